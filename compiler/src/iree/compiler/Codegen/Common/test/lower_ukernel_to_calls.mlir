@@ -169,6 +169,38 @@ func.func @ukernel_mmt4d_i8i8i32(%lhs : memref<?x?x?x?xi8>, %rhs : memref<?x?x?x
 
 // -----
 
+func.func @ukernel_batch_mmt4d_f32f32f32(%lhs : memref<?x?x?x?x?xf32>, %rhs : memref<?x?x?x?x?xf32>,
+    %acc : memref<?x?x?x?x?xf32>, %b : index, %m : index, %n : index, %k : index, %m0 : i32, %n0 : i32, %k0 : i32, %flags : i32) {
+  iree_codegen.ukernel.generic "iree_uk_batch_mmt4d" ins(%lhs, %rhs : memref<?x?x?x?x?xf32>, memref<?x?x?x?x?xf32>)
+      outs(%acc : memref<?x?x?x?x?xf32>) (%b, %m, %n, %k, %m0, %n0, %k0, %flags : index, index, index, index, i32, i32, i32, i32) strided_outer_dims(2)
+  return
+}
+// CHECK-LABEL: func.func private @iree_uk_batch_mmt4d
+//  CHECK-SAME:     (memref<f32>, index, index, index, memref<f32>, index, index, index,
+//  CHECK-SAME:     memref<f32>, index, index, index, index, index, index, index, i32, i32, i32, i32)
+// CHECK-LABEL: func.func @ukernel_batch_mmt4d_f32f32f32(
+//  CHECK-SAME:     %[[ARG0:[a-zA-Z0-9]+]]: memref<?x?x?x?x?xf32>
+//  CHECK-SAME:     %[[ARG1:[a-zA-Z0-9]+]]: memref<?x?x?x?x?xf32>
+//  CHECK-SAME:     %[[ARG2:[a-zA-Z0-9]+]]: memref<?x?x?x?x?xf32>
+//  CHECK-SAME:     %[[B:[a-zA-Z0-9]+]]: index
+//  CHECK-SAME:     %[[M:[a-zA-Z0-9]+]]: index
+//  CHECK-SAME:     %[[N:[a-zA-Z0-9]+]]: index
+//  CHECK-SAME:     %[[K:[a-zA-Z0-9]+]]: index
+//  CHECK-SAME:     %[[M0:[a-zA-Z0-9]+]]: i32
+//  CHECK-SAME:     %[[N0:[a-zA-Z0-9]+]]: i32
+//  CHECK-SAME:     %[[K0:[a-zA-Z0-9]+]]: i32
+//  CHECK-SAME:     %[[FLAGS:[a-zA-Z0-9]+]]: i32
+//       CHECK:   %[[BASE0:.+]], %[[OFFSET0:.+]], %[[SIZE0:.+]]:5, %[[STRIDES0:.+]]:5 = memref.extract_strided_metadata %[[ARG0]]
+//       CHECK:   %[[BASE1:.+]], %[[OFFSET1:.+]], %[[SIZE1:.+]]:5, %[[STRIDES1:.+]]:5 = memref.extract_strided_metadata %[[ARG1]]
+//       CHECK:   %[[BASE2:.+]], %[[OFFSET2:.+]], %[[SIZE2:.+]]:5, %[[STRIDES2:.+]]:5 = memref.extract_strided_metadata %[[ARG2]]
+//       CHECK:   call @iree_uk_batch_mmt4d(%[[BASE0]], %[[OFFSET0]], %[[STRIDES0]]#0, %[[STRIDES0]]#1
+//  CHECK-SAME:       %[[BASE1]], %[[OFFSET1]], %[[STRIDES1]]#0, %[[STRIDES1]]#1
+//  CHECK-SAME:       %[[BASE2]], %[[OFFSET2]], %[[STRIDES2]]#0, %[[STRIDES2]]#1
+//  CHECK-SAME:       %[[B]], %[[M]], %[[N]], %[[K]],
+//  CHECK-SAME:       %[[M0]], %[[N0]], %[[K0]], %[[FLAGS]])
+
+// -----
+
 func.func @ukernel_generic_test_fndef_attrs(%arg0 : memref<?xf32, strided<[1], offset: ?>>) {
   iree_codegen.ukernel.generic "test1d" outs(%arg0 : memref<?xf32, strided<[1], offset: ?>>)
       fn_def_attrs{hal.import.fields = ["processor_id", "processor_data"]}
@@ -1176,10 +1176,18 @@ static LogicalResult setRootConfig(func::FuncOp entryPointFn,
     unsigned numLoops = batchMmt4dOp.getNumLoops();
     SmallVector<int64_t> minTileSizes(numLoops, 0);
     SmallVector<int64_t> maxTileSizes(numLoops, 0);
+    // The batch_mmt4d microkernel loops over batches internally, so with
+    // microkernels a workgroup can process several batches in one call. This
+    // matters for batches of small matmuls (e.g. attention heads), where one
+    // workgroup per batch would be dominated by per-call overheads. VMVX has
+    // no batch_mmt4d microkernel and decomposes batch_mmt4d into mmt4d.
+    auto targetAttr = IREE::HAL::ExecutableTargetAttr::lookup(entryPointFn);
+    bool useBatchUKernel =
+        hasMicrokernels(targetAttr) && !isVMVXBackend(targetAttr);
     minTileSizes[0] = 1;
     minTileSizes[1] = 4;
     minTileSizes[2] = 4;
-    maxTileSizes[0] = 1;
+    maxTileSizes[0] = useBatchUKernel ? 16 : 1;
     maxTileSizes[1] = 48;
     maxTileSizes[2] = 32;
     SmallVector<int64_t> distTileSizes = getDefaultDistributedLevelTileSizes(
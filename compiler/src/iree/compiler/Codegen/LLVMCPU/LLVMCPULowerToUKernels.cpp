@@ -11,9 +11,11 @@
 #include "iree/compiler/Codegen/Dialect/UKernelOps.h"
 #include "iree/compiler/Codegen/LLVMCPU/PassDetail.h"
 #include "iree/compiler/Codegen/LLVMCPU/Passes.h"
+#include "iree/compiler/Codegen/Utils/Utils.h"
 #include "mlir/Dialect/Arith/IR/Arith.h"
 #include "mlir/Dialect/Func/IR/FuncOps.h"
 #include "mlir/Dialect/Linalg/IR/Linalg.h"
+#include "mlir/Dialect/Math/IR/Math.h"
 #include "mlir/Dialect/Tensor/IR/Tensor.h"
 #include "mlir/IR/Attributes.h"
 #include "mlir/IR/BuiltinAttributes.h"
@@ -102,44 +104,192 @@ getFnNameAndDefAttrs(const char *ukernelName, RewriterBase &rewriter,
   return result;
 }
 
+/// Returns the tensor.pack op producing the mmt4d LHS `lhs` if it can be fused
+/// into a `pack_mmt4d` microkernel packing LHS tiles on the fly: it must pack a
+/// 2D tensor into untransposed tiles, pad with zeros if at all, and have no
+/// other users, so that the packed LHS never needs to be materialized. The
+/// microkernel accumulates into the output across chunks of K, so the output
+/// `outElemType` must be 32-bit for that not to introduce roundings.
+static tensor::PackOp getFusableLhsPackOp(Value lhs, Type outElemType) {
+  if (outElemType.getIntOrFloatBitWidth() != 32)
+    return {};
+  auto packOp = lhs.getDefiningOp<tensor::PackOp>();
+  if (!packOp || !packOp->hasOneUse())
+    return {};
+  if (packOp.getSourceType().getRank() != 2)
+    return {};
+  ArrayRef<int64_t> innerDimsPos = packOp.getInnerDimsPos();
+  if (innerDimsPos.size() != 2 || innerDimsPos[0] != 0 || innerDimsPos[1] != 1)
+    return {};
+  ArrayRef<int64_t> outerDimsPerm = packOp.getOuterDimsPerm();
+  if (!outerDimsPerm.empty() &&
+      (outerDimsPerm[0] != 0 || outerDimsPerm[1] != 1))
+    return {};
+  Value paddingValue = packOp.getPaddingValue();
+  if (paddingValue && !matchPattern(paddingValue, m_Zero()) &&
+      !matchPattern(paddingValue, m_AnyZeroFloat()))
+    return {};
+  return packOp;
+}
+
+/// Returns the mmt4d ukernel type flag for the given element types, or
+/// std::nullopt if there is no ukernel for that combination.
+static std::optional<uint32_t> getMmt4dTypeFlag(Type lhsElemType,
+                                                Type rhsElemType,
+                                                Type outElemType) {
+  if (lhsElemType.isSignlessInteger(8) && rhsElemType.isSignlessInteger(8) &&
+      outElemType.isSignlessInteger(32)) {
+    return IREE_UK_FLAG_MMT4D_TYPE_I8I8I32;
+  }
+  if (lhsElemType.isF32() && rhsElemType.isF32() && outElemType.isF32()) {
+    return IREE_UK_FLAG_MMT4D_TYPE_F32F32F32;
+  }
+  if (lhsElemType.isF16() && rhsElemType.isF16() && outElemType.isF32()) {
+    return IREE_UK_FLAG_MMT4D_TYPE_F16F16F32;
+  }
+  if (lhsElemType.isF16() && rhsElemType.isF16() && outElemType.isF16()) {
+    return IREE_UK_FLAG_MMT4D_TYPE_F16F16F16;
+  }
+  if (lhsElemType.isBF16() && rhsElemType.isBF16() && outElemType.isF32()) {
+    return IREE_UK_FLAG_MMT4D_TYPE_BF16BF16F32;
+  }
+  if (lhsElemType.isBF16() && rhsElemType.isBF16() && outElemType.isBF16()) {
+    return IREE_UK_FLAG_MMT4D_TYPE_BF16BF16BF16;
+  }
+  if (lhsElemType.isF32() && rhsElemType.isSignlessInteger(4) &&
+      outElemType.isF32()) {
+    return IREE_UK_FLAG_MMT4D_TYPE_F32I4F32;
+  }
+  if (lhsElemType.isF32() && rhsElemType.isSignlessInteger(8) &&
+      outElemType.isF32()) {
+    return IREE_UK_FLAG_MMT4D_TYPE_F32I8F32;
+  }
+  if (lhsElemType.isF16() && rhsElemType.isSignlessInteger(4) &&
+      outElemType.isF32()) {
+    return IREE_UK_FLAG_MMT4D_TYPE_F16I4F32;
+  }
+  if (lhsElemType.isF16() && rhsElemType.isSignlessInteger(8) &&
+      outElemType.isF32()) {
+    return IREE_UK_FLAG_MMT4D_TYPE_F16I8F32;
+  }
+  return std::nullopt;
+}
+
+/// The operands of a linalg.generic dequantizing the RHS of an mmt4d.
+struct DequantizedRhs {
+  /// The packed integer RHS.
+  Value quantized;
+  /// The f32 scales, laid out as [N][groups][N0].
+  Value scales;
+  /// The number of K-tiles sharing a group of scales.
+  int64_t groupKTiles;
+};
+
+/// Matches `rhs` being produced by a linalg.generic that dequantizes a packed
+/// i4/i8 RHS with per-group f32 scales, i.e. computes
+/// `sitofp(quantized[n, k, n0, k0]) * scales[n, k floordiv c, n0]`, and has no
+/// other users, so that the dequantization can happen inside the mmt4d
+/// microkernel and the f32 RHS never needs to be materialized.
+static std::optional<DequantizedRhs> matchDequantizedRhs(Value rhs) {
+  auto genericOp = rhs.getDefiningOp<linalg::GenericOp>();
+  if (!genericOp || !genericOp->hasOneUse())
+    return std::nullopt;
+  if (genericOp.getNumDpsInputs() != 2 || genericOp.getNumDpsInits() != 1 ||
+      genericOp.getNumLoops() != 4 || genericOp.getNumParallelLoops() != 4)
+    return std::nullopt;
+  OpOperand *quantizedOperand = genericOp.getDpsInputOperand(0);
+  OpOperand *scalesOperand = genericOp.getDpsInputOperand(1);
+  Type quantizedElemType = getElementTypeOrSelf(quantizedOperand->get());
+  if (!quantizedElemType.isSignlessInteger(4) &&
+      !quantizedElemType.isSignlessInteger(8))
+    return std::nullopt;
+  if (!getElementTypeOrSelf(scalesOperand->get()).isF32() ||
+      !getElementTypeOrSelf(rhs).isF32())
+    return std::nullopt;
+  if (!genericOp.getMatchingIndexingMap(quantizedOperand).isIdentity() ||
+      !genericOp.getMatchingIndexingMap(genericOp.getDpsInitOperand(0))
+           .isIdentity())
+    return std::nullopt;
+
+  // The scales are indexed by (n, k floordiv c, n0), or (n, k, n0) for c == 1.
+  AffineMap scalesMap = genericOp.getMatchingIndexingMap(scalesOperand);
+  MLIRContext *context = genericOp.getContext();
+  if (scalesMap.getNumResults() != 3 ||
+      scalesMap.getResult(0) != getAffineDimExpr(0, context) ||
+      scalesMap.getResult(2) != getAffineDimExpr(2, context))
+    return std::nullopt;
+  AffineExpr groupExpr = scalesMap.getResult(1);
+  int64_t groupKTiles = 1;
+  if (groupExpr != getAffineDimExpr(1, context)) {
+    auto floorDivExpr = groupExpr.dyn_cast<AffineBinaryOpExpr>();
+    if (!floorDivExpr || floorDivExpr.getKind() != AffineExprKind::FloorDiv ||
+        floorDivExpr.getLHS() != getAffineDimExpr(1, context))
+      return std::nullopt;
+    auto divisorExpr = floorDivExpr.getRHS().dyn_cast<AffineConstantExpr>();
+    if (!divisorExpr || divisorExpr.getValue() <= 0)
+      return std::nullopt;
+    groupKTiles = divisorExpr.getValue();
+  }
+
+  // The body must be exactly `yield(mulf(sitofp(quantized), scale))`.
+  Block &body = genericOp.getRegion().front();
+  if (body.getOperations().size() != 3)
+    return std::nullopt;
+  auto yieldOp = cast<linalg::YieldOp>(body.getTerminator());
+  auto mulOp = yieldOp.getOperand(0).getDefiningOp<arith::MulFOp>();
+  if (!mulOp)
+    return std::nullopt;
+  Value mulLhs = mulOp.getLhs();
+  Value mulRhs = mulOp.getRhs();
+  if (mulRhs.getDefiningOp<arith::SIToFPOp>())
+    std::swap(mulLhs, mulRhs);
+  auto castOp = mulLhs.getDefiningOp<arith::SIToFPOp>();
+  if (!castOp || castOp.getIn() != body.getArgument(0) ||
+      mulRhs != body.getArgument(1))
+    return std::nullopt;
+  return DequantizedRhs{quantizedOperand->get(), scalesOperand->get(),
+                        groupKTiles};
+}
+
 /// Matches an (linalg.fill -> )? linalg.mmt4d operation sequence and converts
 /// it into a iree_codegen.ukernel.mmt4d operation, that is later lowered
-/// into a call to the microkernel.
+/// into a call to the microkernel. When the RHS is dequantized by a
+/// linalg.generic matched by matchDequantizedRhs, that is folded into a call
+/// to the mmt4d_dequant microkernel instead.
 static FailureOr<IREE::Codegen::UKernelOpInterface>
 matchDAGForUKernel(RewriterBase &rewriter, linalg::Mmt4DOp op,
                    bool skipIntermediateRoundings) {
   Value lhs = op.getDpsInputOperand(0)->get();
   Value rhs = op.getDpsInputOperand(1)->get();
   Value out = op.getDpsInitOperand(0)->get();
+  auto targetAttr = IREE::HAL::ExecutableTargetAttr::lookup(op);
+  bool isVMVX = isVMVXBackend(targetAttr);
+  std::optional<DequantizedRhs> dequantizedRhs;
+  if (!isVMVX) {
+    dequantizedRhs = matchDequantizedRhs(rhs);
+    if (dequantizedRhs)
+      rhs = dequantizedRhs->quantized;
+  }
   auto lhsType = llvm::cast<ShapedType>(lhs.getType());
   auto rhsType = llvm::cast<ShapedType>(rhs.getType());
   auto outType = llvm::cast<ShapedType>(out.getType());
   Type lhsElemType = lhsType.getElementType();
   Type rhsElemType = rhsType.getElementType();
   Type outElemType = outType.getElementType();
-  uint32_t flags = 0;
-  if (lhsElemType.isSignlessInteger(8) && rhsElemType.isSignlessInteger(8) &&
-      outElemType.isSignlessInteger(32)) {
-    flags = IREE_UK_FLAG_MMT4D_TYPE_I8I8I32;
-  } else if (lhsElemType.isF32() && rhsElemType.isF32() &&
-             outElemType.isF32()) {
-    flags = IREE_UK_FLAG_MMT4D_TYPE_F32F32F32;
-  } else if (lhsElemType.isF16() && rhsElemType.isF16() &&
-             outElemType.isF32()) {
-    flags = IREE_UK_FLAG_MMT4D_TYPE_F16F16F32;
-  } else if (lhsElemType.isF16() && rhsElemType.isF16() &&
-             outElemType.isF16()) {
-    flags = IREE_UK_FLAG_MMT4D_TYPE_F16F16F16;
-  } else if (lhsElemType.isBF16() && rhsElemType.isBF16() &&
-             outElemType.isF32()) {
-    flags = IREE_UK_FLAG_MMT4D_TYPE_BF16BF16F32;
-  } else if (lhsElemType.isBF16() && rhsElemType.isBF16() &&
-             outElemType.isBF16()) {
-    flags = IREE_UK_FLAG_MMT4D_TYPE_BF16BF16BF16;
-  } else {
+  std::optional<uint32_t> typeFlag =
+      getMmt4dTypeFlag(lhsElemType, rhsElemType, outElemType);
+  if (!typeFlag) {
     return rewriter.notifyMatchFailure(
         op, "unsupported combination of element types");
   }
+  uint32_t flags = *typeFlag;
+  bool isWeightOnlyQuantized =
+      llvm::isa<FloatType>(lhsElemType) && llvm::isa<IntegerType>(rhsElemType);
+
+  if (isWeightOnlyQuantized && isVMVX) {
+    return rewriter.notifyMatchFailure(
+        op, "weight-only quantized mmt4d is not supported on VMVX");
+  }
 
   // Check if the accumulator is zero-filled.
   if (isInitializedToZero(out)) {
@@ -173,7 +323,44 @@ matchDAGForUKernel(RewriterBase &rewriter, linalg::Mmt4DOp op,
   Value k0 = getDimAsI32(rewriter, loc, rhs, 3);
   Value flagsVal = rewriter.create<arith::ConstantOp>(
       loc, rewriter.getI32IntegerAttr(flags));
-  auto targetAttr = IREE::HAL::ExecutableTargetAttr::lookup(op);
+  // When the LHS is packed just for this mmt4d, fuse the packing into the
+  // microkernel so that the packed LHS is never written to memory.
+  tensor::PackOp lhsPackOp;
+  if (!isVMVX && !isWeightOnlyQuantized) {
+    lhsPackOp = getFusableLhsPackOp(lhs, outElemType);
+  }
+  if (lhsPackOp) {
+    Value lhsSource = lhsPackOp.getSource();
+    Value lhsSize0 = rewriter.create<tensor::DimOp>(loc, lhsSource, 0);
+    Value lhsSize1 = rewriter.create<tensor::DimOp>(loc, lhsSource, 1);
+    auto fn = getFnNameAndDefAttrs("pack_mmt4d", rewriter, targetAttr);
+    auto genericMicroKernelOp =
+        rewriter.create<IREE::Codegen::UKernelGenericOp>(
+            loc, outType, fn.name, ValueRange{lhsSource, rhs}, out,
+            ValueRange{lhsSize0, lhsSize1, m, n, k, m0, n0, k0, flagsVal},
+            /*fn_def_attrs=*/rewriter.getDictionaryAttr(fn.defAttrs),
+            /*strided_outer_dims=*/rewriter.getIndexAttr(1));
+    return cast<IREE::Codegen::UKernelOpInterface>(
+        genericMicroKernelOp.getOperation());
+  }
+  if (dequantizedRhs) {
+    // The scales are grouped by whole K-tiles; the microkernel takes the
+    // group size in elements along the reduction dimension.
+    Value groupSizeVal = rewriter.create<arith::MulIOp>(
+        loc, k0,
+        rewriter.create<arith::ConstantOp>(
+            loc, rewriter.getI32IntegerAttr(dequantizedRhs->groupKTiles)));
+    auto fn = getFnNameAndDefAttrs("mmt4d_dequant", rewriter, targetAttr);
+    auto genericMicroKernelOp =
+        rewriter.create<IREE::Codegen::UKernelGenericOp>(
+            loc, outType, fn.name,
+            ValueRange{lhs, rhs, dequantizedRhs->scales}, out,
+            ValueRange{m, n, k, m0, n0, k0, flagsVal, groupSizeVal},
+            /*fn_def_attrs=*/rewriter.getDictionaryAttr(fn.defAttrs),
+            /*strided_outer_dims=*/rewriter.getIndexAttr(1));
+    return cast<IREE::Codegen::UKernelOpInterface>(
+        genericMicroKernelOp.getOperation());
+  }
   auto fn = getFnNameAndDefAttrs("mmt4d", rewriter, targetAttr);
   auto genericMicroKernelOp = rewriter.create<IREE::Codegen::UKernelGenericOp>(
       loc, outType, fn.name, ValueRange{lhs, rhs}, out,
@@ -184,6 +371,76 @@ matchDAGForUKernel(RewriterBase &rewriter, linalg::Mmt4DOp op,
       genericMicroKernelOp.getOperation());
 }
 
+/// Matches an (linalg.fill -> )? linalg.batch_mmt4d operation sequence and
+/// converts it into a call to the batch_mmt4d microkernel, which runs all the
+/// batches in one call instead of one mmt4d call per batch.
+static FailureOr<IREE::Codegen::UKernelOpInterface>
+matchDAGForUKernel(RewriterBase &rewriter, linalg::BatchMmt4DOp op,
+                   bool skipIntermediateRoundings) {
+  Value lhs = op.getDpsInputOperand(0)->get();
+  Value rhs = op.getDpsInputOperand(1)->get();
+  Value out = op.getDpsInitOperand(0)->get();
+  auto lhsType = llvm::cast<ShapedType>(lhs.getType());
+  auto rhsType = llvm::cast<ShapedType>(rhs.getType());
+  auto outType = llvm::cast<ShapedType>(out.getType());
+  Type lhsElemType = lhsType.getElementType();
+  Type rhsElemType = rhsType.getElementType();
+  Type outElemType = outType.getElementType();
+  std::optional<uint32_t> typeFlag =
+      getMmt4dTypeFlag(lhsElemType, rhsElemType, outElemType);
+  if (!typeFlag) {
+    return rewriter.notifyMatchFailure(
+        op, "unsupported combination of element types");
+  }
+  if (llvm::isa<FloatType>(lhsElemType) &&
+      llvm::isa<IntegerType>(rhsElemType)) {
+    return rewriter.notifyMatchFailure(
+        op, "weight-only quantized batch_mmt4d is not supported");
+  }
+  uint32_t flags = *typeFlag;
+
+  // Check if the accumulator is zero-filled.
+  if (isInitializedToZero(out)) {
+    if (auto fillOp = out.getDefiningOp<linalg::FillOp>()) {
+      out = fillOp.getDpsInitOperand(0)->get();
+    }
+  } else {
+    flags |= IREE_UK_FLAG_MMT4D_ACCUMULATE;
+  }
+
+  if (skipIntermediateRoundings) {
+    flags |= IREE_UK_FLAG_MMT4D_SKIP_INTERMEDIATE_ROUNDINGS;
+  }
+
+  Location loc = op.getLoc();
+  Value batch = rewriter.create<tensor::DimOp>(loc, lhs, 0);
+  Value m = rewriter.create<tensor::DimOp>(loc, lhs, 1);
+  Value n = rewriter.create<tensor::DimOp>(loc, rhs, 1);
+  Value k = rewriter.create<tensor::DimOp>(loc, rhs, 2);
+
+  auto getDimAsI32 = [](RewriterBase &rewriter, Location loc, Value value,
+                        int dim) -> Value {
+    return rewriter.create<arith::IndexCastOp>(
+        loc, rewriter.getI32Type(),
+        rewriter.create<tensor::DimOp>(loc, value, dim));
+  };
+  Value m0 = getDimAsI32(rewriter, loc, lhs, 3);
+  Value n0 = getDimAsI32(rewriter, loc, rhs, 3);
+  Value k0 = getDimAsI32(rewriter, loc, rhs, 4);
+  Value flagsVal = rewriter.create<arith::ConstantOp>(
+      loc, rewriter.getI32IntegerAttr(flags));
+  auto targetAttr = IREE::HAL::ExecutableTargetAttr::lookup(op);
+  auto fn = getFnNameAndDefAttrs("batch_mmt4d", rewriter, targetAttr);
+  // The batch and the M/N tile rows are both strided: 2 outer dims.
+  auto genericMicroKernelOp = rewriter.create<IREE::Codegen::UKernelGenericOp>(
+      loc, outType, fn.name, ValueRange{lhs, rhs}, out,
+      ValueRange{batch, m, n, k, m0, n0, k0, flagsVal},
+      /*fn_def_attrs=*/rewriter.getDictionaryAttr(fn.defAttrs),
+      /*strided_outer_dims=*/rewriter.getIndexAttr(2));
+  return cast<IREE::Codegen::UKernelOpInterface>(
+      genericMicroKernelOp.getOperation());
+}
+
 static FailureOr<IREE::Codegen::UKernelOpInterface>
 matchDAGForUKernel(RewriterBase &rewriter, tensor::PackOp op,
                    bool /*skipIntermediateRoundings*/) {
@@ -383,6 +640,454 @@ matchDAGForUKernel(RewriterBase &rewriter, tensor::UnPackOp op,
       genericMicroKernelOp.getOperation());
 }
 
+/// Matches an iree_linalg_ext.softmax op over the innermost dimension of a 2D
+/// f32 tensor and converts it into a call to the softmax microkernel.
+static FailureOr<IREE::Codegen::UKernelOpInterface>
+matchDAGForUKernel(RewriterBase &rewriter, IREE::LinalgExt::SoftmaxOp op,
+                   bool /*skipIntermediateRoundings*/) {
+  Value in = op.input();
+  Value out = op.output();
+  auto inType = llvm::dyn_cast<RankedTensorType>(in.getType());
+  auto outType = llvm::dyn_cast<RankedTensorType>(out.getType());
+  if (!inType || !outType) {
+    return rewriter.notifyMatchFailure(op, "expected ranked tensor operands");
+  }
+  if (!inType.getElementType().isF32() || !outType.getElementType().isF32()) {
+    return rewriter.notifyMatchFailure(
+        op, "unsupported combination of element types");
+  }
+  if (inType.getRank() != 2) {
+    return rewriter.notifyMatchFailure(op, "expected input to be 2D");
+  }
+  if (op.getDimension() != 1) {
+    return rewriter.notifyMatchFailure(
+        op, "only softmax over the innermost dimension is supported");
+  }
+  Location loc = op.getLoc();
+  Value size0 = rewriter.create<tensor::DimOp>(loc, in, 0);
+  Value size1 = rewriter.create<tensor::DimOp>(loc, in, 1);
+  Value flagsVal = rewriter.create<arith::ConstantOp>(
+      loc, rewriter.getI32IntegerAttr(IREE_UK_FLAG_SOFTMAX_TYPE_F32F32));
+  auto targetAttr = IREE::HAL::ExecutableTargetAttr::lookup(op);
+  auto fn = getFnNameAndDefAttrs("softmax", rewriter, targetAttr);
+  auto genericMicroKernelOp = rewriter.create<IREE::Codegen::UKernelGenericOp>(
+      loc, outType, fn.name, in, out, ValueRange{size0, size1, flagsVal},
+      /*fn_def_attrs=*/rewriter.getDictionaryAttr(fn.defAttrs),
+      /*strided_outer_dims=*/rewriter.getIndexAttr(1));
+  return cast<IREE::Codegen::UKernelOpInterface>(
+      genericMicroKernelOp.getOperation());
+}
+
+/// A layer normalization matched by matchLayerNorm.
+struct LayerNorm {
+  Value input;
+  Value gamma;
+  // Null for RMSnorm.
+  Value beta;
+  FloatAttr epsilon;
+  bool rms;
+};
+
+/// Returns the operand of `op` feeding `value` if it is a block argument of
+/// the body of `op`, and null otherwise.
+static OpOperand *getOperandOfBlockArg(linalg::GenericOp op, Value value) {
+  auto blockArg = llvm::dyn_cast<BlockArgument>(value);
+  if (!blockArg || blockArg.getOwner() != op.getBlock())
+    return nullptr;
+  return &op->getOpOperand(blockArg.getArgNumber());
+}
+
+/// Returns true if `value` is `sum / n`, written as a division by `n` or as a
+/// multiplication by `1 / n`.
+static bool isMeanOf(Value value, Value sum, int64_t n) {
+  APFloat divisor(0.0f);
+  if (auto divOp = value.getDefiningOp<arith::DivFOp>()) {
+    return divOp.getLhs() == sum &&
+           matchPattern(divOp.getRhs(), m_ConstantFloat(&divisor)) &&
+           divisor.convertToFloat() == static_cast<float>(n);
+  }
+  if (auto mulOp = value.getDefiningOp<arith::MulFOp>()) {
+    Value other = mulOp.getLhs() == sum ? mulOp.getRhs() : mulOp.getLhs();
+    return (mulOp.getLhs() == sum || mulOp.getRhs() == sum) &&
+           matchPattern(other, m_ConstantFloat(&divisor)) &&
+           divisor.convertToFloat() == static_cast<float>(1.0 / n);
+  }
+  return false;
+}
+
+/// Returns the term summed by `op` if it is a linalg.generic summing over the
+/// innermost of two loops into a zero-filled f32 vector, i.e. the `t` in
+/// `out[i] += t(ins[i, j]...)`, and null otherwise.
+static Value getRowSumTerm(linalg::GenericOp op) {
+  if (!op || op.getNumDpsInits() != 1 || op.getNumLoops() != 2 ||
+      op.getNumReductionLoops() != 1 ||
+      op.getIteratorTypesArray()[1] != utils::IteratorType::reduction) {
+    return nullptr;
+  }
+  OpOperand *init = op.getDpsInitOperand(0);
+  MLIRContext *context = op.getContext();
+  if (op.getMatchingIndexingMap(init) !=
+          AffineMap::get(2, 0, getAffineDimExpr(0, context)) ||
+      !getElementTypeOrSelf(init->get()).isF32() ||
+      !isInitializedToZero(init->get())) {
+    return nullptr;
+  }
+  auto yieldOp = cast<linalg::YieldOp>(op.getBlock()->getTerminator());
+  auto addOp = yieldOp.getValues()[0].getDefiningOp<arith::AddFOp>();
+  if (!addOp)
+    return nullptr;
+  Value outArg = op.getMatchingBlockArgument(init);
+  if (addOp.getRhs() == outArg)
+    return addOp.getLhs();
+  if (addOp.getLhs() == outArg)
+    return addOp.getRhs();
+  return nullptr;
+}
+
+/// Returns the row statistic `stat` is computed from, if `stat` is a block
+/// argument of the elementwise `op` indexed by the row and produced by a
+/// reduction of `input` matched by getRowSumTerm, and null otherwise.
+static linalg::GenericOp getRowStatProducer(linalg::GenericOp op, Value stat,
+                                            Value input) {
+  OpOperand *operand = getOperandOfBlockArg(op, stat);
+  if (!operand || op.isDpsInit(operand) ||
+      op.getMatchingIndexingMap(operand) !=
+          AffineMap::get(2, 0, getAffineDimExpr(0, op.getContext()))) {
+    return {};
+  }
+  auto producer = operand->get().getDefiningOp<linalg::GenericOp>();
+  if (!getRowSumTerm(producer) ||
+      producer.getDpsInputOperand(0)->get() != input ||
+      !producer.getMatchingIndexingMap(producer.getDpsInputOperand(0))
+           .isIdentity()) {
+    return {};
+  }
+  return producer;
+}
+
+/// Appends the factors of the product `value` to `factors`, looking through
+/// the `arith.mulf` ops in `block`.
+static void collectFactors(Value value, Block *block,
+                           SmallVectorImpl<Value> &factors) {
+  auto mulOp = value.getDefiningOp<arith::MulFOp>();
+  if (!mulOp || mulOp->getBlock() != block) {
+    factors.push_back(value);
+    return;
+  }
+  collectFactors(mulOp.getLhs(), block, factors);
+  collectFactors(mulOp.getRhs(), block, factors);
+}
+
+/// Matches a layer normalization over the innermost dimension of a 2D f32
+/// tensor, rooted at the elementwise linalg.generic `op` that normalizes the
+/// rows using statistics computed by preceding reductions:
+///
+///   mean = sum_j(x[i, j]) / N
+///   var = sum_j((x[i, j] - mean) * (x[i, j] - mean)) / N
+///   y[i, j] = (x[i, j] - mean) * rsqrt(var + epsilon) * gamma[j] + beta[j]
+///
+/// or RMSnorm, which does not subtract the mean and has no `beta`:
+///
+///   ms = sum_j(x[i, j] * x[i, j]) / N
+///   y[i, j] = x[i, j] * rsqrt(ms + epsilon) * gamma[j]
+///
+/// N must be the static size of the innermost dimension, the divisions may be
+/// multiplications by 1 / N, and the products may be associated and commuted
+/// in any way. These are the forms that the linalg decomposition of these ops
+/// produces; others, e.g. dividing by a sqrt, are left to codegen.
+static std::optional<LayerNorm> matchLayerNorm(linalg::GenericOp op) {
+  if (op.getNumDpsInits() != 1 || op.getNumLoops() != 2 ||
+      op.getNumParallelLoops() != 2) {
+    return std::nullopt;
+  }
+  OpOperand *init = op.getDpsInitOperand(0);
+  auto outType = llvm::dyn_cast<RankedTensorType>(init->get().getType());
+  if (!outType || !outType.getElementType().isF32() ||
+      !op.getMatchingIndexingMap(init).isIdentity() ||
+      !op.getMatchingBlockArgument(init).use_empty()) {
+    return std::nullopt;
+  }
+  Block *body = op.getBlock();
+  auto yieldOp = cast<linalg::YieldOp>(body->getTerminator());
+  Value result = yieldOp.getValues()[0];
+
+  // Split off beta, which only layernorm has.
+  MLIRContext *context = op.getContext();
+  AffineMap columnMap = AffineMap::get(2, 0, getAffineDimExpr(1, context));
+  auto isColumnVector = [&](Value value) {
+    OpOperand *operand = getOperandOfBlockArg(op, value);
+    return operand && !op.isDpsInit(operand) &&
+           op.getMatchingIndexingMap(operand) == columnMap;
+  };
+  LayerNorm layerNorm;
+  layerNorm.rms = true;
+  Value product = result;
+  if (auto addOp = result.getDefiningOp<arith::AddFOp>()) {
+    Value beta = addOp.getRhs();
+    product = addOp.getLhs();
+    if (!isColumnVector(beta))
+      std::swap(beta, product);
+    if (!isColumnVector(beta))
+      return std::nullopt;
+    layerNorm.rms = false;
+    layerNorm.beta = getOperandOfBlockArg(op, beta)->get();
+  }
+
+  // The product must have exactly three factors: gamma, the (centered) input
+  // and the reciprocal standard deviation.
+  SmallVector<Value> factors;
+  collectFactors(product, body, factors);
+  if (factors.size() != 3)
+    return std::nullopt;
+  auto gammaIt = llvm::find_if(factors, isColumnVector);
+  if (gammaIt == factors.end())
+    return std::nullopt;
+  layerNorm.gamma = getOperandOfBlockArg(op, *gammaIt)->get();
+  factors.erase(gammaIt);
+  if (factors[0].getDefiningOp<math::RsqrtOp>())
+    std::swap(factors[0], factors[1]);
+  auto rsqrtOp = factors[1].getDefiningOp<math::RsqrtOp>();
+  if (!rsqrtOp)
+    return std::nullopt;
+
+  // The input may be centered by its mean.
+  Value x = factors[0];
+  Value mean;
+  if (!layerNorm.rms) {
+    auto subOp = x.getDefiningOp<arith::SubFOp>();
+    if (!subOp)
+      return std::nullopt;
+    x = subOp.getLhs();
+    mean = subOp.getRhs();
+  }
+  OpOperand *inputOperand = getOperandOfBlockArg(op, x);
+  if (!inputOperand || op.isDpsInit(inputOperand) ||
+      !op.getMatchingIndexingMap(inputOperand).isIdentity()) {
+    return std::nullopt;
+  }
+  layerNorm.input = inputOperand->get();
+  auto inputType = llvm::dyn_cast<RankedTensorType>(layerNorm.input.getType());
+  if (!inputType || !inputType.getElementType().isF32() ||
+      inputType.isDynamicDim(1)) {
+    return std::nullopt;
+  }
+  int64_t n = inputType.getDimSize(1);
+
+  // rsqrt(variance + epsilon).
+  auto addEpsOp = rsqrtOp.getOperand().getDefiningOp<arith::AddFOp>();
+  if (!addEpsOp)
+    return std::nullopt;
+  Value meanSquare = addEpsOp.getLhs();
+  Value epsilon = addEpsOp.getRhs();
+  if (!matchPattern(epsilon, m_Constant(&layerNorm.epsilon)))
+    std::swap(meanSquare, epsilon);
+  if (!matchPattern(epsilon, m_Constant(&layerNorm.epsilon)))
+    return std::nullopt;
+  auto meanSquareOp = meanSquare.getDefiningOp();
+  if (!meanSquareOp || meanSquareOp->getNumOperands() != 2)
+    return std::nullopt;
+  Value squareSum = meanSquareOp->getOperand(0);
+  if (!isMeanOf(meanSquare, squareSum, n)) {
+    squareSum = meanSquareOp->getOperand(1);
+    if (!isMeanOf(meanSquare, squareSum, n))
+      return std::nullopt;
+  }
+  linalg::GenericOp squareSumOp =
+      getRowStatProducer(op, squareSum, layerNorm.input);
+  if (!squareSumOp)
+    return std::nullopt;
+
+  // The sum of squares, of the input itself or of the centered input.
+  auto squareOp =
+      getRowSumTerm(squareSumOp).getDefiningOp<arith::MulFOp>();
+  if (!squareOp || squareOp.getLhs() != squareOp.getRhs())
+    return std::nullopt;
+  Value squared = squareOp.getLhs();
+  if (layerNorm.rms) {
+    if (squareSumOp.getNumDpsInputs() != 1 ||
+        squared != squareSumOp.getMatchingBlockArgument(
+                       squareSumOp.getDpsInputOperand(0))) {
+      return std::nullopt;
+    }
+    return layerNorm;
+  }
+
+  // For layernorm, the mean must be computed from a sum of the input, and
+  // that same sum must be used to center the input in the variance.
+  auto meanOp = mean.getDefiningOp();
+  if (!meanOp || meanOp->getNumOperands() != 2)
+    return std::nullopt;
+  Value sum = meanOp->getOperand(0);
+  if (!isMeanOf(mean, sum, n)) {
+    sum = meanOp->getOperand(1);
+    if (!isMeanOf(mean, sum, n))
+      return std::nullopt;
+  }
+  linalg::GenericOp sumOp = getRowStatProducer(op, sum, layerNorm.input);
+  if (!sumOp || sumOp.getNumDpsInputs() != 1 ||
+      getRowSumTerm(sumOp) !=
+          sumOp.getMatchingBlockArgument(sumOp.getDpsInputOperand(0))) {
+    return std::nullopt;
+  }
+  auto centerOp = squared.getDefiningOp<arith::SubFOp>();
+  if (!centerOp || squareSumOp.getNumDpsInputs() != 2 ||
+      centerOp.getLhs() != squareSumOp.getMatchingBlockArgument(
+                               squareSumOp.getDpsInputOperand(0))) {
+    return std::nullopt;
+  }
+  OpOperand *centerSumOperand = squareSumOp.getDpsInputOperand(1);
+  if (centerSumOperand->get() != getOperandOfBlockArg(op, sum)->get() ||
+      squareSumOp.getMatchingIndexingMap(centerSumOperand) !=
+          AffineMap::get(2, 0, getAffineDimExpr(0, context)) ||
+      !isMeanOf(centerOp.getRhs(),
+                squareSumOp.getMatchingBlockArgument(centerSumOperand), n)) {
+    return std::nullopt;
+  }
+  return layerNorm;
+}
+
+/// Converts the layer normalization rooted at `op`, matched by matchLayerNorm,
+/// into a call to the layernorm microkernel. The reductions computing the row
+/// statistics are left without users and get erased.
+static FailureOr<IREE::Codegen::UKernelOpInterface>
+lowerLayerNormToUKernel(RewriterBase &rewriter, linalg::GenericOp op,
+                        const LayerNorm &layerNorm) {
+  Value out = op.getDpsInitOperand(0)->get();
+  auto outType = llvm::cast<ShapedType>(out.getType());
+  uint32_t flags = IREE_UK_FLAG_LAYERNORM_TYPE_F32F32;
+  if (layerNorm.rms) {
+    flags |= IREE_UK_FLAG_LAYERNORM_RMS;
+  }
+  Location loc = op.getLoc();
+  Value in = layerNorm.input;
+  Value size0 = rewriter.create<tensor::DimOp>(loc, in, 0);
+  Value size1 = rewriter.create<tensor::DimOp>(loc, in, 1);
+  Value epsilon = rewriter.create<arith::ConstantOp>(loc, layerNorm.epsilon);
+  Value flagsVal = rewriter.create<arith::ConstantOp>(
+      loc, rewriter.getI32IntegerAttr(flags));
+  // RMSnorm ignores beta, so pass gamma in its place to keep the operand list
+  // and the parameter struct layout the same for both variants.
+  Value beta = layerNorm.rms ? layerNorm.gamma : layerNorm.beta;
+  auto targetAttr = IREE::HAL::ExecutableTargetAttr::lookup(op);
+  auto fn = getFnNameAndDefAttrs("layernorm", rewriter, targetAttr);
+  auto genericMicroKernelOp = rewriter.create<IREE::Codegen::UKernelGenericOp>(
+      loc, outType, fn.name, ValueRange{in, layerNorm.gamma, beta}, out,
+      ValueRange{size0, size1, epsilon, flagsVal},
+      /*fn_def_attrs=*/rewriter.getDictionaryAttr(fn.defAttrs),
+      /*strided_outer_dims=*/rewriter.getIndexAttr(1));
+  return cast<IREE::Codegen::UKernelOpInterface>(
+      genericMicroKernelOp.getOperation());
+}
+
+/// Matches a linalg.generic op reducing the innermost dimension of a 2D f32
+/// tensor with either `arith.addf` or `arith.maxf` and converts it into a call
+/// to the reduce microkernel. Sums into a zero-filled accumulator do not read
+/// the accumulator; everything else accumulates into it. Reductions computing
+/// the statistics of a layer normalization are left to be lowered along with
+/// it.
+static FailureOr<IREE::Codegen::UKernelOpInterface>
+matchReductionForUKernel(RewriterBase &rewriter, linalg::GenericOp op) {
+  if (op.getNumDpsInputs() != 1 || op.getNumDpsInits() != 1) {
+    return rewriter.notifyMatchFailure(op, "expected one input and one init");
+  }
+  if (op.getNumLoops() != 2 || op.getNumReductionLoops() != 1 ||
+      op.getIteratorTypesArray()[1] != utils::IteratorType::reduction) {
+    return rewriter.notifyMatchFailure(
+        op, "expected a reduction over the innermost of two loops");
+  }
+  MLIRContext *context = rewriter.getContext();
+  AffineExpr d0, d1;
+  bindDims(context, d0, d1);
+  SmallVector<AffineMap> expectedMaps = {
+      AffineMap::get(2, 0, {d0, d1}, context),
+      AffineMap::get(2, 0, {d0}, context)};
+  if (op.getIndexingMapsArray() != expectedMaps) {
+    return rewriter.notifyMatchFailure(op, "unsupported indexing maps");
+  }
+  Value in = op.getDpsInputOperand(0)->get();
+  Value out = op.getDpsInitOperand(0)->get();
+  auto inType = llvm::dyn_cast<RankedTensorType>(in.getType());
+  auto outType = llvm::dyn_cast<RankedTensorType>(out.getType());
+  if (!inType || !outType || !inType.getElementType().isF32() ||
+      !outType.getElementType().isF32()) {
+    return rewriter.notifyMatchFailure(
+        op, "unsupported combination of element types");
+  }
+
+  // The body must be a single combiner of the input and accumulator values.
+  Block *body = op.getBlock();
+  if (body->getOperations().size() != 2) {
+    return rewriter.notifyMatchFailure(op, "expected a single combiner op");
+  }
+  Operation *combiner = &body->front();
+  auto yieldOp = cast<linalg::YieldOp>(body->getTerminator());
+  if (yieldOp.getValues().size() != 1 ||
+      yieldOp.getValues()[0] != combiner->getResult(0)) {
+    return rewriter.notifyMatchFailure(op, "expected the combiner be yielded");
+  }
+  Value inArg = body->getArgument(0);
+  Value outArg = body->getArgument(1);
+  if (combiner->getNumOperands() != 2 ||
+      !((combiner->getOperand(0) == inArg &&
+         combiner->getOperand(1) == outArg) ||
+        (combiner->getOperand(0) == outArg &&
+         combiner->getOperand(1) == inArg))) {
+    return rewriter.notifyMatchFailure(
+        op, "expected the combiner to take the block arguments");
+  }
+  uint32_t flags = IREE_UK_FLAG_REDUCE_TYPE_F32F32;
+  bool canSkipAccumulator = false;
+  if (isa<arith::AddFOp>(combiner)) {
+    flags |= IREE_UK_FLAG_REDUCE_OP_SUM;
+    canSkipAccumulator = isInitializedToZero(out);
+  } else if (isa<arith::MaxFOp>(combiner)) {
+    flags |= IREE_UK_FLAG_REDUCE_OP_MAX;
+  } else {
+    return rewriter.notifyMatchFailure(op, "unsupported combiner op");
+  }
+  for (Operation *user : op->getUsers()) {
+    auto userOp = dyn_cast<linalg::GenericOp>(user);
+    if (userOp && matchLayerNorm(userOp)) {
+      return rewriter.notifyMatchFailure(
+          op, "reduction is part of a layer normalization");
+    }
+  }
+
+  if (canSkipAccumulator) {
+    // Not setting flags |= IREE_UK_FLAG_REDUCE_ACCUMULATE, so the reduce op
+    // won't read the existing accumulator, so its defining op can be discarded.
+    if (auto fillOp = out.getDefiningOp<linalg::FillOp>()) {
+      out = fillOp.getDpsInitOperand(0)->get();
+    }
+  } else {
+    // Tell the reduce op to read the existing accumulator.
+    flags |= IREE_UK_FLAG_REDUCE_ACCUMULATE;
+  }
+
+  Location loc = op.getLoc();
+  Value size0 = rewriter.create<tensor::DimOp>(loc, in, 0);
+  Value size1 = rewriter.create<tensor::DimOp>(loc, in, 1);
+  Value flagsVal = rewriter.create<arith::ConstantOp>(
+      loc, rewriter.getI32IntegerAttr(flags));
+  auto targetAttr = IREE::HAL::ExecutableTargetAttr::lookup(op);
+  auto fn = getFnNameAndDefAttrs("reduce", rewriter, targetAttr);
+  auto genericMicroKernelOp = rewriter.create<IREE::Codegen::UKernelGenericOp>(
+      loc, outType, fn.name, in, out, ValueRange{size0, size1, flagsVal},
+      /*fn_def_attrs=*/rewriter.getDictionaryAttr(fn.defAttrs),
+      /*strided_outer_dims=*/rewriter.getIndexAttr(1));
+  return cast<IREE::Codegen::UKernelOpInterface>(
+      genericMicroKernelOp.getOperation());
+}
+
+static FailureOr<IREE::Codegen::UKernelOpInterface>
+matchDAGForUKernel(RewriterBase &rewriter, linalg::GenericOp op,
+                   bool /*skipIntermediateRoundings*/) {
+  if (std::optional<LayerNorm> layerNorm = matchLayerNorm(op)) {
+    return lowerLayerNormToUKernel(rewriter, op, *layerNorm);
+  }
+  return matchReductionForUKernel(rewriter, op);
+}
+
 static uint32_t flagForUser(IREE::LinalgExt::EncodingUser user) {
   switch (user) {
   case IREE::LinalgExt::EncodingUser::MATMUL_F32F32F32:
@@ -518,6 +1223,25 @@ void LLVMCPULowerToUKernelsPass::runOnOperation() {
   patterns.insert<LowerToUKernelPattern<tensor::PackOp>,
                   LowerToUKernelPattern<tensor::UnPackOp>>(context,
                                                            isVMVXBackend);
+  // These patterns only have runtime implementations on LLVMCPU. They target
+  // ops whose codegen is dominated by transcendental functions and horizontal
+  // reductions, where the hand-vectorized microkernels have a clear edge. As
+  // they replace ops that codegen handles fine, they are only enabled when
+  // microkernels were requested for the target.
+  auto llvmcpuTargets = [](IREE::HAL::ExecutableTargetAttr target) {
+    return target && !isVMVXBackend(target);
+  };
+  auto llvmcpuUKernelTargets = [](IREE::HAL::ExecutableTargetAttr target) {
+    return target && !isVMVXBackend(target) && hasMicrokernels(target);
+  };
+  patterns.insert<LowerToUKernelPattern<IREE::LinalgExt::SoftmaxOp>,
+                  LowerToUKernelPattern<linalg::GenericOp>>(
+      context, llvmcpuUKernelTargets);
+  // batch_mmt4d only runs the mmt4d tile functions in a loop, so it is as
+  // profitable as mmt4d. It has no VMVX import: on VMVX, batch_mmt4d is
+  // decomposed into mmt4d instead.
+  patterns.insert<LowerToUKernelPattern<linalg::BatchMmt4DOp>>(
+      context, llvmcpuTargets, skipIntermediateRoundings);
   // These patterns are inherently specific to the VMVX backend.
   patterns.insert<LowerToUKernelPattern<IREE::Codegen::QueryTileSizesOp>>(
       context, isVMVXBackend);
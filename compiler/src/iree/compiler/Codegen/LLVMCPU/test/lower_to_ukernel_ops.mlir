@@ -33,6 +33,64 @@ func.func @mmt4d_f32f32f32(%arg0 : tensor<?x?x?x?xf32>, %arg1 : tensor<?x?x?x?xf
 
 // -----
 
+func.func @pack_mmt4d_f32f32f32(%arg0 : tensor<?x?xf32>, %arg1 : tensor<?x?x16x1xf32>,
+    %arg2 : tensor<?x?x16x16xf32>, %arg3 : tensor<?x?x16x1xf32>) -> tensor<?x?x16x16xf32> {
+  %cst = arith.constant 0.0 : f32
+  %0 = tensor.pack %arg0 padding_value(%cst : f32) inner_dims_pos = [0, 1] inner_tiles = [16, 1] into %arg3
+      : tensor<?x?xf32> -> tensor<?x?x16x1xf32>
+  %1 = linalg.mmt4d ins(%0, %arg1 : tensor<?x?x16x1xf32>, tensor<?x?x16x1xf32>)
+      outs(%arg2 : tensor<?x?x16x16xf32>) -> tensor<?x?x16x16xf32>
+  return %1 : tensor<?x?x16x16xf32>
+}
+//      CHECK: func @pack_mmt4d_f32f32f32(
+// CHECK-SAME:     %[[ARG0:[a-zA-Z0-9]+]]: tensor<?x?xf32>
+// CHECK-SAME:     %[[ARG1:[a-zA-Z0-9]+]]: tensor<?x?x16x1xf32>
+// CHECK-SAME:     %[[ARG2:[a-zA-Z0-9]+]]: tensor<?x?x16x16xf32>
+// CHECK-SAME:     %[[ARG3:[a-zA-Z0-9]+]]: tensor<?x?x16x1xf32>
+//  CHECK-DAG:   %[[C0:.+]] = arith.constant 0 : index
+//  CHECK-DAG:   %[[C1:.+]] = arith.constant 1 : index
+//  CHECK-DAG:   %[[FLAGS:.+]] = arith.constant 1281 : i32
+//  CHECK-DAG:   %[[LHS_SIZE0:.+]] = tensor.dim %[[ARG0]], %[[C0]]
+//  CHECK-DAG:   %[[LHS_SIZE1:.+]] = tensor.dim %[[ARG0]], %[[C1]]
+//  CHECK-NOT:   tensor.pack
+//      CHECK:   %[[MICRO_KERNEL:.+]] = iree_codegen.ukernel.generic "iree_uk_pack_mmt4d"
+// CHECK-SAME:       ins(%[[ARG0]], %[[ARG1]] :
+// CHECK-SAME:       outs(%[[ARG2]] :
+// CHECK-SAME:       (%[[LHS_SIZE0]], %[[LHS_SIZE1]], {{.+}}, %[[FLAGS]] :
+//      CHECK:   return %[[MICRO_KERNEL]]
+
+// -----
+
+func.func @pack_mmt4d_f32f32f32_multiple_uses(%arg0 : tensor<?x?xf32>, %arg1 : tensor<?x?x16x1xf32>,
+    %arg2 : tensor<?x?x16x16xf32>, %arg3 : tensor<?x?x16x1xf32>) -> (tensor<?x?x16x16xf32>, tensor<?x?x16x1xf32>) {
+  %0 = tensor.pack %arg0 inner_dims_pos = [0, 1] inner_tiles = [16, 1] into %arg3
+      : tensor<?x?xf32> -> tensor<?x?x16x1xf32>
+  %1 = linalg.mmt4d ins(%0, %arg1 : tensor<?x?x16x1xf32>, tensor<?x?x16x1xf32>)
+      outs(%arg2 : tensor<?x?x16x16xf32>) -> tensor<?x?x16x16xf32>
+  return %1, %0 : tensor<?x?x16x16xf32>, tensor<?x?x16x1xf32>
+}
+//      CHECK: func @pack_mmt4d_f32f32f32_multiple_uses(
+//      CHECK:   %[[PACK:.+]] = tensor.pack
+//      CHECK:   iree_codegen.ukernel.generic "iree_uk_mmt4d"
+// CHECK-SAME:       ins(%[[PACK]],
+
+// -----
+
+func.func @pack_mmt4d_f16f16f16(%arg0 : tensor<?x?xf16>, %arg1 : tensor<?x?x16x1xf16>,
+    %arg2 : tensor<?x?x16x16xf16>, %arg3 : tensor<?x?x16x1xf16>) -> tensor<?x?x16x16xf16> {
+  %0 = tensor.pack %arg0 inner_dims_pos = [0, 1] inner_tiles = [16, 1] into %arg3
+      : tensor<?x?xf16> -> tensor<?x?x16x1xf16>
+  %1 = linalg.mmt4d ins(%0, %arg1 : tensor<?x?x16x1xf16>, tensor<?x?x16x1xf16>)
+      outs(%arg2 : tensor<?x?x16x16xf16>) -> tensor<?x?x16x16xf16>
+  return %1 : tensor<?x?x16x16xf16>
+}
+//      CHECK: func @pack_mmt4d_f16f16f16(
+//      CHECK:   %[[PACK:.+]] = tensor.pack
+//      CHECK:   iree_codegen.ukernel.generic "iree_uk_mmt4d"
+// CHECK-SAME:       ins(%[[PACK]],
+
+// -----
+
 func.func @mmt4d_fill(%arg0 : tensor<?x?x?x?xf32>, %arg1 : tensor<?x?x?x?xf32>, %arg2 : tensor<?x?x?x?xf32>) -> tensor<?x?x?x?xf32> {
   %cst = arith.constant 0.0 : f32
   %fill = linalg.fill ins(%cst : f32) outs(%arg2 : tensor<?x?x?x?xf32>) -> tensor<?x?x?x?xf32>
@@ -246,6 +304,162 @@ func.func @mmt4d_bf16bf16bf16(%arg0 : tensor<?x?x?x?xbf16>, %arg1 : tensor<?x?x?
 
 // -----
 
+func.func @mmt4d_f32i4f32(%arg0 : tensor<?x?x?x?xf32>, %arg1 : tensor<?x?x?x?xi4>,
+    %arg2 : tensor<?x?x?x?xf32>) -> tensor<?x?x?x?xf32> {
+  %0 = linalg.mmt4d ins(%arg0, %arg1 : tensor<?x?x?x?xf32>, tensor<?x?x?x?xi4>)
+      outs(%arg2 : tensor<?x?x?x?xf32>) -> tensor<?x?x?x?xf32>
+  return %0 : tensor<?x?x?x?xf32>
+}
+//      CHECK: func @mmt4d_f32i4f32(
+// CHECK-SAME:     %[[ARG0:[a-zA-Z0-9]+]]: tensor<?x?x?x?xf32>
+// CHECK-SAME:     %[[ARG1:[a-zA-Z0-9]+]]: tensor<?x?x?x?xi4>
+// CHECK-SAME:     %[[ARG2:[a-zA-Z0-9]+]]: tensor<?x?x?x?xf32>
+//  CHECK-DAG:   %[[FLAGS:.+]] = arith.constant 1287 : i32
+//      CHECK:   %[[MICRO_KERNEL:.+]] = iree_codegen.ukernel.generic "iree_uk_mmt4d"
+// CHECK-SAME:       ins(%[[ARG0]], %[[ARG1]] :
+// CHECK-SAME:       outs(%[[ARG2]] :
+// CHECK-SAME:       %[[FLAGS]] :
+//      CHECK:   return %[[MICRO_KERNEL]]
+
+// -----
+
+func.func @mmt4d_f16i8f32(%arg0 : tensor<?x?x?x?xf16>, %arg1 : tensor<?x?x?x?xi8>,
+    %arg2 : tensor<?x?x?x?xf32>) -> tensor<?x?x?x?xf32> {
+  %0 = linalg.mmt4d ins(%arg0, %arg1 : tensor<?x?x?x?xf16>, tensor<?x?x?x?xi8>)
+      outs(%arg2 : tensor<?x?x?x?xf32>) -> tensor<?x?x?x?xf32>
+  return %0 : tensor<?x?x?x?xf32>
+}
+//      CHECK: func @mmt4d_f16i8f32(
+// CHECK-SAME:     %[[ARG0:[a-zA-Z0-9]+]]: tensor<?x?x?x?xf16>
+// CHECK-SAME:     %[[ARG1:[a-zA-Z0-9]+]]: tensor<?x?x?x?xi8>
+// CHECK-SAME:     %[[ARG2:[a-zA-Z0-9]+]]: tensor<?x?x?x?xf32>
+//  CHECK-DAG:   %[[FLAGS:.+]] = arith.constant 1290 : i32
+//      CHECK:   %[[MICRO_KERNEL:.+]] = iree_codegen.ukernel.generic "iree_uk_mmt4d"
+// CHECK-SAME:       ins(%[[ARG0]], %[[ARG1]] :
+// CHECK-SAME:       outs(%[[ARG2]] :
+// CHECK-SAME:       %[[FLAGS]] :
+//      CHECK:   return %[[MICRO_KERNEL]]
+
+// -----
+
+// Check that an RHS dequantized with group scales is folded into the
+// mmt4d_dequant microkernel, with groups of 4 K-tiles.
+func.func @mmt4d_dequant_f32i4f32(%arg0 : tensor<?x?x8x1xf32>, %arg1 : tensor<?x?x8x1xi4>,
+    %arg2 : tensor<?x?x8xf32>, %arg3 : tensor<?x?x8x8xf32>,
+    %arg4 : tensor<?x?x8x1xf32>) -> tensor<?x?x8x8xf32> {
+  %0 = linalg.generic {
+      indexing_maps = [affine_map<(d0, d1, d2, d3) -> (d0, d1, d2, d3)>,
+                       affine_map<(d0, d1, d2, d3) -> (d0, d1 floordiv 4, d2)>,
+                       affine_map<(d0, d1, d2, d3) -> (d0, d1, d2, d3)>],
+      iterator_types = ["parallel", "parallel", "parallel", "parallel"]}
+      ins(%arg1, %arg2 : tensor<?x?x8x1xi4>, tensor<?x?x8xf32>)
+      outs(%arg4 : tensor<?x?x8x1xf32>) {
+  ^bb0(%in: i4, %scale: f32, %out: f32):
+    %2 = arith.sitofp %in : i4 to f32
+    %3 = arith.mulf %2, %scale : f32
+    linalg.yield %3 : f32
+  } -> tensor<?x?x8x1xf32>
+  %1 = linalg.mmt4d ins(%arg0, %0 : tensor<?x?x8x1xf32>, tensor<?x?x8x1xf32>)
+      outs(%arg3 : tensor<?x?x8x8xf32>) -> tensor<?x?x8x8xf32>
+  return %1 : tensor<?x?x8x8xf32>
+}
+//      CHECK: func @mmt4d_dequant_f32i4f32(
+// CHECK-SAME:     %[[ARG0:[a-zA-Z0-9]+]]: tensor<?x?x8x1xf32>
+// CHECK-SAME:     %[[ARG1:[a-zA-Z0-9]+]]: tensor<?x?x8x1xi4>
+// CHECK-SAME:     %[[ARG2:[a-zA-Z0-9]+]]: tensor<?x?x8xf32>
+// CHECK-SAME:     %[[ARG3:[a-zA-Z0-9]+]]: tensor<?x?x8x8xf32>
+//  CHECK-DAG:   %[[FLAGS:.+]] = arith.constant 1287 : i32
+//  CHECK-DAG:   %[[GROUP_SIZE:.+]] = arith.constant 4 : i32
+//  CHECK-NOT:   linalg.generic
+//      CHECK:   %[[MICRO_KERNEL:.+]] = iree_codegen.ukernel.generic "iree_uk_mmt4d_dequant"
+// CHECK-SAME:       ins(%[[ARG0]], %[[ARG1]], %[[ARG2]] :
+// CHECK-SAME:       outs(%[[ARG3]] :
+// CHECK-SAME:       %[[FLAGS]], %[[GROUP_SIZE]] :
+// CHECK-SAME:       strided_outer_dims(1)
+//      CHECK:   return %[[MICRO_KERNEL]]
+
+// -----
+
+// Check that scales indexed by the K-tile give groups of one K-tile, here of
+// K0 = 2 elements.
+func.func @mmt4d_dequant_f16i8f32(%arg0 : tensor<?x?x8x2xf16>, %arg1 : tensor<?x?x8x2xi8>,
+    %arg2 : tensor<?x?x8xf32>, %arg3 : tensor<?x?x8x8xf32>,
+    %arg4 : tensor<?x?x8x2xf32>) -> tensor<?x?x8x8xf32> {
+  %0 = linalg.generic {
+      indexing_maps = [affine_map<(d0, d1, d2, d3) -> (d0, d1, d2, d3)>,
+                       affine_map<(d0, d1, d2, d3) -> (d0, d1, d2)>,
+                       affine_map<(d0, d1, d2, d3) -> (d0, d1, d2, d3)>],
+      iterator_types = ["parallel", "parallel", "parallel", "parallel"]}
+      ins(%arg1, %arg2 : tensor<?x?x8x2xi8>, tensor<?x?x8xf32>)
+      outs(%arg4 : tensor<?x?x8x2xf32>) {
+  ^bb0(%in: i8, %scale: f32, %out: f32):
+    %2 = arith.sitofp %in : i8 to f32
+    %3 = arith.mulf %scale, %2 : f32
+    linalg.yield %3 : f32
+  } -> tensor<?x?x8x2xf32>
+  %1 = linalg.mmt4d ins(%arg0, %0 : tensor<?x?x8x2xf16>, tensor<?x?x8x2xf32>)
+      outs(%arg3 : tensor<?x?x8x8xf32>) -> tensor<?x?x8x8xf32>
+  return %1 : tensor<?x?x8x8xf32>
+}
+//      CHECK: func @mmt4d_dequant_f16i8f32(
+// CHECK-SAME:     %[[ARG0:[a-zA-Z0-9]+]]: tensor<?x?x8x2xf16>
+// CHECK-SAME:     %[[ARG1:[a-zA-Z0-9]+]]: tensor<?x?x8x2xi8>
+// CHECK-SAME:     %[[ARG2:[a-zA-Z0-9]+]]: tensor<?x?x8xf32>
+// CHECK-SAME:     %[[ARG3:[a-zA-Z0-9]+]]: tensor<?x?x8x8xf32>
+//  CHECK-DAG:   %[[FLAGS:.+]] = arith.constant 1290 : i32
+//  CHECK-DAG:   %[[GROUP_SIZE:.+]] = arith.constant 2 : i32
+//  CHECK-NOT:   linalg.generic
+//      CHECK:   %[[MICRO_KERNEL:.+]] = iree_codegen.ukernel.generic "iree_uk_mmt4d_dequant"
+// CHECK-SAME:       ins(%[[ARG0]], %[[ARG1]], %[[ARG2]] :
+// CHECK-SAME:       outs(%[[ARG3]] :
+// CHECK-SAME:       %[[FLAGS]], %[[GROUP_SIZE]] :
+//      CHECK:   return %[[MICRO_KERNEL]]
+
+// -----
+
+// Check that a dequantized RHS that has other users is not folded into the
+// microkernel, as it needs to be materialized anyway.
+func.func @mmt4d_dequant_multiple_uses(%arg0 : tensor<?x?x8x1xf32>, %arg1 : tensor<?x?x8x1xi8>,
+    %arg2 : tensor<?x?x8xf32>, %arg3 : tensor<?x?x8x8xf32>,
+    %arg4 : tensor<?x?x8x1xf32>) -> (tensor<?x?x8x8xf32>, tensor<?x?x8x1xf32>) {
+  %0 = linalg.generic {
+      indexing_maps = [affine_map<(d0, d1, d2, d3) -> (d0, d1, d2, d3)>,
+                       affine_map<(d0, d1, d2, d3) -> (d0, d1, d2)>,
+                       affine_map<(d0, d1, d2, d3) -> (d0, d1, d2, d3)>],
+      iterator_types = ["parallel", "parallel", "parallel", "parallel"]}
+      ins(%arg1, %arg2 : tensor<?x?x8x1xi8>, tensor<?x?x8xf32>)
+      outs(%arg4 : tensor<?x?x8x1xf32>) {
+  ^bb0(%in: i8, %scale: f32, %out: f32):
+    %2 = arith.sitofp %in : i8 to f32
+    %3 = arith.mulf %2, %scale : f32
+    linalg.yield %3 : f32
+  } -> tensor<?x?x8x1xf32>
+  %1 = linalg.mmt4d ins(%arg0, %0 : tensor<?x?x8x1xf32>, tensor<?x?x8x1xf32>)
+      outs(%arg3 : tensor<?x?x8x8xf32>) -> tensor<?x?x8x8xf32>
+  return %1, %0 : tensor<?x?x8x8xf32>, tensor<?x?x8x1xf32>
+}
+//      CHECK: func @mmt4d_dequant_multiple_uses(
+//      CHECK:   %[[DEQUANT:.+]] = linalg.generic
+//      CHECK:   iree_codegen.ukernel.generic "iree_uk_mmt4d"
+// CHECK-SAME:       ins(%{{.+}}, %[[DEQUANT]] :
+
+// -----
+
+// Check that weight-only quantized mmt4d is not lowered to a microkernel on
+// VMVX, which does not support it.
+//      CHECK: func @mmt4d_f32i8f32_vmvx(
+//       CHECK: linalg.mmt4d
+func.func @mmt4d_f32i8f32_vmvx(%arg0 : tensor<?x?x?x?xf32>, %arg1 : tensor<?x?x?x?xi8>,
+    %arg2 : tensor<?x?x?x?xf32>) -> tensor<?x?x?x?xf32> attributes {
+  hal.executable.target = #hal.executable.target<"vmvx", "vmvx-bytecode-fb", {ukernels = true}>
+} {
+  %0 = linalg.mmt4d ins(%arg0, %arg1 : tensor<?x?x?x?xf32>, tensor<?x?x?x?xi8>)
+      outs(%arg2 : tensor<?x?x?x?xf32>) -> tensor<?x?x?x?xf32>
+  return %0 : tensor<?x?x?x?xf32>
+}
+
+// -----
+
 // Check that tensor.pack is not lowered to a microkernel by default - it should
 // only be on VMVX.
 //      CHECK: func @pack_i8i8_default(
@@ -503,3 +717,331 @@ func.func @query_tile_sizes_2d() -> (index, index)  attributes {
   %result:2 = iree_codegen.query_tile_sizes tensor<?x?xf32, #iree_linalg_ext.encoding<user=MATMUL_F32F32F32, role=RESULT>> -> index, index
   return %result#0, %result#1 : index, index
 }
+
+// -----
+
+//      CHECK: func @softmax_f32f32(
+// CHECK-SAME:     %[[ARG0:[a-zA-Z0-9]+]]: tensor<?x?xf32>
+// CHECK-SAME:     %[[ARG1:[a-zA-Z0-9]+]]: tensor<?x?xf32>
+//  CHECK-DAG:   %[[C0:.+]] = arith.constant 0 : index
+//  CHECK-DAG:   %[[C1:.+]] = arith.constant 1 : index
+//  CHECK-DAG:   %[[FLAGS:.+]] = arith.constant 1 : i32
+//  CHECK-DAG:   %[[SIZE0:.+]] = tensor.dim %[[ARG0]], %[[C0]]
+//  CHECK-DAG:   %[[SIZE1:.+]] = tensor.dim %[[ARG0]], %[[C1]]
+//      CHECK:   %[[MICRO_KERNEL:.+]] = iree_codegen.ukernel.generic "iree_uk_softmax"
+// CHECK-SAME:       ins(%[[ARG0]] :
+// CHECK-SAME:       outs(%[[ARG1]] :
+// CHECK-SAME:       (%[[SIZE0]], %[[SIZE1]], %[[FLAGS]] :
+//      CHECK:   return %[[MICRO_KERNEL]]
+func.func @softmax_f32f32(%arg0 : tensor<?x?xf32>, %arg1 : tensor<?x?xf32>) -> tensor<?x?xf32> attributes {
+  hal.executable.target = #hal.executable.target<"llvm-cpu", "embedded-elf-x86_64", {ukernels = true}>
+} {
+  %result = iree_linalg_ext.softmax dimension(1) ins(%arg0 : tensor<?x?xf32>) outs(%arg1 : tensor<?x?xf32>) -> tensor<?x?xf32>
+  func.return %result : tensor<?x?xf32>
+}
+
+// -----
+
+// Softmax over an outer dimension is left to codegen.
+//      CHECK: func @softmax_f32f32_outer_dim(
+//  CHECK-NOT:   iree_codegen.ukernel.generic
+//      CHECK:   iree_linalg_ext.softmax
+func.func @softmax_f32f32_outer_dim(%arg0 : tensor<?x?xf32>, %arg1 : tensor<?x?xf32>) -> tensor<?x?xf32> attributes {
+  hal.executable.target = #hal.executable.target<"llvm-cpu", "embedded-elf-x86_64", {ukernels = true}>
+} {
+  %result = iree_linalg_ext.softmax dimension(0) ins(%arg0 : tensor<?x?xf32>) outs(%arg1 : tensor<?x?xf32>) -> tensor<?x?xf32>
+  func.return %result : tensor<?x?xf32>
+}
+
+// -----
+
+//      CHECK: func @reduce_sum_f32f32_zero_init(
+// CHECK-SAME:     %[[ARG0:[a-zA-Z0-9]+]]: tensor<?x?xf32>
+// CHECK-SAME:     %[[ARG1:[a-zA-Z0-9]+]]: tensor<?xf32>
+//  CHECK-DAG:   %[[C0:.+]] = arith.constant 0 : index
+//  CHECK-DAG:   %[[C1:.+]] = arith.constant 1 : index
+//  CHECK-DAG:   %[[FLAGS:.+]] = arith.constant 257 : i32
+//  CHECK-DAG:   %[[SIZE0:.+]] = tensor.dim %[[ARG0]], %[[C0]]
+//  CHECK-DAG:   %[[SIZE1:.+]] = tensor.dim %[[ARG0]], %[[C1]]
+//  CHECK-NOT:   linalg.fill
+//      CHECK:   %[[MICRO_KERNEL:.+]] = iree_codegen.ukernel.generic "iree_uk_reduce"
+// CHECK-SAME:       ins(%[[ARG0]] :
+// CHECK-SAME:       outs(%[[ARG1]] :
+// CHECK-SAME:       (%[[SIZE0]], %[[SIZE1]], %[[FLAGS]] :
+//      CHECK:   return %[[MICRO_KERNEL]]
+func.func @reduce_sum_f32f32_zero_init(%arg0 : tensor<?x?xf32>, %arg1 : tensor<?xf32>) -> tensor<?xf32> attributes {
+  hal.executable.target = #hal.executable.target<"llvm-cpu", "embedded-elf-x86_64", {ukernels = true}>
+} {
+  %zero = arith.constant 0.0 : f32
+  %fill = linalg.fill ins(%zero : f32) outs(%arg1 : tensor<?xf32>) -> tensor<?xf32>
+  %result = linalg.generic {
+      indexing_maps = [affine_map<(d0, d1) -> (d0, d1)>, affine_map<(d0, d1) -> (d0)>],
+      iterator_types = ["parallel", "reduction"]}
+      ins(%arg0 : tensor<?x?xf32>) outs(%fill : tensor<?xf32>) {
+  ^bb0(%in: f32, %out: f32):
+    %0 = arith.addf %in, %out : f32
+    linalg.yield %0 : f32
+  } -> tensor<?xf32>
+  func.return %result : tensor<?xf32>
+}
+
+// -----
+
+//      CHECK: func @reduce_max_f32f32(
+// CHECK-SAME:     %[[ARG0:[a-zA-Z0-9]+]]: tensor<?x?xf32>
+// CHECK-SAME:     %[[ARG1:[a-zA-Z0-9]+]]: tensor<?xf32>
+//  CHECK-DAG:   %[[FLAGS:.+]] = arith.constant 4609 : i32
+//      CHECK:   %[[MICRO_KERNEL:.+]] = iree_codegen.ukernel.generic "iree_uk_reduce"
+// CHECK-SAME:       ins(%[[ARG0]] :
+// CHECK-SAME:       outs(%[[ARG1]] :
+// CHECK-SAME:       %[[FLAGS]] :
+//      CHECK:   return %[[MICRO_KERNEL]]
+func.func @reduce_max_f32f32(%arg0 : tensor<?x?xf32>, %arg1 : tensor<?xf32>) -> tensor<?xf32> attributes {
+  hal.executable.target = #hal.executable.target<"llvm-cpu", "embedded-elf-x86_64", {ukernels = true}>
+} {
+  %result = linalg.generic {
+      indexing_maps = [affine_map<(d0, d1) -> (d0, d1)>, affine_map<(d0, d1) -> (d0)>],
+      iterator_types = ["parallel", "reduction"]}
+      ins(%arg0 : tensor<?x?xf32>) outs(%arg1 : tensor<?xf32>) {
+  ^bb0(%in: f32, %out: f32):
+    %0 = arith.maxf %out, %in : f32
+    linalg.yield %0 : f32
+  } -> tensor<?xf32>
+  func.return %result : tensor<?xf32>
+}
+
+// -----
+
+// Reductions on VMVX have no microkernel and are left to codegen.
+//      CHECK: func @reduce_sum_f32f32_vmvx(
+//  CHECK-NOT:   iree_codegen.ukernel.generic
+//      CHECK:   linalg.generic
+func.func @reduce_sum_f32f32_vmvx(%arg0 : tensor<?x?xf32>, %arg1 : tensor<?xf32>) -> tensor<?xf32> attributes {
+  hal.executable.target = #hal.executable.target<"vmvx", "vmvx-bytecode-fb", {ukernels = true}>
+} {
+  %result = linalg.generic {
+      indexing_maps = [affine_map<(d0, d1) -> (d0, d1)>, affine_map<(d0, d1) -> (d0)>],
+      iterator_types = ["parallel", "reduction"]}
+      ins(%arg0 : tensor<?x?xf32>) outs(%arg1 : tensor<?xf32>) {
+  ^bb0(%in: f32, %out: f32):
+    %0 = arith.addf %in, %out : f32
+    linalg.yield %0 : f32
+  } -> tensor<?xf32>
+  func.return %result : tensor<?xf32>
+}
+
+// -----
+
+// Without ukernels enabled on the target, reductions are left to codegen.
+//      CHECK: func @reduce_sum_f32f32_no_ukernels(
+//  CHECK-NOT:   iree_codegen.ukernel.generic
+//      CHECK:   linalg.generic
+func.func @reduce_sum_f32f32_no_ukernels(%arg0 : tensor<?x?xf32>, %arg1 : tensor<?xf32>) -> tensor<?xf32> attributes {
+  hal.executable.target = #hal.executable.target<"llvm-cpu", "embedded-elf-x86_64", {ukernels = false}>
+} {
+  %result = linalg.generic {
+      indexing_maps = [affine_map<(d0, d1) -> (d0, d1)>, affine_map<(d0, d1) -> (d0)>],
+      iterator_types = ["parallel", "reduction"]}
+      ins(%arg0 : tensor<?x?xf32>) outs(%arg1 : tensor<?xf32>) {
+  ^bb0(%in: f32, %out: f32):
+    %0 = arith.addf %in, %out : f32
+    linalg.yield %0 : f32
+  } -> tensor<?xf32>
+  func.return %result : tensor<?xf32>
+}
+
+// -----
+
+//      CHECK: func @layernorm_f32f32(
+// CHECK-SAME:     %[[ARG0:[a-zA-Z0-9]+]]: tensor<?x128xf32>
+// CHECK-SAME:     %[[GAMMA:[a-zA-Z0-9]+]]: tensor<128xf32>
+// CHECK-SAME:     %[[BETA:[a-zA-Z0-9]+]]: tensor<128xf32>
+//  CHECK-DAG:   %[[C0:.+]] = arith.constant 0 : index
+//  CHECK-DAG:   %[[C128:.+]] = arith.constant 128 : index
+//  CHECK-DAG:   %[[EPS:.+]] = arith.constant 9.99999974E-6 : f32
+//  CHECK-DAG:   %[[FLAGS:.+]] = arith.constant 1 : i32
+//  CHECK-DAG:   %[[SIZE0:.+]] = tensor.dim %[[ARG0]], %[[C0]]
+//  CHECK-DAG:   %[[EMPTY:.+]] = tensor.empty(%[[SIZE0]]) : tensor<?x128xf32>
+//  CHECK-NOT:   linalg.generic
+//      CHECK:   %[[MICRO_KERNEL:.+]] = iree_codegen.ukernel.generic "iree_uk_layernorm"
+// CHECK-SAME:       ins(%[[ARG0]], %[[GAMMA]], %[[BETA]] :
+// CHECK-SAME:       outs(%[[EMPTY]] :
+// CHECK-SAME:       (%[[SIZE0]], %[[C128]], %[[EPS]], %[[FLAGS]] :
+// CHECK-SAME:       strided_outer_dims(1)
+//  CHECK-NOT:   linalg.generic
+//      CHECK:   return %[[MICRO_KERNEL]]
+func.func @layernorm_f32f32(%x : tensor<?x128xf32>, %gamma : tensor<128xf32>, %beta : tensor<128xf32>) -> tensor<?x128xf32> attributes {
+  hal.executable.target = #hal.executable.target<"llvm-cpu", "embedded-elf-x86_64", {ukernels = true}>
+} {
+  %c0 = arith.constant 0 : index
+  %zero = arith.constant 0.0 : f32
+  %n = arith.constant 128.0 : f32
+  %eps = arith.constant 1.0e-05 : f32
+  %size0 = tensor.dim %x, %c0 : tensor<?x128xf32>
+  %empty_rows = tensor.empty(%size0) : tensor<?xf32>
+  %fill = linalg.fill ins(%zero : f32) outs(%empty_rows : tensor<?xf32>) -> tensor<?xf32>
+  %sum = linalg.generic {
+      indexing_maps = [affine_map<(d0, d1) -> (d0, d1)>, affine_map<(d0, d1) -> (d0)>],
+      iterator_types = ["parallel", "reduction"]}
+      ins(%x : tensor<?x128xf32>) outs(%fill : tensor<?xf32>) {
+  ^bb0(%in: f32, %out: f32):
+    %0 = arith.addf %in, %out : f32
+    linalg.yield %0 : f32
+  } -> tensor<?xf32>
+  %csq = linalg.generic {
+      indexing_maps = [affine_map<(d0, d1) -> (d0, d1)>, affine_map<(d0, d1) -> (d0)>, affine_map<(d0, d1) -> (d0)>],
+      iterator_types = ["parallel", "reduction"]}
+      ins(%x, %sum : tensor<?x128xf32>, tensor<?xf32>) outs(%fill : tensor<?xf32>) {
+  ^bb0(%in: f32, %s: f32, %out: f32):
+    %0 = arith.divf %s, %n : f32
+    %1 = arith.subf %in, %0 : f32
+    %2 = arith.mulf %1, %1 : f32
+    %3 = arith.addf %2, %out : f32
+    linalg.yield %3 : f32
+  } -> tensor<?xf32>
+  %empty = tensor.empty(%size0) : tensor<?x128xf32>
+  %result = linalg.generic {
+      indexing_maps = [affine_map<(d0, d1) -> (d0, d1)>, affine_map<(d0, d1) -> (d0)>, affine_map<(d0, d1) -> (d0)>,
+                       affine_map<(d0, d1) -> (d1)>, affine_map<(d0, d1) -> (d1)>, affine_map<(d0, d1) -> (d0, d1)>],
+      iterator_types = ["parallel", "parallel"]}
+      ins(%x, %sum, %csq, %gamma, %beta : tensor<?x128xf32>, tensor<?xf32>, tensor<?xf32>, tensor<128xf32>, tensor<128xf32>)
+      outs(%empty : tensor<?x128xf32>) {
+  ^bb0(%in: f32, %s: f32, %c: f32, %g: f32, %b: f32, %out: f32):
+    %0 = arith.divf %s, %n : f32
+    %1 = arith.subf %in, %0 : f32
+    %2 = arith.divf %c, %n : f32
+    %3 = arith.addf %2, %eps : f32
+    %4 = math.rsqrt %3 : f32
+    %5 = arith.mulf %1, %4 : f32
+    %6 = arith.mulf %5, %g : f32
+    %7 = arith.addf %6, %b : f32
+    linalg.yield %7 : f32
+  } -> tensor<?x128xf32>
+  func.return %result : tensor<?x128xf32>
+}
+
+// -----
+
+//      CHECK: func @rmsnorm_f32f32(
+// CHECK-SAME:     %[[ARG0:[a-zA-Z0-9]+]]: tensor<?x64xf32>
+// CHECK-SAME:     %[[GAMMA:[a-zA-Z0-9]+]]: tensor<64xf32>
+//  CHECK-DAG:   %[[C64:.+]] = arith.constant 64 : index
+//  CHECK-DAG:   %[[FLAGS:.+]] = arith.constant 257 : i32
+//  CHECK-NOT:   linalg.generic
+//      CHECK:   %[[MICRO_KERNEL:.+]] = iree_codegen.ukernel.generic "iree_uk_layernorm"
+// CHECK-SAME:       ins(%[[ARG0]], %[[GAMMA]], %[[GAMMA]] :
+// CHECK-SAME:       (%{{.+}}, %[[C64]], %{{.+}}, %[[FLAGS]] :
+//  CHECK-NOT:   linalg.generic
+//      CHECK:   return %[[MICRO_KERNEL]]
+func.func @rmsnorm_f32f32(%x : tensor<?x64xf32>, %gamma : tensor<64xf32>) -> tensor<?x64xf32> attributes {
+  hal.executable.target = #hal.executable.target<"llvm-cpu", "embedded-elf-x86_64", {ukernels = true}>
+} {
+  %c0 = arith.constant 0 : index
+  %zero = arith.constant 0.0 : f32
+  %inv_n = arith.constant 0.015625 : f32
+  %eps = arith.constant 1.0e-06 : f32
+  %size0 = tensor.dim %x, %c0 : tensor<?x64xf32>
+  %empty_rows = tensor.empty(%size0) : tensor<?xf32>
+  %fill = linalg.fill ins(%zero : f32) outs(%empty_rows : tensor<?xf32>) -> tensor<?xf32>
+  %sumsq = linalg.generic {
+      indexing_maps = [affine_map<(d0, d1) -> (d0, d1)>, affine_map<(d0, d1) -> (d0)>],
+      iterator_types = ["parallel", "reduction"]}
+      ins(%x : tensor<?x64xf32>) outs(%fill : tensor<?xf32>) {
+  ^bb0(%in: f32, %out: f32):
+    %0 = arith.mulf %in, %in : f32
+    %1 = arith.addf %0, %out : f32
+    linalg.yield %1 : f32
+  } -> tensor<?xf32>
+  %empty = tensor.empty(%size0) : tensor<?x64xf32>
+  %result = linalg.generic {
+      indexing_maps = [affine_map<(d0, d1) -> (d0, d1)>, affine_map<(d0, d1) -> (d0)>,
+                       affine_map<(d0, d1) -> (d1)>, affine_map<(d0, d1) -> (d0, d1)>],
+      iterator_types = ["parallel", "parallel"]}
+      ins(%x, %sumsq, %gamma : tensor<?x64xf32>, tensor<?xf32>, tensor<64xf32>)
+      outs(%empty : tensor<?x64xf32>) {
+  ^bb0(%in: f32, %s: f32, %g: f32, %out: f32):
+    %0 = arith.mulf %s, %inv_n : f32
+    %1 = arith.addf %0, %eps : f32
+    %2 = math.rsqrt %1 : f32
+    %3 = arith.mulf %g, %in : f32
+    %4 = arith.mulf %3, %2 : f32
+    linalg.yield %4 : f32
+  } -> tensor<?x64xf32>
+  func.return %result : tensor<?x64xf32>
+}
+
+// -----
+
+func.func @batch_mmt4d_f32f32f32(%arg0 : tensor<?x?x?x?x?xf32>, %arg1 : tensor<?x?x?x?x?xf32>,
+    %arg2 : tensor<?x?x?x?x?xf32>) -> tensor<?x?x?x?x?xf32> attributes {
+  hal.executable.target = #hal.executable.target<"llvm-cpu", "embedded-elf-x86_64", {ukernels = true}>
+} {
+  %0 = linalg.batch_mmt4d ins(%arg0, %arg1 : tensor<?x?x?x?x?xf32>, tensor<?x?x?x?x?xf32>)
+      outs(%arg2 : tensor<?x?x?x?x?xf32>) -> tensor<?x?x?x?x?xf32>
+  return %0 : tensor<?x?x?x?x?xf32>
+}
+//      CHECK: func @batch_mmt4d_f32f32f32(
+// CHECK-SAME:     %[[ARG0:[a-zA-Z0-9]+]]: tensor<?x?x?x?x?xf32>
+// CHECK-SAME:     %[[ARG1:[a-zA-Z0-9]+]]: tensor<?x?x?x?x?xf32>
+// CHECK-SAME:     %[[ARG2:[a-zA-Z0-9]+]]: tensor<?x?x?x?x?xf32>
+//  CHECK-DAG:   %[[C0:.+]] = arith.constant 0 : index
+//  CHECK-DAG:   %[[C1:.+]] = arith.constant 1
+//  CHECK-DAG:   %[[C2:.+]] = arith.constant 2
+//  CHECK-DAG:   %[[C3:.+]] = arith.constant 3
+//  CHECK-DAG:   %[[C4:.+]] = arith.constant 4
+//  CHECK-DAG:   %[[FLAGS:.+]] = arith.constant 1281 : i32
+//  CHECK-DAG:   %[[B:.+]] = tensor.dim %[[ARG0]], %[[C0]]
+//  CHECK-DAG:   %[[M:.+]] = tensor.dim %[[ARG0]], %[[C1]]
+//  CHECK-DAG:   %[[N:.+]] = tensor.dim %[[ARG1]], %[[C1]]
+//  CHECK-DAG:   %[[K:.+]] = tensor.dim %[[ARG1]], %[[C2]]
+//  CHECK-DAG:   %[[M0_index:.+]] = tensor.dim %[[ARG0]], %[[C3]]
+//  CHECK-DAG:   %[[M0:.+]] = arith.index_cast %[[M0_index]] : index to i32
+//  CHECK-DAG:   %[[N0_index:.+]] = tensor.dim %[[ARG1]], %[[C3]]
+//  CHECK-DAG:   %[[N0:.+]] = arith.index_cast %[[N0_index]] : index to i32
+//  CHECK-DAG:   %[[K0_index:.+]] = tensor.dim %[[ARG1]], %[[C4]]
+//  CHECK-DAG:   %[[K0:.+]] = arith.index_cast %[[K0_index]] : index to i32
+//      CHECK:   %[[MICRO_KERNEL:.+]] = iree_codegen.ukernel.generic "iree_uk_batch_mmt4d"
+// CHECK-SAME:       ins(%[[ARG0]], %[[ARG1]] :
+// CHECK-SAME:       outs(%[[ARG2]] :
+// CHECK-SAME:       (%[[B]], %[[M]], %[[N]], %[[K]], %[[M0]], %[[N0]], %[[K0]], %[[FLAGS]] :
+// CHECK-SAME:       strided_outer_dims(2)
+//      CHECK:   return %[[MICRO_KERNEL]]
+
+// -----
+
+func.func @batch_mmt4d_fill_f32f32f32(%arg0 : tensor<?x?x?x16x1xf32>, %arg1 : tensor<?x?x?x16x1xf32>,
+    %arg2 : tensor<?x?x?x16x16xf32>) -> tensor<?x?x?x16x16xf32> attributes {
+  hal.executable.target = #hal.executable.target<"llvm-cpu", "embedded-elf-x86_64", {ukernels = true}>
+} {
+  %cst = arith.constant 0.0 : f32
+  %fill = linalg.fill ins(%cst : f32) outs(%arg2 : tensor<?x?x?x16x16xf32>) -> tensor<?x?x?x16x16xf32>
+  %0 = linalg.batch_mmt4d ins(%arg0, %arg1 : tensor<?x?x?x16x1xf32>, tensor<?x?x?x16x1xf32>)
+      outs(%fill : tensor<?x?x?x16x16xf32>) -> tensor<?x?x?x16x16xf32>
+  return %0 : tensor<?x?x?x16x16xf32>
+}
+//      CHECK: func @batch_mmt4d_fill_f32f32f32(
+// CHECK-SAME:     %[[ARG0:[a-zA-Z0-9]+]]: tensor<?x?x?x16x1xf32>
+// CHECK-SAME:     %[[ARG1:[a-zA-Z0-9]+]]: tensor<?x?x?x16x1xf32>
+// CHECK-SAME:     %[[ARG2:[a-zA-Z0-9]+]]: tensor<?x?x?x16x16xf32>
+//  CHECK-DAG:   %[[FLAGS:.+]] = arith.constant 1025 : i32
+//  CHECK-NOT:   linalg.fill
+//      CHECK:   %[[MICRO_KERNEL:.+]] = iree_codegen.ukernel.generic "iree_uk_batch_mmt4d"
+// CHECK-SAME:       ins(%[[ARG0]], %[[ARG1]] :
+// CHECK-SAME:       outs(%[[ARG2]] :
+// CHECK-SAME:       %[[FLAGS]] :
+//      CHECK:   return %[[MICRO_KERNEL]]
+
+// -----
+
+// VMVX has no batch_mmt4d microkernel.
+//      CHECK: func @batch_mmt4d_vmvx(
+//  CHECK-NOT:   iree_codegen.ukernel.generic
+//      CHECK:   linalg.batch_mmt4d
+func.func @batch_mmt4d_vmvx(%arg0 : tensor<?x?x?x?x?xf32>, %arg1 : tensor<?x?x?x?x?xf32>,
+    %arg2 : tensor<?x?x?x?x?xf32>) -> tensor<?x?x?x?x?xf32> attributes {
+  hal.executable.target = #hal.executable.target<"vmvx", "vmvx-bytecode-fb", {ukernels = true}>
+} {
+  %0 = linalg.batch_mmt4d ins(%arg0, %arg1 : tensor<?x?x?x?x?xf32>, tensor<?x?x?x?x?xf32>)
+      outs(%arg2 : tensor<?x?x?x?x?xf32>) -> tensor<?x?x?x?x?xf32>
+  return %0 : tensor<?x?x?x?x?xf32>
+}
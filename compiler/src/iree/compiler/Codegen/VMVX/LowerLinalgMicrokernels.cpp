@@ -341,9 +341,11 @@ struct UnaryEmitter {
     OpType opType;
     // If the OpType takes an opcode, this is it.
     StringRef opcode;
+    // The element type of the op, if it is not that of the operand.
+    Type elementType;
 
-    static OpSelection genericUnary(StringRef opcode) {
-      return OpSelection{OpType::GenericUnary, opcode};
+    static OpSelection genericUnary(StringRef opcode, Type elementType = {}) {
+      return OpSelection{OpType::GenericUnary, opcode, elementType};
     }
   };
   struct Descriptor {
@@ -420,7 +422,8 @@ struct UnaryEmitter {
           // Sizes
           params.sizes,
           // Attributes
-          operand.bufferDesc->getElementTypeAttr());
+          selection.elementType ? TypeAttr::get(selection.elementType)
+                                : operand.bufferDesc->getElementTypeAttr());
 
       break;
     }
@@ -521,6 +524,10 @@ struct CopyEmitter {
   }
 };
 
+// Returns true if |type| is a 16-bit float type. The VMVX module computes
+// these in f32 and rounds back, so they support the same float opcodes as f32.
+static bool is16BitFloat(Type type) { return type.isF16() || type.isBF16(); }
+
 /// Matches a generic which contains an expressible binary operation, emitting
 /// as a vmvx op.
 struct LinalgBinaryGenericConversion
@@ -603,7 +610,8 @@ struct LinalgBinaryGenericConversion
     std::optional<BinaryEmitter> emitter =
         TypeSwitch<Operation *, std::optional<BinaryEmitter>>(binaryOp)
             .Case([&](arith::AddFOp op) -> std::optional<BinaryEmitter> {
-              if (resultType.getIntOrFloatBitWidth() == 32) {
+              if (resultType.getIntOrFloatBitWidth() == 32 ||
+                  is16BitFloat(resultType)) {
                 return configureGenericBinary(op, "add");
               }
               return std::nullopt;
@@ -621,7 +629,8 @@ struct LinalgBinaryGenericConversion
               return std::nullopt;
             })
             .Case([&](arith::DivFOp op) -> std::optional<BinaryEmitter> {
-              if (resultType.getIntOrFloatBitWidth() == 32) {
+              if (resultType.getIntOrFloatBitWidth() == 32 ||
+                  is16BitFloat(resultType)) {
                 return configureGenericBinary(op, "div");
               }
               return std::nullopt;
@@ -639,7 +648,8 @@ struct LinalgBinaryGenericConversion
               return std::nullopt;
             })
             .Case([&](arith::MulFOp op) -> std::optional<BinaryEmitter> {
-              if (resultType.getIntOrFloatBitWidth() == 32) {
+              if (resultType.getIntOrFloatBitWidth() == 32 ||
+                  is16BitFloat(resultType)) {
                 return configureGenericBinary(op, "mul");
               }
               return std::nullopt;
@@ -675,7 +685,8 @@ struct LinalgBinaryGenericConversion
               return std::nullopt;
             })
             .Case([&](arith::SubFOp op) -> std::optional<BinaryEmitter> {
-              if (resultType.getIntOrFloatBitWidth() == 32) {
+              if (resultType.getIntOrFloatBitWidth() == 32 ||
+                  is16BitFloat(resultType)) {
                 return configureGenericBinary(op, "sub");
               }
               return std::nullopt;
@@ -738,13 +749,15 @@ struct LinalgUnaryGenericConversion
 
     // Returns an emitter for a generic binary compatible operation where
     // |binaryOp| has a 1:1 correspondance with |opcode|.
+    // For conversions, |elementType| is the 16-bit side of the conversion.
     auto configureGenericUnary =
-        [&](Operation *unaryOp,
-            StringRef opcode) -> std::optional<UnaryEmitter> {
+        [&](Operation *unaryOp, StringRef opcode,
+            Type elementType = {}) -> std::optional<UnaryEmitter> {
       SmallVector<UnaryEmitter::Descriptor, 2> operands;
       // Make sure that the binary op has operands that map to the
       // ins and detect the order.
-      auto selection = UnaryEmitter::OpSelection::genericUnary(opcode);
+      auto selection =
+          UnaryEmitter::OpSelection::genericUnary(opcode, elementType);
       return UnaryEmitter(
           UnaryEmitter::Descriptor(operand0->get(),
                                    op.getMatchingIndexingMap(operand0)),
@@ -761,13 +774,15 @@ struct LinalgUnaryGenericConversion
     std::optional<UnaryEmitter> emitter =
         TypeSwitch<Operation *, std::optional<UnaryEmitter>>(unaryOp)
             .Case([&](math::AbsFOp op) -> std::optional<UnaryEmitter> {
-              if (resultType.getIntOrFloatBitWidth() == 32) {
+              if (resultType.getIntOrFloatBitWidth() == 32 ||
+                  is16BitFloat(resultType)) {
                 return configureGenericUnary(op, "abs");
               }
               return std::nullopt;
             })
             .Case([&](math::CeilOp op) -> std::optional<UnaryEmitter> {
-              if (resultType.getIntOrFloatBitWidth() == 32) {
+              if (resultType.getIntOrFloatBitWidth() == 32 ||
+                  is16BitFloat(resultType)) {
                 return configureGenericUnary(op, "ceil");
               }
               return std::nullopt;
@@ -780,31 +795,49 @@ struct LinalgUnaryGenericConversion
               return std::nullopt;
             })
             .Case([&](math::ExpOp op) -> std::optional<UnaryEmitter> {
-              if (resultType.getIntOrFloatBitWidth() == 32) {
+              if (resultType.getIntOrFloatBitWidth() == 32 ||
+                  is16BitFloat(resultType)) {
                 return configureGenericUnary(op, "exp");
               }
               return std::nullopt;
             })
             .Case([&](math::FloorOp op) -> std::optional<UnaryEmitter> {
-              if (resultType.getIntOrFloatBitWidth() == 32) {
+              if (resultType.getIntOrFloatBitWidth() == 32 ||
+                  is16BitFloat(resultType)) {
                 return configureGenericUnary(op, "floor");
               }
               return std::nullopt;
             })
             .Case([&](math::LogOp op) -> std::optional<UnaryEmitter> {
-              if (resultType.getIntOrFloatBitWidth() == 32) {
+              if (resultType.getIntOrFloatBitWidth() == 32 ||
+                  is16BitFloat(resultType)) {
                 return configureGenericUnary(op, "log");
               }
               return std::nullopt;
             })
             .Case([&](arith::NegFOp op) -> std::optional<UnaryEmitter> {
-              if (resultType.getIntOrFloatBitWidth() == 32) {
+              if (resultType.getIntOrFloatBitWidth() == 32 ||
+                  is16BitFloat(resultType)) {
                 return configureGenericUnary(op, "neg");
               }
               return std::nullopt;
             })
+            .Case([&](arith::ExtFOp op) -> std::optional<UnaryEmitter> {
+              Type inType = op.getIn().getType();
+              if (resultType.isF32() && is16BitFloat(inType)) {
+                return configureGenericUnary(op, "extf", inType);
+              }
+              return std::nullopt;
+            })
+            .Case([&](arith::TruncFOp op) -> std::optional<UnaryEmitter> {
+              if (op.getIn().getType().isF32() && is16BitFloat(resultType)) {
+                return configureGenericUnary(op, "truncf", resultType);
+              }
+              return std::nullopt;
+            })
             .Case([&](math::RsqrtOp op) -> std::optional<UnaryEmitter> {
-              if (resultType.getIntOrFloatBitWidth() == 32) {
+              if (resultType.getIntOrFloatBitWidth() == 32 ||
+                  is16BitFloat(resultType)) {
                 return configureGenericUnary(op, "rsqrt");
               }
               return std::nullopt;
@@ -340,3 +340,78 @@ func.func @rsqrt(%arg0 : memref<64x64xf32>, %arg1 : memref<64xf32>) {
   }
   func.return
 }
+
+// 16-bit float ops.
+// CHECK-LABEL: @addf_f16
+// CHECK: vmvx.binary op("add" : f16)
+func.func @addf_f16(%arg0 : memref<64x64xf16>, %arg1 : memref<64xf16>) {
+  linalg.generic {indexing_maps = [affine_map<(d0, d1) -> (d1)>, affine_map<(d0, d1) -> (d0, d1)>], iterator_types = ["parallel", "parallel"]}
+    ins(%arg1 : memref<64xf16>) outs(%arg0 : memref<64x64xf16>) {
+  ^bb0(%arg2: f16, %arg3: f16):
+    %12 = arith.addf %arg2, %arg3 : f16
+    linalg.yield %12 : f16
+  }
+  func.return
+}
+
+// CHECK-LABEL: @mulf_bf16
+// CHECK: vmvx.binary op("mul" : bf16)
+func.func @mulf_bf16(%arg0 : memref<64x64xbf16>, %arg1 : memref<64xbf16>) {
+  linalg.generic {indexing_maps = [affine_map<(d0, d1) -> (d1)>, affine_map<(d0, d1) -> (d0, d1)>], iterator_types = ["parallel", "parallel"]}
+    ins(%arg1 : memref<64xbf16>) outs(%arg0 : memref<64x64xbf16>) {
+  ^bb0(%arg2: bf16, %arg3: bf16):
+    %12 = arith.mulf %arg2, %arg3 : bf16
+    linalg.yield %12 : bf16
+  }
+  func.return
+}
+
+// CHECK-LABEL: @expf_bf16
+// CHECK: vmvx.unary op("exp" : bf16)
+func.func @expf_bf16(%arg0 : memref<64x64xbf16>, %arg1 : memref<64xbf16>) {
+  linalg.generic {indexing_maps = [affine_map<(d0, d1) -> (d1)>, affine_map<(d0, d1) -> (d0, d1)>], iterator_types = ["parallel", "parallel"]}
+    ins(%arg1 : memref<64xbf16>) outs(%arg0 : memref<64x64xbf16>) {
+  ^bb0(%arg2: bf16, %arg3: bf16):
+    %12 = math.exp %arg2 : bf16
+    linalg.yield %12 : bf16
+  }
+  func.return
+}
+
+// CHECK-LABEL: @addi_i16_not_converted
+// CHECK-NOT: vmvx.binary
+// CHECK: linalg.generic
+func.func @addi_i16_not_converted(%arg0 : memref<64x64xi16>, %arg1 : memref<64xi16>) {
+  linalg.generic {indexing_maps = [affine_map<(d0, d1) -> (d1)>, affine_map<(d0, d1) -> (d0, d1)>], iterator_types = ["parallel", "parallel"]}
+    ins(%arg1 : memref<64xi16>) outs(%arg0 : memref<64x64xi16>) {
+  ^bb0(%arg2: i16, %arg3: i16):
+    %12 = arith.addi %arg2, %arg3 : i16
+    linalg.yield %12 : i16
+  }
+  func.return
+}
+
+// Conversions. The element type is the 16-bit side of the conversion.
+// CHECK-LABEL: @extf_f16
+// CHECK: vmvx.unary op("extf" : f16)
+func.func @extf_f16(%arg0 : memref<64x64xf32>, %arg1 : memref<64x64xf16>) {
+  linalg.generic {indexing_maps = [affine_map<(d0, d1) -> (d0, d1)>, affine_map<(d0, d1) -> (d0, d1)>], iterator_types = ["parallel", "parallel"]}
+    ins(%arg1 : memref<64x64xf16>) outs(%arg0 : memref<64x64xf32>) {
+  ^bb0(%arg2: f16, %arg3: f32):
+    %12 = arith.extf %arg2 : f16 to f32
+    linalg.yield %12 : f32
+  }
+  func.return
+}
+
+// CHECK-LABEL: @truncf_bf16
+// CHECK: vmvx.unary op("truncf" : bf16)
+func.func @truncf_bf16(%arg0 : memref<64x64xbf16>, %arg1 : memref<64x64xf32>) {
+  linalg.generic {indexing_maps = [affine_map<(d0, d1) -> (d0, d1)>, affine_map<(d0, d1) -> (d0, d1)>], iterator_types = ["parallel", "parallel"]}
+    ins(%arg1 : memref<64x64xf32>) outs(%arg0 : memref<64x64xbf16>) {
+  ^bb0(%arg2: f32, %arg3: bf16):
+    %12 = arith.truncf %arg2 : f32 to bf16
+    linalg.yield %12 : bf16
+  }
+  func.return
+}
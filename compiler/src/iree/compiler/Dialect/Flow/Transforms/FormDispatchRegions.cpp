@@ -634,6 +634,15 @@ isFusableWithProducer(OpOperand &operand,
     return true;
   }
 
+  // Keeping the LHS set_encoding in the matmul dispatch lets backends pack the
+  // LHS on the fly instead of writing the packed LHS out and reading it back
+  // (e.g. the pack_mmt4d microkernel on LLVMCPU).
+  if (options.fuseLhsEncodingWithMatmul &&
+      isa<IREE::LinalgExt::SetEncodingOp>(producer) &&
+      isa<linalg::MatmulOp>(consumer)) {
+    return operand.getOperandNumber() == 0;
+  }
+
   if (isPackLikeOp(consumer)) {
     if (auto linalgProducerOp = dyn_cast<linalg::LinalgOp>(producer)) {
       if (auto packOp = dyn_cast<tensor::PackOp>(consumer)) {
@@ -884,11 +893,13 @@ struct FormDispatchRegionsPass
     generateWorkloadRegion = options.generateWorkloadRegion;
     fusePadWithConsumers = options.fusePadWithConsumers;
     fusePadWithProducers = options.fusePadWithProducers;
+    fuseLhsEncodingWithMatmul = options.fuseLhsEncodingWithMatmul;
   }
   FormDispatchRegionsPass(const FormDispatchRegionsPass &other)
       : FormDispatchRegionsPass(FormDispatchRegionsOptions{
             other.fuseMultiUse, other.generateWorkloadRegion,
-            other.fusePadWithConsumers, other.fusePadWithProducers}) {}
+            other.fusePadWithConsumers, other.fusePadWithProducers,
+            other.fuseLhsEncodingWithMatmul}) {}
 
   void runOnOperation() override;
 };
@@ -899,9 +910,9 @@ void FormDispatchRegionsPass::runOnOperation() {
   mlir::FunctionOpInterface funcOp = getOperation();
   DominanceInfo const &dominanceInfo = getAnalysis<DominanceInfo>();
   TensorDimTrackingRewriter rewriter(funcOp);
-  FormDispatchRegionsOptions options{fuseMultiUse, generateWorkloadRegion,
-                                     fusePadWithConsumers,
-                                     fusePadWithProducers};
+  FormDispatchRegionsOptions options{
+      fuseMultiUse, generateWorkloadRegion, fusePadWithConsumers,
+      fusePadWithProducers, fuseLhsEncodingWithMatmul};
   if (failed(createFusionGroups(rewriter, funcOp, dominanceInfo, options))) {
     funcOp->emitOpError("failed to create fusion groups");
     return signalPassFailure();
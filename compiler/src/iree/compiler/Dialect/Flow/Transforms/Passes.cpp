@@ -70,6 +70,14 @@ static llvm::cl::opt<bool> clEnableFusePaddingIntoLinalgProducerOps(
     llvm::cl::desc("Enable fusing tensor.pad ops into Linalg consumer ops."),
     llvm::cl::init(false));
 
+static llvm::cl::opt<bool> clEnableFuseLhsEncodingIntoMatmul(
+    "iree-flow-enable-fuse-lhs-encoding-into-matmul",
+    llvm::cl::desc(
+        "Enable fusing the set_encoding of a matmul LHS into the matmul "
+        "dispatch so that backends can pack it on the fly (e.g. with the "
+        "pack_mmt4d microkernel on LLVMCPU)."),
+    llvm::cl::init(false));
+
 static llvm::cl::opt<bool>
     clEnableFuseMultiUse("iree-flow-fuse-multi-use",
                          llvm::cl::desc("Fuse multi-use ops."),
@@ -168,7 +176,8 @@ void buildFlowTransformPassPipeline(OpPassManager &passManager,
         return createFormDispatchRegionsPass(FormDispatchRegionsOptions{
             clEnableFuseMultiUse, clDispatchGenerateWorkloadRegion,
             clEnableFusePaddingIntoLinalgConsumerOps,
-            clEnableFusePaddingIntoLinalgProducerOps});
+            clEnableFusePaddingIntoLinalgProducerOps,
+            clEnableFuseLhsEncodingIntoMatmul});
       })
       // Collapse dimensions of linalg Ops.
       .addPass(createCollapseDimensionsPass)
@@ -156,6 +156,7 @@ struct FormDispatchRegionsOptions {
   bool generateWorkloadRegion = true;
   bool fusePadWithConsumers = false;
   bool fusePadWithProducers = false;
+  bool fuseLhsEncodingWithMatmul = false;
 };
 std::unique_ptr<InterfacePass<mlir::FunctionOpInterface>>
 createFormDispatchRegionsPass(FormDispatchRegionsOptions options = {});
@@ -0,0 +1,55 @@
+// RUN: iree-opt --pass-pipeline="builtin.module(func.func(iree-flow-form-dispatch-regions{fuse-lhs-encoding-with-matmul}))" --split-input-file %s | FileCheck %s
+
+func.func @fuse_lhs_encoding_with_matmul(%arg0 : tensor<?x?xf32>,
+    %arg1 : tensor<?x?xf32, #iree_linalg_ext.encoding<user = MATMUL_F32F32F32, role = RHS>>,
+    %arg2 : tensor<?x?xf32, #iree_linalg_ext.encoding<user = MATMUL_F32F32F32, role = RESULT>>,
+    %arg3 : index, %arg4 : index)
+    -> tensor<?x?xf32, #iree_linalg_ext.encoding<user = MATMUL_F32F32F32, role = RESULT>> {
+  %cst = arith.constant 0.0 : f32
+  %0 = tensor.pad %arg0 low[0, 0] high[%arg3, %arg4] {
+    ^bb0(%b0: index, %b1 : index):
+      tensor.yield %cst : f32
+  } : tensor<?x?xf32> to tensor<?x?xf32>
+  %1 = iree_linalg_ext.set_encoding %0
+      : tensor<?x?xf32> -> tensor<?x?xf32, #iree_linalg_ext.encoding<user = MATMUL_F32F32F32, role = LHS>>
+  %2 = linalg.matmul
+      ins(%1, %arg1 : tensor<?x?xf32, #iree_linalg_ext.encoding<user = MATMUL_F32F32F32, role = LHS>>,
+                      tensor<?x?xf32, #iree_linalg_ext.encoding<user = MATMUL_F32F32F32, role = RHS>>)
+      outs(%arg2 : tensor<?x?xf32, #iree_linalg_ext.encoding<user = MATMUL_F32F32F32, role = RESULT>>)
+      -> tensor<?x?xf32, #iree_linalg_ext.encoding<user = MATMUL_F32F32F32, role = RESULT>>
+  return %2 : tensor<?x?xf32, #iree_linalg_ext.encoding<user = MATMUL_F32F32F32, role = RESULT>>
+}
+// CHECK-LABEL: func @fuse_lhs_encoding_with_matmul(
+//  CHECK-SAME:     %[[ARG0:[a-zA-Z0-9]+]]: tensor<?x?xf32>
+//  CHECK-SAME:     %[[ARG1:[a-zA-Z0-9]+]]: tensor<?x?xf32, #iree_linalg_ext.encoding<user = MATMUL_F32F32F32, role = RHS>>
+//       CHECK:   %[[RETURN:.+]] = flow.dispatch.region
+//       CHECK:     %[[PAD:.+]] = tensor.pad %[[ARG0]]
+//       CHECK:     %[[LHS:.+]] = iree_linalg_ext.set_encoding %[[PAD]]
+//       CHECK:     %[[MATMUL:.+]] = linalg.matmul
+//  CHECK-SAME:         ins(%[[LHS]], %[[ARG1]] :
+//       CHECK:     flow.return %[[MATMUL]]
+//       CHECK:   return %[[RETURN]]
+
+// -----
+
+func.func @no_fuse_rhs_encoding_with_matmul(
+    %arg0 : tensor<?x?xf32, #iree_linalg_ext.encoding<user = MATMUL_F32F32F32, role = LHS>>,
+    %arg1 : tensor<?x?xf32>,
+    %arg2 : tensor<?x?xf32, #iree_linalg_ext.encoding<user = MATMUL_F32F32F32, role = RESULT>>)
+    -> tensor<?x?xf32, #iree_linalg_ext.encoding<user = MATMUL_F32F32F32, role = RESULT>> {
+  %0 = iree_linalg_ext.set_encoding %arg1
+      : tensor<?x?xf32> -> tensor<?x?xf32, #iree_linalg_ext.encoding<user = MATMUL_F32F32F32, role = RHS>>
+  %1 = linalg.matmul
+      ins(%arg0, %0 : tensor<?x?xf32, #iree_linalg_ext.encoding<user = MATMUL_F32F32F32, role = LHS>>,
+                      tensor<?x?xf32, #iree_linalg_ext.encoding<user = MATMUL_F32F32F32, role = RHS>>)
+      outs(%arg2 : tensor<?x?xf32, #iree_linalg_ext.encoding<user = MATMUL_F32F32F32, role = RESULT>>)
+      -> tensor<?x?xf32, #iree_linalg_ext.encoding<user = MATMUL_F32F32F32, role = RESULT>>
+  return %1 : tensor<?x?xf32, #iree_linalg_ext.encoding<user = MATMUL_F32F32F32, role = RESULT>>
+}
+// CHECK-LABEL: func @no_fuse_rhs_encoding_with_matmul(
+//  CHECK-SAME:     %[[ARG1:[a-zA-Z0-9]+]]: tensor<?x?xf32>
+//       CHECK:   %[[RHS:.+]] = flow.dispatch.region
+//       CHECK:     iree_linalg_ext.set_encoding %[[ARG1]]
+//       CHECK:   flow.dispatch.region
+//       CHECK:     linalg.matmul
+//  CHECK-SAME:         %[[RHS]] :
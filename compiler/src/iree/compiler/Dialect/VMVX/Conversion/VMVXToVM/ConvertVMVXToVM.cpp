@@ -98,7 +98,9 @@ protected:
     }
 
     std::string typePrefix = "x";
-    if (llvm::isa<FloatType>(elementType)) {
+    if (elementType.isBF16()) {
+      typePrefix = "bf";
+    } else if (llvm::isa<FloatType>(elementType)) {
       typePrefix = "f";
     } else if (elementType.isSignlessInteger()) {
       typePrefix = forceUnsigned ? "u" : "i";
@@ -21,3 +21,49 @@ func.func @abs_2d_f32(
            sizes(%arg8, %arg9)
   func.return
 }
+
+// -----
+
+// CHECK-LABEL: @exp_2d_bf16
+func.func @exp_2d_bf16(
+    // IN
+    %arg0 : !util.buffer, %arg1 : index, %arg2 : index, %arg3 : index,
+    // OUT
+    %arg4 : !util.buffer, %arg5 : index, %arg6 : index, %arg7 : index,
+    // SIZE
+    %arg8 : index, %arg9 : index) {
+
+  //      CHECK: vm.call @vmvx.exp.2d.bf16(
+  // CHECK-SAME:   %arg0, %arg1, %arg2, %arg3,
+  // CHECK-SAME:   %arg4, %arg5, %arg6, %arg7,
+  // CHECK-SAME:   %arg8, %arg9)
+  // CHECK-SAME: : (!vm.buffer, i64, i64, i64, !vm.buffer, i64, i64, i64, i64, i64) -> ()
+  vmvx.unary op("exp" : bf16)
+           in(%arg0 offset %arg1 strides[%arg2, %arg3] : !util.buffer)
+           out(%arg4 offset %arg5 strides[%arg6, %arg7] : !util.buffer)
+           sizes(%arg8, %arg9)
+  func.return
+}
+
+// -----
+
+// CHECK-LABEL: @truncf_2d_f16
+func.func @truncf_2d_f16(
+    // IN
+    %arg0 : !util.buffer, %arg1 : index, %arg2 : index, %arg3 : index,
+    // OUT
+    %arg4 : !util.buffer, %arg5 : index, %arg6 : index, %arg7 : index,
+    // SIZE
+    %arg8 : index, %arg9 : index) {
+
+  //      CHECK: vm.call @vmvx.truncf.2d.f16(
+  // CHECK-SAME:   %arg0, %arg1, %arg2, %arg3,
+  // CHECK-SAME:   %arg4, %arg5, %arg6, %arg7,
+  // CHECK-SAME:   %arg8, %arg9)
+  // CHECK-SAME: : (!vm.buffer, i64, i64, i64, !vm.buffer, i64, i64, i64, i64, i64) -> ()
+  vmvx.unary op("truncf" : f16)
+           in(%arg0 offset %arg1 strides[%arg2, %arg3] : !util.buffer)
+           out(%arg4 offset %arg5 strides[%arg6, %arg7] : !util.buffer)
+           sizes(%arg8, %arg9)
+  func.return
+}
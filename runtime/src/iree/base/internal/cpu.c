@@ -24,9 +24,9 @@
 
 #if defined(IREE_PLATFORM_ANDROID) || defined(IREE_PLATFORM_LINUX)
 
-// For now as we only need ISA feature bits and no CPU identification beyond
-// that, and as we are OK with requiring a sufficiently recent linux kernel to
-// expose the features that we need, we can just rely on the basic HWCAP way.
+// As we are OK with requiring a sufficiently recent linux kernel to expose the
+// features that we need, we can just rely on the basic HWCAP way for ISA
+// feature bits. CPU identification is read from sysfs.
 #include <sys/auxv.h>
 
 // NOTE: not all kernel versions have all of the cap bits we need defined so as
@@ -52,6 +52,28 @@
 #define IREE_HWCAP2_SME2P1 (1UL << 38)
 #define IREE_HWCAP2_SME_F16F16 (1UL << 42)
 
+#include <stdio.h>
+#include <stdlib.h>
+
+// Returns the processor data field 6 value identifying the processor model.
+// MIDR_EL1 is trapped when read from EL0 so we use the value the kernel exposes
+// in sysfs for the first processor. On big.LITTLE systems this is the model of
+// whichever cluster cpu0 belongs to.
+static uint64_t iree_cpu_query_model_arm_64(void) {
+  FILE* file =
+      fopen("/sys/devices/system/cpu/cpu0/regs/identification/midr_el1", "r");
+  if (!file) return 0;
+  char line[32] = {0};
+  bool did_read = fgets(line, sizeof(line), file) != NULL;
+  fclose(file);
+  if (!did_read) return 0;
+  uint64_t midr = strtoull(line, NULL, 16);
+  uint64_t implementer = (midr >> 24) & 0xFF;
+  uint64_t part_num = (midr >> 4) & 0xFFF;
+  if (!implementer) return 0;
+  return IREE_CPU_DATA6_MAKE_MODEL(implementer, 0, part_num);
+}
+
 static void iree_cpu_initialize_from_platform_arm_64(uint64_t* out_fields) {
   unsigned long hwcap = getauxval(AT_HWCAP);
   unsigned long hwcap2 = getauxval(AT_HWCAP2);
@@ -96,6 +118,8 @@ static void iree_cpu_initialize_from_platform_arm_64(uint64_t* out_fields) {
                  IREE_HWCAP2_SME_F64F64);
   IREE_COPY_BITS(out_fields[0], IREE_CPU_DATA0_ARM_64_SME_I16I64, hwcap2,
                  IREE_HWCAP2_SME_I16I64);
+
+  out_fields[IREE_CPU_DATA_MODEL_FIELD_INDEX] = iree_cpu_query_model_arm_64();
 }
 
 #elif defined(IREE_PLATFORM_MACOS) || defined(IREE_PLATFORM_IOS)
@@ -239,6 +263,30 @@ static inline iree_cpuid_regs_t iree_cpuid_or_zero(uint32_t eax, uint32_t ecx,
   return iree_cpuid_raw(eax, ecx);
 }
 
+// Returns the processor data field 6 value identifying the processor model.
+// See the Intel Architectures Software Developer's Manual, Figure 3-6,
+// "Version Information Returned by CPUID in EAX" for the derivation of the
+// display family and model.
+static uint64_t iree_cpu_query_model_x86_64(iree_cpuid_bounds_t bounds,
+                                            iree_cpuid_regs_t leaf1) {
+  iree_cpuid_regs_t leaf0 = iree_cpuid_raw(0, 0);
+  uint64_t vendor = 0;
+  // The vendor string is stored in EBX, EDX, ECX order.
+  if (leaf0.ebx == 0x756E6547u && leaf0.edx == 0x49656E69u &&
+      leaf0.ecx == 0x6C65746Eu) {
+    vendor = IREE_CPU_DATA6_X86_64_VENDOR_INTEL;  // "GenuineIntel"
+  } else if (leaf0.ebx == 0x68747541u && leaf0.edx == 0x69746E65u &&
+             leaf0.ecx == 0x444D4163u) {
+    vendor = IREE_CPU_DATA6_X86_64_VENDOR_AMD;  // "AuthenticAMD"
+  }
+  if (!vendor || bounds.max_base_eax < 1) return 0;
+  uint32_t family = (leaf1.eax >> 8) & 0xF;
+  uint32_t model = (leaf1.eax >> 4) & 0xF;
+  if (family == 0xF) family += (leaf1.eax >> 20) & 0xFF;
+  if (family == 0x6 || family >= 0xF) model |= ((leaf1.eax >> 16) & 0xF) << 4;
+  return IREE_CPU_DATA6_MAKE_MODEL(vendor, family, model);
+}
+
 static void iree_cpu_initialize_from_platform_x86_64(uint64_t* out_fields) {
   iree_cpuid_bounds_t bounds = iree_cpuid_query_bounds();
   iree_cpuid_regs_t leaf1 = iree_cpuid_or_zero(1, 0, bounds);
@@ -299,10 +347,146 @@ static void iree_cpu_initialize_from_platform_x86_64(uint64_t* out_fields) {
   }
 
   out_fields[0] = out0;
+  out_fields[IREE_CPU_DATA_MODEL_FIELD_INDEX] =
+      iree_cpu_query_model_x86_64(bounds, leaf1);
 }
 
 #endif  // defined(IREE_ARCH_ARM_64)
 
+//===----------------------------------------------------------------------===//
+// Platform-specific cache hierarchy queries
+//===----------------------------------------------------------------------===//
+
+// Stores |size_bytes| as the KiB size at |shift| in the cache data field.
+static void iree_cpu_store_cache_size(uint64_t* out_fields, int shift,
+                                      uint64_t size_bytes) {
+  uint64_t size_kb = iree_min(size_bytes / 1024,
+                              (uint64_t)IREE_CPU_DATA_CACHE_SIZE_KB_MASK);
+  uint64_t* field = &out_fields[IREE_CPU_DATA_CACHE_FIELD_INDEX];
+  *field &= ~(IREE_CPU_DATA_CACHE_SIZE_KB_MASK << shift);
+  *field |= size_kb << shift;
+}
+
+#if defined(IREE_PLATFORM_ANDROID) || defined(IREE_PLATFORM_LINUX)
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+// Reads the first line of the |attribute| sysfs file of cache |index| of the
+// first processor into |buffer|.
+static bool iree_cpu_read_cache_attribute(int index, const char* attribute,
+                                          char* buffer, int buffer_capacity) {
+  char path[128];
+  snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu0/cache/index%d/%s",
+           index, attribute);
+  FILE* file = fopen(path, "r");
+  if (!file) return false;
+  bool did_read = fgets(buffer, buffer_capacity, file) != NULL;
+  fclose(file);
+  return did_read;
+}
+
+// Queries the caches of the first processor as exposed by the kernel in
+// /sys/devices/system/cpu/cpu0/cache/index*/. This works across architectures
+// (unlike CPUID) but may be unavailable in some sandboxes.
+static bool iree_cpu_initialize_cache_sizes_from_sysfs(uint64_t* out_fields) {
+  bool found_any = false;
+  for (int index = 0; index < 16; ++index) {
+    char line[64];
+    if (!iree_cpu_read_cache_attribute(index, "level", line, sizeof(line))) {
+      break;
+    }
+    int level = atoi(line);
+    if (!iree_cpu_read_cache_attribute(index, "type", line, sizeof(line))) {
+      continue;
+    }
+    // Instruction caches are of no interest to the consumers of this data.
+    if (strncmp(line, "Instruction", strlen("Instruction")) == 0) continue;
+    if (!iree_cpu_read_cache_attribute(index, "size", line, sizeof(line))) {
+      continue;
+    }
+    char* suffix = NULL;
+    uint64_t size_bytes = strtoull(line, &suffix, 10);
+    if (suffix && *suffix == 'K') size_bytes *= 1024;
+    if (suffix && *suffix == 'M') size_bytes *= 1024 * 1024;
+    switch (level) {
+      case 1:
+        iree_cpu_store_cache_size(out_fields, IREE_CPU_DATA7_L1D_SIZE_KB_SHIFT,
+                                  size_bytes);
+        break;
+      case 2:
+        iree_cpu_store_cache_size(out_fields, IREE_CPU_DATA7_L2_SIZE_KB_SHIFT,
+                                  size_bytes);
+        break;
+      case 3:
+        iree_cpu_store_cache_size(out_fields, IREE_CPU_DATA7_L3_SIZE_KB_SHIFT,
+                                  size_bytes);
+        break;
+      default:
+        continue;
+    }
+    found_any = true;
+  }
+  return found_any;
+}
+
+static void iree_cpu_initialize_cache_sizes(uint64_t* out_fields) {
+  if (iree_cpu_initialize_cache_sizes_from_sysfs(out_fields)) return;
+#if defined(_SC_LEVEL1_DCACHE_SIZE)
+  // glibc derives these from CPUID on x86 and returns 0 when unknown.
+  long l1d_size = sysconf(_SC_LEVEL1_DCACHE_SIZE);
+  long l2_size = sysconf(_SC_LEVEL2_CACHE_SIZE);
+  long l3_size = sysconf(_SC_LEVEL3_CACHE_SIZE);
+  if (l1d_size > 0) {
+    iree_cpu_store_cache_size(out_fields, IREE_CPU_DATA7_L1D_SIZE_KB_SHIFT,
+                              (uint64_t)l1d_size);
+  }
+  if (l2_size > 0) {
+    iree_cpu_store_cache_size(out_fields, IREE_CPU_DATA7_L2_SIZE_KB_SHIFT,
+                              (uint64_t)l2_size);
+  }
+  if (l3_size > 0) {
+    iree_cpu_store_cache_size(out_fields, IREE_CPU_DATA7_L3_SIZE_KB_SHIFT,
+                              (uint64_t)l3_size);
+  }
+#endif  // _SC_LEVEL1_DCACHE_SIZE
+}
+
+#elif defined(IREE_PLATFORM_MACOS) || defined(IREE_PLATFORM_IOS)
+
+#include <sys/sysctl.h>
+#include <sys/types.h>
+
+static void iree_cpu_initialize_cache_sizes(uint64_t* out_fields) {
+  typedef struct {
+    const char* sysctl_key;
+    int shift;
+  } cache_t;
+  const cache_t caches[] = {
+      {"hw.l1dcachesize", IREE_CPU_DATA7_L1D_SIZE_KB_SHIFT},
+      {"hw.l2cachesize", IREE_CPU_DATA7_L2_SIZE_KB_SHIFT},
+      {"hw.l3cachesize", IREE_CPU_DATA7_L3_SIZE_KB_SHIFT},
+  };
+  for (int i = 0; i < IREE_ARRAYSIZE(caches); ++i) {
+    int64_t result = 0;
+    size_t result_size = sizeof result;
+    if (0 == sysctlbyname(caches[i].sysctl_key, &result, &result_size, NULL,
+                          0) &&
+        result > 0) {
+      iree_cpu_store_cache_size(out_fields, caches[i].shift, (uint64_t)result);
+    }
+  }
+}
+
+#else
+
+static void iree_cpu_initialize_cache_sizes(uint64_t* out_fields) {
+  // No implementation available. Cache sizes will be reported as unknown.
+}
+
+#endif  // IREE_PLATFORM_*
+
 static void iree_cpu_initialize_from_platform(iree_allocator_t temp_allocator,
                                               uint64_t* out_fields) {
 #if defined(IREE_ARCH_ARM_64)
@@ -312,6 +496,7 @@ static void iree_cpu_initialize_from_platform(iree_allocator_t temp_allocator,
 #else
   // No implementation available. CPU data will be all zeros.
 #endif  // defined(IREE_ARCH_ARM_64)
+  iree_cpu_initialize_cache_sizes(out_fields);
 }
 
 //===----------------------------------------------------------------------===//
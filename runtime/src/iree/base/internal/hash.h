@@ -0,0 +1,110 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+//==============================================================================
+//
+// Non-cryptographic hash functions: **NOT CRYPTOGRAPHICALLY SECURE**
+//
+// Only use these for content addressing of trusted data (cache keys, etc).
+//
+//==============================================================================
+
+#ifndef IREE_BASE_INTERNAL_HASH_H_
+#define IREE_BASE_INTERNAL_HASH_H_
+
+#include <stdint.h>
+#include <string.h>
+
+#include "iree/base/api.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+//==============================================================================
+// FNV-1a (64-bit)
+//==============================================================================
+// http://www.isthe.com/chongo/tech/comp/fnv/index.html
+//
+// Simple and reasonably well distributed but processes one byte at a time.
+// Hashes can be built incrementally by passing the result of one call as the
+// |hash| of the next.
+
+#define IREE_HASH_FNV1A_64_SEED 0xCBF29CE484222325ull
+#define IREE_HASH_FNV1A_64_PRIME 0x00000100000001B3ull
+
+// Mixes |data_length| bytes of |data| into |hash|.
+// Use IREE_HASH_FNV1A_64_SEED as the initial |hash| value.
+static inline uint64_t iree_hash_fnv1a_64(uint64_t hash, const void* data,
+                                          iree_host_size_t data_length) {
+  const uint8_t* bytes = (const uint8_t*)data;
+  for (iree_host_size_t i = 0; i < data_length; ++i) {
+    hash ^= bytes[i];
+    hash *= IREE_HASH_FNV1A_64_PRIME;
+  }
+  return hash;
+}
+
+// Mixes the bytes of |value| into |hash|.
+static inline uint64_t iree_hash_fnv1a_64_u64(uint64_t hash, uint64_t value) {
+  return iree_hash_fnv1a_64(hash, &value, sizeof(value));
+}
+
+//==============================================================================
+// Word-wise 64-bit hash
+//==============================================================================
+// Processes 32 bytes per step in four independent multiply lanes so that large
+// inputs (such as multi-megabyte executables) hash at memory bandwidth instead
+// of being bound by the multiply latency of one step per byte as with FNV-1a.
+// Words are read in host byte order and the result is only stable on hosts of
+// the same endianness; use it for keys that never leave the machine.
+
+#define IREE_HASH_WORDS_64_SEED 0x243F6A8885A308D3ull
+#define IREE_HASH_WORDS_64_PRIME 0x9E3779B97F4A7C15ull
+
+// Finalizes |value| such that every input bit affects every output bit.
+static inline uint64_t iree_hash_mix_64(uint64_t value) {
+  value ^= value >> 33;
+  value *= 0xFF51AFD7ED558CCDull;
+  value ^= value >> 33;
+  value *= 0xC4CEB9FE1A85EC53ull;
+  value ^= value >> 33;
+  return value;
+}
+
+// Hashes |data_length| bytes of |data| starting from |seed|.
+// Use IREE_HASH_WORDS_64_SEED as the |seed| if no other is required.
+static inline uint64_t iree_hash_words_64(uint64_t seed, const void* data,
+                                          iree_host_size_t data_length) {
+  const uint8_t* bytes = (const uint8_t*)data;
+  uint64_t lanes[4] = {
+      seed,
+      seed ^ IREE_HASH_WORDS_64_PRIME,
+      seed + IREE_HASH_WORDS_64_PRIME,
+      ~seed,
+  };
+  iree_host_size_t i = 0;
+  for (; i + sizeof(lanes) <= data_length; i += sizeof(lanes)) {
+    for (int j = 0; j < 4; ++j) {
+      uint64_t word;
+      memcpy(&word, bytes + i + j * sizeof(word), sizeof(word));
+      lanes[j] = (lanes[j] ^ word) * IREE_HASH_WORDS_64_PRIME;
+      lanes[j] ^= lanes[j] >> 32;
+    }
+  }
+  uint64_t hash = seed ^ (uint64_t)data_length;
+  for (int j = 0; j < 4; ++j) {
+    hash = iree_hash_mix_64(hash ^ lanes[j]);
+  }
+  hash = iree_hash_fnv1a_64(hash, bytes + i, data_length - i);
+  return iree_hash_mix_64(hash);
+}
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif  // IREE_BASE_INTERNAL_HASH_H_
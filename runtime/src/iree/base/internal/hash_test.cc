@@ -0,0 +1,72 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/base/internal/hash.h"
+
+#include <cstring>
+
+#include "iree/testing/gtest.h"
+
+namespace {
+
+TEST(FNV1a64Test, Empty) {
+  EXPECT_EQ(IREE_HASH_FNV1A_64_SEED,
+            iree_hash_fnv1a_64(IREE_HASH_FNV1A_64_SEED, NULL, 0));
+}
+
+// Reference values from the FNV test suite.
+TEST(FNV1a64Test, KnownValues) {
+  EXPECT_EQ(0xAF63DC4C8601EC8Cull,
+            iree_hash_fnv1a_64(IREE_HASH_FNV1A_64_SEED, "a", 1));
+  EXPECT_EQ(0x85944171F73967E8ull,
+            iree_hash_fnv1a_64(IREE_HASH_FNV1A_64_SEED, "foobar", 6));
+}
+
+TEST(FNV1a64Test, Incremental) {
+  uint64_t hash = iree_hash_fnv1a_64(IREE_HASH_FNV1A_64_SEED, "foo", 3);
+  hash = iree_hash_fnv1a_64(hash, "bar", 3);
+  EXPECT_EQ(iree_hash_fnv1a_64(IREE_HASH_FNV1A_64_SEED, "foobar", 6), hash);
+}
+
+TEST(FNV1a64Test, U64) {
+  uint64_t value = 0x0123456789ABCDEFull;
+  EXPECT_EQ(iree_hash_fnv1a_64(IREE_HASH_FNV1A_64_SEED, &value, sizeof(value)),
+            iree_hash_fnv1a_64_u64(IREE_HASH_FNV1A_64_SEED, value));
+}
+
+// Tests that every byte of inputs spanning the word loop and the tail affects
+// the hash, as does the length of the input.
+TEST(Words64Test, AllBytesContribute) {
+  uint8_t data[77];
+  for (size_t i = 0; i < sizeof(data); ++i) data[i] = (uint8_t)i;
+  const uint64_t hash =
+      iree_hash_words_64(IREE_HASH_WORDS_64_SEED, data, sizeof(data));
+  EXPECT_EQ(hash,
+            iree_hash_words_64(IREE_HASH_WORDS_64_SEED, data, sizeof(data)));
+  for (size_t i = 0; i < sizeof(data); ++i) {
+    data[i] ^= 0x01;
+    EXPECT_NE(hash,
+              iree_hash_words_64(IREE_HASH_WORDS_64_SEED, data, sizeof(data)))
+        << "byte " << i;
+    data[i] ^= 0x01;
+  }
+  EXPECT_NE(hash, iree_hash_words_64(IREE_HASH_WORDS_64_SEED, data,
+                                     sizeof(data) - 1));
+  EXPECT_NE(hash, iree_hash_words_64(IREE_HASH_WORDS_64_SEED + 1, data,
+                                     sizeof(data)));
+}
+
+// Tests that inputs of all zeros with different lengths hash differently.
+TEST(Words64Test, ZeroLengths) {
+  uint8_t zeros[128] = {0};
+  uint64_t hashes[sizeof(zeros) + 1];
+  for (size_t i = 0; i <= sizeof(zeros); ++i) {
+    hashes[i] = iree_hash_words_64(IREE_HASH_WORDS_64_SEED, zeros, i);
+    for (size_t j = 0; j < i; ++j) EXPECT_NE(hashes[i], hashes[j]);
+  }
+}
+
+}  // namespace
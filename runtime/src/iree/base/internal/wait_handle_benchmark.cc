@@ -0,0 +1,146 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+// Benchmarks the wait set of the active wait API (IREE_WAIT_API).
+// Build with -DIREE_WAIT_API=3 (POLL), 4 (PPOLL) or 5 (EPOLL) to compare
+// implementations; BM_RawPoll measures the poll syscall alone as a baseline.
+
+#include "iree/base/internal/wait_handle.h"
+
+#if !defined(IREE_WAIT_HANDLE_DISABLED)
+
+#include <vector>
+
+#include "benchmark/benchmark.h"
+
+#if defined(IREE_PLATFORM_LINUX) || defined(IREE_PLATFORM_APPLE)
+#include <poll.h>
+#define IREE_HAVE_POLL 1
+#endif  // IREE_PLATFORM_LINUX || IREE_PLATFORM_APPLE
+
+namespace {
+
+//==============================================================================
+// Test fixture utilities
+//==============================================================================
+
+// A set of |count| events where only the last inserted one is signaled. This
+// is the worst case for scanning implementations and mirrors a task poller
+// with many outstanding waits of which one resolves.
+class EventList {
+ public:
+  explicit EventList(int count) : events_(count) {
+    for (int i = 0; i < count; ++i) {
+      IREE_CHECK_OK(iree_event_initialize(/*initial_state=*/i == count - 1,
+                                          &events_[i]));
+    }
+  }
+  ~EventList() {
+    for (auto& event : events_) iree_event_deinitialize(&event);
+  }
+
+  std::vector<iree_event_t>& events() { return events_; }
+  iree_event_t& signaled() { return events_.back(); }
+
+ private:
+  std::vector<iree_event_t> events_;
+};
+
+iree_wait_set_t* AllocateWaitSet(EventList& list) {
+  iree_wait_set_t* wait_set = NULL;
+  IREE_CHECK_OK(iree_wait_set_allocate(list.events().size(),
+                                       iree_allocator_system(), &wait_set));
+  for (auto& event : list.events()) {
+    IREE_CHECK_OK(iree_wait_set_insert(wait_set, event));
+  }
+  return wait_set;
+}
+
+//==============================================================================
+// iree_wait_set_t
+//==============================================================================
+
+// Wait-any on a set that is already signaled.
+void BM_WaitAny(benchmark::State& state) {
+  EventList list(state.range(0));
+  iree_wait_set_t* wait_set = AllocateWaitSet(list);
+  for (auto _ : state) {
+    iree_wait_handle_t wake_handle;
+    IREE_CHECK_OK(
+        iree_wait_any(wait_set, IREE_TIME_INFINITE_PAST, &wake_handle));
+    benchmark::DoNotOptimize(wake_handle);
+  }
+  iree_wait_set_free(wait_set);
+}
+BENCHMARK(BM_WaitAny)->RangeMultiplier(4)->Range(1, 256);
+
+// The wait-wake-erase-insert loop of a poller: after each wake the resolved
+// handle is erased and a new wait is inserted in its place.
+void BM_WaitAnyEraseInsert(benchmark::State& state) {
+  EventList list(state.range(0));
+  iree_wait_set_t* wait_set = AllocateWaitSet(list);
+  for (auto _ : state) {
+    iree_wait_handle_t wake_handle;
+    IREE_CHECK_OK(
+        iree_wait_any(wait_set, IREE_TIME_INFINITE_PAST, &wake_handle));
+    iree_wait_set_erase(wait_set, wake_handle);
+    IREE_CHECK_OK(iree_wait_set_insert(wait_set, list.signaled()));
+  }
+  iree_wait_set_free(wait_set);
+}
+BENCHMARK(BM_WaitAnyEraseInsert)->RangeMultiplier(4)->Range(1, 256);
+
+// The full lifetime of a transient wait set as used by multi-waits: the set is
+// allocated, filled, waited on once, and freed. Any per-set or per-handle setup
+// cost of the wait API shows up here and not in BM_WaitAny.
+void BM_AllocateInsertWaitAnyFree(benchmark::State& state) {
+  EventList list(state.range(0));
+  for (auto _ : state) {
+    iree_wait_set_t* wait_set = AllocateWaitSet(list);
+    iree_wait_handle_t wake_handle;
+    IREE_CHECK_OK(
+        iree_wait_any(wait_set, IREE_TIME_INFINITE_PAST, &wake_handle));
+    benchmark::DoNotOptimize(wake_handle);
+    iree_wait_set_free(wait_set);
+  }
+}
+BENCHMARK(BM_AllocateInsertWaitAnyFree)->RangeMultiplier(4)->Range(1, 256);
+
+// Wait-all on a set where every handle is signaled.
+void BM_WaitAll(benchmark::State& state) {
+  EventList list(state.range(0));
+  for (auto& event : list.events()) iree_event_set(&event);
+  iree_wait_set_t* wait_set = AllocateWaitSet(list);
+  for (auto _ : state) {
+    IREE_CHECK_OK(iree_wait_all(wait_set, IREE_TIME_INFINITE_PAST));
+  }
+  iree_wait_set_free(wait_set);
+}
+BENCHMARK(BM_WaitAll)->RangeMultiplier(4)->Range(1, 256);
+
+#if defined(IREE_HAVE_POLL) && defined(IREE_HAVE_WAIT_TYPE_EVENTFD)
+
+// Baseline: a poll syscall over the same fds without any wait set overhead.
+void BM_RawPoll(benchmark::State& state) {
+  EventList list(state.range(0));
+  std::vector<struct pollfd> poll_fds(list.events().size());
+  for (size_t i = 0; i < poll_fds.size(); ++i) {
+    poll_fds[i].fd = list.events()[i].value.event.fd;
+    poll_fds[i].events = POLLIN;
+    poll_fds[i].revents = 0;
+  }
+  for (auto _ : state) {
+    int rv = poll(poll_fds.data(), poll_fds.size(), 0);
+    benchmark::DoNotOptimize(rv);
+  }
+}
+BENCHMARK(BM_RawPoll)->RangeMultiplier(4)->Range(1, 256);
+
+#endif  // IREE_HAVE_POLL && IREE_HAVE_WAIT_TYPE_EVENTFD
+
+}  // namespace
+
+#endif  // !IREE_WAIT_HANDLE_DISABLED
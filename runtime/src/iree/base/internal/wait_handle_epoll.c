@@ -9,57 +9,553 @@
 
 #if IREE_WAIT_API == IREE_WAIT_API_EPOLL
 
+#include <errno.h>
+#include <poll.h>
+#include <sys/epoll.h>
+#include <time.h>
+#include <unistd.h>
+
 #include "iree/base/internal/wait_handle_posix.h"
 
+//===----------------------------------------------------------------------===//
+// Platform utilities
+//===----------------------------------------------------------------------===//
+
+// epoll_wait only takes a millisecond timeout. We round up so that we never
+// wake before the deadline but may overshoot it by up to 1ms. Wait-any on sets
+// that have not been promoted to epoll, wait-all, and single-handle waits go
+// through ppoll instead which has nanosecond timeouts.
+//
+// Both may spuriously wake with an EINTR. We don't do anything with that
+// opportunity (no fancy signal stuff), but we do need to retry the wait and
+// ensure that we do so with an updated timeout based on the deadline.
+//
+// Documentation: https://man7.org/linux/man-pages/man7/epoll.7.html
+
+static iree_status_t iree_syscall_epoll_wait(int epoll_fd,
+                                             struct epoll_event* events,
+                                             int max_events,
+                                             iree_time_t deadline_ns,
+                                             int* out_signaled_count) {
+  *out_signaled_count = 0;
+  int rv = -1;
+  do {
+    uint32_t timeout_ms = iree_absolute_deadline_to_timeout_ms(deadline_ns);
+    rv = epoll_wait(epoll_fd, events, max_events,
+                    timeout_ms == UINT32_MAX ? -1 : (int)timeout_ms);
+  } while (rv < 0 && errno == EINTR);
+  if (rv > 0) {
+    // One or more events set.
+    *out_signaled_count = rv;
+    return iree_ok_status();
+  } else if (IREE_UNLIKELY(rv < 0)) {
+    return iree_make_status(iree_status_code_from_errno(errno),
+                            "epoll_wait failure %d", errno);
+  }
+  // rv == 0
+  // Timeout; no events set.
+  return iree_status_from_code(IREE_STATUS_DEADLINE_EXCEEDED);
+}
+
+static iree_status_t iree_syscall_ppoll(struct pollfd* fds, nfds_t nfds,
+                                        iree_time_t deadline_ns,
+                                        int* out_signaled_count) {
+  *out_signaled_count = 0;
+  int rv = -1;
+  do {
+    // Convert the deadline into a tmo_p struct for ppoll. Note that we must do
+    // this every iteration of the loop as a previous ppoll may have taken some
+    // of the time.
+    struct timespec timeout_ts;
+    struct timespec* tmo_p = &timeout_ts;
+    if (deadline_ns == IREE_TIME_INFINITE_PAST) {
+      // Block never.
+      memset(&timeout_ts, 0, sizeof(timeout_ts));
+    } else if (deadline_ns == IREE_TIME_INFINITE_FUTURE) {
+      // Block forever (NULL timeout to ppoll).
+      tmo_p = NULL;
+    } else {
+      iree_duration_t timeout_ns = deadline_ns - iree_time_now();
+      if (timeout_ns < 0) {
+        // Deadline reached; still poll once as the caller expects.
+        memset(&timeout_ts, 0, sizeof(timeout_ts));
+      } else {
+        timeout_ts.tv_sec = (time_t)(timeout_ns / 1000000000ull);
+        timeout_ts.tv_nsec = (long)(timeout_ns % 1000000000ull);
+      }
+    }
+    rv = ppoll(fds, nfds, tmo_p, NULL);
+  } while (rv < 0 && errno == EINTR);
+  if (rv > 0) {
+    // One or more events set.
+    *out_signaled_count = rv;
+    return iree_ok_status();
+  } else if (rv < 0) {
+    return iree_make_status(iree_status_code_from_errno(errno),
+                            "ppoll failure %d", errno);
+  }
+  // rv == 0
+  // Timeout; no events set.
+  return iree_status_from_code(IREE_STATUS_DEADLINE_EXCEEDED);
+}
+
 //===----------------------------------------------------------------------===//
 // iree_wait_set_t
 //===----------------------------------------------------------------------===//
 
-// TODO(benvanik): iree_wait_set_s using an epoll fd.
-// epoll lets us route the wait set operations right to kernel and not need our
-// own duplicate data structure. epoll is great, just not available on mac/ios
-// so we still need poll for that. linux/android/bsd all have epoll, though.
+// Sets with fewer handles than this are always waited on with a single ppoll.
+// Below this size scanning the pollfd list is cheaper than maintaining an
+// epoll instance (see wait_handle_benchmark).
+#define IREE_WAIT_SET_EPOLL_MIN_HANDLE_COUNT 32
+
+// Handles live in fixed slots mirrored by a pollfd list that is handed to
+// ppoll. Many wait sets are transient (allocated, filled, waited on once, and
+// freed as in HAL semaphore multi-waits) and for those a single ppoll is
+// cheaper than creating an epoll instance and registering each handle with it.
+//
+// Once a set holding at least IREE_WAIT_SET_EPOLL_MIN_HANDLE_COUNT handles is
+// waited on a second time it is assumed to be long-lived (such as the task
+// poller) and an epoll instance is created with all handles registered. From
+// then on inserts and erases update the registration and wait-any asks the
+// kernel for a single ready handle instead of scanning the whole list. The
+// kernel stores the slot index of each handle in epoll_event::data so a wake
+// maps back to the user handle in O(1).
+//
+// Handles are registered level-triggered (not EPOLLET): IREE events are
+// manual-reset and a handle that is still signaled must keep satisfying waits
+// until it is reset or erased, just as it would with poll. The kernel rotates
+// ready level-triggered entries to the back of its ready list after reporting
+// them so wait-any across multiple signaled handles remains fair.
 struct iree_wait_set_t {
-  // NOTE: we could in theory use the epoll handle directly (iree_wait_set_s
-  // then is just a pointer). Then allocate/free just go straight to the system.
-  int reserved;
+  iree_allocator_t allocator;
+
+  // epoll instance all unique handles are registered with or -1 if the set is
+  // still waited on with ppoll.
+  int epoll_fd;
+
+  // True once iree_wait_any has been called on the set. A second wait-any is
+  // what promotes a large set to epoll.
+  bool has_waited;
+
+  // Total capacity of the handle slots.
+  iree_host_size_t capacity;
+
+  // Total number of handles in the set (including duplicates).
+  // We use this to ensure that we provide consistent capacity errors.
+  iree_host_size_t total_handle_count;
+
+  // Number of occupied slots. Duplicates are only folded into a single slot
+  // once the set is registered with epoll.
+  iree_host_size_t handle_count;
+
+  // Number of slots that have ever been used since the last clear. Slots at or
+  // above this index are all free and never need to be scanned.
+  iree_host_size_t slot_count;
+
+  // Stack of free slot indices below |slot_count|.
+  iree_host_size_t free_slot_count;
+  uint16_t* free_slots;
+
+  // User-provided handles indexed by slot. Free slots have a type of
+  // IREE_WAIT_PRIMITIVE_TYPE_NONE. While polling with ppoll duplicates occupy
+  // their own slots as in the poll backend. epoll rejects registering an fd
+  // twice so once promoted iree_wait_handle_t::set_internal.dupe_count is used
+  // to indicate how many additional duplicates there are of a handle.
+  iree_wait_handle_t* handles;
+
+  // pollfd list indexed by slot that is passed to ppoll by iree_wait_any.
+  // Free slots have a negative fd which the kernel ignores.
+  struct pollfd* poll_fds;
+
+  // Scratch pollfd list compacted by iree_wait_all as handles are signaled.
+  struct pollfd* wait_all_poll_fds;
 };
 
 iree_status_t iree_wait_set_allocate(iree_host_size_t capacity,
                                      iree_allocator_t allocator,
                                      iree_wait_set_t** out_set) {
-  // TODO(benvanik): epoll_create()
+  IREE_ASSERT_ARGUMENT(out_set);
+  *out_set = NULL;
+
+  // Be reasonable; 64K objects is too high. The slot index must also fit in
+  // iree_wait_handle_t::set_internal.index.
+  if (capacity >= UINT16_MAX) {
+    return iree_make_status(
+        IREE_STATUS_INVALID_ARGUMENT,
+        "wait set capacity of %" PRIhsz " is unreasonably large", capacity);
+  }
+
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, (int64_t)capacity);
+
+  iree_host_size_t handle_list_size =
+      capacity * iree_sizeof_struct(iree_wait_handle_t);
+  iree_host_size_t poll_fd_list_size = capacity * sizeof(struct pollfd);
+  iree_host_size_t free_slot_list_size = capacity * sizeof(uint16_t);
+  iree_host_size_t total_size = iree_sizeof_struct(iree_wait_set_t) +
+                                handle_list_size + 2 * poll_fd_list_size +
+                                free_slot_list_size;
+
+  iree_wait_set_t* set = NULL;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_allocator_malloc(allocator, total_size, (void**)&set));
+  set->allocator = allocator;
+  set->epoll_fd = -1;
+  set->has_waited = false;
+  set->capacity = capacity;
+  set->handles = (iree_wait_handle_t*)((uint8_t*)set +
+                                       iree_sizeof_struct(iree_wait_set_t));
+  set->poll_fds = (struct pollfd*)((uint8_t*)set->handles + handle_list_size);
+  set->wait_all_poll_fds = set->poll_fds + capacity;
+  set->free_slots =
+      (uint16_t*)((uint8_t*)set->wait_all_poll_fds + poll_fd_list_size);
+  iree_wait_set_clear(set);
+
+  *out_set = set;
+  IREE_TRACE_ZONE_END(z0);
+  return iree_ok_status();
 }
 
 void iree_wait_set_free(iree_wait_set_t* set) {
-  // TODO(benvanik): close()
+  if (!set) return;
+  IREE_TRACE_ZONE_BEGIN(z0);
+  if (set->epoll_fd >= 0) close(set->epoll_fd);
+  iree_allocator_free(set->allocator, set);
+  IREE_TRACE_ZONE_END(z0);
+}
+
+bool iree_wait_set_is_empty(const iree_wait_set_t* set) {
+  return set->handle_count != 0;
+}
+
+// Returns the slot index of |handle| in |set| or |set|->slot_count if the
+// handle is not present.
+static iree_host_size_t iree_wait_set_find(const iree_wait_set_t* set,
+                                           const iree_wait_handle_t* handle) {
+  for (iree_host_size_t i = 0; i < set->slot_count; ++i) {
+    const iree_wait_handle_t* existing_handle = &set->handles[i];
+    if (existing_handle->type != IREE_WAIT_PRIMITIVE_TYPE_NONE &&
+        iree_wait_primitive_compare_identical(existing_handle, handle)) {
+      return i;
+    }
+  }
+  return set->slot_count;
+}
+
+// Registers the handle in |slot_index| with the epoll instance of |set|.
+static int iree_wait_set_epoll_add(iree_wait_set_t* set, int fd,
+                                   iree_host_size_t slot_index) {
+  struct epoll_event event;
+  memset(&event, 0, sizeof(event));
+  event.events = EPOLLIN | EPOLLPRI;  // implicit EPOLLERR | EPOLLHUP
+  event.data.u32 = (uint32_t)slot_index;
+  return epoll_ctl(set->epoll_fd, EPOLL_CTL_ADD, fd, &event);
+}
+
+// Creates the epoll instance of |set| and registers all current handles.
+static iree_status_t iree_wait_set_promote_to_epoll(iree_wait_set_t* set) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, (int64_t)set->handle_count);
+
+  set->epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+  if (set->epoll_fd < 0) {
+    IREE_TRACE_ZONE_END(z0);
+    return iree_make_status(iree_status_code_from_errno(errno),
+                            "epoll_create1 failure %d", errno);
+  }
+  iree_status_t status = iree_ok_status();
+  for (iree_host_size_t i = 0; i < set->slot_count; ++i) {
+    if (set->poll_fds[i].fd < 0) continue;
+    if (iree_wait_set_epoll_add(set, set->poll_fds[i].fd, i) == 0) continue;
+    iree_host_size_t existing_index =
+        errno == EEXIST ? iree_wait_set_find(set, &set->handles[i]) : i;
+    if (existing_index >= i) {
+      status = iree_make_status(iree_status_code_from_errno(errno),
+                                "epoll_ctl add failure %d", errno);
+      break;
+    }
+    // Duplicate of a handle in an earlier slot; fold it into that slot.
+    set->handles[existing_index].set_internal.dupe_count +=
+        set->handles[i].set_internal.dupe_count + 1;
+    memset(&set->handles[i], 0, sizeof(set->handles[i]));
+    set->poll_fds[i].fd = -1;
+    set->free_slots[set->free_slot_count++] = (uint16_t)i;
+    --set->handle_count;
+  }
+  if (!iree_status_is_ok(status)) {
+    close(set->epoll_fd);
+    set->epoll_fd = -1;
+  }
+
+  IREE_TRACE_ZONE_END(z0);
+  return status;
 }
 
 iree_status_t iree_wait_set_insert(iree_wait_set_t* set,
                                    iree_wait_handle_t handle) {
-  // TODO(benvanik): epoll_ctl(EPOLL_CTL_ADD)
+  if (set->total_handle_count + 1 > set->capacity) {
+    return iree_make_status(IREE_STATUS_RESOURCE_EXHAUSTED,
+                            "wait set capacity %" PRIhsz
+                            " reached; no more wait handles available",
+                            set->capacity);
+  }
+  int fd = iree_wait_primitive_get_read_fd(&handle);
+  if (IREE_UNLIKELY(fd < 0)) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "wait handle of type %d has no readable fd",
+                            (int)handle.type);
+  }
+
+  // Pick the slot the handle will live in if it is not a duplicate.
+  iree_host_size_t index = set->free_slot_count
+                               ? set->free_slots[set->free_slot_count - 1]
+                               : set->slot_count;
+
+  // Without an epoll instance duplicates simply take another slot. With one
+  // the kernel rejects registering the same fd twice so we only need to look
+  // for an existing entry when it tells us there is one and the common insert
+  // of a unique handle is a single syscall.
+  if (set->epoll_fd >= 0 && iree_wait_set_epoll_add(set, fd, index) < 0) {
+    if (errno != EEXIST) {
+      return iree_make_status(iree_status_code_from_errno(errno),
+                              "epoll_ctl add failure %d", errno);
+    }
+    iree_host_size_t existing_index = iree_wait_set_find(set, &handle);
+    if (IREE_UNLIKELY(existing_index == set->slot_count)) {
+      return iree_make_status(IREE_STATUS_ALREADY_EXISTS,
+                              "fd %d is already registered by another handle",
+                              fd);
+    }
+    // Handle already exists in the set; just increment the reference count.
+    ++set->handles[existing_index].set_internal.dupe_count;
+    ++set->total_handle_count;
+    return iree_ok_status();
+  }
+
+  if (set->free_slot_count) {
+    --set->free_slot_count;
+  } else {
+    ++set->slot_count;
+  }
+  ++set->total_handle_count;
+  ++set->handle_count;
+  iree_wait_handle_t* stored_handle = &set->handles[index];
+  iree_wait_handle_wrap_primitive(handle.type, handle.value, stored_handle);
+  stored_handle->set_internal.dupe_count = 0;  // just us so far
+  struct pollfd* poll_fd = &set->poll_fds[index];
+  poll_fd->fd = fd;
+  poll_fd->events = POLLIN | POLLPRI;  // implicit POLLERR | POLLHUP | POLLNVAL
+  poll_fd->revents = 0;
+
+  return iree_ok_status();
 }
 
 void iree_wait_set_erase(iree_wait_set_t* set, iree_wait_handle_t handle) {
-  // TODO(benvanik): epoll_ctl(EPOLL_CTL_DEL)
+  // Find the user handle in the set. This either requires a linear scan to
+  // find the matching user handle or - if valid - we can use the native index
+  // set after an iree_wait_any wake to do a quick lookup.
+  iree_host_size_t index = handle.set_internal.index;
+  if (IREE_UNLIKELY(index >= set->slot_count) ||
+      IREE_UNLIKELY(!iree_wait_primitive_compare_identical(&set->handles[index],
+                                                           &handle))) {
+    // Fallback to a linear scan of (hopefully) a small list.
+    index = iree_wait_set_find(set, &handle);
+    if (IREE_UNLIKELY(index == set->slot_count)) return;  // not present
+  }
+
+  // Decrement reference count.
+  iree_wait_handle_t* existing_handle = &set->handles[index];
+  --set->total_handle_count;
+  if (existing_handle->set_internal.dupe_count-- > 0) {
+    // Still one or more remaining in the set; leave it registered.
+    return;
+  }
+
+  // No more references remaining; unregister and free the slot. The fd may
+  // have already been closed (which implicitly unregisters it) so failures
+  // are ignored.
+  if (set->epoll_fd >= 0) {
+    epoll_ctl(set->epoll_fd, EPOLL_CTL_DEL, set->poll_fds[index].fd, NULL);
+  }
+  memset(existing_handle, 0, sizeof(*existing_handle));
+  set->poll_fds[index].fd = -1;
+  set->free_slots[set->free_slot_count++] = (uint16_t)index;
+  --set->handle_count;
 }
 
 void iree_wait_set_clear(iree_wait_set_t* set) {
-  // TODO(benvanik): close and reopen?
+  // Dropping the epoll instance unregisters everything in one syscall. The set
+  // will be promoted again if it is refilled and keeps being waited on.
+  if (set->epoll_fd >= 0) {
+    close(set->epoll_fd);
+    set->epoll_fd = -1;
+  }
+  memset(set->handles, 0, set->capacity * sizeof(iree_wait_handle_t));
+  set->total_handle_count = 0;
+  set->handle_count = 0;
+  set->slot_count = 0;
+  set->free_slot_count = 0;
+}
+
+// Maps a poll revent bitfield result to a status (on failure) and an indicator
+// of whether the event was signaled.
+static iree_status_t iree_wait_set_resolve_poll_events(short revents,
+                                                       bool* out_signaled) {
+  if (revents & POLLERR) {
+    return iree_make_status(IREE_STATUS_INTERNAL, "POLLERR on fd");
+  } else if (revents & POLLHUP) {
+    return iree_make_status(IREE_STATUS_CANCELLED, "POLLHUP on fd");
+  } else if (revents & POLLNVAL) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT, "POLLNVAL on fd");
+  }
+  *out_signaled = (revents & POLLIN) != 0;
+  return iree_ok_status();
+}
+
+// Maps epoll events to a status (on failure) and an indicator of whether the
+// handle was signaled.
+static iree_status_t iree_wait_set_resolve_epoll_events(uint32_t events,
+                                                        bool* out_signaled) {
+  if (events & EPOLLERR) {
+    return iree_make_status(IREE_STATUS_INTERNAL, "EPOLLERR on fd");
+  } else if (events & EPOLLHUP) {
+    return iree_make_status(IREE_STATUS_CANCELLED, "EPOLLHUP on fd");
+  }
+  *out_signaled = (events & EPOLLIN) != 0;
+  return iree_ok_status();
 }
 
 iree_status_t iree_wait_all(iree_wait_set_t* set, iree_time_t deadline_ns) {
-  // TODO(benvanik): epoll_wait
+  // Make the syscall only when we have at least one valid fd.
+  // Don't use this as a sleep.
+  if (set->handle_count <= 0) {
+    return iree_ok_status();
+  }
+
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  // epoll has no way to wait for all registered fds and reporting many ready
+  // level-triggered fds costs more than polling them. Wait-all is rare so we
+  // compact the pollfd list into scratch storage and drop handles from it as
+  // they are signaled. Like poll this means the handles need not all be
+  // signaled simultaneously.
+  struct pollfd* poll_fds = set->wait_all_poll_fds;
+  nfds_t poll_fd_count = 0;
+  for (iree_host_size_t i = 0; i < set->slot_count; ++i) {
+    if (set->poll_fds[i].fd < 0) continue;
+    poll_fds[poll_fd_count] = set->poll_fds[i];
+    poll_fds[poll_fd_count].revents = 0;
+    ++poll_fd_count;
+  }
+
+  iree_status_t status = iree_ok_status();
+  while (poll_fd_count > 0 && iree_status_is_ok(status)) {
+    int signaled_count = 0;
+    status = iree_syscall_ppoll(poll_fds, poll_fd_count, deadline_ns,
+                                &signaled_count);
+    // Swap signaled fds with the tail so that only unsignaled fds remain in
+    // the list for the next poll.
+    for (nfds_t i = 0; i < poll_fd_count && iree_status_is_ok(status);) {
+      bool signaled = false;
+      status =
+          iree_wait_set_resolve_poll_events(poll_fds[i].revents, &signaled);
+      if (signaled) {
+        poll_fds[i] = poll_fds[--poll_fd_count];
+      } else {
+        ++i;
+      }
+    }
+  }
+
+  IREE_TRACE_ZONE_END(z0);
+  return status;
 }
 
 iree_status_t iree_wait_any(iree_wait_set_t* set, iree_time_t deadline_ns,
                             iree_wait_handle_t* out_wake_handle) {
-  // TODO(benvanik): epoll_wait
+  // Make the syscall only when we have at least one valid fd.
+  // Don't use this as a sleep.
+  if (set->handle_count <= 0) {
+    if (out_wake_handle) memset(out_wake_handle, 0, sizeof(*out_wake_handle));
+    return iree_ok_status();
+  }
+
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  // Large sets that are waited on repeatedly are worth registering with epoll.
+  if (set->epoll_fd < 0 && set->has_waited &&
+      set->handle_count >= IREE_WAIT_SET_EPOLL_MIN_HANDLE_COUNT) {
+    IREE_RETURN_AND_END_ZONE_IF_ERROR(z0, iree_wait_set_promote_to_epoll(set));
+  }
+  set->has_waited = true;
+
+  // The wake handle is optional for callers that only need to know that some
+  // handle resolved (such as HAL semaphore multi-waits).
+  if (out_wake_handle) memset(out_wake_handle, 0, sizeof(*out_wake_handle));
+
+  bool signaled = false;
+  iree_host_size_t index = 0;
+  int signaled_count = 0;
+  if (set->epoll_fd >= 0) {
+    // We only need one handle so only ask the kernel for one; the slot index
+    // is carried in the event data.
+    struct epoll_event event;
+    IREE_RETURN_AND_END_ZONE_IF_ERROR(
+        z0, iree_syscall_epoll_wait(set->epoll_fd, &event, 1, deadline_ns,
+                                    &signaled_count));
+    if (signaled_count > 0) {
+      IREE_RETURN_AND_END_ZONE_IF_ERROR(
+          z0, iree_wait_set_resolve_epoll_events(event.events, &signaled));
+      index = event.data.u32;
+    }
+  } else {
+    // Poll every slot; free slots have negative fds that the kernel skips.
+    IREE_RETURN_AND_END_ZONE_IF_ERROR(
+        z0, iree_syscall_ppoll(set->poll_fds, set->slot_count, deadline_ns,
+                               &signaled_count));
+    for (iree_host_size_t i = 0; i < set->slot_count && signaled_count > 0;
+         ++i) {
+      if (set->poll_fds[i].fd < 0) continue;
+      IREE_RETURN_AND_END_ZONE_IF_ERROR(
+          z0, iree_wait_set_resolve_poll_events(set->poll_fds[i].revents,
+                                                &signaled));
+      if (signaled) {
+        index = i;
+        break;
+      }
+    }
+  }
+
+  if (out_wake_handle && signaled && index < set->slot_count) {
+    memcpy(out_wake_handle, &set->handles[index], sizeof(*out_wake_handle));
+    out_wake_handle->set_internal.index = index;
+  }
+
+  IREE_TRACE_ZONE_END(z0);
+  return iree_ok_status();
 }
 
 iree_status_t iree_wait_one(iree_wait_handle_t* handle,
                             iree_time_t deadline_ns) {
-  // TODO(benvanik): just use poll?
+  struct pollfd poll_fd;
+  poll_fd.fd = iree_wait_primitive_get_read_fd(handle);
+  if (poll_fd.fd == -1) {
+    // Immediate handles (IREE_WAIT_PRIMITIVE_TYPE_NONE) are always resolved.
+    return iree_ok_status();
+  }
+  poll_fd.events = POLLIN;
+  poll_fd.revents = 0;
+
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  // A single handle doesn't benefit from an epoll instance and ppoll gives us
+  // precise timeouts without any registration overhead.
+  int signaled_count = 0;
+  iree_status_t status =
+      iree_syscall_ppoll(&poll_fd, 1, deadline_ns, &signaled_count);
+
+  IREE_TRACE_ZONE_END(z0);
+  return status;
 }
 
 #endif  // IREE_WAIT_API == IREE_WAIT_API_EPOLL
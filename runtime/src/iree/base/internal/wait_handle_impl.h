@@ -57,11 +57,14 @@
 #elif defined(IREE_PLATFORM_WINDOWS)
 #define IREE_WAIT_API IREE_WAIT_API_WIN32  // WFMO used in wait_handle_win32.c
 #else
-// TODO(benvanik): EPOLL on android/linux/bsd/etc.
+// TODO(benvanik): EPOLL on bsd/etc.
 // TODO(benvanik): KQUEUE on mac/ios.
 // KQUEUE is not implemented yet. Use POLL for mac/ios
-// Android ppoll requires API version >= 21
-#if !defined(IREE_PLATFORM_APPLE) && \
+// Android epoll_create1 and ppoll require API version >= 21
+#if defined(IREE_PLATFORM_LINUX) && \
+    (!defined(__ANDROID_API__) || __ANDROID_API__ >= 21)
+#define IREE_WAIT_API IREE_WAIT_API_EPOLL
+#elif !defined(IREE_PLATFORM_APPLE) && \
     (!defined(__ANDROID_API__) || __ANDROID_API__ >= 21)
 #define IREE_WAIT_API IREE_WAIT_API_PPOLL
 #else
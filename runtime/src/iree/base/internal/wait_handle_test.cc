@@ -796,6 +796,133 @@ TEST(WaitSet, WaitAnyEraseSplit) {
   iree_event_deinitialize(&ev_set);
 }
 
+// Tests the wait-wake-erase-insert pattern used by pollers where the set is
+// kept at capacity and handles are replaced as they resolve.
+TEST(WaitSet, WaitAnyEraseReinsert) {
+  constexpr int kCapacity = 4;
+  iree_event_t events[kCapacity];
+  for (int i = 0; i < kCapacity; ++i) {
+    IREE_ASSERT_OK(iree_event_initialize(/*initial_state=*/false, &events[i]));
+  }
+  iree_wait_set_t* wait_set = NULL;
+  IREE_ASSERT_OK(
+      iree_wait_set_allocate(kCapacity, iree_allocator_system(), &wait_set));
+  for (int i = 0; i < kCapacity; ++i) {
+    IREE_ASSERT_OK(iree_wait_set_insert(wait_set, events[i]));
+  }
+
+  // Set is at capacity.
+  iree_event_t ev_extra;
+  IREE_ASSERT_OK(iree_event_initialize(/*initial_state=*/true, &ev_extra));
+  IREE_EXPECT_STATUS_IS(IREE_STATUS_RESOURCE_EXHAUSTED,
+                        iree_wait_set_insert(wait_set, ev_extra));
+
+  // Repeatedly wake on one handle, erase it, and reinsert it.
+  iree_wait_handle_t wake_handle;
+  for (int round = 0; round < 3; ++round) {
+    for (int i = 0; i < kCapacity; ++i) {
+      iree_event_set(&events[i]);
+      IREE_ASSERT_OK(
+          iree_wait_any(wait_set, IREE_TIME_INFINITE_PAST, &wake_handle));
+      EXPECT_EQ(0, memcmp(&events[i].value, &wake_handle.value,
+                          sizeof(events[i].value)));
+      iree_wait_set_erase(wait_set, wake_handle);
+      iree_event_reset(&events[i]);
+      IREE_ASSERT_OK(iree_wait_set_insert(wait_set, events[i]));
+    }
+  }
+
+  // Nothing is signaled so we should timeout.
+  IREE_EXPECT_STATUS_IS(
+      IREE_STATUS_DEADLINE_EXCEEDED,
+      iree_wait_any(wait_set, IREE_TIME_INFINITE_PAST, &wake_handle));
+
+  iree_wait_set_free(wait_set);
+  iree_event_deinitialize(&ev_extra);
+  for (int i = 0; i < kCapacity; ++i) {
+    iree_event_deinitialize(&events[i]);
+  }
+}
+
+// Tests a large set that is waited on many times. Backends may switch to a
+// different kernel mechanism for such sets (epoll) once they are reused and
+// that must preserve membership, duplicates, and erasure.
+TEST(WaitSet, WaitAnyLargeSetReused) {
+  constexpr int kCount = 64;
+  iree_event_t events[kCount];
+  for (int i = 0; i < kCount; ++i) {
+    IREE_ASSERT_OK(iree_event_initialize(/*initial_state=*/false, &events[i]));
+  }
+  iree_wait_set_t* wait_set = NULL;
+  IREE_ASSERT_OK(
+      iree_wait_set_allocate(kCount + 2, iree_allocator_system(), &wait_set));
+  for (int i = 0; i < kCount; ++i) {
+    IREE_ASSERT_OK(iree_wait_set_insert(wait_set, events[i]));
+  }
+  IREE_ASSERT_OK(iree_wait_set_insert(wait_set, events[0]));
+
+  // Nothing is signaled so both waits should timeout.
+  iree_wait_handle_t wake_handle;
+  for (int i = 0; i < 2; ++i) {
+    iree_status_t status =
+        iree_wait_any(wait_set, IREE_TIME_INFINITE_PAST, &wake_handle);
+    IREE_EXPECT_STATUS_IS(IREE_STATUS_DEADLINE_EXCEEDED, status);
+    iree_status_free(status);
+  }
+
+  // Inserting after the set has been reused must still be observed and
+  // duplicates must still be reference counted.
+  IREE_ASSERT_OK(iree_wait_set_insert(wait_set, events[kCount / 2]));
+  iree_event_set(&events[kCount / 2]);
+  IREE_ASSERT_OK(
+      iree_wait_any(wait_set, IREE_TIME_INFINITE_PAST, &wake_handle));
+  EXPECT_EQ(0, memcmp(&events[kCount / 2].value, &wake_handle.value,
+                      sizeof(events[kCount / 2].value)));
+  iree_wait_set_erase(wait_set, wake_handle);
+  IREE_ASSERT_OK(
+      iree_wait_any(wait_set, IREE_TIME_INFINITE_PAST, &wake_handle));
+  EXPECT_EQ(0, memcmp(&events[kCount / 2].value, &wake_handle.value,
+                      sizeof(events[kCount / 2].value)));
+  iree_wait_set_erase(wait_set, wake_handle);
+  iree_status_t status =
+      iree_wait_any(wait_set, IREE_TIME_INFINITE_PAST, &wake_handle);
+  IREE_EXPECT_STATUS_IS(IREE_STATUS_DEADLINE_EXCEEDED, status);
+  iree_status_free(status);
+
+  // Wake on each handle in turn, erase it, and reinsert it. events[0] was
+  // inserted twice and must remain in the set after one erase.
+  for (int i = 0; i < kCount; ++i) {
+    if (i == kCount / 2) continue;  // erased above
+    iree_event_set(&events[i]);
+    IREE_ASSERT_OK(
+        iree_wait_any(wait_set, IREE_TIME_INFINITE_PAST, &wake_handle));
+    EXPECT_EQ(0, memcmp(&events[i].value, &wake_handle.value,
+                        sizeof(events[i].value)));
+    iree_wait_set_erase(wait_set, wake_handle);
+    if (i == 0) {
+      IREE_ASSERT_OK(
+          iree_wait_any(wait_set, IREE_TIME_INFINITE_PAST, &wake_handle));
+      EXPECT_EQ(0, memcmp(&events[0].value, &wake_handle.value,
+                          sizeof(events[0].value)));
+    }
+    iree_event_reset(&events[i]);
+    IREE_ASSERT_OK(iree_wait_set_insert(wait_set, events[i]));
+  }
+
+  // Clearing and refilling the set must drop all prior registrations.
+  iree_wait_set_clear(wait_set);
+  IREE_ASSERT_OK(iree_wait_set_insert(wait_set, events[kCount / 2]));
+  IREE_ASSERT_OK(
+      iree_wait_any(wait_set, IREE_TIME_INFINITE_PAST, &wake_handle));
+  EXPECT_EQ(0, memcmp(&events[kCount / 2].value, &wake_handle.value,
+                      sizeof(events[kCount / 2].value)));
+
+  iree_wait_set_free(wait_set);
+  for (int i = 0; i < kCount; ++i) {
+    iree_event_deinitialize(&events[i]);
+  }
+}
+
 // Tests iree_wait_one when polling (deadline_ns = IREE_TIME_INFINITE_PAST).
 TEST(WaitSet, WaitOnePolling) {
   iree_event_t ev_unset, ev_set;
@@ -182,6 +182,58 @@ IREE_API_EXPORT iree_status_t iree_loop_wait_all(
   return status;
 }
 
+static iree_status_t iree_loop_io(iree_loop_command_t command, iree_loop_t loop,
+                                  intptr_t file_handle, uint64_t file_offset,
+                                  iree_host_size_t span_count,
+                                  iree_byte_span_t* spans,
+                                  iree_loop_callback_fn_t callback,
+                                  void* user_data) {
+  const iree_loop_io_params_t params = {
+      .callback =
+          {
+              .fn = callback,
+              .user_data = user_data,
+          },
+      .file_handle = file_handle,
+      .file_offset = file_offset,
+      .span_count = span_count,
+      .spans = spans,
+  };
+  return loop.ctl(loop.self, command, &params, NULL);
+}
+
+IREE_API_EXPORT iree_status_t iree_loop_read(
+    iree_loop_t loop, intptr_t file_handle, uint64_t file_offset,
+    iree_host_size_t span_count, iree_byte_span_t* spans,
+    iree_loop_callback_fn_t callback, void* user_data) {
+  if (IREE_UNLIKELY(!loop.ctl)) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT, "null loop");
+  }
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, (uint64_t)span_count);
+  iree_status_t status =
+      iree_loop_io(IREE_LOOP_COMMAND_READ, loop, file_handle, file_offset,
+                   span_count, spans, callback, user_data);
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+IREE_API_EXPORT iree_status_t iree_loop_write(
+    iree_loop_t loop, intptr_t file_handle, uint64_t file_offset,
+    iree_host_size_t span_count, iree_byte_span_t* spans,
+    iree_loop_callback_fn_t callback, void* user_data) {
+  if (IREE_UNLIKELY(!loop.ctl)) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT, "null loop");
+  }
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, (uint64_t)span_count);
+  iree_status_t status =
+      iree_loop_io(IREE_LOOP_COMMAND_WRITE, loop, file_handle, file_offset,
+                   span_count, spans, callback, user_data);
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
 IREE_API_EXPORT iree_status_t iree_loop_drain(iree_loop_t loop,
                                               iree_timeout_t timeout) {
   if (IREE_UNLIKELY(!loop.ctl)) {
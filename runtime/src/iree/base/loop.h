@@ -182,6 +182,38 @@ IREE_API_EXPORT iree_status_t iree_loop_wait_all(
     iree_loop_t loop, iree_host_size_t count, iree_wait_source_t* wait_sources,
     iree_timeout_t timeout, iree_loop_callback_fn_t callback, void* user_data);
 
+// Reads from |file_handle| starting at |file_offset| into the |spans| list of
+// buffers and then issues |callback|. The callback receives
+// IREE_STATUS_OUT_OF_RANGE if the end of the file was reached before all spans
+// were filled.
+//
+// |file_handle| is the platform file handle (a file descriptor on POSIX).
+// Not all implementations support file I/O and may return
+// IREE_STATUS_UNIMPLEMENTED.
+//
+// The callback is guaranteed to be issued.
+// |spans|, the buffers they reference, and |user_data| are not retained and
+// must be live until the callback is issued.
+IREE_API_EXPORT iree_status_t iree_loop_read(
+    iree_loop_t loop, intptr_t file_handle, uint64_t file_offset,
+    iree_host_size_t span_count, iree_byte_span_t* spans,
+    iree_loop_callback_fn_t callback, void* user_data);
+
+// Writes the |spans| list of buffers to |file_handle| starting at
+// |file_offset| and then issues |callback|.
+//
+// |file_handle| is the platform file handle (a file descriptor on POSIX).
+// Not all implementations support file I/O and may return
+// IREE_STATUS_UNIMPLEMENTED.
+//
+// The callback is guaranteed to be issued.
+// |spans|, the buffers they reference, and |user_data| are not retained and
+// must be live until the callback is issued.
+IREE_API_EXPORT iree_status_t iree_loop_write(
+    iree_loop_t loop, intptr_t file_handle, uint64_t file_offset,
+    iree_host_size_t span_count, iree_byte_span_t* spans,
+    iree_loop_callback_fn_t callback, void* user_data);
+
 // Blocks the caller and waits until the loop is idle or |timeout| is reached.
 //
 // Not all implementations support this and may return
@@ -214,11 +246,6 @@ enum iree_loop_command_e {
   //   inout_ptr: unused
   IREE_LOOP_COMMAND_DISPATCH,
 
-  // TODO(benvanik): open/read/write/close/etc with iovecs.
-  // Our iree_byte_span_t matches with `struct iovec` and if we share that we
-  // can do scatter/gather I/O with io_uring.
-  // Want something with an fd, flags, count, and iree_byte_span_t's.
-
   // TODO(benvanik): IREE_LOOP_COMMAND_WAIT_IDLE to get idle callbacks.
 
   // Sleeps until the timeout is reached then issues the callback.
@@ -262,7 +289,25 @@ enum iree_loop_command_e {
   //   inout_ptr: unused
   IREE_LOOP_COMMAND_DRAIN,
 
-  IREE_LOOP_COMMAND_MAX = IREE_LOOP_COMMAND_DRAIN,
+  // Reads from a file into a list of buffers then issues the callback.
+  // The callback will always be called (including when aborted).
+  //
+  // iree_loop_ctl_fn_t:
+  //   params: iree_loop_io_params_t
+  //   inout_ptr: unused
+  IREE_LOOP_COMMAND_READ,
+
+  // Writes a list of buffers to a file then issues the callback.
+  // The callback will always be called (including when aborted).
+  //
+  // iree_loop_ctl_fn_t:
+  //   params: iree_loop_io_params_t
+  //   inout_ptr: unused
+  IREE_LOOP_COMMAND_WRITE,
+
+  // TODO(benvanik): open/close/etc.
+
+  IREE_LOOP_COMMAND_MAX = IREE_LOOP_COMMAND_WRITE,
 };
 
 typedef struct iree_loop_callback_t {
@@ -323,6 +368,22 @@ typedef struct iree_loop_wait_multi_params_t {
   iree_wait_source_t* wait_sources;
 } iree_loop_wait_multi_params_t;
 
+// Parameters for IREE_LOOP_COMMAND_READ / IREE_LOOP_COMMAND_WRITE.
+typedef struct iree_loop_io_params_t {
+  // Callback issued after the transfer completes (successfully or otherwise).
+  iree_loop_callback_t callback;
+  // Platform file handle (a file descriptor on POSIX).
+  intptr_t file_handle;
+  // Byte offset in the file at which the transfer begins.
+  uint64_t file_offset;
+  // Total number of spans in |spans|.
+  iree_host_size_t span_count;
+  // Scatter/gather list of buffers. iree_byte_span_t matches `struct iovec` so
+  // implementations can pass the list directly to the system.
+  // Ownership remains with the issuer and must remain live until the callback.
+  iree_byte_span_t* spans;
+} iree_loop_io_params_t;
+
 // Parameters for IREE_LOOP_COMMAND_DRAIN.
 typedef struct iree_loop_drain_params_t {
   // Time when the wait will abort.
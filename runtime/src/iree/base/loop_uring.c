@@ -0,0 +1,1464 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/base/loop_uring.h"
+
+#include "iree/base/internal/math.h"
+#include "iree/base/internal/wait_handle.h"
+
+#if defined(IREE_PLATFORM_LINUX) && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#define IREE_HAVE_LOOP_URING 1
+#endif  // __has_include(<linux/io_uring.h>)
+#endif  // IREE_PLATFORM_LINUX && __has_include
+
+#if defined(IREE_HAVE_LOOP_URING)
+
+#include <errno.h>
+#include <linux/io_uring.h>
+#include <poll.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <time.h>
+#include <unistd.h>
+
+// NOTE: all callbacks should be at offset 0. This allows for easily zipping
+// through the params lists and issuing callbacks.
+static_assert(offsetof(iree_loop_call_params_t, callback) == 0,
+              "callback must be at offset 0");
+static_assert(offsetof(iree_loop_dispatch_params_t, callback) == 0,
+              "callback must be at offset 0");
+static_assert(offsetof(iree_loop_wait_until_params_t, callback) == 0,
+              "callback must be at offset 0");
+static_assert(offsetof(iree_loop_wait_one_params_t, callback) == 0,
+              "callback must be at offset 0");
+static_assert(offsetof(iree_loop_wait_multi_params_t, callback) == 0,
+              "callback must be at offset 0");
+static_assert(offsetof(iree_loop_io_params_t, callback) == 0,
+              "callback must be at offset 0");
+
+// I/O spans are passed to the kernel directly as iovecs.
+static_assert(sizeof(iree_byte_span_t) == sizeof(struct iovec) &&
+                  offsetof(iree_byte_span_t, data) ==
+                      offsetof(struct iovec, iov_base) &&
+                  offsetof(iree_byte_span_t, data_length) ==
+                      offsetof(struct iovec, iov_len),
+              "iree_byte_span_t must match struct iovec");
+
+// Maximum number of iovecs accepted by a single vectored I/O operation.
+// Longer span lists are transferred in multiple operations.
+#define IREE_LOOP_URING_MAX_IOV_COUNT 1024
+
+static void iree_loop_uring_abort_scope(iree_loop_uring_t* loop_uring,
+                                        iree_loop_uring_scope_t* scope);
+
+//===----------------------------------------------------------------------===//
+// iree_loop_uring_queue_t
+//===----------------------------------------------------------------------===//
+
+// Submission and completion rings shared with the kernel.
+// We only use the features we need from the raw syscall interface so that we
+// don't take a dependency on liburing.
+typedef struct iree_loop_uring_queue_t {
+  // io_uring instance file descriptor.
+  int fd;
+
+  // Shared ring mapping containing both the submission and completion rings.
+  void* ring_ptr;
+  iree_host_size_t ring_size;
+
+  // Submission queue entry storage.
+  struct io_uring_sqe* sqes;
+  iree_host_size_t sqes_size;
+
+  // Submission ring.
+  uint32_t sq_entries;
+  uint32_t sq_mask;
+  uint32_t* sq_khead;
+  uint32_t* sq_ktail;
+  // Tail including all entries prepared locally.
+  uint32_t sq_tail;
+  // Tail of all entries consumed by the kernel.
+  uint32_t sq_submitted;
+
+  // Completion ring.
+  uint32_t cq_mask;
+  uint32_t* cq_khead;
+  uint32_t* cq_ktail;
+  struct io_uring_cqe* cqes;
+} iree_loop_uring_queue_t;
+
+static iree_status_t iree_loop_uring_queue_initialize(
+    uint32_t entries, iree_loop_uring_queue_t* out_queue) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+  memset(out_queue, 0, sizeof(*out_queue));
+  out_queue->fd = -1;
+
+  struct io_uring_params params;
+  memset(&params, 0, sizeof(params));
+  int fd = (int)syscall(__NR_io_uring_setup, entries, &params);
+  if (fd < 0) {
+    int error_number = errno;
+    IREE_TRACE_ZONE_END(z0);
+    return iree_make_status(error_number == ENOSYS || error_number == EPERM
+                                ? IREE_STATUS_UNAVAILABLE
+                                : iree_status_code_from_errno(error_number),
+                            "io_uring_setup failed (%d)", error_number);
+  }
+  out_queue->fd = fd;
+
+  // We need the single mmap layout (5.4), no completion drops (5.5), and
+  // timeouts on io_uring_enter (5.11).
+  const uint32_t required_features =
+      IORING_FEAT_SINGLE_MMAP | IORING_FEAT_NODROP | IORING_FEAT_EXT_ARG;
+  if ((params.features & required_features) != required_features) {
+    close(fd);
+    out_queue->fd = -1;
+    IREE_TRACE_ZONE_END(z0);
+    return iree_make_status(
+        IREE_STATUS_UNAVAILABLE,
+        "io_uring features 0x%08X are missing; Linux 5.11+ is required",
+        required_features & ~params.features);
+  }
+
+  out_queue->ring_size =
+      iree_max(params.sq_off.array + params.sq_entries * sizeof(uint32_t),
+               params.cq_off.cqes +
+                   params.cq_entries * sizeof(struct io_uring_cqe));
+  out_queue->ring_ptr =
+      mmap(NULL, out_queue->ring_size, PROT_READ | PROT_WRITE,
+           MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+  out_queue->sqes_size = params.sq_entries * sizeof(struct io_uring_sqe);
+  out_queue->sqes =
+      mmap(NULL, out_queue->sqes_size, PROT_READ | PROT_WRITE,
+           MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES);
+  if (out_queue->ring_ptr == MAP_FAILED || out_queue->sqes == MAP_FAILED) {
+    int error_number = errno;
+    if (out_queue->ring_ptr != MAP_FAILED) {
+      munmap(out_queue->ring_ptr, out_queue->ring_size);
+    }
+    if (out_queue->sqes != MAP_FAILED) {
+      munmap(out_queue->sqes, out_queue->sqes_size);
+    }
+    close(fd);
+    memset(out_queue, 0, sizeof(*out_queue));
+    out_queue->fd = -1;
+    IREE_TRACE_ZONE_END(z0);
+    return iree_make_status(iree_status_code_from_errno(error_number),
+                            "failed to map io_uring rings (%d)",
+                            error_number);
+  }
+
+  uint8_t* ring_ptr = (uint8_t*)out_queue->ring_ptr;
+  out_queue->sq_entries = params.sq_entries;
+  out_queue->sq_mask = *(uint32_t*)(ring_ptr + params.sq_off.ring_mask);
+  out_queue->sq_khead = (uint32_t*)(ring_ptr + params.sq_off.head);
+  out_queue->sq_ktail = (uint32_t*)(ring_ptr + params.sq_off.tail);
+  out_queue->sq_tail = *out_queue->sq_ktail;
+  out_queue->sq_submitted = out_queue->sq_tail;
+  out_queue->cq_mask = *(uint32_t*)(ring_ptr + params.cq_off.ring_mask);
+  out_queue->cq_khead = (uint32_t*)(ring_ptr + params.cq_off.head);
+  out_queue->cq_ktail = (uint32_t*)(ring_ptr + params.cq_off.tail);
+  out_queue->cqes = (struct io_uring_cqe*)(ring_ptr + params.cq_off.cqes);
+
+  // We always fill entries in order so the indirection array is the identity.
+  uint32_t* sq_array = (uint32_t*)(ring_ptr + params.sq_off.array);
+  for (uint32_t i = 0; i < params.sq_entries; ++i) sq_array[i] = i;
+
+  IREE_TRACE_ZONE_END(z0);
+  return iree_ok_status();
+}
+
+static void iree_loop_uring_queue_deinitialize(
+    iree_loop_uring_queue_t* queue) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+  if (queue->fd != -1) {
+    munmap(queue->sqes, queue->sqes_size);
+    munmap(queue->ring_ptr, queue->ring_size);
+    // Closing the ring cancels any requests still pending in the kernel.
+    close(queue->fd);
+    queue->fd = -1;
+  }
+  IREE_TRACE_ZONE_END(z0);
+}
+
+// Publishes all prepared submissions and optionally waits for at least
+// |min_complete| completions to be available or |deadline_ns| to elapse.
+// Returns IREE_STATUS_DEADLINE_EXCEEDED if the wait timed out.
+static iree_status_t iree_loop_uring_queue_enter(iree_loop_uring_queue_t* queue,
+                                                 uint32_t min_complete,
+                                                 iree_time_t deadline_ns) {
+  __atomic_store_n(queue->sq_ktail, queue->sq_tail, __ATOMIC_RELEASE);
+  uint32_t to_submit = queue->sq_tail - queue->sq_submitted;
+
+  uint32_t flags = 0;
+  struct __kernel_timespec ts;
+  struct io_uring_getevents_arg arg;
+  memset(&arg, 0, sizeof(arg));
+  if (min_complete) {
+    flags |= IORING_ENTER_GETEVENTS | IORING_ENTER_EXT_ARG;
+    if (deadline_ns != IREE_TIME_INFINITE_FUTURE) {
+      iree_duration_t timeout_ns =
+          iree_max(0, iree_absolute_deadline_to_timeout_ns(deadline_ns));
+      ts.tv_sec = timeout_ns / 1000000000ull;
+      ts.tv_nsec = timeout_ns % 1000000000ull;
+      arg.ts = (uint64_t)(uintptr_t)&ts;
+    }
+  } else if (!to_submit) {
+    return iree_ok_status();
+  }
+
+  int rv = (int)syscall(__NR_io_uring_enter, queue->fd, to_submit,
+                        min_complete, flags, min_complete ? &arg : NULL,
+                        min_complete ? sizeof(arg) : 0);
+  if (rv < 0) {
+    switch (errno) {
+      case ETIME:
+        return iree_status_from_code(IREE_STATUS_DEADLINE_EXCEEDED);
+      case EINTR:
+      case EAGAIN:
+      case EBUSY:
+        // Interrupted or the completion ring is backed up; the caller will
+        // reap what is available and try again.
+        return iree_ok_status();
+      default:
+        return iree_make_status(iree_status_code_from_errno(errno),
+                                "io_uring_enter failed (%d)", errno);
+    }
+  }
+  queue->sq_submitted += (uint32_t)rv;
+  return iree_ok_status();
+}
+
+// Returns a zeroed submission queue entry for the caller to prepare.
+// The entry is submitted on the next iree_loop_uring_queue_enter.
+static iree_status_t iree_loop_uring_queue_acquire_sqe(
+    iree_loop_uring_queue_t* queue, struct io_uring_sqe** out_sqe) {
+  uint32_t head = __atomic_load_n(queue->sq_khead, __ATOMIC_ACQUIRE);
+  if (queue->sq_tail - head >= queue->sq_entries) {
+    // Ring full; flush what we have to the kernel to make space.
+    IREE_RETURN_IF_ERROR(iree_loop_uring_queue_enter(
+        queue, /*min_complete=*/0, IREE_TIME_INFINITE_PAST));
+    head = __atomic_load_n(queue->sq_khead, __ATOMIC_ACQUIRE);
+    if (queue->sq_tail - head >= queue->sq_entries) {
+      return iree_make_status(IREE_STATUS_RESOURCE_EXHAUSTED,
+                              "io_uring submission queue capacity %u exceeded",
+                              queue->sq_entries);
+    }
+  }
+  struct io_uring_sqe* sqe = &queue->sqes[queue->sq_tail & queue->sq_mask];
+  memset(sqe, 0, sizeof(*sqe));
+  ++queue->sq_tail;
+  *out_sqe = sqe;
+  return iree_ok_status();
+}
+
+//===----------------------------------------------------------------------===//
+// iree_loop_uring_run_ring_t
+//===----------------------------------------------------------------------===//
+
+// Represents an operation in the loop run ringbuffer.
+typedef struct iree_loop_uring_run_op_t {
+  union {
+    iree_loop_callback_t callback;  // asserted at offset 0 above
+    union {
+      iree_loop_call_params_t call;
+      iree_loop_dispatch_params_t dispatch;
+    } params;
+  };
+  iree_loop_command_t command;
+  iree_loop_uring_scope_t* scope;
+
+  // Set on calls when we are issuing a callback for an operation.
+  // Unlike other pointers in the params this is owned by the ring.
+  iree_status_t status;
+} iree_loop_uring_run_op_t;
+
+// Ringbuffer containing pending ready to run callback operations.
+// Completions reaped from the kernel are routed through the ring so that they
+// are sequenced with other runnable work.
+typedef iree_alignas(iree_max_align_t) struct iree_loop_uring_run_ring_t {
+  // Storage capacity of |ops|; always a power of two.
+  uint32_t capacity;
+  // Index into |ops| where the next operation to be dequeued is located.
+  uint32_t read_head;
+  // Index into |ops| where the next operation will be enqueued.
+  uint32_t write_head;
+  // Ringbuffer storage.
+  iree_loop_uring_run_op_t ops[0];
+} iree_loop_uring_run_ring_t;
+
+static iree_host_size_t iree_loop_uring_run_ring_storage_size(
+    iree_loop_uring_options_t options) {
+  return sizeof(iree_loop_uring_run_ring_t) +
+         options.max_queue_depth * sizeof(iree_loop_uring_run_op_t);
+}
+
+static bool iree_loop_uring_run_ring_is_empty(
+    const iree_loop_uring_run_ring_t* run_ring) {
+  return run_ring->read_head == run_ring->write_head;
+}
+
+static iree_status_t iree_loop_uring_run_ring_enqueue(
+    iree_loop_uring_run_ring_t* run_ring, iree_loop_uring_run_op_t op) {
+  const uint32_t mask = run_ring->capacity - 1;
+  if (((run_ring->write_head - run_ring->read_head) & mask) == mask) {
+    iree_status_ignore(op.status);
+    return iree_make_status(
+        IREE_STATUS_RESOURCE_EXHAUSTED,
+        "run ringbuffer capacity %u exceeded; reduce the amount of concurrent "
+        "work or increase max_queue_depth",
+        run_ring->capacity);
+  }
+  run_ring->ops[run_ring->write_head] = op;
+  run_ring->write_head = (run_ring->write_head + 1) & mask;
+  ++op.scope->pending_count;
+  return iree_ok_status();
+}
+
+static bool iree_loop_uring_run_ring_dequeue(
+    iree_loop_uring_run_ring_t* run_ring, iree_loop_uring_run_op_t* out_op) {
+  if (iree_loop_uring_run_ring_is_empty(run_ring)) return false;
+  // Copy out the parameters; the operation we execute may overwrite them by
+  // enqueuing more work.
+  *out_op = run_ring->ops[run_ring->read_head];
+  run_ring->read_head = (run_ring->read_head + 1) & (run_ring->capacity - 1);
+  --out_op->scope->pending_count;
+  return true;
+}
+
+// Aborts all ops that are part of |scope|.
+// A NULL |scope| indicates all work from all scopes should be aborted.
+static void iree_loop_uring_run_ring_abort_scope(
+    iree_loop_uring_run_ring_t* run_ring, iree_loop_uring_scope_t* scope) {
+  if (iree_loop_uring_run_ring_is_empty(run_ring)) return;
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  // Dequeue all ops and re-enqueue any that don't match so that the remaining
+  // ops retain their original order.
+  const uint32_t count =
+      (run_ring->write_head - run_ring->read_head) & (run_ring->capacity - 1);
+  for (uint32_t i = 0; i < count; ++i) {
+    iree_loop_uring_run_op_t op;
+    if (!iree_loop_uring_run_ring_dequeue(run_ring, &op)) break;
+    if (scope && op.scope != scope) {
+      iree_status_ignore(iree_loop_uring_run_ring_enqueue(run_ring, op));
+    } else {
+      iree_status_ignore(op.status);
+      iree_status_ignore(op.callback.fn(op.callback.user_data, iree_loop_null(),
+                                        iree_make_status(IREE_STATUS_ABORTED)));
+    }
+  }
+
+  IREE_TRACE_ZONE_END(z0);
+}
+
+//===----------------------------------------------------------------------===//
+// iree_loop_uring_op_t
+//===----------------------------------------------------------------------===//
+
+// Each submission encodes the index of the op it belongs to and its kind in the
+// user_data so that completions can be routed back without any lookups.
+typedef enum iree_loop_uring_sqe_kind_e {
+  // Poll on the fd of one of the wait sources of a wait op.
+  IREE_LOOP_URING_SQE_KIND_POLL = 0,
+  // Timeout used for wait-until or the deadline of a wait op.
+  IREE_LOOP_URING_SQE_KIND_TIMEOUT = 1,
+  // Read or write of an I/O op.
+  IREE_LOOP_URING_SQE_KIND_IO = 2,
+} iree_loop_uring_sqe_kind_t;
+
+// user_data of submissions whose completions are ignored (cancellations).
+#define IREE_LOOP_URING_USER_DATA_IGNORE UINT64_MAX
+
+static inline uint64_t iree_loop_uring_make_user_data(
+    uint32_t op_index, iree_loop_uring_sqe_kind_t kind) {
+  return ((uint64_t)op_index << 8) | (uint64_t)kind;
+}
+
+// An operation with submissions pending in the kernel.
+typedef struct iree_loop_uring_op_t {
+  union {
+    iree_loop_callback_t callback;  // asserted at offset 0 above
+    union {
+      iree_loop_wait_until_params_t wait_until;
+      iree_loop_wait_one_params_t wait_one;
+      iree_loop_wait_multi_params_t wait_multi;
+      iree_loop_io_params_t io;
+    } params;
+  };
+  iree_loop_command_t command;
+  // Scope the op was issued against or NULL if the slot is free.
+  iree_loop_uring_scope_t* scope;
+
+  // True once the op has completed and its callback has been scheduled. The
+  // slot is not reused until all of its submissions have completed.
+  bool retired;
+  // True while the op is being aborted and its callback has not been issued.
+  bool aborting;
+  // True if a timeout submission is pending in the kernel.
+  bool has_timeout;
+
+  // Number of submissions that have not yet produced a completion.
+  uint32_t inflight_count;
+  // Number of poll submissions that have not yet produced a completion.
+  uint32_t poll_count;
+  // Number of polls that must complete before a wait-all is satisfied.
+  uint32_t unresolved_count;
+
+  // Absolute CLOCK_MONOTONIC timeout. The kernel reads this when the
+  // submission is consumed so it must remain live until then.
+  struct __kernel_timespec timeout_ts;
+
+  // I/O progress: current span, byte offset within that span, and file offset.
+  iree_host_size_t span_index;
+  iree_host_size_t span_offset;
+  uint64_t file_offset;
+
+  // Next slot in the free list when the slot is unused.
+  uint32_t next_free;
+} iree_loop_uring_op_t;
+
+//===----------------------------------------------------------------------===//
+// iree_loop_uring_scope_t
+//===----------------------------------------------------------------------===//
+
+IREE_API_EXPORT void iree_loop_uring_scope_initialize(
+    iree_loop_uring_t* loop_uring, iree_loop_uring_error_fn_t error_fn,
+    void* error_user_data, iree_loop_uring_scope_t* out_scope) {
+  memset(out_scope, 0, sizeof(*out_scope));
+  out_scope->loop_uring = loop_uring;
+  out_scope->pending_count = 0;
+  out_scope->error_fn = error_fn;
+  out_scope->error_user_data = error_user_data;
+}
+
+IREE_API_EXPORT void iree_loop_uring_scope_deinitialize(
+    iree_loop_uring_scope_t* scope) {
+  IREE_ASSERT_ARGUMENT(scope);
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  if (scope->loop_uring) {
+    iree_loop_uring_abort_scope(scope->loop_uring, scope);
+  }
+
+  IREE_TRACE_ZONE_END(z0);
+}
+
+//===----------------------------------------------------------------------===//
+// iree_loop_uring_t
+//===----------------------------------------------------------------------===//
+
+typedef struct iree_loop_uring_t {
+  iree_allocator_t allocator;
+
+  // Kernel submission and completion rings.
+  iree_loop_uring_queue_t queue;
+
+  // Runnable operations; NULL while shutting down.
+  iree_loop_uring_run_ring_t* run_ring;
+
+  // Number of ops that have not yet been retired.
+  iree_host_size_t active_count;
+  // Total number of slots in |ops|.
+  uint32_t op_capacity;
+  // Head of the free slot list or UINT32_MAX if all slots are in use.
+  uint32_t op_free_head;
+  iree_loop_uring_op_t* ops;
+
+  // Trailing data:
+  // + iree_loop_uring_run_ring_storage_size
+  // + op_capacity * sizeof(iree_loop_uring_op_t)
+} iree_loop_uring_t;
+
+IREE_API_EXPORT iree_status_t iree_loop_uring_allocate(
+    iree_loop_uring_options_t options, iree_allocator_t allocator,
+    iree_loop_uring_t** out_loop_uring) {
+  IREE_ASSERT_ARGUMENT(out_loop_uring);
+  *out_loop_uring = NULL;
+
+  // The run queue must be a power of two due to the ringbuffer masking
+  // technique we use.
+  options.max_queue_depth =
+      iree_math_round_up_to_pow2_u32((uint32_t)options.max_queue_depth);
+  if (options.max_queue_depth > UINT16_MAX) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "queue depth exceeds maximum");
+  }
+  if (IREE_UNLIKELY(options.max_pending_count > UINT16_MAX)) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "pending operation count exceeds maximum");
+  }
+  if (!options.submission_queue_depth) {
+    options.submission_queue_depth = iree_max(8, options.max_pending_count);
+  }
+
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  const iree_host_size_t loop_uring_size =
+      iree_host_align(sizeof(iree_loop_uring_t), iree_max_align_t);
+  const iree_host_size_t run_ring_size = iree_host_align(
+      iree_loop_uring_run_ring_storage_size(options), iree_max_align_t);
+  const iree_host_size_t ops_size =
+      options.max_pending_count * sizeof(iree_loop_uring_op_t);
+  const iree_host_size_t total_storage_size =
+      loop_uring_size + run_ring_size + ops_size;
+
+  uint8_t* storage = NULL;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0,
+      iree_allocator_malloc(allocator, total_storage_size, (void**)&storage));
+  iree_loop_uring_t* loop_uring = (iree_loop_uring_t*)storage;
+  loop_uring->allocator = allocator;
+  loop_uring->queue.fd = -1;
+  loop_uring->run_ring =
+      (iree_loop_uring_run_ring_t*)(storage + loop_uring_size);
+  loop_uring->run_ring->capacity = (uint32_t)options.max_queue_depth;
+  loop_uring->run_ring->read_head = 0;
+  loop_uring->run_ring->write_head = 0;
+  loop_uring->active_count = 0;
+  loop_uring->op_capacity = (uint32_t)options.max_pending_count;
+  loop_uring->ops =
+      (iree_loop_uring_op_t*)(storage + loop_uring_size + run_ring_size);
+  loop_uring->op_free_head = loop_uring->op_capacity ? 0 : UINT32_MAX;
+  for (uint32_t i = 0; i < loop_uring->op_capacity; ++i) {
+    loop_uring->ops[i].next_free =
+        i + 1 < loop_uring->op_capacity ? i + 1 : UINT32_MAX;
+  }
+
+  iree_status_t status = iree_loop_uring_queue_initialize(
+      (uint32_t)options.submission_queue_depth, &loop_uring->queue);
+
+  if (iree_status_is_ok(status)) {
+    *out_loop_uring = loop_uring;
+  } else {
+    iree_loop_uring_free(loop_uring);
+  }
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+// Reaps all available completions and routes them to their ops.
+// Returns the number of completions reaped.
+static iree_host_size_t iree_loop_uring_reap(iree_loop_uring_t* loop_uring);
+
+// Blocks until all I/O submissions of ops being aborted have completed.
+// The kernel may otherwise still reference the buffers the issuer is about to
+// free in response to the abort.
+static void iree_loop_uring_flush_aborted_io(iree_loop_uring_t* loop_uring) {
+  for (;;) {
+    bool any_pending = false;
+    for (uint32_t i = 0; i < loop_uring->op_capacity; ++i) {
+      const iree_loop_uring_op_t* op = &loop_uring->ops[i];
+      if (op->aborting && op->inflight_count &&
+          (op->command == IREE_LOOP_COMMAND_READ ||
+           op->command == IREE_LOOP_COMMAND_WRITE)) {
+        any_pending = true;
+        break;
+      }
+    }
+    if (!any_pending) break;
+    iree_status_t status = iree_loop_uring_queue_enter(
+        &loop_uring->queue, /*min_complete=*/1, IREE_TIME_INFINITE_FUTURE);
+    if (!iree_status_is_ok(status)) {
+      // Nothing we can do; leaking the ops is better than corrupting memory.
+      iree_status_ignore(status);
+      break;
+    }
+    iree_loop_uring_reap(loop_uring);
+  }
+}
+
+IREE_API_EXPORT void iree_loop_uring_free(iree_loop_uring_t* loop_uring) {
+  IREE_ASSERT_ARGUMENT(loop_uring);
+  IREE_TRACE_ZONE_BEGIN(z0);
+  iree_allocator_t allocator = loop_uring->allocator;
+
+  // Abort all pending operations.
+  // This will issue callbacks for each operation that was aborted directly
+  // with IREE_STATUS_ABORTED.
+  if (loop_uring->queue.fd != -1) {
+    iree_loop_uring_abort_scope(loop_uring, /*scope=*/NULL);
+  }
+
+  // To ensure we don't enqueue more work while aborting we NULL out the ring.
+  loop_uring->run_ring = NULL;
+
+  // Any polls or timeouts still pending are cancelled by the kernel when the
+  // ring is closed; none of them reference user memory.
+  iree_loop_uring_queue_deinitialize(&loop_uring->queue);
+  iree_allocator_free(allocator, loop_uring);
+
+  IREE_TRACE_ZONE_END(z0);
+}
+
+static iree_status_t iree_loop_uring_acquire_op(iree_loop_uring_t* loop_uring,
+                                                iree_loop_uring_scope_t* scope,
+                                                iree_loop_command_t command,
+                                                iree_loop_uring_op_t** out_op) {
+  if (loop_uring->op_free_head == UINT32_MAX) {
+    return iree_make_status(IREE_STATUS_RESOURCE_EXHAUSTED,
+                            "pending operation capacity %u reached",
+                            loop_uring->op_capacity);
+  }
+  iree_loop_uring_op_t* op = &loop_uring->ops[loop_uring->op_free_head];
+  loop_uring->op_free_head = op->next_free;
+  memset(op, 0, sizeof(*op));
+  op->command = command;
+  op->scope = scope;
+  op->next_free = UINT32_MAX;
+  *out_op = op;
+  return iree_ok_status();
+}
+
+// Returns |op| to the free list if it has retired and the kernel is done
+// with all of its submissions.
+static void iree_loop_uring_maybe_release_op(iree_loop_uring_t* loop_uring,
+                                             iree_loop_uring_op_t* op) {
+  if (!op->retired || op->inflight_count) return;
+  op->scope = NULL;
+  op->next_free = loop_uring->op_free_head;
+  loop_uring->op_free_head = (uint32_t)(op - loop_uring->ops);
+}
+
+static uint32_t iree_loop_uring_op_index(iree_loop_uring_t* loop_uring,
+                                         iree_loop_uring_op_t* op) {
+  return (uint32_t)(op - loop_uring->ops);
+}
+
+// Submits a cancellation of all of |op|'s pending submissions.
+// The cancelled submissions still produce completions that must be reaped
+// before the op can be released.
+static void iree_loop_uring_cancel_op(iree_loop_uring_t* loop_uring,
+                                      iree_loop_uring_op_t* op) {
+  const uint32_t op_index = iree_loop_uring_op_index(loop_uring, op);
+  struct io_uring_sqe* sqe = NULL;
+  // Each poll removal only matches a single poll so we need one per poll.
+  for (uint32_t i = 0; i < op->poll_count; ++i) {
+    if (!iree_status_is_ok(iree_loop_uring_queue_acquire_sqe(&loop_uring->queue,
+                                                             &sqe))) {
+      return;
+    }
+    sqe->opcode = IORING_OP_POLL_REMOVE;
+    sqe->fd = -1;
+    sqe->addr =
+        iree_loop_uring_make_user_data(op_index, IREE_LOOP_URING_SQE_KIND_POLL);
+    sqe->user_data = IREE_LOOP_URING_USER_DATA_IGNORE;
+  }
+  if (op->has_timeout) {
+    if (!iree_status_is_ok(iree_loop_uring_queue_acquire_sqe(&loop_uring->queue,
+                                                             &sqe))) {
+      return;
+    }
+    sqe->opcode = IORING_OP_TIMEOUT_REMOVE;
+    sqe->fd = -1;
+    sqe->addr = iree_loop_uring_make_user_data(
+        op_index, IREE_LOOP_URING_SQE_KIND_TIMEOUT);
+    sqe->user_data = IREE_LOOP_URING_USER_DATA_IGNORE;
+  }
+  if (op->command == IREE_LOOP_COMMAND_READ ||
+      op->command == IREE_LOOP_COMMAND_WRITE) {
+    if (op->inflight_count &&
+        iree_status_is_ok(
+            iree_loop_uring_queue_acquire_sqe(&loop_uring->queue, &sqe))) {
+      sqe->opcode = IORING_OP_ASYNC_CANCEL;
+      sqe->fd = -1;
+      sqe->addr =
+          iree_loop_uring_make_user_data(op_index, IREE_LOOP_URING_SQE_KIND_IO);
+      sqe->user_data = IREE_LOOP_URING_USER_DATA_IGNORE;
+    }
+  }
+}
+
+// Retires |op| and schedules its callback with |status| on the run ring.
+static iree_status_t iree_loop_uring_complete_op(iree_loop_uring_t* loop_uring,
+                                                 iree_loop_uring_op_t* op,
+                                                 iree_status_t status) {
+  iree_loop_uring_cancel_op(loop_uring, op);
+  op->retired = true;
+  --loop_uring->active_count;
+  iree_loop_uring_scope_t* scope = op->scope;
+  --scope->pending_count;
+  iree_loop_callback_t callback = op->callback;
+  iree_loop_uring_maybe_release_op(loop_uring, op);
+
+  // Enqueue the callback on the run ring - this ensures it gets sequenced with
+  // other runnable work and keeps ordering easier to reason about.
+  return iree_loop_uring_run_ring_enqueue(
+      loop_uring->run_ring,
+      (iree_loop_uring_run_op_t){
+          .command = IREE_LOOP_COMMAND_CALL,
+          .scope = scope,
+          .params =
+              {
+                  .call =
+                      {
+                          .callback = callback,
+                          .priority = IREE_LOOP_PRIORITY_DEFAULT,
+                      },
+              },
+          .status = status,
+      });
+}
+
+// Retires |op| without issuing its callback. Used when enqueuing fails and the
+// error is returned to the issuer instead.
+static void iree_loop_uring_discard_op(iree_loop_uring_t* loop_uring,
+                                       iree_loop_uring_op_t* op) {
+  iree_loop_uring_cancel_op(loop_uring, op);
+  op->retired = true;
+  iree_loop_uring_maybe_release_op(loop_uring, op);
+}
+
+// Enqueues a callback for an op that resolved without any kernel work.
+static iree_status_t iree_loop_uring_enqueue_resolved(
+    iree_loop_uring_t* loop_uring, iree_loop_uring_scope_t* scope,
+    iree_loop_callback_t callback, iree_status_t status) {
+  return iree_loop_uring_run_ring_enqueue(
+      loop_uring->run_ring,
+      (iree_loop_uring_run_op_t){
+          .command = IREE_LOOP_COMMAND_CALL,
+          .scope = scope,
+          .params =
+              {
+                  .call =
+                      {
+                          .callback = callback,
+                          .priority = IREE_LOOP_PRIORITY_DEFAULT,
+                      },
+              },
+          .status = status,
+      });
+}
+
+// Converts an absolute iree_time_t deadline into an absolute CLOCK_MONOTONIC
+// timespec as used by io_uring timeouts. iree_time_now is not guaranteed to
+// use the monotonic clock so we rebase relative to the current time.
+static void iree_loop_uring_make_timeout_ts(iree_time_t deadline_ns,
+                                            struct __kernel_timespec* out_ts) {
+  iree_duration_t timeout_ns =
+      iree_max(0, iree_absolute_deadline_to_timeout_ns(deadline_ns));
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  uint64_t monotonic_ns =
+      (uint64_t)now.tv_sec * 1000000000ull + now.tv_nsec + timeout_ns;
+  out_ts->tv_sec = monotonic_ns / 1000000000ull;
+  out_ts->tv_nsec = monotonic_ns % 1000000000ull;
+}
+
+static iree_status_t iree_loop_uring_submit_timeout(
+    iree_loop_uring_t* loop_uring, iree_loop_uring_op_t* op,
+    iree_time_t deadline_ns) {
+  struct io_uring_sqe* sqe = NULL;
+  IREE_RETURN_IF_ERROR(
+      iree_loop_uring_queue_acquire_sqe(&loop_uring->queue, &sqe));
+  iree_loop_uring_make_timeout_ts(deadline_ns, &op->timeout_ts);
+  sqe->opcode = IORING_OP_TIMEOUT;
+  sqe->fd = -1;
+  sqe->addr = (uint64_t)(uintptr_t)&op->timeout_ts;
+  sqe->len = 1;
+  sqe->timeout_flags = IORING_TIMEOUT_ABS;
+  sqe->user_data = iree_loop_uring_make_user_data(
+      iree_loop_uring_op_index(loop_uring, op),
+      IREE_LOOP_URING_SQE_KIND_TIMEOUT);
+  op->has_timeout = true;
+  ++op->inflight_count;
+  return iree_ok_status();
+}
+
+static iree_status_t iree_loop_uring_enqueue_wait_until(
+    iree_loop_uring_t* loop_uring, iree_loop_uring_scope_t* scope,
+    const iree_loop_wait_until_params_t* params) {
+  if (params->deadline_ns <= iree_time_now()) {
+    return iree_loop_uring_enqueue_resolved(loop_uring, scope,
+                                            params->callback, iree_ok_status());
+  }
+  IREE_TRACE_ZONE_BEGIN(z0);
+  iree_loop_uring_op_t* op = NULL;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_loop_uring_acquire_op(loop_uring, scope,
+                                     IREE_LOOP_COMMAND_WAIT_UNTIL, &op));
+  op->params.wait_until = *params;
+  iree_status_t status =
+      iree_loop_uring_submit_timeout(loop_uring, op, params->deadline_ns);
+  if (iree_status_is_ok(status)) {
+    ++loop_uring->active_count;
+    ++scope->pending_count;
+  } else {
+    iree_loop_uring_discard_op(loop_uring, op);
+  }
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+// Returns the fd that can be polled for |wait_handle| to resolve.
+static int iree_loop_uring_wait_handle_fd(
+    const iree_wait_handle_t* wait_handle) {
+  switch (wait_handle->type) {
+#if defined(IREE_HAVE_WAIT_TYPE_EVENTFD)
+    case IREE_WAIT_PRIMITIVE_TYPE_EVENT_FD:
+      return wait_handle->value.event.fd;
+#endif  // IREE_HAVE_WAIT_TYPE_EVENTFD
+#if defined(IREE_HAVE_WAIT_TYPE_SYNC_FILE)
+    case IREE_WAIT_PRIMITIVE_TYPE_SYNC_FILE:
+      return wait_handle->value.sync_file.fd;
+#endif  // IREE_HAVE_WAIT_TYPE_SYNC_FILE
+#if defined(IREE_HAVE_WAIT_TYPE_PIPE)
+    case IREE_WAIT_PRIMITIVE_TYPE_PIPE:
+      return wait_handle->value.pipe.read_fd;
+#endif  // IREE_HAVE_WAIT_TYPE_PIPE
+    default:
+      return -1;
+  }
+}
+
+// Submits a poll on |wait_source|, exporting it to a system wait handle if
+// required. As with iree_loop_sync_t the wait source is replaced with the
+// exported handle so that it is only exported once.
+static iree_status_t iree_loop_uring_submit_poll(
+    iree_loop_uring_t* loop_uring, iree_loop_uring_op_t* op,
+    iree_wait_source_t* wait_source) {
+  iree_wait_handle_t wait_handle = iree_wait_handle_immediate();
+  iree_wait_handle_t* wait_handle_ptr =
+      iree_wait_handle_from_source(wait_source);
+  if (wait_handle_ptr) {
+    wait_handle = *wait_handle_ptr;
+  } else {
+    iree_wait_primitive_t wait_primitive = iree_wait_primitive_immediate();
+    IREE_RETURN_IF_ERROR(iree_wait_source_export(
+        *wait_source, IREE_WAIT_PRIMITIVE_TYPE_ANY, iree_immediate_timeout(),
+        &wait_primitive));
+    iree_wait_handle_wrap_primitive(wait_primitive.type, wait_primitive.value,
+                                    &wait_handle);
+    IREE_RETURN_IF_ERROR(iree_wait_source_import(wait_primitive, wait_source));
+  }
+
+  int fd = iree_loop_uring_wait_handle_fd(&wait_handle);
+  if (fd < 0) {
+    return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
+                            "wait primitive type %d cannot be polled",
+                            (int)wait_handle.type);
+  }
+
+  struct io_uring_sqe* sqe = NULL;
+  IREE_RETURN_IF_ERROR(
+      iree_loop_uring_queue_acquire_sqe(&loop_uring->queue, &sqe));
+  sqe->opcode = IORING_OP_POLL_ADD;
+  sqe->fd = fd;
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+  sqe->poll32_events = __builtin_bswap32(POLLIN);
+#else
+  sqe->poll32_events = POLLIN;
+#endif  // __BYTE_ORDER__
+  sqe->user_data = iree_loop_uring_make_user_data(
+      iree_loop_uring_op_index(loop_uring, op), IREE_LOOP_URING_SQE_KIND_POLL);
+  ++op->poll_count;
+  ++op->inflight_count;
+  return iree_ok_status();
+}
+
+static iree_status_t iree_loop_uring_enqueue_wait(
+    iree_loop_uring_t* loop_uring, iree_loop_uring_scope_t* scope,
+    iree_loop_command_t command, iree_loop_callback_t callback,
+    iree_time_t deadline_ns, iree_host_size_t count,
+    iree_wait_source_t* wait_sources, const void* params) {
+  // Query all wait sources first so that already resolved waits don't need
+  // any kernel work. Wait-all sources that have resolved are neutered so that
+  // they are not polled.
+  iree_host_size_t unresolved_count = 0;
+  for (iree_host_size_t i = 0; i < count; ++i) {
+    if (iree_wait_source_is_delay(wait_sources[i])) {
+      // We can't easily support delays as polled wait sources; use
+      // iree_loop_wait_until instead.
+      return iree_make_status(IREE_STATUS_FAILED_PRECONDITION,
+                              "delays must come from wait-until ops");
+    }
+    iree_status_code_t wait_status_code = IREE_STATUS_OK;
+    IREE_RETURN_IF_ERROR(
+        iree_wait_source_query(wait_sources[i], &wait_status_code));
+    if (wait_status_code == IREE_STATUS_OK) {
+      if (command != IREE_LOOP_COMMAND_WAIT_ALL) {
+        // One resolved; wait-one/wait-any satisfied.
+        return iree_loop_uring_enqueue_resolved(loop_uring, scope, callback,
+                                                iree_ok_status());
+      }
+      wait_sources[i] = iree_wait_source_immediate();
+    } else if (wait_status_code != IREE_STATUS_DEFERRED) {
+      // Wait source failed.
+      return iree_loop_uring_enqueue_resolved(
+          loop_uring, scope, callback, iree_status_from_code(wait_status_code));
+    } else {
+      ++unresolved_count;
+    }
+  }
+  if (!unresolved_count) {
+    return iree_loop_uring_enqueue_resolved(loop_uring, scope, callback,
+                                            iree_ok_status());
+  } else if (deadline_ns <= iree_time_now()) {
+    return iree_loop_uring_enqueue_resolved(
+        loop_uring, scope, callback,
+        iree_status_from_code(IREE_STATUS_DEADLINE_EXCEEDED));
+  }
+
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, (int64_t)unresolved_count);
+
+  iree_loop_uring_op_t* op = NULL;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_loop_uring_acquire_op(loop_uring, scope, command, &op));
+  if (command == IREE_LOOP_COMMAND_WAIT_ONE) {
+    op->params.wait_one = *(const iree_loop_wait_one_params_t*)params;
+    wait_sources = &op->params.wait_one.wait_source;
+  } else {
+    op->params.wait_multi = *(const iree_loop_wait_multi_params_t*)params;
+  }
+  op->unresolved_count =
+      command == IREE_LOOP_COMMAND_WAIT_ALL ? (uint32_t)unresolved_count : 1;
+
+  iree_status_t status = iree_ok_status();
+  for (iree_host_size_t i = 0; i < count && iree_status_is_ok(status); ++i) {
+    if (iree_wait_source_is_immediate(wait_sources[i])) continue;
+    status = iree_loop_uring_submit_poll(loop_uring, op, &wait_sources[i]);
+  }
+  if (iree_status_is_ok(status) && deadline_ns != IREE_TIME_INFINITE_FUTURE) {
+    status = iree_loop_uring_submit_timeout(loop_uring, op, deadline_ns);
+  }
+
+  if (iree_status_is_ok(status)) {
+    ++loop_uring->active_count;
+    ++scope->pending_count;
+  } else {
+    iree_loop_uring_discard_op(loop_uring, op);
+  }
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+// Submits the next chunk of the transfer of I/O |op| from its current cursor.
+static iree_status_t iree_loop_uring_submit_io(iree_loop_uring_t* loop_uring,
+                                               iree_loop_uring_op_t* op) {
+  struct io_uring_sqe* sqe = NULL;
+  IREE_RETURN_IF_ERROR(
+      iree_loop_uring_queue_acquire_sqe(&loop_uring->queue, &sqe));
+  const iree_loop_io_params_t* params = &op->params.io;
+  const bool is_read = op->command == IREE_LOOP_COMMAND_READ;
+  sqe->fd = (int)params->file_handle;
+  sqe->off = op->file_offset;
+  iree_byte_span_t* span = &params->spans[op->span_index];
+  if (op->span_offset) {
+    // Resuming a partial transfer of a span; transfer the rest of it alone.
+    sqe->opcode = is_read ? IORING_OP_READ : IORING_OP_WRITE;
+    sqe->addr = (uint64_t)(uintptr_t)(span->data + op->span_offset);
+    sqe->len = (uint32_t)iree_min(span->data_length - op->span_offset,
+                                  (iree_host_size_t)UINT32_MAX);
+  } else {
+    sqe->opcode = is_read ? IORING_OP_READV : IORING_OP_WRITEV;
+    sqe->addr = (uint64_t)(uintptr_t)span;
+    sqe->len = (uint32_t)iree_min(params->span_count - op->span_index,
+                                  IREE_LOOP_URING_MAX_IOV_COUNT);
+  }
+  sqe->user_data = iree_loop_uring_make_user_data(
+      iree_loop_uring_op_index(loop_uring, op), IREE_LOOP_URING_SQE_KIND_IO);
+  ++op->inflight_count;
+  return iree_ok_status();
+}
+
+// Skips empty spans so that each submission makes progress.
+// Returns true if the transfer has completed.
+static bool iree_loop_uring_io_skip_empty(iree_loop_uring_op_t* op) {
+  const iree_loop_io_params_t* params = &op->params.io;
+  while (op->span_index < params->span_count &&
+         op->span_offset == params->spans[op->span_index].data_length) {
+    ++op->span_index;
+    op->span_offset = 0;
+  }
+  return op->span_index == params->span_count;
+}
+
+static iree_status_t iree_loop_uring_enqueue_io(
+    iree_loop_uring_t* loop_uring, iree_loop_uring_scope_t* scope,
+    iree_loop_command_t command, const iree_loop_io_params_t* params) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+  iree_loop_uring_op_t* op = NULL;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_loop_uring_acquire_op(loop_uring, scope, command, &op));
+  op->params.io = *params;
+  op->file_offset = params->file_offset;
+
+  iree_status_t status = iree_ok_status();
+  if (iree_loop_uring_io_skip_empty(op)) {
+    // Nothing to transfer.
+    iree_loop_uring_discard_op(loop_uring, op);
+    status = iree_loop_uring_enqueue_resolved(loop_uring, scope,
+                                              params->callback,
+                                              iree_ok_status());
+    IREE_TRACE_ZONE_END(z0);
+    return status;
+  }
+
+  status = iree_loop_uring_submit_io(loop_uring, op);
+  if (iree_status_is_ok(status)) {
+    ++loop_uring->active_count;
+    ++scope->pending_count;
+  } else {
+    iree_loop_uring_discard_op(loop_uring, op);
+  }
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+// Advances the I/O |op| by the |result| of its last submission and either
+// resubmits the remainder or completes the op.
+static iree_status_t iree_loop_uring_handle_io(iree_loop_uring_t* loop_uring,
+                                               iree_loop_uring_op_t* op,
+                                               int32_t result) {
+  if (result == -EINTR || result == -EAGAIN) {
+    // Retry from the same position.
+  } else if (result < 0) {
+    return iree_loop_uring_complete_op(
+        loop_uring, op,
+        iree_make_status(iree_status_code_from_errno(-result),
+                         "file %s failed (%d)",
+                         op->command == IREE_LOOP_COMMAND_READ ? "read"
+                                                               : "write",
+                         -result));
+  } else if (result == 0) {
+    return iree_loop_uring_complete_op(
+        loop_uring, op,
+        iree_make_status(IREE_STATUS_OUT_OF_RANGE,
+                         "end of file reached at offset %" PRIu64,
+                         op->file_offset));
+  } else {
+    // Advance the cursor through the spans covered by the transfer.
+    const iree_loop_io_params_t* params = &op->params.io;
+    iree_host_size_t remaining = (iree_host_size_t)result;
+    op->file_offset += remaining;
+    while (remaining) {
+      iree_host_size_t span_remaining =
+          params->spans[op->span_index].data_length - op->span_offset;
+      iree_host_size_t advance = iree_min(remaining, span_remaining);
+      op->span_offset += advance;
+      remaining -= advance;
+      if (op->span_offset == params->spans[op->span_index].data_length) {
+        ++op->span_index;
+        op->span_offset = 0;
+      }
+    }
+    if (iree_loop_uring_io_skip_empty(op)) {
+      return iree_loop_uring_complete_op(loop_uring, op, iree_ok_status());
+    }
+  }
+  iree_status_t status = iree_loop_uring_submit_io(loop_uring, op);
+  if (!iree_status_is_ok(status)) {
+    return iree_loop_uring_complete_op(loop_uring, op, status);
+  }
+  return iree_ok_status();
+}
+
+// Routes a single completion to its op.
+static iree_status_t iree_loop_uring_handle_cqe(iree_loop_uring_t* loop_uring,
+                                                uint64_t user_data,
+                                                int32_t result) {
+  if (user_data == IREE_LOOP_URING_USER_DATA_IGNORE) return iree_ok_status();
+  iree_loop_uring_op_t* op = &loop_uring->ops[user_data >> 8];
+  iree_loop_uring_sqe_kind_t kind =
+      (iree_loop_uring_sqe_kind_t)(user_data & 0xFF);
+  --op->inflight_count;
+  switch (kind) {
+    case IREE_LOOP_URING_SQE_KIND_POLL:
+      --op->poll_count;
+      break;
+    case IREE_LOOP_URING_SQE_KIND_TIMEOUT:
+      op->has_timeout = false;
+      break;
+    default:
+      break;
+  }
+  if (op->retired || op->aborting) {
+    // Completion of a cancelled submission; just wait for the rest.
+    iree_loop_uring_maybe_release_op(loop_uring, op);
+    return iree_ok_status();
+  }
+
+  switch (kind) {
+    case IREE_LOOP_URING_SQE_KIND_POLL:
+      if (result < 0) {
+        return iree_loop_uring_complete_op(
+            loop_uring, op,
+            iree_make_status(iree_status_code_from_errno(-result),
+                             "wait handle poll failed (%d)", -result));
+      } else if (result & (POLLERR | POLLNVAL)) {
+        return iree_loop_uring_complete_op(
+            loop_uring, op,
+            iree_make_status(IREE_STATUS_INTERNAL,
+                             "wait handle poll error (0x%X)", result));
+      } else if (--op->unresolved_count == 0) {
+        return iree_loop_uring_complete_op(loop_uring, op, iree_ok_status());
+      }
+      return iree_ok_status();
+    case IREE_LOOP_URING_SQE_KIND_TIMEOUT:
+      if (result != -ETIME && result < 0) {
+        return iree_loop_uring_complete_op(
+            loop_uring, op,
+            iree_make_status(iree_status_code_from_errno(-result),
+                             "timeout failed (%d)", -result));
+      }
+      return iree_loop_uring_complete_op(
+          loop_uring, op,
+          op->command == IREE_LOOP_COMMAND_WAIT_UNTIL
+              ? iree_ok_status()
+              : iree_status_from_code(IREE_STATUS_DEADLINE_EXCEEDED));
+    case IREE_LOOP_URING_SQE_KIND_IO:
+      return iree_loop_uring_handle_io(loop_uring, op, result);
+    default:
+      IREE_ASSERT_UNREACHABLE("unhandled submission kind");
+      return iree_ok_status();
+  }
+}
+
+static iree_host_size_t iree_loop_uring_reap(iree_loop_uring_t* loop_uring) {
+  iree_loop_uring_queue_t* queue = &loop_uring->queue;
+  iree_host_size_t reaped_count = 0;
+  uint32_t head = *queue->cq_khead;
+  uint32_t tail = __atomic_load_n(queue->cq_ktail, __ATOMIC_ACQUIRE);
+  while (head != tail) {
+    const struct io_uring_cqe* cqe = &queue->cqes[head & queue->cq_mask];
+    uint64_t user_data = cqe->user_data;
+    int32_t result = cqe->res;
+    // Release the entry before handling it so that the kernel can reuse it.
+    __atomic_store_n(queue->cq_khead, ++head, __ATOMIC_RELEASE);
+    ++reaped_count;
+    iree_status_t status =
+        iree_loop_uring_handle_cqe(loop_uring, user_data, result);
+    if (!iree_status_is_ok(status)) {
+      // Failed to schedule a callback (run ring full). We can't propagate the
+      // error to the op scope as it has already retired.
+      // TODO(#4026): propagate failure to all scopes involved.
+      IREE_ASSERT_TRUE(iree_status_is_ok(status));
+      iree_status_ignore(status);
+    }
+    tail = __atomic_load_n(queue->cq_ktail, __ATOMIC_ACQUIRE);
+  }
+  IREE_TRACE_PLOT_VALUE_I64("iree_loop_pending_count",
+                            loop_uring->active_count);
+  return reaped_count;
+}
+
+// Aborts all operations in the loop attributed to |scope|.
+// A NULL |scope| indicates all work from all scopes should be aborted.
+static void iree_loop_uring_abort_scope(iree_loop_uring_t* loop_uring,
+                                        iree_loop_uring_scope_t* scope) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  // Cancel all pending ops in the scope in the kernel.
+  bool any_aborted = false;
+  for (uint32_t i = 0; i < loop_uring->op_capacity; ++i) {
+    iree_loop_uring_op_t* op = &loop_uring->ops[i];
+    if (!op->scope || op->retired || op->aborting) continue;
+    if (scope && op->scope != scope) continue;
+    iree_loop_uring_cancel_op(loop_uring, op);
+    op->aborting = true;
+    any_aborted = true;
+  }
+
+  if (any_aborted) {
+    // Wait for the kernel to release any buffers the callbacks may free.
+    iree_loop_uring_flush_aborted_io(loop_uring);
+
+    // Issue the completion callback of each op to notify it of the abort.
+    // To prevent enqueuing more work while aborting we pass in a NULL loop.
+    // We can't do anything with the errors so we ignore them.
+    for (uint32_t i = 0; i < loop_uring->op_capacity; ++i) {
+      iree_loop_uring_op_t* op = &loop_uring->ops[i];
+      if (!op->aborting) continue;
+      op->aborting = false;
+      op->retired = true;
+      --loop_uring->active_count;
+      --op->scope->pending_count;
+      iree_loop_callback_t callback = op->callback;
+      iree_loop_uring_maybe_release_op(loop_uring, op);
+      iree_status_ignore(callback.fn(callback.user_data, iree_loop_null(),
+                                     iree_make_status(IREE_STATUS_ABORTED)));
+    }
+  }
+
+  if (loop_uring->run_ring) {
+    iree_loop_uring_run_ring_abort_scope(loop_uring->run_ring, scope);
+  }
+
+  IREE_TRACE_ZONE_END(z0);
+}
+
+// Emits |status| to the given |loop| scope and aborts associated operations.
+static void iree_loop_uring_emit_error(iree_loop_t loop, iree_status_t status) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_TEXT(
+      z0, iree_status_code_string(iree_status_code(status)));
+
+  iree_loop_uring_scope_t* scope = (iree_loop_uring_scope_t*)loop.self;
+  iree_loop_uring_t* loop_uring = scope->loop_uring;
+
+  if (scope->error_fn) {
+    scope->error_fn(scope->error_user_data, status);
+  } else {
+    iree_status_ignore(status);
+  }
+
+  iree_loop_uring_abort_scope(loop_uring, scope);
+
+  IREE_TRACE_ZONE_END(z0);
+}
+
+static void iree_loop_uring_run_call(iree_loop_t loop,
+                                     const iree_loop_call_params_t params,
+                                     iree_status_t op_status) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+  iree_status_t status =
+      params.callback.fn(params.callback.user_data, loop, op_status);
+  if (!iree_status_is_ok(status)) {
+    iree_loop_uring_emit_error(loop, status);
+  }
+  IREE_TRACE_ZONE_END(z0);
+}
+
+static void iree_loop_uring_run_dispatch(
+    iree_loop_t loop, const iree_loop_dispatch_params_t params) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  // We run all workgroups before issuing the completion callback.
+  // If any workgroup fails we exit early and pass the failing status back to
+  // the completion handler exactly once.
+  uint32_t workgroup_count_x = params.workgroup_count_xyz[0];
+  uint32_t workgroup_count_y = params.workgroup_count_xyz[1];
+  uint32_t workgroup_count_z = params.workgroup_count_xyz[2];
+  iree_status_t workgroup_status = iree_ok_status();
+  for (uint32_t z = 0; z < workgroup_count_z; ++z) {
+    for (uint32_t y = 0; y < workgroup_count_y; ++y) {
+      for (uint32_t x = 0; x < workgroup_count_x; ++x) {
+        workgroup_status =
+            params.workgroup_fn(params.callback.user_data, loop, x, y, z);
+        if (!iree_status_is_ok(workgroup_status)) goto workgroup_failed;
+      }
+    }
+  }
+workgroup_failed:;
+
+  // Fire the completion callback with either success or the first error hit by
+  // a workgroup.
+  iree_status_t status =
+      params.callback.fn(params.callback.user_data, loop, workgroup_status);
+  if (!iree_status_is_ok(status)) {
+    iree_loop_uring_emit_error(loop, status);
+  }
+
+  IREE_TRACE_ZONE_END(z0);
+}
+
+// Drains work from the loop until all work in |scope| has completed.
+// A NULL |scope| indicates all work from all scopes should be drained.
+static iree_status_t iree_loop_uring_drain_scope(
+    iree_loop_uring_t* loop_uring, iree_loop_uring_scope_t* scope,
+    iree_time_t deadline_ns) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  iree_status_t status = iree_ok_status();
+  do {
+    // If we are draining a particular scope we can bail whenever there's no
+    // more work remaining.
+    if (scope && !scope->pending_count) break;
+
+    // Run an op from the runnable queue.
+    // We only want to run one op at a time before checking our deadline so that
+    // we don't get into infinite loops or exceed the deadline (too much).
+    iree_loop_uring_run_op_t run_op;
+    if (iree_loop_uring_run_ring_dequeue(loop_uring->run_ring, &run_op)) {
+      iree_loop_t loop = {
+          .self = run_op.scope,
+          .ctl = iree_loop_uring_ctl,
+      };
+      switch (run_op.command) {
+        case IREE_LOOP_COMMAND_CALL:
+          iree_loop_uring_run_call(loop, run_op.params.call, run_op.status);
+          break;
+        case IREE_LOOP_COMMAND_DISPATCH:
+          iree_loop_uring_run_dispatch(loop, run_op.params.dispatch);
+          break;
+      }
+      continue;  // loop back around only if under the deadline
+    }
+
+    // -- if here then the run ring is currently empty --
+
+    // Route any completions the kernel has already posted to the run ring.
+    if (iree_loop_uring_reap(loop_uring) > 0) continue;
+
+    // If there are no pending ops then the drain has completed.
+    if (!loop_uring->active_count) break;
+
+    // Flush submissions and block in the kernel until something completes.
+    IREE_TRACE_ZONE_BEGIN_NAMED(z1, "iree_loop_uring_wait");
+    status = iree_loop_uring_queue_enter(&loop_uring->queue,
+                                         /*min_complete=*/1, deadline_ns);
+    IREE_TRACE_ZONE_END(z1);
+    if (!iree_status_is_ok(status)) break;
+  } while (iree_time_now() < deadline_ns);
+
+  if (iree_status_is_ok(status) &&
+      (scope ? scope->pending_count != 0
+             : (loop_uring->active_count != 0 ||
+                !iree_loop_uring_run_ring_is_empty(loop_uring->run_ring)))) {
+    status = iree_status_from_code(IREE_STATUS_DEADLINE_EXCEEDED);
+  }
+
+  // Ensure submissions made by callbacks reach the kernel even if the caller
+  // does not drain again for a while.
+  if (iree_status_is_ok(status) || iree_status_is_deadline_exceeded(status)) {
+    iree_status_t flush_status = iree_loop_uring_queue_enter(
+        &loop_uring->queue, /*min_complete=*/0, IREE_TIME_INFINITE_PAST);
+    if (!iree_status_is_ok(flush_status)) {
+      iree_status_ignore(status);
+      status = flush_status;
+    }
+  }
+
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+IREE_API_EXPORT iree_status_t iree_loop_uring_wait_idle(
+    iree_loop_uring_t* loop_uring, iree_timeout_t timeout) {
+  IREE_ASSERT_ARGUMENT(loop_uring);
+  IREE_TRACE_ZONE_BEGIN(z0);
+  iree_time_t deadline_ns = iree_timeout_as_deadline_ns(timeout);
+  iree_status_t status =
+      iree_loop_uring_drain_scope(loop_uring, /*scope=*/NULL, deadline_ns);
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+// Control function for the io_uring loop.
+// |self| must be an iree_loop_uring_scope_t.
+IREE_API_EXPORT iree_status_t iree_loop_uring_ctl(void* self,
+                                                  iree_loop_command_t command,
+                                                  const void* params,
+                                                  void** inout_ptr) {
+  IREE_ASSERT_ARGUMENT(self);
+  iree_loop_uring_scope_t* scope = (iree_loop_uring_scope_t*)self;
+  iree_loop_uring_t* loop_uring = scope->loop_uring;
+
+  if (IREE_UNLIKELY(!loop_uring->run_ring)) {
+    return iree_make_status(
+        IREE_STATUS_FAILED_PRECONDITION,
+        "new work cannot be enqueued while the loop is shutting down");
+  }
+
+  // NOTE: we return immediately to make this all (hopefully) tail calls.
+  switch (command) {
+    case IREE_LOOP_COMMAND_CALL:
+      return iree_loop_uring_run_ring_enqueue(
+          loop_uring->run_ring,
+          (iree_loop_uring_run_op_t){
+              .command = command,
+              .scope = scope,
+              .params =
+                  {
+                      .call = *(const iree_loop_call_params_t*)params,
+                  },
+          });
+    case IREE_LOOP_COMMAND_DISPATCH:
+      return iree_loop_uring_run_ring_enqueue(
+          loop_uring->run_ring,
+          (iree_loop_uring_run_op_t){
+              .command = command,
+              .scope = scope,
+              .params =
+                  {
+                      .dispatch = *(const iree_loop_dispatch_params_t*)params,
+                  },
+          });
+    case IREE_LOOP_COMMAND_WAIT_UNTIL:
+      return iree_loop_uring_enqueue_wait_until(
+          loop_uring, scope, (const iree_loop_wait_until_params_t*)params);
+    case IREE_LOOP_COMMAND_WAIT_ONE: {
+      // The wait source is copied into the op by the enqueue; query a copy.
+      iree_loop_wait_one_params_t wait_one =
+          *(const iree_loop_wait_one_params_t*)params;
+      return iree_loop_uring_enqueue_wait(
+          loop_uring, scope, command, wait_one.callback, wait_one.deadline_ns,
+          1, &wait_one.wait_source, &wait_one);
+    }
+    case IREE_LOOP_COMMAND_WAIT_ALL:
+    case IREE_LOOP_COMMAND_WAIT_ANY: {
+      const iree_loop_wait_multi_params_t* wait_multi =
+          (const iree_loop_wait_multi_params_t*)params;
+      return iree_loop_uring_enqueue_wait(
+          loop_uring, scope, command, wait_multi->callback,
+          wait_multi->deadline_ns, wait_multi->count, wait_multi->wait_sources,
+          wait_multi);
+    }
+    case IREE_LOOP_COMMAND_READ:
+    case IREE_LOOP_COMMAND_WRITE:
+      return iree_loop_uring_enqueue_io(loop_uring, scope, command,
+                                        (const iree_loop_io_params_t*)params);
+    case IREE_LOOP_COMMAND_DRAIN:
+      return iree_loop_uring_drain_scope(
+          loop_uring, scope,
+          ((const iree_loop_drain_params_t*)params)->deadline_ns);
+    default:
+      return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
+                              "unimplemented loop command");
+  }
+}
+
+#else
+
+//===----------------------------------------------------------------------===//
+// Unsupported platforms
+//===----------------------------------------------------------------------===//
+
+typedef struct iree_loop_uring_t {
+  int reserved;
+} iree_loop_uring_t;
+
+IREE_API_EXPORT iree_status_t iree_loop_uring_allocate(
+    iree_loop_uring_options_t options, iree_allocator_t allocator,
+    iree_loop_uring_t** out_loop_uring) {
+  IREE_ASSERT_ARGUMENT(out_loop_uring);
+  *out_loop_uring = NULL;
+  return iree_make_status(IREE_STATUS_UNAVAILABLE,
+                          "io_uring is only available on Linux");
+}
+
+IREE_API_EXPORT void iree_loop_uring_free(iree_loop_uring_t* loop_uring) {}
+
+IREE_API_EXPORT iree_status_t iree_loop_uring_wait_idle(
+    iree_loop_uring_t* loop_uring, iree_timeout_t timeout) {
+  return iree_make_status(IREE_STATUS_UNAVAILABLE,
+                          "io_uring is only available on Linux");
+}
+
+IREE_API_EXPORT void iree_loop_uring_scope_initialize(
+    iree_loop_uring_t* loop_uring, iree_loop_uring_error_fn_t error_fn,
+    void* error_user_data, iree_loop_uring_scope_t* out_scope) {
+  memset(out_scope, 0, sizeof(*out_scope));
+  out_scope->loop_uring = loop_uring;
+  out_scope->error_fn = error_fn;
+  out_scope->error_user_data = error_user_data;
+}
+
+IREE_API_EXPORT void iree_loop_uring_scope_deinitialize(
+    iree_loop_uring_scope_t* scope) {}
+
+IREE_API_EXPORT iree_status_t iree_loop_uring_ctl(void* self,
+                                                  iree_loop_command_t command,
+                                                  const void* params,
+                                                  void** inout_ptr) {
+  return iree_make_status(IREE_STATUS_UNAVAILABLE,
+                          "io_uring is only available on Linux");
+}
+
+#endif  // IREE_HAVE_LOOP_URING
@@ -0,0 +1,127 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_BASE_LOOP_URING_H_
+#define IREE_BASE_LOOP_URING_H_
+
+#include "iree/base/api.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+//===----------------------------------------------------------------------===//
+// iree_loop_uring_t
+//===----------------------------------------------------------------------===//
+
+// Configuration options for the io_uring loop implementation.
+typedef struct iree_loop_uring_options_t {
+  // Specifies the maximum operation queue depth in number of operations.
+  // Growth is not currently supported and if the capacity is reached during
+  // execution then IREE_STATUS_RESOURCE_EXHAUSTED will be returned when new
+  // operations are enqueued.
+  iree_host_size_t max_queue_depth;
+
+  // Specifies how many waits and file I/O operations are allowed to be pending
+  // in the kernel at the same time. Growth is not currently supported and if
+  // the capacity is reached during execution then
+  // IREE_STATUS_RESOURCE_EXHAUSTED will be returned when new operations are
+  // enqueued.
+  iree_host_size_t max_pending_count;
+
+  // Number of io_uring submission queue entries (rounded up to a power of
+  // two). Submissions beyond this are flushed to the kernel early. 0 selects a
+  // default based on |max_pending_count|.
+  iree_host_size_t submission_queue_depth;
+} iree_loop_uring_options_t;
+
+// A loop backed by a Linux io_uring instance.
+// Waits on system wait handles are submitted as kernel polls, wait-until
+// operations as kernel timeouts, and reads/writes as vectored file I/O. A
+// single thread draining the loop can service many devices, semaphores, and
+// file transfers with one syscall per batch of submissions and completions.
+//
+// Wait sources that are not system wait handles are exported to one prior to
+// being submitted in the same way as iree_loop_sync_t.
+//
+// Only available on Linux 5.11+. iree_loop_uring_allocate returns
+// IREE_STATUS_UNAVAILABLE on other platforms or if io_uring is unsupported or
+// disabled by the kernel.
+//
+// Thread-compatible: the loop only performs work when iree_loop_drain is
+// called and must not be used from multiple threads concurrently.
+typedef struct iree_loop_uring_t iree_loop_uring_t;
+
+// Allocates an io_uring loop using |allocator| stored into |out_loop_uring|.
+IREE_API_EXPORT iree_status_t iree_loop_uring_allocate(
+    iree_loop_uring_options_t options, iree_allocator_t allocator,
+    iree_loop_uring_t** out_loop_uring);
+
+// Frees an io_uring |loop_uring|, aborting all pending operations.
+// Blocks until the kernel has released any buffers referenced by pending file
+// I/O operations.
+IREE_API_EXPORT void iree_loop_uring_free(iree_loop_uring_t* loop_uring);
+
+// Waits until the loop is idle (all operations in all scopes have retired).
+// Returns IREE_STATUS_DEADLINE_EXCEEDED if |timeout| is reached before the
+// loop is idle.
+IREE_API_EXPORT iree_status_t iree_loop_uring_wait_idle(
+    iree_loop_uring_t* loop_uring, iree_timeout_t timeout);
+
+// Handles scope errors returned from loop callback operations.
+// Ownership of |status| is passed to the handler and must be freed.
+// All operations of the same scope will be aborted.
+typedef void(IREE_API_PTR* iree_loop_uring_error_fn_t)(void* user_data,
+                                                       iree_status_t status);
+
+// A scope of execution within a loop.
+// Each scope has a dedicated error handler that is notified when an error
+// propagates from a loop operation scheduled against the scope. When an error
+// arises all other operations in the same scope will be aborted.
+typedef struct iree_loop_uring_scope_t {
+  // Target loop for execution.
+  iree_loop_uring_t* loop_uring;
+
+  // Total number of pending operations in the scope.
+  // When 0 the scope is considered idle.
+  int32_t pending_count;
+
+  // Optional function used to report errors that occur during execution.
+  iree_loop_uring_error_fn_t error_fn;
+  void* error_user_data;
+} iree_loop_uring_scope_t;
+
+// Initializes a loop scope that runs operations against |loop_uring|.
+IREE_API_EXPORT void iree_loop_uring_scope_initialize(
+    iree_loop_uring_t* loop_uring, iree_loop_uring_error_fn_t error_fn,
+    void* error_user_data, iree_loop_uring_scope_t* out_scope);
+
+// Deinitializes a loop |scope| and aborts any pending operations.
+IREE_API_EXPORT void iree_loop_uring_scope_deinitialize(
+    iree_loop_uring_scope_t* scope);
+
+IREE_API_EXPORT iree_status_t iree_loop_uring_ctl(void* self,
+                                                  iree_loop_command_t command,
+                                                  const void* params,
+                                                  void** inout_ptr);
+
+// Returns a loop that schedules operations against |scope|.
+// The scope must remain valid until all operations scheduled against it have
+// completed.
+static inline iree_loop_t iree_loop_uring_scope(
+    iree_loop_uring_scope_t* scope) {
+  iree_loop_t loop = {
+      scope,
+      iree_loop_uring_ctl,
+  };
+  return loop;
+}
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif  // IREE_BASE_LOOP_URING_H_
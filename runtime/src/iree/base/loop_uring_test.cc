@@ -0,0 +1,175 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/base/loop_uring.h"
+
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <string>
+
+#include "iree/base/api.h"
+#include "iree/testing/gtest.h"
+#include "iree/testing/status_matchers.h"
+
+// Contains the test definitions applied to all loop implementations:
+#include "iree/base/loop_test.h"
+
+void AllocateLoop(iree_status_t* out_status, iree_allocator_t allocator,
+                  iree_loop_t* out_loop) {
+  iree_loop_uring_options_t options = {0};
+  options.max_queue_depth = 128;
+  options.max_pending_count = 32;
+
+  iree_loop_uring_t* loop_uring = NULL;
+  iree_status_t status =
+      iree_loop_uring_allocate(options, allocator, &loop_uring);
+  if (iree_status_is_unavailable(status)) {
+    // io_uring unsupported or disabled in the kernel; tests will be skipped.
+    iree_status_ignore(status);
+    *out_loop = iree_loop_null();
+    return;
+  }
+  IREE_CHECK_OK(status);
+
+  iree_loop_uring_scope_t* scope = NULL;
+  IREE_CHECK_OK(
+      iree_allocator_malloc(allocator, sizeof(*scope), (void**)&scope));
+  iree_loop_uring_scope_initialize(
+      loop_uring,
+      +[](void* user_data, iree_status_t status) {
+        iree_status_t* status_ptr = (iree_status_t*)user_data;
+        if (iree_status_is_ok(*status_ptr)) {
+          *status_ptr = status;
+        } else {
+          iree_status_ignore(status);
+        }
+      },
+      out_status, scope);
+  *out_loop = iree_loop_uring_scope(scope);
+}
+
+void FreeLoop(iree_allocator_t allocator, iree_loop_t loop) {
+  iree_loop_uring_scope_t* scope = (iree_loop_uring_scope_t*)loop.self;
+  iree_loop_uring_t* loop_uring = scope->loop_uring;
+
+  iree_loop_uring_scope_deinitialize(scope);
+  iree_allocator_free(allocator, scope);
+
+  iree_loop_uring_free(loop_uring);
+}
+
+namespace iree {
+namespace testing {
+
+//===----------------------------------------------------------------------===//
+// iree_loop_read / iree_loop_write
+//===----------------------------------------------------------------------===//
+
+// Opens a new unlinked temporary file for read/write.
+static int OpenTempFile() {
+  const char* test_tmpdir = getenv("TEST_TMPDIR");
+  if (!test_tmpdir) test_tmpdir = getenv("TMPDIR");
+  if (!test_tmpdir) test_tmpdir = "/tmp";
+  std::string path = std::string(test_tmpdir) + "/iree_loop_uring_XXXXXX";
+  int fd = mkstemp(&path[0]);
+  if (fd != -1) unlink(path.c_str());
+  return fd;
+}
+
+struct IOUserData {
+  bool did_callback = false;
+  iree_status_code_t status_code = IREE_STATUS_DATA_LOSS;
+};
+
+static iree_status_t RecordIOCallback(void* user_data_ptr, iree_loop_t loop,
+                                      iree_status_t status) {
+  auto* user_data = reinterpret_cast<IOUserData*>(user_data_ptr);
+  user_data->did_callback = true;
+  user_data->status_code = iree_status_code(status);
+  iree_status_ignore(status);
+  return iree_ok_status();
+}
+
+// Tests a gather write followed by a scatter read across span boundaries.
+TEST_F(LoopTest, WriteReadSpans) {
+  IREE_TRACE_SCOPE();
+  int fd = OpenTempFile();
+  ASSERT_NE(fd, -1);
+
+  char write_a[] = "hello ";
+  char write_b[] = "io_uring";
+  iree_byte_span_t write_spans[] = {
+      iree_make_byte_span(write_a, strlen(write_a)),
+      iree_make_byte_span(NULL, 0),
+      iree_make_byte_span(write_b, strlen(write_b)),
+  };
+  IOUserData write_data;
+  IREE_ASSERT_OK(iree_loop_write(loop, fd, /*file_offset=*/4,
+                                 IREE_ARRAYSIZE(write_spans), write_spans,
+                                 RecordIOCallback, &write_data));
+  IREE_ASSERT_OK(iree_loop_drain(loop, iree_infinite_timeout()));
+  IREE_ASSERT_OK(loop_status);
+  EXPECT_TRUE(write_data.did_callback);
+  EXPECT_EQ(write_data.status_code, IREE_STATUS_OK);
+
+  char read_a[3] = {0};
+  char read_b[11] = {0};
+  iree_byte_span_t read_spans[] = {
+      iree_make_byte_span(read_a, sizeof(read_a)),
+      iree_make_byte_span(read_b, sizeof(read_b)),
+  };
+  IOUserData read_data;
+  IREE_ASSERT_OK(iree_loop_read(loop, fd, /*file_offset=*/4,
+                                IREE_ARRAYSIZE(read_spans), read_spans,
+                                RecordIOCallback, &read_data));
+  IREE_ASSERT_OK(iree_loop_drain(loop, iree_infinite_timeout()));
+  IREE_ASSERT_OK(loop_status);
+  EXPECT_TRUE(read_data.did_callback);
+  EXPECT_EQ(read_data.status_code, IREE_STATUS_OK);
+  EXPECT_EQ(std::string(read_a, sizeof(read_a)), "hel");
+  EXPECT_EQ(std::string(read_b, sizeof(read_b)), "lo io_uring");
+
+  close(fd);
+}
+
+// Tests that reading past the end of the file fails the read.
+TEST_F(LoopTest, ReadPastEnd) {
+  IREE_TRACE_SCOPE();
+  int fd = OpenTempFile();
+  ASSERT_NE(fd, -1);
+  ASSERT_EQ(write(fd, "abc", 3), 3);
+
+  char buffer[8] = {0};
+  iree_byte_span_t span = iree_make_byte_span(buffer, sizeof(buffer));
+  IOUserData read_data;
+  IREE_ASSERT_OK(iree_loop_read(loop, fd, /*file_offset=*/0, 1, &span,
+                                RecordIOCallback, &read_data));
+  IREE_ASSERT_OK(iree_loop_drain(loop, iree_infinite_timeout()));
+  IREE_ASSERT_OK(loop_status);
+  EXPECT_TRUE(read_data.did_callback);
+  EXPECT_EQ(read_data.status_code, IREE_STATUS_OUT_OF_RANGE);
+  EXPECT_EQ(std::string(buffer, 3), "abc");
+
+  close(fd);
+}
+
+// Tests that a read of an invalid file handle reports the failure.
+TEST_F(LoopTest, ReadInvalidFile) {
+  IREE_TRACE_SCOPE();
+  char buffer[8] = {0};
+  iree_byte_span_t span = iree_make_byte_span(buffer, sizeof(buffer));
+  IOUserData read_data;
+  IREE_ASSERT_OK(iree_loop_read(loop, /*file_handle=*/-1, /*file_offset=*/0, 1,
+                                &span, RecordIOCallback, &read_data));
+  IREE_ASSERT_OK(iree_loop_drain(loop, iree_infinite_timeout()));
+  IREE_ASSERT_OK(loop_status);
+  EXPECT_TRUE(read_data.did_callback);
+  EXPECT_NE(read_data.status_code, IREE_STATUS_OK);
+}
+
+}  // namespace testing
+}  // namespace iree
@@ -0,0 +1,871 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include <errno.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include "iree/base/alignment.h"
+#include "iree/base/internal/atomics.h"
+#include "iree/base/tracing.h"
+
+#if defined(IREE_PLATFORM_WINDOWS)
+#include <fcntl.h>
+#include <io.h>
+#include <process.h>
+#define iree_process_id() ((uint64_t)_getpid())
+#define iree_file_open_for_write(path) \
+  _open((path), _O_WRONLY | _O_CREAT | _O_TRUNC | _O_BINARY, 0644)
+#define iree_file_write(fd, data, length) \
+  _write((fd), (data), (unsigned int)(length))
+#define iree_file_close(fd) _close(fd)
+#else
+#include <fcntl.h>
+#include <signal.h>
+#include <unistd.h>
+#define iree_process_id() ((uint64_t)getpid())
+#define iree_file_open_for_write(path) \
+  open((path), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644)
+#define iree_file_write(fd, data, length) write((fd), (data), (length))
+#define iree_file_close(fd) close(fd)
+#define IREE_TRACING_RINGBUFFER_HAVE_SIGNALS 1
+#endif  // IREE_PLATFORM_WINDOWS
+
+#if defined(IREE_ARCH_X86_64) && defined(IREE_COMPILER_MSVC)
+#include <intrin.h>
+#elif defined(IREE_ARCH_X86_64) && defined(IREE_COMPILER_GCC_COMPAT)
+#include <x86intrin.h>
+#endif  // IREE_ARCH_X86_64
+
+// NOTE: threading support is optional.
+#if IREE_SYNCHRONIZATION_DISABLE_UNSAFE
+
+#define iree_thread_local static
+#define iree_thread_id() 0
+
+#else
+
+#if defined(__STDC_VERSION__) && (__STDC_VERSION__ >= 201102L) && \
+    !__STDC_NO_THREADS__
+#define iree_thread_local _Thread_local
+#elif defined(IREE_COMPILER_MSVC)
+#define iree_thread_local __declspec(thread)
+#else
+#define iree_thread_local
+#endif  // __STDC_NO_THREADS__
+
+#if defined(IREE_PLATFORM_ANDROID)
+#include <unistd.h>
+#define iree_thread_id() ((uint64_t)gettid())
+#elif defined(IREE_PLATFORM_APPLE)
+#include <pthread.h>
+#define iree_thread_id() ((uint64_t)pthread_mach_thread_np(pthread_self()))
+#elif defined(IREE_PLATFORM_LINUX)
+#include <sys/syscall.h>
+#include <unistd.h>
+#define iree_thread_id() ((uint64_t)syscall(__NR_gettid))
+#elif defined(IREE_PLATFORM_WINDOWS)
+#define iree_thread_id() ((uint64_t)GetCurrentThreadId())
+#else
+#define iree_thread_id() 0
+#endif  // IREE_PLATFORM_*
+
+#endif  // IREE_SYNCHRONIZATION_DISABLE_UNSAFE
+
+#if IREE_TRACING_FEATURES
+
+//===----------------------------------------------------------------------===//
+// Timestamps
+//===----------------------------------------------------------------------===//
+
+// Returns a monotonic time in nanoseconds. The clock is read directly instead
+// of with iree_time_now as providers are linked into iree/base and must not
+// depend on it. Both clocks are async-signal-safe.
+static uint64_t iree_tracing_ringbuffer_time_ns(void) {
+#if defined(IREE_PLATFORM_WINDOWS)
+  static LARGE_INTEGER frequency = {0};
+  if (!frequency.QuadPart) QueryPerformanceFrequency(&frequency);
+  LARGE_INTEGER counter;
+  QueryPerformanceCounter(&counter);
+  return (uint64_t)((double)counter.QuadPart * 1e9 /
+                    (double)frequency.QuadPart);
+#else
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+#endif  // IREE_PLATFORM_WINDOWS
+}
+
+// Returns a raw timestamp counter value. Counters are only converted to
+// nanoseconds when the buffers are dumped so that recording avoids the vDSO
+// call (or worse, syscall) and the math.
+static inline uint64_t iree_tracing_ringbuffer_timestamp(void) {
+#if defined(IREE_ARCH_X86_64) && \
+    (defined(IREE_COMPILER_MSVC) || defined(IREE_COMPILER_GCC_COMPAT))
+  return __rdtsc();
+#elif defined(IREE_ARCH_ARM_64) && defined(IREE_COMPILER_GCC_COMPAT)
+  uint64_t value;
+  __asm__ volatile("mrs %0, cntvct_el0" : "=r"(value));
+  return value;
+#else
+  return iree_tracing_ringbuffer_time_ns();
+#endif  // IREE_ARCH_*
+}
+
+//===----------------------------------------------------------------------===//
+// Per-thread event ring buffers
+//===----------------------------------------------------------------------===//
+
+#define IREE_TRACING_RINGBUFFER_CAPACITY_MASK \
+  ((int64_t)IREE_TRACING_RINGBUFFER_CAPACITY - 1)
+#if (IREE_TRACING_RINGBUFFER_CAPACITY & \
+     (IREE_TRACING_RINGBUFFER_CAPACITY - 1)) != 0
+#error "IREE_TRACING_RINGBUFFER_CAPACITY must be a power of two"
+#endif  // IREE_TRACING_RINGBUFFER_CAPACITY
+
+// Maximum length of dynamic strings (zone names, messages) copied into events.
+// Longer strings are truncated.
+#define IREE_TRACING_RINGBUFFER_TEXT_CAPACITY 32
+
+// Maximum length of a thread name including the NUL terminator.
+#define IREE_TRACING_RINGBUFFER_THREAD_NAME_CAPACITY 32
+
+typedef enum iree_tracing_ringbuffer_event_type_e {
+  // |ptr| is an iree_tracing_location_t.
+  IREE_TRACING_RINGBUFFER_EVENT_ZONE_BEGIN = 0,
+  // |ptr| is an iree_tracing_location_t and |text| contains the zone name.
+  IREE_TRACING_RINGBUFFER_EVENT_ZONE_BEGIN_DYNAMIC,
+  // |text| contains the zone name and |value.i64| the source line.
+  IREE_TRACING_RINGBUFFER_EVENT_ZONE_BEGIN_EXTERNAL,
+  IREE_TRACING_RINGBUFFER_EVENT_ZONE_END,
+  // |ptr| is the plot name literal and |value| the plotted value.
+  IREE_TRACING_RINGBUFFER_EVENT_PLOT_I64,
+  IREE_TRACING_RINGBUFFER_EVENT_PLOT_F64,
+  // |ptr| is the frame name literal or NULL for the default frame.
+  IREE_TRACING_RINGBUFFER_EVENT_FRAME_MARK,
+  // |ptr| is the message literal.
+  IREE_TRACING_RINGBUFFER_EVENT_MESSAGE_LITERAL,
+  // |text| contains the message.
+  IREE_TRACING_RINGBUFFER_EVENT_MESSAGE_DYNAMIC,
+} iree_tracing_ringbuffer_event_type_t;
+
+// A single recorded event sized to fill one cache line on 64-bit systems.
+typedef struct iree_tracing_ringbuffer_event_t {
+  // Raw timestamp counter value as returned by
+  // iree_tracing_ringbuffer_timestamp.
+  uint64_t timestamp;
+  // iree_tracing_ringbuffer_event_type_t.
+  uint8_t type;
+  // Length of |text| in characters.
+  uint8_t text_length;
+  uint16_t reserved;
+  // Message color.
+  uint32_t color;
+  // Event type-specific pointer to a string literal or static location.
+  const void* ptr;
+  union {
+    int64_t i64;
+    double f64;
+  } value;
+  // Event type-specific copied string data. Not NUL terminated.
+  char text[IREE_TRACING_RINGBUFFER_TEXT_CAPACITY];
+} iree_tracing_ringbuffer_event_t;
+
+// Ring buffer owned by a single thread. Only the owning thread writes events
+// and the dump reads them concurrently.
+typedef struct iree_tracing_ringbuffer_thread_t {
+  // Next thread in the global thread list.
+  struct iree_tracing_ringbuffer_thread_t* next;
+  // Platform thread ID used as the Chrome trace tid.
+  uint64_t thread_id;
+  // Thread name as set by iree_tracing_set_thread_name. Not synchronized with
+  // the dump; a name changing during a dump may be torn.
+  char name[IREE_TRACING_RINGBUFFER_THREAD_NAME_CAPACITY];
+  // Total number of events written to the thread. The event with index i is
+  // stored in events[i & IREE_TRACING_RINGBUFFER_CAPACITY_MASK] and once
+  // published with a release store is immutable until index
+  // i + IREE_TRACING_RINGBUFFER_CAPACITY begins being written.
+  iree_atomic_int64_t write_index;
+  iree_tracing_ringbuffer_event_t events[IREE_TRACING_RINGBUFFER_CAPACITY];
+} iree_tracing_ringbuffer_thread_t;
+
+typedef struct iree_tracing_ringbuffer_t {
+  // iree_tracing_ringbuffer_thread_t* list head of all threads that have
+  // recorded an event. Threads are only ever added.
+  iree_atomic_intptr_t thread_head;
+  // 0 = uninitialized, 1 = initializing, 2 = initialized.
+  iree_atomic_int32_t init_state;
+  // 1 while a dump is in progress.
+  iree_atomic_int32_t dumping;
+  // Timestamp counter and monotonic time captured during initialization used
+  // to convert counters to nanoseconds.
+  uint64_t base_timestamp;
+  uint64_t base_time_ns;
+  // Path the signal handler and IREE_TRACING_RINGBUFFER_DUMP_ON_EXIT dump to.
+  // Resolved ahead of time as getenv is not async-signal-safe.
+  char dump_path[256];
+} iree_tracing_ringbuffer_t;
+
+// Global shared ringbuffer tracing context.
+// Thread buffers are retained for the lifetime of the process such that the
+// activity of threads that have since exited is still available when dumping.
+static iree_tracing_ringbuffer_t _ringbuffer = {0};
+
+// Buffer used by threads that have failed to allocate their own. Events written
+// to it are never dumped (and may be written to by multiple threads at once).
+static iree_tracing_ringbuffer_thread_t _ringbuffer_overflow_thread;
+
+static iree_thread_local iree_tracing_ringbuffer_thread_t* _thread = NULL;
+
+#if IREE_TRACING_RINGBUFFER_HAVE_SIGNALS && IREE_TRACING_RINGBUFFER_SIGNAL
+static void iree_tracing_ringbuffer_signal_handler(int signal_number) {
+  int saved_errno = errno;
+  iree_tracing_ringbuffer_dump(_ringbuffer.dump_path);
+  errno = saved_errno;
+}
+#endif  // IREE_TRACING_RINGBUFFER_HAVE_SIGNALS
+
+void iree_tracing_ringbuffer_initialize() {
+  int32_t expected = 0;
+  if (!iree_atomic_compare_exchange_strong_int32(
+          &_ringbuffer.init_state, &expected, 1, iree_memory_order_acq_rel,
+          iree_memory_order_acquire)) {
+    // Already initialized or another thread is initializing. Events recorded
+    // in the interim will have timestamps slightly before the base.
+    return;
+  }
+
+  _ringbuffer.base_time_ns = iree_tracing_ringbuffer_time_ns();
+  _ringbuffer.base_timestamp = iree_tracing_ringbuffer_timestamp();
+
+  const char* dump_path = getenv("IREE_TRACING_RINGBUFFER_PATH");
+  if (dump_path && dump_path[0]) {
+    snprintf(_ringbuffer.dump_path, sizeof(_ringbuffer.dump_path), "%s",
+             dump_path);
+  } else {
+    snprintf(_ringbuffer.dump_path, sizeof(_ringbuffer.dump_path),
+             "iree-trace-%" PRIu64 ".json", iree_process_id());
+  }
+
+#if IREE_TRACING_RINGBUFFER_HAVE_SIGNALS && IREE_TRACING_RINGBUFFER_SIGNAL
+  struct sigaction action;
+  memset(&action, 0, sizeof(action));
+  action.sa_handler = iree_tracing_ringbuffer_signal_handler;
+  action.sa_flags = SA_RESTART;
+  sigemptyset(&action.sa_mask);
+  sigaction(IREE_TRACING_RINGBUFFER_SIGNAL, &action, NULL);
+#endif  // IREE_TRACING_RINGBUFFER_HAVE_SIGNALS
+
+  iree_atomic_store_int32(&_ringbuffer.init_state, 2,
+                          iree_memory_order_release);
+}
+
+void iree_tracing_ringbuffer_deinitialize() {
+#if IREE_TRACING_RINGBUFFER_DUMP_ON_EXIT
+  if (iree_atomic_load_int32(&_ringbuffer.init_state,
+                             iree_memory_order_acquire) == 2) {
+    iree_tracing_ringbuffer_dump(_ringbuffer.dump_path);
+  }
+#endif  // IREE_TRACING_RINGBUFFER_DUMP_ON_EXIT
+}
+
+// Allocates and registers the buffer for the calling thread.
+// Libraries embedded in hosting applications may never call
+// IREE_TRACE_APP_ENTER so the first thread to record initializes the global
+// state.
+static IREE_ATTRIBUTE_NOINLINE iree_tracing_ringbuffer_thread_t*
+iree_tracing_ringbuffer_register_thread(void) {
+  iree_tracing_ringbuffer_initialize();
+
+  // NOTE: we use malloc directly as the allocator may itself be traced.
+  iree_tracing_ringbuffer_thread_t* thread =
+      (iree_tracing_ringbuffer_thread_t*)malloc(sizeof(*thread));
+  if (!thread) {
+    _thread = &_ringbuffer_overflow_thread;
+    return _thread;
+  }
+  thread->thread_id = iree_thread_id();
+  memset(thread->name, 0, sizeof(thread->name));
+  iree_atomic_store_int64(&thread->write_index, 0, iree_memory_order_relaxed);
+
+  intptr_t head = iree_atomic_load_intptr(&_ringbuffer.thread_head,
+                                          iree_memory_order_relaxed);
+  do {
+    thread->next = (iree_tracing_ringbuffer_thread_t*)head;
+  } while (!iree_atomic_compare_exchange_weak_intptr(
+      &_ringbuffer.thread_head, &head, (intptr_t)thread,
+      iree_memory_order_release, iree_memory_order_relaxed));
+
+  _thread = thread;
+  return thread;
+}
+
+static inline iree_tracing_ringbuffer_thread_t*
+iree_tracing_ringbuffer_current_thread(void) {
+  iree_tracing_ringbuffer_thread_t* thread = _thread;
+  if (IREE_UNLIKELY(!thread)) {
+    thread = iree_tracing_ringbuffer_register_thread();
+  }
+  return thread;
+}
+
+// Returns the next event in |thread| with the type and timestamp populated.
+// The event must be published with iree_tracing_ringbuffer_event_end once all
+// other fields have been written.
+static inline iree_tracing_ringbuffer_event_t*
+iree_tracing_ringbuffer_event_begin(iree_tracing_ringbuffer_thread_t* thread,
+                                    iree_tracing_ringbuffer_event_type_t type) {
+  int64_t index =
+      iree_atomic_load_int64(&thread->write_index, iree_memory_order_relaxed);
+  // Orders the publication of the previous event before the stores to this
+  // one (which may be overwriting an event the dump is reading). Free on x86.
+  iree_atomic_thread_fence(iree_memory_order_release);
+  iree_tracing_ringbuffer_event_t* event =
+      &thread->events[index & IREE_TRACING_RINGBUFFER_CAPACITY_MASK];
+  event->timestamp = iree_tracing_ringbuffer_timestamp();
+  event->type = (uint8_t)type;
+  return event;
+}
+
+static inline void iree_tracing_ringbuffer_event_end(
+    iree_tracing_ringbuffer_thread_t* thread) {
+  int64_t index =
+      iree_atomic_load_int64(&thread->write_index, iree_memory_order_relaxed);
+  iree_atomic_store_int64(&thread->write_index, index + 1,
+                          iree_memory_order_release);
+}
+
+static inline void iree_tracing_ringbuffer_event_set_text(
+    iree_tracing_ringbuffer_event_t* event, const char* text,
+    size_t text_length) {
+  if (!text) text_length = 0;
+  event->text_length =
+      (uint8_t)iree_min(text_length, IREE_TRACING_RINGBUFFER_TEXT_CAPACITY);
+  memcpy(event->text, text, event->text_length);
+}
+
+void iree_tracing_set_thread_name(const char* name) {
+  iree_tracing_ringbuffer_thread_t* thread =
+      iree_tracing_ringbuffer_current_thread();
+  snprintf(thread->name, sizeof(thread->name), "%s", name);
+}
+
+IREE_MUST_USE_RESULT iree_zone_id_t
+iree_tracing_zone_begin_impl(const iree_tracing_location_t* src_loc,
+                             const char* name, size_t name_length) {
+  iree_tracing_ringbuffer_thread_t* thread =
+      iree_tracing_ringbuffer_current_thread();
+  if (!name) {
+    iree_tracing_ringbuffer_event_t* event =
+        iree_tracing_ringbuffer_event_begin(
+            thread, IREE_TRACING_RINGBUFFER_EVENT_ZONE_BEGIN);
+    event->ptr = src_loc;
+  } else {
+    iree_tracing_ringbuffer_event_t* event =
+        iree_tracing_ringbuffer_event_begin(
+            thread, IREE_TRACING_RINGBUFFER_EVENT_ZONE_BEGIN_DYNAMIC);
+    event->ptr = src_loc;
+    iree_tracing_ringbuffer_event_set_text(event, name, name_length);
+  }
+  iree_tracing_ringbuffer_event_end(thread);
+  return 1;
+}
+
+IREE_MUST_USE_RESULT iree_zone_id_t iree_tracing_zone_begin_external_impl(
+    const char* file_name, size_t file_name_length, uint32_t line,
+    const char* function_name, size_t function_name_length, const char* name,
+    size_t name_length) {
+  iree_tracing_ringbuffer_thread_t* thread =
+      iree_tracing_ringbuffer_current_thread();
+  iree_tracing_ringbuffer_event_t* event = iree_tracing_ringbuffer_event_begin(
+      thread, IREE_TRACING_RINGBUFFER_EVENT_ZONE_BEGIN_EXTERNAL);
+  event->value.i64 = line;
+  if (name) {
+    iree_tracing_ringbuffer_event_set_text(event, name, name_length);
+  } else {
+    iree_tracing_ringbuffer_event_set_text(event, function_name,
+                                           function_name_length);
+  }
+  iree_tracing_ringbuffer_event_end(thread);
+  return 1;
+}
+
+void iree_tracing_zone_end(iree_zone_id_t zone_id) {
+  if (!zone_id) return;
+  iree_tracing_ringbuffer_thread_t* thread =
+      iree_tracing_ringbuffer_current_thread();
+  iree_tracing_ringbuffer_event_begin(thread,
+                                      IREE_TRACING_RINGBUFFER_EVENT_ZONE_END);
+  iree_tracing_ringbuffer_event_end(thread);
+}
+
+void iree_tracing_plot_value_i64(const char* name_literal, int64_t value) {
+  iree_tracing_ringbuffer_thread_t* thread =
+      iree_tracing_ringbuffer_current_thread();
+  iree_tracing_ringbuffer_event_t* event = iree_tracing_ringbuffer_event_begin(
+      thread, IREE_TRACING_RINGBUFFER_EVENT_PLOT_I64);
+  event->ptr = name_literal;
+  event->value.i64 = value;
+  iree_tracing_ringbuffer_event_end(thread);
+}
+
+void iree_tracing_plot_value_f64(const char* name_literal, double value) {
+  iree_tracing_ringbuffer_thread_t* thread =
+      iree_tracing_ringbuffer_current_thread();
+  iree_tracing_ringbuffer_event_t* event = iree_tracing_ringbuffer_event_begin(
+      thread, IREE_TRACING_RINGBUFFER_EVENT_PLOT_F64);
+  event->ptr = name_literal;
+  event->value.f64 = value;
+  iree_tracing_ringbuffer_event_end(thread);
+}
+
+void iree_tracing_frame_mark(const char* name_literal) {
+  iree_tracing_ringbuffer_thread_t* thread =
+      iree_tracing_ringbuffer_current_thread();
+  iree_tracing_ringbuffer_event_t* event = iree_tracing_ringbuffer_event_begin(
+      thread, IREE_TRACING_RINGBUFFER_EVENT_FRAME_MARK);
+  event->ptr = name_literal;
+  iree_tracing_ringbuffer_event_end(thread);
+}
+
+void iree_tracing_message_cstring(const char* value_literal, uint32_t color) {
+  iree_tracing_ringbuffer_thread_t* thread =
+      iree_tracing_ringbuffer_current_thread();
+  iree_tracing_ringbuffer_event_t* event = iree_tracing_ringbuffer_event_begin(
+      thread, IREE_TRACING_RINGBUFFER_EVENT_MESSAGE_LITERAL);
+  event->ptr = value_literal;
+  event->color = color;
+  iree_tracing_ringbuffer_event_end(thread);
+}
+
+void iree_tracing_message_string_view(const char* value, size_t value_length,
+                                      uint32_t color) {
+  iree_tracing_ringbuffer_thread_t* thread =
+      iree_tracing_ringbuffer_current_thread();
+  iree_tracing_ringbuffer_event_t* event = iree_tracing_ringbuffer_event_begin(
+      thread, IREE_TRACING_RINGBUFFER_EVENT_MESSAGE_DYNAMIC);
+  event->color = color;
+  iree_tracing_ringbuffer_event_set_text(event, value, value_length);
+  iree_tracing_ringbuffer_event_end(thread);
+}
+
+//===----------------------------------------------------------------------===//
+// Chrome trace event JSON dump
+//===----------------------------------------------------------------------===//
+// https://docs.google.com/document/d/1CvAClvFfyA5R-PhYUmn5OOQtYMH4h6I0nSsKchNAySU
+//
+// The dump may run from a signal handler and must only use async-signal-safe
+// functions: no stdio, no allocation, and no locks. All formatting is done
+// manually into a fixed-size buffer that is flushed with raw writes.
+
+typedef struct iree_tracing_ringbuffer_writer_t {
+  int fd;
+  bool failed;
+  size_t length;
+  char buffer[4096];
+} iree_tracing_ringbuffer_writer_t;
+
+static void iree_tracing_ringbuffer_writer_flush(
+    iree_tracing_ringbuffer_writer_t* writer) {
+  size_t offset = 0;
+  while (!writer->failed && offset < writer->length) {
+    intptr_t written = (intptr_t)iree_file_write(
+        writer->fd, writer->buffer + offset, writer->length - offset);
+    if (written < 0 && errno == EINTR) continue;
+    if (written <= 0) {
+      writer->failed = true;
+      break;
+    }
+    offset += (size_t)written;
+  }
+  writer->length = 0;
+}
+
+static void iree_tracing_ringbuffer_write(
+    iree_tracing_ringbuffer_writer_t* writer, const char* data,
+    size_t length) {
+  while (length > 0) {
+    if (writer->length == sizeof(writer->buffer)) {
+      iree_tracing_ringbuffer_writer_flush(writer);
+    }
+    size_t chunk_length =
+        iree_min(length, sizeof(writer->buffer) - writer->length);
+    memcpy(writer->buffer + writer->length, data, chunk_length);
+    writer->length += chunk_length;
+    data += chunk_length;
+    length -= chunk_length;
+  }
+}
+
+static void iree_tracing_ringbuffer_write_cstring(
+    iree_tracing_ringbuffer_writer_t* writer, const char* value) {
+  iree_tracing_ringbuffer_write(writer, value, strlen(value));
+}
+
+// Writes |value| as a quoted JSON string.
+static void iree_tracing_ringbuffer_write_string(
+    iree_tracing_ringbuffer_writer_t* writer, const char* value,
+    size_t length) {
+  static const char kHexDigits[] = "0123456789abcdef";
+  iree_tracing_ringbuffer_write(writer, "\"", 1);
+  for (size_t i = 0; i < length; ++i) {
+    unsigned char c = (unsigned char)value[i];
+    if (c == '"' || c == '\\') {
+      char escaped[2] = {'\\', (char)c};
+      iree_tracing_ringbuffer_write(writer, escaped, sizeof(escaped));
+    } else if (c < 0x20) {
+      char escaped[6] = {
+          '\\', 'u', '0', '0', kHexDigits[c >> 4], kHexDigits[c & 0xF],
+      };
+      iree_tracing_ringbuffer_write(writer, escaped, sizeof(escaped));
+    } else {
+      iree_tracing_ringbuffer_write(writer, (const char*)&c, 1);
+    }
+  }
+  iree_tracing_ringbuffer_write(writer, "\"", 1);
+}
+
+static void iree_tracing_ringbuffer_write_u64(
+    iree_tracing_ringbuffer_writer_t* writer, uint64_t value) {
+  char digits[20];
+  size_t digit_count = 0;
+  do {
+    digits[sizeof(digits) - ++digit_count] = (char)('0' + value % 10);
+    value /= 10;
+  } while (value);
+  iree_tracing_ringbuffer_write(
+      writer, digits + sizeof(digits) - digit_count, digit_count);
+}
+
+static void iree_tracing_ringbuffer_write_i64(
+    iree_tracing_ringbuffer_writer_t* writer, int64_t value) {
+  if (value < 0) {
+    iree_tracing_ringbuffer_write(writer, "-", 1);
+    iree_tracing_ringbuffer_write_u64(writer, 0 - (uint64_t)value);
+  } else {
+    iree_tracing_ringbuffer_write_u64(writer, (uint64_t)value);
+  }
+}
+
+// Writes |value| with 6 fractional digits. Non-finite values are not
+// representable in JSON and are written as 0.
+static void iree_tracing_ringbuffer_write_f64(
+    iree_tracing_ringbuffer_writer_t* writer, double value) {
+  if (value != value || value - value != 0.0) {
+    iree_tracing_ringbuffer_write(writer, "0", 1);
+    return;
+  }
+  if (value < 0.0) {
+    iree_tracing_ringbuffer_write(writer, "-", 1);
+    value = -value;
+  }
+  int exponent = 0;
+  while (value >= 1e18) {
+    value /= 10.0;
+    ++exponent;
+  }
+  uint64_t integral = (uint64_t)value;
+  uint64_t fraction = (uint64_t)((value - (double)integral) * 1e6 + 0.5);
+  if (fraction >= 1000000) {
+    ++integral;
+    fraction -= 1000000;
+  }
+  iree_tracing_ringbuffer_write_u64(writer, integral);
+  char fraction_digits[7] = {'.'};
+  for (int i = 6; i > 0; --i) {
+    fraction_digits[i] = (char)('0' + fraction % 10);
+    fraction /= 10;
+  }
+  iree_tracing_ringbuffer_write(writer, fraction_digits,
+                                sizeof(fraction_digits));
+  if (exponent) {
+    iree_tracing_ringbuffer_write(writer, "e", 1);
+    iree_tracing_ringbuffer_write_u64(writer, (uint64_t)exponent);
+  }
+}
+
+// Writes a nanosecond timestamp as the fractional microseconds Chrome expects.
+static void iree_tracing_ringbuffer_write_timestamp(
+    iree_tracing_ringbuffer_writer_t* writer, uint64_t time_ns) {
+  iree_tracing_ringbuffer_write_u64(writer, time_ns / 1000);
+  uint32_t fraction = (uint32_t)(time_ns % 1000);
+  char fraction_digits[4] = {
+      '.',
+      (char)('0' + fraction / 100),
+      (char)('0' + (fraction / 10) % 10),
+      (char)('0' + fraction % 10),
+  };
+  iree_tracing_ringbuffer_write(writer, fraction_digits,
+                                sizeof(fraction_digits));
+}
+
+// Returns the base name of |file_name| without any leading path.
+static const char* iree_tracing_ringbuffer_trim_file_path(
+    const char* file_name, size_t file_name_length, size_t* out_length) {
+  for (size_t i = file_name_length; i > 0; --i) {
+    char c = file_name[i - 1];
+    if (c == '/' || c == '\\') {
+      *out_length = file_name_length - i;
+      return file_name + i;
+    }
+  }
+  *out_length = file_name_length;
+  return file_name;
+}
+
+// Returns the number of nanoseconds per timestamp counter tick.
+static double iree_tracing_ringbuffer_ns_per_tick(void) {
+#if defined(IREE_ARCH_X86_64) && \
+    (defined(IREE_COMPILER_MSVC) || defined(IREE_COMPILER_GCC_COMPAT))
+  // The TSC frequency is not architecturally exposed so calibrate against the
+  // monotonic clock over the lifetime of the process. The longer the process
+  // has been running the more accurate this is.
+  uint64_t time_ns = iree_tracing_ringbuffer_time_ns();
+  uint64_t timestamp = iree_tracing_ringbuffer_timestamp();
+  if (timestamp <= _ringbuffer.base_timestamp ||
+      time_ns <= _ringbuffer.base_time_ns) {
+    return 1.0;
+  }
+  return (double)(time_ns - _ringbuffer.base_time_ns) /
+         (double)(timestamp - _ringbuffer.base_timestamp);
+#elif defined(IREE_ARCH_ARM_64) && defined(IREE_COMPILER_GCC_COMPAT)
+  uint64_t frequency;
+  __asm__ volatile("mrs %0, cntfrq_el0" : "=r"(frequency));
+  return frequency ? 1e9 / (double)frequency : 1.0;
+#else
+  return 1.0;
+#endif  // IREE_ARCH_*
+}
+
+typedef struct iree_tracing_ringbuffer_dump_state_t {
+  iree_tracing_ringbuffer_writer_t* writer;
+  uint64_t process_id;
+  double ns_per_tick;
+  bool any_events;
+} iree_tracing_ringbuffer_dump_state_t;
+
+// Writes the common prefix of an event object through the "ts" field.
+static void iree_tracing_ringbuffer_write_event_prefix(
+    iree_tracing_ringbuffer_dump_state_t* state,
+    const iree_tracing_ringbuffer_thread_t* thread, const char* phase,
+    uint64_t timestamp) {
+  iree_tracing_ringbuffer_writer_t* writer = state->writer;
+  iree_tracing_ringbuffer_write_cstring(
+      writer, state->any_events ? ",\n{\"ph\":\"" : "\n{\"ph\":\"");
+  state->any_events = true;
+  iree_tracing_ringbuffer_write_cstring(writer, phase);
+  iree_tracing_ringbuffer_write_cstring(writer, "\",\"pid\":");
+  iree_tracing_ringbuffer_write_u64(writer, state->process_id);
+  iree_tracing_ringbuffer_write_cstring(writer, ",\"tid\":");
+  iree_tracing_ringbuffer_write_u64(writer, thread->thread_id);
+  iree_tracing_ringbuffer_write_cstring(writer, ",\"ts\":");
+  uint64_t time_ns =
+      timestamp > _ringbuffer.base_timestamp
+          ? (uint64_t)((double)(timestamp - _ringbuffer.base_timestamp) *
+                       state->ns_per_tick)
+          : 0;
+  iree_tracing_ringbuffer_write_timestamp(writer, time_ns);
+}
+
+static void iree_tracing_ringbuffer_write_event(
+    iree_tracing_ringbuffer_dump_state_t* state,
+    const iree_tracing_ringbuffer_thread_t* thread,
+    const iree_tracing_ringbuffer_event_t* event) {
+  iree_tracing_ringbuffer_writer_t* writer = state->writer;
+  switch (event->type) {
+    case IREE_TRACING_RINGBUFFER_EVENT_ZONE_BEGIN:
+    case IREE_TRACING_RINGBUFFER_EVENT_ZONE_BEGIN_DYNAMIC: {
+      const iree_tracing_location_t* src_loc =
+          (const iree_tracing_location_t*)event->ptr;
+      iree_tracing_ringbuffer_write_event_prefix(state, thread, "B",
+                                                 event->timestamp);
+      iree_tracing_ringbuffer_write_cstring(writer, ",\"name\":");
+      if (event->type == IREE_TRACING_RINGBUFFER_EVENT_ZONE_BEGIN_DYNAMIC) {
+        iree_tracing_ringbuffer_write_string(writer, event->text,
+                                             event->text_length);
+      } else if (src_loc->name) {
+        iree_tracing_ringbuffer_write_string(writer, src_loc->name,
+                                             src_loc->name_length);
+      } else {
+        iree_tracing_ringbuffer_write_string(writer, src_loc->function_name,
+                                             src_loc->function_name_length);
+      }
+      size_t file_name_length = 0;
+      const char* file_name = iree_tracing_ringbuffer_trim_file_path(
+          src_loc->file_name, src_loc->file_name_length, &file_name_length);
+      iree_tracing_ringbuffer_write_cstring(writer, ",\"args\":{\"file\":");
+      iree_tracing_ringbuffer_write_string(writer, file_name,
+                                           file_name_length);
+      iree_tracing_ringbuffer_write_cstring(writer, ",\"line\":");
+      iree_tracing_ringbuffer_write_u64(writer, src_loc->line);
+      iree_tracing_ringbuffer_write_cstring(writer, "}}");
+      break;
+    }
+    case IREE_TRACING_RINGBUFFER_EVENT_ZONE_BEGIN_EXTERNAL: {
+      iree_tracing_ringbuffer_write_event_prefix(state, thread, "B",
+                                                 event->timestamp);
+      iree_tracing_ringbuffer_write_cstring(writer, ",\"name\":");
+      iree_tracing_ringbuffer_write_string(writer, event->text,
+                                           event->text_length);
+      iree_tracing_ringbuffer_write_cstring(writer, ",\"args\":{\"line\":");
+      iree_tracing_ringbuffer_write_i64(writer, event->value.i64);
+      iree_tracing_ringbuffer_write_cstring(writer, "}}");
+      break;
+    }
+    case IREE_TRACING_RINGBUFFER_EVENT_ZONE_END: {
+      iree_tracing_ringbuffer_write_event_prefix(state, thread, "E",
+                                                 event->timestamp);
+      iree_tracing_ringbuffer_write_cstring(writer, "}");
+      break;
+    }
+    case IREE_TRACING_RINGBUFFER_EVENT_PLOT_I64:
+    case IREE_TRACING_RINGBUFFER_EVENT_PLOT_F64: {
+      iree_tracing_ringbuffer_write_event_prefix(state, thread, "C",
+                                                 event->timestamp);
+      iree_tracing_ringbuffer_write_cstring(writer, ",\"name\":");
+      iree_tracing_ringbuffer_write_string(writer, (const char*)event->ptr,
+                                           strlen((const char*)event->ptr));
+      iree_tracing_ringbuffer_write_cstring(writer, ",\"args\":{\"value\":");
+      if (event->type == IREE_TRACING_RINGBUFFER_EVENT_PLOT_I64) {
+        iree_tracing_ringbuffer_write_i64(writer, event->value.i64);
+      } else {
+        iree_tracing_ringbuffer_write_f64(writer, event->value.f64);
+      }
+      iree_tracing_ringbuffer_write_cstring(writer, "}}");
+      break;
+    }
+    case IREE_TRACING_RINGBUFFER_EVENT_FRAME_MARK: {
+      const char* name = event->ptr ? (const char*)event->ptr : "frame";
+      iree_tracing_ringbuffer_write_event_prefix(state, thread, "i",
+                                                 event->timestamp);
+      iree_tracing_ringbuffer_write_cstring(writer, ",\"s\":\"p\",\"name\":");
+      iree_tracing_ringbuffer_write_string(writer, name, strlen(name));
+      iree_tracing_ringbuffer_write_cstring(writer, "}");
+      break;
+    }
+    case IREE_TRACING_RINGBUFFER_EVENT_MESSAGE_LITERAL:
+    case IREE_TRACING_RINGBUFFER_EVENT_MESSAGE_DYNAMIC: {
+      iree_tracing_ringbuffer_write_event_prefix(state, thread, "i",
+                                                 event->timestamp);
+      iree_tracing_ringbuffer_write_cstring(writer, ",\"s\":\"t\",\"name\":");
+      if (event->type == IREE_TRACING_RINGBUFFER_EVENT_MESSAGE_LITERAL) {
+        iree_tracing_ringbuffer_write_string(writer, (const char*)event->ptr,
+                                             strlen((const char*)event->ptr));
+      } else {
+        iree_tracing_ringbuffer_write_string(writer, event->text,
+                                             event->text_length);
+      }
+      iree_tracing_ringbuffer_write_cstring(writer, ",\"args\":{\"color\":");
+      iree_tracing_ringbuffer_write_u64(writer, event->color);
+      iree_tracing_ringbuffer_write_cstring(writer, "}}");
+      break;
+    }
+    default:
+      break;
+  }
+}
+
+static void iree_tracing_ringbuffer_write_thread(
+    iree_tracing_ringbuffer_dump_state_t* state,
+    iree_tracing_ringbuffer_thread_t* thread) {
+  iree_tracing_ringbuffer_writer_t* writer = state->writer;
+
+  // Thread name metadata.
+  char name[IREE_TRACING_RINGBUFFER_THREAD_NAME_CAPACITY];
+  memcpy(name, thread->name, sizeof(name));
+  name[sizeof(name) - 1] = 0;
+  if (name[0]) {
+    iree_tracing_ringbuffer_write_cstring(
+        writer, state->any_events ? ",\n{\"ph\":\"M\"" : "\n{\"ph\":\"M\"");
+    state->any_events = true;
+    iree_tracing_ringbuffer_write_cstring(writer, ",\"pid\":");
+    iree_tracing_ringbuffer_write_u64(writer, state->process_id);
+    iree_tracing_ringbuffer_write_cstring(writer, ",\"tid\":");
+    iree_tracing_ringbuffer_write_u64(writer, thread->thread_id);
+    iree_tracing_ringbuffer_write_cstring(
+        writer, ",\"name\":\"thread_name\",\"args\":{\"name\":");
+    iree_tracing_ringbuffer_write_string(writer, name, strlen(name));
+    iree_tracing_ringbuffer_write_cstring(writer, "}}");
+  }
+
+  int64_t end_index =
+      iree_atomic_load_int64(&thread->write_index, iree_memory_order_acquire);
+  int64_t index = end_index > IREE_TRACING_RINGBUFFER_CAPACITY
+                      ? end_index - IREE_TRACING_RINGBUFFER_CAPACITY
+                      : 0;
+  uint32_t depth = 0;
+  for (; index < end_index; ++index) {
+    // Copy the event and then check whether the thread has since started
+    // overwriting it. The acquire fence pairs with the release fence in
+    // iree_tracing_ringbuffer_event_begin such that if any of the copied
+    // fields came from a newer event the newer write_index is observed.
+    iree_tracing_ringbuffer_event_t event =
+        thread->events[index & IREE_TRACING_RINGBUFFER_CAPACITY_MASK];
+    iree_atomic_thread_fence(iree_memory_order_acquire);
+    int64_t write_index =
+        iree_atomic_load_int64(&thread->write_index, iree_memory_order_relaxed);
+    if (index + IREE_TRACING_RINGBUFFER_CAPACITY <= write_index) {
+      // Overwritten; any zones begun prior were lost with it.
+      depth = 0;
+      continue;
+    }
+
+    // Drop zone ends whose begin was overwritten. Zones that are still open
+    // are left unterminated and shown as such by trace viewers.
+    if (event.type == IREE_TRACING_RINGBUFFER_EVENT_ZONE_END) {
+      if (!depth) continue;
+      --depth;
+    } else if (event.type == IREE_TRACING_RINGBUFFER_EVENT_ZONE_BEGIN ||
+               event.type == IREE_TRACING_RINGBUFFER_EVENT_ZONE_BEGIN_DYNAMIC ||
+               event.type ==
+                   IREE_TRACING_RINGBUFFER_EVENT_ZONE_BEGIN_EXTERNAL) {
+      ++depth;
+    }
+
+    iree_tracing_ringbuffer_write_event(state, thread, &event);
+  }
+}
+
+bool iree_tracing_ringbuffer_dump(const char* path) {
+  int32_t expected = 0;
+  if (!iree_atomic_compare_exchange_strong_int32(
+          &_ringbuffer.dumping, &expected, 1, iree_memory_order_acquire,
+          iree_memory_order_relaxed)) {
+    return false;  // dump already in progress (possibly on this thread)
+  }
+
+  iree_tracing_ringbuffer_writer_t writer;
+  writer.fd = iree_file_open_for_write(path);
+  writer.failed = writer.fd < 0;
+  writer.length = 0;
+
+  if (!writer.failed) {
+    iree_tracing_ringbuffer_dump_state_t state = {
+        .writer = &writer,
+        .process_id = iree_process_id(),
+        .ns_per_tick = iree_tracing_ringbuffer_ns_per_tick(),
+        .any_events = false,
+    };
+    iree_tracing_ringbuffer_write_cstring(&writer, "{\"traceEvents\":[");
+    iree_tracing_ringbuffer_thread_t* thread =
+        (iree_tracing_ringbuffer_thread_t*)iree_atomic_load_intptr(
+            &_ringbuffer.thread_head, iree_memory_order_acquire);
+    for (; thread; thread = thread->next) {
+      iree_tracing_ringbuffer_write_thread(&state, thread);
+    }
+    iree_tracing_ringbuffer_write_cstring(
+        &writer, "\n],\"displayTimeUnit\":\"ns\"}\n");
+    iree_tracing_ringbuffer_writer_flush(&writer);
+    iree_file_close(writer.fd);
+  }
+
+  iree_atomic_store_int32(&_ringbuffer.dumping, 0, iree_memory_order_release);
+  return !writer.failed;
+}
+
+#endif  // IREE_TRACING_FEATURES
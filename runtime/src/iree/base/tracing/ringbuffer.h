@@ -0,0 +1,307 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+// Low-overhead flight-recorder tracing provider.
+//
+// Zone begin/end events, plot values, and messages are written into fixed-size
+// per-thread ring buffers with raw CPU timestamp counter values. Nothing is
+// formatted or written out while recording: each event is a handful of stores
+// into thread-local memory, making it cheap enough to leave enabled in
+// production. When the buffers fill the oldest events are overwritten such
+// that the most recent window of activity is always available.
+//
+// The buffers can be dumped on demand as Chrome trace event JSON (loadable in
+// chrome://tracing, https://ui.perfetto.dev, etc) with either
+// iree_tracing_ringbuffer_dump or by sending the process the signal specified
+// by IREE_TRACING_RINGBUFFER_SIGNAL (SIGUSR2 by default on POSIX platforms):
+//   $ kill -USR2 <pid>
+// The signal-triggered dump is written to the path in the
+// IREE_TRACING_RINGBUFFER_PATH environment variable if set or otherwise
+// `iree-trace-<pid>.json` in the working directory.
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "iree/base/attributes.h"
+#include "iree/base/config.h"
+
+#ifndef IREE_BASE_TRACING_RINGBUFFER_H_
+#define IREE_BASE_TRACING_RINGBUFFER_H_
+
+//===----------------------------------------------------------------------===//
+// Ringbuffer tracing configuration
+//===----------------------------------------------------------------------===//
+
+// Filter to only supported features.
+#if !defined(IREE_TRACING_FEATURES)
+#define IREE_TRACING_FEATURES          \
+  ((IREE_TRACING_FEATURES_REQUESTED) & \
+   (IREE_TRACING_FEATURE_INSTRUMENTATION | IREE_TRACING_FEATURE_LOG_MESSAGES))
+#endif  // !IREE_TRACING_FEATURES
+
+// Number of events retained per thread. Must be a power of two. Each event is
+// 64 bytes and each thread that emits an event allocates its buffer on first
+// use and retains it for the lifetime of the process.
+#if !defined(IREE_TRACING_RINGBUFFER_CAPACITY)
+#define IREE_TRACING_RINGBUFFER_CAPACITY 8192
+#endif  // !IREE_TRACING_RINGBUFFER_CAPACITY
+
+// Signal number that triggers a dump of all thread buffers when received.
+// Set to 0 to disable the signal handler. Ignored on platforms without POSIX
+// signals.
+#if !defined(IREE_TRACING_RINGBUFFER_SIGNAL)
+#define IREE_TRACING_RINGBUFFER_SIGNAL SIGUSR2
+#endif  // !IREE_TRACING_RINGBUFFER_SIGNAL
+
+// Dumps all thread buffers in IREE_TRACE_APP_EXIT when enabled. Useful when
+// running tools locally; production deployments usually only want the
+// on-demand dumps.
+#if !defined(IREE_TRACING_RINGBUFFER_DUMP_ON_EXIT)
+#define IREE_TRACING_RINGBUFFER_DUMP_ON_EXIT 0
+#endif  // !IREE_TRACING_RINGBUFFER_DUMP_ON_EXIT
+
+//===----------------------------------------------------------------------===//
+// C API used for tracing control
+//===----------------------------------------------------------------------===//
+// These functions are implementation details and should not be called directly.
+// Always use the macros (or C++ RAII types).
+
+// Local zone ID used for the C IREE_TRACE_ZONE_* macros.
+typedef uint32_t iree_zone_id_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+#if IREE_TRACING_FEATURES
+
+#define IREE_TRACE_IMPL_CONCAT(x, y) IREE_TRACE_IMPL_CONCAT2(x, y)
+#define IREE_TRACE_IMPL_CONCAT2(x, y) x##y
+
+#define IREE_TRACE_STRLEN(literal) (sizeof(literal) - 1)
+
+typedef struct iree_tracing_location_t {
+  const char* name;
+  size_t name_length;
+  const char* function_name;
+  size_t function_name_length;
+  const char* file_name;
+  size_t file_name_length;
+  uint32_t line;
+  uint32_t color;
+} iree_tracing_location_t;
+
+#define iree_tracing_make_zone_ctx(zone_id) (zone_id)
+
+void iree_tracing_ringbuffer_initialize();
+void iree_tracing_ringbuffer_deinitialize();
+
+// Dumps the contents of all thread buffers to the file at |path| as Chrome
+// trace event JSON. Recording continues on all threads while the dump is in
+// progress and events overwritten during the dump are omitted. Returns false
+// if the file could not be written or another dump is in progress.
+bool iree_tracing_ringbuffer_dump(const char* path);
+
+void iree_tracing_set_thread_name(const char* name);
+
+IREE_MUST_USE_RESULT iree_zone_id_t
+iree_tracing_zone_begin_impl(const iree_tracing_location_t* src_loc,
+                             const char* name, size_t name_length);
+IREE_MUST_USE_RESULT iree_zone_id_t iree_tracing_zone_begin_external_impl(
+    const char* file_name, size_t file_name_length, uint32_t line,
+    const char* function_name, size_t function_name_length, const char* name,
+    size_t name_length);
+void iree_tracing_zone_end(iree_zone_id_t zone_id);
+
+void iree_tracing_plot_value_i64(const char* name_literal, int64_t value);
+void iree_tracing_plot_value_f64(const char* name_literal, double value);
+
+void iree_tracing_frame_mark(const char* name_literal);
+
+void iree_tracing_message_cstring(const char* value_literal, uint32_t color);
+void iree_tracing_message_string_view(const char* value, size_t value_length,
+                                      uint32_t color);
+
+#endif  // IREE_TRACING_FEATURES
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+//===----------------------------------------------------------------------===//
+// Instrumentation macros (C)
+//===----------------------------------------------------------------------===//
+
+#if IREE_TRACING_FEATURES & IREE_TRACING_FEATURE_INSTRUMENTATION
+
+#define IREE_TRACE(expr) expr
+
+#define IREE_TRACE_APP_ENTER() iree_tracing_ringbuffer_initialize()
+#define IREE_TRACE_APP_EXIT(exit_code) iree_tracing_ringbuffer_deinitialize()
+#define IREE_TRACE_SET_APP_INFO(value, value_length)
+#define IREE_TRACE_SET_THREAD_NAME(name) iree_tracing_set_thread_name(name)
+
+#define IREE_TRACE_FIBER_ENTER(fiber)
+#define IREE_TRACE_FIBER_LEAVE()
+
+#define IREE_TRACE_ZONE_BEGIN(zone_id) \
+  IREE_TRACE_ZONE_BEGIN_NAMED(zone_id, NULL)
+
+#define IREE_TRACE_ZONE_BEGIN_NAMED(zone_id, name_literal)                     \
+  static const iree_tracing_location_t IREE_TRACE_IMPL_CONCAT(                 \
+      __iree_tracing_source_location, __LINE__) = {                            \
+      name_literal,       IREE_TRACE_STRLEN(name_literal),                     \
+      __FUNCTION__,       IREE_TRACE_STRLEN(__FUNCTION__),                     \
+      __FILE__,           IREE_TRACE_STRLEN(__FILE__),                         \
+      (uint32_t)__LINE__, 0};                                                  \
+  iree_zone_id_t zone_id = iree_tracing_zone_begin_impl(                       \
+      &IREE_TRACE_IMPL_CONCAT(__iree_tracing_source_location, __LINE__), NULL, \
+      0)
+
+#define IREE_TRACE_ZONE_BEGIN_NAMED_DYNAMIC(zone_id, name, name_length)  \
+  static const iree_tracing_location_t IREE_TRACE_IMPL_CONCAT(           \
+      __iree_tracing_source_location, __LINE__) = {                      \
+      NULL,                                                              \
+      0,                                                                 \
+      __FUNCTION__,                                                      \
+      IREE_TRACE_STRLEN(__FUNCTION__),                                   \
+      __FILE__,                                                          \
+      IREE_TRACE_STRLEN(__FILE__),                                       \
+      (uint32_t)__LINE__,                                                \
+      0};                                                                \
+  iree_zone_id_t zone_id = iree_tracing_zone_begin_impl(                 \
+      &IREE_TRACE_IMPL_CONCAT(__iree_tracing_source_location, __LINE__), \
+      (name), (name_length))
+
+#define IREE_TRACE_ZONE_BEGIN_EXTERNAL(                                       \
+    zone_id, file_name, file_name_length, line, function_name,                \
+    function_name_length, name, name_length)                                  \
+  iree_zone_id_t zone_id = iree_tracing_zone_begin_external_impl(             \
+      file_name, file_name_length, line, function_name, function_name_length, \
+      name, name_length)
+
+#define IREE_TRACE_ZONE_END(zone_id) iree_tracing_zone_end(zone_id)
+
+#define IREE_RETURN_AND_END_ZONE_IF_ERROR(zone_id, ...) \
+  IREE_RETURN_AND_EVAL_IF_ERROR(IREE_TRACE_ZONE_END(zone_id), __VA_ARGS__)
+
+#define IREE_TRACE_ZONE_SET_COLOR(zone_id, color_xbgr)
+
+// TODO(benvanik): ringbuffer tracing zone append value/text. These would need
+// to be recorded as additional events and attached as args during the dump.
+#define IREE_TRACE_ZONE_APPEND_VALUE_I64(zone_id, value) (void)(value)
+#define IREE_TRACE_ZONE_APPEND_TEXT(...)                                  \
+  IREE_TRACE_IMPL_GET_VARIADIC_((__VA_ARGS__,                             \
+                                 IREE_TRACE_ZONE_APPEND_TEXT_STRING_VIEW, \
+                                 IREE_TRACE_ZONE_APPEND_TEXT_CSTRING))    \
+  (__VA_ARGS__)
+#define IREE_TRACE_ZONE_APPEND_TEXT_CSTRING(zone_id, value) (void)(value)
+#define IREE_TRACE_ZONE_APPEND_TEXT_STRING_VIEW(zone_id, value, value_length) \
+  (void)(value), (void)(value_length)
+
+// Plots are emitted as Chrome trace counter events. The plot type and display
+// configuration have no equivalent and are ignored.
+#define IREE_TRACE_SET_PLOT_TYPE(name_literal, plot_type, step, fill, color) \
+  (void)(name_literal), (void)(plot_type), (void)(step), (void)(fill),       \
+      (void)(color)
+#define IREE_TRACE_PLOT_VALUE_I64(name_literal, value) \
+  iree_tracing_plot_value_i64(name_literal, (int64_t)(value))
+#define IREE_TRACE_PLOT_VALUE_F32(name_literal, value) \
+  iree_tracing_plot_value_f64(name_literal, (double)(value))
+#define IREE_TRACE_PLOT_VALUE_F64(name_literal, value) \
+  iree_tracing_plot_value_f64(name_literal, (double)(value))
+
+// Frame marks are emitted as process-wide instant events. Discontinuous frames
+// have no equivalent and are ignored.
+#define IREE_TRACE_FRAME_MARK() iree_tracing_frame_mark(NULL)
+#define IREE_TRACE_FRAME_MARK_NAMED(name_literal) \
+  iree_tracing_frame_mark(name_literal)
+#define IREE_TRACE_FRAME_MARK_BEGIN_NAMED(name_literal)
+#define IREE_TRACE_FRAME_MARK_END_NAMED(name_literal)
+
+// Messages are emitted as thread-scoped instant events. Literal messages are
+// retained by reference while dynamic messages are truncated to fit within a
+// single event.
+#define IREE_TRACE_MESSAGE(level, value_literal) \
+  iree_tracing_message_cstring(value_literal,    \
+                               IREE_TRACING_MESSAGE_LEVEL_##level)
+#define IREE_TRACE_MESSAGE_COLORED(color, value_literal) \
+  iree_tracing_message_cstring(value_literal, color)
+#define IREE_TRACE_MESSAGE_DYNAMIC(level, value, value_length) \
+  iree_tracing_message_string_view(value, value_length,        \
+                                   IREE_TRACING_MESSAGE_LEVEL_##level)
+#define IREE_TRACE_MESSAGE_DYNAMIC_COLORED(color, value, value_length) \
+  iree_tracing_message_string_view(value, value_length, color)
+
+// Utilities:
+#define IREE_TRACE_IMPL_GET_VARIADIC_HELPER_(_1, _2, _3, NAME, ...) NAME
+#define IREE_TRACE_IMPL_GET_VARIADIC_(args) \
+  IREE_TRACE_IMPL_GET_VARIADIC_HELPER_ args
+
+#endif  // IREE_TRACING_FEATURE_INSTRUMENTATION
+
+//===----------------------------------------------------------------------===//
+// Instrumentation C++ RAII types, wrappers, and macros
+//===----------------------------------------------------------------------===//
+
+#ifdef __cplusplus
+
+#if IREE_TRACING_FEATURES & IREE_TRACING_FEATURE_INSTRUMENTATION
+
+namespace iree {
+
+class ScopedZone {
+ public:
+  ScopedZone(const ScopedZone&) = delete;
+  ScopedZone(ScopedZone&&) = delete;
+  ScopedZone& operator=(const ScopedZone&) = delete;
+  ScopedZone& operator=(ScopedZone&&) = delete;
+
+  IREE_ATTRIBUTE_ALWAYS_INLINE ScopedZone(
+      const iree_tracing_location_t* src_loc) {
+    zone_id_ = iree_tracing_zone_begin_impl(src_loc, NULL, 0);
+  }
+  IREE_ATTRIBUTE_ALWAYS_INLINE ~ScopedZone() { IREE_TRACE_ZONE_END(zone_id_); }
+
+  operator iree_zone_id_t() const noexcept { return zone_id_; }
+
+ private:
+  iree_zone_id_t zone_id_;
+};
+
+}  // namespace iree
+
+#define IREE_TRACE_SCOPE()                                         \
+  static constexpr iree_tracing_location_t IREE_TRACE_IMPL_CONCAT( \
+      __iree_tracing_source_location, __LINE__){                   \
+      nullptr,                                                     \
+      0,                                                           \
+      __FUNCTION__,                                                \
+      IREE_TRACE_STRLEN(__FUNCTION__),                             \
+      __FILE__,                                                    \
+      IREE_TRACE_STRLEN(__FILE__),                                 \
+      (uint32_t)__LINE__,                                          \
+      0};                                                          \
+  ::iree::ScopedZone ___iree_tracing_scoped_zone(                  \
+      &IREE_TRACE_IMPL_CONCAT(__iree_tracing_source_location, __LINE__))
+#define IREE_TRACE_SCOPE_NAMED(name_literal)                       \
+  static constexpr iree_tracing_location_t IREE_TRACE_IMPL_CONCAT( \
+      __iree_tracing_source_location, __LINE__){                   \
+      name_literal,       IREE_TRACE_STRLEN(name_literal),         \
+      __FUNCTION__,       IREE_TRACE_STRLEN(__FUNCTION__),         \
+      __FILE__,           IREE_TRACE_STRLEN(__FILE__),             \
+      (uint32_t)__LINE__, 0};                                      \
+  ::iree::ScopedZone ___iree_tracing_scoped_zone(                  \
+      &IREE_TRACE_IMPL_CONCAT(__iree_tracing_source_location, __LINE__))
+#define IREE_TRACE_SCOPE_ID ___iree_tracing_scoped_zone
+
+#endif  // IREE_TRACING_FEATURE_INSTRUMENTATION
+
+#endif  // __cplusplus
+
+#endif  // IREE_BASE_TRACING_RINGBUFFER_H_
@@ -0,0 +1,334 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "iree/base/api.h"
+#include "iree/testing/gtest.h"
+
+namespace {
+
+// Only meaningful when the ringbuffer provider is the one linked in; other
+// configurations build the test but skip it.
+#if defined(IREE_BASE_TRACING_RINGBUFFER_H_) && \
+    (IREE_TRACING_FEATURES & IREE_TRACING_FEATURE_INSTRUMENTATION)
+
+std::string GetTempPath(const char* name) {
+  const char* test_tmpdir = getenv("TEST_TMPDIR");
+  if (!test_tmpdir) test_tmpdir = getenv("TMPDIR");
+  if (!test_tmpdir) test_tmpdir = getenv("TEMP");
+  if (!test_tmpdir) test_tmpdir = "/tmp";
+  return std::string(test_tmpdir) + "/" + name;
+}
+
+std::string ReadFile(const std::string& path) {
+  std::ifstream file(path, std::ios::binary);
+  std::stringstream stream;
+  stream << file.rdbuf();
+  return stream.str();
+}
+
+// Minimal JSON value and parser covering what the dump emits. Parsing fails on
+// any syntax error so that torn or truncated output is caught.
+struct JsonValue {
+  enum class Type { kNull, kBool, kNumber, kString, kArray, kObject };
+  Type type = Type::kNull;
+  bool boolean = false;
+  double number = 0.0;
+  std::string string;
+  std::vector<JsonValue> array;
+  std::vector<std::pair<std::string, JsonValue>> object;
+
+  const JsonValue* Find(const char* key) const {
+    for (const auto& member : object) {
+      if (member.first == key) return &member.second;
+    }
+    return nullptr;
+  }
+};
+
+class JsonParser {
+ public:
+  explicit JsonParser(const std::string& text) : text_(text) {}
+
+  bool Parse(JsonValue* out_value) {
+    if (!ParseValue(out_value)) return false;
+    SkipWhitespace();
+    return offset_ == text_.size();
+  }
+
+ private:
+  void SkipWhitespace() {
+    while (offset_ < text_.size() &&
+           (text_[offset_] == ' ' || text_[offset_] == '\n' ||
+            text_[offset_] == '\r' || text_[offset_] == '\t')) {
+      ++offset_;
+    }
+  }
+
+  bool Consume(const char* literal) {
+    size_t length = strlen(literal);
+    if (text_.compare(offset_, length, literal) != 0) return false;
+    offset_ += length;
+    return true;
+  }
+
+  bool ParseString(std::string* out_string) {
+    if (!Consume("\"")) return false;
+    while (offset_ < text_.size()) {
+      char c = text_[offset_++];
+      if (c == '"') return true;
+      if (static_cast<unsigned char>(c) < 0x20) return false;
+      if (c != '\\') {
+        out_string->push_back(c);
+        continue;
+      }
+      if (offset_ >= text_.size()) return false;
+      c = text_[offset_++];
+      switch (c) {
+        case '"':
+        case '\\':
+        case '/':
+          out_string->push_back(c);
+          break;
+        case 'n':
+          out_string->push_back('\n');
+          break;
+        case 't':
+          out_string->push_back('\t');
+          break;
+        case 'u': {
+          if (offset_ + 4 > text_.size()) return false;
+          unsigned long code =
+              strtoul(text_.substr(offset_, 4).c_str(), nullptr, 16);
+          offset_ += 4;
+          // The dump only escapes control characters.
+          if (code >= 0x20) return false;
+          out_string->push_back(static_cast<char>(code));
+          break;
+        }
+        default:
+          return false;
+      }
+    }
+    return false;
+  }
+
+  bool ParseNumber(double* out_number) {
+    const char* begin = text_.c_str() + offset_;
+    char* end = nullptr;
+    *out_number = strtod(begin, &end);
+    if (end == begin) return false;
+    offset_ += end - begin;
+    return true;
+  }
+
+  bool ParseValue(JsonValue* out_value) {
+    SkipWhitespace();
+    if (offset_ >= text_.size()) return false;
+    char c = text_[offset_];
+    if (c == '{') {
+      ++offset_;
+      out_value->type = JsonValue::Type::kObject;
+      SkipWhitespace();
+      if (Consume("}")) return true;
+      do {
+        SkipWhitespace();
+        std::pair<std::string, JsonValue> member;
+        if (!ParseString(&member.first)) return false;
+        SkipWhitespace();
+        if (!Consume(":")) return false;
+        if (!ParseValue(&member.second)) return false;
+        out_value->object.push_back(std::move(member));
+        SkipWhitespace();
+      } while (Consume(","));
+      return Consume("}");
+    } else if (c == '[') {
+      ++offset_;
+      out_value->type = JsonValue::Type::kArray;
+      SkipWhitespace();
+      if (Consume("]")) return true;
+      do {
+        out_value->array.emplace_back();
+        if (!ParseValue(&out_value->array.back())) return false;
+        SkipWhitespace();
+      } while (Consume(","));
+      return Consume("]");
+    } else if (c == '"') {
+      out_value->type = JsonValue::Type::kString;
+      return ParseString(&out_value->string);
+    } else if (Consume("true")) {
+      out_value->type = JsonValue::Type::kBool;
+      out_value->boolean = true;
+      return true;
+    } else if (Consume("false")) {
+      out_value->type = JsonValue::Type::kBool;
+      return true;
+    } else if (Consume("null")) {
+      return true;
+    }
+    out_value->type = JsonValue::Type::kNumber;
+    return ParseNumber(&out_value->number);
+  }
+
+  const std::string& text_;
+  size_t offset_ = 0;
+};
+
+// Events of a single thread in a dump.
+struct ThreadEvents {
+  std::string name;
+  std::vector<const JsonValue*> events;
+};
+
+// Dumps all buffers to |path|, parses the result, and checks the invariants
+// that hold for any dump: every event is well formed and zone ends never
+// outnumber their begins on a thread.
+void DumpAndParse(const std::string& path, JsonValue* out_root,
+                  std::map<uint64_t, ThreadEvents>* out_threads) {
+  ASSERT_TRUE(iree_tracing_ringbuffer_dump(path.c_str()));
+  std::string text = ReadFile(path);
+  remove(path.c_str());
+  ASSERT_TRUE(JsonParser(text).Parse(out_root)) << text;
+  ASSERT_EQ(out_root->type, JsonValue::Type::kObject);
+  const JsonValue* trace_events = out_root->Find("traceEvents");
+  ASSERT_NE(trace_events, nullptr);
+  ASSERT_EQ(trace_events->type, JsonValue::Type::kArray);
+
+  std::map<uint64_t, int> depths;
+  std::map<uint64_t, double> last_timestamps;
+  for (const JsonValue& event : trace_events->array) {
+    ASSERT_EQ(event.type, JsonValue::Type::kObject);
+    const JsonValue* phase = event.Find("ph");
+    const JsonValue* tid = event.Find("tid");
+    ASSERT_NE(phase, nullptr);
+    ASSERT_NE(tid, nullptr);
+    ASSERT_NE(event.Find("pid"), nullptr);
+    uint64_t thread_id = static_cast<uint64_t>(tid->number);
+    ThreadEvents& thread = (*out_threads)[thread_id];
+    if (phase->string == "M") {
+      thread.name = event.Find("args")->Find("name")->string;
+      continue;
+    }
+    const JsonValue* ts = event.Find("ts");
+    ASSERT_NE(ts, nullptr);
+    EXPECT_GE(ts->number, last_timestamps[thread_id]);
+    last_timestamps[thread_id] = ts->number;
+    if (phase->string == "B") {
+      ++depths[thread_id];
+    } else if (phase->string == "E") {
+      ASSERT_GT(depths[thread_id], 0);
+      --depths[thread_id];
+    }
+    thread.events.push_back(&event);
+  }
+}
+
+// Records zones, plots, and messages from several threads while dumping
+// concurrently and then checks that the final dump contains every event of
+// every thread in order.
+TEST(RingbufferTest, MultithreadedRecordAndDump) {
+  constexpr int kThreadCount = 4;
+  // Six events per iteration stays well within a single thread's capacity so
+  // that nothing is overwritten by the time of the final dump.
+  constexpr int kIterationCount = 200;
+  static_assert(kIterationCount * 6 < IREE_TRACING_RINGBUFFER_CAPACITY,
+                "events must not wrap");
+
+  std::atomic<bool> start = {false};
+  std::atomic<int> finished_count = {0};
+  std::vector<std::thread> threads;
+  for (int i = 0; i < kThreadCount; ++i) {
+    threads.emplace_back([&, i]() {
+      std::string thread_name = "ringbuffer_test_" + std::to_string(i);
+      IREE_TRACE_SET_THREAD_NAME(thread_name.c_str());
+      while (!start.load()) std::this_thread::yield();
+      for (int j = 0; j < kIterationCount; ++j) {
+        IREE_TRACE_ZONE_BEGIN_NAMED(z0, "outer");
+        std::string inner_name = "inner_" + std::to_string(i);
+        IREE_TRACE_ZONE_BEGIN_NAMED_DYNAMIC(z1, inner_name.data(),
+                                            inner_name.size());
+        IREE_TRACE_PLOT_VALUE_I64("ringbuffer_test_plot", j);
+        static const char kMessage[] = "say \"hi\"\n";
+        IREE_TRACE_MESSAGE_DYNAMIC(INFO, kMessage, sizeof(kMessage) - 1);
+        IREE_TRACE_ZONE_END(z1);
+        IREE_TRACE_ZONE_END(z0);
+      }
+      ++finished_count;
+    });
+  }
+
+  // Dumps taken while the threads are recording must still be valid.
+  start = true;
+  while (finished_count.load() < kThreadCount) {
+    JsonValue root;
+    std::map<uint64_t, ThreadEvents> thread_events;
+    DumpAndParse(GetTempPath("ringbuffer_test_concurrent.json"), &root,
+                 &thread_events);
+    if (HasFatalFailure()) break;
+  }
+  for (auto& thread : threads) thread.join();
+  ASSERT_FALSE(HasFatalFailure());
+
+  JsonValue root;
+  std::map<uint64_t, ThreadEvents> thread_events;
+  DumpAndParse(GetTempPath("ringbuffer_test.json"), &root, &thread_events);
+  ASSERT_FALSE(HasFatalFailure());
+
+  int found_thread_count = 0;
+  for (const auto& it : thread_events) {
+    const ThreadEvents& thread = it.second;
+    if (thread.name.rfind("ringbuffer_test_", 0) != 0) continue;
+    ++found_thread_count;
+    std::string inner_name =
+        "inner_" + thread.name.substr(strlen("ringbuffer_test_"));
+    ASSERT_EQ(thread.events.size(), kIterationCount * 6u) << thread.name;
+    for (int j = 0; j < kIterationCount; ++j) {
+      const JsonValue* const* events = &thread.events[j * 6];
+      EXPECT_EQ(events[0]->Find("ph")->string, "B");
+      EXPECT_EQ(events[0]->Find("name")->string, "outer");
+      EXPECT_EQ(events[0]->Find("args")->Find("file")->string,
+                "ringbuffer_test.cc");
+      EXPECT_EQ(events[1]->Find("ph")->string, "B");
+      EXPECT_EQ(events[1]->Find("name")->string, inner_name);
+      EXPECT_EQ(events[2]->Find("ph")->string, "C");
+      EXPECT_EQ(events[2]->Find("name")->string, "ringbuffer_test_plot");
+      EXPECT_EQ(events[2]->Find("args")->Find("value")->number, j);
+      EXPECT_EQ(events[3]->Find("ph")->string, "i");
+      EXPECT_EQ(events[3]->Find("name")->string, "say \"hi\"\n");
+      EXPECT_EQ(events[4]->Find("ph")->string, "E");
+      EXPECT_EQ(events[5]->Find("ph")->string, "E");
+    }
+  }
+  EXPECT_EQ(found_thread_count, kThreadCount);
+}
+
+TEST(RingbufferTest, DumpToInvalidPathFails) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_END(z0);
+  EXPECT_FALSE(iree_tracing_ringbuffer_dump(
+      GetTempPath("does_not_exist/ringbuffer_test.json").c_str()));
+}
+
+#else
+
+TEST(RingbufferTest, Disabled) {
+  GTEST_SKIP() << "ringbuffer tracing provider not enabled";
+}
+
+#endif  // IREE_BASE_TRACING_RINGBUFFER_H_
+
+}  // namespace
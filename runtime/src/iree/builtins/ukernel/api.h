@@ -7,9 +7,14 @@
 #ifndef IREE_BUILTINS_UKERNEL_API_H_
 #define IREE_BUILTINS_UKERNEL_API_H_
 
+#include "iree/builtins/ukernel/batch_mmt4d.h"
+#include "iree/builtins/ukernel/layernorm.h"
 #include "iree/builtins/ukernel/mmt4d.h"
 #include "iree/builtins/ukernel/pack.h"
+#include "iree/builtins/ukernel/pack_mmt4d.h"
 #include "iree/builtins/ukernel/query_tile_sizes.h"
+#include "iree/builtins/ukernel/reduce.h"
+#include "iree/builtins/ukernel/softmax.h"
 #include "iree/builtins/ukernel/unpack.h"
 
 #endif  // IREE_BUILTINS_UKERNEL_API_H_
@@ -188,4 +188,121 @@ static inline void iree_uk_neon_copy_8x8xi8_transpose_strided_to_unstrided(
                                                         in_stride);
 }
 
+static inline void iree_uk_neon_copy_8x1xi16_strided_to_unstrided(
+    iree_uk_int8_t* IREE_UK_RESTRICT out_ptr,
+    const iree_uk_int8_t* IREE_UK_RESTRICT in_ptr, iree_uk_index_t in_stride) {
+  int16x8_t v = vdupq_n_s16(0);
+  v = vld1q_lane_s16((const iree_uk_int16_t*)(in_ptr + 0 * in_stride), v, 0);
+  v = vld1q_lane_s16((const iree_uk_int16_t*)(in_ptr + 1 * in_stride), v, 1);
+  v = vld1q_lane_s16((const iree_uk_int16_t*)(in_ptr + 2 * in_stride), v, 2);
+  v = vld1q_lane_s16((const iree_uk_int16_t*)(in_ptr + 3 * in_stride), v, 3);
+  v = vld1q_lane_s16((const iree_uk_int16_t*)(in_ptr + 4 * in_stride), v, 4);
+  v = vld1q_lane_s16((const iree_uk_int16_t*)(in_ptr + 5 * in_stride), v, 5);
+  v = vld1q_lane_s16((const iree_uk_int16_t*)(in_ptr + 6 * in_stride), v, 6);
+  v = vld1q_lane_s16((const iree_uk_int16_t*)(in_ptr + 7 * in_stride), v, 7);
+  vst1q_s16((iree_uk_int16_t*)out_ptr, v);
+}
+
+static inline void iree_uk_neon_copy_8x16xi8_strided_to_strided(
+    iree_uk_int8_t* IREE_UK_RESTRICT out_ptr,
+    const iree_uk_int8_t* IREE_UK_RESTRICT in_ptr, iree_uk_index_t out_stride,
+    iree_uk_index_t in_stride) {
+  for (int i = 0; i < 8; ++i) {
+    vst1q_s8(out_ptr + i * out_stride, vld1q_s8(in_ptr + i * in_stride));
+  }
+}
+
+// Transposes a 4x4 tile of 32-bit elements. Strides are in bytes.
+static inline void iree_uk_neon_copy_4x4xi32_transpose_strided_to_strided(
+    iree_uk_int8_t* IREE_UK_RESTRICT out_ptr,
+    const iree_uk_int8_t* IREE_UK_RESTRICT in_ptr, iree_uk_index_t out_stride,
+    iree_uk_index_t in_stride) {
+  int32x4_t r0 = vld1q_s32((const iree_uk_int32_t*)(in_ptr + 0 * in_stride));
+  int32x4_t r1 = vld1q_s32((const iree_uk_int32_t*)(in_ptr + 1 * in_stride));
+  int32x4_t r2 = vld1q_s32((const iree_uk_int32_t*)(in_ptr + 2 * in_stride));
+  int32x4_t r3 = vld1q_s32((const iree_uk_int32_t*)(in_ptr + 3 * in_stride));
+  int32x4x2_t t01 = vtrnq_s32(r0, r1);
+  int32x4x2_t t23 = vtrnq_s32(r2, r3);
+  vst1q_s32((iree_uk_int32_t*)(out_ptr + 0 * out_stride),
+            vcombine_s32(vget_low_s32(t01.val[0]), vget_low_s32(t23.val[0])));
+  vst1q_s32((iree_uk_int32_t*)(out_ptr + 1 * out_stride),
+            vcombine_s32(vget_low_s32(t01.val[1]), vget_low_s32(t23.val[1])));
+  vst1q_s32((iree_uk_int32_t*)(out_ptr + 2 * out_stride),
+            vcombine_s32(vget_high_s32(t01.val[0]), vget_high_s32(t23.val[0])));
+  vst1q_s32((iree_uk_int32_t*)(out_ptr + 3 * out_stride),
+            vcombine_s32(vget_high_s32(t01.val[1]), vget_high_s32(t23.val[1])));
+}
+
+// Transposes a 8x8 tile of 32-bit elements. Strides are in bytes.
+static inline void iree_uk_neon_copy_8x8xi32_transpose_strided_to_strided(
+    iree_uk_int8_t* IREE_UK_RESTRICT out_ptr,
+    const iree_uk_int8_t* IREE_UK_RESTRICT in_ptr, iree_uk_index_t out_stride,
+    iree_uk_index_t in_stride) {
+  for (int i = 0; i < 2; ++i) {
+    for (int j = 0; j < 2; ++j) {
+      iree_uk_neon_copy_4x4xi32_transpose_strided_to_strided(
+          out_ptr + 4 * j * out_stride + 16 * i,
+          in_ptr + 4 * i * in_stride + 16 * j, out_stride, in_stride);
+    }
+  }
+}
+
+// Transposes a 8x8 tile of 16-bit elements. Strides are in bytes.
+static inline void iree_uk_neon_copy_8x8xi16_transpose_strided_to_strided(
+    iree_uk_int8_t* IREE_UK_RESTRICT out_ptr,
+    const iree_uk_int8_t* IREE_UK_RESTRICT in_ptr, iree_uk_index_t out_stride,
+    iree_uk_index_t in_stride) {
+  int16x8_t r[8];
+  for (int i = 0; i < 8; ++i) {
+    r[i] = vld1q_s16((const iree_uk_int16_t*)(in_ptr + i * in_stride));
+  }
+  // a[k].val[0] holds columns 0..3 of rows 2k, 2k+1 and val[1] columns 4..7.
+  int32x4x2_t a[4];
+  for (int i = 0; i < 4; ++i) {
+    a[i] = iree_uk_neon_zip_8xi16_as_4xi32(r[2 * i], r[2 * i + 1]);
+  }
+  // b[2k+h].val[j] holds columns 4h+2j, 4h+2j+1 of rows 4k..4k+3.
+  int64x2x2_t b[4];
+  for (int i = 0; i < 2; ++i) {
+    for (int h = 0; h < 2; ++h) {
+      b[2 * i + h] =
+          iree_uk_neon_zip_4xi32_as_2xi64(a[2 * i].val[h], a[2 * i + 1].val[h]);
+    }
+  }
+  for (int h = 0; h < 2; ++h) {
+    for (int j = 0; j < 2; ++j) {
+      int64x2_t lo = b[h].val[j];
+      int64x2_t hi = b[2 + h].val[j];
+      iree_uk_int8_t* out_col = out_ptr + (4 * h + 2 * j) * out_stride;
+      vst1q_s8(out_col, vreinterpretq_s8_s64(
+                            vcombine_s64(vget_low_s64(lo), vget_low_s64(hi))));
+      vst1q_s8(out_col + out_stride,
+               vreinterpretq_s8_s64(
+                   vcombine_s64(vget_high_s64(lo), vget_high_s64(hi))));
+    }
+  }
+}
+
+// Vectorized iree_uk_exp_f32. See the IREE_UK_EXP_F32_* constants in common.h.
+static inline float32x4_t iree_uk_neon_exp_f32(float32x4_t x) {
+  uint32x4_t underflow = vcltq_f32(x, vdupq_n_f32(IREE_UK_EXP_F32_MIN_INPUT));
+  x = vminq_f32(x, vdupq_n_f32(IREE_UK_EXP_F32_MAX_INPUT));
+  x = vmaxq_f32(x, vdupq_n_f32(IREE_UK_EXP_F32_MIN_INPUT));
+  float32x4_t n = vrndnq_f32(vmulq_n_f32(x, IREE_UK_EXP_F32_LOG2E));
+  float32x4_t r = vfmsq_n_f32(x, n, IREE_UK_EXP_F32_LN2_HI);
+  r = vfmsq_n_f32(r, n, IREE_UK_EXP_F32_LN2_LO);
+  float32x4_t p = vdupq_n_f32(IREE_UK_EXP_F32_P0);
+  p = vfmaq_f32(vdupq_n_f32(IREE_UK_EXP_F32_P1), p, r);
+  p = vfmaq_f32(vdupq_n_f32(IREE_UK_EXP_F32_P2), p, r);
+  p = vfmaq_f32(vdupq_n_f32(IREE_UK_EXP_F32_P3), p, r);
+  p = vfmaq_f32(vdupq_n_f32(IREE_UK_EXP_F32_P4), p, r);
+  p = vfmaq_f32(vdupq_n_f32(IREE_UK_EXP_F32_P5), p, r);
+  float32x4_t y = vfmaq_f32(r, p, vmulq_f32(r, r));
+  y = vaddq_f32(y, vdupq_n_f32(1.0f));
+  int32x4_t pow2n =
+      vshlq_n_s32(vaddq_s32(vcvtq_s32_f32(n), vdupq_n_s32(127)), 23);
+  y = vmulq_f32(y, vreinterpretq_f32_s32(pow2n));
+  return vreinterpretq_f32_u32(vbicq_u32(vreinterpretq_u32_f32(y), underflow));
+}
+
 #endif  // IREE_BUILTINS_UKERNEL_ARCH_ARM_64_COMMON_ARM_64_H_
@@ -0,0 +1,67 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/builtins/ukernel/arch/arm_64/common_arm_64.h"
+#include "iree/builtins/ukernel/arch/arm_64/layernorm_arm_64_internal.h"
+
+void iree_uk_layernorm_tile_f32f32_arm_64(
+    void* out_ptr, const void* in_ptr, const void* IREE_UK_RESTRICT gamma_ptr,
+    const void* IREE_UK_RESTRICT beta_ptr, iree_uk_index_t size,
+    float epsilon) {
+  const float* in = in_ptr;
+  float* out = out_ptr;
+  const float* gamma = gamma_ptr;
+  const float* beta = beta_ptr;
+  iree_uk_index_t j = 0;
+  float32x4_t sum_v = vdupq_n_f32(0.0f);
+  for (; j + 4 <= size; j += 4) sum_v = vaddq_f32(sum_v, vld1q_f32(in + j));
+  float sum = vaddvq_f32(sum_v);
+  for (; j < size; ++j) sum += in[j];
+  float mean = sum / size;
+  float32x4_t mean_v = vdupq_n_f32(mean);
+  float32x4_t sum_sq_v = vdupq_n_f32(0.0f);
+  for (j = 0; j + 4 <= size; j += 4) {
+    float32x4_t d = vsubq_f32(vld1q_f32(in + j), mean_v);
+    sum_sq_v = vfmaq_f32(sum_sq_v, d, d);
+  }
+  float sum_sq = vaddvq_f32(sum_sq_v);
+  for (; j < size; ++j) {
+    float d = in[j] - mean;
+    sum_sq += d * d;
+  }
+  float inv_stddev = 1.0f / iree_uk_sqrt_f32(sum_sq / size + epsilon);
+  for (j = 0; j + 4 <= size; j += 4) {
+    float32x4_t d = vsubq_f32(vld1q_f32(in + j), mean_v);
+    float32x4_t g = vmulq_n_f32(vld1q_f32(gamma + j), inv_stddev);
+    vst1q_f32(out + j, vfmaq_f32(vld1q_f32(beta + j), d, g));
+  }
+  for (; j < size; ++j) {
+    out[j] = (in[j] - mean) * inv_stddev * gamma[j] + beta[j];
+  }
+}
+
+void iree_uk_layernorm_tile_f32f32_rms_arm_64(
+    void* out_ptr, const void* in_ptr, const void* IREE_UK_RESTRICT gamma_ptr,
+    const void* IREE_UK_RESTRICT beta_ptr, iree_uk_index_t size,
+    float epsilon) {
+  const float* in = in_ptr;
+  float* out = out_ptr;
+  const float* gamma = gamma_ptr;
+  iree_uk_index_t j = 0;
+  float32x4_t sum_sq_v = vdupq_n_f32(0.0f);
+  for (; j + 4 <= size; j += 4) {
+    float32x4_t x = vld1q_f32(in + j);
+    sum_sq_v = vfmaq_f32(sum_sq_v, x, x);
+  }
+  float sum_sq = vaddvq_f32(sum_sq_v);
+  for (; j < size; ++j) sum_sq += in[j] * in[j];
+  float inv_rms = 1.0f / iree_uk_sqrt_f32(sum_sq / size + epsilon);
+  for (j = 0; j + 4 <= size; j += 4) {
+    float32x4_t g = vmulq_n_f32(vld1q_f32(gamma + j), inv_rms);
+    vst1q_f32(out + j, vmulq_f32(vld1q_f32(in + j), g));
+  }
+  for (; j < size; ++j) out[j] = in[j] * inv_rms * gamma[j];
+}
@@ -0,0 +1,16 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/builtins/ukernel/arch/arm_64/common_arm_64_entry_point.h"
+#include "iree/builtins/ukernel/arch/arm_64/layernorm_arm_64_internal.h"
+
+iree_uk_layernorm_tile_func_t iree_uk_layernorm_select_tile_func_arch(
+    const iree_uk_layernorm_params_t* params) {
+  // Currently f32f32 is the only supported type.
+  return (params->flags & IREE_UK_FLAG_LAYERNORM_RMS)
+             ? iree_uk_layernorm_tile_f32f32_rms_arm_64
+             : iree_uk_layernorm_tile_f32f32_arm_64;
+}
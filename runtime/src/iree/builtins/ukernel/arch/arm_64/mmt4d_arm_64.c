@@ -94,6 +94,62 @@ void iree_uk_mmt4d_tile_f32f32f32_8x8x1_arm_64(
   vst1q_f32(out_ptr + 4 * 15, acc15);
 }
 
+// Narrow-M counterpart of the 8x8x1 tile function, for M0 = 1, 2 or 4. It is
+// always inlined into the variants below so that M0 is a compile-time constant
+// and the loops over it unroll with the accumulators kept in registers.
+static inline IREE_UK_ATTRIBUTE_ALWAYS_INLINE void
+iree_uk_mmt4d_tile_f32f32f32_Mx8x1_arm_64(
+    void* IREE_UK_RESTRICT out_tile, const void* IREE_UK_RESTRICT lhs_panel,
+    const void* IREE_UK_RESTRICT rhs_panel,
+    const iree_uk_mmt4d_params_t* params, int M0) {
+  IREE_UK_ASSUME(M0 >= 1 && M0 <= 4);
+  const float* IREE_UK_RESTRICT lhs_ptr = lhs_panel;
+  const float* IREE_UK_RESTRICT rhs_ptr = rhs_panel;
+  float* IREE_UK_RESTRICT out_ptr = out_tile;
+  float32x4_t acc[8];
+  if (params->flags & IREE_UK_FLAG_MMT4D_ACCUMULATE) {
+    for (int i = 0; i < 2 * M0; ++i) acc[i] = vld1q_f32(out_ptr + 4 * i);
+  } else {
+    for (int i = 0; i < 2 * M0; ++i) acc[i] = vdupq_n_f32(0);
+  }
+  IREE_UK_ASSUME(params->K >= 1);
+  for (int k = 0; k < params->K; ++k) {
+    float32x4_t rhs0 = vld1q_f32(rhs_ptr + 0);
+    float32x4_t rhs1 = vld1q_f32(rhs_ptr + 4);
+    rhs_ptr += 8;
+    for (int i = 0; i < M0; ++i) {
+      acc[2 * i + 0] = vfmaq_n_f32(acc[2 * i + 0], rhs0, lhs_ptr[i]);
+      acc[2 * i + 1] = vfmaq_n_f32(acc[2 * i + 1], rhs1, lhs_ptr[i]);
+    }
+    lhs_ptr += M0;
+  }
+  for (int i = 0; i < 2 * M0; ++i) vst1q_f32(out_ptr + 4 * i, acc[i]);
+}
+
+void iree_uk_mmt4d_tile_f32f32f32_1x8x1_arm_64(
+    void* IREE_UK_RESTRICT out_tile, const void* IREE_UK_RESTRICT lhs_panel,
+    const void* IREE_UK_RESTRICT rhs_panel,
+    const iree_uk_mmt4d_params_t* params) {
+  iree_uk_mmt4d_tile_f32f32f32_Mx8x1_arm_64(out_tile, lhs_panel, rhs_panel,
+                                           params, 1);
+}
+
+void iree_uk_mmt4d_tile_f32f32f32_2x8x1_arm_64(
+    void* IREE_UK_RESTRICT out_tile, const void* IREE_UK_RESTRICT lhs_panel,
+    const void* IREE_UK_RESTRICT rhs_panel,
+    const iree_uk_mmt4d_params_t* params) {
+  iree_uk_mmt4d_tile_f32f32f32_Mx8x1_arm_64(out_tile, lhs_panel, rhs_panel,
+                                           params, 2);
+}
+
+void iree_uk_mmt4d_tile_f32f32f32_4x8x1_arm_64(
+    void* IREE_UK_RESTRICT out_tile, const void* IREE_UK_RESTRICT lhs_panel,
+    const void* IREE_UK_RESTRICT rhs_panel,
+    const iree_uk_mmt4d_params_t* params) {
+  iree_uk_mmt4d_tile_f32f32f32_Mx8x1_arm_64(out_tile, lhs_panel, rhs_panel,
+                                           params, 4);
+}
+
 // Shared implementation for f16f16f16 and f16f16f32.
 // In the f16f16f16 case, intermediate roundings are skipped. This function
 // should only be used if IREE_UK_FLAG_MMT4D_SKIP_INTERMEDIATE_ROUNDINGS is set.
@@ -325,3 +381,178 @@ void iree_uk_mmt4d_tile_i8i8i32_8x8x1_arm_64(
   vst1q_s32(out_ptr + 4 * 14, acc14);
   vst1q_s32(out_ptr + 4 * 15, acc15);
 }
+
+// Loads the 8 RHS elements for one k-step of a 8x8x1 tile of a weight-only
+// quantized type as int8. int4 elements are packed two per byte, with the
+// even-indexed element in the low nibble.
+static inline int8x8_t iree_uk_mmt4d_load_rhs_8xiXX_as_8xi8_arm_64(
+    const iree_uk_int8_t* IREE_UK_RESTRICT rhs_ptr, iree_uk_type_t rhs_type) {
+  if (rhs_type == IREE_UK_TYPE_INT_8) {
+    return vld1_s8(rhs_ptr);
+  }
+  iree_uk_uint32_t packed;
+  iree_uk_memcpy(&packed, rhs_ptr, sizeof packed);
+  int8x8_t bytes = vreinterpret_s8_u32(vdup_n_u32(packed));
+  int8x8_t lo = vshr_n_s8(vshl_n_s8(bytes, 4), 4);
+  int8x8_t hi = vshr_n_s8(bytes, 4);
+  return vzip1_s8(lo, hi);
+}
+
+// Shared implementation for the weight-only quantized types
+// f32|f16 * dequant(i8|i4) -> f32. The RHS is dequantized in registers and
+// scaled before being multiplied with the LHS, so that the scales are applied
+// once per RHS element rather than once per product.
+static inline void iree_uk_mmt4d_tile_fXXiXXf32_8x8x1_arm_64(
+    void* IREE_UK_RESTRICT out_tile, const void* IREE_UK_RESTRICT lhs_panel,
+    const void* IREE_UK_RESTRICT rhs_panel,
+    const float* IREE_UK_RESTRICT rhs_scales_panel, iree_uk_int32_t group_size,
+    const iree_uk_mmt4d_params_t* params, iree_uk_type_t lhs_type,
+    iree_uk_type_t rhs_type) {
+  const float* IREE_UK_RESTRICT lhs_f32_ptr = lhs_panel;
+  const float16_t* IREE_UK_RESTRICT lhs_f16_ptr = lhs_panel;
+  const iree_uk_int8_t* IREE_UK_RESTRICT rhs_ptr = rhs_panel;
+  const float* IREE_UK_RESTRICT scales_ptr = rhs_scales_panel;
+  float* IREE_UK_RESTRICT out_ptr = out_tile;
+  const int rhs_tile_bytes = rhs_type == IREE_UK_TYPE_INT_8 ? 8 : 4;
+  float32x4_t acc0, acc1, acc2, acc3, acc4, acc5, acc6, acc7, acc8, acc9, acc10,
+      acc11, acc12, acc13, acc14, acc15;
+  if (params->flags & IREE_UK_FLAG_MMT4D_ACCUMULATE) {
+    acc0 = vld1q_f32(out_ptr + 4 * 0);
+    acc1 = vld1q_f32(out_ptr + 4 * 1);
+    acc2 = vld1q_f32(out_ptr + 4 * 2);
+    acc3 = vld1q_f32(out_ptr + 4 * 3);
+    acc4 = vld1q_f32(out_ptr + 4 * 4);
+    acc5 = vld1q_f32(out_ptr + 4 * 5);
+    acc6 = vld1q_f32(out_ptr + 4 * 6);
+    acc7 = vld1q_f32(out_ptr + 4 * 7);
+    acc8 = vld1q_f32(out_ptr + 4 * 8);
+    acc9 = vld1q_f32(out_ptr + 4 * 9);
+    acc10 = vld1q_f32(out_ptr + 4 * 10);
+    acc11 = vld1q_f32(out_ptr + 4 * 11);
+    acc12 = vld1q_f32(out_ptr + 4 * 12);
+    acc13 = vld1q_f32(out_ptr + 4 * 13);
+    acc14 = vld1q_f32(out_ptr + 4 * 14);
+    acc15 = vld1q_f32(out_ptr + 4 * 15);
+  } else {
+    acc0 = vdupq_n_f32(0);
+    acc1 = vdupq_n_f32(0);
+    acc2 = vdupq_n_f32(0);
+    acc3 = vdupq_n_f32(0);
+    acc4 = vdupq_n_f32(0);
+    acc5 = vdupq_n_f32(0);
+    acc6 = vdupq_n_f32(0);
+    acc7 = vdupq_n_f32(0);
+    acc8 = vdupq_n_f32(0);
+    acc9 = vdupq_n_f32(0);
+    acc10 = vdupq_n_f32(0);
+    acc11 = vdupq_n_f32(0);
+    acc12 = vdupq_n_f32(0);
+    acc13 = vdupq_n_f32(0);
+    acc14 = vdupq_n_f32(0);
+    acc15 = vdupq_n_f32(0);
+  }
+  // K0 == 1 so each k-step is one element of the group.
+  float32x4_t scales0 = vld1q_f32(scales_ptr + 0);
+  float32x4_t scales1 = vld1q_f32(scales_ptr + 4);
+  iree_uk_int32_t group_remaining = group_size;
+  IREE_UK_ASSUME(params->K >= 1);
+  for (int k = 0; k < params->K; ++k) {
+    if (group_remaining == 0) {
+      scales_ptr += 8;
+      scales0 = vld1q_f32(scales_ptr + 0);
+      scales1 = vld1q_f32(scales_ptr + 4);
+      group_remaining = group_size;
+    }
+    --group_remaining;
+    float32x4_t lhs0, lhs1;
+    if (lhs_type == IREE_UK_TYPE_FLOAT_32) {
+      lhs0 = vld1q_f32(lhs_f32_ptr + 0);
+      lhs1 = vld1q_f32(lhs_f32_ptr + 4);
+      lhs_f32_ptr += 8;
+    } else {
+      lhs0 = vcvt_f32_f16(vld1_f16(lhs_f16_ptr + 0));
+      lhs1 = vcvt_f32_f16(vld1_f16(lhs_f16_ptr + 4));
+      lhs_f16_ptr += 8;
+    }
+    int8x8_t rhs_i8 =
+        iree_uk_mmt4d_load_rhs_8xiXX_as_8xi8_arm_64(rhs_ptr, rhs_type);
+    int16x8_t rhs_i16 = vmovl_s8(rhs_i8);
+    rhs_ptr += rhs_tile_bytes;
+    float32x4_t rhs0 =
+        vmulq_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16(rhs_i16))), scales0);
+    float32x4_t rhs1 =
+        vmulq_f32(vcvtq_f32_s32(vmovl_high_s16(rhs_i16)), scales1);
+    acc0 = vfmaq_lane_f32(acc0, rhs0, vget_low_f32(lhs0), 0);
+    acc1 = vfmaq_lane_f32(acc1, rhs1, vget_low_f32(lhs0), 0);
+    acc2 = vfmaq_lane_f32(acc2, rhs0, vget_low_f32(lhs0), 1);
+    acc3 = vfmaq_lane_f32(acc3, rhs1, vget_low_f32(lhs0), 1);
+    acc4 = vfmaq_lane_f32(acc4, rhs0, vget_high_f32(lhs0), 0);
+    acc5 = vfmaq_lane_f32(acc5, rhs1, vget_high_f32(lhs0), 0);
+    acc6 = vfmaq_lane_f32(acc6, rhs0, vget_high_f32(lhs0), 1);
+    acc7 = vfmaq_lane_f32(acc7, rhs1, vget_high_f32(lhs0), 1);
+    acc8 = vfmaq_lane_f32(acc8, rhs0, vget_low_f32(lhs1), 0);
+    acc9 = vfmaq_lane_f32(acc9, rhs1, vget_low_f32(lhs1), 0);
+    acc10 = vfmaq_lane_f32(acc10, rhs0, vget_low_f32(lhs1), 1);
+    acc11 = vfmaq_lane_f32(acc11, rhs1, vget_low_f32(lhs1), 1);
+    acc12 = vfmaq_lane_f32(acc12, rhs0, vget_high_f32(lhs1), 0);
+    acc13 = vfmaq_lane_f32(acc13, rhs1, vget_high_f32(lhs1), 0);
+    acc14 = vfmaq_lane_f32(acc14, rhs0, vget_high_f32(lhs1), 1);
+    acc15 = vfmaq_lane_f32(acc15, rhs1, vget_high_f32(lhs1), 1);
+  }
+  vst1q_f32(out_ptr + 4 * 0, acc0);
+  vst1q_f32(out_ptr + 4 * 1, acc1);
+  vst1q_f32(out_ptr + 4 * 2, acc2);
+  vst1q_f32(out_ptr + 4 * 3, acc3);
+  vst1q_f32(out_ptr + 4 * 4, acc4);
+  vst1q_f32(out_ptr + 4 * 5, acc5);
+  vst1q_f32(out_ptr + 4 * 6, acc6);
+  vst1q_f32(out_ptr + 4 * 7, acc7);
+  vst1q_f32(out_ptr + 4 * 8, acc8);
+  vst1q_f32(out_ptr + 4 * 9, acc9);
+  vst1q_f32(out_ptr + 4 * 10, acc10);
+  vst1q_f32(out_ptr + 4 * 11, acc11);
+  vst1q_f32(out_ptr + 4 * 12, acc12);
+  vst1q_f32(out_ptr + 4 * 13, acc13);
+  vst1q_f32(out_ptr + 4 * 14, acc14);
+  vst1q_f32(out_ptr + 4 * 15, acc15);
+}
+
+void iree_uk_mmt4d_tile_f32i8f32_8x8x1_arm_64(
+    void* IREE_UK_RESTRICT out_tile, const void* IREE_UK_RESTRICT lhs_panel,
+    const void* IREE_UK_RESTRICT rhs_panel,
+    const float* IREE_UK_RESTRICT rhs_scales_panel, iree_uk_int32_t group_size,
+    const iree_uk_mmt4d_params_t* params) {
+  iree_uk_mmt4d_tile_fXXiXXf32_8x8x1_arm_64(
+      out_tile, lhs_panel, rhs_panel, rhs_scales_panel, group_size, params,
+      IREE_UK_TYPE_FLOAT_32, IREE_UK_TYPE_INT_8);
+}
+
+void iree_uk_mmt4d_tile_f32i4f32_8x8x1_arm_64(
+    void* IREE_UK_RESTRICT out_tile, const void* IREE_UK_RESTRICT lhs_panel,
+    const void* IREE_UK_RESTRICT rhs_panel,
+    const float* IREE_UK_RESTRICT rhs_scales_panel, iree_uk_int32_t group_size,
+    const iree_uk_mmt4d_params_t* params) {
+  iree_uk_mmt4d_tile_fXXiXXf32_8x8x1_arm_64(
+      out_tile, lhs_panel, rhs_panel, rhs_scales_panel, group_size, params,
+      IREE_UK_TYPE_FLOAT_32, IREE_UK_TYPE_INT_4);
+}
+
+void iree_uk_mmt4d_tile_f16i8f32_8x8x1_arm_64(
+    void* IREE_UK_RESTRICT out_tile, const void* IREE_UK_RESTRICT lhs_panel,
+    const void* IREE_UK_RESTRICT rhs_panel,
+    const float* IREE_UK_RESTRICT rhs_scales_panel, iree_uk_int32_t group_size,
+    const iree_uk_mmt4d_params_t* params) {
+  iree_uk_mmt4d_tile_fXXiXXf32_8x8x1_arm_64(
+      out_tile, lhs_panel, rhs_panel, rhs_scales_panel, group_size, params,
+      IREE_UK_TYPE_FLOAT_16, IREE_UK_TYPE_INT_8);
+}
+
+void iree_uk_mmt4d_tile_f16i4f32_8x8x1_arm_64(
+    void* IREE_UK_RESTRICT out_tile, const void* IREE_UK_RESTRICT lhs_panel,
+    const void* IREE_UK_RESTRICT rhs_panel,
+    const float* IREE_UK_RESTRICT rhs_scales_panel, iree_uk_int32_t group_size,
+    const iree_uk_mmt4d_params_t* params) {
+  iree_uk_mmt4d_tile_fXXiXXf32_8x8x1_arm_64(
+      out_tile, lhs_panel, rhs_panel, rhs_scales_panel, group_size, params,
+      IREE_UK_TYPE_FLOAT_16, IREE_UK_TYPE_INT_4);
+}
@@ -36,10 +36,19 @@ iree_uk_mmt4d_select_tile_func_arm_64_i8i8i32_8x8x4(
 static iree_uk_mmt4d_tile_func_t
 iree_uk_mmt4d_select_tile_func_arm_64_f32f32f32(
     const iree_uk_mmt4d_params_t* params) {
-  if (params->M0 == 8 && params->N0 == 8 && params->K0 == 1) {
-    return iree_uk_mmt4d_tile_f32f32f32_8x8x1_arm_64;
+  if (params->N0 != 8 || params->K0 != 1) return 0;
+  switch (params->M0) {
+    case 1:
+      return iree_uk_mmt4d_tile_f32f32f32_1x8x1_arm_64;
+    case 2:
+      return iree_uk_mmt4d_tile_f32f32f32_2x8x1_arm_64;
+    case 4:
+      return iree_uk_mmt4d_tile_f32f32f32_4x8x1_arm_64;
+    case 8:
+      return iree_uk_mmt4d_tile_f32f32f32_8x8x1_arm_64;
+    default:
+      return 0;
   }
-  return 0;
 }
 
 static iree_uk_mmt4d_tile_func_t
@@ -125,3 +134,20 @@ iree_uk_mmt4d_tile_func_t iree_uk_mmt4d_select_tile_func_arch(
       return 0;
   }
 }
+
+iree_uk_mmt4d_dequant_tile_func_t iree_uk_mmt4d_select_dequant_tile_func_arch(
+    const iree_uk_mmt4d_params_t* params) {
+  if (params->M0 != 8 || params->N0 != 8 || params->K0 != 1) return 0;
+  switch (iree_uk_mmt4d_type(params->flags)) {
+    case iree_uk_mmt4d_type_f32i8f32:
+      return iree_uk_mmt4d_tile_f32i8f32_8x8x1_arm_64;
+    case iree_uk_mmt4d_type_f32i4f32:
+      return iree_uk_mmt4d_tile_f32i4f32_8x8x1_arm_64;
+    case iree_uk_mmt4d_type_f16i8f32:
+      return iree_uk_mmt4d_tile_f16i8f32_8x8x1_arm_64;
+    case iree_uk_mmt4d_type_f16i4f32:
+      return iree_uk_mmt4d_tile_f16i4f32_8x8x1_arm_64;
+    default:
+      return 0;
+  }
+}
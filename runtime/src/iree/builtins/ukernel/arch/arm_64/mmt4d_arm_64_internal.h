@@ -9,6 +9,9 @@
 
 #include "iree/builtins/ukernel/mmt4d_internal.h"
 
+IREE_UK_MMT4D_TILE_FUNC_DECL(iree_uk_mmt4d_tile_f32f32f32_1x8x1_arm_64)
+IREE_UK_MMT4D_TILE_FUNC_DECL(iree_uk_mmt4d_tile_f32f32f32_2x8x1_arm_64)
+IREE_UK_MMT4D_TILE_FUNC_DECL(iree_uk_mmt4d_tile_f32f32f32_4x8x1_arm_64)
 IREE_UK_MMT4D_TILE_FUNC_DECL(iree_uk_mmt4d_tile_f32f32f32_8x8x1_arm_64)
 IREE_UK_MMT4D_TILE_FUNC_DECL(iree_uk_mmt4d_tile_f16f16f32_8x8x1_arm_64)
 IREE_UK_MMT4D_TILE_FUNC_DECL(iree_uk_mmt4d_tile_f16f16f32_8x8x1_arm_64_fp16fml)
@@ -18,5 +21,9 @@ IREE_UK_MMT4D_TILE_FUNC_DECL(iree_uk_mmt4d_tile_bf16bf16f32_8x8x4_arm_64_bf16)
 IREE_UK_MMT4D_TILE_FUNC_DECL(iree_uk_mmt4d_tile_i8i8i32_8x8x1_arm_64)
 IREE_UK_MMT4D_TILE_FUNC_DECL(iree_uk_mmt4d_tile_i8i8i32_8x8x4_arm_64_dotprod)
 IREE_UK_MMT4D_TILE_FUNC_DECL(iree_uk_mmt4d_tile_i8i8i32_8x8x8_arm_64_i8mm)
+IREE_UK_MMT4D_DEQUANT_TILE_FUNC_DECL(iree_uk_mmt4d_tile_f32i8f32_8x8x1_arm_64)
+IREE_UK_MMT4D_DEQUANT_TILE_FUNC_DECL(iree_uk_mmt4d_tile_f32i4f32_8x8x1_arm_64)
+IREE_UK_MMT4D_DEQUANT_TILE_FUNC_DECL(iree_uk_mmt4d_tile_f16i8f32_8x8x1_arm_64)
+IREE_UK_MMT4D_DEQUANT_TILE_FUNC_DECL(iree_uk_mmt4d_tile_f16i4f32_8x8x1_arm_64)
 
 #endif  // foIREE_BUILTINS_UKERNEL_ARCH_ARM_64_MMT4D_ARM_64_INTERNAL_H_
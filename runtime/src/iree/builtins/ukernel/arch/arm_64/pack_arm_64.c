@@ -199,3 +199,148 @@ void iree_uk_pack_tile_8x8_x32_arm_64_direct(
     in_ptr += 32;
   }
 }
+
+void iree_uk_pack_tile_8x8_x32_arm_64_transpose(
+    void* IREE_UK_RESTRICT out_tile_ptr,
+    const void* IREE_UK_RESTRICT in_tile_ptr, iree_uk_index_t outer_size1,
+    iree_uk_index_t out_stride1, iree_uk_index_t in_stride0,
+    iree_uk_index_t elem_size, iree_uk_index_t tile_size0,
+    iree_uk_index_t tile_size1) {
+  IREE_UK_ASSERT(elem_size == 4);
+  IREE_UK_ASSERT(tile_size0 == 8);
+  IREE_UK_ASSERT(tile_size1 == 8);
+  const iree_uk_int8_t* IREE_UK_RESTRICT in_ptr = in_tile_ptr;
+  iree_uk_int8_t* IREE_UK_RESTRICT out_ptr = out_tile_ptr;
+  for (; outer_size1 > 0; --outer_size1) {
+    iree_uk_neon_copy_8x8xi32_transpose_strided_to_strided(out_ptr, in_ptr, 32,
+                                                           4 * in_stride0);
+    out_ptr += 4 * out_stride1;
+    in_ptr += 32;
+  }
+}
+
+void iree_uk_pack_tile_8x1_x16_arm_64_direct(
+    void* IREE_UK_RESTRICT out_tile_ptr,
+    const void* IREE_UK_RESTRICT in_tile_ptr, iree_uk_index_t outer_size1,
+    iree_uk_index_t out_stride1, iree_uk_index_t in_stride0,
+    iree_uk_index_t elem_size, iree_uk_index_t tile_size0,
+    iree_uk_index_t tile_size1) {
+  IREE_UK_ASSERT(elem_size == 2);
+  IREE_UK_ASSERT(tile_size0 == 8);
+  IREE_UK_ASSERT(tile_size1 == 1);
+  iree_uk_int8_t* IREE_UK_RESTRICT out_ptr = out_tile_ptr;
+  const iree_uk_int8_t* IREE_UK_RESTRICT in_ptr = in_tile_ptr;
+  for (; outer_size1 >= 8; outer_size1 -= 8) {
+    iree_uk_neon_copy_8x8xi16_transpose_strided_to_strided(
+        out_ptr, in_ptr, 2 * out_stride1, 2 * in_stride0);
+    out_ptr += 16 * out_stride1;
+    in_ptr += 16;
+  }
+  for (; outer_size1 > 0; --outer_size1) {
+    iree_uk_neon_copy_8x1xi16_strided_to_unstrided(out_ptr, in_ptr,
+                                                   2 * in_stride0);
+    out_ptr += 2 * out_stride1;
+    in_ptr += 2;
+  }
+}
+
+void iree_uk_pack_tile_8x1_x16_arm_64_transpose(
+    void* IREE_UK_RESTRICT out_tile_ptr,
+    const void* IREE_UK_RESTRICT in_tile_ptr, iree_uk_index_t outer_size1,
+    iree_uk_index_t out_stride1, iree_uk_index_t in_stride0,
+    iree_uk_index_t elem_size, iree_uk_index_t tile_size0,
+    iree_uk_index_t tile_size1) {
+  IREE_UK_ASSERT(elem_size == 2);
+  IREE_UK_ASSERT(tile_size0 == 1);
+  IREE_UK_ASSERT(tile_size1 == 8);
+  const iree_uk_int16_t* IREE_UK_RESTRICT in_tile_ptr_i16 = in_tile_ptr;
+  iree_uk_int16_t* IREE_UK_RESTRICT out_tile_i16_ptr = out_tile_ptr;
+  for (; outer_size1 > 0; --outer_size1) {
+    iree_uk_memcpy(out_tile_i16_ptr, in_tile_ptr_i16, 16);
+    out_tile_i16_ptr += out_stride1;
+    in_tile_ptr_i16 += 8;
+  }
+}
+
+void iree_uk_pack_tile_8x4_x16_arm_64_direct(
+    void* IREE_UK_RESTRICT out_tile_ptr,
+    const void* IREE_UK_RESTRICT in_tile_ptr, iree_uk_index_t outer_size1,
+    iree_uk_index_t out_stride1, iree_uk_index_t in_stride0,
+    iree_uk_index_t elem_size, iree_uk_index_t tile_size0,
+    iree_uk_index_t tile_size1) {
+  IREE_UK_ASSERT(elem_size == 2);
+  IREE_UK_ASSERT(tile_size0 == 8);
+  IREE_UK_ASSERT(tile_size1 == 4);
+  iree_uk_pack_tile_8x8_x8_arm_64_direct(out_tile_ptr, in_tile_ptr, outer_size1,
+                                         out_stride1 * 2, in_stride0 * 2, 1, 8,
+                                         8);
+}
+
+void iree_uk_pack_tile_8x4_x16_arm_64_transpose(
+    void* IREE_UK_RESTRICT out_tile_ptr,
+    const void* IREE_UK_RESTRICT in_tile_ptr, iree_uk_index_t outer_size1,
+    iree_uk_index_t out_stride1, iree_uk_index_t in_stride0,
+    iree_uk_index_t elem_size, iree_uk_index_t tile_size0,
+    iree_uk_index_t tile_size1) {
+  IREE_UK_ASSERT(elem_size == 2);
+  IREE_UK_ASSERT(tile_size0 == 4);
+  IREE_UK_ASSERT(tile_size1 == 8);
+  const iree_uk_int16_t* IREE_UK_RESTRICT in_ptr = in_tile_ptr;
+  iree_uk_int16_t* IREE_UK_RESTRICT out_ptr = out_tile_ptr;
+  for (; outer_size1 > 0; --outer_size1) {
+    int16x8_t r0 = vld1q_s16(in_ptr + 0 * in_stride0);
+    int16x8_t r1 = vld1q_s16(in_ptr + 1 * in_stride0);
+    int16x8_t r2 = vld1q_s16(in_ptr + 2 * in_stride0);
+    int16x8_t r3 = vld1q_s16(in_ptr + 3 * in_stride0);
+    int32x4x2_t zip01 = iree_uk_neon_zip_8xi16_as_4xi32(r0, r1);
+    int32x4x2_t zip23 = iree_uk_neon_zip_8xi16_as_4xi32(r2, r3);
+    int64x2x2_t lo =
+        iree_uk_neon_zip_4xi32_as_2xi64(zip01.val[0], zip23.val[0]);
+    int64x2x2_t hi =
+        iree_uk_neon_zip_4xi32_as_2xi64(zip01.val[1], zip23.val[1]);
+    vst1q_s16(out_ptr + 0, vreinterpretq_s16_s64(lo.val[0]));
+    vst1q_s16(out_ptr + 8, vreinterpretq_s16_s64(lo.val[1]));
+    vst1q_s16(out_ptr + 16, vreinterpretq_s16_s64(hi.val[0]));
+    vst1q_s16(out_ptr + 24, vreinterpretq_s16_s64(hi.val[1]));
+    out_ptr += out_stride1;
+    in_ptr += 8;
+  }
+}
+
+void iree_uk_pack_tile_8x8_x16_arm_64_direct(
+    void* IREE_UK_RESTRICT out_tile_ptr,
+    const void* IREE_UK_RESTRICT in_tile_ptr, iree_uk_index_t outer_size1,
+    iree_uk_index_t out_stride1, iree_uk_index_t in_stride0,
+    iree_uk_index_t elem_size, iree_uk_index_t tile_size0,
+    iree_uk_index_t tile_size1) {
+  IREE_UK_ASSERT(elem_size == 2);
+  IREE_UK_ASSERT(tile_size0 == 8);
+  IREE_UK_ASSERT(tile_size1 == 8);
+  const iree_uk_int8_t* IREE_UK_RESTRICT in_ptr = in_tile_ptr;
+  iree_uk_int8_t* IREE_UK_RESTRICT out_ptr = out_tile_ptr;
+  for (; outer_size1 > 0; --outer_size1) {
+    iree_uk_neon_copy_8x16xi8_strided_to_strided(out_ptr, in_ptr, 16,
+                                                 2 * in_stride0);
+    out_ptr += 2 * out_stride1;
+    in_ptr += 16;
+  }
+}
+
+void iree_uk_pack_tile_8x8_x16_arm_64_transpose(
+    void* IREE_UK_RESTRICT out_tile_ptr,
+    const void* IREE_UK_RESTRICT in_tile_ptr, iree_uk_index_t outer_size1,
+    iree_uk_index_t out_stride1, iree_uk_index_t in_stride0,
+    iree_uk_index_t elem_size, iree_uk_index_t tile_size0,
+    iree_uk_index_t tile_size1) {
+  IREE_UK_ASSERT(elem_size == 2);
+  IREE_UK_ASSERT(tile_size0 == 8);
+  IREE_UK_ASSERT(tile_size1 == 8);
+  const iree_uk_int8_t* IREE_UK_RESTRICT in_ptr = in_tile_ptr;
+  iree_uk_int8_t* IREE_UK_RESTRICT out_ptr = out_tile_ptr;
+  for (; outer_size1 > 0; --outer_size1) {
+    iree_uk_neon_copy_8x8xi16_transpose_strided_to_strided(out_ptr, in_ptr, 16,
+                                                           2 * in_stride0);
+    out_ptr += 2 * out_stride1;
+    in_ptr += 16;
+  }
+}
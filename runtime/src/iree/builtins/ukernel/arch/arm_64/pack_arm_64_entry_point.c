@@ -16,11 +16,20 @@ iree_uk_pack_tile_func_t iree_uk_pack_select_tile_func_arch(
   int esize = iree_uk_type_size(iree_uk_pack_out_type(pack_type));
   bool transpose = params->flags & IREE_UK_FLAG_PACK_TRANSPOSE_INNER;
   if (esize == 4 && params->out_size2 == 8 && params->out_size3 == 8) {
-    // Currently only used for accumulators, which are never transposed.
-    return transpose ? 0 : iree_uk_pack_tile_8x8_x32_arm_64_direct;
+    return transpose ? iree_uk_pack_tile_8x8_x32_arm_64_transpose
+                     : iree_uk_pack_tile_8x8_x32_arm_64_direct;
   } else if (esize == 4 && params->out_size2 == 8 && params->out_size3 == 1) {
     return transpose ? iree_uk_pack_tile_8x1_x32_arm_64_transpose
                      : iree_uk_pack_tile_8x1_x32_arm_64_direct;
+  } else if (esize == 2 && params->out_size2 == 8 && params->out_size3 == 1) {
+    return transpose ? iree_uk_pack_tile_8x1_x16_arm_64_transpose
+                     : iree_uk_pack_tile_8x1_x16_arm_64_direct;
+  } else if (esize == 2 && params->out_size2 == 8 && params->out_size3 == 4) {
+    return transpose ? iree_uk_pack_tile_8x4_x16_arm_64_transpose
+                     : iree_uk_pack_tile_8x4_x16_arm_64_direct;
+  } else if (esize == 2 && params->out_size2 == 8 && params->out_size3 == 8) {
+    return transpose ? iree_uk_pack_tile_8x8_x16_arm_64_transpose
+                     : iree_uk_pack_tile_8x8_x16_arm_64_direct;
   } else if (esize == 1 && params->out_size2 == 8 && params->out_size3 == 1) {
     return transpose ? iree_uk_pack_tile_8x1_x8_arm_64_transpose
                      : iree_uk_pack_tile_8x1_x8_arm_64_direct;
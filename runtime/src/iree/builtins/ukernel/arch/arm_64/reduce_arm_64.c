@@ -0,0 +1,63 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/builtins/ukernel/arch/arm_64/common_arm_64.h"
+#include "iree/builtins/ukernel/arch/arm_64/reduce_arm_64_internal.h"
+
+// Both kernels use 4 independent accumulators to hide the latency of the
+// vector add/max instructions, which otherwise bounds a single-chain loop.
+// vmaxq_f32 and vmaxvq_f32 are FMAX and FMAXV, which return NaN when any input
+// is NaN (unlike FMAXNM), so the max propagates NaNs like arith.maxf.
+
+void iree_uk_reduce_tile_f32f32_sum_arm_64(void* IREE_UK_RESTRICT out_ptr,
+                                           const void* IREE_UK_RESTRICT in_ptr,
+                                           iree_uk_index_t size,
+                                           iree_uk_uint32_t flags) {
+  const float* in = in_ptr;
+  float* out = out_ptr;
+  iree_uk_index_t j = 0;
+  float32x4_t acc_0 = vdupq_n_f32(0.0f);
+  float32x4_t acc_1 = acc_0;
+  float32x4_t acc_2 = acc_0;
+  float32x4_t acc_3 = acc_0;
+  for (; j + 16 <= size; j += 16) {
+    acc_0 = vaddq_f32(acc_0, vld1q_f32(in + j + 0));
+    acc_1 = vaddq_f32(acc_1, vld1q_f32(in + j + 4));
+    acc_2 = vaddq_f32(acc_2, vld1q_f32(in + j + 8));
+    acc_3 = vaddq_f32(acc_3, vld1q_f32(in + j + 12));
+  }
+  for (; j + 4 <= size; j += 4) acc_0 = vaddq_f32(acc_0, vld1q_f32(in + j));
+  acc_0 = vaddq_f32(vaddq_f32(acc_0, acc_1), vaddq_f32(acc_2, acc_3));
+  float acc = vaddvq_f32(acc_0);
+  for (; j < size; ++j) acc += in[j];
+  if (flags & IREE_UK_FLAG_REDUCE_ACCUMULATE) acc += *out;
+  *out = acc;
+}
+
+void iree_uk_reduce_tile_f32f32_max_arm_64(void* IREE_UK_RESTRICT out_ptr,
+                                           const void* IREE_UK_RESTRICT in_ptr,
+                                           iree_uk_index_t size,
+                                           iree_uk_uint32_t flags) {
+  const float* in = in_ptr;
+  float* out = out_ptr;
+  iree_uk_index_t j = 0;
+  float32x4_t acc_0 = vdupq_n_f32(iree_uk_f32_neg_inf());
+  float32x4_t acc_1 = acc_0;
+  float32x4_t acc_2 = acc_0;
+  float32x4_t acc_3 = acc_0;
+  for (; j + 16 <= size; j += 16) {
+    acc_0 = vmaxq_f32(acc_0, vld1q_f32(in + j + 0));
+    acc_1 = vmaxq_f32(acc_1, vld1q_f32(in + j + 4));
+    acc_2 = vmaxq_f32(acc_2, vld1q_f32(in + j + 8));
+    acc_3 = vmaxq_f32(acc_3, vld1q_f32(in + j + 12));
+  }
+  for (; j + 4 <= size; j += 4) acc_0 = vmaxq_f32(acc_0, vld1q_f32(in + j));
+  acc_0 = vmaxq_f32(vmaxq_f32(acc_0, acc_1), vmaxq_f32(acc_2, acc_3));
+  float acc = vmaxvq_f32(acc_0);
+  for (; j < size; ++j) acc = iree_uk_max_f32(acc, in[j]);
+  if (flags & IREE_UK_FLAG_REDUCE_ACCUMULATE) acc = iree_uk_max_f32(acc, *out);
+  *out = acc;
+}
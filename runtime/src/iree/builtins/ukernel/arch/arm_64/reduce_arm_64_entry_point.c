@@ -0,0 +1,21 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/builtins/ukernel/arch/arm_64/common_arm_64_entry_point.h"
+#include "iree/builtins/ukernel/arch/arm_64/reduce_arm_64_internal.h"
+
+iree_uk_reduce_tile_func_t iree_uk_reduce_select_tile_func_arch(
+    const iree_uk_reduce_params_t* params) {
+  // Currently f32f32 is the only supported type.
+  switch (params->flags & IREE_UK_FLAG_REDUCE_OP_MASK) {
+    case IREE_UK_FLAG_REDUCE_OP_SUM:
+      return iree_uk_reduce_tile_f32f32_sum_arm_64;
+    case IREE_UK_FLAG_REDUCE_OP_MAX:
+      return iree_uk_reduce_tile_f32f32_max_arm_64;
+    default:
+      return 0;
+  }
+}
@@ -0,0 +1,47 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/builtins/ukernel/arch/arm_64/common_arm_64.h"
+#include "iree/builtins/ukernel/arch/arm_64/softmax_arm_64_internal.h"
+
+void iree_uk_softmax_tile_f32f32_arm_64(void* out_ptr, const void* in_ptr,
+                                        iree_uk_index_t size) {
+  const float* in = in_ptr;
+  float* out = out_ptr;
+  iree_uk_index_t j = 0;
+  // Pass 1: row maximum. Two accumulators to hide the fmax latency. FMAX and
+  // FMAXV propagate NaNs, so a NaN anywhere in the row makes the whole row NaN,
+  // as with the decomposed softmax.
+  float32x4_t max_0 = vdupq_n_f32(iree_uk_f32_neg_inf());
+  float32x4_t max_1 = max_0;
+  for (; j + 8 <= size; j += 8) {
+    max_0 = vmaxq_f32(max_0, vld1q_f32(in + j));
+    max_1 = vmaxq_f32(max_1, vld1q_f32(in + j + 4));
+  }
+  for (; j + 4 <= size; j += 4) max_0 = vmaxq_f32(max_0, vld1q_f32(in + j));
+  float max = vmaxvq_f32(vmaxq_f32(max_0, max_1));
+  for (; j < size; ++j) max = iree_uk_max_f32(max, in[j]);
+  // Pass 2: exponentials, stored to the output, and their sum.
+  float32x4_t max_v = vdupq_n_f32(max);
+  float32x4_t sum_v = vdupq_n_f32(0.0f);
+  for (j = 0; j + 4 <= size; j += 4) {
+    float32x4_t e = iree_uk_neon_exp_f32(vsubq_f32(vld1q_f32(in + j), max_v));
+    vst1q_f32(out + j, e);
+    sum_v = vaddq_f32(sum_v, e);
+  }
+  float sum = vaddvq_f32(sum_v);
+  for (; j < size; ++j) {
+    float e = iree_uk_exp_f32(in[j] - max);
+    out[j] = e;
+    sum += e;
+  }
+  // Pass 3: normalization.
+  float scale = 1.0f / sum;
+  for (j = 0; j + 4 <= size; j += 4) {
+    vst1q_f32(out + j, vmulq_n_f32(vld1q_f32(out + j), scale));
+  }
+  for (; j < size; ++j) out[j] *= scale;
+}
@@ -25,3 +25,60 @@ void iree_uk_unpack_tile_8x8_x32_arm_64_direct(
     in_ptr += 4 * in_stride1;
   }
 }
+
+void iree_uk_unpack_tile_8x8_x32_arm_64_transpose(
+    void* IREE_UK_RESTRICT out_tile_ptr,
+    const void* IREE_UK_RESTRICT in_tile_ptr, iree_uk_index_t outer_size1,
+    iree_uk_index_t out_stride0, iree_uk_index_t in_stride1,
+    iree_uk_index_t elem_size, iree_uk_index_t tile_size0,
+    iree_uk_index_t tile_size1) {
+  IREE_UK_ASSERT(elem_size == 4);
+  IREE_UK_ASSERT(tile_size0 == 8);
+  IREE_UK_ASSERT(tile_size1 == 8);
+  iree_uk_int8_t* IREE_UK_RESTRICT out_ptr = out_tile_ptr;
+  const iree_uk_int8_t* IREE_UK_RESTRICT in_ptr = in_tile_ptr;
+  for (; outer_size1 > 0; --outer_size1) {
+    iree_uk_neon_copy_8x8xi32_transpose_strided_to_strided(
+        out_ptr, in_ptr, 4 * out_stride0, 32);
+    out_ptr += 32;
+    in_ptr += 4 * in_stride1;
+  }
+}
+
+void iree_uk_unpack_tile_8x8_x16_arm_64_direct(
+    void* IREE_UK_RESTRICT out_tile_ptr,
+    const void* IREE_UK_RESTRICT in_tile_ptr, iree_uk_index_t outer_size1,
+    iree_uk_index_t out_stride0, iree_uk_index_t in_stride1,
+    iree_uk_index_t elem_size, iree_uk_index_t tile_size0,
+    iree_uk_index_t tile_size1) {
+  IREE_UK_ASSERT(elem_size == 2);
+  IREE_UK_ASSERT(tile_size0 == 8);
+  IREE_UK_ASSERT(tile_size1 == 8);
+  iree_uk_int8_t* IREE_UK_RESTRICT out_ptr = out_tile_ptr;
+  const iree_uk_int8_t* IREE_UK_RESTRICT in_ptr = in_tile_ptr;
+  for (; outer_size1 > 0; --outer_size1) {
+    iree_uk_neon_copy_8x16xi8_strided_to_strided(out_ptr, in_ptr,
+                                                 2 * out_stride0, 16);
+    out_ptr += 16;
+    in_ptr += 2 * in_stride1;
+  }
+}
+
+void iree_uk_unpack_tile_8x8_x16_arm_64_transpose(
+    void* IREE_UK_RESTRICT out_tile_ptr,
+    const void* IREE_UK_RESTRICT in_tile_ptr, iree_uk_index_t outer_size1,
+    iree_uk_index_t out_stride0, iree_uk_index_t in_stride1,
+    iree_uk_index_t elem_size, iree_uk_index_t tile_size0,
+    iree_uk_index_t tile_size1) {
+  IREE_UK_ASSERT(elem_size == 2);
+  IREE_UK_ASSERT(tile_size0 == 8);
+  IREE_UK_ASSERT(tile_size1 == 8);
+  iree_uk_int8_t* IREE_UK_RESTRICT out_ptr = out_tile_ptr;
+  const iree_uk_int8_t* IREE_UK_RESTRICT in_ptr = in_tile_ptr;
+  for (; outer_size1 > 0; --outer_size1) {
+    iree_uk_neon_copy_8x8xi16_transpose_strided_to_strided(
+        out_ptr, in_ptr, 2 * out_stride0, 16);
+    out_ptr += 16;
+    in_ptr += 2 * in_stride1;
+  }
+}
@@ -12,10 +12,14 @@ iree_uk_unpack_tile_func_t iree_uk_unpack_select_tile_func_arch(
   iree_uk_unpack_type_t unpack_type = iree_uk_unpack_type(params->flags);
   int esize = iree_uk_type_size(iree_uk_unpack_out_type(unpack_type));
   bool transpose = params->flags & IREE_UK_FLAG_UNPACK_TRANSPOSE_INNER;
-  // Unpack is currently only used in practice with esize==4 and non-transpose.
-  if (esize != 4 || transpose) return 0;
   if (params->in_size2 == 8 && params->in_size3 == 8) {
-    return iree_uk_unpack_tile_8x8_x32_arm_64_direct;
+    if (esize == 4) {
+      return transpose ? iree_uk_unpack_tile_8x8_x32_arm_64_transpose
+                       : iree_uk_unpack_tile_8x8_x32_arm_64_direct;
+    } else if (esize == 2) {
+      return transpose ? iree_uk_unpack_tile_8x8_x16_arm_64_transpose
+                       : iree_uk_unpack_tile_8x8_x16_arm_64_direct;
+    }
   }
   return 0;
 }
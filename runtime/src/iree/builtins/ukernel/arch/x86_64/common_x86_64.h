@@ -46,6 +46,24 @@ static inline void iree_uk_copy_16x64xi8_strided_to_strided(
   }
 }
 
+static inline void iree_uk_copy_8x16xi8_strided_to_strided(
+    iree_uk_int8_t* IREE_UK_RESTRICT out_ptr,
+    const iree_uk_int8_t* IREE_UK_RESTRICT in_ptr, iree_uk_index_t out_stride,
+    iree_uk_index_t in_stride) {
+  for (int i = 0; i < 8; ++i) {
+    iree_uk_memcpy(out_ptr + i * out_stride, in_ptr + i * in_stride, 16);
+  }
+}
+
+static inline void iree_uk_copy_16x32xi8_strided_to_strided(
+    iree_uk_int8_t* IREE_UK_RESTRICT out_ptr,
+    const iree_uk_int8_t* IREE_UK_RESTRICT in_ptr, iree_uk_index_t out_stride,
+    iree_uk_index_t in_stride) {
+  for (int i = 0; i < 16; ++i) {
+    iree_uk_memcpy(out_ptr + i * out_stride, in_ptr + i * in_stride, 32);
+  }
+}
+
 static inline __m256i iree_uk_avx2_load_8x4xi8_strided(
     const iree_uk_int8_t* src, iree_uk_index_t stride) {
   __m256i indices = _mm256_mullo_epi32(
@@ -224,6 +242,144 @@ iree_uk_avx2_copy_8x16xi8_tiled_1x2_transpose_strided_to_strided(
                            r0123456701234567_3);
 }
 
+// Transposes a 8x8 tile of 32-bit elements. Strides are in bytes.
+static inline void iree_uk_avx2_copy_8x8xi32_transpose_strided_to_strided(
+    iree_uk_int8_t* IREE_UK_RESTRICT out_ptr,
+    const iree_uk_int8_t* IREE_UK_RESTRICT in_ptr, iree_uk_index_t out_stride,
+    iree_uk_index_t in_stride) {
+  __m256 r[8];
+  for (int i = 0; i < 8; ++i) {
+    r[i] = _mm256_loadu_ps((const float*)(in_ptr + i * in_stride));
+  }
+  // Interleave pairs of rows: t[2k] holds columns 0,1,4,5 of rows 2k, 2k+1
+  // and t[2k+1] holds columns 2,3,6,7.
+  __m256 t[8];
+  for (int i = 0; i < 4; ++i) {
+    t[2 * i + 0] = _mm256_unpacklo_ps(r[2 * i], r[2 * i + 1]);
+    t[2 * i + 1] = _mm256_unpackhi_ps(r[2 * i], r[2 * i + 1]);
+  }
+  // Gather 4-row columns: s[4k+c] holds columns c, c+4 of rows 4k..4k+3.
+  __m256 s[8];
+  for (int i = 0; i < 2; ++i) {
+    s[4 * i + 0] = _mm256_shuffle_ps(t[4 * i + 0], t[4 * i + 2], 0x44);
+    s[4 * i + 1] = _mm256_shuffle_ps(t[4 * i + 0], t[4 * i + 2], 0xEE);
+    s[4 * i + 2] = _mm256_shuffle_ps(t[4 * i + 1], t[4 * i + 3], 0x44);
+    s[4 * i + 3] = _mm256_shuffle_ps(t[4 * i + 1], t[4 * i + 3], 0xEE);
+  }
+  for (int c = 0; c < 4; ++c) {
+    _mm256_storeu_ps((float*)(out_ptr + c * out_stride),
+                     _mm256_permute2f128_ps(s[c], s[c + 4], 0x20));
+    _mm256_storeu_ps((float*)(out_ptr + (c + 4) * out_stride),
+                     _mm256_permute2f128_ps(s[c], s[c + 4], 0x31));
+  }
+}
+
+// Transposes a 8x8 tile of 16-bit elements. Strides are in bytes.
+static inline void iree_uk_sse_copy_8x8xi16_transpose_strided_to_strided(
+    iree_uk_int8_t* IREE_UK_RESTRICT out_ptr,
+    const iree_uk_int8_t* IREE_UK_RESTRICT in_ptr, iree_uk_index_t out_stride,
+    iree_uk_index_t in_stride) {
+  __m128i r[8];
+  for (int i = 0; i < 8; ++i) {
+    r[i] = _mm_loadu_si128((const __m128i*)(in_ptr + i * in_stride));
+  }
+  // a[2k] holds columns 0..3 of rows 2k, 2k+1 and a[2k+1] columns 4..7.
+  __m128i a[8];
+  for (int i = 0; i < 4; ++i) {
+    a[2 * i + 0] = _mm_unpacklo_epi16(r[2 * i], r[2 * i + 1]);
+    a[2 * i + 1] = _mm_unpackhi_epi16(r[2 * i], r[2 * i + 1]);
+  }
+  // b[4k+j] holds columns 2j, 2j+1 of rows 4k..4k+3.
+  __m128i b[8];
+  for (int i = 0; i < 2; ++i) {
+    b[4 * i + 0] = _mm_unpacklo_epi32(a[4 * i + 0], a[4 * i + 2]);
+    b[4 * i + 1] = _mm_unpackhi_epi32(a[4 * i + 0], a[4 * i + 2]);
+    b[4 * i + 2] = _mm_unpacklo_epi32(a[4 * i + 1], a[4 * i + 3]);
+    b[4 * i + 3] = _mm_unpackhi_epi32(a[4 * i + 1], a[4 * i + 3]);
+  }
+  for (int j = 0; j < 4; ++j) {
+    _mm_storeu_si128((__m128i*)(out_ptr + (2 * j + 0) * out_stride),
+                     _mm_unpacklo_epi64(b[j], b[j + 4]));
+    _mm_storeu_si128((__m128i*)(out_ptr + (2 * j + 1) * out_stride),
+                     _mm_unpackhi_epi64(b[j], b[j + 4]));
+  }
+}
+
+// Transposes a 16x16 tile of 32-bit elements. Strides are in bytes.
+static inline void iree_uk_avx2_copy_16x16xi32_transpose_strided_to_strided(
+    iree_uk_int8_t* IREE_UK_RESTRICT out_ptr,
+    const iree_uk_int8_t* IREE_UK_RESTRICT in_ptr, iree_uk_index_t out_stride,
+    iree_uk_index_t in_stride) {
+  for (int i = 0; i < 2; ++i) {
+    for (int j = 0; j < 2; ++j) {
+      iree_uk_avx2_copy_8x8xi32_transpose_strided_to_strided(
+          out_ptr + 8 * j * out_stride + 32 * i,
+          in_ptr + 8 * i * in_stride + 32 * j, out_stride, in_stride);
+    }
+  }
+}
+
+// Transposes a 16x16 tile of 16-bit elements. Strides are in bytes.
+static inline void iree_uk_sse_copy_16x16xi16_transpose_strided_to_strided(
+    iree_uk_int8_t* IREE_UK_RESTRICT out_ptr,
+    const iree_uk_int8_t* IREE_UK_RESTRICT in_ptr, iree_uk_index_t out_stride,
+    iree_uk_index_t in_stride) {
+  for (int i = 0; i < 2; ++i) {
+    for (int j = 0; j < 2; ++j) {
+      iree_uk_sse_copy_8x8xi16_transpose_strided_to_strided(
+          out_ptr + 8 * j * out_stride + 16 * i,
+          in_ptr + 8 * i * in_stride + 16 * j, out_stride, in_stride);
+    }
+  }
+}
+
+// Horizontal reductions of the 8 lanes of a __m256.
+static inline float iree_uk_avx2_reduce_add_f32(__m256 v) {
+  __m128 v4 =
+      _mm_add_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+  __m128 v2 = _mm_add_ps(v4, _mm_movehl_ps(v4, v4));
+  __m128 v1 = _mm_add_ss(v2, _mm_movehdup_ps(v2));
+  return _mm_cvtss_f32(v1);
+}
+
+// Note that vmaxps returns its second operand when either operand is NaN, so a
+// max reduction built on it drops NaNs that arith.maxf propagates. Kernels
+// track unordered inputs separately, off the critical path of the max chain,
+// and only rely on this for NaN-free vectors.
+static inline float iree_uk_avx2_reduce_max_f32(__m256 v) {
+  __m128 v4 =
+      _mm_max_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+  __m128 v2 = _mm_max_ps(v4, _mm_movehl_ps(v4, v4));
+  __m128 v1 = _mm_max_ss(v2, _mm_movehdup_ps(v2));
+  return _mm_cvtss_f32(v1);
+}
+
+// Vectorized iree_uk_exp_f32. See the IREE_UK_EXP_F32_* constants in common.h.
+static inline __m256 iree_uk_avx2_exp_f32(__m256 x) {
+  __m256 underflow = _mm256_cmp_ps(
+      x, _mm256_set1_ps(IREE_UK_EXP_F32_MIN_INPUT), _CMP_LT_OQ);
+  // The min/max operand order makes NaN inputs propagate.
+  x = _mm256_min_ps(_mm256_set1_ps(IREE_UK_EXP_F32_MAX_INPUT), x);
+  x = _mm256_max_ps(_mm256_set1_ps(IREE_UK_EXP_F32_MIN_INPUT), x);
+  __m256 n = _mm256_round_ps(
+      _mm256_mul_ps(x, _mm256_set1_ps(IREE_UK_EXP_F32_LOG2E)),
+      _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+  __m256 r = _mm256_fnmadd_ps(n, _mm256_set1_ps(IREE_UK_EXP_F32_LN2_HI), x);
+  r = _mm256_fnmadd_ps(n, _mm256_set1_ps(IREE_UK_EXP_F32_LN2_LO), r);
+  __m256 p = _mm256_set1_ps(IREE_UK_EXP_F32_P0);
+  p = _mm256_fmadd_ps(p, r, _mm256_set1_ps(IREE_UK_EXP_F32_P1));
+  p = _mm256_fmadd_ps(p, r, _mm256_set1_ps(IREE_UK_EXP_F32_P2));
+  p = _mm256_fmadd_ps(p, r, _mm256_set1_ps(IREE_UK_EXP_F32_P3));
+  p = _mm256_fmadd_ps(p, r, _mm256_set1_ps(IREE_UK_EXP_F32_P4));
+  p = _mm256_fmadd_ps(p, r, _mm256_set1_ps(IREE_UK_EXP_F32_P5));
+  __m256 y = _mm256_fmadd_ps(p, _mm256_mul_ps(r, r), r);
+  y = _mm256_add_ps(y, _mm256_set1_ps(1.0f));
+  __m256i pow2n = _mm256_slli_epi32(
+      _mm256_add_epi32(_mm256_cvtps_epi32(n), _mm256_set1_epi32(127)), 23);
+  y = _mm256_mul_ps(y, _mm256_castsi256_ps(pow2n));
+  return _mm256_andnot_ps(underflow, y);
+}
+
 #if defined(__AVX512F__)
 
 static inline __m512i iree_uk_avx512_loadu_4x128(const void* src0,
@@ -406,6 +562,30 @@ iree_uk_avx512_copy_16x16xi8_tiled_1x2_transpose_strided_to_strided(
       r0123456701234567_3);
 }
 
+// Vectorized iree_uk_exp_f32. See the IREE_UK_EXP_F32_* constants in common.h.
+static inline __m512 iree_uk_avx512_exp_f32(__m512 x) {
+  __mmask16 underflow = _mm512_cmp_ps_mask(
+      x, _mm512_set1_ps(IREE_UK_EXP_F32_MIN_INPUT), _CMP_LT_OQ);
+  // The min/max operand order makes NaN inputs propagate.
+  x = _mm512_min_ps(_mm512_set1_ps(IREE_UK_EXP_F32_MAX_INPUT), x);
+  x = _mm512_max_ps(_mm512_set1_ps(IREE_UK_EXP_F32_MIN_INPUT), x);
+  __m512 n = _mm512_roundscale_ps(
+      _mm512_mul_ps(x, _mm512_set1_ps(IREE_UK_EXP_F32_LOG2E)),
+      _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+  __m512 r = _mm512_fnmadd_ps(n, _mm512_set1_ps(IREE_UK_EXP_F32_LN2_HI), x);
+  r = _mm512_fnmadd_ps(n, _mm512_set1_ps(IREE_UK_EXP_F32_LN2_LO), r);
+  __m512 p = _mm512_set1_ps(IREE_UK_EXP_F32_P0);
+  p = _mm512_fmadd_ps(p, r, _mm512_set1_ps(IREE_UK_EXP_F32_P1));
+  p = _mm512_fmadd_ps(p, r, _mm512_set1_ps(IREE_UK_EXP_F32_P2));
+  p = _mm512_fmadd_ps(p, r, _mm512_set1_ps(IREE_UK_EXP_F32_P3));
+  p = _mm512_fmadd_ps(p, r, _mm512_set1_ps(IREE_UK_EXP_F32_P4));
+  p = _mm512_fmadd_ps(p, r, _mm512_set1_ps(IREE_UK_EXP_F32_P5));
+  __m512 y = _mm512_fmadd_ps(p, _mm512_mul_ps(r, r), r);
+  y = _mm512_add_ps(y, _mm512_set1_ps(1.0f));
+  y = _mm512_scalef_ps(y, n);
+  return _mm512_mask_mov_ps(y, underflow, _mm512_setzero_ps());
+}
+
 #endif  // defined (__AVX512F__)
 
 #endif  // defined(__AVX2__)
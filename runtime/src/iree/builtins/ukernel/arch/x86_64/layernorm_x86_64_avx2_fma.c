@@ -0,0 +1,71 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/builtins/ukernel/arch/x86_64/common_x86_64.h"
+#include "iree/builtins/ukernel/arch/x86_64/layernorm_x86_64_internal.h"
+
+void iree_uk_layernorm_tile_f32f32_x86_64_avx2_fma(
+    void* out_ptr, const void* in_ptr, const void* IREE_UK_RESTRICT gamma_ptr,
+    const void* IREE_UK_RESTRICT beta_ptr, iree_uk_index_t size,
+    float epsilon) {
+  const float* in = in_ptr;
+  float* out = out_ptr;
+  const float* gamma = gamma_ptr;
+  const float* beta = beta_ptr;
+  iree_uk_index_t j = 0;
+  __m256 sum_v = _mm256_setzero_ps();
+  for (; j + 8 <= size; j += 8) {
+    sum_v = _mm256_add_ps(sum_v, _mm256_loadu_ps(in + j));
+  }
+  float sum = iree_uk_avx2_reduce_add_f32(sum_v);
+  for (; j < size; ++j) sum += in[j];
+  float mean = sum / size;
+  __m256 mean_v = _mm256_set1_ps(mean);
+  __m256 sum_sq_v = _mm256_setzero_ps();
+  for (j = 0; j + 8 <= size; j += 8) {
+    __m256 d = _mm256_sub_ps(_mm256_loadu_ps(in + j), mean_v);
+    sum_sq_v = _mm256_fmadd_ps(d, d, sum_sq_v);
+  }
+  float sum_sq = iree_uk_avx2_reduce_add_f32(sum_sq_v);
+  for (; j < size; ++j) {
+    float d = in[j] - mean;
+    sum_sq += d * d;
+  }
+  float inv_stddev = 1.0f / iree_uk_sqrt_f32(sum_sq / size + epsilon);
+  __m256 inv_stddev_v = _mm256_set1_ps(inv_stddev);
+  for (j = 0; j + 8 <= size; j += 8) {
+    __m256 d = _mm256_sub_ps(_mm256_loadu_ps(in + j), mean_v);
+    __m256 g = _mm256_mul_ps(_mm256_loadu_ps(gamma + j), inv_stddev_v);
+    _mm256_storeu_ps(out + j, _mm256_fmadd_ps(d, g, _mm256_loadu_ps(beta + j)));
+  }
+  for (; j < size; ++j) {
+    out[j] = (in[j] - mean) * inv_stddev * gamma[j] + beta[j];
+  }
+}
+
+void iree_uk_layernorm_tile_f32f32_rms_x86_64_avx2_fma(
+    void* out_ptr, const void* in_ptr, const void* IREE_UK_RESTRICT gamma_ptr,
+    const void* IREE_UK_RESTRICT beta_ptr, iree_uk_index_t size,
+    float epsilon) {
+  const float* in = in_ptr;
+  float* out = out_ptr;
+  const float* gamma = gamma_ptr;
+  iree_uk_index_t j = 0;
+  __m256 sum_sq_v = _mm256_setzero_ps();
+  for (; j + 8 <= size; j += 8) {
+    __m256 x = _mm256_loadu_ps(in + j);
+    sum_sq_v = _mm256_fmadd_ps(x, x, sum_sq_v);
+  }
+  float sum_sq = iree_uk_avx2_reduce_add_f32(sum_sq_v);
+  for (; j < size; ++j) sum_sq += in[j] * in[j];
+  float inv_rms = 1.0f / iree_uk_sqrt_f32(sum_sq / size + epsilon);
+  __m256 inv_rms_v = _mm256_set1_ps(inv_rms);
+  for (j = 0; j + 8 <= size; j += 8) {
+    __m256 g = _mm256_mul_ps(_mm256_loadu_ps(gamma + j), inv_rms_v);
+    _mm256_storeu_ps(out + j, _mm256_mul_ps(_mm256_loadu_ps(in + j), g));
+  }
+  for (; j < size; ++j) out[j] = in[j] * inv_rms * gamma[j];
+}
@@ -0,0 +1,82 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/builtins/ukernel/arch/x86_64/common_x86_64.h"
+#include "iree/builtins/ukernel/arch/x86_64/layernorm_x86_64_internal.h"
+
+void iree_uk_layernorm_tile_f32f32_x86_64_avx512_base(
+    void* out_ptr, const void* in_ptr, const void* IREE_UK_RESTRICT gamma_ptr,
+    const void* IREE_UK_RESTRICT beta_ptr, iree_uk_index_t size,
+    float epsilon) {
+  const float* in = in_ptr;
+  float* out = out_ptr;
+  const float* gamma = gamma_ptr;
+  const float* beta = beta_ptr;
+  __mmask16 tail_mask = (1u << (size & 15)) - 1;
+  iree_uk_index_t j = 0;
+  __m512 sum_v = _mm512_setzero_ps();
+  for (; j + 16 <= size; j += 16) {
+    sum_v = _mm512_add_ps(sum_v, _mm512_loadu_ps(in + j));
+  }
+  sum_v = _mm512_add_ps(sum_v, _mm512_maskz_loadu_ps(tail_mask, in + j));
+  float mean = _mm512_reduce_add_ps(sum_v) / size;
+  __m512 mean_v = _mm512_set1_ps(mean);
+  __m512 sum_sq_v = _mm512_setzero_ps();
+  for (j = 0; j + 16 <= size; j += 16) {
+    __m512 d = _mm512_sub_ps(_mm512_loadu_ps(in + j), mean_v);
+    sum_sq_v = _mm512_fmadd_ps(d, d, sum_sq_v);
+  }
+  if (tail_mask) {
+    __m512 d = _mm512_maskz_sub_ps(
+        tail_mask, _mm512_maskz_loadu_ps(tail_mask, in + j), mean_v);
+    sum_sq_v = _mm512_fmadd_ps(d, d, sum_sq_v);
+  }
+  float sum_sq = _mm512_reduce_add_ps(sum_sq_v);
+  __m512 inv_stddev_v =
+      _mm512_set1_ps(1.0f / iree_uk_sqrt_f32(sum_sq / size + epsilon));
+  for (j = 0; j + 16 <= size; j += 16) {
+    __m512 d = _mm512_sub_ps(_mm512_loadu_ps(in + j), mean_v);
+    __m512 g = _mm512_mul_ps(_mm512_loadu_ps(gamma + j), inv_stddev_v);
+    _mm512_storeu_ps(out + j, _mm512_fmadd_ps(d, g, _mm512_loadu_ps(beta + j)));
+  }
+  if (tail_mask) {
+    __m512 d = _mm512_sub_ps(_mm512_maskz_loadu_ps(tail_mask, in + j), mean_v);
+    __m512 g = _mm512_mul_ps(_mm512_maskz_loadu_ps(tail_mask, gamma + j),
+                             inv_stddev_v);
+    __m512 b = _mm512_maskz_loadu_ps(tail_mask, beta + j);
+    _mm512_mask_storeu_ps(out + j, tail_mask, _mm512_fmadd_ps(d, g, b));
+  }
+}
+
+void iree_uk_layernorm_tile_f32f32_rms_x86_64_avx512_base(
+    void* out_ptr, const void* in_ptr, const void* IREE_UK_RESTRICT gamma_ptr,
+    const void* IREE_UK_RESTRICT beta_ptr, iree_uk_index_t size,
+    float epsilon) {
+  const float* in = in_ptr;
+  float* out = out_ptr;
+  const float* gamma = gamma_ptr;
+  __mmask16 tail_mask = (1u << (size & 15)) - 1;
+  iree_uk_index_t j = 0;
+  __m512 sum_sq_v = _mm512_setzero_ps();
+  for (; j + 16 <= size; j += 16) {
+    __m512 x = _mm512_loadu_ps(in + j);
+    sum_sq_v = _mm512_fmadd_ps(x, x, sum_sq_v);
+  }
+  __m512 x_tail = _mm512_maskz_loadu_ps(tail_mask, in + j);
+  sum_sq_v = _mm512_fmadd_ps(x_tail, x_tail, sum_sq_v);
+  float sum_sq = _mm512_reduce_add_ps(sum_sq_v);
+  __m512 inv_rms_v =
+      _mm512_set1_ps(1.0f / iree_uk_sqrt_f32(sum_sq / size + epsilon));
+  for (j = 0; j + 16 <= size; j += 16) {
+    __m512 g = _mm512_mul_ps(_mm512_loadu_ps(gamma + j), inv_rms_v);
+    _mm512_storeu_ps(out + j, _mm512_mul_ps(_mm512_loadu_ps(in + j), g));
+  }
+  if (tail_mask) {
+    __m512 g = _mm512_mul_ps(_mm512_maskz_loadu_ps(tail_mask, gamma + j),
+                             inv_rms_v);
+    _mm512_mask_storeu_ps(out + j, tail_mask, _mm512_mul_ps(x_tail, g));
+  }
+}
@@ -0,0 +1,27 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/builtins/ukernel/arch/x86_64/common_x86_64_entry_point.h"
+#include "iree/builtins/ukernel/arch/x86_64/layernorm_x86_64_internal.h"
+
+iree_uk_layernorm_tile_func_t iree_uk_layernorm_select_tile_func_arch(
+    const iree_uk_layernorm_params_t* params) {
+  // Currently f32f32 is the only supported type.
+  bool rms = params->flags & IREE_UK_FLAG_LAYERNORM_RMS;
+#if defined(IREE_UK_BUILD_X86_64_AVX512_BASE)
+  if (iree_uk_cpu_supports_avx512_base(params->cpu_data)) {
+    return rms ? iree_uk_layernorm_tile_f32f32_rms_x86_64_avx512_base
+               : iree_uk_layernorm_tile_f32f32_x86_64_avx512_base;
+  }
+#endif
+#if defined(IREE_UK_BUILD_X86_64_AVX2_FMA)
+  if (iree_uk_cpu_supports_avx2_fma(params->cpu_data)) {
+    return rms ? iree_uk_layernorm_tile_f32f32_rms_x86_64_avx2_fma
+               : iree_uk_layernorm_tile_f32f32_x86_64_avx2_fma;
+  }
+#endif
+  return 0;
+}
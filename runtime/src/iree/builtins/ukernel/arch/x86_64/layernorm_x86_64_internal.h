@@ -0,0 +1,20 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_BUILTINS_UKERNEL_ARCH_X86_64_LAYERNORM_X86_64_INTERNAL_H_
+#define IREE_BUILTINS_UKERNEL_ARCH_X86_64_LAYERNORM_X86_64_INTERNAL_H_
+
+#include "iree/builtins/ukernel/layernorm_internal.h"
+
+IREE_UK_LAYERNORM_TILE_FUNC_DECL(iree_uk_layernorm_tile_f32f32_x86_64_avx2_fma)
+IREE_UK_LAYERNORM_TILE_FUNC_DECL(
+    iree_uk_layernorm_tile_f32f32_rms_x86_64_avx2_fma)
+IREE_UK_LAYERNORM_TILE_FUNC_DECL(
+    iree_uk_layernorm_tile_f32f32_x86_64_avx512_base)
+IREE_UK_LAYERNORM_TILE_FUNC_DECL(
+    iree_uk_layernorm_tile_f32f32_rms_x86_64_avx512_base)
+
+#endif  // IREE_BUILTINS_UKERNEL_ARCH_X86_64_LAYERNORM_X86_64_INTERNAL_H_
@@ -57,6 +57,59 @@ void iree_uk_mmt4d_tile_f32f32f32_8x8x1_x86_64_avx2_fma(
   _mm256_storeu_ps(out_ptr + 7 * 8, acc7);
 }
 
+// Narrow-M counterpart of the 8x8x1 tile function, for M0 = 1, 2 or 4. It is
+// always inlined into the variants below so that M0 is a compile-time constant
+// and the loops over it unroll with the accumulators kept in registers.
+static inline IREE_UK_ATTRIBUTE_ALWAYS_INLINE void
+iree_uk_mmt4d_tile_f32f32f32_Mx8x1_x86_64_avx2_fma(
+    void* IREE_UK_RESTRICT out_tile, const void* IREE_UK_RESTRICT lhs_panel,
+    const void* IREE_UK_RESTRICT rhs_panel,
+    const iree_uk_mmt4d_params_t* params, int M0) {
+  IREE_UK_ASSUME(M0 >= 1 && M0 <= 4);
+  float* IREE_UK_RESTRICT out_ptr = out_tile;
+  const float* IREE_UK_RESTRICT lhs_ptr = lhs_panel;
+  const float* IREE_UK_RESTRICT rhs_ptr = rhs_panel;
+  __m256 acc[4];
+  if (params->flags & IREE_UK_FLAG_MMT4D_ACCUMULATE) {
+    for (int i = 0; i < M0; ++i) acc[i] = _mm256_loadu_ps(out_ptr + i * 8);
+  } else {
+    for (int i = 0; i < M0; ++i) acc[i] = _mm256_setzero_ps();
+  }
+  for (iree_uk_int32_t k = 0; k < params->K; ++k) {
+    __m256 rhs = _mm256_loadu_ps(rhs_ptr);
+    rhs_ptr += 8;
+    for (int i = 0; i < M0; ++i) {
+      acc[i] = _mm256_fmadd_ps(_mm256_broadcast_ss(lhs_ptr + i), rhs, acc[i]);
+    }
+    lhs_ptr += M0;
+  }
+  for (int i = 0; i < M0; ++i) _mm256_storeu_ps(out_ptr + i * 8, acc[i]);
+}
+
+void iree_uk_mmt4d_tile_f32f32f32_1x8x1_x86_64_avx2_fma(
+    void* IREE_UK_RESTRICT out_tile, const void* IREE_UK_RESTRICT lhs_panel,
+    const void* IREE_UK_RESTRICT rhs_panel,
+    const iree_uk_mmt4d_params_t* params) {
+  iree_uk_mmt4d_tile_f32f32f32_Mx8x1_x86_64_avx2_fma(out_tile, lhs_panel,
+                                                    rhs_panel, params, 1);
+}
+
+void iree_uk_mmt4d_tile_f32f32f32_2x8x1_x86_64_avx2_fma(
+    void* IREE_UK_RESTRICT out_tile, const void* IREE_UK_RESTRICT lhs_panel,
+    const void* IREE_UK_RESTRICT rhs_panel,
+    const iree_uk_mmt4d_params_t* params) {
+  iree_uk_mmt4d_tile_f32f32f32_Mx8x1_x86_64_avx2_fma(out_tile, lhs_panel,
+                                                    rhs_panel, params, 2);
+}
+
+void iree_uk_mmt4d_tile_f32f32f32_4x8x1_x86_64_avx2_fma(
+    void* IREE_UK_RESTRICT out_tile, const void* IREE_UK_RESTRICT lhs_panel,
+    const void* IREE_UK_RESTRICT rhs_panel,
+    const iree_uk_mmt4d_params_t* params) {
+  iree_uk_mmt4d_tile_f32f32f32_Mx8x1_x86_64_avx2_fma(out_tile, lhs_panel,
+                                                    rhs_panel, params, 4);
+}
+
 // Shared implementation for f16f16f16 and f16f16f32.
 // In the f16f16f16 case, intermediate roundings are skipped. This function
 // should only be used if IREE_UK_FLAG_MMT4D_SKIP_INTERMEDIATE_ROUNDINGS is set.
@@ -274,3 +327,151 @@ void iree_uk_mmt4d_tile_i8i8i32_8x8x2_x86_64_avx2_fma(
   iree_uk_avx_storeu_2x128((__m128i*)(out_ptr + 3 * 8 + 4),
                            (__m128i*)(out_ptr + 7 * 8 + 0), acc_3_4567_7_0123);
 }
+
+// Loads the 8 RHS elements for one k-step of a 8x8x1 tile of a weight-only
+// quantized type and sign-extends them to int32. int4 elements are packed two
+// per byte, with the even-indexed element in the low nibble.
+static inline __m256i iree_uk_mmt4d_load_rhs_8xiXX_as_8xi32_avx2(
+    const iree_uk_uint8_t* IREE_UK_RESTRICT rhs_ptr, iree_uk_type_t rhs_type) {
+  if (rhs_type == IREE_UK_TYPE_INT_8) {
+    return _mm256_cvtepi8_epi32(_mm_loadl_epi64((const __m128i*)rhs_ptr));
+  }
+  iree_uk_int32_t packed;
+  iree_uk_memcpy(&packed, rhs_ptr, sizeof packed);
+  // Each 16-bit lane holds one byte, i.e. two int4 elements.
+  __m128i bytes = _mm_cvtepu8_epi16(_mm_cvtsi32_si128(packed));
+  __m128i lo = _mm_srai_epi16(_mm_slli_epi16(bytes, 12), 12);
+  __m128i hi = _mm_srai_epi16(_mm_slli_epi16(bytes, 8), 12);
+  return _mm256_cvtepi16_epi32(_mm_unpacklo_epi16(lo, hi));
+}
+
+// Shared implementation for the weight-only quantized types
+// f32|f16 * dequant(i8|i4) -> f32. The RHS is dequantized in registers and
+// scaled before being multiplied with the LHS, so that the scales are applied
+// once per RHS element rather than once per product.
+static inline void iree_uk_mmt4d_tile_fXXiXXf32_8x8x1_x86_64_avx2_fma(
+    void* IREE_UK_RESTRICT out_tile, const void* IREE_UK_RESTRICT lhs_panel,
+    const void* IREE_UK_RESTRICT rhs_panel,
+    const float* IREE_UK_RESTRICT rhs_scales_panel, iree_uk_int32_t group_size,
+    const iree_uk_mmt4d_params_t* params, iree_uk_type_t lhs_type,
+    iree_uk_type_t rhs_type) {
+  float* IREE_UK_RESTRICT out_ptr = out_tile;
+  const float* IREE_UK_RESTRICT lhs_f32_ptr = lhs_panel;
+  const iree_uk_uint16_t* IREE_UK_RESTRICT lhs_f16_ptr = lhs_panel;
+  const iree_uk_uint8_t* IREE_UK_RESTRICT rhs_ptr = rhs_panel;
+  const float* IREE_UK_RESTRICT scales_ptr = rhs_scales_panel;
+  const int rhs_tile_bytes = rhs_type == IREE_UK_TYPE_INT_8 ? 8 : 4;
+  __m256 acc0, acc1, acc2, acc3, acc4, acc5, acc6, acc7;
+  if (params->flags & IREE_UK_FLAG_MMT4D_ACCUMULATE) {
+    acc0 = _mm256_loadu_ps(out_ptr + 0 * 8);
+    acc1 = _mm256_loadu_ps(out_ptr + 1 * 8);
+    acc2 = _mm256_loadu_ps(out_ptr + 2 * 8);
+    acc3 = _mm256_loadu_ps(out_ptr + 3 * 8);
+    acc4 = _mm256_loadu_ps(out_ptr + 4 * 8);
+    acc5 = _mm256_loadu_ps(out_ptr + 5 * 8);
+    acc6 = _mm256_loadu_ps(out_ptr + 6 * 8);
+    acc7 = _mm256_loadu_ps(out_ptr + 7 * 8);
+  } else {
+    acc0 = _mm256_setzero_ps();
+    acc1 = _mm256_setzero_ps();
+    acc2 = _mm256_setzero_ps();
+    acc3 = _mm256_setzero_ps();
+    acc4 = _mm256_setzero_ps();
+    acc5 = _mm256_setzero_ps();
+    acc6 = _mm256_setzero_ps();
+    acc7 = _mm256_setzero_ps();
+  }
+  // K0 == 1 so each k-step is one element of the group.
+  __m256 scales = _mm256_loadu_ps(scales_ptr);
+  iree_uk_int32_t group_remaining = group_size;
+  for (iree_uk_int32_t k = 0; k < params->K; ++k) {
+    if (group_remaining == 0) {
+      scales_ptr += 8;
+      scales = _mm256_loadu_ps(scales_ptr);
+      group_remaining = group_size;
+    }
+    --group_remaining;
+    __m256 rhs = _mm256_mul_ps(
+        _mm256_cvtepi32_ps(
+            iree_uk_mmt4d_load_rhs_8xiXX_as_8xi32_avx2(rhs_ptr, rhs_type)),
+        scales);
+    rhs_ptr += rhs_tile_bytes;
+    if (lhs_type == IREE_UK_TYPE_FLOAT_32) {
+      acc0 = _mm256_fmadd_ps(_mm256_broadcast_ss(lhs_f32_ptr + 0), rhs, acc0);
+      acc1 = _mm256_fmadd_ps(_mm256_broadcast_ss(lhs_f32_ptr + 1), rhs, acc1);
+      acc2 = _mm256_fmadd_ps(_mm256_broadcast_ss(lhs_f32_ptr + 2), rhs, acc2);
+      acc3 = _mm256_fmadd_ps(_mm256_broadcast_ss(lhs_f32_ptr + 3), rhs, acc3);
+      acc4 = _mm256_fmadd_ps(_mm256_broadcast_ss(lhs_f32_ptr + 4), rhs, acc4);
+      acc5 = _mm256_fmadd_ps(_mm256_broadcast_ss(lhs_f32_ptr + 5), rhs, acc5);
+      acc6 = _mm256_fmadd_ps(_mm256_broadcast_ss(lhs_f32_ptr + 6), rhs, acc6);
+      acc7 = _mm256_fmadd_ps(_mm256_broadcast_ss(lhs_f32_ptr + 7), rhs, acc7);
+      lhs_f32_ptr += 8;
+    } else {
+      acc0 = _mm256_fmadd_ps(_mm256_cvtph_ps(_mm_set1_epi16(lhs_f16_ptr[0])),
+                             rhs, acc0);
+      acc1 = _mm256_fmadd_ps(_mm256_cvtph_ps(_mm_set1_epi16(lhs_f16_ptr[1])),
+                             rhs, acc1);
+      acc2 = _mm256_fmadd_ps(_mm256_cvtph_ps(_mm_set1_epi16(lhs_f16_ptr[2])),
+                             rhs, acc2);
+      acc3 = _mm256_fmadd_ps(_mm256_cvtph_ps(_mm_set1_epi16(lhs_f16_ptr[3])),
+                             rhs, acc3);
+      acc4 = _mm256_fmadd_ps(_mm256_cvtph_ps(_mm_set1_epi16(lhs_f16_ptr[4])),
+                             rhs, acc4);
+      acc5 = _mm256_fmadd_ps(_mm256_cvtph_ps(_mm_set1_epi16(lhs_f16_ptr[5])),
+                             rhs, acc5);
+      acc6 = _mm256_fmadd_ps(_mm256_cvtph_ps(_mm_set1_epi16(lhs_f16_ptr[6])),
+                             rhs, acc6);
+      acc7 = _mm256_fmadd_ps(_mm256_cvtph_ps(_mm_set1_epi16(lhs_f16_ptr[7])),
+                             rhs, acc7);
+      lhs_f16_ptr += 8;
+    }
+  }
+  _mm256_storeu_ps(out_ptr + 0 * 8, acc0);
+  _mm256_storeu_ps(out_ptr + 1 * 8, acc1);
+  _mm256_storeu_ps(out_ptr + 2 * 8, acc2);
+  _mm256_storeu_ps(out_ptr + 3 * 8, acc3);
+  _mm256_storeu_ps(out_ptr + 4 * 8, acc4);
+  _mm256_storeu_ps(out_ptr + 5 * 8, acc5);
+  _mm256_storeu_ps(out_ptr + 6 * 8, acc6);
+  _mm256_storeu_ps(out_ptr + 7 * 8, acc7);
+}
+
+void iree_uk_mmt4d_tile_f32i8f32_8x8x1_x86_64_avx2_fma(
+    void* IREE_UK_RESTRICT out_tile, const void* IREE_UK_RESTRICT lhs_panel,
+    const void* IREE_UK_RESTRICT rhs_panel,
+    const float* IREE_UK_RESTRICT rhs_scales_panel, iree_uk_int32_t group_size,
+    const iree_uk_mmt4d_params_t* params) {
+  iree_uk_mmt4d_tile_fXXiXXf32_8x8x1_x86_64_avx2_fma(
+      out_tile, lhs_panel, rhs_panel, rhs_scales_panel, group_size, params,
+      IREE_UK_TYPE_FLOAT_32, IREE_UK_TYPE_INT_8);
+}
+
+void iree_uk_mmt4d_tile_f32i4f32_8x8x1_x86_64_avx2_fma(
+    void* IREE_UK_RESTRICT out_tile, const void* IREE_UK_RESTRICT lhs_panel,
+    const void* IREE_UK_RESTRICT rhs_panel,
+    const float* IREE_UK_RESTRICT rhs_scales_panel, iree_uk_int32_t group_size,
+    const iree_uk_mmt4d_params_t* params) {
+  iree_uk_mmt4d_tile_fXXiXXf32_8x8x1_x86_64_avx2_fma(
+      out_tile, lhs_panel, rhs_panel, rhs_scales_panel, group_size, params,
+      IREE_UK_TYPE_FLOAT_32, IREE_UK_TYPE_INT_4);
+}
+
+void iree_uk_mmt4d_tile_f16i8f32_8x8x1_x86_64_avx2_fma(
+    void* IREE_UK_RESTRICT out_tile, const void* IREE_UK_RESTRICT lhs_panel,
+    const void* IREE_UK_RESTRICT rhs_panel,
+    const float* IREE_UK_RESTRICT rhs_scales_panel, iree_uk_int32_t group_size,
+    const iree_uk_mmt4d_params_t* params) {
+  iree_uk_mmt4d_tile_fXXiXXf32_8x8x1_x86_64_avx2_fma(
+      out_tile, lhs_panel, rhs_panel, rhs_scales_panel, group_size, params,
+      IREE_UK_TYPE_FLOAT_16, IREE_UK_TYPE_INT_8);
+}
+
+void iree_uk_mmt4d_tile_f16i4f32_8x8x1_x86_64_avx2_fma(
+    void* IREE_UK_RESTRICT out_tile, const void* IREE_UK_RESTRICT lhs_panel,
+    const void* IREE_UK_RESTRICT rhs_panel,
+    const float* IREE_UK_RESTRICT rhs_scales_panel, iree_uk_int32_t group_size,
+    const iree_uk_mmt4d_params_t* params) {
+  iree_uk_mmt4d_tile_fXXiXXf32_8x8x1_x86_64_avx2_fma(
+      out_tile, lhs_panel, rhs_panel, rhs_scales_panel, group_size, params,
+      IREE_UK_TYPE_FLOAT_16, IREE_UK_TYPE_INT_4);
+}
@@ -99,6 +99,68 @@ void iree_uk_mmt4d_tile_f32f32f32_16x16x1_x86_64_avx512_base(
   _mm512_storeu_ps(out_ptr + 15 * 16, acc15);
 }
 
+// Narrow-M counterpart of the 16x16x1 tile function, for M0 = 1, 2, 4 or 8.
+// It is always inlined into the variants below so that M0 is a compile-time
+// constant and the loops over it unroll with the accumulators kept in
+// registers.
+static inline IREE_UK_ATTRIBUTE_ALWAYS_INLINE void
+iree_uk_mmt4d_tile_f32f32f32_Mx16x1_x86_64_avx512_base(
+    void* IREE_UK_RESTRICT out_tile, const void* IREE_UK_RESTRICT lhs_panel,
+    const void* IREE_UK_RESTRICT rhs_panel,
+    const iree_uk_mmt4d_params_t* params, int M0) {
+  IREE_UK_ASSUME(M0 >= 1 && M0 <= 8);
+  float* IREE_UK_RESTRICT out_ptr = out_tile;
+  const float* IREE_UK_RESTRICT lhs_ptr = lhs_panel;
+  const float* IREE_UK_RESTRICT rhs_ptr = rhs_panel;
+  __m512 acc[8];
+  if (params->flags & IREE_UK_FLAG_MMT4D_ACCUMULATE) {
+    for (int i = 0; i < M0; ++i) acc[i] = _mm512_loadu_ps(out_ptr + i * 16);
+  } else {
+    for (int i = 0; i < M0; ++i) acc[i] = _mm512_setzero_ps();
+  }
+  for (iree_uk_int32_t k = 0; k < params->K; ++k) {
+    __m512 rhs = _mm512_loadu_ps(rhs_ptr);
+    rhs_ptr += 16;
+    for (int i = 0; i < M0; ++i) {
+      acc[i] = _mm512_fmadd_ps(_mm512_set1_ps(lhs_ptr[i]), rhs, acc[i]);
+    }
+    lhs_ptr += M0;
+  }
+  for (int i = 0; i < M0; ++i) _mm512_storeu_ps(out_ptr + i * 16, acc[i]);
+}
+
+void iree_uk_mmt4d_tile_f32f32f32_1x16x1_x86_64_avx512_base(
+    void* IREE_UK_RESTRICT out_tile, const void* IREE_UK_RESTRICT lhs_panel,
+    const void* IREE_UK_RESTRICT rhs_panel,
+    const iree_uk_mmt4d_params_t* params) {
+  iree_uk_mmt4d_tile_f32f32f32_Mx16x1_x86_64_avx512_base(out_tile, lhs_panel,
+                                                        rhs_panel, params, 1);
+}
+
+void iree_uk_mmt4d_tile_f32f32f32_2x16x1_x86_64_avx512_base(
+    void* IREE_UK_RESTRICT out_tile, const void* IREE_UK_RESTRICT lhs_panel,
+    const void* IREE_UK_RESTRICT rhs_panel,
+    const iree_uk_mmt4d_params_t* params) {
+  iree_uk_mmt4d_tile_f32f32f32_Mx16x1_x86_64_avx512_base(out_tile, lhs_panel,
+                                                        rhs_panel, params, 2);
+}
+
+void iree_uk_mmt4d_tile_f32f32f32_4x16x1_x86_64_avx512_base(
+    void* IREE_UK_RESTRICT out_tile, const void* IREE_UK_RESTRICT lhs_panel,
+    const void* IREE_UK_RESTRICT rhs_panel,
+    const iree_uk_mmt4d_params_t* params) {
+  iree_uk_mmt4d_tile_f32f32f32_Mx16x1_x86_64_avx512_base(out_tile, lhs_panel,
+                                                        rhs_panel, params, 4);
+}
+
+void iree_uk_mmt4d_tile_f32f32f32_8x16x1_x86_64_avx512_base(
+    void* IREE_UK_RESTRICT out_tile, const void* IREE_UK_RESTRICT lhs_panel,
+    const void* IREE_UK_RESTRICT rhs_panel,
+    const iree_uk_mmt4d_params_t* params) {
+  iree_uk_mmt4d_tile_f32f32f32_Mx16x1_x86_64_avx512_base(out_tile, lhs_panel,
+                                                        rhs_panel, params, 8);
+}
+
 // Shared implementation for f16f16f16 and f16f16f32.
 // In the f16f16f16 case, intermediate roundings are skipped. This function
 // should only be used if IREE_UK_FLAG_MMT4D_SKIP_INTERMEDIATE_ROUNDINGS is set.
@@ -8,22 +8,42 @@
 #include "iree/builtins/ukernel/arch/x86_64/mmt4d_x86_64_internal.h"
 
 static iree_uk_mmt4d_tile_func_t
-iree_uk_mmt4d_select_tile_func_x86_64_f32f32f32_8x8x1(
+iree_uk_mmt4d_select_tile_func_x86_64_f32f32f32_Mx8x1(
     const iree_uk_mmt4d_params_t* params) {
 #if defined(IREE_UK_BUILD_X86_64_AVX2_FMA)
   if (iree_uk_cpu_supports_avx2_fma(params->cpu_data)) {
-    return iree_uk_mmt4d_tile_f32f32f32_8x8x1_x86_64_avx2_fma;
+    switch (params->M0) {
+      case 1:
+        return iree_uk_mmt4d_tile_f32f32f32_1x8x1_x86_64_avx2_fma;
+      case 2:
+        return iree_uk_mmt4d_tile_f32f32f32_2x8x1_x86_64_avx2_fma;
+      case 4:
+        return iree_uk_mmt4d_tile_f32f32f32_4x8x1_x86_64_avx2_fma;
+      case 8:
+        return iree_uk_mmt4d_tile_f32f32f32_8x8x1_x86_64_avx2_fma;
+    }
   }
 #endif
   return 0;
 }
 
 static iree_uk_mmt4d_tile_func_t
-iree_uk_mmt4d_select_tile_func_x86_64_f32f32f32_16x16x1(
+iree_uk_mmt4d_select_tile_func_x86_64_f32f32f32_Mx16x1(
     const iree_uk_mmt4d_params_t* params) {
 #if defined(IREE_UK_BUILD_X86_64_AVX512_BASE)
   if (iree_uk_cpu_supports_avx512_base(params->cpu_data)) {
-    return iree_uk_mmt4d_tile_f32f32f32_16x16x1_x86_64_avx512_base;
+    switch (params->M0) {
+      case 1:
+        return iree_uk_mmt4d_tile_f32f32f32_1x16x1_x86_64_avx512_base;
+      case 2:
+        return iree_uk_mmt4d_tile_f32f32f32_2x16x1_x86_64_avx512_base;
+      case 4:
+        return iree_uk_mmt4d_tile_f32f32f32_4x16x1_x86_64_avx512_base;
+      case 8:
+        return iree_uk_mmt4d_tile_f32f32f32_8x16x1_x86_64_avx512_base;
+      case 16:
+        return iree_uk_mmt4d_tile_f32f32f32_16x16x1_x86_64_avx512_base;
+    }
   }
 #endif
   return 0;
@@ -105,11 +125,11 @@ iree_uk_mmt4d_select_tile_func_x86_64_i8i8i32_8x8x2(
 static iree_uk_mmt4d_tile_func_t
 iree_uk_mmt4d_select_tile_func_x86_64_f32f32f32(
     const iree_uk_mmt4d_params_t* params) {
-  if (params->M0 == 16 && params->N0 == 16 && params->K0 == 1) {
-    return iree_uk_mmt4d_select_tile_func_x86_64_f32f32f32_16x16x1(params);
+  if (params->N0 == 16 && params->K0 == 1) {
+    return iree_uk_mmt4d_select_tile_func_x86_64_f32f32f32_Mx16x1(params);
   }
-  if (params->M0 == 8 && params->N0 == 8 && params->K0 == 1) {
-    return iree_uk_mmt4d_select_tile_func_x86_64_f32f32f32_8x8x1(params);
+  if (params->N0 == 8 && params->K0 == 1) {
+    return iree_uk_mmt4d_select_tile_func_x86_64_f32f32f32_Mx8x1(params);
   }
   return 0;
 }
@@ -181,3 +201,33 @@ iree_uk_mmt4d_tile_func_t iree_uk_mmt4d_select_tile_func_arch(
       return 0;
   }
 }
+
+static iree_uk_mmt4d_dequant_tile_func_t
+iree_uk_mmt4d_select_dequant_tile_func_x86_64_8x8x1(
+    const iree_uk_mmt4d_params_t* params) {
+#if defined(IREE_UK_BUILD_X86_64_AVX2_FMA)
+  if (iree_uk_cpu_supports_avx2_fma(params->cpu_data)) {
+    switch (iree_uk_mmt4d_type(params->flags)) {
+      case iree_uk_mmt4d_type_f32i8f32:
+        return iree_uk_mmt4d_tile_f32i8f32_8x8x1_x86_64_avx2_fma;
+      case iree_uk_mmt4d_type_f32i4f32:
+        return iree_uk_mmt4d_tile_f32i4f32_8x8x1_x86_64_avx2_fma;
+      case iree_uk_mmt4d_type_f16i8f32:
+        return iree_uk_mmt4d_tile_f16i8f32_8x8x1_x86_64_avx2_fma;
+      case iree_uk_mmt4d_type_f16i4f32:
+        return iree_uk_mmt4d_tile_f16i4f32_8x8x1_x86_64_avx2_fma;
+      default:
+        return 0;
+    }
+  }
+#endif
+  return 0;
+}
+
+iree_uk_mmt4d_dequant_tile_func_t iree_uk_mmt4d_select_dequant_tile_func_arch(
+    const iree_uk_mmt4d_params_t* params) {
+  if (params->M0 == 8 && params->N0 == 8 && params->K0 == 1) {
+    return iree_uk_mmt4d_select_dequant_tile_func_x86_64_8x8x1(params);
+  }
+  return 0;
+}
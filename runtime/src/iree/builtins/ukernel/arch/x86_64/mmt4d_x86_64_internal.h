@@ -10,11 +10,22 @@
 #include "iree/builtins/ukernel/mmt4d_internal.h"
 
 IREE_UK_MMT4D_TILE_FUNC_DECL(iree_uk_mmt4d_tile_i8i8i32_8x8x2_x86_64_avx2_fma)
+IREE_UK_MMT4D_TILE_FUNC_DECL(iree_uk_mmt4d_tile_f32f32f32_1x8x1_x86_64_avx2_fma)
+IREE_UK_MMT4D_TILE_FUNC_DECL(iree_uk_mmt4d_tile_f32f32f32_2x8x1_x86_64_avx2_fma)
+IREE_UK_MMT4D_TILE_FUNC_DECL(iree_uk_mmt4d_tile_f32f32f32_4x8x1_x86_64_avx2_fma)
 IREE_UK_MMT4D_TILE_FUNC_DECL(iree_uk_mmt4d_tile_f32f32f32_8x8x1_x86_64_avx2_fma)
 IREE_UK_MMT4D_TILE_FUNC_DECL(iree_uk_mmt4d_tile_f16f16f32_8x8x1_x86_64_avx2_fma)
 IREE_UK_MMT4D_TILE_FUNC_DECL(iree_uk_mmt4d_tile_f16f16f16_8x8x1_x86_64_avx2_fma)
 IREE_UK_MMT4D_TILE_FUNC_DECL(
     iree_uk_mmt4d_tile_i8i8i32_16x16x2_x86_64_avx512_base)
+IREE_UK_MMT4D_TILE_FUNC_DECL(
+    iree_uk_mmt4d_tile_f32f32f32_1x16x1_x86_64_avx512_base)
+IREE_UK_MMT4D_TILE_FUNC_DECL(
+    iree_uk_mmt4d_tile_f32f32f32_2x16x1_x86_64_avx512_base)
+IREE_UK_MMT4D_TILE_FUNC_DECL(
+    iree_uk_mmt4d_tile_f32f32f32_4x16x1_x86_64_avx512_base)
+IREE_UK_MMT4D_TILE_FUNC_DECL(
+    iree_uk_mmt4d_tile_f32f32f32_8x16x1_x86_64_avx512_base)
 IREE_UK_MMT4D_TILE_FUNC_DECL(
     iree_uk_mmt4d_tile_f32f32f32_16x16x1_x86_64_avx512_base)
 IREE_UK_MMT4D_TILE_FUNC_DECL(
@@ -25,4 +36,13 @@ IREE_UK_MMT4D_TILE_FUNC_DECL(
 IREE_UK_MMT4D_TILE_FUNC_DECL(
     iree_uk_mmt4d_tile_i8i8i32_16x16x2_x86_64_avx512_vnni)
 
+IREE_UK_MMT4D_DEQUANT_TILE_FUNC_DECL(
+    iree_uk_mmt4d_tile_f32i8f32_8x8x1_x86_64_avx2_fma)
+IREE_UK_MMT4D_DEQUANT_TILE_FUNC_DECL(
+    iree_uk_mmt4d_tile_f32i4f32_8x8x1_x86_64_avx2_fma)
+IREE_UK_MMT4D_DEQUANT_TILE_FUNC_DECL(
+    iree_uk_mmt4d_tile_f16i8f32_8x8x1_x86_64_avx2_fma)
+IREE_UK_MMT4D_DEQUANT_TILE_FUNC_DECL(
+    iree_uk_mmt4d_tile_f16i4f32_8x8x1_x86_64_avx2_fma)
+
 #endif  // foIREE_BUILTINS_UKERNEL_ARCH_X86_64_MMT4D_X86_64_INTERNAL_H_
@@ -146,3 +146,92 @@ void iree_uk_pack_tile_16x2_x8_x86_64_avx512_base_transpose(
     in_ptr += 16;
   }
 }
+
+void iree_uk_pack_tile_16x16_x32_x86_64_avx512_base_transpose(
+    void* IREE_UK_RESTRICT out_tile_ptr,
+    const void* IREE_UK_RESTRICT in_tile_ptr, iree_uk_index_t outer_size1,
+    iree_uk_index_t out_stride1, iree_uk_index_t in_stride0,
+    iree_uk_index_t elem_size, iree_uk_index_t tile_size0,
+    iree_uk_index_t tile_size1) {
+  IREE_UK_ASSERT(elem_size == 4);
+  IREE_UK_ASSERT(tile_size0 == 16);
+  IREE_UK_ASSERT(tile_size1 == 16);
+  const iree_uk_int8_t* IREE_UK_RESTRICT in_ptr = in_tile_ptr;
+  iree_uk_int8_t* IREE_UK_RESTRICT out_ptr = out_tile_ptr;
+  for (; outer_size1 > 0; --outer_size1) {
+    iree_uk_avx2_copy_16x16xi32_transpose_strided_to_strided(
+        out_ptr, in_ptr, 64, 4 * in_stride0);
+    out_ptr += 4 * out_stride1;
+    in_ptr += 64;
+  }
+}
+
+void iree_uk_pack_tile_16x16_x16_x86_64_avx512_base_direct(
+    void* IREE_UK_RESTRICT out_tile_ptr,
+    const void* IREE_UK_RESTRICT in_tile_ptr, iree_uk_index_t outer_size1,
+    iree_uk_index_t out_stride1, iree_uk_index_t in_stride0,
+    iree_uk_index_t elem_size, iree_uk_index_t tile_size0,
+    iree_uk_index_t tile_size1) {
+  IREE_UK_ASSERT(elem_size == 2);
+  IREE_UK_ASSERT(tile_size0 == 16);
+  IREE_UK_ASSERT(tile_size1 == 16);
+  const iree_uk_int8_t* IREE_UK_RESTRICT in_ptr = in_tile_ptr;
+  iree_uk_int8_t* IREE_UK_RESTRICT out_ptr = out_tile_ptr;
+  for (; outer_size1 > 0; --outer_size1) {
+    iree_uk_copy_16x32xi8_strided_to_strided(out_ptr, in_ptr, 32,
+                                             2 * in_stride0);
+    out_ptr += 2 * out_stride1;
+    in_ptr += 32;
+  }
+}
+
+void iree_uk_pack_tile_16x16_x16_x86_64_avx512_base_transpose(
+    void* IREE_UK_RESTRICT out_tile_ptr,
+    const void* IREE_UK_RESTRICT in_tile_ptr, iree_uk_index_t outer_size1,
+    iree_uk_index_t out_stride1, iree_uk_index_t in_stride0,
+    iree_uk_index_t elem_size, iree_uk_index_t tile_size0,
+    iree_uk_index_t tile_size1) {
+  IREE_UK_ASSERT(elem_size == 2);
+  IREE_UK_ASSERT(tile_size0 == 16);
+  IREE_UK_ASSERT(tile_size1 == 16);
+  const iree_uk_int8_t* IREE_UK_RESTRICT in_ptr = in_tile_ptr;
+  iree_uk_int8_t* IREE_UK_RESTRICT out_ptr = out_tile_ptr;
+  for (; outer_size1 > 0; --outer_size1) {
+    iree_uk_sse_copy_16x16xi16_transpose_strided_to_strided(
+        out_ptr, in_ptr, 32, 2 * in_stride0);
+    out_ptr += 2 * out_stride1;
+    in_ptr += 32;
+  }
+}
+
+void iree_uk_pack_tile_16x1_x16_x86_64_avx512_base_direct(
+    void* IREE_UK_RESTRICT out_tile_ptr,
+    const void* IREE_UK_RESTRICT in_tile_ptr, iree_uk_index_t outer_size1,
+    iree_uk_index_t out_stride1, iree_uk_index_t in_stride0,
+    iree_uk_index_t elem_size, iree_uk_index_t tile_size0,
+    iree_uk_index_t tile_size1) {
+  IREE_UK_ASSERT(elem_size == 2);
+  IREE_UK_ASSERT(tile_size0 == 16);
+  IREE_UK_ASSERT(tile_size1 == 1);
+  iree_uk_pack_tile_16x2_x8_x86_64_avx512_base_direct(
+      out_tile_ptr, in_tile_ptr, outer_size1, out_stride1 * 2, in_stride0 * 2,
+      1, 16, 2);
+}
+
+void iree_uk_pack_tile_16x1_x16_x86_64_avx512_base_transpose(
+    void* IREE_UK_RESTRICT out_tile_ptr,
+    const void* IREE_UK_RESTRICT in_tile_ptr, iree_uk_index_t outer_size1,
+    iree_uk_index_t out_stride1, iree_uk_index_t in_stride0,
+    iree_uk_index_t elem_size, iree_uk_index_t tile_size0,
+    iree_uk_index_t tile_size1) {
+  IREE_UK_ASSERT(elem_size == 2);
+  IREE_UK_ASSERT(tile_size0 == 1);
+  IREE_UK_ASSERT(tile_size1 == 16);
+  const iree_uk_int16_t* IREE_UK_RESTRICT in_tile_ptr_i16 = in_tile_ptr;
+  iree_uk_int16_t* IREE_UK_RESTRICT out_tile_i16_ptr = out_tile_ptr;
+  for (; outer_size1 > 0; --outer_size1) {
+    iree_uk_memcpy(out_tile_i16_ptr, in_tile_ptr_i16, 32);
+    out_tile_i16_ptr += out_stride1;
+    in_tile_ptr_i16 += 16;
+  }
+}
@@ -0,0 +1,77 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/builtins/ukernel/arch/x86_64/common_x86_64.h"
+#include "iree/builtins/ukernel/arch/x86_64/reduce_x86_64_internal.h"
+
+// Both kernels use 4 independent accumulators to hide the latency of the
+// vector add/max instructions, which otherwise bounds a single-chain loop.
+
+void iree_uk_reduce_tile_f32f32_sum_x86_64_avx2_fma(
+    void* IREE_UK_RESTRICT out_ptr, const void* IREE_UK_RESTRICT in_ptr,
+    iree_uk_index_t size, iree_uk_uint32_t flags) {
+  const float* in = in_ptr;
+  float* out = out_ptr;
+  iree_uk_index_t j = 0;
+  __m256 acc_0 = _mm256_setzero_ps();
+  __m256 acc_1 = acc_0;
+  __m256 acc_2 = acc_0;
+  __m256 acc_3 = acc_0;
+  for (; j + 32 <= size; j += 32) {
+    acc_0 = _mm256_add_ps(acc_0, _mm256_loadu_ps(in + j + 0));
+    acc_1 = _mm256_add_ps(acc_1, _mm256_loadu_ps(in + j + 8));
+    acc_2 = _mm256_add_ps(acc_2, _mm256_loadu_ps(in + j + 16));
+    acc_3 = _mm256_add_ps(acc_3, _mm256_loadu_ps(in + j + 24));
+  }
+  for (; j + 8 <= size; j += 8) {
+    acc_0 = _mm256_add_ps(acc_0, _mm256_loadu_ps(in + j));
+  }
+  acc_0 = _mm256_add_ps(_mm256_add_ps(acc_0, acc_1),
+                        _mm256_add_ps(acc_2, acc_3));
+  float acc = iree_uk_avx2_reduce_add_f32(acc_0);
+  for (; j < size; ++j) acc += in[j];
+  if (flags & IREE_UK_FLAG_REDUCE_ACCUMULATE) acc += *out;
+  *out = acc;
+}
+
+void iree_uk_reduce_tile_f32f32_max_x86_64_avx2_fma(
+    void* IREE_UK_RESTRICT out_ptr, const void* IREE_UK_RESTRICT in_ptr,
+    iree_uk_index_t size, iree_uk_uint32_t flags) {
+  const float* in = in_ptr;
+  float* out = out_ptr;
+  iree_uk_index_t j = 0;
+  __m256 acc_0 = _mm256_set1_ps(iree_uk_f32_neg_inf());
+  __m256 acc_1 = acc_0;
+  __m256 acc_2 = acc_0;
+  __m256 acc_3 = acc_0;
+  // Lanes that have seen a NaN, which vmaxps would drop.
+  __m256 unordered = _mm256_setzero_ps();
+  for (; j + 32 <= size; j += 32) {
+    __m256 x_0 = _mm256_loadu_ps(in + j + 0);
+    __m256 x_1 = _mm256_loadu_ps(in + j + 8);
+    __m256 x_2 = _mm256_loadu_ps(in + j + 16);
+    __m256 x_3 = _mm256_loadu_ps(in + j + 24);
+    acc_0 = _mm256_max_ps(acc_0, x_0);
+    acc_1 = _mm256_max_ps(acc_1, x_1);
+    acc_2 = _mm256_max_ps(acc_2, x_2);
+    acc_3 = _mm256_max_ps(acc_3, x_3);
+    unordered = _mm256_or_ps(
+        unordered, _mm256_or_ps(_mm256_cmp_ps(x_0, x_1, _CMP_UNORD_Q),
+                                _mm256_cmp_ps(x_2, x_3, _CMP_UNORD_Q)));
+  }
+  for (; j + 8 <= size; j += 8) {
+    __m256 x = _mm256_loadu_ps(in + j);
+    acc_0 = _mm256_max_ps(acc_0, x);
+    unordered = _mm256_or_ps(unordered, _mm256_cmp_ps(x, x, _CMP_UNORD_Q));
+  }
+  acc_0 = _mm256_max_ps(_mm256_max_ps(acc_0, acc_1),
+                        _mm256_max_ps(acc_2, acc_3));
+  float acc = _mm256_movemask_ps(unordered) ? iree_uk_f32_nan()
+                                            : iree_uk_avx2_reduce_max_f32(acc_0);
+  for (; j < size; ++j) acc = iree_uk_max_f32(acc, in[j]);
+  if (flags & IREE_UK_FLAG_REDUCE_ACCUMULATE) acc = iree_uk_max_f32(acc, *out);
+  *out = acc;
+}
@@ -0,0 +1,81 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/builtins/ukernel/arch/x86_64/common_x86_64.h"
+#include "iree/builtins/ukernel/arch/x86_64/reduce_x86_64_internal.h"
+
+// Both kernels use 4 independent accumulators to hide the latency of the
+// vector add/max instructions, and a masked load for the remainder.
+
+void iree_uk_reduce_tile_f32f32_sum_x86_64_avx512_base(
+    void* IREE_UK_RESTRICT out_ptr, const void* IREE_UK_RESTRICT in_ptr,
+    iree_uk_index_t size, iree_uk_uint32_t flags) {
+  const float* in = in_ptr;
+  float* out = out_ptr;
+  iree_uk_index_t j = 0;
+  __m512 acc_0 = _mm512_setzero_ps();
+  __m512 acc_1 = acc_0;
+  __m512 acc_2 = acc_0;
+  __m512 acc_3 = acc_0;
+  for (; j + 64 <= size; j += 64) {
+    acc_0 = _mm512_add_ps(acc_0, _mm512_loadu_ps(in + j + 0));
+    acc_1 = _mm512_add_ps(acc_1, _mm512_loadu_ps(in + j + 16));
+    acc_2 = _mm512_add_ps(acc_2, _mm512_loadu_ps(in + j + 32));
+    acc_3 = _mm512_add_ps(acc_3, _mm512_loadu_ps(in + j + 48));
+  }
+  for (; j + 16 <= size; j += 16) {
+    acc_0 = _mm512_add_ps(acc_0, _mm512_loadu_ps(in + j));
+  }
+  __mmask16 tail_mask = (1u << (size - j)) - 1;
+  acc_1 = _mm512_add_ps(acc_1, _mm512_maskz_loadu_ps(tail_mask, in + j));
+  acc_0 = _mm512_add_ps(_mm512_add_ps(acc_0, acc_1),
+                        _mm512_add_ps(acc_2, acc_3));
+  float acc = _mm512_reduce_add_ps(acc_0);
+  if (flags & IREE_UK_FLAG_REDUCE_ACCUMULATE) acc += *out;
+  *out = acc;
+}
+
+void iree_uk_reduce_tile_f32f32_max_x86_64_avx512_base(
+    void* IREE_UK_RESTRICT out_ptr, const void* IREE_UK_RESTRICT in_ptr,
+    iree_uk_index_t size, iree_uk_uint32_t flags) {
+  const float* in = in_ptr;
+  float* out = out_ptr;
+  iree_uk_index_t j = 0;
+  __m512 neg_inf = _mm512_set1_ps(iree_uk_f32_neg_inf());
+  __m512 acc_0 = neg_inf;
+  __m512 acc_1 = neg_inf;
+  __m512 acc_2 = neg_inf;
+  __m512 acc_3 = neg_inf;
+  // Lanes that have seen a NaN, which vmaxps would drop.
+  __mmask16 unordered = 0;
+  for (; j + 64 <= size; j += 64) {
+    __m512 x_0 = _mm512_loadu_ps(in + j + 0);
+    __m512 x_1 = _mm512_loadu_ps(in + j + 16);
+    __m512 x_2 = _mm512_loadu_ps(in + j + 32);
+    __m512 x_3 = _mm512_loadu_ps(in + j + 48);
+    acc_0 = _mm512_max_ps(acc_0, x_0);
+    acc_1 = _mm512_max_ps(acc_1, x_1);
+    acc_2 = _mm512_max_ps(acc_2, x_2);
+    acc_3 = _mm512_max_ps(acc_3, x_3);
+    unordered |= _mm512_cmp_ps_mask(x_0, x_1, _CMP_UNORD_Q) |
+                 _mm512_cmp_ps_mask(x_2, x_3, _CMP_UNORD_Q);
+  }
+  for (; j + 16 <= size; j += 16) {
+    __m512 x = _mm512_loadu_ps(in + j);
+    acc_0 = _mm512_max_ps(acc_0, x);
+    unordered |= _mm512_cmp_ps_mask(x, x, _CMP_UNORD_Q);
+  }
+  __mmask16 tail_mask = (1u << (size - j)) - 1;
+  __m512 tail = _mm512_mask_loadu_ps(neg_inf, tail_mask, in + j);
+  acc_1 = _mm512_max_ps(acc_1, tail);
+  unordered |= _mm512_cmp_ps_mask(tail, tail, _CMP_UNORD_Q);
+  acc_0 = _mm512_max_ps(_mm512_max_ps(acc_0, acc_1),
+                        _mm512_max_ps(acc_2, acc_3));
+  float acc =
+      unordered ? iree_uk_f32_nan() : _mm512_reduce_max_ps(acc_0);
+  if (flags & IREE_UK_FLAG_REDUCE_ACCUMULATE) acc = iree_uk_max_f32(acc, *out);
+  *out = acc;
+}
@@ -0,0 +1,19 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_BUILTINS_UKERNEL_ARCH_X86_64_REDUCE_X86_64_INTERNAL_H_
+#define IREE_BUILTINS_UKERNEL_ARCH_X86_64_REDUCE_X86_64_INTERNAL_H_
+
+#include "iree/builtins/ukernel/reduce_internal.h"
+
+IREE_UK_REDUCE_TILE_FUNC_DECL(iree_uk_reduce_tile_f32f32_sum_x86_64_avx2_fma)
+IREE_UK_REDUCE_TILE_FUNC_DECL(iree_uk_reduce_tile_f32f32_max_x86_64_avx2_fma)
+IREE_UK_REDUCE_TILE_FUNC_DECL(
+    iree_uk_reduce_tile_f32f32_sum_x86_64_avx512_base)
+IREE_UK_REDUCE_TILE_FUNC_DECL(
+    iree_uk_reduce_tile_f32f32_max_x86_64_avx512_base)
+
+#endif  // IREE_BUILTINS_UKERNEL_ARCH_X86_64_REDUCE_X86_64_INTERNAL_H_
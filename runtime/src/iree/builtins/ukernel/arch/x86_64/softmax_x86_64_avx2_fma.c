@@ -0,0 +1,62 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/builtins/ukernel/arch/x86_64/common_x86_64.h"
+#include "iree/builtins/ukernel/arch/x86_64/softmax_x86_64_internal.h"
+
+void iree_uk_softmax_tile_f32f32_x86_64_avx2_fma(void* out_ptr,
+                                                 const void* in_ptr,
+                                                 iree_uk_index_t size) {
+  const float* in = in_ptr;
+  float* out = out_ptr;
+  iree_uk_index_t j = 0;
+  // Pass 1: row maximum. Two accumulators to hide the vmaxps latency.
+  __m256 max_0 = _mm256_set1_ps(iree_uk_f32_neg_inf());
+  __m256 max_1 = max_0;
+  // Lanes that have seen a NaN, which vmaxps would drop. As with the
+  // decomposed softmax, a NaN anywhere in the row makes the whole row NaN.
+  __m256 unordered = _mm256_setzero_ps();
+  for (; j + 16 <= size; j += 16) {
+    __m256 x_0 = _mm256_loadu_ps(in + j);
+    __m256 x_1 = _mm256_loadu_ps(in + j + 8);
+    max_0 = _mm256_max_ps(max_0, x_0);
+    max_1 = _mm256_max_ps(max_1, x_1);
+    unordered =
+        _mm256_or_ps(unordered, _mm256_cmp_ps(x_0, x_1, _CMP_UNORD_Q));
+  }
+  for (; j + 8 <= size; j += 8) {
+    __m256 x = _mm256_loadu_ps(in + j);
+    max_0 = _mm256_max_ps(max_0, x);
+    unordered = _mm256_or_ps(unordered, _mm256_cmp_ps(x, x, _CMP_UNORD_Q));
+  }
+  float max =
+      _mm256_movemask_ps(unordered)
+          ? iree_uk_f32_nan()
+          : iree_uk_avx2_reduce_max_f32(_mm256_max_ps(max_0, max_1));
+  for (; j < size; ++j) max = iree_uk_max_f32(max, in[j]);
+  // Pass 2: exponentials, stored to the output, and their sum.
+  __m256 max_v = _mm256_set1_ps(max);
+  __m256 sum_v = _mm256_setzero_ps();
+  for (j = 0; j + 8 <= size; j += 8) {
+    __m256 x = _mm256_loadu_ps(in + j);
+    __m256 e = iree_uk_avx2_exp_f32(_mm256_sub_ps(x, max_v));
+    _mm256_storeu_ps(out + j, e);
+    sum_v = _mm256_add_ps(sum_v, e);
+  }
+  float sum = iree_uk_avx2_reduce_add_f32(sum_v);
+  for (; j < size; ++j) {
+    float e = iree_uk_exp_f32(in[j] - max);
+    out[j] = e;
+    sum += e;
+  }
+  // Pass 3: normalization.
+  float scale = 1.0f / sum;
+  __m256 scale_v = _mm256_set1_ps(scale);
+  for (j = 0; j + 8 <= size; j += 8) {
+    _mm256_storeu_ps(out + j, _mm256_mul_ps(_mm256_loadu_ps(out + j), scale_v));
+  }
+  for (; j < size; ++j) out[j] *= scale;
+}
@@ -0,0 +1,68 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/builtins/ukernel/arch/x86_64/common_x86_64.h"
+#include "iree/builtins/ukernel/arch/x86_64/softmax_x86_64_internal.h"
+
+// Remainders are handled with masked loads and stores, so every element goes
+// through the same vectorized exp and results do not depend on the alignment of
+// the row length.
+void iree_uk_softmax_tile_f32f32_x86_64_avx512_base(void* out_ptr,
+                                                    const void* in_ptr,
+                                                    iree_uk_index_t size) {
+  const float* in = in_ptr;
+  float* out = out_ptr;
+  __mmask16 tail_mask = (1u << (size & 15)) - 1;
+  iree_uk_index_t j = 0;
+  // Pass 1: row maximum. Two accumulators to hide the vmaxps latency.
+  __m512 neg_inf = _mm512_set1_ps(iree_uk_f32_neg_inf());
+  __m512 max_0 = neg_inf;
+  __m512 max_1 = neg_inf;
+  // Lanes that have seen a NaN, which vmaxps would drop. As with the
+  // decomposed softmax, a NaN anywhere in the row makes the whole row NaN.
+  __mmask16 unordered = 0;
+  for (; j + 32 <= size; j += 32) {
+    __m512 x_0 = _mm512_loadu_ps(in + j);
+    __m512 x_1 = _mm512_loadu_ps(in + j + 16);
+    max_0 = _mm512_max_ps(max_0, x_0);
+    max_1 = _mm512_max_ps(max_1, x_1);
+    unordered |= _mm512_cmp_ps_mask(x_0, x_1, _CMP_UNORD_Q);
+  }
+  for (; j + 16 <= size; j += 16) {
+    __m512 x = _mm512_loadu_ps(in + j);
+    max_0 = _mm512_max_ps(max_0, x);
+    unordered |= _mm512_cmp_ps_mask(x, x, _CMP_UNORD_Q);
+  }
+  __m512 tail = _mm512_mask_loadu_ps(neg_inf, tail_mask, in + j);
+  max_1 = _mm512_max_ps(max_1, tail);
+  unordered |= _mm512_cmp_ps_mask(tail, tail, _CMP_UNORD_Q);
+  float max = unordered ? iree_uk_f32_nan()
+                        : _mm512_reduce_max_ps(_mm512_max_ps(max_0, max_1));
+  // Pass 2: exponentials, stored to the output, and their sum.
+  __m512 max_v = _mm512_set1_ps(max);
+  __m512 sum_v = _mm512_setzero_ps();
+  for (j = 0; j + 16 <= size; j += 16) {
+    __m512 x = _mm512_loadu_ps(in + j);
+    __m512 e = iree_uk_avx512_exp_f32(_mm512_sub_ps(x, max_v));
+    _mm512_storeu_ps(out + j, e);
+    sum_v = _mm512_add_ps(sum_v, e);
+  }
+  if (tail_mask) {
+    __m512 x = _mm512_maskz_loadu_ps(tail_mask, in + j);
+    __m512 e = iree_uk_avx512_exp_f32(_mm512_sub_ps(x, max_v));
+    _mm512_mask_storeu_ps(out + j, tail_mask, e);
+    sum_v = _mm512_mask_add_ps(sum_v, tail_mask, sum_v, e);
+  }
+  // Pass 3: normalization.
+  __m512 scale_v = _mm512_set1_ps(1.0f / _mm512_reduce_add_ps(sum_v));
+  for (j = 0; j + 16 <= size; j += 16) {
+    _mm512_storeu_ps(out + j, _mm512_mul_ps(_mm512_loadu_ps(out + j), scale_v));
+  }
+  if (tail_mask) {
+    __m512 e = _mm512_maskz_loadu_ps(tail_mask, out + j);
+    _mm512_mask_storeu_ps(out + j, tail_mask, _mm512_mul_ps(e, scale_v));
+  }
+}
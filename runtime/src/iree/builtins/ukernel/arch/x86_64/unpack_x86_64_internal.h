@@ -11,7 +11,19 @@
 
 IREE_UK_UNPACK_TILE_FUNC_DECL(
     iree_uk_unpack_tile_8x8_x32_x86_64_avx2_fma_direct)
+IREE_UK_UNPACK_TILE_FUNC_DECL(
+    iree_uk_unpack_tile_8x8_x32_x86_64_avx2_fma_transpose)
 IREE_UK_UNPACK_TILE_FUNC_DECL(
     iree_uk_unpack_tile_16x16_x32_x86_64_avx512_base_direct)
+IREE_UK_UNPACK_TILE_FUNC_DECL(
+    iree_uk_unpack_tile_16x16_x32_x86_64_avx512_base_transpose)
+IREE_UK_UNPACK_TILE_FUNC_DECL(
+    iree_uk_unpack_tile_8x8_x16_x86_64_avx2_fma_direct)
+IREE_UK_UNPACK_TILE_FUNC_DECL(
+    iree_uk_unpack_tile_8x8_x16_x86_64_avx2_fma_transpose)
+IREE_UK_UNPACK_TILE_FUNC_DECL(
+    iree_uk_unpack_tile_16x16_x16_x86_64_avx512_base_direct)
+IREE_UK_UNPACK_TILE_FUNC_DECL(
+    iree_uk_unpack_tile_16x16_x16_x86_64_avx512_base_transpose)
 
 #endif  // IREE_BUILTINS_UKERNEL_ARCH_X86_64_UNPACK_X86_64_INTERNAL_H_
@@ -0,0 +1,63 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/builtins/ukernel/batch_mmt4d.h"
+
+#include "iree/builtins/ukernel/mmt4d_internal.h"
+
+static void iree_uk_batch_mmt4d_validate(
+    const iree_uk_batch_mmt4d_params_t* params) {
+#ifdef IREE_UK_ENABLE_ASSERTS
+  IREE_UK_ASSERT(IREE_UK_VALUE_IN_UNSIGNED_INT_RANGE(params->batch_size, 31));
+  // Weight-only quantized types would also need batched RHS scales.
+  iree_uk_uint32_t flags_type = params->flags & IREE_UK_FLAG_MMT4D_TYPE_MASK;
+  IREE_UK_ASSERT(flags_type == IREE_UK_FLAG_MMT4D_TYPE_F32F32F32 ||
+                 flags_type == IREE_UK_FLAG_MMT4D_TYPE_I8I8I32 ||
+                 flags_type == IREE_UK_FLAG_MMT4D_TYPE_F16F16F32 ||
+                 flags_type == IREE_UK_FLAG_MMT4D_TYPE_F16F16F16 ||
+                 flags_type == IREE_UK_FLAG_MMT4D_TYPE_BF16BF16F32 ||
+                 flags_type == IREE_UK_FLAG_MMT4D_TYPE_BF16BF16BF16);
+  // The rest is validated by mmt4d, for each batch.
+#endif  // IREE_UK_ENABLE_ASSERTS
+}
+
+IREE_UK_EXPORT int iree_uk_batch_mmt4d(
+    const iree_uk_batch_mmt4d_params_t* params) {
+  iree_uk_batch_mmt4d_validate(params);
+
+  iree_uk_mmt4d_params_t mmt4d_params = {
+      .lhs_buffer = params->lhs_buffer,
+      .lhs_offset = params->lhs_offset,
+      .lhs_stride0 = params->lhs_stride1,
+      .rhs_buffer = params->rhs_buffer,
+      .rhs_offset = params->rhs_offset,
+      .rhs_stride0 = params->rhs_stride1,
+      .out_buffer = params->out_buffer,
+      .out_offset = params->out_offset,
+      .out_stride0 = params->out_stride1,
+      .M = params->M,
+      .N = params->N,
+      .K = params->K,
+      .M0 = params->M0,
+      .N0 = params->N0,
+      .K0 = params->K0,
+      .flags = params->flags,
+      .cpu_data = params->cpu_data,
+  };
+  if (params->batch_size == 0) return 0;
+
+  // The tile function only depends on the type, the tile sizes and the CPU
+  // features, which are the same for all batches, so select it only once.
+  iree_uk_mmt4d_tile_func_t tile_func =
+      iree_uk_mmt4d_select_tile_func(&mmt4d_params);
+  for (iree_uk_index_t b = 0; b < params->batch_size; ++b) {
+    iree_uk_mmt4d_with_tile_func(&mmt4d_params, tile_func);
+    mmt4d_params.lhs_offset += params->lhs_stride0;
+    mmt4d_params.rhs_offset += params->rhs_stride0;
+    mmt4d_params.out_offset += params->out_stride0;
+  }
+  return 0;
+}
@@ -173,6 +173,12 @@ extern "C" {
 #define IREE_UK_ATTRIBUTE_NOINLINE
 #endif  // IREE_UK_HAVE_ATTRIBUTE(noinline)
 
+#if IREE_UK_HAVE_ATTRIBUTE(always_inline) || defined(IREE_UK_COMPILER_GCC)
+#define IREE_UK_ATTRIBUTE_ALWAYS_INLINE __attribute__((always_inline))
+#else
+#define IREE_UK_ATTRIBUTE_ALWAYS_INLINE
+#endif  // IREE_UK_HAVE_ATTRIBUTE(always_inline)
+
 #if defined(IREE_UK_COMPILER_CLANG_OR_GCC)
 #define IREE_UK_LIKELY(x) (__builtin_expect(!!(x), 1))
 #define IREE_UK_UNLIKELY(x) (__builtin_expect(!!(x), 0))
@@ -461,6 +467,7 @@ enum {
   IREE_UK_TYPE_OPAQUE_16 = IREE_UK_TYPE_CATEGORY_OPAQUE | 4,
   IREE_UK_TYPE_OPAQUE_32 = IREE_UK_TYPE_CATEGORY_OPAQUE | 5,
   IREE_UK_TYPE_OPAQUE_64 = IREE_UK_TYPE_CATEGORY_OPAQUE | 6,
+  IREE_UK_TYPE_INT_4 = IREE_UK_TYPE_CATEGORY_INTEGER | 2,
   IREE_UK_TYPE_INT_8 = IREE_UK_TYPE_CATEGORY_INTEGER | 3,
   IREE_UK_TYPE_INT_16 = IREE_UK_TYPE_CATEGORY_INTEGER | 4,
   IREE_UK_TYPE_INT_32 = IREE_UK_TYPE_CATEGORY_INTEGER | 5,
@@ -508,6 +515,15 @@ static inline int iree_uk_type_size(iree_uk_type_t t) {
   return 1 << iree_uk_type_size_log2(t);
 }
 
+// Returns the size in bytes of |count| consecutive elements of type |t|.
+// Unlike iree_uk_type_size, this supports sub-byte types such as
+// IREE_UK_TYPE_INT_4, in which case |count| elements must fill a whole number
+// of bytes.
+static inline iree_uk_index_t iree_uk_type_size_of_elements(
+    iree_uk_type_t t, iree_uk_index_t count) {
+  return (count << iree_uk_type_bit_count_log2(t)) >> 3;
+}
+
 //===----------------------------------------------------------------------===//
 // Tuples of types, packed ("tied") into a word.
 //===----------------------------------------------------------------------===//
@@ -828,6 +844,91 @@ static inline iree_uk_uint16_t iree_uk_f32_to_bf16(float value) {
   return iree_uk_f32_to_generic_fp16(value, 8);
 }
 
+//===----------------------------------------------------------------------===//
+// Fast f32 elementary functions.
+//===----------------------------------------------------------------------===//
+
+// Bit-casts between float and its uint32 representation.
+static inline iree_uk_uint32_t iree_uk_f32_bits(float value) {
+  iree_uk_uint32_t bits;
+  iree_uk_memcpy(&bits, &value, sizeof bits);
+  return bits;
+}
+
+static inline float iree_uk_f32_from_bits(iree_uk_uint32_t bits) {
+  float value;
+  iree_uk_memcpy(&value, &bits, sizeof value);
+  return value;
+}
+
+static inline float iree_uk_f32_neg_inf(void) {
+  return iree_uk_f32_from_bits(0xFF800000u);
+}
+
+static inline float iree_uk_f32_nan(void) {
+  return iree_uk_f32_from_bits(0x7FC00000u);
+}
+
+// Maximum propagating NaNs from either operand, like arith.maxf.
+static inline float iree_uk_max_f32(float a, float b) {
+  return (a > b || a != a) ? a : b;
+}
+
+static inline float iree_uk_sqrt_f32(float x) {
+#if defined(IREE_UK_COMPILER_CLANG_OR_GCC)
+  return __builtin_sqrtf(x);
+#else
+  // Newton-Raphson from an exponent-halving initial guess. Only reached on
+  // toolchains without __builtin_sqrtf; not used in performance-critical loops.
+  if (x == 0.0f) return x;
+  if (!(x > 0.0f)) return iree_uk_f32_from_bits(0x7FC00000u);
+  float y = iree_uk_f32_from_bits((iree_uk_f32_bits(x) >> 1) + 0x1FBD1DF5u);
+  for (int i = 0; i < 4; ++i) y = 0.5f * (y + x / y);
+  return y;
+#endif
+}
+
+// Constants shared by the scalar and SIMD fast exp implementations, so that
+// all code paths agree to within rounding differences. This is the Cephes
+// expf algorithm: range reduction x = n * ln(2) + r with |r| <= ln(2)/2 using a
+// two-constant (hi/lo) Cody-Waite split of ln(2), a degree-5 polynomial for
+// exp(r) and a reconstruction of 2^n from its exponent bits. The relative error
+// is within a few ulp over the whole clamped range.
+//
+// Inputs below IREE_UK_EXP_F32_MIN_INPUT flush to 0 (so exp(-inf) == 0, as
+// required by masked softmax) and inputs above IREE_UK_EXP_F32_MAX_INPUT
+// saturate. NaN propagates.
+#define IREE_UK_EXP_F32_MIN_INPUT -87.0f
+#define IREE_UK_EXP_F32_MAX_INPUT 88.0f
+#define IREE_UK_EXP_F32_LOG2E 1.44269504088896341f
+#define IREE_UK_EXP_F32_LN2_HI 0.693359375f
+#define IREE_UK_EXP_F32_LN2_LO -2.12194440e-4f
+#define IREE_UK_EXP_F32_P0 1.9875691500e-4f
+#define IREE_UK_EXP_F32_P1 1.3981999507e-3f
+#define IREE_UK_EXP_F32_P2 8.3334519073e-3f
+#define IREE_UK_EXP_F32_P3 4.1665795894e-2f
+#define IREE_UK_EXP_F32_P4 1.6666665459e-1f
+#define IREE_UK_EXP_F32_P5 5.0000001201e-1f
+
+// Fast approximation of exp(x). See the IREE_UK_EXP_F32_* constants above.
+static inline float iree_uk_exp_f32(float x) {
+  if (x != x) return x;
+  if (x < IREE_UK_EXP_F32_MIN_INPUT) return 0.0f;
+  if (x > IREE_UK_EXP_F32_MAX_INPUT) x = IREE_UK_EXP_F32_MAX_INPUT;
+  float t = x * IREE_UK_EXP_F32_LOG2E;
+  iree_uk_int32_t n = (iree_uk_int32_t)(t + (t >= 0.0f ? 0.5f : -0.5f));
+  float r = x - (float)n * IREE_UK_EXP_F32_LN2_HI;
+  r = r - (float)n * IREE_UK_EXP_F32_LN2_LO;
+  float p = IREE_UK_EXP_F32_P0;
+  p = p * r + IREE_UK_EXP_F32_P1;
+  p = p * r + IREE_UK_EXP_F32_P2;
+  p = p * r + IREE_UK_EXP_F32_P3;
+  p = p * r + IREE_UK_EXP_F32_P4;
+  p = p * r + IREE_UK_EXP_F32_P5;
+  float y = p * r * r + r + 1.0f;
+  return y * iree_uk_f32_from_bits((iree_uk_uint32_t)(n + 127) << 23);
+}
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif  // __cplusplus
@@ -49,6 +49,12 @@
 #define IREE_UK_FLAG_MMT4D_TYPE_F16F16F16 0x04
 #define IREE_UK_FLAG_MMT4D_TYPE_BF16BF16F32 0x05
 #define IREE_UK_FLAG_MMT4D_TYPE_BF16BF16BF16 0x06
+// Weight-only quantized types: float LHS, signed integer RHS dequantized with
+// per-group scales (see iree_uk_mmt4d_dequant_params_t).
+#define IREE_UK_FLAG_MMT4D_TYPE_F32I4F32 0x07
+#define IREE_UK_FLAG_MMT4D_TYPE_F32I8F32 0x08
+#define IREE_UK_FLAG_MMT4D_TYPE_F16I4F32 0x09
+#define IREE_UK_FLAG_MMT4D_TYPE_F16I8F32 0x0A
 
 // bit flags
 #define IREE_UK_FLAG_MMT4D_ACCUMULATE 0x100
@@ -90,6 +96,46 @@ IREE_UK_ENSURE_CONSISTENT_FLAG(IREE_UK_FLAG_MMT4D_ACCUMULATE);
 #define IREE_UK_FLAG_UNPACK_TRANSPOSE_INNER 0x100
 #define IREE_UK_FLAG_UNPACK_TRANSPOSE_OUTER 0x200
 
+//===----------------------------------------------------------------------===//
+// softmax
+//===----------------------------------------------------------------------===//
+
+// type enum
+#define IREE_UK_FLAG_SOFTMAX_TYPE_MASK 0xFF
+#define IREE_UK_FLAG_SOFTMAX_TYPE_NONE 0x00
+#define IREE_UK_FLAG_SOFTMAX_TYPE_F32F32 0x01
+
+//===----------------------------------------------------------------------===//
+// layernorm
+//===----------------------------------------------------------------------===//
+
+// type enum
+#define IREE_UK_FLAG_LAYERNORM_TYPE_MASK 0xFF
+#define IREE_UK_FLAG_LAYERNORM_TYPE_NONE 0x00
+#define IREE_UK_FLAG_LAYERNORM_TYPE_F32F32 0x01
+
+// bit flags
+// Computes RMSnorm instead of layernorm: no mean subtraction, no beta.
+#define IREE_UK_FLAG_LAYERNORM_RMS 0x100
+
+//===----------------------------------------------------------------------===//
+// reduce
+//===----------------------------------------------------------------------===//
+
+// type enum
+#define IREE_UK_FLAG_REDUCE_TYPE_MASK 0xFF
+#define IREE_UK_FLAG_REDUCE_TYPE_NONE 0x00
+#define IREE_UK_FLAG_REDUCE_TYPE_F32F32 0x01
+
+// reduction operation enum
+#define IREE_UK_FLAG_REDUCE_OP_MASK 0xF00
+#define IREE_UK_FLAG_REDUCE_OP_NONE 0x000
+#define IREE_UK_FLAG_REDUCE_OP_SUM 0x100
+#define IREE_UK_FLAG_REDUCE_OP_MAX 0x200
+
+// bit flags
+#define IREE_UK_FLAG_REDUCE_ACCUMULATE 0x1000
+
 //===----------------------------------------------------------------------===//
 // query_tile_sizes
 //===----------------------------------------------------------------------===//
@@ -0,0 +1,74 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/builtins/ukernel/layernorm_internal.h"
+
+static void iree_uk_layernorm_validate(
+    const iree_uk_layernorm_params_t* params) {
+#ifdef IREE_UK_ENABLE_ASSERTS
+  const iree_uk_uint32_t allflags =
+      IREE_UK_FLAG_LAYERNORM_TYPE_MASK | IREE_UK_FLAG_LAYERNORM_RMS;
+  IREE_UK_ASSERT(!(params->flags & ~allflags));
+  iree_uk_uint32_t flags_type =
+      params->flags & IREE_UK_FLAG_LAYERNORM_TYPE_MASK;
+  IREE_UK_ASSERT(flags_type == IREE_UK_FLAG_LAYERNORM_TYPE_F32F32);
+  IREE_UK_ASSERT(params->size0 >= 0);
+  IREE_UK_ASSERT(params->size1 >= 0);
+  IREE_UK_ASSERT(params->in_stride0 >= params->size1 || params->size0 <= 1);
+  IREE_UK_ASSERT(params->out_stride0 >= params->size1 || params->size0 <= 1);
+  IREE_UK_ASSERT(params->epsilon >= 0.0f);
+  IREE_UK_ASSERT(params->gamma_buffer);
+  IREE_UK_ASSERT(params->gamma_stride0 == 1 || params->size1 <= 1);
+  if (!(params->flags & IREE_UK_FLAG_LAYERNORM_RMS)) {
+    IREE_UK_ASSERT(params->beta_buffer);
+    IREE_UK_ASSERT(params->beta_stride0 == 1 || params->size1 <= 1);
+  }
+#endif  // IREE_UK_ENABLE_ASSERTS
+}
+
+// Early-return implementation for this ukernel. Returns true if already done.
+static bool iree_uk_layernorm_early(const iree_uk_layernorm_params_t* params) {
+  return params->size0 == 0 || params->size1 == 0;
+}
+
+static void iree_uk_layernorm_using_tile_func(
+    const iree_uk_layernorm_params_t* params,
+    iree_uk_layernorm_tile_func_t tile_func) {
+  iree_uk_layernorm_type_t layernorm_type =
+      iree_uk_layernorm_type(params->flags);
+  iree_uk_index_t in_elem_size =
+      iree_uk_type_size(iree_uk_layernorm_in_type(layernorm_type));
+  iree_uk_index_t out_elem_size =
+      iree_uk_type_size(iree_uk_layernorm_out_type(layernorm_type));
+  const char* in_ptr =
+      (const char*)params->in_buffer + params->in_offset * in_elem_size;
+  char* out_ptr = (char*)params->out_buffer + params->out_offset * out_elem_size;
+  // gamma and beta have the input element type.
+  const char* gamma_ptr =
+      (const char*)params->gamma_buffer + params->gamma_offset * in_elem_size;
+  const char* beta_ptr =
+      params->beta_buffer
+          ? (const char*)params->beta_buffer + params->beta_offset * in_elem_size
+          : 0;
+  for (iree_uk_index_t i = 0; i < params->size0; ++i) {
+    tile_func(out_ptr, in_ptr, gamma_ptr, beta_ptr, params->size1,
+              params->epsilon);
+    in_ptr += params->in_stride0 * in_elem_size;
+    out_ptr += params->out_stride0 * out_elem_size;
+  }
+}
+
+IREE_UK_EXPORT int iree_uk_layernorm(const iree_uk_layernorm_params_t* params) {
+  iree_uk_layernorm_validate(params);
+
+  if (iree_uk_layernorm_early(params)) return 0;
+
+  // Select a target-specific tile_func and use that with generic outer loops.
+  iree_uk_layernorm_tile_func_t func =
+      iree_uk_layernorm_select_tile_func(params);
+  iree_uk_layernorm_using_tile_func(params, func);
+  return 0;
+}
@@ -0,0 +1,58 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_BUILTINS_UKERNEL_LAYERNORM_H_
+#define IREE_BUILTINS_UKERNEL_LAYERNORM_H_
+
+#include "iree/builtins/ukernel/common.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+// `layernorm` microkernel. Normalizes each row of a 2D input along its
+// innermost dimension and applies the per-column affine transform given by the
+// 1D `gamma` and `beta` vectors of length `size1`:
+//   out[i, j] = (in[i, j] - mean_i) / sqrt(var_i + epsilon) * gamma[j]
+//               + beta[j]
+// With IREE_UK_FLAG_LAYERNORM_RMS this is RMSnorm instead:
+//   out[i, j] = in[i, j] / sqrt(mean_j(in[i, :]^2) + epsilon) * gamma[j]
+// in which case `beta` is ignored and may be NULL.
+//
+// `gamma` and `beta` must be contiguous: their strides, which the compiler
+// passes along with every 1D operand, must be 1.
+//
+// Layernorm reaches codegen as reductions computing the row statistics followed
+// by an elementwise op normalizing the rows. On LLVMCPU, the ukernel lowering
+// matches that elementwise op together with the reductions feeding it.
+
+typedef struct iree_uk_layernorm_params_t {
+  const void* in_buffer;
+  iree_uk_index_t in_offset;
+  iree_uk_index_t in_stride0;
+  const void* gamma_buffer;
+  iree_uk_index_t gamma_offset;
+  iree_uk_index_t gamma_stride0;
+  const void* beta_buffer;
+  iree_uk_index_t beta_offset;
+  iree_uk_index_t beta_stride0;
+  void* out_buffer;
+  iree_uk_index_t out_offset;
+  iree_uk_index_t out_stride0;
+  iree_uk_index_t size0;
+  iree_uk_index_t size1;
+  float epsilon;
+  iree_uk_uint32_t flags;
+  const iree_uk_uint64_t* cpu_data;
+} iree_uk_layernorm_params_t;
+
+IREE_UK_EXPORT int iree_uk_layernorm(const iree_uk_layernorm_params_t* params);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif  // IREE_BUILTINS_UKERNEL_LAYERNORM_H_
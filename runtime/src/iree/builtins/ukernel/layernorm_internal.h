@@ -0,0 +1,59 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_BUILTINS_UKERNEL_LAYERNORM_INTERNAL_H_
+#define IREE_BUILTINS_UKERNEL_LAYERNORM_INTERNAL_H_
+
+#include "iree/builtins/ukernel/layernorm.h"
+
+typedef enum iree_uk_layernorm_type_t {
+  iree_uk_layernorm_type_f32f32 =
+      IREE_UK_TIE_2_TYPES_LITERAL(FLOAT_32, FLOAT_32),
+} iree_uk_layernorm_type_t;
+
+static inline iree_uk_layernorm_type_t iree_uk_layernorm_type(
+    iree_uk_uint32_t flags) {
+  switch (flags & IREE_UK_FLAG_LAYERNORM_TYPE_MASK) {
+    case IREE_UK_FLAG_LAYERNORM_TYPE_F32F32:
+      return iree_uk_layernorm_type_f32f32;
+    default:
+      IREE_UK_ASSUME_UNREACHABLE;
+  }
+}
+
+static inline iree_uk_type_t iree_uk_layernorm_in_type(
+    iree_uk_layernorm_type_t type) {
+  return iree_uk_untie_type(0, type);
+}
+
+static inline iree_uk_type_t iree_uk_layernorm_out_type(
+    iree_uk_layernorm_type_t type) {
+  return iree_uk_untie_type(1, type);
+}
+
+// A layernorm "tile" is a single row. out_ptr may alias in_ptr exactly.
+// beta_ptr is unused (and may be NULL) by RMSnorm tile functions.
+typedef void (*iree_uk_layernorm_tile_func_t)(
+    void* out_ptr, const void* in_ptr, const void* IREE_UK_RESTRICT gamma_ptr,
+    const void* IREE_UK_RESTRICT beta_ptr, iree_uk_index_t size,
+    float epsilon);
+
+// Tile kernel declarations. Prototype matches iree_uk_layernorm_tile_func_t.
+#define IREE_UK_LAYERNORM_TILE_FUNC_DECL(NAME)                           \
+  void NAME(void* out_ptr, const void* in_ptr,                           \
+            const void* IREE_UK_RESTRICT gamma_ptr,                      \
+            const void* IREE_UK_RESTRICT beta_ptr, iree_uk_index_t size, \
+            float epsilon);
+
+// Returns the tile function to use for the layernorm op with the given params.
+iree_uk_layernorm_tile_func_t iree_uk_layernorm_select_tile_func(
+    const iree_uk_layernorm_params_t* params);
+
+// Architecture-specific implementation.
+iree_uk_layernorm_tile_func_t iree_uk_layernorm_select_tile_func_arch(
+    const iree_uk_layernorm_params_t* params);
+
+#endif  // IREE_BUILTINS_UKERNEL_LAYERNORM_INTERNAL_H_
@@ -0,0 +1,68 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/builtins/ukernel/layernorm_internal.h"
+
+// The mean and variance are computed in two passes rather than from a running
+// sum of squares, which loses precision when |mean| >> stddev.
+static void iree_uk_layernorm_tile_f32f32_generic(
+    void* out_ptr, const void* in_ptr, const void* IREE_UK_RESTRICT gamma_ptr,
+    const void* IREE_UK_RESTRICT beta_ptr, iree_uk_index_t size,
+    float epsilon) {
+  const float* in = in_ptr;
+  float* out = out_ptr;
+  const float* gamma = gamma_ptr;
+  const float* beta = beta_ptr;
+  float sum = 0.0f;
+  for (iree_uk_index_t j = 0; j < size; ++j) sum += in[j];
+  float mean = sum / size;
+  float sum_sq = 0.0f;
+  for (iree_uk_index_t j = 0; j < size; ++j) {
+    float d = in[j] - mean;
+    sum_sq += d * d;
+  }
+  float inv_stddev = 1.0f / iree_uk_sqrt_f32(sum_sq / size + epsilon);
+  for (iree_uk_index_t j = 0; j < size; ++j) {
+    out[j] = (in[j] - mean) * inv_stddev * gamma[j] + beta[j];
+  }
+}
+
+static void iree_uk_layernorm_tile_f32f32_rms_generic(
+    void* out_ptr, const void* in_ptr, const void* IREE_UK_RESTRICT gamma_ptr,
+    const void* IREE_UK_RESTRICT beta_ptr, iree_uk_index_t size,
+    float epsilon) {
+  const float* in = in_ptr;
+  float* out = out_ptr;
+  const float* gamma = gamma_ptr;
+  float sum_sq = 0.0f;
+  for (iree_uk_index_t j = 0; j < size; ++j) sum_sq += in[j] * in[j];
+  float inv_rms = 1.0f / iree_uk_sqrt_f32(sum_sq / size + epsilon);
+  for (iree_uk_index_t j = 0; j < size; ++j) {
+    out[j] = in[j] * inv_rms * gamma[j];
+  }
+}
+
+static iree_uk_layernorm_tile_func_t
+iree_uk_layernorm_select_tile_func_generic(
+    const iree_uk_layernorm_params_t* params) {
+  // Currently f32f32 is the only supported type.
+  if (params->flags & IREE_UK_FLAG_LAYERNORM_RMS) {
+    return iree_uk_layernorm_tile_f32f32_rms_generic;
+  }
+  return iree_uk_layernorm_tile_f32f32_generic;
+}
+
+// Select the 'tile function' that is the typically target-optimized inner loop
+// implementation.
+iree_uk_layernorm_tile_func_t iree_uk_layernorm_select_tile_func(
+    const iree_uk_layernorm_params_t* params) {
+  iree_uk_layernorm_tile_func_t arch_tile_func =
+      iree_uk_layernorm_select_tile_func_arch(params);
+  if (arch_tile_func) {
+    return arch_tile_func;
+  }
+  return iree_uk_layernorm_select_tile_func_generic(params);
+}
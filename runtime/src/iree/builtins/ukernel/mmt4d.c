@@ -7,6 +7,7 @@
 #include "iree/builtins/ukernel/mmt4d.h"
 
 #include "iree/builtins/ukernel/mmt4d_internal.h"
+#include "iree/schemas/cpu_data.h"
 
 static void iree_uk_mmt4d_validate(const iree_uk_mmt4d_params_t* params) {
 #ifdef IREE_UK_ENABLE_ASSERTS
@@ -20,7 +21,11 @@ static void iree_uk_mmt4d_validate(const iree_uk_mmt4d_params_t* params) {
                  flags_type == IREE_UK_FLAG_MMT4D_TYPE_F16F16F32 ||
                  flags_type == IREE_UK_FLAG_MMT4D_TYPE_F16F16F16 ||
                  flags_type == IREE_UK_FLAG_MMT4D_TYPE_BF16BF16F32 ||
-                 flags_type == IREE_UK_FLAG_MMT4D_TYPE_BF16BF16BF16);
+                 flags_type == IREE_UK_FLAG_MMT4D_TYPE_BF16BF16BF16 ||
+                 flags_type == IREE_UK_FLAG_MMT4D_TYPE_F32I4F32 ||
+                 flags_type == IREE_UK_FLAG_MMT4D_TYPE_F32I8F32 ||
+                 flags_type == IREE_UK_FLAG_MMT4D_TYPE_F16I4F32 ||
+                 flags_type == IREE_UK_FLAG_MMT4D_TYPE_F16I8F32);
   // Some implementations may wish to avoid supporting absurdly wide types. For
   // instance, K is the innermost (i.e. hottest) loop bound, so some 32bit
   // targets may benefit from K being int32, not int64. We still let K be of
@@ -38,6 +43,60 @@ static void iree_uk_mmt4d_validate(const iree_uk_mmt4d_params_t* params) {
   IREE_UK_ASSERT(params->M0 * params->N0 *
                      iree_uk_type_size(iree_uk_mmt4d_out_type(mmt4d_type)) <=
                  iree_uk_mmt4d_tile_generic_max_bytes);
+  if (iree_uk_mmt4d_type_is_dequant(mmt4d_type)) {
+    // Ensure the unit scales used when no scales are provided fit on the stack.
+    IREE_UK_ASSERT(params->N0 * sizeof(float) <=
+                   iree_uk_mmt4d_tile_generic_max_bytes);
+    // Sub-byte RHS tiles and panels must start on byte boundaries.
+    iree_uk_type_t rhs_type = iree_uk_mmt4d_rhs_type(mmt4d_type);
+    if (iree_uk_type_bit_count(rhs_type) < 8) {
+      int elems_per_byte = 8 / iree_uk_type_bit_count(rhs_type);
+      IREE_UK_ASSERT(params->N0 * params->K0 % elems_per_byte == 0);
+      IREE_UK_ASSERT(params->rhs_offset % elems_per_byte == 0);
+      IREE_UK_ASSERT(params->rhs_stride0 % elems_per_byte == 0);
+    }
+  }
+#endif  // IREE_UK_ENABLE_ASSERTS
+}
+
+// Returns the iree_uk_mmt4d_params_t that |params| reduces to when ignoring the
+// RHS scales. This is what the dequant tile functions get to read the flags,
+// the reduction size and the tile sizes from.
+static iree_uk_mmt4d_params_t iree_uk_mmt4d_dequant_params_without_scales(
+    const iree_uk_mmt4d_dequant_params_t* params) {
+  iree_uk_mmt4d_params_t result = {
+      .lhs_buffer = params->lhs_buffer,
+      .lhs_offset = params->lhs_offset,
+      .lhs_stride0 = params->lhs_stride0,
+      .rhs_buffer = params->rhs_buffer,
+      .rhs_offset = params->rhs_offset,
+      .rhs_stride0 = params->rhs_stride0,
+      .out_buffer = params->out_buffer,
+      .out_offset = params->out_offset,
+      .out_stride0 = params->out_stride0,
+      .M = params->M,
+      .N = params->N,
+      .K = params->K,
+      .M0 = params->M0,
+      .N0 = params->N0,
+      .K0 = params->K0,
+      .flags = params->flags,
+      .cpu_data = params->cpu_data,
+  };
+  return result;
+}
+
+static void iree_uk_mmt4d_dequant_validate(
+    const iree_uk_mmt4d_dequant_params_t* params) {
+#ifdef IREE_UK_ENABLE_ASSERTS
+  iree_uk_mmt4d_params_t params_without_scales =
+      iree_uk_mmt4d_dequant_params_without_scales(params);
+  iree_uk_mmt4d_validate(&params_without_scales);
+  IREE_UK_ASSERT(
+      iree_uk_mmt4d_type_is_dequant(iree_uk_mmt4d_type(params->flags)));
+  // Scale groups must consist of whole K0-slices of the RHS tiles.
+  IREE_UK_ASSERT(params->rhs_group_size >= 0);
+  IREE_UK_ASSERT(params->rhs_group_size % params->K0 == 0);
 #endif  // IREE_UK_ENABLE_ASSERTS
 }
 
@@ -86,6 +145,257 @@ static void iree_uk_mmt4d_using_tile_func(const iree_uk_mmt4d_params_t* params,
   }
 }
 
+// Returns the size in bytes of the data cache whose KiB size is stored at
+// |shift| in the cache hierarchy field of |cpu_data|, or 0 if unknown.
+static iree_uk_index_t iree_uk_mmt4d_cache_size(
+    const iree_uk_uint64_t* cpu_data, int shift) {
+  if (!cpu_data) return 0;
+  iree_uk_uint64_t size_kb =
+      (cpu_data[IREE_CPU_DATA_CACHE_FIELD_INDEX] >> shift) &
+      IREE_CPU_DATA_CACHE_SIZE_KB_MASK;
+  return (iree_uk_index_t)size_kb * 1024;
+}
+
+// Cache-blocked variant of iree_uk_mmt4d_using_tile_func. For large K the LHS
+// and RHS panels no longer fit in L1 and each RHS panel is evicted from L2
+// before being reused by the next row of LHS tiles, so the loop nest is blocked
+// over K (by |K_block| K-tiles, sized so that a LHS panel chunk and a RHS panel
+// chunk fit in L1) and over N (by |N_block| RHS panels, sized so that the RHS
+// panel chunks of one block fit in L2). Each K block after the first is
+// accumulated onto the output of the previous one.
+//
+// Splitting K changes how floating-point reductions are associated: a tile
+// function may reorder its reduction internally (several partial sums, paired
+// dot-product instructions), and that now happens per K block instead of over
+// the whole of K. Blocked f32 results may therefore differ in the last bits
+// from unblocked ones. This runs on a single thread; multi-threading comes from
+// the dispatch tiling of the caller, as ukernels must not spawn threads.
+static void iree_uk_mmt4d_using_tile_func_blocked(
+    const iree_uk_mmt4d_params_t* params, iree_uk_mmt4d_tile_func_t tile_func,
+    iree_uk_int32_t K_block, iree_uk_int32_t N_block) {
+  const iree_uk_int32_t M = params->M;
+  const iree_uk_int32_t N = params->N;
+  const iree_uk_int32_t K = params->K;
+  const iree_uk_int16_t M0 = params->M0;
+  const iree_uk_int16_t N0 = params->N0;
+  const iree_uk_int16_t K0 = params->K0;
+  iree_uk_mmt4d_type_t mmt4d_type = iree_uk_mmt4d_type(params->flags);
+  const iree_uk_type_t lhs_type = iree_uk_mmt4d_lhs_type(mmt4d_type);
+  const iree_uk_type_t rhs_type = iree_uk_mmt4d_rhs_type(mmt4d_type);
+  const iree_uk_type_t out_type = iree_uk_mmt4d_out_type(mmt4d_type);
+  const iree_uk_int16_t lhs_elem_size_log2 = iree_uk_type_size_log2(lhs_type);
+  const iree_uk_int16_t rhs_elem_size_log2 = iree_uk_type_size_log2(rhs_type);
+  const iree_uk_int16_t out_elem_size_log2 = iree_uk_type_size_log2(out_type);
+  char* out_start =
+      (char*)params->out_buffer + (params->out_offset << out_elem_size_log2);
+  const char* lhs_start = (const char*)params->lhs_buffer +
+                          (params->lhs_offset << lhs_elem_size_log2);
+  const char* rhs_start = (const char*)params->rhs_buffer +
+                          (params->rhs_offset << rhs_elem_size_log2);
+  iree_uk_int32_t out_tile_size = (M0 * N0) << out_elem_size_log2;
+  iree_uk_index_t lhs_tile_size = (M0 * K0) << lhs_elem_size_log2;
+  iree_uk_index_t rhs_tile_size = (N0 * K0) << rhs_elem_size_log2;
+  iree_uk_index_t lhs_panel_stride = params->lhs_stride0 << lhs_elem_size_log2;
+  iree_uk_index_t rhs_panel_stride = params->rhs_stride0 << rhs_elem_size_log2;
+  iree_uk_index_t out_stride = params->out_stride0 << out_elem_size_log2;
+  iree_uk_mmt4d_params_t block_params = *params;
+  for (iree_uk_int32_t k = 0; k < K; k += K_block) {
+    block_params.K = iree_uk_index_min(K_block, K - k);
+    if (k > 0) block_params.flags |= IREE_UK_FLAG_MMT4D_ACCUMULATE;
+    for (iree_uk_int32_t j_block = 0; j_block < N; j_block += N_block) {
+      const iree_uk_int32_t j_end = iree_uk_index_min(j_block + N_block, N);
+      char* out_tile_row = out_start + j_block * out_tile_size;
+      const char* lhs_panel = lhs_start + k * lhs_tile_size;
+      const char* rhs_panel_start =
+          rhs_start + j_block * rhs_panel_stride + k * rhs_tile_size;
+      for (iree_uk_int32_t i = 0; i < M; ++i) {
+        char* out_tile = out_tile_row;
+        const char* rhs_panel = rhs_panel_start;
+        IREE_UK_PREFETCH_RW(out_tile_row, IREE_UK_PREFETCH_LOCALITY_L3);
+        // The next LHS panel chunk is used right after this row of tiles.
+        IREE_UK_PREFETCH_RO(lhs_panel + lhs_panel_stride,
+                            IREE_UK_PREFETCH_LOCALITY_L1);
+        for (iree_uk_int32_t j = j_block; j < j_end; ++j) {
+          IREE_UK_PREFETCH_RO(rhs_panel + rhs_panel_stride,
+                              IREE_UK_PREFETCH_LOCALITY_L1);
+          tile_func(out_tile, lhs_panel, rhs_panel, &block_params);
+          out_tile += out_tile_size;
+          rhs_panel += rhs_panel_stride;
+        }
+        out_tile_row += out_stride;
+        lhs_panel += lhs_panel_stride;
+      }
+    }
+  }
+}
+
+// Selects the cache blocking for |params| from the cache sizes in cpu_data,
+// returning the number of K-tiles and of RHS panels per block. Returns K and N
+// when the unblocked loop nest is just as good.
+static void iree_uk_mmt4d_select_blocking(const iree_uk_mmt4d_params_t* params,
+                                          iree_uk_int32_t* out_K_block,
+                                          iree_uk_int32_t* out_N_block) {
+  *out_K_block = params->K;
+  *out_N_block = params->N;
+  iree_uk_index_t l1_size = iree_uk_mmt4d_cache_size(
+      params->cpu_data, IREE_CPU_DATA7_L1D_SIZE_KB_SHIFT);
+  iree_uk_index_t l2_size = iree_uk_mmt4d_cache_size(
+      params->cpu_data, IREE_CPU_DATA7_L2_SIZE_KB_SHIFT);
+  if (!l1_size || !l2_size) return;
+  iree_uk_mmt4d_type_t mmt4d_type = iree_uk_mmt4d_type(params->flags);
+  iree_uk_index_t lhs_tile_size =
+      iree_uk_type_size_of_elements(iree_uk_mmt4d_lhs_type(mmt4d_type),
+                                    params->M0 * params->K0);
+  iree_uk_index_t rhs_tile_size =
+      iree_uk_type_size_of_elements(iree_uk_mmt4d_rhs_type(mmt4d_type),
+                                    params->N0 * params->K0);
+  // When all of the RHS panels fit in L2 they are reused from there by every
+  // row of LHS tiles and the unblocked loop nest is already cache-friendly.
+  if (params->N * params->K * rhs_tile_size <= l2_size / 2) return;
+  // Use half of each cache, leaving room for the output tiles and whatever
+  // else is resident.
+  iree_uk_index_t K_block = iree_uk_index_max(
+      1, (l1_size / 2) / (lhs_tile_size + rhs_tile_size));
+  // Splitting the reduction would round narrow accumulators to the output type
+  // in between blocks, so only accumulators that are stored exactly are split.
+  if (iree_uk_type_size(iree_uk_mmt4d_out_type(mmt4d_type)) < 4) {
+    K_block = params->K;
+  }
+  K_block = iree_uk_index_min(K_block, params->K);
+  iree_uk_index_t N_block = iree_uk_index_max(
+      1, (l2_size / 2) / (K_block * rhs_tile_size));
+  N_block = iree_uk_index_min(N_block, params->N);
+  *out_K_block = K_block;
+  *out_N_block = N_block;
+}
+
+// Runs the blocked or unblocked loop nest according to the cache blocking
+// selected for |params|.
+static void iree_uk_mmt4d_using_tile_func_maybe_blocked(
+    const iree_uk_mmt4d_params_t* params, iree_uk_mmt4d_tile_func_t tile_func) {
+  iree_uk_int32_t K_block = 0;
+  iree_uk_int32_t N_block = 0;
+  iree_uk_mmt4d_select_blocking(params, &K_block, &N_block);
+  if (K_block == params->K && N_block == params->N) {
+    // Everything already fits: the unblocked loop nest is just as good.
+    iree_uk_mmt4d_using_tile_func(params, tile_func);
+    return;
+  }
+  iree_uk_mmt4d_using_tile_func_blocked(params, tile_func, K_block, N_block);
+}
+
+// Like iree_uk_mmt4d_using_tile_func_blocked but for the weight-only quantized
+// types, also walking the panels of RHS scales alongside the RHS panels.
+// Offsets and strides are in elements and the RHS element type may be
+// sub-byte. Passing K_block == K and N_block == N gives the unblocked loop
+// nest. When the RHS is scaled, |K_block| must be a whole number of scale
+// groups so that each K block starts on a group boundary.
+static void iree_uk_mmt4d_using_dequant_tile_func(
+    const iree_uk_mmt4d_dequant_params_t* params,
+    iree_uk_mmt4d_dequant_tile_func_t tile_func, iree_uk_int32_t K_block,
+    iree_uk_int32_t N_block) {
+  const iree_uk_int32_t M = params->M;
+  const iree_uk_int32_t N = params->N;
+  const iree_uk_int32_t K = params->K;
+  const iree_uk_int16_t M0 = params->M0;
+  const iree_uk_int16_t N0 = params->N0;
+  const iree_uk_int16_t K0 = params->K0;
+  iree_uk_mmt4d_type_t mmt4d_type = iree_uk_mmt4d_type(params->flags);
+  const iree_uk_type_t lhs_type = iree_uk_mmt4d_lhs_type(mmt4d_type);
+  const iree_uk_type_t rhs_type = iree_uk_mmt4d_rhs_type(mmt4d_type);
+  const iree_uk_type_t out_type = iree_uk_mmt4d_out_type(mmt4d_type);
+  const iree_uk_int16_t lhs_elem_size_log2 = iree_uk_type_size_log2(lhs_type);
+  const iree_uk_int16_t out_elem_size_log2 = iree_uk_type_size_log2(out_type);
+  char* out_start =
+      (char*)params->out_buffer + (params->out_offset << out_elem_size_log2);
+  const char* lhs_start = (const char*)params->lhs_buffer +
+                          (params->lhs_offset << lhs_elem_size_log2);
+  const char* rhs_start =
+      (const char*)params->rhs_buffer +
+      iree_uk_type_size_of_elements(rhs_type, params->rhs_offset);
+  iree_uk_int32_t out_tile_size = (M0 * N0) << out_elem_size_log2;
+  iree_uk_index_t lhs_tile_size = (M0 * K0) << lhs_elem_size_log2;
+  iree_uk_index_t rhs_tile_size =
+      iree_uk_type_size_of_elements(rhs_type, N0 * K0);
+  iree_uk_index_t lhs_panel_stride = params->lhs_stride0 << lhs_elem_size_log2;
+  iree_uk_index_t rhs_panel_stride =
+      iree_uk_type_size_of_elements(rhs_type, params->rhs_stride0);
+  iree_uk_index_t out_stride = params->out_stride0 << out_elem_size_log2;
+
+  // Without scales we use a single group of unit scales spanning the entire
+  // reduction so that the tile functions don't need a separate code path.
+  iree_uk_int32_t group_size = params->rhs_group_size;
+  const float* rhs_scales_start = 0;
+  iree_uk_index_t rhs_scales_panel_stride = 0;
+  float unit_scales[iree_uk_mmt4d_tile_generic_max_bytes / sizeof(float)];
+  if (group_size) {
+    rhs_scales_start =
+        (const float*)params->rhs_scales_buffer + params->rhs_scales_offset;
+    rhs_scales_panel_stride = params->rhs_scales_stride0;
+  } else {
+    for (int j0 = 0; j0 < N0; ++j0) unit_scales[j0] = 1.0f;
+    rhs_scales_start = unit_scales;
+    group_size = K * K0;
+  }
+
+  iree_uk_mmt4d_params_t block_params =
+      iree_uk_mmt4d_dequant_params_without_scales(params);
+  for (iree_uk_int32_t k = 0; k < K; k += K_block) {
+    block_params.K = iree_uk_index_min(K_block, K - k);
+    if (k > 0) block_params.flags |= IREE_UK_FLAG_MMT4D_ACCUMULATE;
+    // The first scale group of this K block. Unit scales have a single group.
+    iree_uk_index_t rhs_scales_k_offset =
+        params->rhs_group_size ? (k * K0 / group_size) * N0 : 0;
+    for (iree_uk_int32_t j_block = 0; j_block < N; j_block += N_block) {
+      const iree_uk_int32_t j_end = iree_uk_index_min(j_block + N_block, N);
+      char* out_tile_row = out_start + j_block * out_tile_size;
+      const char* lhs_panel = lhs_start + k * lhs_tile_size;
+      const char* rhs_panel_start =
+          rhs_start + j_block * rhs_panel_stride + k * rhs_tile_size;
+      const float* rhs_scales_panel_start = rhs_scales_start +
+                                            j_block * rhs_scales_panel_stride +
+                                            rhs_scales_k_offset;
+      for (iree_uk_int32_t i = 0; i < M; ++i) {
+        char* out_tile = out_tile_row;
+        const char* rhs_panel = rhs_panel_start;
+        const float* rhs_scales_panel = rhs_scales_panel_start;
+        IREE_UK_PREFETCH_RW(out_tile_row, IREE_UK_PREFETCH_LOCALITY_L3);
+        IREE_UK_PREFETCH_RO(lhs_panel, IREE_UK_PREFETCH_LOCALITY_L1);
+        IREE_UK_PREFETCH_RO(rhs_panel, IREE_UK_PREFETCH_LOCALITY_L1);
+        for (iree_uk_int32_t j = j_block; j < j_end; ++j) {
+          tile_func(out_tile, lhs_panel, rhs_panel, rhs_scales_panel,
+                    group_size, &block_params);
+          out_tile += out_tile_size;
+          rhs_panel += rhs_panel_stride;
+          rhs_scales_panel += rhs_scales_panel_stride;
+        }
+        out_tile_row += out_stride;
+        lhs_panel += lhs_panel_stride;
+      }
+    }
+  }
+}
+
+// Selects the cache blocking for the weight-only quantized |params| and runs
+// the dequant loop nest with it.
+static void iree_uk_mmt4d_using_dequant_tile_func_maybe_blocked(
+    const iree_uk_mmt4d_dequant_params_t* params,
+    iree_uk_mmt4d_dequant_tile_func_t tile_func) {
+  iree_uk_mmt4d_params_t params_without_scales =
+      iree_uk_mmt4d_dequant_params_without_scales(params);
+  iree_uk_int32_t K_block = 0;
+  iree_uk_int32_t N_block = 0;
+  iree_uk_mmt4d_select_blocking(&params_without_scales, &K_block, &N_block);
+  if (params->rhs_group_size && K_block < params->K) {
+    // K blocks must start on scale group boundaries.
+    iree_uk_int32_t group_k_tiles = params->rhs_group_size / params->K0;
+    K_block = iree_uk_index_max(group_k_tiles,
+                                K_block / group_k_tiles * group_k_tiles);
+    K_block = iree_uk_index_min(K_block, params->K);
+  }
+  iree_uk_mmt4d_using_dequant_tile_func(params, tile_func, K_block, N_block);
+}
+
 // Helper for early-return path when K==0 and we just need to clear the output.
 static void iree_uk_mmt4d_zero_out(const iree_uk_mmt4d_params_t* params) {
   iree_uk_mmt4d_type_t mmt4d_type = iree_uk_mmt4d_type(params->flags);
@@ -133,9 +443,75 @@ IREE_UK_EXPORT int iree_uk_mmt4d(const iree_uk_mmt4d_params_t* params) {
   // targets that want to handle the entire loop nest in target-specific code.
   if (iree_uk_mmt4d_early(params)) return 0;
 
+  // Weight-only quantized types use their own family of tile functions. Here
+  // they have no scales.
+  if (iree_uk_mmt4d_type_is_dequant(iree_uk_mmt4d_type(params->flags))) {
+    iree_uk_mmt4d_dequant_params_t dequant_params = {
+        .lhs_buffer = params->lhs_buffer,
+        .lhs_offset = params->lhs_offset,
+        .lhs_stride0 = params->lhs_stride0,
+        .rhs_buffer = params->rhs_buffer,
+        .rhs_offset = params->rhs_offset,
+        .rhs_stride0 = params->rhs_stride0,
+        .out_buffer = params->out_buffer,
+        .out_offset = params->out_offset,
+        .out_stride0 = params->out_stride0,
+        .M = params->M,
+        .N = params->N,
+        .K = params->K,
+        .M0 = params->M0,
+        .N0 = params->N0,
+        .K0 = params->K0,
+        .flags = params->flags,
+        .rhs_group_size = 0,
+        .cpu_data = params->cpu_data,
+    };
+    iree_uk_mmt4d_dequant_tile_func_t tile_func =
+        iree_uk_mmt4d_select_dequant_tile_func(params);
+    iree_uk_mmt4d_using_dequant_tile_func_maybe_blocked(&dequant_params,
+                                                        tile_func);
+    return 0;
+  }
+
   // Select a target-specific tile_func (inner loop on K, computing one M0xN0
   // tile) and use that with generic outer loops.
   iree_uk_mmt4d_tile_func_t tile_func = iree_uk_mmt4d_select_tile_func(params);
-  iree_uk_mmt4d_using_tile_func(params, tile_func);
+  iree_uk_mmt4d_using_tile_func_maybe_blocked(params, tile_func);
+  return 0;
+}
+
+IREE_UK_EXPORT int iree_uk_mmt4d_dequant(
+    const iree_uk_mmt4d_dequant_params_t* params) {
+  iree_uk_mmt4d_dequant_validate(params);
+  iree_uk_mmt4d_params_t params_without_scales =
+      iree_uk_mmt4d_dequant_params_without_scales(params);
+  if (iree_uk_mmt4d_early(&params_without_scales)) return 0;
+  iree_uk_mmt4d_dequant_tile_func_t tile_func =
+      iree_uk_mmt4d_select_dequant_tile_func(&params_without_scales);
+  iree_uk_mmt4d_using_dequant_tile_func_maybe_blocked(params, tile_func);
+  return 0;
+}
+
+void iree_uk_mmt4d_with_tile_func(const iree_uk_mmt4d_params_t* params,
+                                  iree_uk_mmt4d_tile_func_t tile_func) {
+  iree_uk_mmt4d_validate(params);
+  if (iree_uk_mmt4d_early(params)) return;
+  iree_uk_mmt4d_using_tile_func_maybe_blocked(params, tile_func);
+}
+
+IREE_UK_EXPORT iree_uk_mmt4d_resolved_tile_func_t
+iree_uk_mmt4d_resolve_tile_func(const iree_uk_mmt4d_params_t* params) {
+  if (iree_uk_mmt4d_type_is_dequant(iree_uk_mmt4d_type(params->flags))) {
+    return 0;
+  }
+  return (iree_uk_mmt4d_resolved_tile_func_t)iree_uk_mmt4d_select_tile_func(
+      params);
+}
+
+IREE_UK_EXPORT int iree_uk_mmt4d_with_resolved_tile_func(
+    const iree_uk_mmt4d_params_t* params,
+    iree_uk_mmt4d_resolved_tile_func_t tile_func) {
+  if (!tile_func) return iree_uk_mmt4d(params);
+  iree_uk_mmt4d_with_tile_func(params, (iree_uk_mmt4d_tile_func_t)tile_func);
   return 0;
 }
@@ -36,8 +36,77 @@ typedef struct iree_uk_mmt4d_params_t {
   const iree_uk_uint64_t* cpu_data;
 } iree_uk_mmt4d_params_t;
 
+// When |cpu_data| reports the cache sizes, large problems are blocked over K
+// and N to stay in cache. Floating-point results of the blocked loop nest may
+// differ in rounding from the unblocked one, as splitting K reassociates the
+// reduction. Outputs narrower than 32 bits are never split over K.
 IREE_UK_EXPORT int iree_uk_mmt4d(const iree_uk_mmt4d_params_t* params);
 
+// `mmt4d_dequant` microkernel: `mmt4d` for the weight-only quantized types,
+// which have a float LHS and an integer RHS (such as
+// IREE_UK_FLAG_MMT4D_TYPE_F32I4F32), with per-group RHS scales.
+//
+// Each RHS element is multiplied by the f32 scale of its column and group,
+// where a group is rhs_group_size consecutive elements along the reduction
+// dimension. rhs_group_size must be a multiple of K0. The scales buffer has
+// layout [N][ceildiv(K * K0, rhs_group_size)][N0], i.e. it is tiled like the
+// RHS, with rhs_scales_offset and rhs_scales_stride0 in f32 elements. If
+// rhs_group_size is 0 the RHS is not scaled and the rhs_scales_* fields are
+// ignored.
+//
+// The RHS offset and stride are in elements, which may be sub-byte; sub-byte
+// RHS panels must start on byte boundaries. The field order matches the
+// operand order of the ukernel call emitted by the compiler, with the scales
+// following the RHS they apply to.
+//
+// iree_uk_mmt4d also accepts the weight-only quantized types, treating the RHS
+// as unscaled.
+typedef struct iree_uk_mmt4d_dequant_params_t {
+  const void* lhs_buffer;
+  iree_uk_index_t lhs_offset;
+  iree_uk_index_t lhs_stride0;
+  const void* rhs_buffer;
+  iree_uk_index_t rhs_offset;
+  iree_uk_index_t rhs_stride0;
+  const void* rhs_scales_buffer;
+  iree_uk_index_t rhs_scales_offset;
+  iree_uk_index_t rhs_scales_stride0;
+  void* out_buffer;
+  iree_uk_index_t out_offset;
+  iree_uk_index_t out_stride0;
+  iree_uk_index_t M;
+  iree_uk_index_t N;
+  iree_uk_index_t K;
+  iree_uk_int32_t M0;
+  iree_uk_int32_t N0;
+  iree_uk_int32_t K0;
+  iree_uk_uint32_t flags;
+  iree_uk_int32_t rhs_group_size;
+  const iree_uk_uint64_t* cpu_data;
+} iree_uk_mmt4d_dequant_params_t;
+
+IREE_UK_EXPORT int iree_uk_mmt4d_dequant(
+    const iree_uk_mmt4d_dequant_params_t* params);
+
+// Opaque handle to the tile function that iree_uk_mmt4d selects for a given
+// type and flags, tile size (M0, N0, K0) and cpu_data. Runtime callers that
+// run many small mmt4d's, such as the VMVX module, can resolve it once, cache
+// it under those keys, and skip the selection logic on each call.
+typedef void (*iree_uk_mmt4d_resolved_tile_func_t)(void);
+
+// Returns the tile function for |params|, of which only the flags, the tile
+// sizes and cpu_data are read. Returns NULL for weight-only quantized types,
+// which select their tile function differently.
+IREE_UK_EXPORT iree_uk_mmt4d_resolved_tile_func_t
+iree_uk_mmt4d_resolve_tile_func(const iree_uk_mmt4d_params_t* params);
+
+// Same as iree_uk_mmt4d, using |tile_func| as returned by
+// iree_uk_mmt4d_resolve_tile_func for params with the same flags, tile sizes
+// and cpu_data. Falls back to iree_uk_mmt4d if |tile_func| is NULL.
+IREE_UK_EXPORT int iree_uk_mmt4d_with_resolved_tile_func(
+    const iree_uk_mmt4d_params_t* params,
+    iree_uk_mmt4d_resolved_tile_func_t tile_func);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif  // __cplusplus
@@ -22,6 +22,14 @@ typedef enum iree_uk_mmt4d_type_t {
       IREE_UK_TIE_3_TYPES_LITERAL(BFLOAT_16, BFLOAT_16, FLOAT_32),
   iree_uk_mmt4d_type_bf16bf16bf16 =
       IREE_UK_TIE_3_TYPES_LITERAL(BFLOAT_16, BFLOAT_16, BFLOAT_16),
+  iree_uk_mmt4d_type_f32i4f32 =
+      IREE_UK_TIE_3_TYPES_LITERAL(FLOAT_32, INT_4, FLOAT_32),
+  iree_uk_mmt4d_type_f32i8f32 =
+      IREE_UK_TIE_3_TYPES_LITERAL(FLOAT_32, INT_8, FLOAT_32),
+  iree_uk_mmt4d_type_f16i4f32 =
+      IREE_UK_TIE_3_TYPES_LITERAL(FLOAT_16, INT_4, FLOAT_32),
+  iree_uk_mmt4d_type_f16i8f32 =
+      IREE_UK_TIE_3_TYPES_LITERAL(FLOAT_16, INT_8, FLOAT_32),
 } iree_uk_mmt4d_type_t;
 
 static inline iree_uk_mmt4d_type_t iree_uk_mmt4d_type(iree_uk_uint32_t flags) {
@@ -38,6 +46,14 @@ static inline iree_uk_mmt4d_type_t iree_uk_mmt4d_type(iree_uk_uint32_t flags) {
       return iree_uk_mmt4d_type_bf16bf16f32;
     case IREE_UK_FLAG_MMT4D_TYPE_BF16BF16BF16:
       return iree_uk_mmt4d_type_bf16bf16bf16;
+    case IREE_UK_FLAG_MMT4D_TYPE_F32I4F32:
+      return iree_uk_mmt4d_type_f32i4f32;
+    case IREE_UK_FLAG_MMT4D_TYPE_F32I8F32:
+      return iree_uk_mmt4d_type_f32i8f32;
+    case IREE_UK_FLAG_MMT4D_TYPE_F16I4F32:
+      return iree_uk_mmt4d_type_f16i4f32;
+    case IREE_UK_FLAG_MMT4D_TYPE_F16I8F32:
+      return iree_uk_mmt4d_type_f16i8f32;
     default:
       // This unreachable statement is not just an optimization, it also works
       // around a LLVM/riscv32 miscompile.
@@ -64,6 +80,16 @@ static inline iree_uk_type_t iree_uk_mmt4d_out_type(iree_uk_mmt4d_type_t type) {
   return iree_uk_untie_type(2, type);
 }
 
+// Returns true if |type| is a weight-only quantized type, i.e. one with a float
+// LHS and an integer RHS that is dequantized using the RHS scales of
+// iree_uk_mmt4d_dequant_params_t.
+static inline bool iree_uk_mmt4d_type_is_dequant(iree_uk_mmt4d_type_t type) {
+  return iree_uk_type_category(iree_uk_mmt4d_lhs_type(type)) ==
+             IREE_UK_TYPE_CATEGORY_FLOAT_IEEE &&
+         iree_uk_type_category(iree_uk_mmt4d_rhs_type(type)) ==
+             IREE_UK_TYPE_CATEGORY_INTEGER;
+}
+
 // Function pointer type for tile functions, i.e. typically architecture
 // specific functions computing one M0xN0 tile of the output matrix, i.e.
 // the inner-most loop of the matmul, i.e. the thing that we should actually
@@ -81,6 +107,29 @@ typedef void (*iree_uk_mmt4d_tile_func_t)(
             const void* IREE_UK_RESTRICT rhs_panel, \
             const iree_uk_mmt4d_params_t* params);
 
+// Function pointer type for tile functions of weight-only quantized types.
+// Like iree_uk_mmt4d_tile_func_t but also takes the panel of RHS scales
+// matching |rhs_panel|, laid out as [ceildiv(K * K0, group_size)][N0] f32
+// values.
+// Tile functions are always called with a valid scales panel and
+// |group_size| (in elements along the reduction dimension, a multiple of K0);
+// when the caller did not provide scales they are all 1 and group_size spans
+// the whole reduction.
+typedef void (*iree_uk_mmt4d_dequant_tile_func_t)(
+    void* IREE_UK_RESTRICT out_tile, const void* IREE_UK_RESTRICT lhs_panel,
+    const void* IREE_UK_RESTRICT rhs_panel,
+    const float* IREE_UK_RESTRICT rhs_scales_panel, iree_uk_int32_t group_size,
+    const iree_uk_mmt4d_params_t* params);
+
+// Tile kernel declarations. Prototype matches
+// iree_uk_mmt4d_dequant_tile_func_t.
+#define IREE_UK_MMT4D_DEQUANT_TILE_FUNC_DECL(NAME)           \
+  void NAME(void* IREE_UK_RESTRICT out_tile,                 \
+            const void* IREE_UK_RESTRICT lhs_panel,          \
+            const void* IREE_UK_RESTRICT rhs_panel,          \
+            const float* IREE_UK_RESTRICT rhs_scales_panel,  \
+            iree_uk_int32_t group_size, const iree_uk_mmt4d_params_t* params);
+
 // In order to be helpful as a reference for future architecture-specific
 // kernels, the generic kernels are structured like an actual optimized kernel,
 // using an "accumulator tile" that in this case is a stack array (which would
@@ -107,4 +156,22 @@ iree_uk_mmt4d_tile_func_t iree_uk_mmt4d_select_tile_func(
 iree_uk_mmt4d_tile_func_t iree_uk_mmt4d_select_tile_func_arch(
     const iree_uk_mmt4d_params_t* params);
 
+// Runs the mmt4d op with the given params using |tile_func|, including the
+// trivial cases handled without a tile function. |tile_func| must have been
+// returned by iree_uk_mmt4d_select_tile_func for params with the same flags,
+// tile sizes and cpu_data. This lets ukernels that run many mmt4d's of the same
+// type and tile sizes, such as batch_mmt4d, select the tile function only once.
+// Weight-only quantized types are not supported.
+void iree_uk_mmt4d_with_tile_func(const iree_uk_mmt4d_params_t* params,
+                                  iree_uk_mmt4d_tile_func_t tile_func);
+
+// Returns the dequant tile function to use for the mmt4d op with the given
+// params, which must have a weight-only quantized type.
+iree_uk_mmt4d_dequant_tile_func_t iree_uk_mmt4d_select_dequant_tile_func(
+    const iree_uk_mmt4d_params_t* params);
+
+// Architecture-specific implementation.
+iree_uk_mmt4d_dequant_tile_func_t iree_uk_mmt4d_select_dequant_tile_func_arch(
+    const iree_uk_mmt4d_params_t* params);
+
 #endif  // IREE_BUILTINS_UKERNEL_MMT4D_INTERNAL_H_
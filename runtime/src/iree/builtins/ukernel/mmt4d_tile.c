@@ -220,6 +220,80 @@ static void iree_uk_mmt4d_tile_bf16bf16bf16_generic(
   for (int i = 0; i < M0 * N0; ++i) out_tile[i] = acc[i];
 }
 
+// Returns element |index| of a LHS tile of the weight-only quantized types as
+// f32.
+static inline float iree_uk_mmt4d_dequant_lhs_f32(iree_uk_type_t lhs_type,
+                                                  const void* lhs_tile,
+                                                  iree_uk_index_t index) {
+  if (lhs_type == IREE_UK_TYPE_FLOAT_32) {
+    return ((const float*)lhs_tile)[index];
+  }
+  return iree_uk_f16_to_f32(((const iree_uk_uint16_t*)lhs_tile)[index]);
+}
+
+// Returns element |index| of a RHS tile of the weight-only quantized types,
+// sign-extended to int32. int4 elements are packed two per byte, with the
+// even-indexed element in the low nibble.
+static inline iree_uk_int32_t iree_uk_mmt4d_dequant_rhs_i32(
+    iree_uk_type_t rhs_type, const void* rhs_tile, iree_uk_index_t index) {
+  if (rhs_type == IREE_UK_TYPE_INT_8) {
+    return ((const iree_uk_int8_t*)rhs_tile)[index];
+  }
+  iree_uk_uint8_t byte = ((const iree_uk_uint8_t*)rhs_tile)[index >> 1];
+  iree_uk_uint8_t nibble = (index & 1) ? (byte >> 4) : (byte & 0xF);
+  return (iree_uk_int32_t)(iree_uk_int8_t)(nibble << 4) >> 4;
+}
+
+// Generic implementation of matmul tile for the weight-only quantized types,
+// f32|f16 * dequant(i4|i8) -> f32. The RHS is dequantized before multiplying,
+// as an optimized kernel would do in registers.
+static void iree_uk_mmt4d_tile_dequant_generic(
+    void* out_tile_untyped, const void* lhs_panel_untyped,
+    const void* rhs_panel_untyped, const float* rhs_scales_panel,
+    iree_uk_int32_t group_size, const iree_uk_mmt4d_params_t* params) {
+  float* out_tile = out_tile_untyped;
+  const char* lhs_panel = lhs_panel_untyped;
+  const char* rhs_panel = rhs_panel_untyped;
+  iree_uk_mmt4d_type_t mmt4d_type = iree_uk_mmt4d_type(params->flags);
+  iree_uk_type_t lhs_type = iree_uk_mmt4d_lhs_type(mmt4d_type);
+  iree_uk_type_t rhs_type = iree_uk_mmt4d_rhs_type(mmt4d_type);
+  iree_uk_int16_t M0 = params->M0;
+  iree_uk_int16_t N0 = params->N0;
+  iree_uk_int16_t K0 = params->K0;
+  iree_uk_index_t lhs_tile_size = (M0 * K0) << iree_uk_type_size_log2(lhs_type);
+  iree_uk_index_t rhs_tile_size =
+      iree_uk_type_size_of_elements(rhs_type, N0 * K0);
+  iree_uk_int32_t k_per_group = group_size / K0;
+  // Initialize the local accumulator tile.
+  float acc[iree_uk_mmt4d_tile_generic_max_bytes / sizeof(*out_tile)];
+  if (params->flags & IREE_UK_FLAG_MMT4D_ACCUMULATE) {
+    for (int i = 0; i < M0 * N0; ++i) acc[i] = out_tile[i];
+  } else {
+    for (int i = 0; i < M0 * N0; ++i) acc[i] = 0;
+  }
+  // Accumulation loop.
+  for (iree_uk_index_t k = 0; k < params->K; ++k) {
+    const float* scales = rhs_scales_panel + (k / k_per_group) * N0;
+    for (iree_uk_index_t i0 = 0; i0 < M0; ++i0) {
+      for (iree_uk_index_t j0 = 0; j0 < N0; ++j0) {
+        for (iree_uk_index_t k0 = 0; k0 < K0; ++k0) {
+          float lhs_f32 =
+              iree_uk_mmt4d_dequant_lhs_f32(lhs_type, lhs_panel, i0 * K0 + k0);
+          float rhs_f32 =
+              iree_uk_mmt4d_dequant_rhs_i32(rhs_type, rhs_panel,
+                                            j0 * K0 + k0) *
+              scales[j0];
+          acc[i0 * N0 + j0] += lhs_f32 * rhs_f32;
+        }
+      }
+    }
+    lhs_panel += lhs_tile_size;
+    rhs_panel += rhs_tile_size;
+  }
+  // Store the local accumulator tile to the destination.
+  for (int i = 0; i < M0 * N0; ++i) out_tile[i] = acc[i];
+}
+
 static iree_uk_mmt4d_tile_func_t iree_uk_mmt4d_select_tile_func_generic(
     const iree_uk_mmt4d_params_t* params) {
   switch (iree_uk_mmt4d_type(params->flags)) {
@@ -249,3 +323,11 @@ iree_uk_mmt4d_tile_func_t iree_uk_mmt4d_select_tile_func(
   if (arch_tile_func) return arch_tile_func;
   return iree_uk_mmt4d_select_tile_func_generic(params);
 }
+
+iree_uk_mmt4d_dequant_tile_func_t iree_uk_mmt4d_select_dequant_tile_func(
+    const iree_uk_mmt4d_params_t* params) {
+  iree_uk_mmt4d_dequant_tile_func_t arch_tile_func =
+      iree_uk_mmt4d_select_dequant_tile_func_arch(params);
+  if (arch_tile_func) return arch_tile_func;
+  return iree_uk_mmt4d_tile_dequant_generic;
+}
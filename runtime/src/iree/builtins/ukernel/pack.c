@@ -262,3 +262,10 @@ IREE_UK_EXPORT int iree_uk_pack(const iree_uk_pack_params_t* params) {
   iree_uk_pack_using_tile_func(params, tile_func);
   return 0;
 }
+
+void iree_uk_pack_with_tile_func(const iree_uk_pack_params_t* params,
+                                 iree_uk_pack_tile_func_t tile_func) {
+  iree_uk_pack_validate(params);
+  if (iree_uk_pack_early(params)) return;
+  iree_uk_pack_using_tile_func(params, tile_func);
+}
@@ -66,4 +66,12 @@ iree_uk_pack_tile_func_t iree_uk_pack_select_tile_func(
 iree_uk_pack_tile_func_t iree_uk_pack_select_tile_func_arch(
     const iree_uk_pack_params_t* params);
 
+// Runs the pack op with the given params using |tile_func|. |tile_func| must
+// have been returned by iree_uk_pack_select_tile_func for params with the same
+// flags, tile sizes and cpu_data. This lets ukernels that run many packs of the
+// same type and tile sizes, such as pack_mmt4d, select the tile function only
+// once.
+void iree_uk_pack_with_tile_func(const iree_uk_pack_params_t* params,
+                                 iree_uk_pack_tile_func_t tile_func);
+
 #endif  // IREE_BUILTINS_UKERNEL_PACK_INTERNAL_H_
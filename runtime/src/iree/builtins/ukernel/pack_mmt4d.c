@@ -0,0 +1,157 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/builtins/ukernel/pack_mmt4d.h"
+
+#include "iree/builtins/ukernel/mmt4d_internal.h"
+#include "iree/builtins/ukernel/pack_internal.h"
+
+// Size of the local buffer holding a chunk of one packed row of LHS tiles.
+// Together with the temporary buffer of `pack` and the accumulator tile of the
+// generic mmt4d tile functions this stays well below the smallest stack frame
+// size limit that we know we may have to deal with (16 kilobytes).
+enum { iree_uk_pack_mmt4d_lhs_buf_size = 8192 };
+
+// Returns the `pack` type flag for packing LHS elements of type |lhs_type|.
+static iree_uk_uint32_t iree_uk_pack_mmt4d_lhs_pack_type_flag(
+    iree_uk_type_t lhs_type) {
+  switch (lhs_type) {
+    case IREE_UK_TYPE_FLOAT_32:
+      return IREE_UK_FLAG_PACK_TYPE_F32F32;
+    case IREE_UK_TYPE_INT_8:
+      return IREE_UK_FLAG_PACK_TYPE_I8I8;
+    case IREE_UK_TYPE_FLOAT_16:
+      return IREE_UK_FLAG_PACK_TYPE_F16F16;
+    case IREE_UK_TYPE_BFLOAT_16:
+      return IREE_UK_FLAG_PACK_TYPE_BF16BF16;
+    default:
+      IREE_UK_ASSUME_UNREACHABLE;
+  }
+}
+
+static void iree_uk_pack_mmt4d_validate(
+    const iree_uk_pack_mmt4d_params_t* params) {
+#ifdef IREE_UK_ENABLE_ASSERTS
+  const iree_uk_uint32_t allflags =
+      IREE_UK_FLAG_MMT4D_TYPE_MASK | IREE_UK_FLAG_MMT4D_ACCUMULATE |
+      IREE_UK_FLAG_MMT4D_SKIP_INTERMEDIATE_ROUNDINGS;
+  IREE_UK_ASSERT(!(params->flags & ~allflags));
+  iree_uk_uint32_t flags_type = params->flags & IREE_UK_FLAG_MMT4D_TYPE_MASK;
+  // The output accumulates across K chunks, so it must be 32-bit to not be
+  // rounded between chunks.
+  IREE_UK_ASSERT(flags_type == IREE_UK_FLAG_MMT4D_TYPE_F32F32F32 ||
+                 flags_type == IREE_UK_FLAG_MMT4D_TYPE_I8I8I32 ||
+                 flags_type == IREE_UK_FLAG_MMT4D_TYPE_F16F16F32 ||
+                 flags_type == IREE_UK_FLAG_MMT4D_TYPE_BF16BF16F32);
+  IREE_UK_ASSERT(params->M0 > 0 && params->N0 > 0 && params->K0 > 0);
+  // The padded LHS must be exactly covered by the M x K tiles.
+  IREE_UK_ASSERT(params->lhs_size0 >= 0 && params->lhs_size1 >= 0);
+  IREE_UK_ASSERT(params->M * params->M0 >= params->lhs_size0);
+  IREE_UK_ASSERT((params->M - 1) * params->M0 < params->lhs_size0 ||
+                 params->M == 0);
+  IREE_UK_ASSERT(params->K * params->K0 >= params->lhs_size1);
+  IREE_UK_ASSERT((params->K - 1) * params->K0 < params->lhs_size1 ||
+                 params->K == 0);
+  // At least one packed LHS tile must fit in the local buffer.
+  iree_uk_mmt4d_type_t mmt4d_type = iree_uk_mmt4d_type(params->flags);
+  IREE_UK_ASSERT(
+      iree_uk_type_size_of_elements(iree_uk_mmt4d_lhs_type(mmt4d_type),
+                                    params->M0 * params->K0) <=
+      iree_uk_pack_mmt4d_lhs_buf_size);
+#endif  // IREE_UK_ENABLE_ASSERTS
+}
+
+IREE_UK_EXPORT int iree_uk_pack_mmt4d(
+    const iree_uk_pack_mmt4d_params_t* params) {
+  iree_uk_pack_mmt4d_validate(params);
+
+  iree_uk_mmt4d_type_t mmt4d_type = iree_uk_mmt4d_type(params->flags);
+  const iree_uk_type_t lhs_type = iree_uk_mmt4d_lhs_type(mmt4d_type);
+  const iree_uk_index_t lhs_tile_size =
+      iree_uk_type_size_of_elements(lhs_type, params->M0 * params->K0);
+  const iree_uk_index_t K_chunk = iree_uk_index_max(
+      1, iree_uk_pack_mmt4d_lhs_buf_size / lhs_tile_size);
+
+  // Cache line alignment, as in the temporary buffer of `pack`.
+  IREE_UK_ATTRIBUTE_ALIGNED(64)
+  char lhs_buf[iree_uk_pack_mmt4d_lhs_buf_size];
+
+  // Packs one chunk of one row of LHS tiles at a time into lhs_buf.
+  iree_uk_pack_params_t pack_params = {
+      .in_buffer = params->lhs_buffer,
+      .in_stride0 = params->lhs_stride0,
+      .out_buffer = lhs_buf,
+      .out_offset = 0,
+      .out_size0 = 1,
+      .out_size2 = params->M0,
+      .out_size3 = params->K0,
+      .padding_value = 0,
+      .flags = iree_uk_pack_mmt4d_lhs_pack_type_flag(lhs_type),
+      .cpu_data = params->cpu_data,
+  };
+  // Multiplies the packed chunk in lhs_buf by the matching chunk of all the
+  // RHS panels, producing one row of output tiles.
+  iree_uk_mmt4d_params_t mmt4d_params = {
+      .lhs_buffer = lhs_buf,
+      .lhs_offset = 0,
+      .lhs_stride0 = 0,
+      .rhs_buffer = params->rhs_buffer,
+      .rhs_stride0 = params->rhs_stride0,
+      .out_buffer = params->out_buffer,
+      .M = 1,
+      .N = params->N,
+      .M0 = params->M0,
+      .N0 = params->N0,
+      .K0 = params->K0,
+      .cpu_data = params->cpu_data,
+  };
+
+  if (params->K == 0) {
+    // Nothing to pack: let mmt4d clear the output or leave it alone.
+    mmt4d_params.out_offset = params->out_offset;
+    mmt4d_params.out_stride0 = params->out_stride0;
+    mmt4d_params.M = params->M;
+    mmt4d_params.K = 0;
+    mmt4d_params.flags = params->flags;
+    return iree_uk_mmt4d(&mmt4d_params);
+  }
+
+  // The tile functions only depend on the types, the tile sizes and the CPU
+  // features, which are the same for every row and chunk, so select them only
+  // once. The mmt4d tile functions read the accumulate flag at run time.
+  mmt4d_params.flags = params->flags;
+  iree_uk_mmt4d_tile_func_t mmt4d_tile_func =
+      iree_uk_mmt4d_select_tile_func(&mmt4d_params);
+  iree_uk_pack_tile_func_t pack_tile_func =
+      iree_uk_pack_select_tile_func(&pack_params);
+
+  for (iree_uk_index_t i = 0; i < params->M; ++i) {
+    iree_uk_index_t row = i * params->M0;
+    pack_params.in_size0 =
+        iree_uk_index_min(params->M0, params->lhs_size0 - row);
+    mmt4d_params.out_offset = params->out_offset + i * params->out_stride0;
+    for (iree_uk_index_t k = 0; k < params->K; k += K_chunk) {
+      iree_uk_index_t col = k * params->K0;
+      iree_uk_index_t K_this_chunk =
+          iree_uk_index_min(K_chunk, params->K - k);
+      pack_params.in_offset =
+          params->lhs_offset + row * params->lhs_stride0 + col;
+      pack_params.in_size1 =
+          iree_uk_index_min(K_this_chunk * params->K0,
+                            params->lhs_size1 - col);
+      pack_params.out_size1 = K_this_chunk;
+      pack_params.out_stride0 = K_this_chunk * params->M0 * params->K0;
+      iree_uk_pack_with_tile_func(&pack_params, pack_tile_func);
+      mmt4d_params.rhs_offset =
+          params->rhs_offset + k * params->N0 * params->K0;
+      mmt4d_params.K = K_this_chunk;
+      mmt4d_params.flags = params->flags;
+      if (k > 0) mmt4d_params.flags |= IREE_UK_FLAG_MMT4D_ACCUMULATE;
+      iree_uk_mmt4d_with_tile_func(&mmt4d_params, mmt4d_tile_func);
+    }
+  }
+  return 0;
+}
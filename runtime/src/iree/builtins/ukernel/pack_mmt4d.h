@@ -0,0 +1,62 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_BUILTINS_UKERNEL_PACK_MMT4D_H_
+#define IREE_BUILTINS_UKERNEL_PACK_MMT4D_H_
+
+#include "iree/builtins/ukernel/common.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+// `pack_mmt4d` microkernel: a `pack` of the LHS fused into a `mmt4d`. Used on
+// LLVMCPU when the packed LHS of a mmt4d has no other users, typically dynamic
+// shaped activations that are only consumed once.
+//
+// Instead of writing the whole packed LHS to a temporary and reading it back,
+// each row of LHS tiles is packed into a small local buffer that stays
+// resident in L1 while it is multiplied by all of the RHS panels. Rows whose
+// packed panel exceeds that buffer are processed in chunks along K, the output
+// being accumulated across chunks.
+//
+// The LHS is a row-major lhs_size0 x lhs_size1 matrix, zero-padded to
+// (M * M0) x (K * K0). The RHS and output are laid out as in `mmt4d`, and the
+// flags are the `mmt4d` flags. Only types with a 32-bit output are supported:
+// with a 16-bit output, the accumulator would be rounded to the output type
+// between K chunks, which the unfused `mmt4d` does not do when
+// IREE_UK_FLAG_MMT4D_SKIP_INTERMEDIATE_ROUNDINGS is set.
+
+typedef struct iree_uk_pack_mmt4d_params_t {
+  const void* lhs_buffer;
+  iree_uk_index_t lhs_offset;
+  iree_uk_index_t lhs_stride0;
+  const void* rhs_buffer;
+  iree_uk_index_t rhs_offset;
+  iree_uk_index_t rhs_stride0;
+  void* out_buffer;
+  iree_uk_index_t out_offset;
+  iree_uk_index_t out_stride0;
+  iree_uk_index_t lhs_size0;
+  iree_uk_index_t lhs_size1;
+  iree_uk_index_t M;
+  iree_uk_index_t N;
+  iree_uk_index_t K;
+  iree_uk_int32_t M0;
+  iree_uk_int32_t N0;
+  iree_uk_int32_t K0;
+  iree_uk_uint32_t flags;
+  const iree_uk_uint64_t* cpu_data;
+} iree_uk_pack_mmt4d_params_t;
+
+IREE_UK_EXPORT int iree_uk_pack_mmt4d(
+    const iree_uk_pack_mmt4d_params_t* params);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif  // IREE_BUILTINS_UKERNEL_PACK_MMT4D_H_
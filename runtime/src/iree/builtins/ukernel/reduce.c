@@ -0,0 +1,62 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/builtins/ukernel/reduce_internal.h"
+
+static void iree_uk_reduce_validate(const iree_uk_reduce_params_t* params) {
+#ifdef IREE_UK_ENABLE_ASSERTS
+  const iree_uk_uint32_t allflags = IREE_UK_FLAG_REDUCE_TYPE_MASK |
+                                    IREE_UK_FLAG_REDUCE_OP_MASK |
+                                    IREE_UK_FLAG_REDUCE_ACCUMULATE;
+  IREE_UK_ASSERT(!(params->flags & ~allflags));
+  iree_uk_uint32_t flags_type = params->flags & IREE_UK_FLAG_REDUCE_TYPE_MASK;
+  IREE_UK_ASSERT(flags_type == IREE_UK_FLAG_REDUCE_TYPE_F32F32);
+  iree_uk_uint32_t flags_op = params->flags & IREE_UK_FLAG_REDUCE_OP_MASK;
+  IREE_UK_ASSERT(flags_op == IREE_UK_FLAG_REDUCE_OP_SUM ||
+                 flags_op == IREE_UK_FLAG_REDUCE_OP_MAX);
+  IREE_UK_ASSERT(params->size0 >= 0);
+  IREE_UK_ASSERT(params->size1 >= 0);
+  IREE_UK_ASSERT(params->in_stride0 >= params->size1 || params->size0 <= 1);
+  IREE_UK_ASSERT(params->out_stride0 >= 1 || params->size0 <= 1);
+#endif  // IREE_UK_ENABLE_ASSERTS
+}
+
+// Early-return implementation for this ukernel. Returns true if already done.
+static bool iree_uk_reduce_early(const iree_uk_reduce_params_t* params) {
+  // Empty rows still need their output initialized, unless accumulating.
+  return params->size0 == 0 ||
+         (params->size1 == 0 &&
+          (params->flags & IREE_UK_FLAG_REDUCE_ACCUMULATE));
+}
+
+static void iree_uk_reduce_using_tile_func(
+    const iree_uk_reduce_params_t* params,
+    iree_uk_reduce_tile_func_t tile_func) {
+  iree_uk_reduce_type_t reduce_type = iree_uk_reduce_type(params->flags);
+  iree_uk_index_t in_elem_size =
+      iree_uk_type_size(iree_uk_reduce_in_type(reduce_type));
+  iree_uk_index_t out_elem_size =
+      iree_uk_type_size(iree_uk_reduce_out_type(reduce_type));
+  const char* in_ptr =
+      (const char*)params->in_buffer + params->in_offset * in_elem_size;
+  char* out_ptr = (char*)params->out_buffer + params->out_offset * out_elem_size;
+  for (iree_uk_index_t i = 0; i < params->size0; ++i) {
+    tile_func(out_ptr, in_ptr, params->size1, params->flags);
+    in_ptr += params->in_stride0 * in_elem_size;
+    out_ptr += params->out_stride0 * out_elem_size;
+  }
+}
+
+IREE_UK_EXPORT int iree_uk_reduce(const iree_uk_reduce_params_t* params) {
+  iree_uk_reduce_validate(params);
+
+  if (iree_uk_reduce_early(params)) return 0;
+
+  // Select a target-specific tile_func and use that with generic outer loops.
+  iree_uk_reduce_tile_func_t func = iree_uk_reduce_select_tile_func(params);
+  iree_uk_reduce_using_tile_func(params, func);
+  return 0;
+}
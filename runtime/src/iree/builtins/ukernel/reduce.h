@@ -0,0 +1,47 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_BUILTINS_UKERNEL_REDUCE_H_
+#define IREE_BUILTINS_UKERNEL_REDUCE_H_
+
+#include "iree/builtins/ukernel/common.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+// `reduce` microkernel. Reduces each row of a 2D input along its innermost
+// dimension into the 1D output, with the reduction operation given by
+// IREE_UK_FLAG_REDUCE_OP_*:
+//   out[i] = op_j(in[i, :])
+// With IREE_UK_FLAG_REDUCE_ACCUMULATE the existing output value participates
+// in the reduction:
+//   out[i] = op(out[i], op_j(in[i, :]))
+// Otherwise, rows with size1 == 0 produce the identity of the operation.
+//
+// The order in which elements are combined is unspecified, so floating-point
+// sums may differ in rounding from a sequential loop.
+
+typedef struct iree_uk_reduce_params_t {
+  const void* in_buffer;
+  iree_uk_index_t in_offset;
+  iree_uk_index_t in_stride0;
+  void* out_buffer;
+  iree_uk_index_t out_offset;
+  iree_uk_index_t out_stride0;
+  iree_uk_index_t size0;
+  iree_uk_index_t size1;
+  iree_uk_uint32_t flags;
+  const iree_uk_uint64_t* cpu_data;
+} iree_uk_reduce_params_t;
+
+IREE_UK_EXPORT int iree_uk_reduce(const iree_uk_reduce_params_t* params);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif  // IREE_BUILTINS_UKERNEL_REDUCE_H_
@@ -0,0 +1,57 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_BUILTINS_UKERNEL_REDUCE_INTERNAL_H_
+#define IREE_BUILTINS_UKERNEL_REDUCE_INTERNAL_H_
+
+#include "iree/builtins/ukernel/reduce.h"
+
+typedef enum iree_uk_reduce_type_t {
+  iree_uk_reduce_type_f32f32 = IREE_UK_TIE_2_TYPES_LITERAL(FLOAT_32, FLOAT_32),
+} iree_uk_reduce_type_t;
+
+static inline iree_uk_reduce_type_t iree_uk_reduce_type(
+    iree_uk_uint32_t flags) {
+  switch (flags & IREE_UK_FLAG_REDUCE_TYPE_MASK) {
+    case IREE_UK_FLAG_REDUCE_TYPE_F32F32:
+      return iree_uk_reduce_type_f32f32;
+    default:
+      IREE_UK_ASSUME_UNREACHABLE;
+  }
+}
+
+static inline iree_uk_type_t iree_uk_reduce_in_type(
+    iree_uk_reduce_type_t type) {
+  return iree_uk_untie_type(0, type);
+}
+
+static inline iree_uk_type_t iree_uk_reduce_out_type(
+    iree_uk_reduce_type_t type) {
+  return iree_uk_untie_type(1, type);
+}
+
+// A reduce "tile" is a single input row, reduced into the single output element
+// at out_ptr. The only flag that tile functions need to handle is
+// IREE_UK_FLAG_REDUCE_ACCUMULATE.
+typedef void (*iree_uk_reduce_tile_func_t)(
+    void* IREE_UK_RESTRICT out_ptr, const void* IREE_UK_RESTRICT in_ptr,
+    iree_uk_index_t size, iree_uk_uint32_t flags);
+
+// Tile kernel declarations. Prototype matches iree_uk_reduce_tile_func_t.
+#define IREE_UK_REDUCE_TILE_FUNC_DECL(NAME)                            \
+  void NAME(void* IREE_UK_RESTRICT out_ptr,                            \
+            const void* IREE_UK_RESTRICT in_ptr, iree_uk_index_t size, \
+            iree_uk_uint32_t flags);
+
+// Returns the tile function to use for the reduce op with the given params.
+iree_uk_reduce_tile_func_t iree_uk_reduce_select_tile_func(
+    const iree_uk_reduce_params_t* params);
+
+// Architecture-specific implementation.
+iree_uk_reduce_tile_func_t iree_uk_reduce_select_tile_func_arch(
+    const iree_uk_reduce_params_t* params);
+
+#endif  // IREE_BUILTINS_UKERNEL_REDUCE_INTERNAL_H_
@@ -0,0 +1,53 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/builtins/ukernel/reduce_internal.h"
+
+static void iree_uk_reduce_tile_f32f32_sum_generic(
+    void* IREE_UK_RESTRICT out_ptr, const void* IREE_UK_RESTRICT in_ptr,
+    iree_uk_index_t size, iree_uk_uint32_t flags) {
+  const float* in = in_ptr;
+  float* out = out_ptr;
+  float acc = (flags & IREE_UK_FLAG_REDUCE_ACCUMULATE) ? *out : 0.0f;
+  for (iree_uk_index_t j = 0; j < size; ++j) acc += in[j];
+  *out = acc;
+}
+
+static void iree_uk_reduce_tile_f32f32_max_generic(
+    void* IREE_UK_RESTRICT out_ptr, const void* IREE_UK_RESTRICT in_ptr,
+    iree_uk_index_t size, iree_uk_uint32_t flags) {
+  const float* in = in_ptr;
+  float* out = out_ptr;
+  float acc = (flags & IREE_UK_FLAG_REDUCE_ACCUMULATE) ? *out
+                                                       : iree_uk_f32_neg_inf();
+  for (iree_uk_index_t j = 0; j < size; ++j) acc = iree_uk_max_f32(acc, in[j]);
+  *out = acc;
+}
+
+static iree_uk_reduce_tile_func_t iree_uk_reduce_select_tile_func_generic(
+    const iree_uk_reduce_params_t* params) {
+  // Currently f32f32 is the only supported type.
+  switch (params->flags & IREE_UK_FLAG_REDUCE_OP_MASK) {
+    case IREE_UK_FLAG_REDUCE_OP_SUM:
+      return iree_uk_reduce_tile_f32f32_sum_generic;
+    case IREE_UK_FLAG_REDUCE_OP_MAX:
+      return iree_uk_reduce_tile_f32f32_max_generic;
+    default:
+      IREE_UK_ASSUME_UNREACHABLE;
+  }
+}
+
+// Select the 'tile function' that is the typically target-optimized inner loop
+// implementation.
+iree_uk_reduce_tile_func_t iree_uk_reduce_select_tile_func(
+    const iree_uk_reduce_params_t* params) {
+  iree_uk_reduce_tile_func_t arch_tile_func =
+      iree_uk_reduce_select_tile_func_arch(params);
+  if (arch_tile_func) {
+    return arch_tile_func;
+  }
+  return iree_uk_reduce_select_tile_func_generic(params);
+}
@@ -0,0 +1,41 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_BUILTINS_UKERNEL_SOFTMAX_H_
+#define IREE_BUILTINS_UKERNEL_SOFTMAX_H_
+
+#include "iree/builtins/ukernel/common.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+// `softmax` microkernel. Computes the softmax of each row of a 2D input along
+// its innermost dimension:
+//   out[i, j] = exp(in[i, j] - max_j(in[i, :])) / sum_j(exp(in[i, :] - max))
+// The exponential is a fast polynomial approximation (see iree_uk_exp_f32).
+// The input and output may alias exactly (in-place softmax).
+
+typedef struct iree_uk_softmax_params_t {
+  const void* in_buffer;
+  iree_uk_index_t in_offset;
+  iree_uk_index_t in_stride0;
+  void* out_buffer;
+  iree_uk_index_t out_offset;
+  iree_uk_index_t out_stride0;
+  iree_uk_index_t size0;
+  iree_uk_index_t size1;
+  iree_uk_uint32_t flags;
+  const iree_uk_uint64_t* cpu_data;
+} iree_uk_softmax_params_t;
+
+IREE_UK_EXPORT int iree_uk_softmax(const iree_uk_softmax_params_t* params);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif  // IREE_BUILTINS_UKERNEL_SOFTMAX_H_
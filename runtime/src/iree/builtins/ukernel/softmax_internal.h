@@ -0,0 +1,53 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_BUILTINS_UKERNEL_SOFTMAX_INTERNAL_H_
+#define IREE_BUILTINS_UKERNEL_SOFTMAX_INTERNAL_H_
+
+#include "iree/builtins/ukernel/softmax.h"
+
+typedef enum iree_uk_softmax_type_t {
+  iree_uk_softmax_type_f32f32 = IREE_UK_TIE_2_TYPES_LITERAL(FLOAT_32, FLOAT_32),
+} iree_uk_softmax_type_t;
+
+static inline iree_uk_softmax_type_t iree_uk_softmax_type(
+    iree_uk_uint32_t flags) {
+  switch (flags & IREE_UK_FLAG_SOFTMAX_TYPE_MASK) {
+    case IREE_UK_FLAG_SOFTMAX_TYPE_F32F32:
+      return iree_uk_softmax_type_f32f32;
+    default:
+      IREE_UK_ASSUME_UNREACHABLE;
+  }
+}
+
+static inline iree_uk_type_t iree_uk_softmax_in_type(
+    iree_uk_softmax_type_t type) {
+  return iree_uk_untie_type(0, type);
+}
+
+static inline iree_uk_type_t iree_uk_softmax_out_type(
+    iree_uk_softmax_type_t type) {
+  return iree_uk_untie_type(1, type);
+}
+
+// A softmax "tile" is a single row. Unlike most other ukernels there is no
+// restrict qualifier: out_ptr may alias in_ptr exactly.
+typedef void (*iree_uk_softmax_tile_func_t)(void* out_ptr, const void* in_ptr,
+                                            iree_uk_index_t size);
+
+// Tile kernel declarations. Prototype matches iree_uk_softmax_tile_func_t.
+#define IREE_UK_SOFTMAX_TILE_FUNC_DECL(NAME) \
+  void NAME(void* out_ptr, const void* in_ptr, iree_uk_index_t size);
+
+// Returns the tile function to use for the softmax op with the given params.
+iree_uk_softmax_tile_func_t iree_uk_softmax_select_tile_func(
+    const iree_uk_softmax_params_t* params);
+
+// Architecture-specific implementation.
+iree_uk_softmax_tile_func_t iree_uk_softmax_select_tile_func_arch(
+    const iree_uk_softmax_params_t* params);
+
+#endif  // IREE_BUILTINS_UKERNEL_SOFTMAX_INTERNAL_H_
@@ -0,0 +1,42 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/builtins/ukernel/softmax_internal.h"
+
+static void iree_uk_softmax_tile_f32f32_generic(void* out_ptr,
+                                                const void* in_ptr,
+                                                iree_uk_index_t size) {
+  const float* in = in_ptr;
+  float* out = out_ptr;
+  float max = iree_uk_f32_neg_inf();
+  for (iree_uk_index_t j = 0; j < size; ++j) max = iree_uk_max_f32(max, in[j]);
+  float sum = 0.0f;
+  for (iree_uk_index_t j = 0; j < size; ++j) {
+    float e = iree_uk_exp_f32(in[j] - max);
+    out[j] = e;
+    sum += e;
+  }
+  float scale = 1.0f / sum;
+  for (iree_uk_index_t j = 0; j < size; ++j) out[j] *= scale;
+}
+
+static iree_uk_softmax_tile_func_t iree_uk_softmax_select_tile_func_generic(
+    const iree_uk_softmax_params_t* params) {
+  // Currently f32f32 is the only supported type.
+  return iree_uk_softmax_tile_f32f32_generic;
+}
+
+// Select the 'tile function' that is the typically target-optimized inner loop
+// implementation.
+iree_uk_softmax_tile_func_t iree_uk_softmax_select_tile_func(
+    const iree_uk_softmax_params_t* params) {
+  iree_uk_softmax_tile_func_t arch_tile_func =
+      iree_uk_softmax_select_tile_func_arch(params);
+  if (arch_tile_func) {
+    return arch_tile_func;
+  }
+  return iree_uk_softmax_select_tile_func_generic(params);
+}
@@ -0,0 +1,188 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/base/api.h"
+#include "iree/builtins/ukernel/api.h"
+#include "iree/builtins/ukernel/mmt4d_internal.h"
+#include "iree/builtins/ukernel/tools/test.h"
+#include "iree/builtins/ukernel/tools/util.h"
+
+// The reference is one mmt4d per batch. Both sides use the same tile functions
+// and accumulate in the same order, so the results must be bit-exact.
+static void iree_batch_mmt4d_reference(
+    const iree_uk_batch_mmt4d_params_t* params) {
+  for (iree_uk_index_t b = 0; b < params->batch_size; ++b) {
+    iree_uk_mmt4d_params_t mmt4d_params = {
+        .lhs_buffer = params->lhs_buffer,
+        .lhs_offset = params->lhs_offset + b * params->lhs_stride0,
+        .lhs_stride0 = params->lhs_stride1,
+        .rhs_buffer = params->rhs_buffer,
+        .rhs_offset = params->rhs_offset + b * params->rhs_stride0,
+        .rhs_stride0 = params->rhs_stride1,
+        .out_buffer = params->out_buffer,
+        .out_offset = params->out_offset + b * params->out_stride0,
+        .out_stride0 = params->out_stride1,
+        .M = params->M,
+        .N = params->N,
+        .K = params->K,
+        .M0 = params->M0,
+        .N0 = params->N0,
+        .K0 = params->K0,
+        .flags = params->flags,
+        .cpu_data = params->cpu_data,
+    };
+    iree_uk_mmt4d(&mmt4d_params);
+  }
+}
+
+static void iree_uk_test_batch_mmt4d_for_shape_params(
+    iree_uk_test_t* test, const iree_uk_batch_mmt4d_params_t* src_params) {
+  iree_uk_batch_mmt4d_params_t params;
+  memcpy(&params, src_params, sizeof params);
+  // Populate strides first - we need them below to compute buffer lengths.
+  // Randomly make strides either tight or not to exercise all cases.
+  iree_uk_random_engine_t* engine = iree_uk_test_random_engine(test);
+  params.lhs_stride1 =
+      params.K * params.M0 * params.K0 + iree_uk_random_engine_get_0_1(engine);
+  params.rhs_stride1 =
+      params.K * params.N0 * params.K0 + iree_uk_random_engine_get_0_1(engine);
+  params.out_stride1 =
+      params.N * params.M0 * params.N0 + iree_uk_random_engine_get_0_1(engine);
+  params.lhs_stride0 =
+      params.M * params.lhs_stride1 + iree_uk_random_engine_get_0_1(engine);
+  params.rhs_stride0 =
+      params.N * params.rhs_stride1 + iree_uk_random_engine_get_0_1(engine);
+  params.out_stride0 =
+      params.M * params.out_stride1 + iree_uk_random_engine_get_0_1(engine);
+  iree_uk_mmt4d_type_t mmt4d_type = iree_uk_mmt4d_type(params.flags);
+  iree_uk_type_t lhs_type = iree_uk_mmt4d_lhs_type(mmt4d_type);
+  iree_uk_type_t rhs_type = iree_uk_mmt4d_rhs_type(mmt4d_type);
+  iree_uk_type_t out_type = iree_uk_mmt4d_out_type(mmt4d_type);
+  iree_uk_index_t lhs_buffer_size = iree_uk_2d_buffer_length(
+      lhs_type, params.batch_size, params.lhs_stride0);
+  iree_uk_index_t rhs_buffer_size = iree_uk_2d_buffer_length(
+      rhs_type, params.batch_size, params.rhs_stride0);
+  void* lhs_buffer = malloc(lhs_buffer_size);
+  void* rhs_buffer = malloc(rhs_buffer_size);
+  iree_uk_write_random_buffer(lhs_buffer, lhs_buffer_size, lhs_type, engine);
+  iree_uk_write_random_buffer(rhs_buffer, rhs_buffer_size, rhs_type, engine);
+  params.lhs_offset = iree_uk_random_engine_get_0_65535(engine);
+  params.rhs_offset = iree_uk_random_engine_get_0_65535(engine);
+  params.out_offset = iree_uk_random_engine_get_0_65535(engine);
+  params.lhs_buffer = (const char*)lhs_buffer -
+                      (params.lhs_offset * iree_uk_type_size(lhs_type));
+  params.rhs_buffer = (const char*)rhs_buffer -
+                      (params.rhs_offset * iree_uk_type_size(rhs_type));
+
+  iree_uk_batch_mmt4d_params_t reference_params;
+  memcpy(&reference_params, &params, sizeof params);
+  iree_uk_index_t out_buffer_size = iree_uk_2d_buffer_length(
+      out_type, params.batch_size, params.out_stride0);
+  void* init_out_buffer = malloc(out_buffer_size);
+  iree_uk_write_random_buffer(init_out_buffer, out_buffer_size, out_type,
+                              engine);
+  void* reference_out_buffer = malloc(out_buffer_size);
+  memcpy(reference_out_buffer, init_out_buffer, out_buffer_size);
+  reference_params.out_buffer =
+      (char*)reference_out_buffer -
+      (params.out_offset * iree_uk_type_size(out_type));
+
+  iree_uk_batch_mmt4d_params_t actual_params;
+  memcpy(&actual_params, &params, sizeof params);
+  void* actual_out_buffer = malloc(out_buffer_size);
+  memcpy(actual_out_buffer, init_out_buffer, out_buffer_size);
+  actual_params.out_buffer = (char*)actual_out_buffer -
+                             (params.out_offset * iree_uk_type_size(out_type));
+
+  iree_batch_mmt4d_reference(&reference_params);
+  iree_uk_batch_mmt4d(&actual_params);
+
+  if (memcmp(actual_out_buffer, reference_out_buffer, out_buffer_size)) {
+    IREE_UK_TEST_FAIL(test);
+  }
+
+  free(init_out_buffer);
+  free(reference_out_buffer);
+  free(actual_out_buffer);
+  free(lhs_buffer);
+  free(rhs_buffer);
+}
+
+static void iree_uk_test_batch_mmt4d_for_tile_params(iree_uk_test_t* test,
+                                                     const void* src_params) {
+  typedef struct shape_bmnk_t {
+    int batch, m, n, k;
+  } shape_bmnk_t;
+  const shape_bmnk_t shapes[] = {
+      // Degenerate cases. Vacuous, or zeroing the output buffer when K==0 and
+      // flags do not have ACCUMULATE.
+      {0, 2, 2, 2},
+      {3, 0, 2, 2},
+      {3, 2, 0, 2},
+      {3, 2, 2, 0},
+      // Single batch, same as mmt4d.
+      {1, 5, 7, 9},
+      // Many small matmuls, as in the per-head matmuls of attention.
+      {8, 1, 1, 1},
+      {12, 2, 3, 4},
+      {16, 4, 4, 8},
+      {5, 9, 6, 33},
+  };
+  for (int i = 0; i < IREE_ARRAYSIZE(shapes); ++i) {
+    iree_uk_batch_mmt4d_params_t params;
+    memcpy(&params, src_params, sizeof params);
+    params.cpu_data = iree_uk_test_cpu_data(test);
+    shape_bmnk_t shape = shapes[i];
+    params.batch_size = shape.batch;
+    params.M = shape.m;
+    params.N = shape.n;
+    params.K = shape.k;
+    for (int accumulate = 0; accumulate <= 1; ++accumulate) {
+      if (accumulate) params.flags |= IREE_UK_FLAG_MMT4D_ACCUMULATE;
+      iree_uk_test_batch_mmt4d_for_shape_params(test, &params);
+    }
+  }
+}
+
+static void iree_uk_test_batch_mmt4d(iree_uk_uint32_t flags, int M0, int N0,
+                                     int K0, const char* cpu_features) {
+  char types_str[32];
+  iree_uk_mmt4d_type_t mmt4d_type = iree_uk_mmt4d_type(flags);
+  iree_uk_type_triple_str(types_str, sizeof types_str, mmt4d_type);
+  iree_uk_batch_mmt4d_params_t params = {
+      .flags = flags, .M0 = M0, .N0 = N0, .K0 = K0};
+  char test_label_str[256];
+  snprintf(test_label_str, sizeof test_label_str, "types:%s tile:%dx%dx%d",
+           types_str, M0, N0, K0);
+  iree_uk_test(test_label_str, iree_uk_test_batch_mmt4d_for_tile_params,
+               &params, cpu_features);
+}
+
+int main(int argc, char** argv) {
+  // Generic tests, not matching any particular CPU feature, with weird tile
+  // sizes.
+  iree_uk_test_batch_mmt4d(IREE_UK_FLAG_MMT4D_TYPE_F32F32F32, 3, 5, 7, "");
+  iree_uk_test_batch_mmt4d(IREE_UK_FLAG_MMT4D_TYPE_I8I8I32, 9, 6, 3, "");
+  iree_uk_test_batch_mmt4d(IREE_UK_FLAG_MMT4D_TYPE_F16F16F32, 4, 6, 5, "");
+  iree_uk_test_batch_mmt4d(IREE_UK_FLAG_MMT4D_TYPE_F16F16F16, 3, 5, 8, "");
+  iree_uk_test_batch_mmt4d(IREE_UK_FLAG_MMT4D_TYPE_BF16BF16F32, 11, 4, 1, "");
+  iree_uk_test_batch_mmt4d(IREE_UK_FLAG_MMT4D_TYPE_BF16BF16BF16, 2, 3, 4, "");
+
+#if defined(IREE_ARCH_ARM_64)
+  iree_uk_test_batch_mmt4d(IREE_UK_FLAG_MMT4D_TYPE_F32F32F32, 8, 8, 1, "");
+  iree_uk_test_batch_mmt4d(IREE_UK_FLAG_MMT4D_TYPE_I8I8I32, 8, 8, 4,
+                           "dotprod");
+#elif defined(IREE_ARCH_X86_64)
+  iree_uk_test_batch_mmt4d(IREE_UK_FLAG_MMT4D_TYPE_F32F32F32, 8, 8, 1,
+                           "avx2_fma");
+  iree_uk_test_batch_mmt4d(IREE_UK_FLAG_MMT4D_TYPE_F32F32F32, 16, 16, 1,
+                           "avx512_base");
+  iree_uk_test_batch_mmt4d(IREE_UK_FLAG_MMT4D_TYPE_I8I8I32, 16, 16, 2,
+                           "avx512_base");
+#endif  // defined(IREE_ARCH_ARM_64)
+
+  return iree_uk_test_exit_status();
+}
@@ -12,6 +12,7 @@
 #include "iree/builtins/ukernel/mmt4d_internal.h"
 #include "iree/builtins/ukernel/tools/benchmark.h"
 #include "iree/builtins/ukernel/tools/util.h"
+#include "iree/schemas/cpu_data.h"
 
 IREE_FLAG(string, type, "f32f32f32",
           "Element types triple (LHS, RHS, OUT). Valid values include: "
@@ -32,12 +33,18 @@ IREE_FLAG(
     "host CPU capabilities. Other values are like in other benchmarks, e.g. "
     "\"avx2_fma\", \"avx512_base\". The empty string \"\" means the "
     "architecture baseline (e.g. on x86-64 that would be SSE2).");
+IREE_FLAG(bool, shape_sweep, false,
+          "If true, ignore the M, K, N flags and benchmark a range of shapes, "
+          "from square ones to large-K ones whose packed operands exceed L2.");
 
 typedef struct iree_uk_benchmark_e2e_matmul_params_t {
   iree_uk_uint32_t mmt4d_flags;
   int M;
   int K;
   int N;
+  // If false, the cache sizes are hidden from mmt4d so that it falls back to
+  // its unblocked loop nest.
+  bool cache_blocking;
 } iree_uk_benchmark_e2e_matmul_params_t;
 
 static iree_uk_uint32_t iree_uk_qts_op_flag(iree_uk_mmt4d_type_t type) {
@@ -187,9 +194,13 @@ static iree_status_t iree_uk_benchmark_e2e_matmul(
     const iree_benchmark_def_t* benchmark_def,
     iree_benchmark_state_t* benchmark_state) {
   const iree_uk_benchmark_user_data_t* user_data = benchmark_def->user_data;
-  const iree_uk_uint64_t* cpu_data = iree_uk_benchmark_cpu_data(user_data);
   const iree_uk_benchmark_e2e_matmul_params_t* params =
       iree_uk_benchmark_params(user_data);
+  iree_uk_uint64_t cpu_data[IREE_CPU_DATA_FIELD_COUNT];
+  memcpy(cpu_data, iree_uk_benchmark_cpu_data(user_data), sizeof cpu_data);
+  if (!params->cache_blocking) {
+    cpu_data[IREE_CPU_DATA_CACHE_FIELD_INDEX] = 0;
+  }
 
   iree_uk_mmt4d_type_t mmt4d_type = iree_uk_mmt4d_type(params->mmt4d_flags);
   iree_uk_type_t lhs_type = iree_uk_mmt4d_lhs_type(mmt4d_type);
@@ -383,17 +394,27 @@ iree_uk_uint32_t iree_uk_mmt4d_parse_type_into_flag(const char* type) {
   return (iree_uk_mmt4d_type_t)0;
 }
 
+// Registers the matmul both with and without mmt4d cache blocking so that the
+// two loop nests can be compared side by side.
 static void iree_uk_benchmark_register_e2e_matmul(const char* type_str, int M,
                                                   int K, int N, bool accumulate,
                                                   const char* cpu_features) {
-  char name[128];
-  snprintf(name, sizeof name, "e2e_matmul_%s_%dx%dx%d", type_str, M, K, N);
   iree_uk_uint32_t mmt4d_flags = iree_uk_mmt4d_parse_type_into_flag(type_str);
   if (accumulate) mmt4d_flags |= IREE_UK_FLAG_MMT4D_ACCUMULATE;
-  iree_uk_benchmark_e2e_matmul_params_t params = {
-      .mmt4d_flags = mmt4d_flags, .M = M, .K = K, .N = N};
-  iree_uk_benchmark_register(name, iree_uk_benchmark_e2e_matmul, &params,
-                             sizeof params, cpu_features);
+  for (int cache_blocking = 0; cache_blocking <= 1; ++cache_blocking) {
+    char name[128];
+    snprintf(name, sizeof name, "e2e_matmul_%s_%dx%dx%d_%s", type_str, M, K, N,
+             cache_blocking ? "blocked" : "unblocked");
+    iree_uk_benchmark_e2e_matmul_params_t params = {
+        .mmt4d_flags = mmt4d_flags,
+        .M = M,
+        .K = K,
+        .N = N,
+        .cache_blocking = cache_blocking,
+    };
+    iree_uk_benchmark_register(name, iree_uk_benchmark_e2e_matmul, &params,
+                               sizeof params, cpu_features);
+  }
 }
 
 int main(int argc, char** argv) {
@@ -403,7 +424,22 @@ int main(int argc, char** argv) {
       "query_tile_sizes, pack, mmt4d, unpack.");
   iree_flags_parse_checked(IREE_FLAGS_PARSE_MODE_UNDEFINED_OK, &argc, &argv);
   iree_uk_benchmark_initialize(&argc, argv);
-  iree_uk_benchmark_register_e2e_matmul(FLAG_type, FLAG_M, FLAG_K, FLAG_N,
-                                        FLAG_accumulate, FLAG_cpu_features);
+  if (FLAG_shape_sweep) {
+    typedef struct shape_mkn_t {
+      int m, k, n;
+    } shape_mkn_t;
+    const shape_mkn_t shapes[] = {
+        {256, 256, 256},   {1024, 1024, 1024}, {128, 4096, 1024},
+        {64, 16384, 1024}, {16, 65536, 512},   {1024, 8192, 4096},
+    };
+    for (int i = 0; i < IREE_ARRAYSIZE(shapes); ++i) {
+      iree_uk_benchmark_register_e2e_matmul(FLAG_type, shapes[i].m,
+                                            shapes[i].k, shapes[i].n,
+                                            FLAG_accumulate, FLAG_cpu_features);
+    }
+  } else {
+    iree_uk_benchmark_register_e2e_matmul(FLAG_type, FLAG_M, FLAG_K, FLAG_N,
+                                          FLAG_accumulate, FLAG_cpu_features);
+  }
   iree_uk_benchmark_run_and_cleanup();
 }
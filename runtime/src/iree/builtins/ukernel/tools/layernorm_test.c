@@ -0,0 +1,178 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include <math.h>
+
+#include "iree/base/api.h"
+#include "iree/builtins/ukernel/api.h"
+#include "iree/builtins/ukernel/layernorm_internal.h"
+#include "iree/builtins/ukernel/tools/test.h"
+#include "iree/builtins/ukernel/tools/util.h"
+
+// Reference implementation accumulating in double precision.
+static void iree_layernorm_reference(const iree_uk_layernorm_params_t* params) {
+  bool rms = params->flags & IREE_UK_FLAG_LAYERNORM_RMS;
+  const float* gamma =
+      (const float*)params->gamma_buffer + params->gamma_offset;
+  const float* beta =
+      rms ? NULL : (const float*)params->beta_buffer + params->beta_offset;
+  for (iree_uk_index_t i = 0; i < params->size0; ++i) {
+    const float* in = (const float*)params->in_buffer + params->in_offset +
+                      i * params->in_stride0;
+    float* out = (float*)params->out_buffer + params->out_offset +
+                 i * params->out_stride0;
+    double mean = 0;
+    if (!rms) {
+      for (iree_uk_index_t j = 0; j < params->size1; ++j) mean += in[j];
+      mean /= params->size1;
+    }
+    double var = 0;
+    for (iree_uk_index_t j = 0; j < params->size1; ++j) {
+      var += (in[j] - mean) * (in[j] - mean);
+    }
+    var /= params->size1;
+    double inv_stddev = 1.0 / sqrt(var + params->epsilon);
+    for (iree_uk_index_t j = 0; j < params->size1; ++j) {
+      double y = (in[j] - mean) * inv_stddev * gamma[j];
+      out[j] = (float)(rms ? y : y + beta[j]);
+    }
+  }
+}
+
+static void iree_uk_test_layernorm_for_shape_params(
+    iree_uk_test_t* test, const iree_uk_layernorm_params_t* src_params) {
+  iree_uk_layernorm_params_t params;
+  memcpy(&params, src_params, sizeof params);
+  // Randomly make strides either tight or not to exercise all cases.
+  iree_uk_random_engine_t* engine = iree_uk_test_random_engine(test);
+  params.in_stride0 = params.size1 + iree_uk_random_engine_get_0_1(engine);
+  params.out_stride0 = params.size1 + iree_uk_random_engine_get_0_1(engine);
+  iree_uk_type_t type = IREE_UK_TYPE_FLOAT_32;
+  iree_uk_index_t in_buffer_size =
+      iree_uk_2d_buffer_length(type, params.size0, params.in_stride0);
+  float* in_buffer = malloc(in_buffer_size);
+  iree_uk_write_random_buffer(in_buffer, in_buffer_size, type, engine);
+  // Offset the inputs so that |mean| >> stddev in some rows, which is where a
+  // single-pass variance computation would lose precision.
+  for (iree_uk_index_t i = 0; i < params.size0; i += 2) {
+    for (iree_uk_index_t j = 0; j < params.size1; ++j) {
+      in_buffer[i * params.in_stride0 + j] += 1000.0f;
+    }
+  }
+  iree_uk_index_t vector_size = iree_uk_2d_buffer_length(type, 1, params.size1);
+  float* gamma_buffer = malloc(vector_size);
+  iree_uk_write_random_buffer(gamma_buffer, vector_size, type, engine);
+  float* beta_buffer = malloc(vector_size);
+  iree_uk_write_random_buffer(beta_buffer, vector_size, type, engine);
+  params.in_offset = iree_uk_random_engine_get_0_65535(engine);
+  params.in_buffer = in_buffer - params.in_offset;
+  params.gamma_offset = iree_uk_random_engine_get_0_65535(engine);
+  params.gamma_buffer = gamma_buffer - params.gamma_offset;
+  params.gamma_stride0 = 1;
+  if (params.flags & IREE_UK_FLAG_LAYERNORM_RMS) {
+    params.beta_buffer = NULL;
+  } else {
+    params.beta_offset = iree_uk_random_engine_get_0_65535(engine);
+    params.beta_buffer = beta_buffer - params.beta_offset;
+    params.beta_stride0 = 1;
+  }
+  params.out_offset = iree_uk_random_engine_get_0_65535(engine);
+  iree_uk_index_t out_buffer_size =
+      iree_uk_2d_buffer_length(type, params.size0, params.out_stride0);
+
+  iree_uk_layernorm_params_t reference_params;
+  memcpy(&reference_params, &params, sizeof reference_params);
+  float* reference_out_buffer = malloc(out_buffer_size);
+  iree_uk_write_random_buffer(reference_out_buffer, out_buffer_size, type,
+                              engine);
+  reference_params.out_buffer = reference_out_buffer - params.out_offset;
+
+  iree_uk_layernorm_params_t actual_params;
+  memcpy(&actual_params, &params, sizeof actual_params);
+  float* actual_out_buffer = malloc(out_buffer_size);
+  iree_uk_write_random_buffer(actual_out_buffer, out_buffer_size, type,
+                              engine);
+  actual_params.out_buffer = actual_out_buffer - params.out_offset;
+
+  iree_layernorm_reference(&reference_params);
+  iree_uk_layernorm(&actual_params);
+
+  if (!iree_uk_2d_f32_buffers_close(actual_out_buffer, reference_out_buffer,
+                                    params.size0, params.size1,
+                                    params.out_stride0, 1e-4f)) {
+    IREE_UK_TEST_FAIL(test);
+  }
+
+  free(reference_out_buffer);
+  free(actual_out_buffer);
+  free(beta_buffer);
+  free(gamma_buffer);
+  free(in_buffer);
+}
+
+static void iree_uk_test_layernorm_for_flags(iree_uk_test_t* test,
+                                             const void* src_params) {
+  typedef struct shape_t {
+    int size0, size1;
+  } shape_t;
+  const shape_t shapes[] = {
+      // Degenerate cases. Vacuous.
+      {0, 1},
+      {1, 0},
+      // Non-degenerate cases, with row lengths hitting all the vector loop
+      // remainder cases.
+      {1, 1},
+      {2, 3},
+      {3, 7},
+      {3, 8},
+      {4, 15},
+      {4, 16},
+      {5, 17},
+      {2, 33},
+      {3, 64},
+      {2, 100},
+      {2, 768},
+  };
+  for (int i = 0; i < IREE_ARRAYSIZE(shapes); ++i) {
+    iree_uk_layernorm_params_t params;
+    memcpy(&params, src_params, sizeof params);
+    params.cpu_data = iree_uk_test_cpu_data(test);
+    params.size0 = shapes[i].size0;
+    params.size1 = shapes[i].size1;
+    iree_uk_test_layernorm_for_shape_params(test, &params);
+  }
+}
+
+static void iree_uk_test_layernorm(iree_uk_uint32_t flags,
+                                   const char* cpu_features) {
+  iree_uk_layernorm_params_t params = {.flags = flags, .epsilon = 1e-5f};
+  char types_str[32];
+  iree_uk_layernorm_type_t layernorm_type = iree_uk_layernorm_type(flags);
+  iree_uk_type_pair_str(types_str, sizeof types_str, layernorm_type);
+  char test_label_str[256];
+  snprintf(test_label_str, sizeof test_label_str, "types:%s%s", types_str,
+           (flags & IREE_UK_FLAG_LAYERNORM_RMS) ? " rms" : "");
+  iree_uk_test(test_label_str, iree_uk_test_layernorm_for_flags, &params,
+               cpu_features);
+}
+
+int main(int argc, char** argv) {
+  const iree_uk_uint32_t f32 = IREE_UK_FLAG_LAYERNORM_TYPE_F32F32;
+  const iree_uk_uint32_t rms = IREE_UK_FLAG_LAYERNORM_RMS;
+  iree_uk_test_layernorm(f32, "");
+  iree_uk_test_layernorm(f32 | rms, "");
+
+  // On arm64, the tests above already exercise the NEON tile functions: NEON
+  // is part of the baseline ISA, so they are selected without CPU features.
+#if defined(IREE_ARCH_X86_64)
+  iree_uk_test_layernorm(f32, "avx2_fma");
+  iree_uk_test_layernorm(f32 | rms, "avx2_fma");
+  iree_uk_test_layernorm(f32, "avx512_base");
+  iree_uk_test_layernorm(f32 | rms, "avx512_base");
+#endif  // defined(IREE_ARCH_X86_64)
+
+  return iree_uk_test_exit_status();
+}
@@ -0,0 +1,205 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+// Sweeps the mmt4d tile shapes that have optimized code paths on the host,
+// times each of them on a matmul of a fixed overall shape, and prints the
+// fastest tile sizes for each operation. This is meant to inform the per-ISA
+// tile size choices of CPU encoding materialization and of
+// iree_uk_query_tile_sizes_2d, which must agree with each other.
+//
+// The candidate shapes are every combination of the M0, N0 and K0 values
+// below. Only the candidates for which iree_uk_mmt4d_select_tile_func_arch
+// returns a tile function on the host are timed, so this does not need to be
+// updated when tile functions are added. Since the tile sizes differ, the
+// number of tiles is derived from the --m_size/--n_size/--k_size element counts
+// so that every shape performs the same amount of work (up to padding to a
+// whole number of tiles).
+
+#include <stdio.h>
+
+#include "iree/base/api.h"
+#include "iree/base/internal/cpu.h"
+#include "iree/base/internal/flags.h"
+#include "iree/builtins/ukernel/api.h"
+#include "iree/builtins/ukernel/mmt4d_internal.h"
+#include "iree/builtins/ukernel/tools/util.h"
+#include "iree/schemas/cpu_data.h"
+
+IREE_FLAG(int32_t, m_size, 256,
+          "Number of rows of the LHS and of the accumulator, in elements.");
+IREE_FLAG(int32_t, n_size, 256,
+          "Number of rows of the RHS and of columns of the accumulator, in "
+          "elements.");
+IREE_FLAG(int32_t, k_size, 512, "Accumulation depth, in elements.");
+IREE_FLAG(int32_t, repetitions, 10,
+          "Number of timed runs of each variant. The fastest run is kept.");
+
+// An operation to tune.
+typedef struct iree_uk_autotune_operation_t {
+  // IREE_UK_FLAG_MMT4D_TYPE_* value.
+  iree_uk_uint32_t mmt4d_type_flags;
+  // Suffix of the IREE_UK_FLAG_QUERY_TILE_SIZES_OPERATION_* value.
+  const char* name;
+} iree_uk_autotune_operation_t;
+
+static const iree_uk_autotune_operation_t iree_uk_autotune_operations[] = {
+    {IREE_UK_FLAG_MMT4D_TYPE_F32F32F32, "MATMUL_F32F32F32"},
+    {IREE_UK_FLAG_MMT4D_TYPE_F16F16F32, "MATMUL_F16F16F32"},
+    {IREE_UK_FLAG_MMT4D_TYPE_F16F16F16, "MATMUL_F16F16F16"},
+    {IREE_UK_FLAG_MMT4D_TYPE_BF16BF16F32, "MATMUL_BF16BF16F32"},
+    {IREE_UK_FLAG_MMT4D_TYPE_I8I8I32, "MATMUL_I8I8I32"},
+};
+
+// Candidate tile sizes. Their combinations cover the tile shapes of all the
+// optimized tile functions that exist on any architecture.
+static const int iree_uk_autotune_m0_values[] = {1, 2, 4, 8, 16};
+static const int iree_uk_autotune_n0_values[] = {4, 8, 16};
+static const int iree_uk_autotune_k0_values[] = {1, 2, 4, 8};
+
+// A tile variant to time.
+typedef struct iree_uk_autotune_variant_t {
+  iree_uk_uint32_t mmt4d_type_flags;
+  int M0, N0, K0;
+} iree_uk_autotune_variant_t;
+
+// Returns the mmt4d flags that variants are timed with.
+static iree_uk_uint32_t iree_uk_autotune_flags(
+    const iree_uk_autotune_variant_t* variant) {
+  return variant->mmt4d_type_flags |
+         IREE_UK_FLAG_MMT4D_SKIP_INTERMEDIATE_ROUNDINGS;
+}
+
+// Returns true if the host has an optimized tile function for |variant|.
+static bool iree_uk_autotune_has_tile_func(
+    const iree_uk_autotune_variant_t* variant) {
+  iree_uk_mmt4d_params_t params = {
+      .flags = iree_uk_autotune_flags(variant),
+      .M0 = variant->M0,
+      .N0 = variant->N0,
+      .K0 = variant->K0,
+      .cpu_data = (const iree_uk_uint64_t*)iree_cpu_data_fields(),
+  };
+  return iree_uk_mmt4d_select_tile_func_arch(&params) != 0;
+}
+
+// Returns the fastest of FLAG_repetitions runs of |variant|, in nanoseconds.
+static iree_duration_t iree_uk_autotune_time_variant(
+    const iree_uk_autotune_variant_t* variant,
+    iree_uk_random_engine_t* engine) {
+  iree_uk_mmt4d_params_t params = {
+      .flags = iree_uk_autotune_flags(variant),
+      .M = (FLAG_m_size + variant->M0 - 1) / variant->M0,
+      .N = (FLAG_n_size + variant->N0 - 1) / variant->N0,
+      .K = (FLAG_k_size + variant->K0 - 1) / variant->K0,
+      .M0 = variant->M0,
+      .N0 = variant->N0,
+      .K0 = variant->K0,
+      // The host processor data rather than just the variant's features, so
+      // that fields such as the cache sizes are the ones seen in deployment.
+      .cpu_data = (const iree_uk_uint64_t*)iree_cpu_data_fields(),
+  };
+  params.lhs_stride0 = params.K * params.M0 * params.K0;
+  params.rhs_stride0 = params.K * params.N0 * params.K0;
+  params.out_stride0 = params.N * params.M0 * params.N0;
+  iree_uk_mmt4d_type_t mmt4d_type = iree_uk_mmt4d_type(params.flags);
+  iree_uk_type_t lhs_type = iree_uk_mmt4d_lhs_type(mmt4d_type);
+  iree_uk_type_t rhs_type = iree_uk_mmt4d_rhs_type(mmt4d_type);
+  iree_uk_type_t out_type = iree_uk_mmt4d_out_type(mmt4d_type);
+  iree_uk_index_t lhs_buffer_size =
+      iree_uk_2d_buffer_length(lhs_type, params.M, params.lhs_stride0);
+  iree_uk_index_t rhs_buffer_size =
+      iree_uk_2d_buffer_length(rhs_type, params.N, params.rhs_stride0);
+  iree_uk_index_t out_buffer_size =
+      iree_uk_2d_buffer_length(out_type, params.M, params.out_stride0);
+  void* lhs_buffer = malloc(lhs_buffer_size);
+  void* rhs_buffer = malloc(rhs_buffer_size);
+  void* out_buffer = malloc(out_buffer_size);
+  iree_uk_write_random_buffer(lhs_buffer, lhs_buffer_size, lhs_type, engine);
+  iree_uk_write_random_buffer(rhs_buffer, rhs_buffer_size, rhs_type, engine);
+  params.lhs_buffer = lhs_buffer;
+  params.rhs_buffer = rhs_buffer;
+  params.out_buffer = out_buffer;
+  // Untimed warm-up run to fault in the buffers.
+  iree_uk_mmt4d(&params);
+  iree_duration_t best_duration = IREE_DURATION_INFINITE;
+  for (int i = 0; i < FLAG_repetitions; ++i) {
+    iree_time_t start_time = iree_time_now();
+    iree_uk_mmt4d(&params);
+    best_duration = iree_min(best_duration, iree_time_now() - start_time);
+  }
+  free(lhs_buffer);
+  free(rhs_buffer);
+  free(out_buffer);
+  return best_duration;
+}
+
+int main(int argc, char** argv) {
+  iree_flags_set_usage(
+      "mmt4d_autotune",
+      "Prints the fastest mmt4d tile sizes on the host for each "
+      "operation.\n");
+  iree_flags_parse_checked(IREE_FLAGS_PARSE_MODE_DEFAULT, &argc, &argv);
+  if (FLAG_m_size <= 0 || FLAG_n_size <= 0 || FLAG_k_size <= 0 ||
+      FLAG_repetitions <= 0) {
+    fprintf(stderr, "Sizes and repetitions must be positive.\n");
+    return EXIT_FAILURE;
+  }
+  iree_uk_initialize_cpu_once();
+  iree_uk_uint64_t cpu_model =
+      iree_cpu_data_field(IREE_CPU_DATA_MODEL_FIELD_INDEX);
+
+  iree_uk_random_engine_t engine = iree_uk_random_engine_init();
+  printf("Fastest M0xN0xK0 tiles with m_size=%d n_size=%d k_size=%d",
+         FLAG_m_size, FLAG_n_size, FLAG_k_size);
+  if (cpu_model) {
+    printf(" on CPU vendor 0x%x family 0x%x model 0x%x",
+           (unsigned)((cpu_model >> IREE_CPU_DATA6_VENDOR_SHIFT) &
+                      IREE_CPU_DATA6_VENDOR_MASK),
+           (unsigned)((cpu_model >> IREE_CPU_DATA6_FAMILY_SHIFT) &
+                      IREE_CPU_DATA6_FAMILY_MASK),
+           (unsigned)((cpu_model >> IREE_CPU_DATA6_MODEL_SHIFT) &
+                      IREE_CPU_DATA6_MODEL_MASK));
+  }
+  printf(":\n");
+  for (int op = 0; op < IREE_ARRAYSIZE(iree_uk_autotune_operations); ++op) {
+    const iree_uk_autotune_operation_t* operation =
+        &iree_uk_autotune_operations[op];
+    iree_uk_autotune_variant_t best_variant = {0};
+    double best_ops_per_ns = 0.0;
+    for (int m = 0; m < IREE_ARRAYSIZE(iree_uk_autotune_m0_values); ++m) {
+      for (int n = 0; n < IREE_ARRAYSIZE(iree_uk_autotune_n0_values); ++n) {
+        for (int k = 0; k < IREE_ARRAYSIZE(iree_uk_autotune_k0_values); ++k) {
+          iree_uk_autotune_variant_t variant = {
+              .mmt4d_type_flags = operation->mmt4d_type_flags,
+              .M0 = iree_uk_autotune_m0_values[m],
+              .N0 = iree_uk_autotune_n0_values[n],
+              .K0 = iree_uk_autotune_k0_values[k],
+          };
+          if (!iree_uk_autotune_has_tile_func(&variant)) continue;
+          iree_duration_t duration =
+              iree_uk_autotune_time_variant(&variant, &engine);
+          // Count only the useful ops, not the ones on padding.
+          double ops_per_ns = 2.0 * FLAG_m_size * FLAG_n_size * FLAG_k_size /
+                              (double)iree_max(duration, 1);
+          fprintf(stderr, "%s tile %dx%dx%d: %.2f Gop/s\n", operation->name,
+                  variant.M0, variant.N0, variant.K0, ops_per_ns);
+          if (ops_per_ns > best_ops_per_ns) {
+            best_variant = variant;
+            best_ops_per_ns = ops_per_ns;
+          }
+        }
+      }
+    }
+    if (!best_ops_per_ns) {
+      fprintf(stderr, "%s has no optimized tile function on the host.\n",
+              operation->name);
+      continue;
+    }
+    printf("%s: %dx%dx%d at %.2f Gop/s\n", operation->name, best_variant.M0,
+           best_variant.N0, best_variant.K0, best_ops_per_ns);
+  }
+  return EXIT_SUCCESS;
+}
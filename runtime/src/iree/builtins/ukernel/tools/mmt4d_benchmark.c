@@ -23,6 +23,10 @@ IREE_FLAG(
     int32_t, k_size, 256,
     "K-dimension of mmt4d ops. That's the number of iterations of the inner "
     "loop. The overall accumulation depth is that times the K0 tile size.");
+IREE_FLAG(int32_t, rhs_group_size, 128,
+          "For weight-only quantized types, the number of RHS elements along "
+          "the reduction dimension sharing a scale. Must be a multiple of the "
+          "K0 tile size. 0 means no scales.");
 IREE_FLAG(bool, accumulate, false,
           "Whether the kernel should accumulate into the existing accumulator "
           "tile values, or zero the accumulator tile.");
@@ -67,11 +71,47 @@ static iree_status_t iree_uk_benchmark_mmt4d(
   params.lhs_buffer = lhs_buffer;
   params.rhs_buffer = rhs_buffer;
   params.out_buffer = out_buffer;
+  // Weight-only quantized types go through iree_uk_mmt4d_dequant with scales,
+  // as the compiler emits for them.
+  bool dequant = iree_uk_mmt4d_type_is_dequant(mmt4d_type);
+  iree_uk_mmt4d_dequant_params_t dequant_params = {
+      .lhs_buffer = params.lhs_buffer,
+      .lhs_stride0 = params.lhs_stride0,
+      .rhs_buffer = params.rhs_buffer,
+      .rhs_stride0 = params.rhs_stride0,
+      .out_buffer = params.out_buffer,
+      .out_stride0 = params.out_stride0,
+      .M = params.M,
+      .N = params.N,
+      .K = params.K,
+      .M0 = params.M0,
+      .N0 = params.N0,
+      .K0 = params.K0,
+      .flags = params.flags,
+      .cpu_data = params.cpu_data,
+  };
+  void* rhs_scales_buffer = NULL;
+  if (dequant && FLAG_rhs_group_size) {
+    dequant_params.rhs_group_size = FLAG_rhs_group_size;
+    iree_uk_index_t group_count =
+        (params.K * params.K0 + FLAG_rhs_group_size - 1) / FLAG_rhs_group_size;
+    dequant_params.rhs_scales_stride0 = group_count * params.N0;
+    iree_uk_index_t rhs_scales_buffer_size = iree_uk_2d_buffer_length(
+        IREE_UK_TYPE_FLOAT_32, params.N, dequant_params.rhs_scales_stride0);
+    rhs_scales_buffer = malloc(rhs_scales_buffer_size);
+    iree_uk_write_random_buffer(rhs_scales_buffer, rhs_scales_buffer_size,
+                                IREE_UK_TYPE_FLOAT_32, engine);
+    dequant_params.rhs_scales_buffer = rhs_scales_buffer;
+  }
   int64_t total_iterations = 0;
   int64_t batch_count = 1;
   while (iree_benchmark_keep_running(benchmark_state, batch_count)) {
     for (int i = 0; i < batch_count; ++i) {
-      iree_uk_mmt4d(&params);
+      if (dequant) {
+        iree_uk_mmt4d_dequant(&dequant_params);
+      } else {
+        iree_uk_mmt4d(&params);
+      }
     }
     total_iterations += batch_count;
     batch_count *= 2;
@@ -82,6 +122,7 @@ static iree_status_t iree_uk_benchmark_mmt4d(
   free(lhs_buffer);
   free(rhs_buffer);
   free(out_buffer);
+  free(rhs_scales_buffer);
   return iree_ok_status();
 }
 
@@ -134,6 +175,14 @@ int main(int argc, char** argv) {
                                    "dotprod");
   iree_uk_benchmark_register_mmt4d(IREE_UK_FLAG_MMT4D_TYPE_I8I8I32, 8, 8, 8,
                                    "i8mm");
+  iree_uk_benchmark_register_mmt4d(IREE_UK_FLAG_MMT4D_TYPE_F32I4F32, 8, 8, 1,
+                                   "");
+  iree_uk_benchmark_register_mmt4d(IREE_UK_FLAG_MMT4D_TYPE_F32I8F32, 8, 8, 1,
+                                   "");
+  iree_uk_benchmark_register_mmt4d(IREE_UK_FLAG_MMT4D_TYPE_F16I4F32, 8, 8, 1,
+                                   "");
+  iree_uk_benchmark_register_mmt4d(IREE_UK_FLAG_MMT4D_TYPE_F16I8F32, 8, 8, 1,
+                                   "");
 #elif defined(IREE_ARCH_X86_64)
   iree_uk_benchmark_register_mmt4d(IREE_UK_FLAG_MMT4D_TYPE_F32F32F32, 8, 8, 1,
                                    "avx2_fma");
@@ -153,6 +202,14 @@ int main(int argc, char** argv) {
                                    "avx512_base");
   iree_uk_benchmark_register_mmt4d(IREE_UK_FLAG_MMT4D_TYPE_I8I8I32, 16, 16, 2,
                                    "avx512_vnni");
+  iree_uk_benchmark_register_mmt4d(IREE_UK_FLAG_MMT4D_TYPE_F32I4F32, 8, 8, 1,
+                                   "avx2_fma");
+  iree_uk_benchmark_register_mmt4d(IREE_UK_FLAG_MMT4D_TYPE_F32I8F32, 8, 8, 1,
+                                   "avx2_fma");
+  iree_uk_benchmark_register_mmt4d(IREE_UK_FLAG_MMT4D_TYPE_F16I4F32, 8, 8, 1,
+                                   "avx2_fma");
+  iree_uk_benchmark_register_mmt4d(IREE_UK_FLAG_MMT4D_TYPE_F16I8F32, 8, 8, 1,
+                                   "avx2_fma");
 #else   // defined(IREE_ARCH_ARM_64)
   // Architectures on which we do not have any optimized ukernel code.
   // Benchmark some arbitrary tile shape.
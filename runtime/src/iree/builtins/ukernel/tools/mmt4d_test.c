@@ -12,6 +12,7 @@
 #include "iree/builtins/ukernel/mmt4d_internal.h"
 #include "iree/builtins/ukernel/tools/test.h"
 #include "iree/builtins/ukernel/tools/util.h"
+#include "iree/schemas/cpu_data.h"
 
 static void iree_mmt4d_reference_innerloop_f32f32f32(
     float* out_ptr, const float* lhs_ptr, const float* rhs_ptr,
@@ -137,6 +138,74 @@ static void iree_mmt4d_reference_innerloop_i8i8i32(
   *out_ptr = acc;
 }
 
+// Returns element |index| of an int4 buffer, sign-extended. Elements are packed
+// two per byte, with the even-indexed element in the low nibble.
+static int32_t iree_mmt4d_reference_load_i4(const void* buffer,
+                                            iree_uk_index_t index) {
+  uint8_t byte = ((const uint8_t*)buffer)[index >> 1];
+  int32_t nibble = (index & 1) ? (byte >> 4) : (byte & 0xF);
+  return nibble >= 8 ? nibble - 16 : nibble;
+}
+
+// Reference for the weight-only quantized types. These get their own loop nest
+// as the RHS may be a sub-byte type and is scaled per column and group.
+static void iree_mmt4d_reference_dequant(
+    const iree_uk_mmt4d_dequant_params_t* params) {
+  iree_uk_mmt4d_type_t mmt4d_type = iree_uk_mmt4d_type(params->flags);
+  iree_uk_type_t lhs_type = iree_uk_mmt4d_lhs_type(mmt4d_type);
+  iree_uk_type_t rhs_type = iree_uk_mmt4d_rhs_type(mmt4d_type);
+  iree_uk_index_t lhs_elem_size = iree_uk_type_size(lhs_type);
+  const iree_uk_index_t M0 = params->M0;
+  const iree_uk_index_t N0 = params->N0;
+  const iree_uk_index_t K0 = params->K0;
+  for (iree_uk_index_t i = 0; i < params->M; ++i) {
+    for (iree_uk_index_t j = 0; j < params->N; ++j) {
+      float* out_tile_ptr = (float*)params->out_buffer + params->out_offset +
+                            i * params->out_stride0 + j * M0 * N0;
+      const char* lhs_panel_ptr =
+          ((const char*)params->lhs_buffer) +
+          (params->lhs_offset + i * params->lhs_stride0) * lhs_elem_size;
+      // In elements, as the RHS element type may be sub-byte.
+      iree_uk_index_t rhs_panel_index =
+          params->rhs_offset + j * params->rhs_stride0;
+      const float* scales_panel_ptr = (const float*)params->rhs_scales_buffer +
+                                      params->rhs_scales_offset +
+                                      j * params->rhs_scales_stride0;
+      for (iree_uk_index_t i0 = 0; i0 < M0; ++i0) {
+        for (iree_uk_index_t j0 = 0; j0 < N0; ++j0) {
+          float* out_ptr = out_tile_ptr + i0 * N0 + j0;
+          float acc =
+              params->flags & IREE_UK_FLAG_MMT4D_ACCUMULATE ? *out_ptr : 0.f;
+          for (iree_uk_index_t k = 0; k < params->K; ++k) {
+            for (iree_uk_index_t k0 = 0; k0 < K0; ++k0) {
+              iree_uk_index_t lhs_index = k * M0 * K0 + i0 * K0 + k0;
+              float lhs_f32 =
+                  lhs_type == IREE_UK_TYPE_FLOAT_32
+                      ? ((const float*)lhs_panel_ptr)[lhs_index]
+                      : iree_math_f16_to_f32(
+                            ((const uint16_t*)lhs_panel_ptr)[lhs_index]);
+              iree_uk_index_t rhs_index =
+                  rhs_panel_index + k * N0 * K0 + j0 * K0 + k0;
+              int32_t rhs_i32 =
+                  rhs_type == IREE_UK_TYPE_INT_8
+                      ? ((const int8_t*)params->rhs_buffer)[rhs_index]
+                      : iree_mmt4d_reference_load_i4(params->rhs_buffer,
+                                                     rhs_index);
+              float scale = 1.f;
+              if (params->rhs_group_size) {
+                iree_uk_index_t group = (k * K0 + k0) / params->rhs_group_size;
+                scale = scales_panel_ptr[group * N0 + j0];
+              }
+              acc += lhs_f32 * (rhs_i32 * scale);
+            }
+          }
+          *out_ptr = acc;
+        }
+      }
+    }
+  }
+}
+
 static void iree_mmt4d_reference(const iree_uk_mmt4d_params_t* params) {
   iree_uk_mmt4d_type_t mmt4d_type = iree_uk_mmt4d_type(params->flags);
   iree_uk_index_t lhs_elem_size =
@@ -206,6 +275,17 @@ static void iree_mmt4d_reference(const iree_uk_mmt4d_params_t* params) {
   }
 }
 
+// Fills |buffer| with random powers of two, so that scaling by them keeps float
+// arithmetic exact.
+static void iree_uk_write_random_scales(float* buffer, iree_uk_index_t count,
+                                        iree_uk_random_engine_t* engine) {
+  static const float scales[] = {0.5f, 1.f, 2.f};
+  for (iree_uk_index_t i = 0; i < count; ++i) {
+    int index = iree_uk_random_engine_get_0_65535(engine);
+    buffer[i] = scales[index % IREE_ARRAYSIZE(scales)];
+  }
+}
+
 static void iree_uk_test_mmt4d_for_shape_params(
     iree_uk_test_t* test, const iree_uk_mmt4d_params_t* src_params) {
   iree_uk_mmt4d_params_t params;
@@ -283,6 +363,16 @@ static void iree_uk_test_mmt4d_for_shape_params(
     }
   }
 
+  // Running with a pre-resolved tile function, as runtime callers caching it
+  // do, must give the same result as iree_uk_mmt4d.
+  void* resolved_out_buffer = malloc(out_buffer_size);
+  memcpy(resolved_out_buffer, init_out_buffer, out_buffer_size);
+  actual_params.out_buffer = (char*)resolved_out_buffer -
+                             (params.out_offset * iree_uk_type_size(out_type));
+  iree_uk_mmt4d_with_resolved_tile_func(
+      &actual_params, iree_uk_mmt4d_resolve_tile_func(&actual_params));
+  fail |= memcmp(actual_out_buffer, resolved_out_buffer, out_buffer_size) != 0;
+
   if (fail) {
     IREE_UK_TEST_FAIL(test);
   }
@@ -290,10 +380,139 @@ static void iree_uk_test_mmt4d_for_shape_params(
   free(init_out_buffer);
   free(reference_out_buffer);
   free(actual_out_buffer);
+  free(resolved_out_buffer);
   free(lhs_buffer);
   free(rhs_buffer);
 }
 
+// Like iree_uk_test_mmt4d_for_shape_params for the weight-only quantized
+// types, running iree_uk_mmt4d_dequant with scale groups of |rhs_group_size|
+// RHS elements, or without scales if it is 0.
+static void iree_uk_test_mmt4d_dequant_for_shape_params(
+    iree_uk_test_t* test, const iree_uk_mmt4d_params_t* src_params,
+    iree_uk_int32_t rhs_group_size) {
+  iree_uk_mmt4d_dequant_params_t params = {
+      .M = src_params->M,
+      .N = src_params->N,
+      .K = src_params->K,
+      .M0 = src_params->M0,
+      .N0 = src_params->N0,
+      .K0 = src_params->K0,
+      .flags = src_params->flags,
+      .rhs_group_size = rhs_group_size,
+      .cpu_data = src_params->cpu_data,
+  };
+  // Populate strides first - we need them below to compute buffer lengths.
+  // Randomly make strides either tight or not to exercise all cases.
+  iree_uk_random_engine_t* engine = iree_uk_test_random_engine(test);
+  params.lhs_stride0 =
+      params.K * params.M0 * params.K0 + iree_uk_random_engine_get_0_1(engine);
+  params.rhs_stride0 =
+      params.K * params.N0 * params.K0 + iree_uk_random_engine_get_0_1(engine);
+  params.out_stride0 =
+      params.N * params.M0 * params.N0 + iree_uk_random_engine_get_0_1(engine);
+  iree_uk_mmt4d_type_t mmt4d_type = iree_uk_mmt4d_type(params.flags);
+  iree_uk_type_t lhs_type = iree_uk_mmt4d_lhs_type(mmt4d_type);
+  iree_uk_type_t rhs_type = iree_uk_mmt4d_rhs_type(mmt4d_type);
+  iree_uk_type_t out_type = iree_uk_mmt4d_out_type(mmt4d_type);
+  // Sub-byte RHS panels must start on byte boundaries.
+  int rhs_bit_count = iree_uk_type_bit_count(rhs_type);
+  iree_uk_index_t rhs_elems_per_byte =
+      rhs_bit_count < 8 ? 8 / rhs_bit_count : 1;
+  params.rhs_stride0 = (params.rhs_stride0 + rhs_elems_per_byte - 1) /
+                       rhs_elems_per_byte * rhs_elems_per_byte;
+  iree_uk_index_t lhs_buffer_size =
+      iree_uk_2d_buffer_length(lhs_type, params.M, params.lhs_stride0);
+  iree_uk_index_t rhs_buffer_size =
+      iree_uk_2d_buffer_length(rhs_type, params.N, params.rhs_stride0);
+  void* lhs_buffer = malloc(lhs_buffer_size);
+  void* rhs_buffer = malloc(rhs_buffer_size);
+  iree_uk_write_random_buffer(lhs_buffer, lhs_buffer_size, lhs_type, engine);
+  iree_uk_write_random_buffer(rhs_buffer, rhs_buffer_size, rhs_type, engine);
+  params.lhs_offset = iree_uk_random_engine_get_0_65535(engine);
+  params.rhs_offset = iree_uk_random_engine_get_0_65535(engine) /
+                      rhs_elems_per_byte * rhs_elems_per_byte;
+  params.out_offset = iree_uk_random_engine_get_0_65535(engine);
+  params.lhs_buffer = (const char*)lhs_buffer -
+                      (params.lhs_offset * iree_uk_type_size(lhs_type));
+  params.rhs_buffer =
+      (const char*)rhs_buffer -
+      iree_uk_type_size_of_elements(rhs_type, params.rhs_offset);
+  float* rhs_scales_buffer = NULL;
+  if (rhs_group_size) {
+    iree_uk_index_t group_count =
+        (params.K * params.K0 + rhs_group_size - 1) / rhs_group_size;
+    params.rhs_scales_stride0 =
+        group_count * params.N0 + iree_uk_random_engine_get_0_1(engine);
+    iree_uk_index_t rhs_scales_count = params.N * params.rhs_scales_stride0;
+    rhs_scales_buffer = malloc(rhs_scales_count * sizeof(float));
+    iree_uk_write_random_scales(rhs_scales_buffer, rhs_scales_count, engine);
+    params.rhs_scales_offset = iree_uk_random_engine_get_0_65535(engine);
+    params.rhs_scales_buffer = rhs_scales_buffer - params.rhs_scales_offset;
+  }
+
+  iree_uk_index_t out_buffer_size =
+      iree_uk_2d_buffer_length(out_type, params.M, params.out_stride0);
+  void* init_out_buffer = malloc(out_buffer_size);
+  iree_uk_write_random_buffer(init_out_buffer, out_buffer_size, out_type,
+                              engine);
+  void* reference_out_buffer = malloc(out_buffer_size);
+  memcpy(reference_out_buffer, init_out_buffer, out_buffer_size);
+  void* actual_out_buffer = malloc(out_buffer_size);
+  memcpy(actual_out_buffer, init_out_buffer, out_buffer_size);
+  iree_uk_index_t out_buffer_offset_bytes =
+      params.out_offset * iree_uk_type_size(out_type);
+
+  iree_uk_mmt4d_dequant_params_t reference_params = params;
+  reference_params.out_buffer =
+      (char*)reference_out_buffer - out_buffer_offset_bytes;
+  iree_mmt4d_reference_dequant(&reference_params);
+  iree_uk_mmt4d_dequant_params_t actual_params = params;
+  actual_params.out_buffer = (char*)actual_out_buffer - out_buffer_offset_bytes;
+  iree_uk_mmt4d_dequant(&actual_params);
+
+  // Scales are powers of two, so float results are exact as for the other
+  // types.
+  bool fail = memcmp(actual_out_buffer, reference_out_buffer, out_buffer_size);
+
+  // Without scales, iree_uk_mmt4d must give the same result.
+  if (!rhs_group_size) {
+    memcpy(actual_out_buffer, init_out_buffer, out_buffer_size);
+    iree_uk_mmt4d_params_t unscaled_params = {
+        .lhs_buffer = params.lhs_buffer,
+        .lhs_offset = params.lhs_offset,
+        .lhs_stride0 = params.lhs_stride0,
+        .rhs_buffer = params.rhs_buffer,
+        .rhs_offset = params.rhs_offset,
+        .rhs_stride0 = params.rhs_stride0,
+        .out_buffer = actual_params.out_buffer,
+        .out_offset = params.out_offset,
+        .out_stride0 = params.out_stride0,
+        .M = params.M,
+        .N = params.N,
+        .K = params.K,
+        .M0 = params.M0,
+        .N0 = params.N0,
+        .K0 = params.K0,
+        .flags = params.flags,
+        .cpu_data = params.cpu_data,
+    };
+    iree_uk_mmt4d(&unscaled_params);
+    fail |= memcmp(actual_out_buffer, reference_out_buffer, out_buffer_size);
+  }
+
+  if (fail) {
+    IREE_UK_TEST_FAIL(test);
+  }
+
+  free(init_out_buffer);
+  free(reference_out_buffer);
+  free(actual_out_buffer);
+  free(lhs_buffer);
+  free(rhs_buffer);
+  free(rhs_scales_buffer);
+}
+
 static void iree_uk_test_mmt4d_for_tile_params(iree_uk_test_t* test,
                                                const void* src_params) {
   typedef struct shape_mnk_t {
@@ -320,17 +539,41 @@ static void iree_uk_test_mmt4d_for_tile_params(iree_uk_test_t* test,
       {2, 2, 2},
       {5, 7, 13},
   };
-  for (int i = 0; i < IREE_ARRAYSIZE(shapes); ++i) {
+  // Also pretend to have tiny caches (1 KiB L1, 4 KiB L2) so that the
+  // cache-blocked loop nest gets exercised by the larger shapes.
+  iree_uk_uint64_t tiny_cache_cpu_data[IREE_CPU_DATA_FIELD_COUNT];
+  memcpy(tiny_cache_cpu_data, iree_uk_test_cpu_data(test),
+         sizeof tiny_cache_cpu_data);
+  tiny_cache_cpu_data[IREE_CPU_DATA_CACHE_FIELD_INDEX] =
+      (1ull << IREE_CPU_DATA7_L1D_SIZE_KB_SHIFT) |
+      (4ull << IREE_CPU_DATA7_L2_SIZE_KB_SHIFT);
+  const iree_uk_uint64_t* cpu_datas[] = {
+      iree_uk_test_cpu_data(test),
+      tiny_cache_cpu_data,
+  };
+  for (int i = 0; i < IREE_ARRAYSIZE(cpu_datas) * IREE_ARRAYSIZE(shapes); ++i) {
     iree_uk_mmt4d_params_t params;
     memcpy(&params, src_params, sizeof params);
-    params.cpu_data = iree_uk_test_cpu_data(test);
-    shape_mnk_t shape = shapes[i];
+    params.cpu_data = cpu_datas[i / IREE_ARRAYSIZE(shapes)];
+    shape_mnk_t shape = shapes[i % IREE_ARRAYSIZE(shapes)];
     params.M = shape.m;
     params.N = shape.n;
     params.K = shape.k;
+    bool dequant =
+        iree_uk_mmt4d_type_is_dequant(iree_uk_mmt4d_type(params.flags));
     for (int accumulate = 0; accumulate <= 1; ++accumulate) {
       if (accumulate) params.flags |= IREE_UK_FLAG_MMT4D_ACCUMULATE;
-      iree_uk_test_mmt4d_for_shape_params(test, &params);
+      if (!dequant) {
+        iree_uk_test_mmt4d_for_shape_params(test, &params);
+        continue;
+      }
+      // The weight-only quantized types are tested without scales, with a
+      // scale per K0-slice and with scale groups spanning multiple K0-slices.
+      const int group_size_multipliers[] = {0, 1, 3};
+      for (int g = 0; g < IREE_ARRAYSIZE(group_size_multipliers); ++g) {
+        iree_uk_test_mmt4d_dequant_for_shape_params(
+            test, &params, group_size_multipliers[g] * params.K0);
+      }
     }
   }
 }
@@ -373,8 +616,15 @@ int main(int argc, char** argv) {
   iree_uk_test_mmt4d(IREE_UK_FLAG_MMT4D_TYPE_F16F16F16, 3, 5, 8, "");
   iree_uk_test_mmt4d(IREE_UK_FLAG_MMT4D_TYPE_BF16BF16F32, 11, 4, 1, "");
   iree_uk_test_mmt4d(IREE_UK_FLAG_MMT4D_TYPE_BF16BF16BF16, 2, 9, 3, "");
+  iree_uk_test_mmt4d(IREE_UK_FLAG_MMT4D_TYPE_F32I4F32, 4, 6, 2, "");
+  iree_uk_test_mmt4d(IREE_UK_FLAG_MMT4D_TYPE_F32I8F32, 3, 5, 3, "");
+  iree_uk_test_mmt4d(IREE_UK_FLAG_MMT4D_TYPE_F16I4F32, 5, 2, 3, "");
+  iree_uk_test_mmt4d(IREE_UK_FLAG_MMT4D_TYPE_F16I8F32, 3, 5, 4, "");
 
 #if defined(IREE_ARCH_ARM_64)
+  iree_uk_test_mmt4d(IREE_UK_FLAG_MMT4D_TYPE_F32F32F32, 1, 8, 1, "");
+  iree_uk_test_mmt4d(IREE_UK_FLAG_MMT4D_TYPE_F32F32F32, 2, 8, 1, "");
+  iree_uk_test_mmt4d(IREE_UK_FLAG_MMT4D_TYPE_F32F32F32, 4, 8, 1, "");
   iree_uk_test_mmt4d(IREE_UK_FLAG_MMT4D_TYPE_F32F32F32, 8, 8, 1, "");
   iree_uk_test_mmt4d(IREE_UK_FLAG_MMT4D_TYPE_F16F16F32, 8, 8, 1, "");
   iree_uk_test_mmt4d(IREE_UK_FLAG_MMT4D_TYPE_F16F16F32, 8, 8, 1, "fp16fml");
@@ -386,9 +636,24 @@ int main(int argc, char** argv) {
   iree_uk_test_mmt4d(IREE_UK_FLAG_MMT4D_TYPE_I8I8I32, 8, 8, 1, "");
   iree_uk_test_mmt4d(IREE_UK_FLAG_MMT4D_TYPE_I8I8I32, 8, 8, 4, "dotprod");
   iree_uk_test_mmt4d(IREE_UK_FLAG_MMT4D_TYPE_I8I8I32, 8, 8, 8, "i8mm");
+  iree_uk_test_mmt4d(IREE_UK_FLAG_MMT4D_TYPE_F32I4F32, 8, 8, 1, "");
+  iree_uk_test_mmt4d(IREE_UK_FLAG_MMT4D_TYPE_F32I8F32, 8, 8, 1, "");
+  iree_uk_test_mmt4d(IREE_UK_FLAG_MMT4D_TYPE_F16I4F32, 8, 8, 1, "");
+  iree_uk_test_mmt4d(IREE_UK_FLAG_MMT4D_TYPE_F16I8F32, 8, 8, 1, "");
 #elif defined(IREE_ARCH_X86_64)
   iree_uk_test_mmt4d(IREE_UK_FLAG_MMT4D_TYPE_F32F32F32, 8, 4, 1, "");  // SSE
+  iree_uk_test_mmt4d(IREE_UK_FLAG_MMT4D_TYPE_F32F32F32, 1, 8, 1, "avx2_fma");
+  iree_uk_test_mmt4d(IREE_UK_FLAG_MMT4D_TYPE_F32F32F32, 2, 8, 1, "avx2_fma");
+  iree_uk_test_mmt4d(IREE_UK_FLAG_MMT4D_TYPE_F32F32F32, 4, 8, 1, "avx2_fma");
   iree_uk_test_mmt4d(IREE_UK_FLAG_MMT4D_TYPE_F32F32F32, 8, 8, 1, "avx2_fma");
+  iree_uk_test_mmt4d(IREE_UK_FLAG_MMT4D_TYPE_F32F32F32, 1, 16, 1,
+                     "avx512_base");
+  iree_uk_test_mmt4d(IREE_UK_FLAG_MMT4D_TYPE_F32F32F32, 2, 16, 1,
+                     "avx512_base");
+  iree_uk_test_mmt4d(IREE_UK_FLAG_MMT4D_TYPE_F32F32F32, 4, 16, 1,
+                     "avx512_base");
+  iree_uk_test_mmt4d(IREE_UK_FLAG_MMT4D_TYPE_F32F32F32, 8, 16, 1,
+                     "avx512_base");
   iree_uk_test_mmt4d(IREE_UK_FLAG_MMT4D_TYPE_F32F32F32, 16, 16, 1,
                      "avx512_base");
   iree_uk_test_mmt4d(IREE_UK_FLAG_MMT4D_TYPE_F16F16F32, 8, 8, 1, "avx2_fma");
@@ -402,6 +667,10 @@ int main(int argc, char** argv) {
   iree_uk_test_mmt4d(IREE_UK_FLAG_MMT4D_TYPE_I8I8I32, 8, 8, 2, "avx2_fma");
   iree_uk_test_mmt4d(IREE_UK_FLAG_MMT4D_TYPE_I8I8I32, 16, 16, 2, "avx512_base");
   iree_uk_test_mmt4d(IREE_UK_FLAG_MMT4D_TYPE_I8I8I32, 16, 16, 2, "avx512_vnni");
+  iree_uk_test_mmt4d(IREE_UK_FLAG_MMT4D_TYPE_F32I4F32, 8, 8, 1, "avx2_fma");
+  iree_uk_test_mmt4d(IREE_UK_FLAG_MMT4D_TYPE_F32I8F32, 8, 8, 1, "avx2_fma");
+  iree_uk_test_mmt4d(IREE_UK_FLAG_MMT4D_TYPE_F16I4F32, 8, 8, 1, "avx2_fma");
+  iree_uk_test_mmt4d(IREE_UK_FLAG_MMT4D_TYPE_F16I8F32, 8, 8, 1, "avx2_fma");
 #endif  // defined(IREE_ARCH_ARM_64)
 
   return iree_uk_test_exit_status();
@@ -122,8 +122,9 @@ static void iree_uk_benchmark_register_pack(iree_uk_uint32_t flags,
   for (int i = 0; i < IREE_ARRAYSIZE(variants); ++i) {
     pack_variant_t variant = variants[i];
     char name[128];
-    snprintf(name, sizeof name, "pack_%s_tile_%dx%d_%s_wss_%" PRIi64, type_str,
-             tile_size0, tile_size1, variant.label, FLAG_working_set_size);
+    snprintf(name, sizeof name, "pack_%s_tile_%dx%d_%s_pad_%d_wss_%" PRIi64,
+             type_str, tile_size0, tile_size1, variant.label, FLAG_padding_size,
+             FLAG_working_set_size);
     params.flags = flags | variant.flags;
     iree_uk_benchmark_register(name, iree_uk_benchmark_pack, &params,
                                sizeof params, cpu_features);
@@ -147,6 +148,11 @@ int main(int argc, char** argv) {
   iree_uk_benchmark_register_pack(IREE_UK_FLAG_PACK_TYPE_I8I8, 8, 4, "");
   // Tile size selected with cpu feature "i8mm".
   iree_uk_benchmark_register_pack(IREE_UK_FLAG_PACK_TYPE_I8I8, 8, 8, "");
+  iree_uk_benchmark_register_pack(IREE_UK_FLAG_PACK_TYPE_F32F32, 8, 8, "");
+  iree_uk_benchmark_register_pack(IREE_UK_FLAG_PACK_TYPE_I32I32, 8, 8, "");
+  iree_uk_benchmark_register_pack(IREE_UK_FLAG_PACK_TYPE_F16F16, 8, 1, "");
+  iree_uk_benchmark_register_pack(IREE_UK_FLAG_PACK_TYPE_F16F16, 8, 8, "");
+  iree_uk_benchmark_register_pack(IREE_UK_FLAG_PACK_TYPE_BF16BF16, 8, 4, "");
 #elif defined(IREE_ARCH_X86_64)
   iree_uk_benchmark_register_pack(IREE_UK_FLAG_PACK_TYPE_F32F32, 8, 1,
                                   "avx2_fma");
@@ -164,6 +170,16 @@ int main(int argc, char** argv) {
                                   "avx2_fma");
   iree_uk_benchmark_register_pack(IREE_UK_FLAG_PACK_TYPE_I32I32, 16, 16,
                                   "avx512_base");
+  iree_uk_benchmark_register_pack(IREE_UK_FLAG_PACK_TYPE_F16F16, 8, 1,
+                                  "avx2_fma");
+  iree_uk_benchmark_register_pack(IREE_UK_FLAG_PACK_TYPE_F16F16, 16, 1,
+                                  "avx512_base");
+  iree_uk_benchmark_register_pack(IREE_UK_FLAG_PACK_TYPE_F16F16, 8, 8,
+                                  "avx2_fma");
+  iree_uk_benchmark_register_pack(IREE_UK_FLAG_PACK_TYPE_F16F16, 16, 16,
+                                  "avx512_base");
+  iree_uk_benchmark_register_pack(IREE_UK_FLAG_PACK_TYPE_BF16BF16, 16, 1,
+                                  "avx512_base");
 #else   // defined(IREE_ARCH_ARM_64)
   // Architectures on which we do not have any optimized ukernel code.
   // Benchmark some arbitrary tile shape.
@@ -0,0 +1,198 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include <stdio.h>
+
+#include "iree/base/api.h"
+#include "iree/base/internal/flags.h"
+#include "iree/builtins/ukernel/api.h"
+#include "iree/builtins/ukernel/mmt4d_internal.h"
+#include "iree/builtins/ukernel/tools/benchmark.h"
+#include "iree/builtins/ukernel/tools/util.h"
+
+IREE_FLAG(int32_t, lhs_rows, 100,
+          "Number of rows of the unpacked LHS, e.g. the dynamic batch size.");
+IREE_FLAG(int32_t, n_size, 16,
+          "N-dimension of mmt4d ops. The overall number of columns of the "
+          "accumulator is that times the N0 tile size.");
+IREE_FLAG(int32_t, lhs_cols, 1024,
+          "Number of columns of the unpacked LHS, i.e. the accumulation "
+          "depth.");
+
+// Sets up buffers for |params| from the flags. The caller frees the buffers.
+static void iree_uk_benchmark_pack_mmt4d_setup(
+    const iree_uk_benchmark_user_data_t* user_data,
+    iree_uk_pack_mmt4d_params_t* params) {
+  memcpy(params, iree_uk_benchmark_params(user_data), sizeof *params);
+  params->cpu_data = iree_uk_benchmark_cpu_data(user_data);
+  params->lhs_size0 = FLAG_lhs_rows;
+  params->lhs_size1 = FLAG_lhs_cols;
+  params->M = (FLAG_lhs_rows + params->M0 - 1) / params->M0;
+  params->N = FLAG_n_size;
+  params->K = (FLAG_lhs_cols + params->K0 - 1) / params->K0;
+  params->lhs_stride0 = params->lhs_size1;
+  params->rhs_stride0 = params->K * params->N0 * params->K0;
+  params->out_stride0 = params->N * params->M0 * params->N0;
+  iree_uk_mmt4d_type_t mmt4d_type = iree_uk_mmt4d_type(params->flags);
+  iree_uk_type_t lhs_type = iree_uk_mmt4d_lhs_type(mmt4d_type);
+  iree_uk_type_t rhs_type = iree_uk_mmt4d_rhs_type(mmt4d_type);
+  iree_uk_type_t out_type = iree_uk_mmt4d_out_type(mmt4d_type);
+  iree_uk_index_t lhs_buffer_size = iree_uk_2d_buffer_length(
+      lhs_type, params->lhs_size0, params->lhs_stride0);
+  iree_uk_index_t rhs_buffer_size =
+      iree_uk_2d_buffer_length(rhs_type, params->N, params->rhs_stride0);
+  iree_uk_index_t out_buffer_size =
+      iree_uk_2d_buffer_length(out_type, params->M, params->out_stride0);
+  void* lhs_buffer = malloc(lhs_buffer_size);
+  void* rhs_buffer = malloc(rhs_buffer_size);
+  void* out_buffer = malloc(out_buffer_size);
+  iree_uk_random_engine_t* engine = iree_uk_benchmark_random_engine(user_data);
+  iree_uk_write_random_buffer(lhs_buffer, lhs_buffer_size, lhs_type, engine);
+  iree_uk_write_random_buffer(rhs_buffer, rhs_buffer_size, rhs_type, engine);
+  iree_uk_write_random_buffer(out_buffer, out_buffer_size, out_type, engine);
+  params->lhs_buffer = lhs_buffer;
+  params->rhs_buffer = rhs_buffer;
+  params->out_buffer = out_buffer;
+}
+
+static void iree_uk_benchmark_pack_mmt4d_teardown(
+    const iree_uk_pack_mmt4d_params_t* params) {
+  free((void*)params->lhs_buffer);
+  free((void*)params->rhs_buffer);
+  free(params->out_buffer);
+}
+
+static void iree_uk_benchmark_pack_mmt4d_report(
+    const iree_uk_pack_mmt4d_params_t* params, int64_t total_iterations,
+    iree_benchmark_state_t* benchmark_state) {
+  iree_benchmark_set_items_processed(
+      benchmark_state, total_iterations * 2 * params->M * params->N *
+                           params->K * params->M0 * params->N0 * params->K0);
+}
+
+static iree_status_t iree_uk_benchmark_pack_mmt4d(
+    const iree_benchmark_def_t* benchmark_def,
+    iree_benchmark_state_t* benchmark_state) {
+  iree_uk_pack_mmt4d_params_t params;
+  iree_uk_benchmark_pack_mmt4d_setup(benchmark_def->user_data, &params);
+  int64_t total_iterations = 0;
+  int64_t batch_count = 1;
+  while (iree_benchmark_keep_running(benchmark_state, batch_count)) {
+    for (int i = 0; i < batch_count; ++i) {
+      iree_uk_pack_mmt4d(&params);
+    }
+    total_iterations += batch_count;
+    batch_count *= 2;
+  }
+  iree_uk_benchmark_pack_mmt4d_report(&params, total_iterations,
+                                      benchmark_state);
+  iree_uk_benchmark_pack_mmt4d_teardown(&params);
+  return iree_ok_status();
+}
+
+// The unfused baseline: pack the whole LHS into a temporary, then mmt4d.
+static iree_status_t iree_uk_benchmark_pack_then_mmt4d(
+    const iree_benchmark_def_t* benchmark_def,
+    iree_benchmark_state_t* benchmark_state) {
+  iree_uk_pack_mmt4d_params_t params;
+  iree_uk_benchmark_pack_mmt4d_setup(benchmark_def->user_data, &params);
+  iree_uk_mmt4d_type_t mmt4d_type = iree_uk_mmt4d_type(params.flags);
+  iree_uk_type_t lhs_type = iree_uk_mmt4d_lhs_type(mmt4d_type);
+  iree_uk_index_t packed_lhs_stride0 = params.K * params.M0 * params.K0;
+  void* packed_lhs_buffer = malloc(
+      iree_uk_2d_buffer_length(lhs_type, params.M, packed_lhs_stride0));
+  iree_uk_pack_params_t pack_params = {
+      .in_buffer = params.lhs_buffer,
+      .in_stride0 = params.lhs_stride0,
+      .out_buffer = packed_lhs_buffer,
+      .out_stride0 = packed_lhs_stride0,
+      .in_size0 = params.lhs_size0,
+      .in_size1 = params.lhs_size1,
+      .out_size0 = params.M,
+      .out_size1 = params.K,
+      .out_size2 = params.M0,
+      .out_size3 = params.K0,
+      .flags = lhs_type == IREE_UK_TYPE_INT_8 ? IREE_UK_FLAG_PACK_TYPE_I8I8
+                                              : IREE_UK_FLAG_PACK_TYPE_F32F32,
+      .cpu_data = params.cpu_data,
+  };
+  iree_uk_mmt4d_params_t mmt4d_params = {
+      .lhs_buffer = packed_lhs_buffer,
+      .lhs_stride0 = packed_lhs_stride0,
+      .rhs_buffer = params.rhs_buffer,
+      .rhs_stride0 = params.rhs_stride0,
+      .out_buffer = params.out_buffer,
+      .out_stride0 = params.out_stride0,
+      .M = params.M,
+      .N = params.N,
+      .K = params.K,
+      .M0 = params.M0,
+      .N0 = params.N0,
+      .K0 = params.K0,
+      .flags = params.flags,
+      .cpu_data = params.cpu_data,
+  };
+  int64_t total_iterations = 0;
+  int64_t batch_count = 1;
+  while (iree_benchmark_keep_running(benchmark_state, batch_count)) {
+    for (int i = 0; i < batch_count; ++i) {
+      iree_uk_pack(&pack_params);
+      iree_uk_mmt4d(&mmt4d_params);
+    }
+    total_iterations += batch_count;
+    batch_count *= 2;
+  }
+  iree_uk_benchmark_pack_mmt4d_report(&params, total_iterations,
+                                      benchmark_state);
+  free(packed_lhs_buffer);
+  iree_uk_benchmark_pack_mmt4d_teardown(&params);
+  return iree_ok_status();
+}
+
+static void iree_uk_benchmark_register_pack_mmt4d(iree_uk_uint32_t flags,
+                                                  int M0, int N0, int K0,
+                                                  const char* cpu_features) {
+  char type_str[32];
+  iree_uk_mmt4d_type_t mmt4d_type = iree_uk_mmt4d_type(flags);
+  iree_uk_type_triple_str(type_str, sizeof type_str, mmt4d_type);
+  iree_uk_pack_mmt4d_params_t params = {
+      .flags = flags, .M0 = M0, .N0 = N0, .K0 = K0};
+  char name[128];
+  snprintf(name, sizeof name, "pack_mmt4d_%s_tile_%dx%dx%d", type_str, M0, N0,
+           K0);
+  iree_uk_benchmark_register(name, iree_uk_benchmark_pack_mmt4d, &params,
+                             sizeof params, cpu_features);
+  snprintf(name, sizeof name, "pack_then_mmt4d_%s_tile_%dx%dx%d", type_str, M0,
+           N0, K0);
+  iree_uk_benchmark_register(name, iree_uk_benchmark_pack_then_mmt4d, &params,
+                             sizeof params, cpu_features);
+}
+
+int main(int argc, char** argv) {
+  iree_flags_set_usage("pack_mmt4d_benchmark", "");
+
+  iree_flags_parse_checked(IREE_FLAGS_PARSE_MODE_UNDEFINED_OK, &argc, &argv);
+  iree_uk_benchmark_initialize(&argc, argv);
+
+#if defined(IREE_ARCH_ARM_64)
+  iree_uk_benchmark_register_pack_mmt4d(IREE_UK_FLAG_MMT4D_TYPE_F32F32F32, 8,
+                                        8, 1, "");
+  iree_uk_benchmark_register_pack_mmt4d(IREE_UK_FLAG_MMT4D_TYPE_I8I8I32, 8, 8,
+                                        4, "dotprod");
+#elif defined(IREE_ARCH_X86_64)
+  iree_uk_benchmark_register_pack_mmt4d(IREE_UK_FLAG_MMT4D_TYPE_F32F32F32, 8,
+                                        8, 1, "avx2_fma");
+  iree_uk_benchmark_register_pack_mmt4d(IREE_UK_FLAG_MMT4D_TYPE_F32F32F32, 16,
+                                        16, 1, "avx512_base");
+  iree_uk_benchmark_register_pack_mmt4d(IREE_UK_FLAG_MMT4D_TYPE_I8I8I32, 16,
+                                        16, 2, "avx512_vnni");
+#else   // defined(IREE_ARCH_ARM_64)
+  iree_uk_benchmark_register_pack_mmt4d(IREE_UK_FLAG_MMT4D_TYPE_F32F32F32, 8,
+                                        8, 1, "");
+#endif  // defined(IREE_ARCH_ARM_64)
+
+  iree_uk_benchmark_run_and_cleanup();
+}
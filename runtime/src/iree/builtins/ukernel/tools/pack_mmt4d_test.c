@@ -0,0 +1,227 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/base/api.h"
+#include "iree/builtins/ukernel/api.h"
+#include "iree/builtins/ukernel/mmt4d_internal.h"
+#include "iree/builtins/ukernel/tools/test.h"
+#include "iree/builtins/ukernel/tools/util.h"
+
+// The reference is the unfused sequence: pack the whole LHS into a temporary
+// buffer, then mmt4d. Both sides use the same tile functions and accumulate in
+// the same order, so the results must be bit-exact.
+static void iree_pack_mmt4d_reference(
+    const iree_uk_pack_mmt4d_params_t* params) {
+  iree_uk_mmt4d_type_t mmt4d_type = iree_uk_mmt4d_type(params->flags);
+  iree_uk_type_t lhs_type = iree_uk_mmt4d_lhs_type(mmt4d_type);
+  iree_uk_uint32_t pack_flags = 0;
+  switch (lhs_type) {
+    case IREE_UK_TYPE_FLOAT_32:
+      pack_flags = IREE_UK_FLAG_PACK_TYPE_F32F32;
+      break;
+    case IREE_UK_TYPE_INT_8:
+      pack_flags = IREE_UK_FLAG_PACK_TYPE_I8I8;
+      break;
+    case IREE_UK_TYPE_FLOAT_16:
+      pack_flags = IREE_UK_FLAG_PACK_TYPE_F16F16;
+      break;
+    case IREE_UK_TYPE_BFLOAT_16:
+      pack_flags = IREE_UK_FLAG_PACK_TYPE_BF16BF16;
+      break;
+    default:
+      IREE_UK_ASSERT(false && "unhandled LHS type");
+  }
+  iree_uk_index_t packed_lhs_stride0 = params->K * params->M0 * params->K0;
+  void* packed_lhs_buffer = malloc(iree_uk_2d_buffer_length(
+      lhs_type, iree_max(1, params->M), packed_lhs_stride0));
+  iree_uk_pack_params_t pack_params = {
+      .in_buffer = params->lhs_buffer,
+      .in_offset = params->lhs_offset,
+      .in_stride0 = params->lhs_stride0,
+      .out_buffer = packed_lhs_buffer,
+      .out_offset = 0,
+      .out_stride0 = packed_lhs_stride0,
+      .in_size0 = params->lhs_size0,
+      .in_size1 = params->lhs_size1,
+      .out_size0 = params->M,
+      .out_size1 = params->K,
+      .out_size2 = params->M0,
+      .out_size3 = params->K0,
+      .padding_value = 0,
+      .flags = pack_flags,
+      .cpu_data = params->cpu_data,
+  };
+  iree_uk_pack(&pack_params);
+  iree_uk_mmt4d_params_t mmt4d_params = {
+      .lhs_buffer = packed_lhs_buffer,
+      .lhs_offset = 0,
+      .lhs_stride0 = packed_lhs_stride0,
+      .rhs_buffer = params->rhs_buffer,
+      .rhs_offset = params->rhs_offset,
+      .rhs_stride0 = params->rhs_stride0,
+      .out_buffer = params->out_buffer,
+      .out_offset = params->out_offset,
+      .out_stride0 = params->out_stride0,
+      .M = params->M,
+      .N = params->N,
+      .K = params->K,
+      .M0 = params->M0,
+      .N0 = params->N0,
+      .K0 = params->K0,
+      .flags = params->flags,
+      .cpu_data = params->cpu_data,
+  };
+  iree_uk_mmt4d(&mmt4d_params);
+  free(packed_lhs_buffer);
+}
+
+static void iree_uk_test_pack_mmt4d_for_shape_params(
+    iree_uk_test_t* test, const iree_uk_pack_mmt4d_params_t* src_params) {
+  iree_uk_pack_mmt4d_params_t params;
+  memcpy(&params, src_params, sizeof params);
+  // Populate strides first - we need them below to compute buffer lengths.
+  // Randomly make strides either tight or not to exercise all cases.
+  iree_uk_random_engine_t* engine = iree_uk_test_random_engine(test);
+  params.lhs_stride0 =
+      params.lhs_size1 + iree_uk_random_engine_get_0_1(engine);
+  params.rhs_stride0 =
+      params.K * params.N0 * params.K0 + iree_uk_random_engine_get_0_1(engine);
+  params.out_stride0 =
+      params.N * params.M0 * params.N0 + iree_uk_random_engine_get_0_1(engine);
+  iree_uk_mmt4d_type_t mmt4d_type = iree_uk_mmt4d_type(params.flags);
+  iree_uk_type_t lhs_type = iree_uk_mmt4d_lhs_type(mmt4d_type);
+  iree_uk_type_t rhs_type = iree_uk_mmt4d_rhs_type(mmt4d_type);
+  iree_uk_type_t out_type = iree_uk_mmt4d_out_type(mmt4d_type);
+  iree_uk_index_t lhs_buffer_size =
+      iree_uk_2d_buffer_length(lhs_type, params.lhs_size0, params.lhs_stride0);
+  iree_uk_index_t rhs_buffer_size =
+      iree_uk_2d_buffer_length(rhs_type, params.N, params.rhs_stride0);
+  void* lhs_buffer = malloc(lhs_buffer_size);
+  void* rhs_buffer = malloc(rhs_buffer_size);
+  iree_uk_write_random_buffer(lhs_buffer, lhs_buffer_size, lhs_type, engine);
+  iree_uk_write_random_buffer(rhs_buffer, rhs_buffer_size, rhs_type, engine);
+  params.lhs_offset = iree_uk_random_engine_get_0_65535(engine);
+  params.rhs_offset = iree_uk_random_engine_get_0_65535(engine);
+  params.out_offset = iree_uk_random_engine_get_0_65535(engine);
+  params.lhs_buffer = (const char*)lhs_buffer -
+                      (params.lhs_offset * iree_uk_type_size(lhs_type));
+  params.rhs_buffer = (const char*)rhs_buffer -
+                      (params.rhs_offset * iree_uk_type_size(rhs_type));
+
+  iree_uk_pack_mmt4d_params_t reference_params;
+  memcpy(&reference_params, &params, sizeof params);
+  iree_uk_index_t out_buffer_size =
+      iree_uk_2d_buffer_length(out_type, params.M, params.out_stride0);
+  void* init_out_buffer = malloc(out_buffer_size);
+  iree_uk_write_random_buffer(init_out_buffer, out_buffer_size, out_type,
+                              engine);
+  void* reference_out_buffer = malloc(out_buffer_size);
+  memcpy(reference_out_buffer, init_out_buffer, out_buffer_size);
+  reference_params.out_buffer =
+      (char*)reference_out_buffer -
+      (params.out_offset * iree_uk_type_size(out_type));
+
+  iree_uk_pack_mmt4d_params_t actual_params;
+  memcpy(&actual_params, &params, sizeof params);
+  void* actual_out_buffer = malloc(out_buffer_size);
+  memcpy(actual_out_buffer, init_out_buffer, out_buffer_size);
+  actual_params.out_buffer = (char*)actual_out_buffer -
+                             (params.out_offset * iree_uk_type_size(out_type));
+
+  iree_pack_mmt4d_reference(&reference_params);
+  iree_uk_pack_mmt4d(&actual_params);
+
+  if (memcmp(actual_out_buffer, reference_out_buffer, out_buffer_size)) {
+    IREE_UK_TEST_FAIL(test);
+  }
+
+  free(init_out_buffer);
+  free(reference_out_buffer);
+  free(actual_out_buffer);
+  free(lhs_buffer);
+  free(rhs_buffer);
+}
+
+static void iree_uk_test_pack_mmt4d_for_tile_params(iree_uk_test_t* test,
+                                                    const void* src_params) {
+  typedef struct shape_t {
+    int lhs_size0, lhs_size1, n;
+  } shape_t;
+  const shape_t shapes[] = {
+      // Degenerate cases. Vacuous, or zeroing the output buffer when K==0 and
+      // flags do not have ACCUMULATE.
+      {0, 5, 3},
+      {5, 7, 0},
+      {5, 0, 3},
+      // Non-degenerate cases, with and without padding.
+      {1, 1, 1},
+      {2, 3, 2},
+      {17, 19, 5},
+      {33, 64, 3},
+      // Large enough for the packed LHS rows to be processed in several chunks.
+      {9, 1000, 3},
+      {20, 4099, 2},
+  };
+  for (int i = 0; i < IREE_ARRAYSIZE(shapes); ++i) {
+    iree_uk_pack_mmt4d_params_t params;
+    memcpy(&params, src_params, sizeof params);
+    params.cpu_data = iree_uk_test_cpu_data(test);
+    shape_t shape = shapes[i];
+    params.lhs_size0 = shape.lhs_size0;
+    params.lhs_size1 = shape.lhs_size1;
+    params.M = (shape.lhs_size0 + params.M0 - 1) / params.M0;
+    params.K = (shape.lhs_size1 + params.K0 - 1) / params.K0;
+    params.N = shape.n;
+    for (int accumulate = 0; accumulate <= 1; ++accumulate) {
+      if (accumulate) params.flags |= IREE_UK_FLAG_MMT4D_ACCUMULATE;
+      iree_uk_test_pack_mmt4d_for_shape_params(test, &params);
+      // Chunking along K must not introduce any rounding of the accumulator
+      // that the unfused mmt4d skips.
+      params.flags |= IREE_UK_FLAG_MMT4D_SKIP_INTERMEDIATE_ROUNDINGS;
+      iree_uk_test_pack_mmt4d_for_shape_params(test, &params);
+      params.flags &= ~IREE_UK_FLAG_MMT4D_SKIP_INTERMEDIATE_ROUNDINGS;
+    }
+  }
+}
+
+static void iree_uk_test_pack_mmt4d(iree_uk_uint32_t flags, int M0, int N0,
+                                    int K0, const char* cpu_features) {
+  char types_str[32];
+  iree_uk_mmt4d_type_t mmt4d_type = iree_uk_mmt4d_type(flags);
+  iree_uk_type_triple_str(types_str, sizeof types_str, mmt4d_type);
+  iree_uk_pack_mmt4d_params_t params = {
+      .flags = flags, .M0 = M0, .N0 = N0, .K0 = K0};
+  char test_label_str[256];
+  snprintf(test_label_str, sizeof test_label_str, "types:%s tile:%dx%dx%d",
+           types_str, M0, N0, K0);
+  iree_uk_test(test_label_str, iree_uk_test_pack_mmt4d_for_tile_params,
+               &params, cpu_features);
+}
+
+int main(int argc, char** argv) {
+  // Generic tests, not matching any particular CPU feature, with weird tile
+  // sizes.
+  iree_uk_test_pack_mmt4d(IREE_UK_FLAG_MMT4D_TYPE_F32F32F32, 3, 5, 7, "");
+  iree_uk_test_pack_mmt4d(IREE_UK_FLAG_MMT4D_TYPE_I8I8I32, 9, 6, 3, "");
+  iree_uk_test_pack_mmt4d(IREE_UK_FLAG_MMT4D_TYPE_F16F16F32, 4, 6, 5, "");
+  iree_uk_test_pack_mmt4d(IREE_UK_FLAG_MMT4D_TYPE_BF16BF16F32, 11, 4, 1, "");
+  iree_uk_test_pack_mmt4d(IREE_UK_FLAG_MMT4D_TYPE_BF16BF16F32, 3, 5, 8, "");
+
+#if defined(IREE_ARCH_ARM_64)
+  iree_uk_test_pack_mmt4d(IREE_UK_FLAG_MMT4D_TYPE_F32F32F32, 8, 8, 1, "");
+  iree_uk_test_pack_mmt4d(IREE_UK_FLAG_MMT4D_TYPE_I8I8I32, 8, 8, 4,
+                          "dotprod");
+#elif defined(IREE_ARCH_X86_64)
+  iree_uk_test_pack_mmt4d(IREE_UK_FLAG_MMT4D_TYPE_F32F32F32, 8, 8, 1,
+                          "avx2_fma");
+  iree_uk_test_pack_mmt4d(IREE_UK_FLAG_MMT4D_TYPE_F32F32F32, 16, 16, 1,
+                          "avx512_base");
+  iree_uk_test_pack_mmt4d(IREE_UK_FLAG_MMT4D_TYPE_I8I8I32, 16, 16, 2,
+                          "avx512_base");
+#endif  // defined(IREE_ARCH_ARM_64)
+
+  return iree_uk_test_exit_status();
+}
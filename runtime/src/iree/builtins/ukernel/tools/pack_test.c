@@ -221,15 +221,28 @@ int main(int argc, char** argv) {
   iree_uk_test_pack(IREE_UK_FLAG_PACK_TYPE_I8I8, 8, 4, "");
   // Tile size selected for CPU feature i8mm. Same comment as for dotprod.
   iree_uk_test_pack(IREE_UK_FLAG_PACK_TYPE_I8I8, 8, 8, "");
+  // 16-bit types, using the f16 and bf16 mmt4d tile sizes.
+  iree_uk_test_pack(IREE_UK_FLAG_PACK_TYPE_F16F16, 8, 1, "");
+  iree_uk_test_pack(IREE_UK_FLAG_PACK_TYPE_F16F16, 8, 8, "");
+  iree_uk_test_pack(IREE_UK_FLAG_PACK_TYPE_BF16BF16, 8, 4, "");
+  iree_uk_test_pack(IREE_UK_FLAG_PACK_TYPE_BF16BF16, 8, 8, "");
 #elif defined(IREE_ARCH_X86_64)
   iree_uk_test_pack(IREE_UK_FLAG_PACK_TYPE_F32F32, 8, 1, "avx2_fma");
   iree_uk_test_pack(IREE_UK_FLAG_PACK_TYPE_I8I8, 8, 2, "avx2_fma");
   iree_uk_test_pack(IREE_UK_FLAG_PACK_TYPE_F32F32, 8, 8, "avx2_fma");
   iree_uk_test_pack(IREE_UK_FLAG_PACK_TYPE_I32I32, 8, 8, "avx2_fma");
+  iree_uk_test_pack(IREE_UK_FLAG_PACK_TYPE_F16F16, 8, 1, "avx2_fma");
+  iree_uk_test_pack(IREE_UK_FLAG_PACK_TYPE_F16F16, 8, 8, "avx2_fma");
+  iree_uk_test_pack(IREE_UK_FLAG_PACK_TYPE_BF16BF16, 8, 1, "avx2_fma");
+  iree_uk_test_pack(IREE_UK_FLAG_PACK_TYPE_BF16BF16, 8, 8, "avx2_fma");
   iree_uk_test_pack(IREE_UK_FLAG_PACK_TYPE_F32F32, 16, 1, "avx512_base");
   iree_uk_test_pack(IREE_UK_FLAG_PACK_TYPE_I8I8, 16, 2, "avx512_base");
   iree_uk_test_pack(IREE_UK_FLAG_PACK_TYPE_F32F32, 16, 16, "avx512_base");
   iree_uk_test_pack(IREE_UK_FLAG_PACK_TYPE_I32I32, 16, 16, "avx512_base");
+  iree_uk_test_pack(IREE_UK_FLAG_PACK_TYPE_F16F16, 16, 1, "avx512_base");
+  iree_uk_test_pack(IREE_UK_FLAG_PACK_TYPE_F16F16, 16, 16, "avx512_base");
+  iree_uk_test_pack(IREE_UK_FLAG_PACK_TYPE_BF16BF16, 16, 1, "avx512_base");
+  iree_uk_test_pack(IREE_UK_FLAG_PACK_TYPE_BF16BF16, 16, 16, "avx512_base");
   // avx512_vnni uses the same tile size and same pack code as avx512_base.
 #endif  // defined(IREE_ARCH_ARM_64)
 
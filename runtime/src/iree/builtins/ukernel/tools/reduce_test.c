@@ -0,0 +1,161 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include <math.h>
+
+#include "iree/base/api.h"
+#include "iree/builtins/ukernel/api.h"
+#include "iree/builtins/ukernel/reduce_internal.h"
+#include "iree/builtins/ukernel/tools/test.h"
+#include "iree/builtins/ukernel/tools/util.h"
+
+static void iree_reduce_reference(const iree_uk_reduce_params_t* params) {
+  bool max = (params->flags & IREE_UK_FLAG_REDUCE_OP_MASK) ==
+             IREE_UK_FLAG_REDUCE_OP_MAX;
+  for (iree_uk_index_t i = 0; i < params->size0; ++i) {
+    const float* in = (const float*)params->in_buffer + params->in_offset +
+                      i * params->in_stride0;
+    float* out = (float*)params->out_buffer + params->out_offset +
+                 i * params->out_stride0;
+    double acc = max ? -INFINITY : 0;
+    if (params->flags & IREE_UK_FLAG_REDUCE_ACCUMULATE) acc = *out;
+    for (iree_uk_index_t j = 0; j < params->size1; ++j) {
+      // Like arith.maxf, the max propagates NaNs.
+      acc = max ? ((in[j] > acc || isnan(in[j])) ? in[j] : acc) : acc + in[j];
+    }
+    *out = (float)acc;
+  }
+}
+
+static void iree_uk_test_reduce_for_shape_params(
+    iree_uk_test_t* test, const iree_uk_reduce_params_t* src_params,
+    bool with_nans) {
+  iree_uk_reduce_params_t params;
+  memcpy(&params, src_params, sizeof params);
+  // Randomly make strides either tight or not to exercise all cases.
+  iree_uk_random_engine_t* engine = iree_uk_test_random_engine(test);
+  params.in_stride0 = params.size1 + iree_uk_random_engine_get_0_1(engine);
+  params.out_stride0 = 1 + iree_uk_random_engine_get_0_1(engine);
+  iree_uk_type_t type = IREE_UK_TYPE_FLOAT_32;
+  iree_uk_index_t in_buffer_size =
+      iree_uk_2d_buffer_length(type, params.size0, params.in_stride0);
+  float* in_buffer = malloc(in_buffer_size);
+  iree_uk_write_random_buffer(in_buffer, in_buffer_size, type, engine);
+  if (with_nans) {
+    // One NaN at a random position in every other row, so that both the vector
+    // loops and the remainders see NaNs.
+    for (iree_uk_index_t i = 0; i < params.size0 && params.size1; i += 2) {
+      iree_uk_index_t j =
+          iree_uk_random_engine_get_0_65535(engine) % params.size1;
+      in_buffer[i * params.in_stride0 + j] = NAN;
+    }
+  }
+  params.in_offset = iree_uk_random_engine_get_0_65535(engine);
+  params.in_buffer = in_buffer - params.in_offset;
+  params.out_offset = iree_uk_random_engine_get_0_65535(engine);
+  // View the 1D output as a size0 x 1 matrix for buffer helpers.
+  iree_uk_index_t out_buffer_size =
+      iree_uk_2d_buffer_length(type, params.size0, params.out_stride0);
+
+  iree_uk_reduce_params_t reference_params;
+  memcpy(&reference_params, &params, sizeof reference_params);
+  float* reference_out_buffer = malloc(out_buffer_size);
+  iree_uk_write_random_buffer(reference_out_buffer, out_buffer_size, type,
+                              engine);
+  reference_params.out_buffer = reference_out_buffer - params.out_offset;
+
+  iree_uk_reduce_params_t actual_params;
+  memcpy(&actual_params, &params, sizeof actual_params);
+  float* actual_out_buffer = malloc(out_buffer_size);
+  memcpy(actual_out_buffer, reference_out_buffer, out_buffer_size);
+  actual_params.out_buffer = actual_out_buffer - params.out_offset;
+
+  iree_reduce_reference(&reference_params);
+  iree_uk_reduce(&actual_params);
+
+  // Test inputs are small integers, so sums are exact in any order. A zero
+  // tolerance still lets NaNs compare equal.
+  if (!iree_uk_2d_f32_buffers_close(actual_out_buffer, reference_out_buffer,
+                                    params.size0, 1, params.out_stride0,
+                                    0.0f)) {
+    IREE_UK_TEST_FAIL(test);
+  }
+
+  free(reference_out_buffer);
+  free(actual_out_buffer);
+  free(in_buffer);
+}
+
+static void iree_uk_test_reduce_for_flags(iree_uk_test_t* test,
+                                          const void* src_params) {
+  typedef struct shape_t {
+    int size0, size1;
+  } shape_t;
+  const shape_t shapes[] = {
+      // Degenerate cases. Rows with size1 == 0 still write the identity.
+      {0, 1},
+      {3, 0},
+      // Non-degenerate cases, with row lengths hitting all the vector loop
+      // remainder cases.
+      {1, 1},
+      {2, 3},
+      {3, 7},
+      {3, 8},
+      {4, 15},
+      {4, 16},
+      {5, 17},
+      {2, 33},
+      {3, 64},
+      {2, 100},
+      {2, 1000},
+  };
+  for (int i = 0; i < IREE_ARRAYSIZE(shapes); ++i) {
+    for (int accumulate = 0; accumulate <= 1; ++accumulate) {
+      iree_uk_reduce_params_t params;
+      memcpy(&params, src_params, sizeof params);
+      params.cpu_data = iree_uk_test_cpu_data(test);
+      params.size0 = shapes[i].size0;
+      params.size1 = shapes[i].size1;
+      if (accumulate) params.flags |= IREE_UK_FLAG_REDUCE_ACCUMULATE;
+      iree_uk_test_reduce_for_shape_params(test, &params, /*with_nans=*/false);
+      iree_uk_test_reduce_for_shape_params(test, &params, /*with_nans=*/true);
+    }
+  }
+}
+
+static void iree_uk_test_reduce(iree_uk_uint32_t flags,
+                                const char* cpu_features) {
+  iree_uk_reduce_params_t params = {.flags = flags};
+  char types_str[32];
+  iree_uk_reduce_type_t reduce_type = iree_uk_reduce_type(flags);
+  iree_uk_type_pair_str(types_str, sizeof types_str, reduce_type);
+  bool max =
+      (flags & IREE_UK_FLAG_REDUCE_OP_MASK) == IREE_UK_FLAG_REDUCE_OP_MAX;
+  char test_label_str[256];
+  snprintf(test_label_str, sizeof test_label_str, "types:%s op:%s", types_str,
+           max ? "max" : "sum");
+  iree_uk_test(test_label_str, iree_uk_test_reduce_for_flags, &params,
+               cpu_features);
+}
+
+int main(int argc, char** argv) {
+  const iree_uk_uint32_t f32 = IREE_UK_FLAG_REDUCE_TYPE_F32F32;
+  const iree_uk_uint32_t sum = IREE_UK_FLAG_REDUCE_OP_SUM;
+  const iree_uk_uint32_t max = IREE_UK_FLAG_REDUCE_OP_MAX;
+  iree_uk_test_reduce(f32 | sum, "");
+  iree_uk_test_reduce(f32 | max, "");
+
+  // On arm64, the tests above already exercise the NEON tile functions: NEON
+  // is part of the baseline ISA, so they are selected without CPU features.
+#if defined(IREE_ARCH_X86_64)
+  iree_uk_test_reduce(f32 | sum, "avx2_fma");
+  iree_uk_test_reduce(f32 | max, "avx2_fma");
+  iree_uk_test_reduce(f32 | sum, "avx512_base");
+  iree_uk_test_reduce(f32 | max, "avx512_base");
+#endif  // defined(IREE_ARCH_X86_64)
+
+  return iree_uk_test_exit_status();
+}
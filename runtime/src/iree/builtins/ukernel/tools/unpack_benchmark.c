@@ -121,8 +121,8 @@ static void iree_uk_benchmark_register_unpack(iree_uk_uint32_t flags,
   for (int i = 0; i < IREE_ARRAYSIZE(variants); ++i) {
     unpack_variant_t variant = variants[i];
     char name[128];
-    snprintf(name, sizeof name, "unpack_%s_tile_%dx%d_%s_wss_%" PRIi64,
-             type_str, tile_size0, tile_size1, variant.label,
+    snprintf(name, sizeof name, "unpack_%s_tile_%dx%d_%s_pad_%d_wss_%" PRIi64,
+             type_str, tile_size0, tile_size1, variant.label, FLAG_padding_size,
              FLAG_working_set_size);
     params.flags = flags | variant.flags;
     iree_uk_benchmark_register(name, iree_uk_benchmark_unpack, &params,
@@ -143,6 +143,7 @@ int main(int argc, char** argv) {
 #if defined(IREE_ARCH_ARM_64)
   iree_uk_benchmark_register_unpack(IREE_UK_FLAG_UNPACK_TYPE_F32F32, 8, 8, "");
   iree_uk_benchmark_register_unpack(IREE_UK_FLAG_UNPACK_TYPE_I32I32, 8, 8, "");
+  iree_uk_benchmark_register_unpack(IREE_UK_FLAG_UNPACK_TYPE_F16F16, 8, 8, "");
 #elif defined(IREE_ARCH_X86_64)
   iree_uk_benchmark_register_unpack(IREE_UK_FLAG_UNPACK_TYPE_F32F32, 8, 8,
                                     "avx2_fma");
@@ -152,6 +153,10 @@ int main(int argc, char** argv) {
                                     "avx512_base");
   iree_uk_benchmark_register_unpack(IREE_UK_FLAG_UNPACK_TYPE_I32I32, 16, 16,
                                     "avx512_base");
+  iree_uk_benchmark_register_unpack(IREE_UK_FLAG_UNPACK_TYPE_F16F16, 8, 8,
+                                    "avx2_fma");
+  iree_uk_benchmark_register_unpack(IREE_UK_FLAG_UNPACK_TYPE_F16F16, 16, 16,
+                                    "avx512_base");
 #else   // defined(IREE_ARCH_ARM_64)
   // Architectures on which we do not have any optimized ukernel code.
   // Benchmark some arbitrary tile shape.
@@ -34,7 +34,7 @@ iree_uk_index_t iree_uk_2d_buffer_length(iree_uk_type_t type,
                                          iree_uk_index_t size0,
                                          iree_uk_index_t stride0) {
   // Just for testing purposes, so it's OK to overestimate size.
-  return size0 * stride0 << iree_uk_type_size_log2(type);
+  return ((size0 * stride0 << iree_uk_type_bit_count_log2(type)) + 7) >> 3;
 }
 
 bool iree_uk_2d_buffers_equal(const void* buf1, const void* buf2,
@@ -51,6 +51,23 @@ bool iree_uk_2d_buffers_equal(const void* buf1, const void* buf2,
   return true;
 }
 
+bool iree_uk_2d_f32_buffers_close(const float* buf1, const float* buf2,
+                                  iree_uk_index_t size0, iree_uk_index_t size1,
+                                  iree_uk_index_t stride0, float tolerance) {
+  for (iree_uk_index_t i0 = 0; i0 < size0; ++i0) {
+    for (iree_uk_index_t i1 = 0; i1 < size1; ++i1) {
+      float x = buf1[i0 * stride0 + i1];
+      float y = buf2[i0 * stride0 + i1];
+      float abs_y = y < 0 ? -y : y;
+      if (x == y || (x != x && y != y)) continue;
+      float diff = x < y ? y - x : x - y;
+      // Written so that NaN in only one buffer compares as not close.
+      if (!(diff <= tolerance * (1.0f + abs_y))) return false;
+    }
+  }
+  return true;
+}
+
 // Parameter for locally defined lcg similar to std::minstd_rand.
 #define IREE_PRNG_MULTIPLIER 48271
 #define IREE_PRNG_MODULUS 2147483647
@@ -86,6 +103,14 @@ int iree_uk_random_engine_get_minus16_plus15(iree_uk_random_engine_t* e) {
 void iree_uk_write_random_buffer(void* buffer, iree_uk_index_t size_in_bytes,
                                  iree_uk_type_t type,
                                  iree_uk_random_engine_t* engine) {
+  if (type == IREE_UK_TYPE_INT_4) {
+    // Sub-byte type: any random byte is a pair of valid int4 values, and int4
+    // values are already small enough to keep float arithmetic exact.
+    for (iree_uk_index_t i = 0; i < size_in_bytes; ++i) {
+      ((uint8_t*)buffer)[i] = iree_uk_random_engine_get_0_65535(engine);
+    }
+    return;
+  }
   iree_uk_index_t elem_size = iree_uk_type_size(type);
   iree_uk_index_t size_in_elems = size_in_bytes / elem_size;
   for (iree_uk_index_t i = 0; i < size_in_elems; ++i) {
@@ -18,6 +18,14 @@ bool iree_uk_2d_buffers_equal(const void* buf1, const void* buf2,
                               iree_uk_type_t type, iree_uk_index_t size0,
                               iree_uk_index_t size1, iree_uk_index_t stride0);
 
+// Like iree_uk_2d_buffers_equal but for f32 buffers, treating elements as equal
+// when |x - y| <= tolerance * (1 + |y|) or when both are NaN. Used to test
+// ukernels that use fast approximations or reassociate floating-point
+// reductions.
+bool iree_uk_2d_f32_buffers_close(const float* buf1, const float* buf2,
+                                  iree_uk_index_t size0, iree_uk_index_t size1,
+                                  iree_uk_index_t stride0, float tolerance);
+
 // Simple deterministic pseudorandom generator. Same as C++'s std::minstd_rand.
 typedef struct iree_uk_random_engine_t {
   iree_uk_uint32_t state;
@@ -18,6 +18,7 @@
 #include "iree/hal/local/inline_command_buffer.h"
 #include "iree/hal/local/local_executable_cache.h"
 #include "iree/hal/local/local_pipeline_layout.h"
+#include "iree/hal/local/local_profiler.h"
 #include "iree/hal/utils/buffer_transfer.h"
 #include "iree/hal/utils/deferred_command_buffer.h"
 #include "iree/hal/utils/file_transfer.h"
@@ -33,6 +34,9 @@ typedef struct iree_hal_sync_device_t {
   // Optional provider used for creating/configuring collective channels.
   iree_hal_channel_provider_t* channel_provider;
 
+  // Profiler shared with all command buffers created from the device.
+  iree_hal_local_profiler_t* profiler;
+
   // Block pool used for command buffers with a larger block size (as command
   // buffers can contain inlined data uploads).
   iree_arena_block_pool_t large_block_pool;
@@ -109,6 +113,10 @@ iree_status_t iree_hal_sync_device_create(
     }
 
     iree_hal_sync_semaphore_state_initialize(&device->semaphore_state);
+
+    // All work runs on the calling thread as worker 0.
+    status = iree_hal_local_profiler_create(/*worker_count=*/1, host_allocator,
+                                            &device->profiler);
   }
 
   if (iree_status_is_ok(status)) {
@@ -133,6 +141,7 @@ static void iree_hal_sync_device_destroy(iree_hal_device_t* base_device) {
 
   iree_hal_allocator_release(device->device_allocator);
   iree_hal_channel_provider_release(device->channel_provider);
+  iree_hal_local_profiler_release(device->profiler);
 
   iree_arena_block_pool_deinitialize(&device->large_block_pool);
 
@@ -225,13 +234,14 @@ static iree_status_t iree_hal_sync_device_create_command_buffer(
     iree_hal_command_category_t command_categories,
     iree_hal_queue_affinity_t queue_affinity, iree_host_size_t binding_capacity,
     iree_hal_command_buffer_t** out_command_buffer) {
+  iree_hal_sync_device_t* device = iree_hal_sync_device_cast(base_device);
   if (iree_all_bits_set(mode,
                         IREE_HAL_COMMAND_BUFFER_MODE_ALLOW_INLINE_EXECUTION)) {
     return iree_hal_inline_command_buffer_create(
         base_device, mode, command_categories, queue_affinity, binding_capacity,
-        iree_hal_device_host_allocator(base_device), out_command_buffer);
+        device->profiler, iree_hal_device_host_allocator(base_device),
+        out_command_buffer);
   } else {
-    iree_hal_sync_device_t* device = iree_hal_sync_device_cast(base_device);
     return iree_hal_deferred_command_buffer_create(
         base_device, mode, command_categories, binding_capacity,
         &device->large_block_pool, device->host_allocator, out_command_buffer);
@@ -260,8 +270,9 @@ static iree_status_t iree_hal_sync_device_create_executable_cache(
     iree_loop_t loop, iree_hal_executable_cache_t** out_executable_cache) {
   iree_hal_sync_device_t* device = iree_hal_sync_device_cast(base_device);
   return iree_hal_local_executable_cache_create(
-      identifier, /*worker_capacity=*/1, device->loader_count, device->loaders,
-      iree_hal_device_host_allocator(base_device), out_executable_cache);
+      identifier, loop, /*worker_capacity=*/1, device->loader_count,
+      device->loaders, iree_hal_device_host_allocator(base_device),
+      out_executable_cache);
 }
 
 static iree_status_t iree_hal_sync_device_import_file(
@@ -364,8 +375,8 @@ static iree_status_t iree_hal_sync_device_apply_deferred_command_buffers(
           iree_hal_command_buffer_mode(command_buffer) |
               IREE_HAL_COMMAND_BUFFER_MODE_ALLOW_INLINE_EXECUTION,
           IREE_HAL_COMMAND_CATEGORY_ANY, IREE_HAL_QUEUE_AFFINITY_ANY,
-          /*binding_capacity=*/0, device->host_allocator, storage,
-          &inline_command_buffer));
+          /*binding_capacity=*/0, device->profiler, device->host_allocator,
+          storage, &inline_command_buffer));
       iree_status_t status = iree_hal_deferred_command_buffer_apply(
           command_buffer, inline_command_buffer,
           iree_hal_buffer_binding_table_empty());
@@ -426,6 +437,7 @@ static iree_status_t iree_hal_sync_device_queue_execute(
     iree_host_size_t command_buffer_count,
     iree_hal_command_buffer_t* const* command_buffers) {
   iree_hal_sync_device_t* device = iree_hal_sync_device_cast(base_device);
+  iree_hal_local_profiler_record_submit(device->profiler, command_buffer_count);
 
   // TODO(#4680): there is some better error handling here needed; we should
   // propagate failures to all signal semaphores. Today we aren't as there
@@ -466,27 +478,20 @@ static iree_status_t iree_hal_sync_device_wait_semaphores(
 static iree_status_t iree_hal_sync_device_profiling_begin(
     iree_hal_device_t* base_device,
     const iree_hal_device_profiling_options_t* options) {
-  // Unimplemented (and that's ok).
-  // We could hook in to vendor APIs (Intel/ARM/etc) or generic perf infra:
-  // https://man7.org/linux/man-pages/man2/perf_event_open.2.html
-  // Capturing things like:
-  //   PERF_COUNT_HW_CPU_CYCLES / PERF_COUNT_HW_INSTRUCTIONS
-  //   PERF_COUNT_HW_CACHE_REFERENCES / PERF_COUNT_HW_CACHE_MISSES
-  //   etc
-  // TODO(benvanik): shared iree/hal/local/profiling implementation of this.
-  return iree_ok_status();
+  iree_hal_sync_device_t* device = iree_hal_sync_device_cast(base_device);
+  return iree_hal_local_profiler_begin(device->profiler, options);
 }
 
 static iree_status_t iree_hal_sync_device_profiling_flush(
     iree_hal_device_t* base_device) {
-  // Unimplemented (and that's ok).
-  return iree_ok_status();
+  iree_hal_sync_device_t* device = iree_hal_sync_device_cast(base_device);
+  return iree_hal_local_profiler_flush(device->profiler);
 }
 
 static iree_status_t iree_hal_sync_device_profiling_end(
     iree_hal_device_t* base_device) {
-  // Unimplemented (and that's ok).
-  return iree_ok_status();
+  iree_hal_sync_device_t* device = iree_hal_sync_device_cast(base_device);
+  return iree_hal_local_profiler_end(device->profiler);
 }
 
 static const iree_hal_device_vtable_t iree_hal_sync_device_vtable = {
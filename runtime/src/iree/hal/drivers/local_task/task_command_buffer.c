@@ -16,6 +16,7 @@
 #include "iree/hal/local/executable_library.h"
 #include "iree/hal/local/local_executable.h"
 #include "iree/hal/local/local_pipeline_layout.h"
+#include "iree/hal/local/local_profiler.h"
 #include "iree/hal/utils/resource_set.h"
 #include "iree/task/affinity_set.h"
 #include "iree/task/list.h"
@@ -40,6 +41,11 @@ typedef struct iree_hal_task_command_buffer_t {
 
   iree_task_scope_t* scope;
 
+  // Optional profiler sampling dispatch workgroups while active.
+  iree_hal_local_profiler_t* profiler;
+  // First profiler worker slot of the executor the command buffer runs on.
+  uint32_t profiler_worker_base;
+
   // Arena used for all allocations; references the shared device block pool.
   iree_arena_allocator_t arena;
 
@@ -110,7 +116,8 @@ iree_status_t iree_hal_task_command_buffer_create(
     iree_hal_command_buffer_mode_t mode,
     iree_hal_command_category_t command_categories,
     iree_hal_queue_affinity_t queue_affinity, iree_host_size_t binding_capacity,
-    iree_arena_block_pool_t* block_pool, iree_allocator_t host_allocator,
+    iree_arena_block_pool_t* block_pool, iree_hal_local_profiler_t* profiler,
+    uint32_t profiler_worker_base, iree_allocator_t host_allocator,
     iree_hal_command_buffer_t** out_command_buffer) {
   IREE_ASSERT_ARGUMENT(out_command_buffer);
   *out_command_buffer = NULL;
@@ -145,6 +152,9 @@ iree_status_t iree_hal_task_command_buffer_create(
         &iree_hal_task_command_buffer_vtable, &command_buffer->base);
     command_buffer->host_allocator = host_allocator;
     command_buffer->scope = scope;
+    command_buffer->profiler = profiler;
+    command_buffer->profiler_worker_base = profiler_worker_base;
+    iree_hal_local_profiler_retain(profiler);
     iree_arena_initialize(block_pool, &command_buffer->arena);
     iree_task_list_initialize(&command_buffer->root_tasks);
     iree_task_list_initialize(&command_buffer->leaf_tasks);
@@ -174,6 +184,7 @@ static void iree_hal_task_command_buffer_destroy(
   iree_task_list_discard(&command_buffer->leaf_tasks);
   iree_arena_deinitialize(&command_buffer->arena);
   iree_hal_resource_set_free(command_buffer->resource_set);
+  iree_hal_local_profiler_release(command_buffer->profiler);
   iree_allocator_free(host_allocator, command_buffer);
 
   IREE_TRACE_ZONE_END(z0);
@@ -814,6 +825,11 @@ typedef struct iree_hal_cmd_dispatch_t {
   iree_hal_local_executable_t* executable;
   int32_t ordinal;
 
+  // Profiler of the command buffer, if any. Workgroups are only sampled when
+  // it is active at the time they execute.
+  iree_hal_local_profiler_t* profiler;
+  uint32_t profiler_worker_base;
+
   // Total number of available 4 byte push constant values in |push_constants|.
   uint16_t push_constant_count;
 
@@ -870,14 +886,56 @@ static iree_status_t iree_hal_cmd_dispatch_tile(
           .local_memory = tile_context->local_memory.data,
           .local_memory_size = (size_t)tile_context->local_memory.data_length,
       };
-  iree_status_t status = iree_hal_local_executable_issue_call(
-      cmd->executable, cmd->ordinal, &dispatch_state, &workgroup_state,
-      tile_context->worker_id);
+  iree_status_t status = iree_ok_status();
+  if (iree_hal_local_profiler_is_active(cmd->profiler)) {
+    // Each workgroup is sampled on the worker executing it; the dispatch is
+    // counted once on the worker executing the first workgroup.
+    const uint32_t profiler_worker_id =
+        cmd->profiler_worker_base + tile_context->worker_id;
+    iree_hal_local_profiler_sample_t sample;
+    iree_hal_local_profiler_sample_begin(cmd->profiler, &sample);
+    status = iree_hal_local_executable_issue_call(
+        cmd->executable, cmd->ordinal, &dispatch_state, &workgroup_state,
+        tile_context->worker_id);
+    const bool is_first_workgroup = (workgroup_state.workgroup_id_x |
+                                     workgroup_state.workgroup_id_y |
+                                     workgroup_state.workgroup_id_z) == 0;
+    iree_hal_local_profiler_sample_end(
+        cmd->profiler, profiler_worker_id, cmd->executable, cmd->ordinal,
+        is_first_workgroup ? 1 : 0, /*workgroup_count=*/1,
+        is_first_workgroup
+            ? iree_hal_local_profiler_binding_length(&dispatch_state)
+            : 0,
+        &sample);
+  } else {
+    status = iree_hal_local_executable_issue_call(
+        cmd->executable, cmd->ordinal, &dispatch_state, &workgroup_state,
+        tile_context->worker_id);
+  }
 
   IREE_TRACE_ZONE_END(z0);
   return status;
 }
 
+// Brackets all workgroups a worker runs in a dispatch shard with a hardware
+// counter span so that counters are read once per shard instead of per
+// workgroup.
+static void iree_hal_cmd_dispatch_shard(
+    void* user_context, const iree_task_tile_context_t* tile_context,
+    iree_task_dispatch_shard_event_t event) {
+  const iree_hal_cmd_dispatch_t* cmd =
+      (const iree_hal_cmd_dispatch_t*)user_context;
+  if (!iree_hal_local_profiler_is_active(cmd->profiler)) return;
+  const uint32_t profiler_worker_id =
+      cmd->profiler_worker_base + tile_context->worker_id;
+  if (event == IREE_TASK_DISPATCH_SHARD_EVENT_BEGIN) {
+    iree_hal_local_profiler_counters_begin(cmd->profiler, profiler_worker_id);
+  } else {
+    iree_hal_local_profiler_counters_end(cmd->profiler, profiler_worker_id,
+                                         cmd->executable, cmd->ordinal);
+  }
+}
+
 static iree_status_t iree_hal_task_command_buffer_build_dispatch(
     iree_hal_command_buffer_t* base_command_buffer,
     iree_hal_executable_t* executable, int32_t entry_point,
@@ -888,6 +946,11 @@ static iree_status_t iree_hal_task_command_buffer_build_dispatch(
 
   iree_hal_local_executable_t* local_executable =
       iree_hal_local_executable_cast(executable);
+
+  // Recording needs the dispatch attributes of the prepared executable.
+  // Callers preparing asynchronously must wait on the preparation fence first.
+  IREE_RETURN_IF_ERROR(iree_hal_local_executable_query_ready(local_executable));
+
   if (IREE_UNLIKELY(!local_executable->pipeline_layouts)) {
     return iree_make_status(
         IREE_STATUS_FAILED_PRECONDITION,
@@ -919,6 +982,8 @@ static iree_status_t iree_hal_task_command_buffer_build_dispatch(
 
   cmd->executable = local_executable;
   cmd->ordinal = entry_point;
+  cmd->profiler = command_buffer->profiler;
+  cmd->profiler_worker_base = command_buffer->profiler_worker_base;
   cmd->push_constant_count = push_constant_count;
   cmd->binding_count = used_binding_count;
 
@@ -929,6 +994,7 @@ static iree_status_t iree_hal_task_command_buffer_build_dispatch(
       command_buffer->scope,
       iree_task_make_dispatch_closure(iree_hal_cmd_dispatch_tile, (void*)cmd),
       workgroup_size, workgroup_count, &cmd->task);
+  if (cmd->profiler) cmd->task.shard_fn = iree_hal_cmd_dispatch_shard;
 
   // Tell the task system how much workgroup local memory is required for the
   // dispatch; each invocation of the entry point will have at least as much
@@ -19,6 +19,7 @@
 #include "iree/hal/local/executable_environment.h"
 #include "iree/hal/local/local_executable_cache.h"
 #include "iree/hal/local/local_pipeline_layout.h"
+#include "iree/hal/local/local_profiler.h"
 #include "iree/hal/utils/buffer_transfer.h"
 #include "iree/hal/utils/file_transfer.h"
 #include "iree/hal/utils/memory_file.h"
@@ -43,6 +44,9 @@ typedef struct iree_hal_task_device_t {
   // Optional provider used for creating/configuring collective channels.
   iree_hal_channel_provider_t* channel_provider;
 
+  // Profiler shared with all command buffers created from the device.
+  iree_hal_local_profiler_t* profiler;
+
   iree_host_size_t queue_count;
   iree_hal_task_queue_t queues[];
 } iree_hal_task_device_t;
@@ -138,6 +142,25 @@ iree_status_t iree_hal_task_device_create(
     }
   }
 
+  if (iree_status_is_ok(status)) {
+    // Worker IDs are local to each executor so each distinct executor gets
+    // its own range of profiler worker slots.
+    iree_host_size_t total_worker_count = 0;
+    for (iree_host_size_t i = 0; i < queue_count; ++i) {
+      iree_host_size_t j = 0;
+      while (j < i && queue_executors[j] != queue_executors[i]) ++j;
+      if (j < i) {
+        device->queues[i].profiler_worker_base =
+            device->queues[j].profiler_worker_base;
+        continue;
+      }
+      device->queues[i].profiler_worker_base = (uint32_t)total_worker_count;
+      total_worker_count += iree_task_executor_worker_count(queue_executors[i]);
+    }
+    status = iree_hal_local_profiler_create(total_worker_count, host_allocator,
+                                            &device->profiler);
+  }
+
   if (iree_status_is_ok(status)) {
     *out_device = (iree_hal_device_t*)device;
   } else {
@@ -162,6 +185,7 @@ static void iree_hal_task_device_destroy(iree_hal_device_t* base_device) {
 
   iree_hal_allocator_release(device->device_allocator);
   iree_hal_channel_provider_release(device->channel_provider);
+  iree_hal_local_profiler_release(device->profiler);
 
   iree_arena_block_pool_deinitialize(&device->large_block_pool);
   iree_arena_block_pool_deinitialize(&device->small_block_pool);
@@ -289,6 +313,7 @@ static iree_status_t iree_hal_task_device_create_command_buffer(
   return iree_hal_task_command_buffer_create(
       base_device, &device->queues[queue_index].scope, mode, command_categories,
       queue_affinity, binding_capacity, &device->large_block_pool,
+      device->profiler, device->queues[queue_index].profiler_worker_base,
       device->host_allocator, out_command_buffer);
 }
 
@@ -323,8 +348,9 @@ static iree_status_t iree_hal_task_device_create_executable_cache(
   }
 
   return iree_hal_local_executable_cache_create(
-      identifier, total_worker_count, device->loader_count, device->loaders,
-      iree_hal_device_host_allocator(base_device), out_executable_cache);
+      identifier, loop, total_worker_count, device->loader_count,
+      device->loaders, iree_hal_device_host_allocator(base_device),
+      out_executable_cache);
 }
 
 static iree_status_t iree_hal_task_device_import_file(
@@ -464,6 +490,7 @@ static iree_status_t iree_hal_task_device_queue_execute(
       .command_buffer_count = command_buffer_count,
       .command_buffers = command_buffers,
   };
+  iree_hal_local_profiler_record_submit(device->profiler, command_buffer_count);
   return iree_hal_task_queue_submit(&device->queues[queue_index], 1, &batch);
 }
 
@@ -486,27 +513,20 @@ static iree_status_t iree_hal_task_device_wait_semaphores(
 static iree_status_t iree_hal_task_device_profiling_begin(
     iree_hal_device_t* base_device,
     const iree_hal_device_profiling_options_t* options) {
-  // Unimplemented (and that's ok).
-  // We could hook in to vendor APIs (Intel/ARM/etc) or generic perf infra:
-  // https://man7.org/linux/man-pages/man2/perf_event_open.2.html
-  // Capturing things like:
-  //   PERF_COUNT_HW_CPU_CYCLES / PERF_COUNT_HW_INSTRUCTIONS
-  //   PERF_COUNT_HW_CACHE_REFERENCES / PERF_COUNT_HW_CACHE_MISSES
-  //   etc
-  // TODO(benvanik): shared iree/hal/local/profiling implementation of this.
-  return iree_ok_status();
+  iree_hal_task_device_t* device = iree_hal_task_device_cast(base_device);
+  return iree_hal_local_profiler_begin(device->profiler, options);
 }
 
 static iree_status_t iree_hal_task_device_profiling_flush(
     iree_hal_device_t* base_device) {
-  // Unimplemented (and that's ok).
-  return iree_ok_status();
+  iree_hal_task_device_t* device = iree_hal_task_device_cast(base_device);
+  return iree_hal_local_profiler_flush(device->profiler);
 }
 
 static iree_status_t iree_hal_task_device_profiling_end(
     iree_hal_device_t* base_device) {
-  // Unimplemented (and that's ok).
-  return iree_ok_status();
+  iree_hal_task_device_t* device = iree_hal_task_device_cast(base_device);
+  return iree_hal_local_profiler_end(device->profiler);
 }
 
 static const iree_hal_device_vtable_t iree_hal_task_device_vtable = {
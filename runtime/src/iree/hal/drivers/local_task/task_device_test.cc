@@ -0,0 +1,136 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/hal/drivers/local_task/task_device.h"
+
+#include <cstring>
+#include <vector>
+
+#include "iree/base/api.h"
+#include "iree/hal/api.h"
+#include "iree/hal/local/executable_library.h"
+#include "iree/hal/local/local_executable.h"
+#include "iree/hal/local/loaders/static_library_loader.h"
+#include "iree/task/api.h"
+#include "iree/testing/gtest.h"
+#include "iree/testing/status_matchers.h"
+
+namespace {
+
+// An executable library with no exports; only its preparation matters here.
+static const iree_hal_executable_library_header_t empty_library_header = {
+    /*version=*/IREE_HAL_EXECUTABLE_LIBRARY_VERSION_LATEST,
+    /*name=*/"empty_library",
+    /*features=*/IREE_HAL_EXECUTABLE_LIBRARY_FEATURE_NONE,
+    /*sanitizer=*/IREE_HAL_EXECUTABLE_LIBRARY_SANITIZER_NONE,
+};
+static const iree_hal_executable_library_v0_t empty_library = {
+    /*header=*/&empty_library_header,
+};
+static const iree_hal_executable_library_header_t** empty_library_query(
+    iree_hal_executable_library_version_t max_version,
+    const iree_hal_executable_environment_v0_t* environment) {
+  return max_version <= IREE_HAL_EXECUTABLE_LIBRARY_VERSION_LATEST
+             ? (const iree_hal_executable_library_header_t**)&empty_library
+             : NULL;
+}
+
+// A loop that defers all calls until explicitly drained by the test.
+struct DeferredLoop {
+  std::vector<iree_loop_callback_t> calls;
+
+  iree_loop_t loop() { return {this, DeferredLoop::Ctl}; }
+
+  static iree_status_t Ctl(void* self, iree_loop_command_t command,
+                           const void* params, void** inout_ptr) {
+    if (command != IREE_LOOP_COMMAND_CALL) {
+      return iree_make_status(IREE_STATUS_UNIMPLEMENTED);
+    }
+    auto* deferred_loop = reinterpret_cast<DeferredLoop*>(self);
+    deferred_loop->calls.push_back(
+        reinterpret_cast<const iree_loop_call_params_t*>(params)->callback);
+    return iree_ok_status();
+  }
+
+  void Drain() {
+    auto pending_calls = std::move(calls);
+    for (auto& callback : pending_calls) {
+      IREE_EXPECT_OK(callback.fn(callback.user_data, loop(), iree_ok_status()));
+    }
+  }
+};
+
+// Tests that executable preparation is scheduled on the loop the caller
+// provides and that it does not reference the device, which may be destroyed
+// before the loop runs.
+TEST(TaskDeviceTest, PrepareOnCallerLoop) {
+  iree_allocator_t host_allocator = iree_allocator_system();
+
+  iree_task_topology_t topology;
+  iree_task_topology_initialize_from_group_count(/*group_count=*/1, &topology);
+  iree_task_executor_options_t options;
+  iree_task_executor_options_initialize(&options);
+  iree_task_executor_t* executor = NULL;
+  IREE_ASSERT_OK(iree_task_executor_create(options, &topology, host_allocator,
+                                           &executor));
+  iree_task_topology_deinitialize(&topology);
+
+  const iree_hal_executable_library_query_fn_t library_query_fns[] = {
+      empty_library_query,
+  };
+  iree_hal_executable_loader_t* loader = NULL;
+  IREE_ASSERT_OK(iree_hal_static_library_loader_create(
+      IREE_ARRAYSIZE(library_query_fns), library_query_fns,
+      iree_hal_executable_import_provider_null(), host_allocator, &loader));
+
+  iree_hal_allocator_t* device_allocator = NULL;
+  IREE_ASSERT_OK(iree_hal_allocator_create_heap(
+      IREE_SV("test"), host_allocator, host_allocator, &device_allocator));
+
+  iree_hal_task_device_params_t params;
+  iree_hal_task_device_params_initialize(&params);
+  iree_hal_device_t* device = NULL;
+  IREE_ASSERT_OK(iree_hal_task_device_create(
+      IREE_SV("test"), &params, /*queue_count=*/1, &executor,
+      /*loader_count=*/1, &loader, device_allocator, host_allocator, &device));
+  iree_hal_allocator_release(device_allocator);
+  iree_hal_executable_loader_release(loader);
+
+  DeferredLoop deferred_loop;
+  iree_hal_executable_cache_t* executable_cache = NULL;
+  IREE_ASSERT_OK(iree_hal_executable_cache_create(
+      device, IREE_SV("test"), deferred_loop.loop(), &executable_cache));
+
+  iree_hal_executable_params_t executable_params;
+  iree_hal_executable_params_initialize(&executable_params);
+  executable_params.executable_format = IREE_SV("static");
+  executable_params.executable_data =
+      iree_make_const_byte_span("empty_library", strlen("empty_library"));
+  iree_hal_executable_t* executable = NULL;
+  IREE_ASSERT_OK(iree_hal_executable_cache_prepare_executable_async(
+      executable_cache, &executable_params, /*signal_fence=*/NULL,
+      &executable));
+  EXPECT_EQ(deferred_loop.calls.size(), 1);
+
+  // The executable is not usable until the loop runs the preparation and
+  // checking it does not wait.
+  iree_hal_local_executable_t* local_executable =
+      iree_hal_local_executable_cast(executable);
+  iree_status_t status =
+      iree_hal_local_executable_query_ready(local_executable);
+  EXPECT_TRUE(iree_status_is_failed_precondition(status));
+  iree_status_ignore(status);
+
+  iree_hal_executable_cache_release(executable_cache);
+  iree_hal_device_release(device);
+  deferred_loop.Drain();
+  IREE_EXPECT_OK(iree_hal_local_executable_query_ready(local_executable));
+
+  iree_hal_executable_release(executable);
+  iree_task_executor_release(executor);
+}
+
+}  // namespace
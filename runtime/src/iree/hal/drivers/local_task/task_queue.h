@@ -37,6 +37,10 @@ typedef struct iree_hal_task_queue_t {
   // The intra-queue synchronization (barriers/events) carries across command
   // buffers and this is used to rendezvous the tasks in each set.
   iree_hal_task_queue_state_t state;
+
+  // First profiler worker slot of |executor|. Queues sharing an executor share
+  // slots and each distinct executor of a device gets its own range.
+  uint32_t profiler_worker_base;
 } iree_hal_task_queue_t;
 
 void iree_hal_task_queue_initialize(iree_string_view_t identifier,
@@ -63,6 +63,11 @@ typedef struct iree_hal_task_semaphore_t {
 
   // OK or the status passed to iree_hal_semaphore_fail. Owned by the semaphore.
   iree_status_t failure_status;
+
+  // Posted whenever the semaphore is signaled or failed. Host waits block on
+  // this (a futex where available) instead of acquiring an event per wait and
+  // all waiters are woken with a single post.
+  iree_notification_t notification;
 } iree_hal_task_semaphore_t;
 
 static const iree_hal_semaphore_vtable_t iree_hal_task_semaphore_vtable;
@@ -93,6 +98,7 @@ iree_status_t iree_hal_task_semaphore_create(
     iree_slim_mutex_initialize(&semaphore->mutex);
     semaphore->current_value = initial_value;
     semaphore->failure_status = iree_ok_status();
+    iree_notification_initialize(&semaphore->notification);
 
     *out_semaphore = &semaphore->base;
   }
@@ -108,6 +114,7 @@ static void iree_hal_task_semaphore_destroy(
   iree_allocator_t host_allocator = semaphore->host_allocator;
   IREE_TRACE_ZONE_BEGIN(z0);
 
+  iree_notification_deinitialize(&semaphore->notification);
   iree_slim_mutex_deinitialize(&semaphore->mutex);
   iree_status_ignore(semaphore->failure_status);
 
@@ -165,6 +172,9 @@ static iree_status_t iree_hal_task_semaphore_signal(
   // Notify timepoints - note that this must happen outside the lock.
   iree_hal_semaphore_notify(&semaphore->base, new_value, IREE_STATUS_OK);
 
+  // Wake all host waiters; this is a no-op if there are none.
+  iree_notification_post(&semaphore->notification, IREE_ALL_WAITERS);
+
   return iree_ok_status();
 }
 
@@ -194,6 +204,7 @@ static void iree_hal_task_semaphore_fail(iree_hal_semaphore_t* base_semaphore,
   // Notify timepoints - note that this must happen outside the lock.
   iree_hal_semaphore_notify(&semaphore->base, IREE_HAL_SEMAPHORE_FAILURE_VALUE,
                             status_code);
+  iree_notification_post(&semaphore->notification, IREE_ALL_WAITERS);
 }
 
 // Acquires a timepoint waiting for the given value.
@@ -277,6 +288,23 @@ iree_status_t iree_hal_task_semaphore_enqueue_timepoint(
   return status;
 }
 
+typedef struct iree_hal_task_semaphore_notify_state_t {
+  iree_hal_task_semaphore_t* semaphore;
+  uint64_t value;
+} iree_hal_task_semaphore_notify_state_t;
+
+// Returns true if the semaphore has reached the value (or failed).
+// Used with iree_condition_fn_t and must match that signature.
+static bool iree_hal_task_semaphore_is_signaled(
+    iree_hal_task_semaphore_notify_state_t* state) {
+  iree_hal_task_semaphore_t* semaphore = state->semaphore;
+  iree_slim_mutex_lock(&semaphore->mutex);
+  bool is_signaled = semaphore->current_value >= state->value ||
+                     !iree_status_is_ok(semaphore->failure_status);
+  iree_slim_mutex_unlock(&semaphore->mutex);
+  return is_signaled;
+}
+
 static iree_status_t iree_hal_task_semaphore_wait(
     iree_hal_semaphore_t* base_semaphore, uint64_t value,
     iree_timeout_t timeout) {
@@ -299,25 +327,33 @@ static iree_status_t iree_hal_task_semaphore_wait(
     return iree_status_from_code(IREE_STATUS_DEADLINE_EXCEEDED);
   }
 
-  iree_time_t deadline_ns = iree_timeout_as_deadline_ns(timeout);
+  iree_slim_mutex_unlock(&semaphore->mutex);
 
-  // Slow path: acquire a timepoint while we hold the lock.
-  iree_hal_task_timepoint_t timepoint;
-  iree_status_t status = iree_hal_task_semaphore_acquire_timepoint(
-      semaphore, value, timeout, &timepoint);
+  // Slow path: block on the semaphore notification until the value is reached.
+  // Unlike timepoints this needs no event or fd and all waiters are woken by
+  // the single post made when the semaphore is signaled.
+  IREE_TRACE_ZONE_BEGIN(z0);
+  iree_hal_task_semaphore_notify_state_t notify_state = {
+      .semaphore = semaphore,
+      .value = value,
+  };
+  iree_notification_await(
+      &semaphore->notification,
+      (iree_condition_fn_t)iree_hal_task_semaphore_is_signaled,
+      (void*)&notify_state, timeout);
 
-  iree_slim_mutex_unlock(&semaphore->mutex);
-  if (IREE_UNLIKELY(!iree_status_is_ok(status))) return status;
-
-  // Wait until the timepoint resolves.
-  // If satisfied the timepoint is automatically cleaned up and we are done. If
-  // the deadline is reached before satisfied then we have to clean it up.
-  status = iree_wait_one(&timepoint.event, deadline_ns);
-  if (!iree_status_is_ok(status)) {
-    iree_hal_semaphore_cancel_timepoint(&semaphore->base, &timepoint.base);
+  iree_status_t status = iree_ok_status();
+  iree_slim_mutex_lock(&semaphore->mutex);
+  if (!iree_status_is_ok(semaphore->failure_status)) {
+    // Semaphore has failed.
+    status = iree_status_from_code(IREE_STATUS_ABORTED);
+  } else if (semaphore->current_value < value) {
+    // Deadline expired before the semaphore was signaled.
+    status = iree_status_from_code(IREE_STATUS_DEADLINE_EXCEEDED);
   }
-  iree_event_pool_release(semaphore->event_pool, 1, &timepoint.event);
+  iree_slim_mutex_unlock(&semaphore->mutex);
 
+  IREE_TRACE_ZONE_END(z0);
   return status;
 }
 
@@ -337,6 +373,21 @@ iree_status_t iree_hal_task_semaphore_multi_wait(
 
   iree_time_t deadline_ns = iree_timeout_as_deadline_ns(timeout);
 
+  // Wait-all can wait on each semaphore in turn with the same deadline and use
+  // the notification-based single waits. Only wait-any needs system wait
+  // handles so that it can block on all of the semaphores at once.
+  if (wait_mode == IREE_HAL_WAIT_MODE_ALL) {
+    iree_status_t status = iree_ok_status();
+    for (iree_host_size_t i = 0; i < semaphore_list.count; ++i) {
+      status = iree_hal_task_semaphore_wait(semaphore_list.semaphores[i],
+                                            semaphore_list.payload_values[i],
+                                            iree_make_deadline(deadline_ns));
+      if (!iree_status_is_ok(status)) break;
+    }
+    IREE_TRACE_ZONE_END(z0);
+    return status;
+  }
+
   // Avoid heap allocations by using the device block pool for the wait set.
   iree_arena_allocator_t arena;
   iree_arena_initialize(block_pool, &arena);
@@ -350,6 +401,7 @@ iree_status_t iree_hal_task_semaphore_multi_wait(
   // call.
   iree_host_size_t timepoint_count = 0;
   iree_hal_task_timepoint_t* timepoints = NULL;
+  bool any_satisfied = false;
   iree_host_size_t total_timepoint_size =
       semaphore_list.count * sizeof(timepoints[0]);
   status =
@@ -361,7 +413,8 @@ iree_status_t iree_hal_task_semaphore_multi_wait(
           iree_hal_task_semaphore_cast(semaphore_list.semaphores[i]);
       iree_slim_mutex_lock(&semaphore->mutex);
       if (semaphore->current_value >= semaphore_list.payload_values[i]) {
-        // Fast path: already satisfied.
+        // Fast path: already satisfied and the wait-any can return.
+        any_satisfied = true;
       } else {
         // Slow path: get a native wait handle for the timepoint.
         iree_hal_task_timepoint_t* timepoint = &timepoints[timepoint_count++];
@@ -372,17 +425,13 @@ iree_status_t iree_hal_task_semaphore_multi_wait(
         }
       }
       iree_slim_mutex_unlock(&semaphore->mutex);
-      if (!iree_status_is_ok(status)) break;
+      if (!iree_status_is_ok(status) || any_satisfied) break;
     }
   }
 
   // Perform the wait.
-  if (iree_status_is_ok(status)) {
-    if (wait_mode == IREE_HAL_WAIT_MODE_ANY) {
-      status = iree_wait_any(wait_set, deadline_ns, /*out_wake_handle=*/NULL);
-    } else {
-      status = iree_wait_all(wait_set, deadline_ns);
-    }
+  if (iree_status_is_ok(status) && !any_satisfied) {
+    status = iree_wait_any(wait_set, deadline_ns, /*out_wake_handle=*/NULL);
   }
 
   // TODO(benvanik): if we flip the API to multi-acquire events from the pool
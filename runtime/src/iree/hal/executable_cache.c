@@ -11,6 +11,7 @@
 
 #include "iree/hal/detail.h"
 #include "iree/hal/device.h"
+#include "iree/hal/fence.h"
 #include "iree/hal/resource.h"
 
 void iree_hal_executable_params_initialize(
@@ -66,3 +67,37 @@ IREE_API_EXPORT iree_status_t iree_hal_executable_cache_prepare_executable(
   IREE_TRACE_ZONE_END(z0);
   return status;
 }
+
+IREE_API_EXPORT iree_status_t
+iree_hal_executable_cache_prepare_executable_async(
+    iree_hal_executable_cache_t* executable_cache,
+    const iree_hal_executable_params_t* executable_params,
+    iree_hal_fence_t* signal_fence, iree_hal_executable_t** out_executable) {
+  IREE_ASSERT_ARGUMENT(executable_cache);
+  IREE_ASSERT_ARGUMENT(executable_params);
+  IREE_ASSERT_ARGUMENT(!executable_params->pipeline_layout_count ||
+                       executable_params->pipeline_layouts);
+  IREE_ASSERT_ARGUMENT(out_executable);
+  *out_executable = NULL;
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  iree_status_t status = iree_ok_status();
+  if (_VTABLE_DISPATCH(executable_cache, prepare_executable_async)) {
+    status = _VTABLE_DISPATCH(executable_cache, prepare_executable_async)(
+        executable_cache, executable_params, signal_fence, out_executable);
+  } else {
+    // Synchronous fallback: the executable is ready upon return.
+    status = _VTABLE_DISPATCH(executable_cache, prepare_executable)(
+        executable_cache, executable_params, out_executable);
+    if (signal_fence) {
+      if (iree_status_is_ok(status)) {
+        status = iree_hal_fence_signal(signal_fence);
+      } else {
+        iree_hal_fence_fail(signal_fence, iree_status_clone(status));
+      }
+    }
+  }
+
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
@@ -20,6 +20,7 @@ extern "C" {
 #endif  // __cplusplus
 
 typedef struct iree_hal_device_t iree_hal_device_t;
+typedef struct iree_hal_fence_t iree_hal_fence_t;
 
 //===----------------------------------------------------------------------===//
 // Types and Enums
@@ -188,6 +189,36 @@ IREE_API_EXPORT iree_status_t iree_hal_executable_cache_prepare_executable(
     const iree_hal_executable_params_t* executable_params,
     iree_hal_executable_t** out_executable);
 
+// Begins preparing the executable defined by |executable_params| for use
+// without waiting for preparation to complete.
+//
+// |out_executable| is returned immediately and may be retained and stored
+// while preparation continues on the loop provided when the cache was created.
+// Operations that require the prepared contents of the executable (such as
+// recording a dispatch) never wait for preparation: they fail with
+// IREE_STATUS_FAILED_PRECONDITION while it is in progress and with the
+// preparation error if it failed. Callers must wait on |signal_fence| before
+// using the executable. This allows programs with many executables to prepare
+// them all concurrently and wait once.
+//
+// If provided |signal_fence| will be signaled when preparation completes or
+// failed with the preparation error. Failures known before this call returns
+// (such as when the cache loop runs work inline) are also returned from it.
+//
+// The cache copies any of |executable_params| it needs to retain, including
+// the executable data, and none of it needs to remain valid after this call
+// returns. IREE_HAL_EXECUTABLE_CACHING_MODE_ALIAS_PROVIDED_DATA is ignored by
+// caches that prepare asynchronously as the data cannot be safely aliased once
+// the call has returned.
+//
+// Caches that do not support asynchronous preparation prepare synchronously
+// and signal |signal_fence| before returning.
+IREE_API_EXPORT iree_status_t
+iree_hal_executable_cache_prepare_executable_async(
+    iree_hal_executable_cache_t* executable_cache,
+    const iree_hal_executable_params_t* executable_params,
+    iree_hal_fence_t* signal_fence, iree_hal_executable_t** out_executable);
+
 //===----------------------------------------------------------------------===//
 // iree_hal_executable_cache_t implementation details
 //===----------------------------------------------------------------------===//
@@ -204,6 +235,13 @@ typedef struct iree_hal_executable_cache_vtable_t {
       iree_hal_executable_cache_t* executable_cache,
       const iree_hal_executable_params_t* executable_params,
       iree_hal_executable_t** out_executable);
+
+  // Optional; iree_hal_executable_cache_prepare_executable_async will fall
+  // back to prepare_executable if omitted.
+  iree_status_t(IREE_API_PTR* prepare_executable_async)(
+      iree_hal_executable_cache_t* executable_cache,
+      const iree_hal_executable_params_t* executable_params,
+      iree_hal_fence_t* signal_fence, iree_hal_executable_t** out_executable);
 } iree_hal_executable_cache_vtable_t;
 IREE_HAL_ASSERT_VTABLE_LAYOUT(iree_hal_executable_cache_vtable_t);
 
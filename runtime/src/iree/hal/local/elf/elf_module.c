@@ -9,6 +9,7 @@
 #include <inttypes.h>
 #include <string.h>
 
+#include "iree/base/internal/hash.h"
 #include "iree/hal/local/elf/arch.h"
 #include "iree/hal/local/elf/fatelf.h"
 #include "iree/hal/local/elf/platform.h"
@@ -665,3 +666,410 @@ iree_status_t iree_elf_module_lookup_export(iree_elf_module_t* module,
   *out_export = module->vaddr_bias + sym->st_value;
   return iree_ok_status();
 }
+
+//==============================================================================
+// Load snapshots
+//==============================================================================
+
+#define IREE_ELF_SNAPSHOT_VERSION 1
+
+// Alignment of the image within the snapshot. This matches the smallest page
+// size of any platform we run on such that the image could be mapped directly.
+#define IREE_ELF_SNAPSHOT_IMAGE_ALIGNMENT 4096
+
+static const char iree_elf_snapshot_magic[8] = {'I', 'R', 'E', 'E',
+                                                'S', 'N', 'A', 'P'};
+
+// Header at the start of every snapshot. All offsets are relative to the start
+// of the snapshot data.
+typedef struct iree_elf_snapshot_header_t {
+  char magic[8];
+  uint32_t version;
+  // e_machine of the source ELF.
+  uint16_t machine;
+  // sizeof(uintptr_t) of the host that produced the snapshot.
+  uint16_t pointer_size;
+  // Total number of iree_elf_phdr_t in the phdr table.
+  uint32_t phdr_count;
+  // Total number of uint32_t image-relative offsets in the fixup table.
+  uint32_t fixup_count;
+  // Minimum virtual address of the image (what the image starts at).
+  uint64_t vaddr_offset;
+  // Total length of the virtual address range covered by the image.
+  uint64_t vaddr_length;
+  uint64_t phdr_table_offset;
+  uint64_t fixup_table_offset;
+  uint64_t image_offset;
+  // Length and iree_elf_module_snapshot_source_hash of the ELF (or FatELF) the
+  // snapshot was produced from. Used to verify that a snapshot stored outside
+  // of the program was produced from the program.
+  uint64_t source_length;
+  uint64_t source_hash;
+} iree_elf_snapshot_header_t;
+static_assert(sizeof(iree_elf_snapshot_header_t) == 80,
+              "snapshot header is part of the serialized format");
+
+bool iree_elf_module_is_snapshot(iree_const_byte_span_t data) {
+  return data.data_length >= sizeof(iree_elf_snapshot_header_t) &&
+         memcmp(data.data, iree_elf_snapshot_magic,
+                sizeof(iree_elf_snapshot_magic)) == 0;
+}
+
+uint64_t iree_elf_module_snapshot_source_hash(iree_const_byte_span_t raw_data) {
+  return iree_hash_words_64(IREE_HASH_WORDS_64_SEED, raw_data.data,
+                            raw_data.data_length);
+}
+
+// Compares the loadable segments of two copies of the same ELF loaded at
+// different addresses and finds all pointer-sized words that differ by exactly
+// the difference in load address. Any other difference indicates a relocation
+// we can't represent and fails. Populates |out_fixups| if not NULL and returns
+// the total number of fixups in |out_fixup_count|.
+static iree_status_t iree_elf_module_diff_relocated_segments(
+    iree_elf_module_load_state_t* load_state, iree_byte_range_t vaddr_range,
+    const iree_elf_module_t* module_a, const iree_elf_module_t* module_b,
+    uint32_t* out_fixups, iree_host_size_t* out_fixup_count) {
+  const uintptr_t bias_delta =
+      (uintptr_t)module_b->vaddr_bias - (uintptr_t)module_a->vaddr_bias;
+  iree_host_size_t fixup_count = 0;
+  for (iree_elf_half_t i = 0; i < load_state->ehdr->e_phnum; ++i) {
+    const iree_elf_phdr_t* phdr = &load_state->phdr_table[i];
+    if (phdr->p_type != IREE_ELF_PT_LOAD) continue;
+    const uint8_t* data_a = module_a->vaddr_bias + phdr->p_vaddr;
+    const uint8_t* data_b = module_b->vaddr_bias + phdr->p_vaddr;
+    iree_host_size_t j = 0;
+    while (j < phdr->p_memsz) {
+      const iree_elf_addr_t vaddr = phdr->p_vaddr + j;
+      if ((vaddr % sizeof(uintptr_t)) != 0 ||
+          j + sizeof(uintptr_t) > phdr->p_memsz) {
+        // Unaligned head/tail bytes must be identical.
+        if (data_a[j] != data_b[j]) {
+          return iree_make_status(
+              IREE_STATUS_UNIMPLEMENTED,
+              "unaligned relocation at vaddr %" PRIu64
+              " cannot be represented in a load snapshot",
+              (uint64_t)vaddr);
+        }
+        ++j;
+        continue;
+      }
+      const uintptr_t word_a = *(const uintptr_t*)(data_a + j);
+      const uintptr_t word_b = *(const uintptr_t*)(data_b + j);
+      if (word_a != word_b) {
+        if (word_b - word_a != bias_delta) {
+          return iree_make_status(
+              IREE_STATUS_UNIMPLEMENTED,
+              "non-address relocation at vaddr %" PRIu64
+              " cannot be represented in a load snapshot",
+              (uint64_t)vaddr);
+        }
+        if (out_fixups) {
+          out_fixups[fixup_count] = (uint32_t)(vaddr - vaddr_range.offset);
+        }
+        ++fixup_count;
+      }
+      j += sizeof(uintptr_t);
+    }
+  }
+  *out_fixup_count = fixup_count;
+  return iree_ok_status();
+}
+
+// Loads and relocates |raw_data| into |out_module| without applying
+// protections or running initializers.
+static iree_status_t iree_elf_module_load_for_snapshot(
+    iree_const_byte_span_t raw_data, iree_allocator_t host_allocator,
+    iree_elf_module_load_state_t* out_load_state,
+    iree_elf_module_t* out_module) {
+  iree_status_t status =
+      iree_elf_module_parse_headers(raw_data, out_load_state, out_module);
+  out_module->host_allocator = host_allocator;
+  if (iree_status_is_ok(status)) {
+    status =
+        iree_elf_module_load_segments(raw_data, out_load_state, out_module);
+  }
+  if (iree_status_is_ok(status)) {
+    status = iree_elf_module_parse_dynamic_tables(out_load_state, out_module);
+  }
+  if (iree_status_is_ok(status)) {
+    status = iree_elf_module_verify_no_imports(out_load_state, out_module);
+  }
+  if (iree_status_is_ok(status)) {
+    status = iree_elf_module_apply_relocations(out_load_state, out_module);
+  }
+  return status;
+}
+
+iree_status_t iree_elf_module_snapshot(iree_const_byte_span_t raw_data,
+                                       iree_allocator_t host_allocator,
+                                       iree_byte_span_t* out_snapshot) {
+  IREE_ASSERT_ARGUMENT(raw_data.data);
+  IREE_ASSERT_ARGUMENT(out_snapshot);
+  *out_snapshot = iree_make_byte_span(NULL, 0);
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  const iree_const_byte_span_t source_data = raw_data;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(z0,
+                                    iree_fatelf_select(raw_data, &raw_data));
+
+  // Load the ELF twice at different addresses; anything the relocations wrote
+  // that depends on the load address will differ between the two copies and
+  // everything else will be identical. This lets us remain agnostic to the
+  // architecture-specific relocation types.
+  iree_elf_module_load_state_t load_states[2];
+  iree_elf_module_t modules[2];
+  memset(modules, 0, sizeof(modules));
+  iree_status_t status = iree_ok_status();
+  iree_memory_jit_context_begin();
+  for (iree_host_size_t i = 0; i < IREE_ARRAYSIZE(modules); ++i) {
+    status = iree_elf_module_load_for_snapshot(raw_data, host_allocator,
+                                               &load_states[i], &modules[i]);
+    if (!iree_status_is_ok(status)) break;
+  }
+  iree_memory_jit_context_end();
+
+  iree_elf_module_load_state_t* load_state = &load_states[0];
+  iree_byte_range_t vaddr_range = {0, 0};
+  if (iree_status_is_ok(status)) {
+    vaddr_range = iree_elf_module_calculate_vaddr_range(load_state);
+    if (vaddr_range.length > UINT32_MAX) {
+      status = iree_make_status(IREE_STATUS_OUT_OF_RANGE,
+                                "ELF image too large for a load snapshot");
+    }
+  }
+
+  // Count the fixups so that we can size the snapshot.
+  iree_host_size_t fixup_count = 0;
+  if (iree_status_is_ok(status)) {
+    status = iree_elf_module_diff_relocated_segments(
+        load_state, vaddr_range, &modules[0], &modules[1], NULL, &fixup_count);
+  }
+
+  // Allocate the snapshot; the image is padded out to its own pages and ends
+  // the snapshot.
+  iree_elf_snapshot_header_t header;
+  memset(&header, 0, sizeof(header));
+  uint8_t* snapshot = NULL;
+  iree_host_size_t snapshot_size = 0;
+  if (iree_status_is_ok(status)) {
+    memcpy(header.magic, iree_elf_snapshot_magic, sizeof(header.magic));
+    header.version = IREE_ELF_SNAPSHOT_VERSION;
+    header.machine = load_state->ehdr->e_machine;
+    header.pointer_size = (uint16_t)sizeof(uintptr_t);
+    header.phdr_count = load_state->ehdr->e_phnum;
+    header.fixup_count = (uint32_t)fixup_count;
+    header.vaddr_offset = vaddr_range.offset;
+    header.vaddr_length = vaddr_range.length;
+    header.phdr_table_offset = sizeof(header);
+    header.fixup_table_offset =
+        header.phdr_table_offset + header.phdr_count * sizeof(iree_elf_phdr_t);
+    header.image_offset = iree_host_align(
+        header.fixup_table_offset + header.fixup_count * sizeof(uint32_t),
+        IREE_ELF_SNAPSHOT_IMAGE_ALIGNMENT);
+    header.source_length = source_data.data_length;
+    header.source_hash = iree_elf_module_snapshot_source_hash(source_data);
+    snapshot_size = header.image_offset + header.vaddr_length;
+    status = iree_allocator_malloc(host_allocator, snapshot_size,
+                                   (void**)&snapshot);
+  }
+
+  if (iree_status_is_ok(status)) {
+    memset(snapshot, 0, snapshot_size);
+    memcpy(snapshot, &header, sizeof(header));
+    memcpy(snapshot + header.phdr_table_offset, load_state->phdr_table,
+           header.phdr_count * sizeof(iree_elf_phdr_t));
+    uint32_t* fixups = (uint32_t*)(snapshot + header.fixup_table_offset);
+    status = iree_elf_module_diff_relocated_segments(
+        load_state, vaddr_range, &modules[0], &modules[1], fixups,
+        &fixup_count);
+  }
+  if (iree_status_is_ok(status)) {
+    // Copy the relocated segments and then remove the load address from each
+    // fixup so that the image is relative to a bias of 0.
+    uint8_t* image = snapshot + header.image_offset;
+    const uint32_t* fixups =
+        (const uint32_t*)(snapshot + header.fixup_table_offset);
+    for (iree_elf_half_t i = 0; i < load_state->ehdr->e_phnum; ++i) {
+      const iree_elf_phdr_t* phdr = &load_state->phdr_table[i];
+      if (phdr->p_type != IREE_ELF_PT_LOAD) continue;
+      memcpy(image + (phdr->p_vaddr - vaddr_range.offset),
+             modules[0].vaddr_bias + phdr->p_vaddr, phdr->p_memsz);
+    }
+    for (iree_host_size_t i = 0; i < fixup_count; ++i) {
+      *(uintptr_t*)(image + fixups[i]) -= (uintptr_t)modules[0].vaddr_bias;
+    }
+  }
+
+  for (iree_host_size_t i = 0; i < IREE_ARRAYSIZE(modules); ++i) {
+    iree_elf_module_deinitialize(&modules[i]);
+  }
+  if (iree_status_is_ok(status)) {
+    *out_snapshot = iree_make_byte_span(snapshot, snapshot_size);
+  } else {
+    iree_allocator_free(host_allocator, snapshot);
+  }
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+// Verifies the snapshot header and that all tables are in bounds.
+static iree_status_t iree_elf_module_verify_snapshot(
+    iree_const_byte_span_t snapshot_data,
+    iree_elf_snapshot_header_t* out_header) {
+  if (!iree_elf_module_is_snapshot(snapshot_data)) {
+    return iree_make_status(IREE_STATUS_FAILED_PRECONDITION,
+                            "data provided is not an ELF load snapshot");
+  }
+  memcpy(out_header, snapshot_data.data, sizeof(*out_header));
+  if (out_header->version != IREE_ELF_SNAPSHOT_VERSION) {
+    return iree_make_status(IREE_STATUS_FAILED_PRECONDITION,
+                            "ELF load snapshot version %u unsupported; "
+                            "expected %u",
+                            out_header->version, IREE_ELF_SNAPSHOT_VERSION);
+  }
+  if (out_header->pointer_size != sizeof(uintptr_t) ||
+      !iree_elf_machine_is_valid(out_header->machine)) {
+    return iree_make_status(
+        IREE_STATUS_FAILED_PRECONDITION,
+        "ELF load snapshot machine (%04X) does not match the running "
+        "architecture",
+        (uint32_t)out_header->machine);
+  }
+  // Each table is checked against the space remaining after its offset so
+  // that no untrusted value is added to or multiplied with another.
+  const uint64_t data_length = snapshot_data.data_length;
+  if (out_header->phdr_count > UINT16_MAX ||
+      out_header->phdr_table_offset > data_length ||
+      out_header->phdr_count > (data_length - out_header->phdr_table_offset) /
+                                   sizeof(iree_elf_phdr_t) ||
+      out_header->fixup_table_offset > data_length ||
+      out_header->fixup_count >
+          (data_length - out_header->fixup_table_offset) / sizeof(uint32_t) ||
+      out_header->image_offset > data_length ||
+      out_header->vaddr_length > data_length - out_header->image_offset ||
+      out_header->vaddr_length > UINT32_MAX ||
+      out_header->vaddr_offset > UINT64_MAX - out_header->vaddr_length) {
+    return iree_make_status(IREE_STATUS_FAILED_PRECONDITION,
+                            "ELF load snapshot tables out of bounds");
+  }
+  if (out_header->phdr_table_offset % sizeof(uint64_t) != 0 ||
+      out_header->fixup_table_offset % sizeof(uint32_t) != 0) {
+    return iree_make_status(IREE_STATUS_FAILED_PRECONDITION,
+                            "ELF load snapshot tables misaligned");
+  }
+  return iree_ok_status();
+}
+
+// Allocates space for and loads all PT_LOAD segments from the snapshot image
+// and then applies the fixups for the chosen load address.
+static iree_status_t iree_elf_module_load_snapshot_segments(
+    iree_const_byte_span_t snapshot_data,
+    const iree_elf_snapshot_header_t* header,
+    iree_elf_module_load_state_t* load_state, iree_elf_module_t* module) {
+  module->vaddr_size = iree_page_align_end(
+      header->vaddr_length, load_state->memory_info.normal_page_size);
+  IREE_RETURN_IF_ERROR(iree_memory_view_reserve(
+      IREE_MEMORY_VIEW_FLAG_MAY_EXECUTE, module->vaddr_size,
+      module->host_allocator, (void**)&module->vaddr_base));
+  module->vaddr_bias = module->vaddr_base - header->vaddr_offset;
+
+  const uint8_t* image = snapshot_data.data + header->image_offset;
+  for (iree_elf_half_t i = 0; i < load_state->ehdr->e_phnum; ++i) {
+    const iree_elf_phdr_t* phdr = &load_state->phdr_table[i];
+    if (phdr->p_type != IREE_ELF_PT_LOAD) continue;
+    if (phdr->p_vaddr < header->vaddr_offset ||
+        phdr->p_memsz > header->vaddr_length ||
+        phdr->p_vaddr - header->vaddr_offset >
+            header->vaddr_length - phdr->p_memsz) {
+      return iree_make_status(IREE_STATUS_FAILED_PRECONDITION,
+                              "snapshot segment outside of image extents");
+    }
+    iree_byte_range_t byte_range = {
+        .offset = phdr->p_vaddr,
+        .length = phdr->p_memsz,
+    };
+    IREE_RETURN_IF_ERROR(iree_memory_view_commit_ranges(
+        module->vaddr_bias, 1, &byte_range,
+        IREE_MEMORY_ACCESS_READ | IREE_MEMORY_ACCESS_WRITE));
+    memcpy(module->vaddr_bias + phdr->p_vaddr,
+           image + (phdr->p_vaddr - header->vaddr_offset), phdr->p_memsz);
+  }
+
+  // Rebase all absolute addresses to the load address. Fixups were produced
+  // from committed words so they always land within a segment loaded above.
+  const uint32_t* fixups =
+      (const uint32_t*)(snapshot_data.data + header->fixup_table_offset);
+  uint8_t* vaddr_base = module->vaddr_bias + header->vaddr_offset;
+  for (uint32_t i = 0; i < header->fixup_count; ++i) {
+    if (header->vaddr_length < sizeof(uintptr_t) ||
+        fixups[i] > header->vaddr_length - sizeof(uintptr_t)) {
+      return iree_make_status(IREE_STATUS_FAILED_PRECONDITION,
+                              "snapshot fixup outside of image extents");
+    }
+    *(uintptr_t*)(vaddr_base + fixups[i]) += (uintptr_t)module->vaddr_bias;
+  }
+
+  return iree_ok_status();
+}
+
+bool iree_elf_module_snapshot_matches(iree_const_byte_span_t snapshot_data,
+                                      uint64_t source_hash,
+                                      iree_host_size_t source_length) {
+  iree_elf_snapshot_header_t header;
+  iree_status_t status =
+      iree_elf_module_verify_snapshot(snapshot_data, &header);
+  if (!iree_status_is_ok(status)) {
+    iree_status_ignore(status);
+    return false;
+  }
+  return header.source_length == source_length &&
+         header.source_hash == source_hash;
+}
+
+iree_status_t iree_elf_module_initialize_from_snapshot(
+    iree_const_byte_span_t snapshot_data, iree_allocator_t host_allocator,
+    iree_elf_module_t* out_module) {
+  IREE_ASSERT_ARGUMENT(snapshot_data.data);
+  IREE_ASSERT_ARGUMENT(out_module);
+  IREE_TRACE_ZONE_BEGIN(z0);
+  memset(out_module, 0, sizeof(*out_module));
+  out_module->host_allocator = host_allocator;
+
+  iree_elf_snapshot_header_t header;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_elf_module_verify_snapshot(snapshot_data, &header));
+
+  // The shared load stages only need the phdr table and its count so we
+  // synthesize an ehdr to carry the count.
+  iree_elf_ehdr_t ehdr;
+  memset(&ehdr, 0, sizeof(ehdr));
+  ehdr.e_machine = header.machine;
+  ehdr.e_phnum = (iree_elf_half_t)header.phdr_count;
+  iree_elf_module_load_state_t load_state;
+  memset(&load_state, 0, sizeof(load_state));
+  iree_memory_query_info(&load_state.memory_info);
+  load_state.ehdr = &ehdr;
+  load_state.phdr_table =
+      (const iree_elf_phdr_t*)(snapshot_data.data + header.phdr_table_offset);
+
+  iree_memory_jit_context_begin();
+  iree_status_t status = iree_elf_module_load_snapshot_segments(
+      snapshot_data, &header, &load_state, out_module);
+  if (iree_status_is_ok(status)) {
+    status = iree_elf_module_parse_dynamic_tables(&load_state, out_module);
+  }
+  if (iree_status_is_ok(status)) {
+    status = iree_elf_module_protect_segments(&load_state, out_module);
+  }
+  iree_memory_jit_context_end();
+
+  if (iree_status_is_ok(status)) {
+    status = iree_elf_module_run_initializers(&load_state, out_module);
+  }
+
+  if (!iree_status_is_ok(status)) {
+    iree_elf_module_deinitialize(out_module);
+  }
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
@@ -7,6 +7,7 @@
 #ifndef IREE_HAL_LOCAL_ELF_ELF_LINKER_H_
 #define IREE_HAL_LOCAL_ELF_ELF_LINKER_H_
 
+#include <stdbool.h>
 #include <stdint.h>
 
 #include "iree/base/api.h"
@@ -89,4 +90,66 @@ iree_status_t iree_elf_module_lookup_export(iree_elf_module_t* module,
                                             const char* symbol_name,
                                             void** out_export);
 
+//==============================================================================
+// Load snapshots
+//==============================================================================
+
+// A load snapshot is a pre-relocated form of an ELF module that can be loaded
+// with almost no processing. It contains the page-aligned in-memory image of
+// all loadable segments as they appear after relocation, the segment table
+// used for applying page protections, and a table of image-relative offsets of
+// the pointer-sized words that need the load address added to them.
+//
+// Loading a snapshot is a reserve + copy + fixup pass instead of the full
+// header verification, dynamic table parsing, symbol resolution, and
+// architecture-specific relocation processing performed on the original ELF.
+// Initializers (if any) still run on every load as they may depend on the
+// process state. Snapshots are only valid for the architecture they were
+// produced on and are versioned such that stale snapshots are rejected.
+// Modules with imports cannot be snapshotted.
+//
+// The image is stored at a page-aligned offset within the snapshot and laid out
+// identically to the virtual address space of the module so that it may be
+// directly mapped in the future. The header records the length and hash of the
+// source ELF so that snapshots stored on disk can be checked against the ELF
+// they are being used in place of with iree_elf_module_snapshot_matches without
+// keeping a copy of the ELF. Snapshot contents beyond the header and table
+// bounds are not checksummed: like any other cached executable code they must
+// come from a trusted location.
+
+// Returns true if |data| contains a load snapshot (vs. an ELF or FatELF).
+bool iree_elf_module_is_snapshot(iree_const_byte_span_t data);
+
+// Produces a load snapshot of the ELF (or FatELF) in |raw_data|.
+// The snapshot is allocated from |host_allocator| and returned in
+// |out_snapshot|; callers must free it with iree_allocator_free.
+//
+// Returns UNIMPLEMENTED if the ELF uses relocations that cannot be represented
+// as pointer-sized additions of the load address (such as text relocations).
+// Callers should fall back to storing the original ELF in that case.
+iree_status_t iree_elf_module_snapshot(iree_const_byte_span_t raw_data,
+                                       iree_allocator_t host_allocator,
+                                       iree_byte_span_t* out_snapshot);
+
+// Returns the hash identifying the ELF (or FatELF) in |raw_data| in snapshots.
+// Callers may use it to name snapshots stored outside of the program.
+uint64_t iree_elf_module_snapshot_source_hash(iree_const_byte_span_t raw_data);
+
+// Returns true if |snapshot_data| is a well-formed snapshot for this
+// architecture produced from an ELF of |source_length| bytes with the
+// |source_hash| returned by iree_elf_module_snapshot_source_hash. Snapshots
+// loaded from outside of the program should be checked with this before being
+// passed to iree_elf_module_initialize_from_snapshot.
+bool iree_elf_module_snapshot_matches(iree_const_byte_span_t snapshot_data,
+                                      uint64_t source_hash,
+                                      iree_host_size_t source_length);
+
+// Initializes an ELF module from a load snapshot produced by
+// iree_elf_module_snapshot. |snapshot_data| must be aligned to at least the
+// pointer size and only needs to remain valid for the initialization of the
+// module. See iree_elf_module_initialize_from_memory for details.
+iree_status_t iree_elf_module_initialize_from_snapshot(
+    iree_const_byte_span_t snapshot_data, iree_allocator_t host_allocator,
+    iree_elf_module_t* out_module);
+
 #endif  // IREE_HAL_LOCAL_ELF_ELF_LINKER_H_
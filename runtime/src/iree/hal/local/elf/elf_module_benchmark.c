@@ -0,0 +1,124 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include <string.h>
+
+#include "iree/base/api.h"
+#include "iree/hal/local/elf/elf_module.h"
+#include "iree/testing/benchmark.h"
+
+// ELF modules for various platforms embedded in the binary:
+#include "iree/hal/local/elf/testdata/elementwise_mul.h"
+
+static iree_status_t query_arch_test_file_data(
+    iree_const_byte_span_t* out_file_data) {
+  *out_file_data = iree_make_const_byte_span(NULL, 0);
+
+  iree_string_view_t pattern = iree_string_view_empty();
+#if defined(IREE_ARCH_ARM_32)
+  pattern = iree_make_cstring_view("*_arm_32.so");
+#elif defined(IREE_ARCH_ARM_64)
+  pattern = iree_make_cstring_view("*_arm_64.so");
+#elif defined(IREE_ARCH_RISCV_32)
+  pattern = iree_make_cstring_view("*_riscv_32.so");
+#elif defined(IREE_ARCH_RISCV_64)
+  pattern = iree_make_cstring_view("*_riscv_64.so");
+#elif defined(IREE_ARCH_X86_32)
+  pattern = iree_make_cstring_view("*_x86_32.so");
+#elif defined(IREE_ARCH_X86_64)
+  pattern = iree_make_cstring_view("*_x86_64.so");
+#endif  // IREE_ARCH_*
+
+  if (!iree_string_view_is_empty(pattern)) {
+    for (size_t i = 0; i < elementwise_mul_size(); ++i) {
+      const struct iree_file_toc_t* file_toc = &elementwise_mul_create()[i];
+      if (iree_string_view_match_pattern(iree_make_cstring_view(file_toc->name),
+                                         pattern)) {
+        *out_file_data =
+            iree_make_const_byte_span(file_toc->data, file_toc->size);
+        return iree_ok_status();
+      }
+    }
+  }
+
+  return iree_make_status(IREE_STATUS_NOT_FOUND,
+                          "no architecture-specific ELF binary embedded into "
+                          "the application for the current target platform");
+}
+
+// Loads the module by parsing and relocating the ELF each time. This is what
+// every load does without a snapshot cache.
+static iree_status_t iree_elf_module_benchmark_relocate(
+    const iree_benchmark_def_t* benchmark_def,
+    iree_benchmark_state_t* benchmark_state) {
+  iree_const_byte_span_t file_data;
+  IREE_RETURN_IF_ERROR(query_arch_test_file_data(&file_data));
+  iree_elf_import_table_t import_table;
+  memset(&import_table, 0, sizeof(import_table));
+
+  while (iree_benchmark_keep_running(benchmark_state, /*batch_count=*/1)) {
+    iree_elf_module_t module;
+    IREE_CHECK_OK(iree_elf_module_initialize_from_memory(
+        file_data, &import_table, benchmark_state->host_allocator, &module));
+    iree_elf_module_deinitialize(&module);
+  }
+
+  return iree_ok_status();
+}
+
+// Loads the module from a snapshot in the same way as a snapshot cache hit:
+// the ELF is hashed to identify the snapshot, the snapshot is checked against
+// it, and then the image is loaded from the snapshot.
+static iree_status_t iree_elf_module_benchmark_snapshot_hit(
+    const iree_benchmark_def_t* benchmark_def,
+    iree_benchmark_state_t* benchmark_state) {
+  iree_allocator_t host_allocator = benchmark_state->host_allocator;
+  iree_const_byte_span_t file_data;
+  IREE_RETURN_IF_ERROR(query_arch_test_file_data(&file_data));
+  iree_byte_span_t snapshot_data = iree_make_byte_span(NULL, 0);
+  IREE_RETURN_IF_ERROR(
+      iree_elf_module_snapshot(file_data, host_allocator, &snapshot_data));
+  iree_const_byte_span_t snapshot = iree_make_const_byte_span(
+      snapshot_data.data, snapshot_data.data_length);
+
+  while (iree_benchmark_keep_running(benchmark_state, /*batch_count=*/1)) {
+    uint64_t source_hash = iree_elf_module_snapshot_source_hash(file_data);
+    if (!iree_elf_module_snapshot_matches(snapshot, source_hash,
+                                          file_data.data_length)) {
+      iree_allocator_free(host_allocator, snapshot_data.data);
+      return iree_make_status(IREE_STATUS_INTERNAL,
+                              "snapshot does not match the ELF");
+    }
+    iree_elf_module_t module;
+    IREE_CHECK_OK(iree_elf_module_initialize_from_snapshot(
+        snapshot, host_allocator, &module));
+    iree_elf_module_deinitialize(&module);
+  }
+
+  iree_allocator_free(host_allocator, snapshot_data.data);
+  return iree_ok_status();
+}
+
+int main(int argc, char** argv) {
+  iree_benchmark_initialize(&argc, argv);
+
+  iree_benchmark_def_t benchmark_def = {
+      .flags = IREE_BENCHMARK_FLAG_MEASURE_PROCESS_CPU_TIME |
+               IREE_BENCHMARK_FLAG_USE_REAL_TIME,
+      .time_unit = IREE_BENCHMARK_UNIT_MICROSECOND,
+      .minimum_duration_ns = 0,
+      .iteration_count = 0,
+      .run = NULL,
+  };
+  benchmark_def.run = iree_elf_module_benchmark_relocate;
+  iree_benchmark_register(iree_make_cstring_view("relocate"), &benchmark_def);
+  benchmark_def.run = iree_elf_module_benchmark_snapshot_hit;
+  iree_benchmark_register(iree_make_cstring_view("snapshot_hit"),
+                          &benchmark_def);
+
+  iree_benchmark_run_specified();
+  return 0;
+}
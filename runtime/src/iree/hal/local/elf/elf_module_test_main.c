@@ -4,8 +4,13 @@
 // See https://llvm.org/LICENSE.txt for license information.
 // SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
 
+#include <stdio.h>
+#include <stdlib.h>
+
 #include "iree/base/api.h"
 #include "iree/base/internal/cpu.h"
+#include "iree/base/internal/file_io.h"
+#include "iree/base/internal/path.h"
 #include "iree/hal/local/elf/elf_module.h"
 #include "iree/hal/local/executable_environment.h"
 #include "iree/hal/local/executable_library.h"
@@ -51,23 +56,14 @@ static iree_status_t query_arch_test_file_data(
                           "the application for the current target platform");
 }
 
-static iree_status_t run_test() {
-  iree_const_byte_span_t file_data;
-  IREE_RETURN_IF_ERROR(query_arch_test_file_data(&file_data));
-
-  iree_elf_import_table_t import_table;
-  memset(&import_table, 0, sizeof(import_table));
-  iree_elf_module_t module;
-  IREE_RETURN_IF_ERROR(iree_elf_module_initialize_from_memory(
-      file_data, &import_table, iree_allocator_system(), &module));
-
+static iree_status_t run_module(iree_elf_module_t* module) {
   iree_hal_executable_environment_v0_t environment;
   iree_hal_executable_environment_initialize(iree_allocator_system(),
                                              &environment);
 
   void* query_fn_ptr = NULL;
   IREE_RETURN_IF_ERROR(iree_elf_module_lookup_export(
-      &module, IREE_HAL_EXECUTABLE_LIBRARY_EXPORT_NAME, &query_fn_ptr));
+      module, IREE_HAL_EXECUTABLE_LIBRARY_EXPORT_NAME, &query_fn_ptr));
 
   union {
     const iree_hal_executable_library_header_t** header;
@@ -150,11 +146,152 @@ static iree_status_t run_test() {
       break;
     }
   }
+  return status;
+}
 
-  iree_elf_module_deinitialize(&module);
+// Returns a copy of |data| with the byte at |offset| flipped. Callers must free
+// the copy with iree_allocator_system.
+static iree_const_byte_span_t clone_with_flipped_byte(
+    iree_const_byte_span_t data, iree_host_size_t offset) {
+  uint8_t* clone = NULL;
+  IREE_CHECK_OK(iree_allocator_malloc(iree_allocator_system(),
+                                      data.data_length, (void**)&clone));
+  memcpy(clone, data.data, data.data_length);
+  clone[offset] ^= 0xFF;
+  return iree_make_const_byte_span(clone, data.data_length);
+}
+
+// Returns true if |snapshot_data| is rejected for a modified copy of
+// |file_data|, when truncated, and when any header field past the magic is
+// overwritten.
+static bool snapshot_rejects_modifications(iree_const_byte_span_t snapshot_data,
+                                           iree_const_byte_span_t file_data) {
+  iree_const_byte_span_t modified_file_data =
+      clone_with_flipped_byte(file_data, file_data.data_length / 2);
+  bool rejected = !iree_elf_module_snapshot_matches(
+      snapshot_data, iree_elf_module_snapshot_source_hash(modified_file_data),
+      modified_file_data.data_length);
+  iree_allocator_free(iree_allocator_system(),
+                      (void*)modified_file_data.data);
+
+  uint64_t source_hash = iree_elf_module_snapshot_source_hash(file_data);
+  rejected = rejected && !iree_elf_module_snapshot_matches(
+                             iree_make_const_byte_span(
+                                 snapshot_data.data,
+                                 snapshot_data.data_length - 1),
+                             source_hash, file_data.data_length);
+
+  // Overwriting any header word either fails the match or the load. The header
+  // is 80 bytes of which the first 8 are the magic.
+  for (iree_host_size_t offset = 8; rejected && offset < 80; offset += 4) {
+    uint8_t* clone = NULL;
+    IREE_CHECK_OK(iree_allocator_malloc(
+        iree_allocator_system(), snapshot_data.data_length, (void**)&clone));
+    memcpy(clone, snapshot_data.data, snapshot_data.data_length);
+    memset(clone + offset, 0xFF, 4);
+    iree_const_byte_span_t modified_snapshot_data =
+        iree_make_const_byte_span(clone, snapshot_data.data_length);
+    if (iree_elf_module_snapshot_matches(modified_snapshot_data, source_hash,
+                                         file_data.data_length)) {
+      iree_elf_module_t module;
+      iree_status_t status = iree_elf_module_initialize_from_snapshot(
+          modified_snapshot_data, iree_allocator_system(), &module);
+      if (iree_status_is_ok(status)) {
+        iree_elf_module_deinitialize(&module);
+        rejected = false;
+      }
+      iree_status_ignore(status);
+    }
+    iree_allocator_free(iree_allocator_system(), clone);
+  }
+
+  return rejected;
+}
+
+// Produces a snapshot of |file_data|, saves it to a file, and then loads and
+// runs the module from the mapped file.
+static iree_status_t run_snapshot_test(iree_const_byte_span_t file_data) {
+  const char* tmpdir = getenv("TEST_TMPDIR");
+  if (!tmpdir) tmpdir = getenv("TMPDIR");
+  if (!tmpdir) tmpdir = getenv("TEMP");
+  if (!tmpdir) {
+    return iree_make_status(IREE_STATUS_FAILED_PRECONDITION,
+                            "TEST_TMPDIR/TMPDIR/TEMP not defined");
+  }
+  char* snapshot_path = NULL;
+  IREE_RETURN_IF_ERROR(iree_file_path_join(
+      iree_make_cstring_view(tmpdir),
+      iree_make_cstring_view("elf_module_test.elfsnap"),
+      iree_allocator_system(), &snapshot_path));
+
+  // Produce and save the snapshot.
+  iree_byte_span_t snapshot_data = iree_make_byte_span(NULL, 0);
+  iree_status_t status = iree_elf_module_snapshot(
+      file_data, iree_allocator_system(), &snapshot_data);
+  if (iree_status_is_ok(status)) {
+    status = iree_file_write_contents(
+        snapshot_path, iree_make_const_byte_span(snapshot_data.data,
+                                                 snapshot_data.data_length));
+  }
+  iree_allocator_free(iree_allocator_system(), snapshot_data.data);
+
+  // Reload the snapshot from the file and verify it is for our ELF.
+  iree_file_contents_t* contents = NULL;
+  if (iree_status_is_ok(status)) {
+    status = iree_file_read_contents(snapshot_path, IREE_FILE_READ_FLAG_MMAP,
+                                     iree_allocator_system(), &contents);
+  }
+  if (iree_status_is_ok(status) &&
+      (!iree_elf_module_is_snapshot(contents->const_buffer) ||
+       !iree_elf_module_snapshot_matches(
+           contents->const_buffer,
+           iree_elf_module_snapshot_source_hash(file_data),
+           file_data.data_length))) {
+    status = iree_make_status(IREE_STATUS_INTERNAL,
+                              "reloaded snapshot does not match the ELF");
+  }
+  if (iree_status_is_ok(status) &&
+      !snapshot_rejects_modifications(contents->const_buffer, file_data)) {
+    status = iree_make_status(IREE_STATUS_INTERNAL,
+                              "snapshot matched after modification");
+  }
+
+  // Load and run from the reloaded snapshot.
+  if (iree_status_is_ok(status)) {
+    iree_elf_module_t module;
+    status = iree_elf_module_initialize_from_snapshot(
+        contents->const_buffer, iree_allocator_system(), &module);
+    if (iree_status_is_ok(status)) {
+      status = run_module(&module);
+      iree_elf_module_deinitialize(&module);
+    }
+  }
+
+  iree_file_contents_free(contents);
+  remove(snapshot_path);
+  iree_allocator_free(iree_allocator_system(), snapshot_path);
   return status;
 }
 
+static iree_status_t run_test() {
+  iree_const_byte_span_t file_data;
+  IREE_RETURN_IF_ERROR(query_arch_test_file_data(&file_data));
+
+  iree_elf_import_table_t import_table;
+  memset(&import_table, 0, sizeof(import_table));
+
+  // Load directly from the ELF.
+  iree_elf_module_t module;
+  IREE_RETURN_IF_ERROR(iree_elf_module_initialize_from_memory(
+      file_data, &import_table, iree_allocator_system(), &module));
+  iree_status_t status = run_module(&module);
+  iree_elf_module_deinitialize(&module);
+  IREE_RETURN_IF_ERROR(status);
+
+  // Load from a pre-relocated snapshot of the ELF round-tripped via a file.
+  return run_snapshot_test(file_data);
+}
+
 int main() {
   const iree_status_t result = run_test();
   int ret = (int)iree_status_code(result);
@@ -17,6 +17,7 @@
 #include "iree/hal/local/executable_library.h"
 #include "iree/hal/local/local_executable.h"
 #include "iree/hal/local/local_pipeline_layout.h"
+#include "iree/hal/local/local_profiler.h"
 
 //===----------------------------------------------------------------------===//
 // iree_hal_inline_command_buffer_t
@@ -27,6 +28,9 @@ typedef struct iree_hal_inline_command_buffer_t {
   iree_hal_command_buffer_t base;
   iree_allocator_t host_allocator;
 
+  // Optional profiler sampling dispatches while active.
+  iree_hal_local_profiler_t* profiler;
+
   struct {
     // A flattened list of all available descriptor set bindings.
     // As descriptor sets are pushed/bound the bindings will be updated to
@@ -93,8 +97,8 @@ iree_status_t iree_hal_inline_command_buffer_initialize(
     iree_hal_device_t* device, iree_hal_command_buffer_mode_t mode,
     iree_hal_command_category_t command_categories,
     iree_hal_queue_affinity_t queue_affinity, iree_host_size_t binding_capacity,
-    iree_allocator_t host_allocator, iree_byte_span_t storage,
-    iree_hal_command_buffer_t** out_command_buffer) {
+    iree_hal_local_profiler_t* profiler, iree_allocator_t host_allocator,
+    iree_byte_span_t storage, iree_hal_command_buffer_t** out_command_buffer) {
   IREE_ASSERT_ARGUMENT(out_command_buffer);
   *out_command_buffer = NULL;
 
@@ -130,6 +134,8 @@ iree_status_t iree_hal_inline_command_buffer_initialize(
       device, mode, command_categories, queue_affinity, binding_capacity,
       &iree_hal_inline_command_buffer_vtable, &command_buffer->base);
   command_buffer->host_allocator = host_allocator;
+  command_buffer->profiler = profiler;
+  iree_hal_local_profiler_retain(profiler);
   iree_hal_inline_command_buffer_reset(command_buffer);
 
   *out_command_buffer = &command_buffer->base;
@@ -143,13 +149,15 @@ void iree_hal_inline_command_buffer_deinitialize(
   iree_hal_inline_command_buffer_t* command_buffer =
       iree_hal_inline_command_buffer_cast(base_command_buffer);
   iree_hal_inline_command_buffer_reset(command_buffer);
+  iree_hal_local_profiler_release(command_buffer->profiler);
+  command_buffer->profiler = NULL;
 }
 
 iree_status_t iree_hal_inline_command_buffer_create(
     iree_hal_device_t* device, iree_hal_command_buffer_mode_t mode,
     iree_hal_command_category_t command_categories,
     iree_hal_queue_affinity_t queue_affinity, iree_host_size_t binding_capacity,
-    iree_allocator_t host_allocator,
+    iree_hal_local_profiler_t* profiler, iree_allocator_t host_allocator,
     iree_hal_command_buffer_t** out_command_buffer) {
   IREE_ASSERT_ARGUMENT(out_command_buffer);
   *out_command_buffer = NULL;
@@ -162,7 +170,7 @@ iree_status_t iree_hal_inline_command_buffer_create(
   if (iree_status_is_ok(status)) {
     status = iree_hal_inline_command_buffer_initialize(
         device, mode, command_categories, queue_affinity, binding_capacity,
-        host_allocator,
+        profiler, host_allocator,
         iree_make_byte_span(storage, iree_hal_inline_command_buffer_size()),
         &command_buffer);
   }
@@ -445,6 +453,11 @@ static iree_status_t iree_hal_inline_command_buffer_dispatch(
 
   iree_hal_local_executable_t* local_executable =
       iree_hal_local_executable_cast(executable);
+
+  // Recording needs the dispatch attributes of the prepared executable.
+  // Callers preparing asynchronously must wait on the preparation fence first.
+  IREE_RETURN_IF_ERROR(iree_hal_local_executable_query_ready(local_executable));
+
   if (IREE_UNLIKELY(!local_executable->pipeline_layouts)) {
     return iree_make_status(
         IREE_STATUS_FAILED_PRECONDITION,
@@ -533,9 +546,29 @@ static iree_status_t iree_hal_inline_command_buffer_dispatch(
   // floating point state. Reset it.
   iree_fpu_state_t fpu_state =
       iree_fpu_state_push(IREE_FPU_STATE_FLAG_FLUSH_DENORMALS_TO_ZERO);
-  iree_status_t status = iree_hal_local_executable_issue_dispatch_inline(
-      local_executable, entry_point, dispatch_state,
-      command_buffer->state.processor_id, local_memory);
+  iree_status_t status = iree_ok_status();
+  if (iree_hal_local_profiler_is_active(command_buffer->profiler)) {
+    // All workgroups run on this thread so the whole dispatch is one sample.
+    iree_hal_local_profiler_counters_begin(command_buffer->profiler,
+                                           /*worker_id=*/0);
+    iree_hal_local_profiler_sample_t sample;
+    iree_hal_local_profiler_sample_begin(command_buffer->profiler, &sample);
+    status = iree_hal_local_executable_issue_dispatch_inline(
+        local_executable, entry_point, dispatch_state,
+        command_buffer->state.processor_id, local_memory);
+    iree_hal_local_profiler_sample_end(
+        command_buffer->profiler, /*worker_id=*/0, local_executable,
+        entry_point, /*dispatch_count=*/1,
+        workgroup_x * workgroup_y * workgroup_z,
+        iree_hal_local_profiler_binding_length(dispatch_state), &sample);
+    iree_hal_local_profiler_counters_end(command_buffer->profiler,
+                                         /*worker_id=*/0, local_executable,
+                                         entry_point);
+  } else {
+    status = iree_hal_local_executable_issue_dispatch_inline(
+        local_executable, entry_point, dispatch_state,
+        command_buffer->state.processor_id, local_memory);
+  }
   iree_fpu_state_pop(fpu_state);
 
   if (local_memory.data) {
@@ -9,6 +9,7 @@
 
 #include "iree/base/api.h"
 #include "iree/hal/api.h"
+#include "iree/hal/local/local_profiler.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -31,8 +32,8 @@ iree_status_t iree_hal_inline_command_buffer_initialize(
     iree_hal_device_t* device, iree_hal_command_buffer_mode_t mode,
     iree_hal_command_category_t command_categories,
     iree_hal_queue_affinity_t queue_affinity, iree_host_size_t binding_capacity,
-    iree_allocator_t host_allocator, iree_byte_span_t storage,
-    iree_hal_command_buffer_t** out_command_buffer);
+    iree_hal_local_profiler_t* profiler, iree_allocator_t host_allocator,
+    iree_byte_span_t storage, iree_hal_command_buffer_t** out_command_buffer);
 
 // Deinitializes an inline command buffer previously initialized with
 // iree_hal_inline_command_buffer_initialize.
@@ -48,11 +49,14 @@ void iree_hal_inline_command_buffer_deinitialize(
 // Executes all work on the calling thread synchronously (today).
 //
 // Must have IREE_HAL_COMMAND_BUFFER_MODE_ALLOW_INLINE_EXECUTION set.
+//
+// |profiler| is optional and retained for the lifetime of the command buffer;
+// dispatches are sampled on it while it is active.
 iree_status_t iree_hal_inline_command_buffer_create(
     iree_hal_device_t* device, iree_hal_command_buffer_mode_t mode,
     iree_hal_command_category_t command_categories,
     iree_hal_queue_affinity_t queue_affinity, iree_host_size_t binding_capacity,
-    iree_allocator_t host_allocator,
+    iree_hal_local_profiler_t* profiler, iree_allocator_t host_allocator,
     iree_hal_command_buffer_t** out_command_buffer);
 
 // Returns true if |command_buffer| is an inline command buffer.
@@ -0,0 +1,74 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/hal/local/loaders/disk_cache.h"
+
+#include <errno.h>
+#include <inttypes.h>
+#include <stdio.h>
+
+#include "iree/base/internal/file_io.h"
+#include "iree/base/internal/path.h"
+
+iree_status_t iree_hal_disk_cache_entry_path(
+    iree_string_view_t cache_path, uint64_t key, uint64_t source_length,
+    const char* extension, iree_allocator_t host_allocator,
+    char** out_file_path) {
+  IREE_ASSERT_ARGUMENT(extension);
+  IREE_ASSERT_ARGUMENT(out_file_path);
+  *out_file_path = NULL;
+  char file_name[64];
+  int file_name_length =
+      snprintf(file_name, sizeof(file_name),
+               "iree_%016" PRIx64 "_%" PRIx64 ".%s", key, source_length,
+               extension);
+  if (file_name_length < 0 || file_name_length >= (int)sizeof(file_name)) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "cache entry extension '%s' too long", extension);
+  }
+  return iree_file_path_join(cache_path,
+                             iree_make_string_view(file_name, file_name_length),
+                             host_allocator, out_file_path);
+}
+
+iree_status_t iree_hal_disk_cache_insert(const char* file_path,
+                                         iree_const_byte_span_t contents,
+                                         iree_allocator_t host_allocator) {
+  IREE_ASSERT_ARGUMENT(file_path);
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  // The temp file name only needs to be unique among writers of the same
+  // cache entry; the time and a stack address are plenty for that.
+  const uint64_t now = (uint64_t)iree_time_now();
+  int temp_path_length =
+      snprintf(NULL, 0, "%s.%" PRIx64 ".%" PRIxPTR ".tmp", file_path, now,
+               (uintptr_t)&contents);
+  char* temp_path = NULL;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_allocator_malloc(host_allocator, temp_path_length + /*NUL=*/1,
+                                (void**)&temp_path));
+  snprintf(temp_path, temp_path_length + /*NUL=*/1,
+           "%s.%" PRIx64 ".%" PRIxPTR ".tmp", file_path, now,
+           (uintptr_t)&contents);
+
+  iree_status_t status = iree_file_write_contents(temp_path, contents);
+  if (iree_status_is_ok(status) && rename(temp_path, file_path) != 0) {
+    // If another writer beat us to it the existing file is just as good.
+    int rename_errno = errno;
+    iree_status_t exists_status = iree_file_exists(file_path);
+    if (!iree_status_is_ok(exists_status)) {
+      iree_status_ignore(exists_status);
+      status = iree_make_status(iree_status_code_from_errno(rename_errno),
+                                "unable to move cache entry into place at '%s'",
+                                file_path);
+    }
+  }
+  remove(temp_path);
+
+  iree_allocator_free(host_allocator, temp_path);
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
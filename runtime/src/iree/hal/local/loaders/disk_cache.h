@@ -0,0 +1,53 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_HAL_LOCAL_LOADERS_DISK_CACHE_H_
+#define IREE_HAL_LOCAL_LOADERS_DISK_CACHE_H_
+
+#include <stdint.h>
+
+#include "iree/base/api.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+//===----------------------------------------------------------------------===//
+// Persistent on-disk cache entries shared by the executable loaders
+//===----------------------------------------------------------------------===//
+// Loaders caching files derived from executables (system libraries written out
+// for dlopen, embedded ELF load snapshots, etc) store them as individual files
+// in a user-provided cache directory. Entries are named by a |key| (usually a
+// hash of the source executable) and the source length so that distinct
+// executables rarely share an entry; loaders must still verify entries when
+// resolving them as the directory may be shared, stale, or corrupted.
+
+// Returns the path of the entry for |key| and |source_length| in |cache_path|
+// with the given file |extension| (without the leading period) in
+// |out_file_path|. Callers must free the path with |host_allocator|.
+iree_status_t iree_hal_disk_cache_entry_path(
+    iree_string_view_t cache_path, uint64_t key, uint64_t source_length,
+    const char* extension, iree_allocator_t host_allocator,
+    char** out_file_path);
+
+// Writes |contents| to the entry at |file_path| such that other processes
+// racing to do the same never observe a partially written file. The data is
+// written to a unique temporary file next to |file_path| and then renamed into
+// place.
+//
+// Some platforms (Windows) fail to rename over existing files; if another
+// writer won the race the existing file is left in place and the insert
+// succeeds. Callers that need the entry to hold exactly |contents| must verify
+// it after inserting.
+iree_status_t iree_hal_disk_cache_insert(const char* file_path,
+                                         iree_const_byte_span_t contents,
+                                         iree_allocator_t host_allocator);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif  // IREE_HAL_LOCAL_LOADERS_DISK_CACHE_H_
@@ -0,0 +1,84 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/hal/local/loaders/disk_cache.h"
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+#include "iree/base/internal/file_io.h"
+#include "iree/testing/gtest.h"
+#include "iree/testing/status_matchers.h"
+
+namespace {
+
+class DiskCacheTest : public ::testing::Test {
+ protected:
+  static iree_string_view_t GetCachePath() {
+    char* test_tmpdir = getenv("TEST_TMPDIR");
+    if (!test_tmpdir) {
+      test_tmpdir = getenv("TMPDIR");
+    }
+    if (!test_tmpdir) {
+      test_tmpdir = getenv("TEMP");
+    }
+    if (!test_tmpdir) {
+      std::cerr << "TEST_TMPDIR/TMPDIR/TEMP not defined\n";
+      exit(1);
+    }
+    return iree_make_cstring_view(test_tmpdir);
+  }
+
+  // Returns the path of the entry for |key| unique to the running test.
+  static std::string EntryPath(uint64_t key) {
+    const auto* test_info =
+        ::testing::UnitTest::GetInstance()->current_test_info();
+    uint64_t source_length = std::string(test_info->name()).size();
+    char* file_path = NULL;
+    IREE_CHECK_OK(iree_hal_disk_cache_entry_path(
+        GetCachePath(), key, source_length, "test", iree_allocator_system(),
+        &file_path));
+    std::string path = file_path;
+    iree_allocator_free(iree_allocator_system(), file_path);
+    return path;
+  }
+
+  static iree_const_byte_span_t AsSpan(const std::string& data) {
+    return iree_make_const_byte_span(data.data(), data.size());
+  }
+
+  static std::string ReadFile(const std::string& path) {
+    iree_file_contents_t* contents = NULL;
+    IREE_CHECK_OK(iree_file_read_contents(path.c_str(),
+                                          IREE_FILE_READ_FLAG_DEFAULT,
+                                          iree_allocator_system(), &contents));
+    std::string data(reinterpret_cast<const char*>(contents->const_buffer.data),
+                     contents->const_buffer.data_length);
+    iree_file_contents_free(contents);
+    return data;
+  }
+};
+
+TEST_F(DiskCacheTest, EntryPathEncodesKey) {
+  std::string path = EntryPath(0x0123456789ABCDEFull);
+  EXPECT_NE(path.find("iree_0123456789abcdef_"), std::string::npos);
+  EXPECT_EQ(path.substr(path.size() - 5), ".test");
+  EXPECT_NE(path, EntryPath(0x0123456789ABCDEEull));
+}
+
+TEST_F(DiskCacheTest, InsertReplacesEntry) {
+  std::string path = EntryPath(1);
+  IREE_ASSERT_OK(iree_hal_disk_cache_insert(path.c_str(), AsSpan("first"),
+                                            iree_allocator_system()));
+  EXPECT_EQ(ReadFile(path), "first");
+  IREE_ASSERT_OK(iree_hal_disk_cache_insert(path.c_str(), AsSpan("second"),
+                                            iree_allocator_system()));
+  EXPECT_EQ(ReadFile(path), "second");
+  remove(path.c_str());
+}
+
+}  // namespace
@@ -10,13 +10,90 @@
 #include <stddef.h>
 #include <stdint.h>
 
+#include "iree/base/internal/file_io.h"
 #include "iree/hal/api.h"
 #include "iree/hal/local/elf/elf_module.h"
 #include "iree/hal/local/executable_library.h"
 #include "iree/hal/local/executable_library_util.h"
 #include "iree/hal/local/executable_plugin_manager.h"
+#include "iree/hal/local/loaders/disk_cache.h"
 #include "iree/hal/local/local_executable.h"
 
+//===----------------------------------------------------------------------===//
+// Persistent load snapshot cache
+//===----------------------------------------------------------------------===//
+
+// Loads |elf_data| into |out_module| from a load snapshot in |cache_path|.
+// If the cache has no snapshot produced from |elf_data| then one is produced,
+// used for this load, and written to the cache for future loads. Falls back to
+// loading the ELF directly if it cannot be snapshotted.
+static iree_status_t iree_hal_elf_module_initialize_with_snapshot_cache(
+    iree_string_view_t cache_path, iree_const_byte_span_t elf_data,
+    iree_allocator_t host_allocator, iree_elf_module_t* out_module) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  // The one pass over the ELF on a hit: the hash both names the entry and
+  // verifies that the snapshot in it was produced from this ELF.
+  uint64_t hash = iree_elf_module_snapshot_source_hash(elf_data);
+  char* file_path = NULL;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_hal_disk_cache_entry_path(cache_path, hash,
+                                         (uint64_t)elf_data.data_length,
+                                         "elfsnap", host_allocator,
+                                         &file_path));
+
+  // Try loading from an existing snapshot. Anything wrong with it (missing,
+  // stale, produced from a different ELF) is treated as a miss.
+  iree_file_contents_t* contents = NULL;
+  iree_status_t status = iree_file_read_contents(
+      file_path, IREE_FILE_READ_FLAG_MMAP, host_allocator, &contents);
+  if (iree_status_is_ok(status)) {
+    if (iree_elf_module_snapshot_matches(contents->const_buffer, hash,
+                                         elf_data.data_length)) {
+      status = iree_elf_module_initialize_from_snapshot(
+          contents->const_buffer, host_allocator, out_module);
+    } else {
+      status = iree_make_status(IREE_STATUS_DATA_LOSS);
+    }
+  }
+  iree_file_contents_free(contents);
+  if (iree_status_is_ok(status)) {
+    IREE_TRACE_ZONE_APPEND_TEXT(z0, "hit");
+    iree_allocator_free(host_allocator, file_path);
+    IREE_TRACE_ZONE_END(z0);
+    return status;
+  }
+  status = iree_status_ignore(status);
+  IREE_TRACE_ZONE_APPEND_TEXT(z0, "miss");
+
+  // Produce a new snapshot and load from it. Failing to write the snapshot to
+  // the cache only means the next load will be a miss as well.
+  iree_byte_span_t snapshot_data = iree_make_byte_span(NULL, 0);
+  iree_status_t snapshot_status =
+      iree_elf_module_snapshot(elf_data, host_allocator, &snapshot_data);
+  if (iree_status_is_ok(snapshot_status)) {
+    iree_const_byte_span_t const_snapshot_data = iree_make_const_byte_span(
+        snapshot_data.data, snapshot_data.data_length);
+    status = iree_elf_module_initialize_from_snapshot(
+        const_snapshot_data, host_allocator, out_module);
+    if (iree_status_is_ok(status)) {
+      iree_status_ignore(iree_hal_disk_cache_insert(
+          file_path, const_snapshot_data, host_allocator));
+    }
+    iree_allocator_free(host_allocator, snapshot_data.data);
+  } else {
+    // Not all ELFs can be snapshotted (or the ELF is invalid and loading it
+    // directly will report why).
+    iree_status_ignore(snapshot_status);
+    status = iree_elf_module_initialize_from_memory(
+        elf_data, /*import_table=*/NULL, host_allocator, out_module);
+  }
+
+  iree_allocator_free(host_allocator, file_path);
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
 //===----------------------------------------------------------------------===//
 // iree_hal_elf_executable_t
 //===----------------------------------------------------------------------===//
@@ -81,13 +158,17 @@ static iree_status_t iree_hal_elf_executable_query_library(
 
   executable->identifier = iree_make_cstring_view(header->name);
   executable->base.dispatch_attrs = executable->library.v0->exports.attrs;
+  executable->base.export_names = executable->library.v0->exports.names;
   return iree_ok_status();
 }
 
+// Loads the ELF in |executable_params|. If |snapshot_cache_path| is not empty
+// the ELF is loaded using the load snapshot cache in that directory.
 static iree_status_t iree_hal_elf_executable_create(
     const iree_hal_executable_params_t* executable_params,
     const iree_hal_executable_import_provider_t import_provider,
-    iree_allocator_t host_allocator, iree_hal_executable_t** out_executable) {
+    iree_string_view_t snapshot_cache_path, iree_allocator_t host_allocator,
+    iree_hal_executable_t** out_executable) {
   IREE_ASSERT_ARGUMENT(executable_params);
   IREE_ASSERT_ARGUMENT(executable_params->executable_data.data &&
                        executable_params->executable_data.data_length);
@@ -131,9 +212,15 @@ static iree_status_t iree_hal_elf_executable_create(
 
   // Attempt to load the ELF module.
   if (iree_status_is_ok(status)) {
-    status = iree_elf_module_initialize_from_memory(
-        executable_params->executable_data, /*import_table=*/NULL,
-        host_allocator, &executable->module);
+    if (!iree_string_view_is_empty(snapshot_cache_path)) {
+      status = iree_hal_elf_module_initialize_with_snapshot_cache(
+          snapshot_cache_path, executable_params->executable_data,
+          host_allocator, &executable->module);
+    } else {
+      status = iree_elf_module_initialize_from_memory(
+          executable_params->executable_data, /*import_table=*/NULL,
+          host_allocator, &executable->module);
+    }
   }
 
   // Query metadata and get the entry point function pointers.
@@ -229,28 +316,53 @@ typedef struct iree_hal_embedded_elf_loader_t {
   iree_hal_executable_loader_t base;
   iree_allocator_t host_allocator;
   iree_hal_executable_plugin_manager_t* plugin_manager;
+  // Optional load snapshot cache directory; stored inline after the loader.
+  iree_string_view_t snapshot_cache_path;
 } iree_hal_embedded_elf_loader_t;
 
 static const iree_hal_executable_loader_vtable_t
     iree_hal_embedded_elf_loader_vtable;
 
+void iree_hal_embedded_elf_loader_params_initialize(
+    iree_hal_embedded_elf_loader_params_t* out_params) {
+  IREE_ASSERT_ARGUMENT(out_params);
+  memset(out_params, 0, sizeof(*out_params));
+}
+
 iree_status_t iree_hal_embedded_elf_loader_create(
     iree_hal_executable_plugin_manager_t* plugin_manager,
     iree_allocator_t host_allocator,
     iree_hal_executable_loader_t** out_executable_loader) {
+  iree_hal_embedded_elf_loader_params_t params;
+  iree_hal_embedded_elf_loader_params_initialize(&params);
+  return iree_hal_embedded_elf_loader_create_with_params(
+      &params, plugin_manager, host_allocator, out_executable_loader);
+}
+
+iree_status_t iree_hal_embedded_elf_loader_create_with_params(
+    const iree_hal_embedded_elf_loader_params_t* params,
+    iree_hal_executable_plugin_manager_t* plugin_manager,
+    iree_allocator_t host_allocator,
+    iree_hal_executable_loader_t** out_executable_loader) {
+  IREE_ASSERT_ARGUMENT(params);
   IREE_ASSERT_ARGUMENT(out_executable_loader);
   *out_executable_loader = NULL;
   IREE_TRACE_ZONE_BEGIN(z0);
 
   iree_hal_embedded_elf_loader_t* executable_loader = NULL;
-  iree_status_t status = iree_allocator_malloc(
-      host_allocator, sizeof(*executable_loader), (void**)&executable_loader);
+  iree_host_size_t total_size =
+      sizeof(*executable_loader) + params->snapshot_cache_path.size;
+  iree_status_t status = iree_allocator_malloc(host_allocator, total_size,
+                                               (void**)&executable_loader);
   if (iree_status_is_ok(status)) {
     iree_hal_executable_loader_initialize(
         &iree_hal_embedded_elf_loader_vtable,
         iree_hal_executable_plugin_manager_provider(plugin_manager),
         &executable_loader->base);
     executable_loader->host_allocator = host_allocator;
+    iree_string_view_append_to_buffer(
+        params->snapshot_cache_path, &executable_loader->snapshot_cache_path,
+        (char*)executable_loader + sizeof(*executable_loader));
     executable_loader->plugin_manager = plugin_manager;
     iree_hal_executable_plugin_manager_retain(
         executable_loader->plugin_manager);
@@ -290,10 +402,18 @@ static iree_status_t iree_hal_embedded_elf_loader_try_load(
       (iree_hal_embedded_elf_loader_t*)base_executable_loader;
   IREE_TRACE_ZONE_BEGIN(z0);
 
+  // Only use the persistent snapshot cache if the caller allows it.
+  iree_string_view_t snapshot_cache_path = iree_string_view_empty();
+  if (iree_all_bits_set(
+          executable_params->caching_mode,
+          IREE_HAL_EXECUTABLE_CACHING_MODE_ALLOW_PERSISTENT_CACHING)) {
+    snapshot_cache_path = executable_loader->snapshot_cache_path;
+  }
+
   // Perform the load of the ELF and wrap it in an executable handle.
   iree_status_t status = iree_hal_elf_executable_create(
       executable_params, base_executable_loader->import_provider,
-      executable_loader->host_allocator, out_executable);
+      snapshot_cache_path, executable_loader->host_allocator, out_executable);
 
   IREE_TRACE_ZONE_END(z0);
   return status;
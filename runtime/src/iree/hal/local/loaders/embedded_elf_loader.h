@@ -20,6 +20,29 @@ extern "C" {
 typedef struct iree_hal_executable_plugin_manager_t
     iree_hal_executable_plugin_manager_t;
 
+// Parameters for configuring an iree_hal_embedded_elf_loader_t.
+// Must be initialized with iree_hal_embedded_elf_loader_params_initialize
+// prior to use.
+typedef struct iree_hal_embedded_elf_loader_params_t {
+  // Optional directory used to persist pre-relocated load snapshots of ELFs
+  // (see iree_elf_module_snapshot). When set the first load of an executable
+  // writes a snapshot into the directory using a name derived from the ELF
+  // contents and subsequent loads (in this or any future process) load from
+  // the snapshot instead of relocating the ELF. Snapshots are verified against
+  // the ELF before use and replaced if they do not match.
+  //
+  // The cache is best-effort: ELFs that cannot be snapshotted and failures to
+  // write the directory fall back to loading the ELF normally.
+  //
+  // Only executables prepared with
+  // IREE_HAL_EXECUTABLE_CACHING_MODE_ALLOW_PERSISTENT_CACHING use the cache.
+  iree_string_view_t snapshot_cache_path;
+} iree_hal_embedded_elf_loader_params_t;
+
+// Initializes |out_params| to the default values.
+void iree_hal_embedded_elf_loader_params_initialize(
+    iree_hal_embedded_elf_loader_params_t* out_params);
+
 // Creates an executable loader that can load minimally-featured ELF dynamic
 // libraries on any platform. This allows us to use a single file format across
 // all operating systems at the cost of some missing debugging/profiling
@@ -29,6 +52,14 @@ iree_status_t iree_hal_embedded_elf_loader_create(
     iree_allocator_t host_allocator,
     iree_hal_executable_loader_t** out_executable_loader);
 
+// Creates an executable loader as with iree_hal_embedded_elf_loader_create
+// using the provided |params|.
+iree_status_t iree_hal_embedded_elf_loader_create_with_params(
+    const iree_hal_embedded_elf_loader_params_t* params,
+    iree_hal_executable_plugin_manager_t* plugin_manager,
+    iree_allocator_t host_allocator,
+    iree_hal_executable_loader_t** out_executable_loader);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif  // __cplusplus
@@ -6,6 +6,9 @@
 
 #include "iree/hal/local/loaders/registration/init.h"
 
+#include "iree/base/internal/flags.h"
+#include "iree/hal/local/shared_executable_cache.h"
+
 // NOTE: we register in a specific order to allow for prioritization:
 // - system-library: used when embedded is not desired (TSAN/debugging/etc).
 // - embedded-elf: default codegen portable ELF output format.
@@ -23,6 +26,75 @@
 #include "iree/hal/local/loaders/vmvx_module_loader.h"
 #endif  // IREE_HAVE_HAL_EXECUTABLE_LOADER_VMVX_MODULE
 
+IREE_FLAG(
+    bool, executable_loader_shared_cache, false,
+    "Deduplicates executables loaded by all devices sharing the same set of\n"
+    "executable loaders such that identical executables are only loaded once.\n"
+    "See iree/hal/local/shared_executable_cache.h for details.");
+
+// Wraps each of |loaders| in-place with a loader that routes through a new
+// shared executable cache. The cache lives as long as any wrapper does.
+static iree_status_t iree_hal_wrap_executable_loaders_with_shared_cache(
+    iree_host_size_t count, iree_hal_executable_loader_t** loaders,
+    iree_allocator_t host_allocator) {
+  iree_hal_shared_executable_cache_t* cache = NULL;
+  IREE_RETURN_IF_ERROR(
+      iree_hal_shared_executable_cache_create(host_allocator, &cache));
+  iree_status_t status = iree_ok_status();
+  for (iree_host_size_t i = 0; i < count && iree_status_is_ok(status); ++i) {
+    iree_hal_executable_loader_t* wrapped_loader = NULL;
+    status = iree_hal_shared_executable_cache_wrap_loader(
+        cache, loaders[i], host_allocator, &wrapped_loader);
+    if (iree_status_is_ok(status)) {
+      iree_hal_executable_loader_release(loaders[i]);
+      loaders[i] = wrapped_loader;
+    }
+  }
+  iree_hal_shared_executable_cache_release(cache);
+  return status;
+}
+
+#if defined(IREE_HAVE_HAL_EXECUTABLE_LOADER_SYSTEM_LIBRARY)
+IREE_FLAG(
+    string, system_library_cache_dir, "",
+    "Directory used to persist system libraries extracted from executables.\n"
+    "Repeated loads of the same executable (including in future processes)\n"
+    "reuse the existing file instead of writing and linking a new one. The\n"
+    "directory can be populated ahead of time by running the program once.");
+
+static iree_status_t iree_hal_system_library_loader_create_from_flags(
+    iree_hal_executable_plugin_manager_t* plugin_manager,
+    iree_allocator_t host_allocator,
+    iree_hal_executable_loader_t** out_executable_loader) {
+  iree_hal_system_library_loader_params_t params;
+  iree_hal_system_library_loader_params_initialize(&params);
+  params.cache_path = iree_make_cstring_view(FLAG_system_library_cache_dir);
+  return iree_hal_system_library_loader_create_with_params(
+      &params, plugin_manager, host_allocator, out_executable_loader);
+}
+#endif  // IREE_HAVE_HAL_EXECUTABLE_LOADER_SYSTEM_LIBRARY
+
+#if defined(IREE_HAVE_HAL_EXECUTABLE_LOADER_EMBEDDED_ELF)
+IREE_FLAG(
+    string, embedded_elf_snapshot_dir, "",
+    "Directory used to persist pre-relocated load snapshots of embedded ELF\n"
+    "executables. Repeated loads of the same executable (including in future\n"
+    "processes) load from the snapshot instead of relocating the ELF. The\n"
+    "directory can be populated ahead of time by running the program once.");
+
+static iree_status_t iree_hal_embedded_elf_loader_create_from_flags(
+    iree_hal_executable_plugin_manager_t* plugin_manager,
+    iree_allocator_t host_allocator,
+    iree_hal_executable_loader_t** out_executable_loader) {
+  iree_hal_embedded_elf_loader_params_t params;
+  iree_hal_embedded_elf_loader_params_initialize(&params);
+  params.snapshot_cache_path =
+      iree_make_cstring_view(FLAG_embedded_elf_snapshot_dir);
+  return iree_hal_embedded_elf_loader_create_with_params(
+      &params, plugin_manager, host_allocator, out_executable_loader);
+}
+#endif  // IREE_HAVE_HAL_EXECUTABLE_LOADER_EMBEDDED_ELF
+
 IREE_API_EXPORT iree_status_t iree_hal_create_all_available_executable_loaders(
     iree_hal_executable_plugin_manager_t* plugin_manager,
     iree_host_size_t capacity, iree_host_size_t* out_count,
@@ -52,15 +124,15 @@ IREE_API_EXPORT iree_status_t iree_hal_create_all_available_executable_loaders(
 
 #if defined(IREE_HAVE_HAL_EXECUTABLE_LOADER_SYSTEM_LIBRARY)
   if (iree_status_is_ok(status)) {
-    status = iree_hal_system_library_loader_create(
+    status = iree_hal_system_library_loader_create_from_flags(
         plugin_manager, host_allocator, &loaders[count++]);
   }
 #endif  // IREE_HAVE_HAL_EXECUTABLE_LOADER_SYSTEM_LIBRARY
 
 #if defined(IREE_HAVE_HAL_EXECUTABLE_LOADER_EMBEDDED_ELF)
   if (iree_status_is_ok(status)) {
-    status = iree_hal_embedded_elf_loader_create(plugin_manager, host_allocator,
-                                                 &loaders[count++]);
+    status = iree_hal_embedded_elf_loader_create_from_flags(
+        plugin_manager, host_allocator, &loaders[count++]);
   }
 #endif  // IREE_HAVE_HAL_EXECUTABLE_LOADER_EMBEDDED_ELF
 
@@ -72,6 +144,11 @@ IREE_API_EXPORT iree_status_t iree_hal_create_all_available_executable_loaders(
   }
 #endif  // IREE_HAVE_HAL_EXECUTABLE_LOADER_VMVX_MODULE
 
+  if (iree_status_is_ok(status) && FLAG_executable_loader_shared_cache) {
+    status = iree_hal_wrap_executable_loaders_with_shared_cache(count, loaders,
+                                                                host_allocator);
+  }
+
   if (iree_status_is_ok(status)) {
     *out_count = count;
   } else {
@@ -89,15 +166,15 @@ IREE_API_EXPORT iree_status_t iree_hal_create_executable_loader_by_name(
     iree_hal_executable_loader_t** out_executable_loader) {
 #if defined(IREE_HAVE_HAL_EXECUTABLE_LOADER_EMBEDDED_ELF)
   if (iree_string_view_starts_with(name, IREE_SV("embedded-elf"))) {
-    return iree_hal_embedded_elf_loader_create(plugin_manager, host_allocator,
-                                               out_executable_loader);
+    return iree_hal_embedded_elf_loader_create_from_flags(
+        plugin_manager, host_allocator, out_executable_loader);
   }
 #endif  // IREE_HAVE_HAL_EXECUTABLE_LOADER_EMBEDDED_ELF
 
 #if defined(IREE_HAVE_HAL_EXECUTABLE_LOADER_SYSTEM_LIBRARY)
   if (iree_string_view_starts_with(name, IREE_SV("system-library"))) {
-    return iree_hal_system_library_loader_create(plugin_manager, host_allocator,
-                                                 out_executable_loader);
+    return iree_hal_system_library_loader_create_from_flags(
+        plugin_manager, host_allocator, out_executable_loader);
   }
 #endif  // IREE_HAVE_HAL_EXECUTABLE_LOADER_SYSTEM_LIBRARY
 
@@ -28,6 +28,10 @@ typedef struct iree_hal_executable_plugin_manager_t
 // Default options are used to create the loaders. If customization is required
 // then callers should create the loaders themselves.
 //
+// If the `--executable_loader_shared_cache` flag is set the returned loaders
+// share a iree_hal_shared_executable_cache_t such that all devices using them
+// load each unique executable only once.
+//
 // Usage:
 //  iree_host_size_t count = 0;
 //  iree_hal_executable_loader_t* loaders[8] = {NULL};
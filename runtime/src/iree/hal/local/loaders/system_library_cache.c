@@ -0,0 +1,101 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/hal/local/loaders/system_library_cache.h"
+
+#include <string.h>
+
+#include "iree/base/internal/file_io.h"
+#include "iree/base/internal/hash.h"
+#include "iree/hal/local/loaders/disk_cache.h"
+
+#if defined(IREE_PLATFORM_APPLE)
+#define IREE_PLATFORM_DYLIB_EXTENSION "dylib"
+#elif defined(IREE_PLATFORM_WINDOWS)
+#define IREE_PLATFORM_DYLIB_EXTENSION "dll"
+#else
+#define IREE_PLATFORM_DYLIB_EXTENSION "so"
+#endif  // IREE_PLATFORM_*
+
+// Returns true if the file at |file_path| contains exactly |library_data|.
+// Unreadable files are treated as not matching.
+static bool iree_hal_system_library_cache_entry_matches(
+    const char* file_path, iree_const_byte_span_t library_data,
+    iree_allocator_t host_allocator) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+  iree_file_contents_t* contents = NULL;
+  iree_status_t status =
+      iree_file_read_contents(file_path, IREE_FILE_READ_FLAG_PRELOAD,
+                              host_allocator, &contents);
+  bool matches = false;
+  if (iree_status_is_ok(status)) {
+    matches = contents->const_buffer.data_length == library_data.data_length &&
+              memcmp(contents->const_buffer.data, library_data.data,
+                     library_data.data_length) == 0;
+  }
+  iree_status_ignore(status);
+  iree_file_contents_free(contents);
+  IREE_TRACE_ZONE_END(z0);
+  return matches;
+}
+
+iree_status_t iree_hal_system_library_cache_resolve(
+    iree_string_view_t cache_path, iree_const_byte_span_t library_data,
+    iree_allocator_t host_allocator, char** out_file_path,
+    iree_hal_system_library_cache_result_t* out_result) {
+  IREE_ASSERT_ARGUMENT(out_file_path);
+  IREE_ASSERT_ARGUMENT(out_result);
+  *out_file_path = NULL;
+  *out_result = IREE_HAL_SYSTEM_LIBRARY_CACHE_RESULT_MISS;
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  uint64_t hash = iree_hash_fnv1a_64(IREE_HASH_FNV1A_64_SEED, library_data.data,
+                                     library_data.data_length);
+  char* file_path = NULL;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_hal_disk_cache_entry_path(
+              cache_path, hash, (uint64_t)library_data.data_length,
+              IREE_PLATFORM_DYLIB_EXTENSION, host_allocator, &file_path));
+
+  iree_status_t status = iree_file_exists(file_path);
+  if (iree_status_is_ok(status)) {
+    if (iree_hal_system_library_cache_entry_matches(file_path, library_data,
+                                                    host_allocator)) {
+      IREE_TRACE_ZONE_APPEND_TEXT(z0, "hit");
+      *out_result = IREE_HAL_SYSTEM_LIBRARY_CACHE_RESULT_HIT;
+    } else {
+      IREE_TRACE_ZONE_APPEND_TEXT(z0, "replaced");
+      *out_result = IREE_HAL_SYSTEM_LIBRARY_CACHE_RESULT_REPLACED;
+      status = iree_hal_disk_cache_insert(file_path, library_data,
+                                                    host_allocator);
+    }
+  } else if (iree_status_is_not_found(status)) {
+    IREE_TRACE_ZONE_APPEND_TEXT(z0, "miss");
+    status = iree_status_ignore(status);
+    *out_result = IREE_HAL_SYSTEM_LIBRARY_CACHE_RESULT_MISS;
+    status = iree_hal_disk_cache_insert(file_path, library_data,
+                                                  host_allocator);
+  }
+
+  // Verify what we wrote (or what a racing writer left in place).
+  if (iree_status_is_ok(status) &&
+      *out_result != IREE_HAL_SYSTEM_LIBRARY_CACHE_RESULT_HIT &&
+      !iree_hal_system_library_cache_entry_matches(file_path, library_data,
+                                                   host_allocator)) {
+    status = iree_make_status(IREE_STATUS_DATA_LOSS,
+                              "cached library at '%s' does not match the "
+                              "executable and could not be replaced",
+                              file_path);
+  }
+
+  if (iree_status_is_ok(status)) {
+    *out_file_path = file_path;
+  } else {
+    iree_allocator_free(host_allocator, file_path);
+  }
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
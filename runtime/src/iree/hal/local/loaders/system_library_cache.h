@@ -0,0 +1,52 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_HAL_LOCAL_LOADERS_SYSTEM_LIBRARY_CACHE_H_
+#define IREE_HAL_LOCAL_LOADERS_SYSTEM_LIBRARY_CACHE_H_
+
+#include "iree/base/api.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+// How a library was resolved in the persistent cache.
+typedef enum iree_hal_system_library_cache_result_e {
+  // An existing entry with identical contents was reused.
+  IREE_HAL_SYSTEM_LIBRARY_CACHE_RESULT_HIT = 0,
+  // No entry existed and a new one was written.
+  IREE_HAL_SYSTEM_LIBRARY_CACHE_RESULT_MISS,
+  // An entry existed with different contents (truncated, modified, or a hash
+  // collision) and was replaced.
+  IREE_HAL_SYSTEM_LIBRARY_CACHE_RESULT_REPLACED,
+} iree_hal_system_library_cache_result_t;
+
+// Ensures that a file containing exactly |library_data| exists in the
+// |cache_path| directory and returns its path in |out_file_path|. Callers must
+// free the path with |host_allocator|.
+//
+// Entries are named by a hash and the length of their contents. Existing
+// entries are compared byte-for-byte against |library_data| and replaced if
+// they differ so that a corrupted entry or hash collision never resolves to
+// the wrong library. New entries are written to a temporary file and renamed
+// into place so that concurrent writers never observe partial files.
+//
+// Returns IREE_STATUS_DATA_LOSS if a mismatched entry could not be replaced;
+// callers should fall back to loading the library without the cache.
+//
+// The cache directory is trusted: entries are verified when resolved but a
+// process with write access to the directory could still replace them between
+// resolution and use.
+iree_status_t iree_hal_system_library_cache_resolve(
+    iree_string_view_t cache_path, iree_const_byte_span_t library_data,
+    iree_allocator_t host_allocator, char** out_file_path,
+    iree_hal_system_library_cache_result_t* out_result);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif  // IREE_HAL_LOCAL_LOADERS_SYSTEM_LIBRARY_CACHE_H_
@@ -0,0 +1,120 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/hal/local/loaders/system_library_cache.h"
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+#include "iree/base/internal/file_io.h"
+#include "iree/testing/gtest.h"
+#include "iree/testing/status_matchers.h"
+
+namespace {
+
+class SystemLibraryCacheTest : public ::testing::Test {
+ protected:
+  static iree_string_view_t GetCachePath() {
+    char* test_tmpdir = getenv("TEST_TMPDIR");
+    if (!test_tmpdir) {
+      test_tmpdir = getenv("TMPDIR");
+    }
+    if (!test_tmpdir) {
+      test_tmpdir = getenv("TEMP");
+    }
+    if (!test_tmpdir) {
+      std::cerr << "TEST_TMPDIR/TMPDIR/TEMP not defined\n";
+      exit(1);
+    }
+    return iree_make_cstring_view(test_tmpdir);
+  }
+
+  // Returns library contents unique to the running test so that tests sharing
+  // a temp directory never resolve to each other's entries.
+  static std::string MakeLibraryData() {
+    const auto* test_info =
+        ::testing::UnitTest::GetInstance()->current_test_info();
+    return std::string("fake library for ") + test_info->name() +
+           std::string(1024, 'x');
+  }
+
+  static iree_const_byte_span_t AsSpan(const std::string& data) {
+    return iree_make_const_byte_span(data.data(), data.size());
+  }
+
+  // Resolves |data| in the cache and returns the path of the entry.
+  static std::string Resolve(const std::string& data,
+                             iree_hal_system_library_cache_result_t* result) {
+    char* file_path = NULL;
+    IREE_CHECK_OK(iree_hal_system_library_cache_resolve(
+        GetCachePath(), AsSpan(data), iree_allocator_system(), &file_path,
+        result));
+    std::string path = file_path;
+    iree_allocator_free(iree_allocator_system(), file_path);
+    return path;
+  }
+
+  static std::string ReadFile(const std::string& path) {
+    iree_file_contents_t* contents = NULL;
+    IREE_CHECK_OK(iree_file_read_contents(path.c_str(),
+                                          IREE_FILE_READ_FLAG_DEFAULT,
+                                          iree_allocator_system(), &contents));
+    std::string data(reinterpret_cast<const char*>(contents->const_buffer.data),
+                     contents->const_buffer.data_length);
+    iree_file_contents_free(contents);
+    return data;
+  }
+};
+
+TEST_F(SystemLibraryCacheTest, MissThenHit) {
+  std::string data = MakeLibraryData();
+  iree_hal_system_library_cache_result_t result;
+  // Drop any entry left behind by a previous run.
+  remove(Resolve(data, &result).c_str());
+
+  std::string path = Resolve(data, &result);
+  EXPECT_EQ(result, IREE_HAL_SYSTEM_LIBRARY_CACHE_RESULT_MISS);
+  EXPECT_EQ(ReadFile(path), data);
+
+  std::string hit_path = Resolve(data, &result);
+  EXPECT_EQ(result, IREE_HAL_SYSTEM_LIBRARY_CACHE_RESULT_HIT);
+  EXPECT_EQ(hit_path, path);
+  EXPECT_EQ(ReadFile(hit_path), data);
+}
+
+TEST_F(SystemLibraryCacheTest, TruncatedEntryIsReplaced) {
+  std::string data = MakeLibraryData();
+  iree_hal_system_library_cache_result_t result;
+  std::string path = Resolve(data, &result);
+
+  std::string truncated = data.substr(0, data.size() / 2);
+  IREE_ASSERT_OK(iree_file_write_contents(path.c_str(), AsSpan(truncated)));
+
+  EXPECT_EQ(Resolve(data, &result), path);
+  EXPECT_EQ(result, IREE_HAL_SYSTEM_LIBRARY_CACHE_RESULT_REPLACED);
+  EXPECT_EQ(ReadFile(path), data);
+
+  Resolve(data, &result);
+  EXPECT_EQ(result, IREE_HAL_SYSTEM_LIBRARY_CACHE_RESULT_HIT);
+}
+
+TEST_F(SystemLibraryCacheTest, CorruptedEntryIsReplaced) {
+  std::string data = MakeLibraryData();
+  iree_hal_system_library_cache_result_t result;
+  std::string path = Resolve(data, &result);
+
+  // Same length as the real library so only a content comparison catches it.
+  std::string corrupted = data;
+  corrupted[corrupted.size() / 2] ^= 0xFF;
+  IREE_ASSERT_OK(iree_file_write_contents(path.c_str(), AsSpan(corrupted)));
+
+  EXPECT_EQ(Resolve(data, &result), path);
+  EXPECT_EQ(result, IREE_HAL_SYSTEM_LIBRARY_CACHE_RESULT_REPLACED);
+  EXPECT_EQ(ReadFile(path), data);
+}
+
+}  // namespace
@@ -15,6 +15,7 @@
 #include "iree/hal/local/executable_library.h"
 #include "iree/hal/local/executable_library_util.h"
 #include "iree/hal/local/executable_plugin_manager.h"
+#include "iree/hal/local/loaders/system_library_cache.h"
 #include "iree/hal/local/local_executable.h"
 
 //===----------------------------------------------------------------------===//
@@ -70,6 +71,34 @@ iree_hal_system_executable_try_query_footer(
   return footer;
 }
 
+//===----------------------------------------------------------------------===//
+// Persistent library cache
+//===----------------------------------------------------------------------===//
+
+// Loads |library_data| from the persistent cache in |cache_path|, populating
+// the cache if needed. Falls back to loading from memory if the cache entry
+// cannot be made to match |library_data|.
+static iree_status_t iree_hal_system_library_cache_load(
+    iree_string_view_t cache_path, iree_const_byte_span_t library_data,
+    iree_allocator_t host_allocator, iree_dynamic_library_t** out_library) {
+  char* file_path = NULL;
+  iree_hal_system_library_cache_result_t result =
+      IREE_HAL_SYSTEM_LIBRARY_CACHE_RESULT_MISS;
+  iree_status_t status = iree_hal_system_library_cache_resolve(
+      cache_path, library_data, host_allocator, &file_path, &result);
+  if (iree_status_is_data_loss(status)) {
+    iree_status_ignore(status);
+    return iree_dynamic_library_load_from_memory(
+        iree_make_cstring_view("aot"), library_data,
+        IREE_DYNAMIC_LIBRARY_FLAG_NONE, host_allocator, out_library);
+  }
+  IREE_RETURN_IF_ERROR(status);
+  status = iree_dynamic_library_load_from_file(
+      file_path, IREE_DYNAMIC_LIBRARY_FLAG_NONE, host_allocator, out_library);
+  iree_allocator_free(host_allocator, file_path);
+  return status;
+}
+
 //===----------------------------------------------------------------------===//
 // iree_hal_system_executable_t
 //===----------------------------------------------------------------------===//
@@ -97,10 +126,12 @@ static const iree_hal_local_executable_vtable_t
 
 // Loads the executable and optional debug database from the given
 // |executable_data| in memory. The memory must remain live for the lifetime
-// of the executable.
+// of the executable. If |cache_path| is not empty the library is loaded from
+// the persistent cache in that directory.
 static iree_status_t iree_hal_system_executable_load(
     iree_hal_system_executable_t* executable,
-    iree_const_byte_span_t executable_data, iree_allocator_t host_allocator) {
+    iree_const_byte_span_t executable_data, iree_string_view_t cache_path,
+    iree_allocator_t host_allocator) {
   // Check to see if the library has a footer indicating embedded debug data.
   iree_const_byte_span_t library_data = iree_make_const_byte_span(NULL, 0);
   iree_const_byte_span_t debug_data = iree_make_const_byte_span(NULL, 0);
@@ -125,9 +156,14 @@ static iree_status_t iree_hal_system_executable_load(
     library_data = executable_data;
   }
 
-  IREE_RETURN_IF_ERROR(iree_dynamic_library_load_from_memory(
-      iree_make_cstring_view("aot"), library_data,
-      IREE_DYNAMIC_LIBRARY_FLAG_NONE, host_allocator, &executable->handle));
+  if (!iree_string_view_is_empty(cache_path)) {
+    IREE_RETURN_IF_ERROR(iree_hal_system_library_cache_load(
+        cache_path, library_data, host_allocator, &executable->handle));
+  } else {
+    IREE_RETURN_IF_ERROR(iree_dynamic_library_load_from_memory(
+        iree_make_cstring_view("aot"), library_data,
+        IREE_DYNAMIC_LIBRARY_FLAG_NONE, host_allocator, &executable->handle));
+  }
 
   if (debug_data.data_length > 0) {
     IREE_RETURN_IF_ERROR(iree_dynamic_library_attach_symbols_from_memory(
@@ -201,6 +237,7 @@ static iree_status_t iree_hal_system_executable_query_library(
 
   executable->identifier = iree_make_cstring_view(header->name);
   executable->base.dispatch_attrs = executable->library.v0->exports.attrs;
+  executable->base.export_names = executable->library.v0->exports.names;
   return iree_ok_status();
 }
 
@@ -213,7 +250,8 @@ static int iree_hal_system_executable_import_thunk_v0(
 static iree_status_t iree_hal_system_executable_create(
     const iree_hal_executable_params_t* executable_params,
     const iree_hal_executable_import_provider_t import_provider,
-    iree_allocator_t host_allocator, iree_hal_executable_t** out_executable) {
+    iree_string_view_t cache_path, iree_allocator_t host_allocator,
+    iree_hal_executable_t** out_executable) {
   IREE_ASSERT_ARGUMENT(executable_params);
   IREE_ASSERT_ARGUMENT(executable_params->executable_data.data &&
                        executable_params->executable_data.data_length);
@@ -255,7 +293,8 @@ static iree_status_t iree_hal_system_executable_create(
   // Attempt to extract the embedded library and load it.
   if (iree_status_is_ok(status)) {
     status = iree_hal_system_executable_load(
-        executable, executable_params->executable_data, host_allocator);
+        executable, executable_params->executable_data, cache_path,
+        host_allocator);
   }
 
   // Query metadata and get the entry point function pointers.
@@ -349,28 +388,53 @@ typedef struct iree_hal_system_library_loader_t {
   iree_hal_executable_loader_t base;
   iree_allocator_t host_allocator;
   iree_hal_executable_plugin_manager_t* plugin_manager;
+  // Optional persistent cache directory; stored inline after the loader.
+  iree_string_view_t cache_path;
 } iree_hal_system_library_loader_t;
 
 static const iree_hal_executable_loader_vtable_t
     iree_hal_system_library_loader_vtable;
 
+void iree_hal_system_library_loader_params_initialize(
+    iree_hal_system_library_loader_params_t* out_params) {
+  IREE_ASSERT_ARGUMENT(out_params);
+  memset(out_params, 0, sizeof(*out_params));
+}
+
 iree_status_t iree_hal_system_library_loader_create(
     iree_hal_executable_plugin_manager_t* plugin_manager,
     iree_allocator_t host_allocator,
     iree_hal_executable_loader_t** out_executable_loader) {
+  iree_hal_system_library_loader_params_t params;
+  iree_hal_system_library_loader_params_initialize(&params);
+  return iree_hal_system_library_loader_create_with_params(
+      &params, plugin_manager, host_allocator, out_executable_loader);
+}
+
+iree_status_t iree_hal_system_library_loader_create_with_params(
+    const iree_hal_system_library_loader_params_t* params,
+    iree_hal_executable_plugin_manager_t* plugin_manager,
+    iree_allocator_t host_allocator,
+    iree_hal_executable_loader_t** out_executable_loader) {
+  IREE_ASSERT_ARGUMENT(params);
   IREE_ASSERT_ARGUMENT(out_executable_loader);
   *out_executable_loader = NULL;
   IREE_TRACE_ZONE_BEGIN(z0);
 
   iree_hal_system_library_loader_t* executable_loader = NULL;
-  iree_status_t status = iree_allocator_malloc(
-      host_allocator, sizeof(*executable_loader), (void**)&executable_loader);
+  iree_host_size_t total_size =
+      sizeof(*executable_loader) + params->cache_path.size;
+  iree_status_t status = iree_allocator_malloc(host_allocator, total_size,
+                                               (void**)&executable_loader);
   if (iree_status_is_ok(status)) {
     iree_hal_executable_loader_initialize(
         &iree_hal_system_library_loader_vtable,
         iree_hal_executable_plugin_manager_provider(plugin_manager),
         &executable_loader->base);
     executable_loader->host_allocator = host_allocator;
+    iree_string_view_append_to_buffer(
+        params->cache_path, &executable_loader->cache_path,
+        (char*)executable_loader + sizeof(*executable_loader));
     executable_loader->plugin_manager = plugin_manager;
     iree_hal_executable_plugin_manager_retain(
         executable_loader->plugin_manager);
@@ -421,11 +485,19 @@ static iree_status_t iree_hal_system_library_loader_try_load(
       (iree_hal_system_library_loader_t*)base_executable_loader;
   IREE_TRACE_ZONE_BEGIN(z0);
 
+  // Only use the persistent cache if the caller allows it.
+  iree_string_view_t cache_path = iree_string_view_empty();
+  if (iree_all_bits_set(
+          executable_params->caching_mode,
+          IREE_HAL_EXECUTABLE_CACHING_MODE_ALLOW_PERSISTENT_CACHING)) {
+    cache_path = executable_loader->cache_path;
+  }
+
   // Perform the load (and requisite disgusting hackery).
   IREE_RETURN_AND_END_ZONE_IF_ERROR(
       z0, iree_hal_system_executable_create(
               executable_params, base_executable_loader->import_provider,
-              executable_loader->host_allocator, out_executable));
+              cache_path, executable_loader->host_allocator, out_executable));
 
   IREE_TRACE_ZONE_END(z0);
   return iree_ok_status();
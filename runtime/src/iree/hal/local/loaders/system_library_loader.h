@@ -20,6 +20,30 @@ extern "C" {
 typedef struct iree_hal_executable_plugin_manager_t
     iree_hal_executable_plugin_manager_t;
 
+// Parameters for configuring an iree_hal_system_library_loader_t.
+// Must be initialized with iree_hal_system_library_loader_params_initialize
+// prior to use.
+typedef struct iree_hal_system_library_loader_params_t {
+  // Optional directory used to persist libraries extracted from executable
+  // data. When set the libraries are written into the directory using a name
+  // derived from their contents and subsequent loads of the same executable
+  // (in this or any future process) will load the existing file instead of
+  // writing a new temporary file. The directory must exist and be writable if
+  // it is not already populated.
+  //
+  // Caches can be pre-warmed by running the programs once with the same cache
+  // directory (for example when building a container image) and then shipping
+  // the directory.
+  //
+  // Only executables prepared with
+  // IREE_HAL_EXECUTABLE_CACHING_MODE_ALLOW_PERSISTENT_CACHING use the cache.
+  iree_string_view_t cache_path;
+} iree_hal_system_library_loader_params_t;
+
+// Initializes |out_params| to the default values.
+void iree_hal_system_library_loader_params_initialize(
+    iree_hal_system_library_loader_params_t* out_params);
+
 // Creates an executable loader that can load files from platform-supported
 // dynamic libraries (such as .dylib on darwin, .so on linux, .dll on windows).
 //
@@ -31,6 +55,14 @@ iree_status_t iree_hal_system_library_loader_create(
     iree_allocator_t host_allocator,
     iree_hal_executable_loader_t** out_executable_loader);
 
+// Creates an executable loader as with iree_hal_system_library_loader_create
+// using the provided |params|.
+iree_status_t iree_hal_system_library_loader_create_with_params(
+    const iree_hal_system_library_loader_params_t* params,
+    iree_hal_executable_plugin_manager_t* plugin_manager,
+    iree_allocator_t host_allocator,
+    iree_hal_executable_loader_t** out_executable_loader);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif  // __cplusplus
@@ -35,6 +35,10 @@ typedef struct iree_hal_local_executable_t {
   // of memory required by the function.
   const iree_hal_executable_dispatch_attrs_v0_t* dispatch_attrs;
 
+  // Optional export names indexed by entry point ordinal, used for profiling.
+  // Populated by the parent type when the library provides them.
+  const char* const* export_names;
+
   // Execution environment.
   iree_hal_executable_environment_v0_t environment;
 } iree_hal_local_executable_t;
@@ -47,6 +51,10 @@ typedef struct iree_hal_local_executable_vtable_t {
       const iree_hal_executable_dispatch_state_v0_t* dispatch_state,
       const iree_hal_executable_workgroup_state_v0_t* workgroup_state,
       uint32_t worker_id);
+
+  // Optional; executables that omit this are always ready.
+  iree_status_t(IREE_API_PTR* query_ready)(
+      iree_hal_local_executable_t* executable);
 } iree_hal_local_executable_vtable_t;
 
 // Initializes the local executable base type.
@@ -67,6 +75,15 @@ void iree_hal_local_executable_deinitialize(
 iree_hal_local_executable_t* iree_hal_local_executable_cast(
     iree_hal_executable_t* base_value);
 
+// Returns OK if |executable| has been fully prepared, the preparation failure
+// if it failed, and IREE_STATUS_FAILED_PRECONDITION if it is still being
+// prepared. Never blocks. Executables being prepared asynchronously (see
+// iree_hal_executable_cache_prepare_executable_async) only populate their
+// dispatch_attrs and environment once ready and callers must check before
+// accessing them or issuing calls.
+iree_status_t iree_hal_local_executable_query_ready(
+    iree_hal_local_executable_t* executable);
+
 iree_status_t iree_hal_local_executable_issue_call(
     iree_hal_local_executable_t* executable, iree_host_size_t ordinal,
     const iree_hal_executable_dispatch_state_v0_t* dispatch_state,
@@ -8,11 +8,16 @@
 
 #include <stdbool.h>
 #include <stddef.h>
+#include <string.h>
+
+#include "iree/base/internal/atomics.h"
+#include "iree/hal/local/local_executable.h"
 
 typedef struct iree_hal_local_executable_cache_t {
   iree_hal_resource_t resource;
   iree_allocator_t host_allocator;
   iree_string_view_t identifier;
+  iree_loop_t loop;
   iree_host_size_t worker_capacity;
   iree_host_size_t loader_count;
   iree_hal_executable_loader_t* loaders[];
@@ -28,9 +33,9 @@ static iree_hal_local_executable_cache_t* iree_hal_local_executable_cache_cast(
 }
 
 iree_status_t iree_hal_local_executable_cache_create(
-    iree_string_view_t identifier, iree_host_size_t worker_capacity,
-    iree_host_size_t loader_count, iree_hal_executable_loader_t** loaders,
-    iree_allocator_t host_allocator,
+    iree_string_view_t identifier, iree_loop_t loop,
+    iree_host_size_t worker_capacity, iree_host_size_t loader_count,
+    iree_hal_executable_loader_t** loaders, iree_allocator_t host_allocator,
     iree_hal_executable_cache_t** out_executable_cache) {
   IREE_ASSERT_ARGUMENT(!loader_count || loaders);
   IREE_ASSERT_ARGUMENT(out_executable_cache);
@@ -51,6 +56,7 @@ iree_status_t iree_hal_local_executable_cache_create(
     iree_string_view_append_to_buffer(
         identifier, &executable_cache->identifier,
         (char*)executable_cache + total_size - identifier.size);
+    executable_cache->loop = loop;
     executable_cache->worker_capacity = worker_capacity;
 
     executable_cache->loader_count = loader_count;
@@ -131,6 +137,302 @@ static iree_status_t iree_hal_local_executable_cache_prepare_executable(
       executable_params->executable_format.data);
 }
 
+//===----------------------------------------------------------------------===//
+// iree_hal_local_pending_executable_t
+//===----------------------------------------------------------------------===//
+
+typedef enum iree_hal_local_pending_executable_state_e {
+  IREE_HAL_LOCAL_PENDING_EXECUTABLE_STATE_PENDING = 0,
+  IREE_HAL_LOCAL_PENDING_EXECUTABLE_STATE_READY = 1,
+  IREE_HAL_LOCAL_PENDING_EXECUTABLE_STATE_FAILED = 2,
+} iree_hal_local_pending_executable_state_t;
+
+// An executable returned from asynchronous preparation. It is usable as a
+// handle immediately and forwards to the loaded executable once preparation
+// completes. The pipeline layouts are available immediately while the dispatch
+// attributes and environment are copied from the loaded executable before the
+// pending executable transitions to ready. Nothing waits on the transition:
+// callers observe it through the preparation fence.
+typedef struct iree_hal_local_pending_executable_t {
+  iree_hal_local_executable_t base;
+  // iree_hal_local_pending_executable_state_t; stored with release order once
+  // |target| or |status| have been set.
+  iree_atomic_int32_t state;
+  // Loaded executable; valid once the state is READY.
+  iree_hal_executable_t* target;
+  // Preparation failure; valid once the state is FAILED.
+  iree_status_t status;
+  iree_hal_pipeline_layout_t* pipeline_layouts[];
+} iree_hal_local_pending_executable_t;
+
+static const iree_hal_local_executable_vtable_t
+    iree_hal_local_pending_executable_vtable;
+
+static iree_hal_local_pending_executable_t*
+iree_hal_local_pending_executable_cast(iree_hal_executable_t* base_value) {
+  IREE_HAL_ASSERT_TYPE(base_value, &iree_hal_local_pending_executable_vtable);
+  return (iree_hal_local_pending_executable_t*)base_value;
+}
+
+static iree_status_t iree_hal_local_pending_executable_create(
+    const iree_hal_executable_params_t* executable_params,
+    iree_allocator_t host_allocator,
+    iree_hal_local_pending_executable_t** out_executable) {
+  iree_hal_local_pending_executable_t* executable = NULL;
+  iree_host_size_t total_size =
+      sizeof(*executable) + executable_params->pipeline_layout_count *
+                                sizeof(*executable->pipeline_layouts);
+  IREE_RETURN_IF_ERROR(
+      iree_allocator_malloc(host_allocator, total_size, (void**)&executable));
+  iree_hal_local_executable_initialize(
+      &iree_hal_local_pending_executable_vtable,
+      executable_params->pipeline_layout_count,
+      executable_params->pipeline_layouts, executable->pipeline_layouts,
+      host_allocator, &executable->base);
+  iree_atomic_store_int32(&executable->state,
+                          IREE_HAL_LOCAL_PENDING_EXECUTABLE_STATE_PENDING,
+                          iree_memory_order_relaxed);
+  executable->target = NULL;
+  executable->status = iree_ok_status();
+  *out_executable = executable;
+  return iree_ok_status();
+}
+
+static void iree_hal_local_pending_executable_destroy(
+    iree_hal_executable_t* base_executable) {
+  iree_hal_local_pending_executable_t* executable =
+      iree_hal_local_pending_executable_cast(base_executable);
+  iree_allocator_t host_allocator = executable->base.host_allocator;
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  // Preparation retains the executable so we can't get here while pending.
+  iree_hal_executable_release(executable->target);
+  iree_status_ignore(executable->status);
+  iree_hal_local_executable_deinitialize(&executable->base);
+  iree_allocator_free(host_allocator, executable);
+
+  IREE_TRACE_ZONE_END(z0);
+}
+
+// Completes preparation of |executable| with either the loaded |target| or a
+// failure |status|. Takes ownership of both.
+static void iree_hal_local_pending_executable_complete(
+    iree_hal_local_pending_executable_t* executable,
+    iree_hal_executable_t* target, iree_status_t status) {
+  iree_hal_local_pending_executable_state_t state =
+      IREE_HAL_LOCAL_PENDING_EXECUTABLE_STATE_FAILED;
+  if (iree_status_is_ok(status)) {
+    iree_hal_local_executable_t* local_target =
+        iree_hal_local_executable_cast(target);
+    executable->target = target;
+    executable->base.dispatch_attrs = local_target->dispatch_attrs;
+    executable->base.export_names = local_target->export_names;
+    executable->base.environment = local_target->environment;
+    state = IREE_HAL_LOCAL_PENDING_EXECUTABLE_STATE_READY;
+  } else {
+    iree_hal_executable_release(target);
+    executable->status = status;
+  }
+  iree_atomic_store_int32(&executable->state, state,
+                          iree_memory_order_release);
+}
+
+static iree_status_t iree_hal_local_pending_executable_query_ready(
+    iree_hal_local_executable_t* base_executable) {
+  iree_hal_local_pending_executable_t* executable =
+      (iree_hal_local_pending_executable_t*)base_executable;
+  switch (iree_atomic_load_int32(&executable->state,
+                                 iree_memory_order_acquire)) {
+    case IREE_HAL_LOCAL_PENDING_EXECUTABLE_STATE_READY:
+      return iree_ok_status();
+    case IREE_HAL_LOCAL_PENDING_EXECUTABLE_STATE_FAILED:
+      return iree_status_clone(executable->status);
+    default:
+      return iree_make_status(IREE_STATUS_FAILED_PRECONDITION,
+                              "executable is still being prepared; wait on "
+                              "the preparation fence before using it");
+  }
+}
+
+static iree_status_t iree_hal_local_pending_executable_issue_call(
+    iree_hal_local_executable_t* base_executable, iree_host_size_t ordinal,
+    const iree_hal_executable_dispatch_state_v0_t* dispatch_state,
+    const iree_hal_executable_workgroup_state_v0_t* workgroup_state,
+    uint32_t worker_id) {
+  iree_hal_local_pending_executable_t* executable =
+      (iree_hal_local_pending_executable_t*)base_executable;
+  IREE_RETURN_IF_ERROR(
+      iree_hal_local_pending_executable_query_ready(base_executable));
+  return iree_hal_local_executable_issue_call(
+      iree_hal_local_executable_cast(executable->target), ordinal,
+      dispatch_state, workgroup_state, worker_id);
+}
+
+static const iree_hal_local_executable_vtable_t
+    iree_hal_local_pending_executable_vtable = {
+        .base =
+            {
+                .destroy = iree_hal_local_pending_executable_destroy,
+            },
+        .issue_call = iree_hal_local_pending_executable_issue_call,
+        .query_ready = iree_hal_local_pending_executable_query_ready,
+};
+
+//===----------------------------------------------------------------------===//
+// Asynchronous preparation
+//===----------------------------------------------------------------------===//
+
+// State for an in-flight asynchronous preparation. Owns copies of any
+// parameters that are not guaranteed to outlive the request.
+typedef struct iree_hal_local_executable_preparation_t {
+  iree_allocator_t host_allocator;
+  iree_hal_executable_cache_t* executable_cache;
+  iree_hal_local_pending_executable_t* executable;
+  iree_hal_fence_t* signal_fence;
+  // References the copied storage following this struct and the pipeline
+  // layouts retained by |executable|.
+  iree_hal_executable_params_t params;
+} iree_hal_local_executable_preparation_t;
+
+static iree_status_t iree_hal_local_executable_preparation_run(
+    void* user_data, iree_loop_t loop, iree_status_t status) {
+  iree_hal_local_executable_preparation_t* preparation =
+      (iree_hal_local_executable_preparation_t*)user_data;
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  // Load the executable; |status| is only non-OK if the loop is failing.
+  iree_hal_executable_t* target = NULL;
+  if (iree_status_is_ok(status)) {
+    status = iree_hal_local_executable_cache_prepare_executable(
+        preparation->executable_cache, &preparation->params, &target);
+  }
+
+  if (preparation->signal_fence) {
+    if (iree_status_is_ok(status)) {
+      iree_status_ignore(iree_hal_fence_signal(preparation->signal_fence));
+    } else {
+      iree_hal_fence_fail(preparation->signal_fence, iree_status_clone(status));
+    }
+    iree_hal_fence_release(preparation->signal_fence);
+  }
+  iree_hal_local_pending_executable_complete(preparation->executable, target,
+                                             status);
+
+  iree_hal_executable_release((iree_hal_executable_t*)preparation->executable);
+  iree_hal_executable_cache_release(preparation->executable_cache);
+  iree_allocator_free(preparation->host_allocator, preparation);
+
+  IREE_TRACE_ZONE_END(z0);
+  return iree_ok_status();
+}
+
+static iree_status_t iree_hal_local_executable_cache_prepare_executable_async(
+    iree_hal_executable_cache_t* base_executable_cache,
+    const iree_hal_executable_params_t* executable_params,
+    iree_hal_fence_t* signal_fence, iree_hal_executable_t** out_executable) {
+  iree_hal_local_executable_cache_t* executable_cache =
+      iree_hal_local_executable_cache_cast(base_executable_cache);
+  iree_allocator_t host_allocator = executable_cache->host_allocator;
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  // Fail early if no loader could possibly handle the executable so that
+  // callers get a synchronous error for obviously unsupported formats.
+  if (!iree_hal_local_executable_cache_can_prepare_format(
+          base_executable_cache, executable_params->caching_mode,
+          executable_params->executable_format)) {
+    IREE_TRACE_ZONE_END(z0);
+    return iree_make_status(IREE_STATUS_NOT_FOUND,
+                            "no executable loader registered for the given "
+                            "executable format '%.*s'",
+                            (int)executable_params->executable_format.size,
+                            executable_params->executable_format.data);
+  }
+
+  // Copy the parameters that may not outlive this call. The executable data is
+  // always copied, even when the caller requested aliasing: nothing retains
+  // the caller's storage while preparation is in flight.
+  iree_host_size_t constants_size =
+      executable_params->constant_count * sizeof(*executable_params->constants);
+  iree_host_size_t data_size = executable_params->executable_data.data_length;
+  iree_hal_local_executable_preparation_t* preparation = NULL;
+  iree_host_size_t total_size =
+      iree_host_align(sizeof(*preparation), iree_max_align_t) +
+      iree_host_align(constants_size, iree_max_align_t) + data_size +
+      executable_params->executable_format.size;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0,
+      iree_allocator_malloc(host_allocator, total_size, (void**)&preparation));
+  preparation->host_allocator = host_allocator;
+  preparation->params = *executable_params;
+  // The copy is released when preparation completes so loaders must not
+  // alias it into the executable.
+  preparation->params.caching_mode &=
+      ~IREE_HAL_EXECUTABLE_CACHING_MODE_ALIAS_PROVIDED_DATA;
+  uint8_t* storage_ptr =
+      (uint8_t*)preparation +
+      iree_host_align(sizeof(*preparation), iree_max_align_t);
+  if (constants_size > 0) {
+    memcpy(storage_ptr, executable_params->constants, constants_size);
+    preparation->params.constants = (const uint32_t*)storage_ptr;
+    storage_ptr += iree_host_align(constants_size, iree_max_align_t);
+  }
+  if (data_size > 0) {
+    memcpy(storage_ptr, executable_params->executable_data.data, data_size);
+    preparation->params.executable_data =
+        iree_make_const_byte_span(storage_ptr, data_size);
+    storage_ptr += data_size;
+  }
+  iree_string_view_append_to_buffer(executable_params->executable_format,
+                                    &preparation->params.executable_format,
+                                    (char*)storage_ptr);
+
+  iree_hal_local_pending_executable_t* executable = NULL;
+  iree_status_t status = iree_hal_local_pending_executable_create(
+      executable_params, host_allocator, &executable);
+  if (!iree_status_is_ok(status)) {
+    iree_allocator_free(host_allocator, preparation);
+    IREE_TRACE_ZONE_END(z0);
+    return status;
+  }
+  preparation->params.pipeline_layouts = executable->base.pipeline_layouts;
+
+  // The preparation keeps everything it touches alive until it completes.
+  preparation->executable_cache = base_executable_cache;
+  iree_hal_executable_cache_retain(base_executable_cache);
+  preparation->executable = executable;
+  iree_hal_executable_retain((iree_hal_executable_t*)executable);
+  preparation->signal_fence = signal_fence;
+  iree_hal_fence_retain(signal_fence);
+
+  // Schedule the preparation on the loop the cache was created with. If the
+  // loop is unable to accept the work (or there is no loop) we prepare
+  // synchronously on the caller.
+  status = iree_loop_call(executable_cache->loop, IREE_LOOP_PRIORITY_DEFAULT,
+                          iree_hal_local_executable_preparation_run,
+                          preparation);
+  if (!iree_status_is_ok(status)) {
+    iree_status_ignore(status);
+    status = iree_hal_local_executable_preparation_run(
+        preparation, executable_cache->loop, iree_ok_status());
+  }
+
+  // Inline loops (and the fallback above) have completed preparation by now
+  // so any failure is reported to the caller here instead of at first use.
+  if (iree_status_is_ok(status) &&
+      iree_atomic_load_int32(&executable->state, iree_memory_order_acquire) ==
+          IREE_HAL_LOCAL_PENDING_EXECUTABLE_STATE_FAILED) {
+    status = iree_status_clone(executable->status);
+  }
+
+  if (iree_status_is_ok(status)) {
+    *out_executable = (iree_hal_executable_t*)executable;
+  } else {
+    iree_hal_executable_release((iree_hal_executable_t*)executable);
+  }
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
 static const iree_hal_executable_cache_vtable_t
     iree_hal_local_executable_cache_vtable = {
         .destroy = iree_hal_local_executable_cache_destroy,
@@ -138,4 +440,6 @@ static const iree_hal_executable_cache_vtable_t
             iree_hal_local_executable_cache_can_prepare_format,
         .prepare_executable =
             iree_hal_local_executable_cache_prepare_executable,
+        .prepare_executable_async =
+            iree_hal_local_executable_cache_prepare_executable_async,
 };
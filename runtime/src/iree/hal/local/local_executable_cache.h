@@ -23,10 +23,19 @@ extern "C" {
 // one device is the same JIT'ed executable in another, and in multi-tenant
 // situations we're likely to want that isolation _and_ sharing.
 
+// Creates an executable cache that loads executables with the first of
+// |loaders| that supports them.
+//
+// |loop| is used to schedule asynchronous preparation requests made with
+// iree_hal_executable_cache_prepare_executable_async and must remain valid for
+// the lifetime of the cache and all pending preparations. If the loop cannot
+// accept work preparation happens synchronously on the caller. Preparation
+// failures are returned from the prepare call when the loop has completed the
+// work before it returns (as inline loops do).
 iree_status_t iree_hal_local_executable_cache_create(
-    iree_string_view_t identifier, iree_host_size_t worker_capacity,
-    iree_host_size_t loader_count, iree_hal_executable_loader_t** loaders,
-    iree_allocator_t host_allocator,
+    iree_string_view_t identifier, iree_loop_t loop,
+    iree_host_size_t worker_capacity, iree_host_size_t loader_count,
+    iree_hal_executable_loader_t** loaders, iree_allocator_t host_allocator,
     iree_hal_executable_cache_t** out_executable_cache);
 
 #ifdef __cplusplus
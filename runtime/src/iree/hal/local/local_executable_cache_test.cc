@@ -0,0 +1,198 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/hal/local/local_executable_cache.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+#include <vector>
+
+#include "iree/base/api.h"
+#include "iree/hal/api.h"
+#include "iree/hal/local/executable_library_demo.h"
+#include "iree/hal/local/loaders/static_library_loader.h"
+#include "iree/hal/local/local_executable.h"
+#include "iree/testing/gtest.h"
+#include "iree/testing/status_matchers.h"
+
+namespace iree {
+namespace hal {
+namespace {
+
+using ::iree::testing::status::StatusIs;
+
+// A loop that defers all calls until explicitly drained by the test.
+struct DeferredLoop {
+  std::vector<iree_loop_callback_t> calls;
+
+  iree_loop_t loop() { return {this, DeferredLoop::Ctl}; }
+
+  static iree_status_t Ctl(void* self, iree_loop_command_t command,
+                           const void* params, void** inout_ptr) {
+    if (command != IREE_LOOP_COMMAND_CALL) {
+      return iree_make_status(IREE_STATUS_UNIMPLEMENTED);
+    }
+    auto* deferred_loop = reinterpret_cast<DeferredLoop*>(self);
+    deferred_loop->calls.push_back(
+        reinterpret_cast<const iree_loop_call_params_t*>(params)->callback);
+    return iree_ok_status();
+  }
+
+  void Drain() {
+    auto pending_calls = std::move(calls);
+    for (auto& callback : pending_calls) {
+      IREE_EXPECT_OK(callback.fn(callback.user_data, loop(), iree_ok_status()));
+    }
+  }
+};
+
+struct LocalExecutableCacheTest : public ::testing::Test {
+  iree_allocator_t host_allocator = iree_allocator_system();
+  iree_hal_executable_loader_t* loader = NULL;
+  DeferredLoop deferred_loop;
+
+  void SetUp() override {
+    const iree_hal_executable_library_query_fn_t library_query_fns[] = {
+        demo_executable_library_query,
+    };
+    IREE_ASSERT_OK(iree_hal_static_library_loader_create(
+        IREE_ARRAYSIZE(library_query_fns), library_query_fns,
+        iree_hal_executable_import_provider_null(), host_allocator, &loader));
+  }
+
+  void TearDown() override { iree_hal_executable_loader_release(loader); }
+
+  iree_hal_executable_cache_t* CreateCache(iree_loop_t loop) {
+    iree_hal_executable_cache_t* executable_cache = NULL;
+    IREE_CHECK_OK(iree_hal_local_executable_cache_create(
+        IREE_SV("test"), loop, /*worker_capacity=*/1, /*loader_count=*/1,
+        &loader, host_allocator, &executable_cache));
+    return executable_cache;
+  }
+
+  static iree_status_t PrepareAsync(iree_hal_executable_cache_t* cache,
+                                    const char* library_name,
+                                    iree_hal_executable_t** out_executable) {
+    iree_hal_executable_params_t executable_params;
+    iree_hal_executable_params_initialize(&executable_params);
+    executable_params.executable_format = IREE_SV("static");
+    executable_params.executable_data = iree_make_const_byte_span(
+        library_name, strlen(library_name));
+    return iree_hal_executable_cache_prepare_executable_async(
+        cache, &executable_params, /*signal_fence=*/NULL, out_executable);
+  }
+};
+
+// Tests that preparation is deferred to the loop and that the executable
+// becomes usable once it runs.
+TEST_F(LocalExecutableCacheTest, PrepareAsync) {
+  iree_hal_executable_cache_t* cache = CreateCache(deferred_loop.loop());
+
+  iree_hal_executable_t* executable = NULL;
+  IREE_ASSERT_OK(PrepareAsync(cache, "demo_library", &executable));
+  ASSERT_NE(executable, nullptr);
+  EXPECT_EQ(deferred_loop.calls.size(), 1);
+
+  // The executable must not be released before preparation completes.
+  iree_hal_executable_cache_release(cache);
+  deferred_loop.Drain();
+
+  iree_hal_local_executable_t* local_executable =
+      iree_hal_local_executable_cast(executable);
+  IREE_EXPECT_OK(iree_hal_local_executable_query_ready(local_executable));
+  EXPECT_NE(local_executable->dispatch_attrs, nullptr);
+
+  iree_hal_executable_release(executable);
+}
+
+// Tests that data provided with ALIAS_PROVIDED_DATA does not need to outlive
+// the prepare call as preparation may run after the caller has released it.
+TEST_F(LocalExecutableCacheTest, PrepareAsyncAliasedData) {
+  iree_hal_executable_cache_t* cache = CreateCache(deferred_loop.loop());
+
+  std::vector<char> library_name(std::begin("demo_library"),
+                                 std::end("demo_library") - 1);
+  iree_hal_executable_params_t executable_params;
+  iree_hal_executable_params_initialize(&executable_params);
+  executable_params.caching_mode |=
+      IREE_HAL_EXECUTABLE_CACHING_MODE_ALIAS_PROVIDED_DATA;
+  executable_params.executable_format = IREE_SV("static");
+  executable_params.executable_data =
+      iree_make_const_byte_span(library_name.data(), library_name.size());
+  iree_hal_executable_t* executable = NULL;
+  IREE_ASSERT_OK(iree_hal_executable_cache_prepare_executable_async(
+      cache, &executable_params, /*signal_fence=*/NULL, &executable));
+
+  // Release the caller storage before preparation runs.
+  std::fill(library_name.begin(), library_name.end(), 0);
+  library_name.clear();
+  library_name.shrink_to_fit();
+  deferred_loop.Drain();
+
+  iree_hal_local_executable_t* local_executable =
+      iree_hal_local_executable_cast(executable);
+  IREE_EXPECT_OK(iree_hal_local_executable_query_ready(local_executable));
+  EXPECT_NE(local_executable->dispatch_attrs, nullptr);
+
+  iree_hal_executable_release(executable);
+  iree_hal_executable_cache_release(cache);
+}
+
+// Tests that the executable cannot be used before preparation runs and that
+// preparation failures are reported once it has.
+TEST_F(LocalExecutableCacheTest, PrepareAsyncFailure) {
+  iree_hal_executable_cache_t* cache = CreateCache(deferred_loop.loop());
+
+  iree_hal_executable_t* executable = NULL;
+  IREE_ASSERT_OK(PrepareAsync(cache, "missing_library", &executable));
+  iree_hal_local_executable_t* local_executable =
+      iree_hal_local_executable_cast(executable);
+  EXPECT_THAT(Status(iree_hal_local_executable_query_ready(local_executable)),
+              StatusIs(StatusCode::kFailedPrecondition));
+
+  deferred_loop.Drain();
+  EXPECT_THAT(Status(iree_hal_local_executable_query_ready(local_executable)),
+              StatusIs(StatusCode::kNotFound));
+
+  iree_hal_executable_release(executable);
+  iree_hal_executable_cache_release(cache);
+}
+
+// Tests that failures are returned from the prepare call when the loop runs
+// preparation before the call returns.
+TEST_F(LocalExecutableCacheTest, PrepareAsyncFailureInline) {
+  iree_status_t loop_status = iree_ok_status();
+  iree_hal_executable_cache_t* cache =
+      CreateCache(iree_loop_inline(&loop_status));
+
+  iree_hal_executable_t* executable = NULL;
+  EXPECT_THAT(Status(PrepareAsync(cache, "missing_library", &executable)),
+              StatusIs(StatusCode::kNotFound));
+  EXPECT_EQ(executable, nullptr);
+
+  iree_hal_executable_cache_release(cache);
+  IREE_EXPECT_OK(loop_status);
+}
+
+// Tests that caches without a usable loop prepare synchronously.
+TEST_F(LocalExecutableCacheTest, PrepareAsyncWithoutLoop) {
+  iree_hal_executable_cache_t* cache = CreateCache(iree_loop_null());
+
+  iree_hal_executable_t* executable = NULL;
+  IREE_ASSERT_OK(PrepareAsync(cache, "demo_library", &executable));
+  iree_hal_local_executable_t* local_executable =
+      iree_hal_local_executable_cast(executable);
+  IREE_EXPECT_OK(iree_hal_local_executable_query_ready(local_executable));
+  EXPECT_NE(local_executable->dispatch_attrs, nullptr);
+
+  iree_hal_executable_release(executable);
+  iree_hal_executable_cache_release(cache);
+}
+
+}  // namespace
+}  // namespace hal
+}  // namespace iree
@@ -0,0 +1,786 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/hal/local/local_profiler.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "iree/base/internal/atomics.h"
+#include "iree/base/internal/synchronization.h"
+
+#if IREE_FILE_IO_ENABLE
+#include "iree/base/internal/file_io.h"
+#endif  // IREE_FILE_IO_ENABLE
+
+#if defined(IREE_PLATFORM_LINUX) || defined(IREE_PLATFORM_ANDROID)
+#define IREE_HAL_LOCAL_PROFILER_HAVE_PERF 1
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#else
+#define IREE_HAL_LOCAL_PROFILER_HAVE_PERF 0
+#endif  // IREE_PLATFORM_LINUX || IREE_PLATFORM_ANDROID
+
+// Maximum number of distinct exports recorded per worker. Must be a power of
+// two. Samples of exports past 3/4 of the capacity are dropped.
+#define IREE_HAL_LOCAL_PROFILER_WORKER_CAPACITY 256
+
+// NOTE: threading support is optional. Without thread-local storage threads
+// cannot be told apart and all samples go through the locked shared tables.
+#if IREE_SYNCHRONIZATION_DISABLE_UNSAFE
+#define IREE_HAL_LOCAL_PROFILER_THREAD_LOCAL
+#elif defined(__STDC_VERSION__) && (__STDC_VERSION__ >= 201102L) && \
+    !__STDC_NO_THREADS__
+#define IREE_HAL_LOCAL_PROFILER_THREAD_LOCAL _Thread_local
+#elif defined(IREE_COMPILER_MSVC)
+#define IREE_HAL_LOCAL_PROFILER_THREAD_LOCAL __declspec(thread)
+#endif  // IREE_SYNCHRONIZATION_DISABLE_UNSAFE
+
+// Returns a nonzero value identifying the calling thread among all live
+// threads or 0 if the calling thread cannot be identified.
+static intptr_t iree_hal_local_profiler_thread_identity(void) {
+#if defined(IREE_HAL_LOCAL_PROFILER_THREAD_LOCAL)
+  // Only the address matters; it is unique per live thread and needs no
+  // syscall to query.
+  static IREE_HAL_LOCAL_PROFILER_THREAD_LOCAL uint8_t marker = 0;
+  return (intptr_t)&marker;
+#else
+  return 0;
+#endif  // IREE_HAL_LOCAL_PROFILER_THREAD_LOCAL
+}
+
+//===----------------------------------------------------------------------===//
+// iree_hal_local_profiler_table_t
+//===----------------------------------------------------------------------===//
+
+// Accumulated samples of a single export on a single worker.
+// Values only ever have one writer at a time and are atomic so that flushes can
+// read them while they are being written without tearing.
+typedef struct iree_hal_local_profiler_entry_t {
+  // iree_hal_local_executable_t* or 0 if the entry is unused. Published with
+  // release order after |ordinal| is set. Retained until profiling ends so that
+  // the pointer cannot be reused by another executable while it keys the entry
+  // and its export names stay valid until the capture is written.
+  iree_atomic_intptr_t executable;
+  uint32_t ordinal;
+  iree_atomic_int64_t dispatch_count;
+  iree_atomic_int64_t workgroup_count;
+  iree_atomic_int64_t total_ns;
+  iree_atomic_int64_t binding_length;
+  iree_atomic_int64_t counters[IREE_HAL_LOCAL_PROFILE_COUNTER_COUNT];
+} iree_hal_local_profiler_entry_t;
+
+// Open-addressed table of entries keyed by executable and export ordinal.
+typedef struct iree_hal_local_profiler_table_t {
+  iree_atomic_int32_t entry_count;
+  iree_atomic_int64_t dropped_sample_count;
+  iree_hal_local_profiler_entry_t
+      entries[IREE_HAL_LOCAL_PROFILER_WORKER_CAPACITY];
+} iree_hal_local_profiler_table_t;
+
+// Adds |value| to |target|. Only valid from the single writer of |target| as
+// it is a plain load and store instead of a locked read-modify-write.
+static inline void iree_hal_local_profiler_accumulate(
+    iree_atomic_int64_t* target, uint64_t value) {
+  iree_atomic_store_int64(
+      target,
+      iree_atomic_load_int64(target, iree_memory_order_relaxed) +
+          (int64_t)value,
+      iree_memory_order_relaxed);
+}
+
+static void iree_hal_local_profiler_table_deinitialize(
+    iree_hal_local_profiler_table_t* table) {
+  for (iree_host_size_t i = 0; i < IREE_ARRAYSIZE(table->entries); ++i) {
+    iree_hal_executable_release((iree_hal_executable_t*)iree_atomic_load_intptr(
+        &table->entries[i].executable, iree_memory_order_acquire));
+  }
+}
+
+// Returns the entry for the export |ordinal| of |executable|, inserting it if
+// needed, or NULL if the table is out of storage. Must only be called by the
+// writer of |table|.
+static iree_hal_local_profiler_entry_t* iree_hal_local_profiler_table_lookup(
+    iree_hal_local_profiler_table_t* table,
+    iree_hal_local_executable_t* executable, uint32_t ordinal) {
+  const iree_host_size_t mask = IREE_HAL_LOCAL_PROFILER_WORKER_CAPACITY - 1;
+  uint64_t hash = ((uint64_t)(uintptr_t)executable >> 4) ^
+                  ((uint64_t)ordinal * 0x9E3779B97F4A7C15ull);
+  hash ^= hash >> 29;
+  for (iree_host_size_t i = (iree_host_size_t)hash & mask;;
+       i = (i + 1) & mask) {
+    iree_hal_local_profiler_entry_t* entry = &table->entries[i];
+    intptr_t entry_executable =
+        iree_atomic_load_intptr(&entry->executable, iree_memory_order_relaxed);
+    if (entry_executable == (intptr_t)executable && entry->ordinal == ordinal) {
+      return entry;
+    } else if (entry_executable) {
+      continue;
+    }
+    // Keep the table sparse enough for probing to stay short.
+    int32_t entry_count =
+        iree_atomic_load_int32(&table->entry_count, iree_memory_order_relaxed);
+    if (entry_count >= IREE_HAL_LOCAL_PROFILER_WORKER_CAPACITY / 4 * 3) {
+      return NULL;
+    }
+    iree_atomic_store_int32(&table->entry_count, entry_count + 1,
+                            iree_memory_order_relaxed);
+    entry->ordinal = ordinal;
+    iree_hal_executable_retain((iree_hal_executable_t*)executable);
+    iree_atomic_store_intptr(&entry->executable, (intptr_t)executable,
+                             iree_memory_order_release);
+    return entry;
+  }
+}
+
+// Accumulates a sample into |table|. Must only be called by the writer of
+// |table|.
+static void iree_hal_local_profiler_table_record(
+    iree_hal_local_profiler_table_t* table,
+    iree_hal_local_executable_t* executable, uint32_t ordinal,
+    uint32_t dispatch_count, uint32_t workgroup_count, uint64_t duration_ns,
+    uint64_t binding_length) {
+  iree_hal_local_profiler_entry_t* entry =
+      iree_hal_local_profiler_table_lookup(table, executable, ordinal);
+  if (!entry) {
+    iree_hal_local_profiler_accumulate(&table->dropped_sample_count, 1);
+    return;
+  }
+  iree_hal_local_profiler_accumulate(&entry->dispatch_count, dispatch_count);
+  iree_hal_local_profiler_accumulate(&entry->workgroup_count, workgroup_count);
+  iree_hal_local_profiler_accumulate(&entry->total_ns, duration_ns);
+  iree_hal_local_profiler_accumulate(&entry->binding_length, binding_length);
+}
+
+//===----------------------------------------------------------------------===//
+// iree_hal_local_profiler_worker_t
+//===----------------------------------------------------------------------===//
+
+typedef struct iree_hal_local_profiler_worker_t {
+  // Identity of the thread owning the worker slot (see
+  // iree_hal_local_profiler_thread_identity) or 0 if not yet claimed. The owner
+  // is the only writer of |table| and records into it without locking.
+  iree_atomic_intptr_t owner;
+  iree_hal_local_profiler_table_t table;
+
+  // Hardware counters opened by and only accessed from the owner thread.
+  bool counters_opened;
+  // Bitmask of iree_hal_local_profile_counter_t that opened successfully.
+  // Written once by the owner and read when writing captures.
+  iree_atomic_int32_t counter_mask;
+  // Group leader used to read all counters at once or -1 if none opened.
+  int counter_group_fd;
+  int counter_fds[IREE_HAL_LOCAL_PROFILE_COUNTER_COUNT];
+  // True between iree_hal_local_profiler_counters_begin and _end with
+  // |counter_base| holding the raw counter values read at the beginning.
+  bool counter_span_open;
+  uint64_t counter_base[IREE_HAL_LOCAL_PROFILE_COUNTER_COUNT];
+
+  // Samples from threads other than the owner that share the slot, such as an
+  // inline command buffer executed from multiple threads. Allocated on first
+  // use and written only with |shared_mutex| held.
+  iree_slim_mutex_t shared_mutex;
+  iree_hal_local_profiler_table_t* shared_table;
+  // Shared samples dropped because the shared table could not be allocated.
+  uint64_t shared_dropped_sample_count;
+} iree_hal_local_profiler_worker_t;
+
+static void iree_hal_local_profiler_worker_initialize(
+    iree_hal_local_profiler_worker_t* out_worker) {
+  memset(out_worker, 0, sizeof(*out_worker));
+  iree_slim_mutex_initialize(&out_worker->shared_mutex);
+  out_worker->counter_group_fd = -1;
+  for (iree_host_size_t i = 0; i < IREE_ARRAYSIZE(out_worker->counter_fds);
+       ++i) {
+    out_worker->counter_fds[i] = -1;
+  }
+}
+
+static void iree_hal_local_profiler_worker_deinitialize(
+    iree_hal_local_profiler_worker_t* worker, iree_allocator_t host_allocator) {
+#if IREE_HAL_LOCAL_PROFILER_HAVE_PERF
+  for (iree_host_size_t i = 0; i < IREE_ARRAYSIZE(worker->counter_fds); ++i) {
+    if (worker->counter_fds[i] >= 0) close(worker->counter_fds[i]);
+  }
+#endif  // IREE_HAL_LOCAL_PROFILER_HAVE_PERF
+  iree_hal_local_profiler_table_deinitialize(&worker->table);
+  if (worker->shared_table) {
+    iree_hal_local_profiler_table_deinitialize(worker->shared_table);
+    iree_allocator_free(host_allocator, worker->shared_table);
+  }
+  iree_slim_mutex_deinitialize(&worker->shared_mutex);
+}
+
+// Returns true if the calling thread owns |worker|, claiming it if unowned.
+static bool iree_hal_local_profiler_worker_claim(
+    iree_hal_local_profiler_worker_t* worker) {
+  const intptr_t identity = iree_hal_local_profiler_thread_identity();
+  if (!identity) return false;
+  intptr_t owner =
+      iree_atomic_load_intptr(&worker->owner, iree_memory_order_relaxed);
+  if (owner == identity) return true;
+  if (owner != 0) return false;
+  return iree_atomic_compare_exchange_strong_intptr(
+      &worker->owner, &owner, identity, iree_memory_order_acquire,
+      iree_memory_order_relaxed);
+}
+
+// Records a sample from a thread that does not own |worker|.
+static void iree_hal_local_profiler_worker_record_shared(
+    iree_hal_local_profiler_worker_t* worker, iree_allocator_t host_allocator,
+    iree_hal_local_executable_t* executable, uint32_t ordinal,
+    uint32_t dispatch_count, uint32_t workgroup_count, uint64_t duration_ns,
+    uint64_t binding_length) {
+  iree_slim_mutex_lock(&worker->shared_mutex);
+  if (!worker->shared_table) {
+    iree_status_t status =
+        iree_allocator_malloc(host_allocator, sizeof(*worker->shared_table),
+                              (void**)&worker->shared_table);
+    if (iree_status_is_ok(status)) {
+      memset(worker->shared_table, 0, sizeof(*worker->shared_table));
+    } else {
+      iree_status_ignore(status);
+    }
+  }
+  if (worker->shared_table) {
+    iree_hal_local_profiler_table_record(
+        worker->shared_table, executable, ordinal, dispatch_count,
+        workgroup_count, duration_ns, binding_length);
+  } else {
+    ++worker->shared_dropped_sample_count;
+  }
+  iree_slim_mutex_unlock(&worker->shared_mutex);
+}
+
+#if IREE_HAL_LOCAL_PROFILER_HAVE_PERF
+
+// Opens the hardware counters for the calling thread. Counters that are not
+// available (unsupported hardware, perf_event_paranoid, containers, etc) are
+// skipped and the worker records only time if none open.
+static void iree_hal_local_profiler_worker_open_counters(
+    iree_hal_local_profiler_worker_t* worker) {
+  worker->counters_opened = true;
+  static const uint64_t configs[IREE_HAL_LOCAL_PROFILE_COUNTER_COUNT] = {
+      [IREE_HAL_LOCAL_PROFILE_COUNTER_CPU_CYCLES] = PERF_COUNT_HW_CPU_CYCLES,
+      [IREE_HAL_LOCAL_PROFILE_COUNTER_INSTRUCTIONS] =
+          PERF_COUNT_HW_INSTRUCTIONS,
+      [IREE_HAL_LOCAL_PROFILE_COUNTER_CACHE_MISSES] =
+          PERF_COUNT_HW_CACHE_MISSES,
+  };
+  uint32_t counter_mask = 0;
+  for (iree_host_size_t i = 0; i < IREE_ARRAYSIZE(configs); ++i) {
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.config = configs[i];
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_GROUP;
+    int fd = (int)syscall(__NR_perf_event_open, &attr, /*pid=*/0, /*cpu=*/-1,
+                          worker->counter_group_fd, PERF_FLAG_FD_CLOEXEC);
+    if (fd < 0) continue;
+    if (worker->counter_group_fd < 0) worker->counter_group_fd = fd;
+    worker->counter_fds[i] = fd;
+    counter_mask |= 1u << i;
+  }
+  iree_atomic_store_int32(&worker->counter_mask, (int32_t)counter_mask,
+                          iree_memory_order_relaxed);
+}
+
+// Reads all counters of the group in the order they were opened.
+static bool iree_hal_local_profiler_worker_read_counters(
+    iree_hal_local_profiler_worker_t* worker,
+    uint64_t out_counters[IREE_HAL_LOCAL_PROFILE_COUNTER_COUNT]) {
+  if (worker->counter_group_fd < 0) return false;
+  // PERF_FORMAT_GROUP: { u64 nr; u64 values[nr]; }
+  uint64_t values[1 + IREE_HAL_LOCAL_PROFILE_COUNTER_COUNT];
+  ssize_t read_length = read(worker->counter_group_fd, values, sizeof(values));
+  if (read_length < (ssize_t)sizeof(values[0])) return false;
+  const uint32_t counter_mask = (uint32_t)iree_atomic_load_int32(
+      &worker->counter_mask, iree_memory_order_relaxed);
+  iree_host_size_t j = 1;
+  for (iree_host_size_t i = 0; i < IREE_HAL_LOCAL_PROFILE_COUNTER_COUNT; ++i) {
+    out_counters[i] =
+        (counter_mask & (1u << i)) && j <= values[0] ? values[j++] : 0;
+  }
+  return true;
+}
+
+#else
+
+static void iree_hal_local_profiler_worker_open_counters(
+    iree_hal_local_profiler_worker_t* worker) {
+  worker->counters_opened = true;
+}
+
+static bool iree_hal_local_profiler_worker_read_counters(
+    iree_hal_local_profiler_worker_t* worker,
+    uint64_t out_counters[IREE_HAL_LOCAL_PROFILE_COUNTER_COUNT]) {
+  return false;
+}
+
+#endif  // IREE_HAL_LOCAL_PROFILER_HAVE_PERF
+
+//===----------------------------------------------------------------------===//
+// iree_hal_local_profiler_t
+//===----------------------------------------------------------------------===//
+
+struct iree_hal_local_profiler_t {
+  iree_atomic_ref_count_t ref_count;
+  iree_allocator_t host_allocator;
+
+  // Nonzero while samples should be recorded.
+  iree_atomic_int32_t active;
+  iree_hal_device_profiling_mode_t mode;
+  bool capture_counters;
+  // Owned copy of the capture file path.
+  char* file_path;
+  iree_time_t begin_ns;
+
+  iree_atomic_int64_t queue_submit_count;
+  iree_atomic_int64_t queue_command_buffer_count;
+
+  // Worker slots allocated only while profiling. Entries retain the
+  // executables sampled until profiling ends.
+  iree_host_size_t worker_count;
+  iree_hal_local_profiler_worker_t* workers;
+};
+
+iree_status_t iree_hal_local_profiler_create(
+    iree_host_size_t worker_count, iree_allocator_t host_allocator,
+    iree_hal_local_profiler_t** out_profiler) {
+  IREE_ASSERT_ARGUMENT(out_profiler);
+  *out_profiler = NULL;
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  iree_hal_local_profiler_t* profiler = NULL;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_allocator_malloc(host_allocator, sizeof(*profiler),
+                                (void**)&profiler));
+  memset(profiler, 0, sizeof(*profiler));
+  iree_atomic_ref_count_init(&profiler->ref_count);
+  profiler->host_allocator = host_allocator;
+  profiler->worker_count = iree_max(1, worker_count);
+
+  *out_profiler = profiler;
+  IREE_TRACE_ZONE_END(z0);
+  return iree_ok_status();
+}
+
+static void iree_hal_local_profiler_reset(iree_hal_local_profiler_t* profiler) {
+  iree_atomic_store_int32(&profiler->active, 0, iree_memory_order_release);
+  if (profiler->workers) {
+    for (iree_host_size_t i = 0; i < profiler->worker_count; ++i) {
+      iree_hal_local_profiler_worker_deinitialize(&profiler->workers[i],
+                                                  profiler->host_allocator);
+    }
+    iree_allocator_free(profiler->host_allocator, profiler->workers);
+    profiler->workers = NULL;
+  }
+  iree_allocator_free(profiler->host_allocator, profiler->file_path);
+  profiler->file_path = NULL;
+}
+
+static void iree_hal_local_profiler_destroy(
+    iree_hal_local_profiler_t* profiler) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+  iree_hal_local_profiler_reset(profiler);
+  iree_allocator_free(profiler->host_allocator, profiler);
+  IREE_TRACE_ZONE_END(z0);
+}
+
+void iree_hal_local_profiler_retain(iree_hal_local_profiler_t* profiler) {
+  if (IREE_LIKELY(profiler)) {
+    iree_atomic_ref_count_inc(&profiler->ref_count);
+  }
+}
+
+void iree_hal_local_profiler_release(iree_hal_local_profiler_t* profiler) {
+  if (IREE_LIKELY(profiler) &&
+      iree_atomic_ref_count_dec(&profiler->ref_count) == 1) {
+    iree_hal_local_profiler_destroy(profiler);
+  }
+}
+
+iree_status_t iree_hal_local_profiler_begin(
+    iree_hal_local_profiler_t* profiler,
+    const iree_hal_device_profiling_options_t* options) {
+  IREE_ASSERT_ARGUMENT(profiler);
+  IREE_ASSERT_ARGUMENT(options);
+  if (profiler->workers) {
+    return iree_make_status(IREE_STATUS_FAILED_PRECONDITION,
+                            "profiling already active");
+  }
+  iree_string_view_t file_path = iree_make_cstring_view(options->file_path);
+  if (iree_string_view_is_empty(file_path)) return iree_ok_status();
+#if !IREE_FILE_IO_ENABLE
+  return iree_make_status(IREE_STATUS_UNAVAILABLE,
+                          "file IO is disabled; cannot write profiles");
+#endif  // !IREE_FILE_IO_ENABLE
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  iree_status_t status = iree_allocator_malloc(
+      profiler->host_allocator, file_path.size + 1,
+      (void**)&profiler->file_path);
+  if (iree_status_is_ok(status)) {
+    memcpy(profiler->file_path, file_path.data, file_path.size);
+    profiler->file_path[file_path.size] = 0;
+    status = iree_allocator_malloc(
+        profiler->host_allocator,
+        profiler->worker_count * sizeof(*profiler->workers),
+        (void**)&profiler->workers);
+  }
+  if (iree_status_is_ok(status)) {
+    for (iree_host_size_t i = 0; i < profiler->worker_count; ++i) {
+      iree_hal_local_profiler_worker_initialize(&profiler->workers[i]);
+    }
+    profiler->mode = options->mode;
+    profiler->capture_counters = iree_any_bit_set(
+        options->mode, IREE_HAL_DEVICE_PROFILING_MODE_DISPATCH_COUNTERS |
+                           IREE_HAL_DEVICE_PROFILING_MODE_EXECUTABLE_COUNTERS);
+    iree_atomic_store_int64(&profiler->queue_submit_count, 0,
+                            iree_memory_order_relaxed);
+    iree_atomic_store_int64(&profiler->queue_command_buffer_count, 0,
+                            iree_memory_order_relaxed);
+    profiler->begin_ns = iree_time_now();
+    iree_atomic_store_int32(&profiler->active, 1, iree_memory_order_release);
+  } else {
+    iree_hal_local_profiler_reset(profiler);
+  }
+
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+// A record copied out of a worker table for sorting before writing the
+// capture. |executable_index| and |name_offset| are assigned once sorted.
+typedef struct iree_hal_local_profiler_capture_entry_t {
+  iree_hal_local_executable_t* executable;
+  iree_hal_local_profile_record_t record;
+} iree_hal_local_profiler_capture_entry_t;
+
+static int iree_hal_local_profiler_capture_entry_compare(const void* lhs_ptr,
+                                                         const void* rhs_ptr) {
+  const iree_hal_local_profiler_capture_entry_t* lhs =
+      (const iree_hal_local_profiler_capture_entry_t*)lhs_ptr;
+  const iree_hal_local_profiler_capture_entry_t* rhs =
+      (const iree_hal_local_profiler_capture_entry_t*)rhs_ptr;
+  uintptr_t lhs_executable = (uintptr_t)lhs->executable;
+  uintptr_t rhs_executable = (uintptr_t)rhs->executable;
+  if (lhs_executable != rhs_executable) {
+    return lhs_executable < rhs_executable ? -1 : 1;
+  }
+  if (lhs->record.export_ordinal != rhs->record.export_ordinal) {
+    return lhs->record.export_ordinal < rhs->record.export_ordinal ? -1 : 1;
+  }
+  return (lhs->record.worker_id > rhs->record.worker_id) -
+         (lhs->record.worker_id < rhs->record.worker_id);
+}
+
+static bool iree_hal_local_profiler_capture_entry_same_export(
+    const iree_hal_local_profiler_capture_entry_t* lhs,
+    const iree_hal_local_profiler_capture_entry_t* rhs) {
+  return lhs->executable == rhs->executable &&
+         lhs->record.export_ordinal == rhs->record.export_ordinal;
+}
+
+// Returns the export name of |entry| or NULL if the executable has none.
+static const char* iree_hal_local_profiler_capture_entry_name(
+    const iree_hal_local_profiler_capture_entry_t* entry) {
+  const char* const* export_names = entry->executable->export_names;
+  return export_names ? export_names[entry->record.export_ordinal] : NULL;
+}
+
+// Copies up to |capacity| used entries of |table| into |out_entries| and
+// returns the number copied. The table writer may be concurrently recording.
+static iree_host_size_t iree_hal_local_profiler_table_copy(
+    iree_hal_local_profiler_table_t* table, uint32_t worker_id,
+    iree_host_size_t capacity,
+    iree_hal_local_profiler_capture_entry_t* out_entries) {
+  iree_host_size_t count = 0;
+  for (iree_host_size_t i = 0;
+       i < IREE_ARRAYSIZE(table->entries) && count < capacity; ++i) {
+    iree_hal_local_profiler_entry_t* entry = &table->entries[i];
+    iree_hal_local_executable_t* executable =
+        (iree_hal_local_executable_t*)iree_atomic_load_intptr(
+            &entry->executable, iree_memory_order_acquire);
+    if (!executable) continue;
+    iree_hal_local_profiler_capture_entry_t* capture_entry =
+        &out_entries[count++];
+    memset(capture_entry, 0, sizeof(*capture_entry));
+    capture_entry->executable = executable;
+    iree_hal_local_profile_record_t* record = &capture_entry->record;
+    record->export_ordinal = entry->ordinal;
+    record->worker_id = worker_id;
+    record->dispatch_count = (uint64_t)iree_atomic_load_int64(
+        &entry->dispatch_count, iree_memory_order_relaxed);
+    record->workgroup_count = (uint64_t)iree_atomic_load_int64(
+        &entry->workgroup_count, iree_memory_order_relaxed);
+    record->total_ns = (uint64_t)iree_atomic_load_int64(
+        &entry->total_ns, iree_memory_order_relaxed);
+    record->binding_length = (uint64_t)iree_atomic_load_int64(
+        &entry->binding_length, iree_memory_order_relaxed);
+    for (iree_host_size_t j = 0; j < IREE_ARRAYSIZE(record->counters); ++j) {
+      record->counters[j] = (uint64_t)iree_atomic_load_int64(
+          &entry->counters[j], iree_memory_order_relaxed);
+    }
+  }
+  return count;
+}
+
+// Serializes all samples recorded so far into |out_capture|.
+// The caller must free the capture with the profiler host allocator.
+static iree_status_t iree_hal_local_profiler_serialize(
+    iree_hal_local_profiler_t* profiler, iree_byte_span_t* out_capture) {
+  *out_capture = iree_make_byte_span(NULL, 0);
+
+  // Copy out all entries; owner tables are read while workers may still be
+  // recording and shared tables are only locked briefly.
+  iree_host_size_t entry_count = 0;
+  for (iree_host_size_t i = 0; i < profiler->worker_count; ++i) {
+    iree_hal_local_profiler_worker_t* worker = &profiler->workers[i];
+    entry_count += (iree_host_size_t)iree_atomic_load_int32(
+        &worker->table.entry_count, iree_memory_order_relaxed);
+    iree_slim_mutex_lock(&worker->shared_mutex);
+    if (worker->shared_table) {
+      entry_count += (iree_host_size_t)iree_atomic_load_int32(
+          &worker->shared_table->entry_count, iree_memory_order_relaxed);
+    }
+    iree_slim_mutex_unlock(&worker->shared_mutex);
+  }
+  // Workers may have inserted entries since they were counted; those are left
+  // for the next flush.
+  iree_hal_local_profiler_capture_entry_t* entries = NULL;
+  IREE_RETURN_IF_ERROR(iree_allocator_malloc(
+      profiler->host_allocator, iree_max(1, entry_count) * sizeof(*entries),
+      (void**)&entries));
+  iree_hal_local_profile_header_t header = {
+      .magic = IREE_HAL_LOCAL_PROFILE_MAGIC,
+      .version = IREE_HAL_LOCAL_PROFILE_VERSION,
+      .counter_count = IREE_HAL_LOCAL_PROFILE_COUNTER_COUNT,
+      .mode = profiler->mode,
+      .worker_count = (uint32_t)profiler->worker_count,
+      .duration_ns = (uint64_t)(iree_time_now() - profiler->begin_ns),
+      .queue_submit_count = (uint64_t)iree_atomic_load_int64(
+          &profiler->queue_submit_count, iree_memory_order_relaxed),
+      .queue_command_buffer_count = (uint64_t)iree_atomic_load_int64(
+          &profiler->queue_command_buffer_count, iree_memory_order_relaxed),
+  };
+  iree_host_size_t copied_count = 0;
+  for (iree_host_size_t i = 0; i < profiler->worker_count; ++i) {
+    iree_hal_local_profiler_worker_t* worker = &profiler->workers[i];
+    header.counter_mask |= (uint32_t)iree_atomic_load_int32(
+        &worker->counter_mask, iree_memory_order_relaxed);
+    header.dropped_sample_count += (uint64_t)iree_atomic_load_int64(
+        &worker->table.dropped_sample_count, iree_memory_order_relaxed);
+    copied_count += iree_hal_local_profiler_table_copy(
+        &worker->table, (uint32_t)i, entry_count - copied_count,
+        entries + copied_count);
+    iree_slim_mutex_lock(&worker->shared_mutex);
+    header.dropped_sample_count += worker->shared_dropped_sample_count;
+    if (worker->shared_table) {
+      header.dropped_sample_count += (uint64_t)iree_atomic_load_int64(
+          &worker->shared_table->dropped_sample_count,
+          iree_memory_order_relaxed);
+      copied_count += iree_hal_local_profiler_table_copy(
+          worker->shared_table, (uint32_t)i, entry_count - copied_count,
+          entries + copied_count);
+    }
+    iree_slim_mutex_unlock(&worker->shared_mutex);
+  }
+  qsort(entries, copied_count, sizeof(*entries),
+        iree_hal_local_profiler_capture_entry_compare);
+
+  // Merge the owner and shared entries of an export on the same worker.
+  entry_count = 0;
+  for (iree_host_size_t i = 0; i < copied_count; ++i) {
+    iree_hal_local_profiler_capture_entry_t* last =
+        entry_count > 0 ? &entries[entry_count - 1] : NULL;
+    if (!last ||
+        !iree_hal_local_profiler_capture_entry_same_export(last,
+                                                           &entries[i]) ||
+        last->record.worker_id != entries[i].record.worker_id) {
+      entries[entry_count++] = entries[i];
+      continue;
+    }
+    const iree_hal_local_profile_record_t* record = &entries[i].record;
+    last->record.dispatch_count += record->dispatch_count;
+    last->record.workgroup_count += record->workgroup_count;
+    last->record.total_ns += record->total_ns;
+    last->record.binding_length += record->binding_length;
+    for (iree_host_size_t j = 0; j < IREE_ARRAYSIZE(record->counters); ++j) {
+      last->record.counters[j] += record->counters[j];
+    }
+  }
+
+  // Names are stored once per export as records of the same export are
+  // adjacent after sorting.
+  iree_host_size_t string_table_length = 0;
+  for (iree_host_size_t i = 0; i < entry_count; ++i) {
+    if (i > 0 && iree_hal_local_profiler_capture_entry_same_export(
+                     &entries[i], &entries[i - 1])) {
+      continue;
+    }
+    const char* name = iree_hal_local_profiler_capture_entry_name(&entries[i]);
+    if (name) string_table_length += strlen(name) + 1;
+  }
+  header.record_count = (uint32_t)entry_count;
+  header.string_table_length = (uint32_t)string_table_length;
+
+  iree_host_size_t capture_length =
+      sizeof(header) + entry_count * sizeof(iree_hal_local_profile_record_t) +
+      string_table_length;
+  uint8_t* capture = NULL;
+  iree_status_t status = iree_allocator_malloc(
+      profiler->host_allocator, capture_length, (void**)&capture);
+  if (iree_status_is_ok(status)) {
+    memcpy(capture, &header, sizeof(header));
+    iree_hal_local_profile_record_t* records =
+        (iree_hal_local_profile_record_t*)(capture + sizeof(header));
+    char* string_table =
+        (char*)(capture + sizeof(header) + entry_count * sizeof(*records));
+    uint32_t executable_index = 0;
+    uint32_t name_offset = UINT32_MAX;
+    uint32_t string_table_offset = 0;
+    for (iree_host_size_t i = 0; i < entry_count; ++i) {
+      const iree_hal_local_profiler_capture_entry_t* entry = &entries[i];
+      bool same_executable =
+          i > 0 && entry->executable == entries[i - 1].executable;
+      if (i > 0 && !same_executable) ++executable_index;
+      if (!same_executable || entry->record.export_ordinal !=
+                                  entries[i - 1].record.export_ordinal) {
+        name_offset = UINT32_MAX;
+        const char* name = iree_hal_local_profiler_capture_entry_name(entry);
+        if (name) {
+          iree_host_size_t name_length = strlen(name) + 1;
+          memcpy(string_table + string_table_offset, name, name_length);
+          name_offset = string_table_offset;
+          string_table_offset += (uint32_t)name_length;
+        }
+      }
+      records[i] = entry->record;
+      records[i].executable_index = executable_index;
+      records[i].name_offset = name_offset;
+    }
+    *out_capture = iree_make_byte_span(capture, capture_length);
+  }
+
+  iree_allocator_free(profiler->host_allocator, entries);
+  return status;
+}
+
+iree_status_t iree_hal_local_profiler_flush(
+    iree_hal_local_profiler_t* profiler) {
+  IREE_ASSERT_ARGUMENT(profiler);
+  if (!profiler->workers) return iree_ok_status();
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  iree_byte_span_t capture = iree_make_byte_span(NULL, 0);
+  iree_status_t status = iree_hal_local_profiler_serialize(profiler, &capture);
+#if IREE_FILE_IO_ENABLE
+  if (iree_status_is_ok(status)) {
+    status = iree_file_write_contents(
+        profiler->file_path,
+        iree_make_const_byte_span(capture.data, capture.data_length));
+  }
+#endif  // IREE_FILE_IO_ENABLE
+  iree_allocator_free(profiler->host_allocator, capture.data);
+
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+iree_status_t iree_hal_local_profiler_end(iree_hal_local_profiler_t* profiler) {
+  IREE_ASSERT_ARGUMENT(profiler);
+  if (!profiler->workers) return iree_ok_status();
+  IREE_TRACE_ZONE_BEGIN(z0);
+  iree_atomic_store_int32(&profiler->active, 0, iree_memory_order_release);
+  iree_status_t status = iree_hal_local_profiler_flush(profiler);
+  iree_hal_local_profiler_reset(profiler);
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+bool iree_hal_local_profiler_is_active(iree_hal_local_profiler_t* profiler) {
+  return profiler && iree_atomic_load_int32(&profiler->active,
+                                            iree_memory_order_acquire) != 0;
+}
+
+void iree_hal_local_profiler_record_submit(
+    iree_hal_local_profiler_t* profiler,
+    iree_host_size_t command_buffer_count) {
+  if (!iree_hal_local_profiler_is_active(profiler)) return;
+  iree_atomic_fetch_add_int64(&profiler->queue_submit_count, 1,
+                              iree_memory_order_relaxed);
+  iree_atomic_fetch_add_int64(&profiler->queue_command_buffer_count,
+                              (int64_t)command_buffer_count,
+                              iree_memory_order_relaxed);
+}
+
+void iree_hal_local_profiler_sample_begin(
+    iree_hal_local_profiler_t* profiler,
+    iree_hal_local_profiler_sample_t* out_sample) {
+  out_sample->start_ns = iree_time_now();
+}
+
+void iree_hal_local_profiler_sample_end(
+    iree_hal_local_profiler_t* profiler, uint32_t worker_id,
+    iree_hal_local_executable_t* executable, iree_host_size_t ordinal,
+    uint32_t dispatch_count, uint32_t workgroup_count, uint64_t binding_length,
+    const iree_hal_local_profiler_sample_t* sample) {
+  const uint64_t duration_ns = (uint64_t)(iree_time_now() - sample->start_ns);
+  IREE_ASSERT_LT(worker_id, profiler->worker_count);
+  iree_hal_local_profiler_worker_t* worker = &profiler->workers[worker_id];
+  if (IREE_LIKELY(iree_hal_local_profiler_worker_claim(worker))) {
+    iree_hal_local_profiler_table_record(
+        &worker->table, executable, (uint32_t)ordinal, dispatch_count,
+        workgroup_count, duration_ns, binding_length);
+  } else {
+    iree_hal_local_profiler_worker_record_shared(
+        worker, profiler->host_allocator, executable, (uint32_t)ordinal,
+        dispatch_count, workgroup_count, duration_ns, binding_length);
+  }
+}
+
+void iree_hal_local_profiler_counters_begin(iree_hal_local_profiler_t* profiler,
+                                            uint32_t worker_id) {
+  if (!profiler->capture_counters) return;
+  IREE_ASSERT_LT(worker_id, profiler->worker_count);
+  iree_hal_local_profiler_worker_t* worker = &profiler->workers[worker_id];
+  if (!iree_hal_local_profiler_worker_claim(worker)) return;
+  if (!worker->counters_opened) {
+    iree_hal_local_profiler_worker_open_counters(worker);
+  }
+  worker->counter_span_open = iree_hal_local_profiler_worker_read_counters(
+      worker, worker->counter_base);
+}
+
+void iree_hal_local_profiler_counters_end(
+    iree_hal_local_profiler_t* profiler, uint32_t worker_id,
+    iree_hal_local_executable_t* executable, iree_host_size_t ordinal) {
+  if (!profiler->capture_counters) return;
+  IREE_ASSERT_LT(worker_id, profiler->worker_count);
+  iree_hal_local_profiler_worker_t* worker = &profiler->workers[worker_id];
+  if (!iree_hal_local_profiler_worker_claim(worker) ||
+      !worker->counter_span_open) {
+    return;
+  }
+  worker->counter_span_open = false;
+  uint64_t counters[IREE_HAL_LOCAL_PROFILE_COUNTER_COUNT];
+  if (!iree_hal_local_profiler_worker_read_counters(worker, counters)) return;
+  iree_hal_local_profiler_entry_t* entry = iree_hal_local_profiler_table_lookup(
+      &worker->table, executable, (uint32_t)ordinal);
+  if (!entry) {
+    iree_hal_local_profiler_accumulate(&worker->table.dropped_sample_count, 1);
+    return;
+  }
+  for (iree_host_size_t i = 0; i < IREE_ARRAYSIZE(counters); ++i) {
+    iree_hal_local_profiler_accumulate(&entry->counters[i],
+                                       counters[i] - worker->counter_base[i]);
+  }
+}
@@ -0,0 +1,200 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_HAL_LOCAL_LOCAL_PROFILER_H_
+#define IREE_HAL_LOCAL_LOCAL_PROFILER_H_
+
+#include <stdint.h>
+
+#include "iree/base/api.h"
+#include "iree/hal/api.h"
+#include "iree/hal/local/local_executable.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+//===----------------------------------------------------------------------===//
+// Capture file format
+//===----------------------------------------------------------------------===//
+// A capture is a header followed by |record_count| records and a string table
+// of |string_table_length| bytes holding NUL-terminated export names. All
+// values are in host byte order. Records are sorted by executable, export
+// ordinal and worker so that all records of an export are adjacent.
+//
+// Each record aggregates all samples of one export on one worker during the
+// profiled range. With the task executor workgroups of a dispatch are spread
+// across workers and |total_ns| is the sum of the time the worker spent in the
+// export; the dispatch count is attributed to the worker that ran the first
+// workgroup of each dispatch. Hardware counters cover each span bracketed by
+// iree_hal_local_profiler_counters_begin/end (a dispatch shard with the task
+// executor) and so also include the scheduling overhead between workgroups.
+
+// "IREE HAL local profile v0"
+// "LPF0" = 0x4C 0x50 0x46 0x30
+#define IREE_HAL_LOCAL_PROFILE_MAGIC 0x3046504Cu
+#define IREE_HAL_LOCAL_PROFILE_VERSION 1u
+
+// Hardware counters captured per record, when available.
+typedef enum iree_hal_local_profile_counter_e {
+  IREE_HAL_LOCAL_PROFILE_COUNTER_CPU_CYCLES = 0,
+  IREE_HAL_LOCAL_PROFILE_COUNTER_INSTRUCTIONS = 1,
+  IREE_HAL_LOCAL_PROFILE_COUNTER_CACHE_MISSES = 2,
+  IREE_HAL_LOCAL_PROFILE_COUNTER_COUNT = 3,
+} iree_hal_local_profile_counter_t;
+
+typedef struct iree_hal_local_profile_header_t {
+  // Must be IREE_HAL_LOCAL_PROFILE_MAGIC.
+  uint32_t magic;
+  // Must be IREE_HAL_LOCAL_PROFILE_VERSION.
+  uint16_t version;
+  // Number of entries in each record's |counters|.
+  uint16_t counter_count;
+  // iree_hal_device_profiling_mode_t the capture was made with.
+  uint32_t mode;
+  // Bitmask of iree_hal_local_profile_counter_t that were captured by at least
+  // one worker. Counters of other bits are always zero.
+  uint32_t counter_mask;
+  // Number of worker slots samples were recorded into.
+  uint32_t worker_count;
+  // Number of iree_hal_local_profile_record_t following the header.
+  uint32_t record_count;
+  // Total length of the string table following the records.
+  uint32_t string_table_length;
+  uint32_t reserved;
+  // Wall time from the start of profiling to the capture.
+  uint64_t duration_ns;
+  // Number of queue submissions and the command buffers they contained.
+  uint64_t queue_submit_count;
+  uint64_t queue_command_buffer_count;
+  // Samples dropped because a worker ran out of record storage.
+  uint64_t dropped_sample_count;
+} iree_hal_local_profile_header_t;
+
+typedef struct iree_hal_local_profile_record_t {
+  // Dense index of the executable within the capture. Different executables
+  // exporting functions with the same name have different indices.
+  uint32_t executable_index;
+  // Export ordinal within the executable.
+  uint32_t export_ordinal;
+  // Worker slot the samples were recorded on.
+  uint32_t worker_id;
+  // Byte offset of the export name in the string table or UINT32_MAX if the
+  // executable has no export names.
+  uint32_t name_offset;
+  uint64_t dispatch_count;
+  uint64_t workgroup_count;
+  uint64_t total_ns;
+  // Total length of the bindings of all counted dispatches. This is the size
+  // of the buffer ranges bound and an upper bound on the bytes accessed.
+  uint64_t binding_length;
+  uint64_t counters[IREE_HAL_LOCAL_PROFILE_COUNTER_COUNT];
+} iree_hal_local_profile_record_t;
+
+//===----------------------------------------------------------------------===//
+// iree_hal_local_profiler_t
+//===----------------------------------------------------------------------===//
+
+// Records per-export dispatch time and hardware counters for the local HAL
+// devices and writes them to a capture file (see above) on flush/end.
+//
+// Samples are recorded into per-worker slots. The first thread sampling on a
+// slot owns it and records without locking; other threads sampling on the same
+// slot record into a shared table under a lock. Callers with multiple
+// executors must give each executor its own range of slots. Hardware counters
+// use Linux perf_event_open, are opened by the owner of a slot, and are only
+// read by iree_hal_local_profiler_counters_begin/end so that callers can
+// amortize the reads over many samples. Counters are only captured in the
+// DISPATCH_COUNTERS and EXECUTABLE_COUNTERS profiling modes.
+//
+// Executables sampled are retained until profiling ends so that their export
+// names can be written to the capture.
+//
+// Thread-safe: sampling may happen concurrently from any thread. Beginning and
+// ending profiling must not overlap with execution per the HAL device API.
+typedef struct iree_hal_local_profiler_t iree_hal_local_profiler_t;
+
+// Creates a profiler with |worker_count| sample slots. Storage for samples is
+// only allocated while profiling.
+iree_status_t iree_hal_local_profiler_create(
+    iree_host_size_t worker_count, iree_allocator_t host_allocator,
+    iree_hal_local_profiler_t** out_profiler);
+
+// Retains the given |profiler| for the caller.
+void iree_hal_local_profiler_retain(iree_hal_local_profiler_t* profiler);
+
+// Releases the given |profiler| from the caller.
+void iree_hal_local_profiler_release(iree_hal_local_profiler_t* profiler);
+
+// Begins profiling with |options|. Profiling is a no-op if no file path is
+// provided as there is nowhere to write the capture.
+iree_status_t iree_hal_local_profiler_begin(
+    iree_hal_local_profiler_t* profiler,
+    const iree_hal_device_profiling_options_t* options);
+
+// Writes a capture of all samples recorded since profiling began.
+iree_status_t iree_hal_local_profiler_flush(
+    iree_hal_local_profiler_t* profiler);
+
+// Writes a final capture and ends profiling.
+iree_status_t iree_hal_local_profiler_end(iree_hal_local_profiler_t* profiler);
+
+// Returns true if samples should be recorded. |profiler| may be NULL.
+bool iree_hal_local_profiler_is_active(iree_hal_local_profiler_t* profiler);
+
+// Records a queue submission of |command_buffer_count| command buffers.
+void iree_hal_local_profiler_record_submit(
+    iree_hal_local_profiler_t* profiler,
+    iree_host_size_t command_buffer_count);
+
+// An in-flight sample started with iree_hal_local_profiler_sample_begin.
+typedef struct iree_hal_local_profiler_sample_t {
+  iree_time_t start_ns;
+} iree_hal_local_profiler_sample_t;
+
+// Starts a sample on the calling thread.
+void iree_hal_local_profiler_sample_begin(
+    iree_hal_local_profiler_t* profiler,
+    iree_hal_local_profiler_sample_t* out_sample);
+
+// Ends |sample| and accumulates it into the record for the export |ordinal| of
+// |executable| on |worker_id|, counting |dispatch_count| dispatches and
+// |workgroup_count| workgroups with |binding_length| total bytes bound.
+// |worker_id| must be less than the worker count the profiler was created with.
+void iree_hal_local_profiler_sample_end(
+    iree_hal_local_profiler_t* profiler, uint32_t worker_id,
+    iree_hal_local_executable_t* executable, iree_host_size_t ordinal,
+    uint32_t dispatch_count, uint32_t workgroup_count, uint64_t binding_length,
+    const iree_hal_local_profiler_sample_t* sample);
+
+// Starts a hardware counter span on the calling thread for |worker_id|. Each
+// span costs a counter read at the beginning and end and should bracket many
+// samples, such as all workgroups a worker runs in a dispatch shard. No-op if
+// counters are not being captured or the calling thread does not own the slot.
+void iree_hal_local_profiler_counters_begin(iree_hal_local_profiler_t* profiler,
+                                            uint32_t worker_id);
+
+// Ends the counter span started on |worker_id| and accumulates the counter
+// deltas into the record for the export |ordinal| of |executable|.
+void iree_hal_local_profiler_counters_end(
+    iree_hal_local_profiler_t* profiler, uint32_t worker_id,
+    iree_hal_local_executable_t* executable, iree_host_size_t ordinal);
+
+// Returns the total length of all bindings in |dispatch_state|.
+static inline uint64_t iree_hal_local_profiler_binding_length(
+    const iree_hal_executable_dispatch_state_v0_t* dispatch_state) {
+  uint64_t binding_length = 0;
+  for (iree_host_size_t i = 0; i < dispatch_state->binding_count; ++i) {
+    binding_length += dispatch_state->binding_lengths[i];
+  }
+  return binding_length;
+}
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif  // IREE_HAL_LOCAL_LOCAL_PROFILER_H_
@@ -0,0 +1,262 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/hal/local/local_profiler.h"
+
+#include <cinttypes>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "iree/base/api.h"
+#include "iree/base/internal/file_io.h"
+#include "iree/testing/gtest.h"
+#include "iree/testing/status_matchers.h"
+
+namespace iree {
+namespace hal {
+namespace {
+
+std::string GetUniquePath(const char* unique_name) {
+  const char* test_tmpdir = getenv("TEST_TMPDIR");
+  if (!test_tmpdir) test_tmpdir = getenv("TMPDIR");
+  if (!test_tmpdir) test_tmpdir = getenv("TEMP");
+  if (!test_tmpdir) test_tmpdir = "/tmp";
+  std::random_device d;
+  uint64_t random = (static_cast<uint64_t>(d()) << 32) | d();
+  char unique_path[256];
+  snprintf(unique_path, sizeof unique_path, "%s/iree_test_%" PRIx64 "_%s",
+           test_tmpdir, random, unique_name);
+  return unique_path;
+}
+
+// An executable that is only used as a key and for its export names and that
+// records when its last reference is released.
+struct FakeExecutable {
+  iree_hal_local_executable_t base;
+  bool released;
+  bool destroyed;
+
+  static void Destroy(iree_hal_executable_t* base_executable) {
+    reinterpret_cast<FakeExecutable*>(base_executable)->destroyed = true;
+  }
+  static const iree_hal_local_executable_vtable_t vtable;
+
+  void Initialize(const char* const* export_names) {
+    memset(this, 0, sizeof(*this));
+    iree_hal_resource_initialize(&vtable, &base.resource);
+    base.export_names = export_names;
+  }
+  // Releases the reference held by the test, if not yet released.
+  void Release() {
+    if (released) return;
+    released = true;
+    iree_hal_executable_release(
+        reinterpret_cast<iree_hal_executable_t*>(&base));
+  }
+};
+
+const iree_hal_local_executable_vtable_t FakeExecutable::vtable = {
+    /*base=*/{FakeExecutable::Destroy},
+    /*issue_call=*/NULL,
+    /*query_ready=*/NULL,
+};
+
+struct LocalProfilerTest : public ::testing::Test {
+  iree_allocator_t host_allocator = iree_allocator_system();
+  iree_hal_local_profiler_t* profiler = NULL;
+
+  static constexpr const char* kExportNames[] = {"dispatch_0", "dispatch_1"};
+  FakeExecutable named_executable;
+  FakeExecutable unnamed_executable;
+
+  void SetUp() override {
+    IREE_ASSERT_OK(iree_hal_local_profiler_create(/*worker_count=*/2,
+                                                  host_allocator, &profiler));
+    named_executable.Initialize(kExportNames);
+    unnamed_executable.Initialize(/*export_names=*/NULL);
+  }
+
+  void TearDown() override {
+    iree_hal_local_profiler_release(profiler);
+    named_executable.Release();
+    unnamed_executable.Release();
+  }
+
+  void Sample(uint32_t worker_id, FakeExecutable* executable,
+              iree_host_size_t ordinal, uint32_t dispatch_count,
+              uint32_t workgroup_count) {
+    ASSERT_TRUE(iree_hal_local_profiler_is_active(profiler));
+    iree_hal_local_profiler_counters_begin(profiler, worker_id);
+    iree_hal_local_profiler_sample_t sample;
+    iree_hal_local_profiler_sample_begin(profiler, &sample);
+    iree_hal_local_profiler_sample_end(
+        profiler, worker_id, &executable->base, ordinal, dispatch_count,
+        workgroup_count, /*binding_length=*/dispatch_count * 1024, &sample);
+    iree_hal_local_profiler_counters_end(profiler, worker_id, &executable->base,
+                                         ordinal);
+  }
+
+  // Reads the capture at |path| into |out_header| and |out_records|.
+  void ReadCapture(const std::string& path,
+                   iree_hal_local_profile_header_t* out_header,
+                   std::vector<iree_hal_local_profile_record_t>* out_records) {
+    iree_file_contents_t* contents = NULL;
+    IREE_ASSERT_OK(iree_file_read_contents(
+        path.c_str(), IREE_FILE_READ_FLAG_DEFAULT, host_allocator, &contents));
+    const uint8_t* data = contents->const_buffer.data;
+    ASSERT_GE(contents->const_buffer.data_length, sizeof(*out_header));
+    memcpy(out_header, data, sizeof(*out_header));
+    const iree_host_size_t records_length =
+        out_header->record_count * sizeof(iree_hal_local_profile_record_t);
+    ASSERT_GE(contents->const_buffer.data_length,
+              sizeof(*out_header) + records_length);
+    out_records->resize(out_header->record_count);
+    memcpy(out_records->data(), data + sizeof(*out_header), records_length);
+    iree_file_contents_free(contents);
+  }
+};
+
+// Tests that profiling without a file is a no-op.
+TEST_F(LocalProfilerTest, NoFile) {
+  iree_hal_device_profiling_options_t options = {};
+  options.mode = IREE_HAL_DEVICE_PROFILING_MODE_QUEUE_OPERATIONS;
+  IREE_ASSERT_OK(iree_hal_local_profiler_begin(profiler, &options));
+  EXPECT_FALSE(iree_hal_local_profiler_is_active(profiler));
+  IREE_EXPECT_OK(iree_hal_local_profiler_flush(profiler));
+  IREE_EXPECT_OK(iree_hal_local_profiler_end(profiler));
+}
+
+// Tests that samples are aggregated per worker and export in the capture.
+TEST_F(LocalProfilerTest, Capture) {
+  std::string path = GetUniquePath("profile.bin");
+  iree_hal_device_profiling_options_t options = {};
+  options.mode = IREE_HAL_DEVICE_PROFILING_MODE_DISPATCH_COUNTERS;
+  options.file_path = path.c_str();
+  IREE_ASSERT_OK(iree_hal_local_profiler_begin(profiler, &options));
+
+  iree_hal_local_profiler_record_submit(profiler, 2);
+  Sample(0, &named_executable, 1, 1, 1);
+  Sample(1, &named_executable, 1, 0, 1);
+  Sample(1, &named_executable, 1, 0, 1);
+  Sample(0, &named_executable, 0, 1, 8);
+  Sample(0, &unnamed_executable, 0, 1, 4);
+  IREE_ASSERT_OK(iree_hal_local_profiler_end(profiler));
+  EXPECT_FALSE(iree_hal_local_profiler_is_active(profiler));
+
+  iree_file_contents_t* contents = NULL;
+  IREE_ASSERT_OK(iree_file_read_contents(
+      path.c_str(), IREE_FILE_READ_FLAG_DEFAULT, host_allocator, &contents));
+  const uint8_t* data = contents->const_buffer.data;
+  iree_hal_local_profile_header_t header;
+  ASSERT_GE(contents->const_buffer.data_length, sizeof(header));
+  memcpy(&header, data, sizeof(header));
+  EXPECT_EQ(header.magic, IREE_HAL_LOCAL_PROFILE_MAGIC);
+  EXPECT_EQ(header.version, IREE_HAL_LOCAL_PROFILE_VERSION);
+  EXPECT_EQ(header.worker_count, 2);
+  EXPECT_EQ(header.queue_submit_count, 1);
+  EXPECT_EQ(header.queue_command_buffer_count, 2);
+  EXPECT_EQ(header.dropped_sample_count, 0);
+  ASSERT_EQ(header.record_count, 4);
+  ASSERT_EQ(contents->const_buffer.data_length,
+            sizeof(header) +
+                header.record_count * sizeof(iree_hal_local_profile_record_t) +
+                header.string_table_length);
+
+  const iree_hal_local_profile_record_t* records =
+      reinterpret_cast<const iree_hal_local_profile_record_t*>(data +
+                                                               sizeof(header));
+  const char* string_table =
+      reinterpret_cast<const char*>(records + header.record_count);
+  uint64_t named_dispatch_count = 0;
+  uint64_t named_workgroup_count = 0;
+  for (uint32_t i = 0; i < header.record_count; ++i) {
+    const iree_hal_local_profile_record_t& record = records[i];
+    EXPECT_EQ(record.binding_length, record.dispatch_count * 1024);
+    if (record.name_offset == UINT32_MAX) {
+      EXPECT_EQ(record.dispatch_count, 1);
+      EXPECT_EQ(record.workgroup_count, 4);
+      continue;
+    }
+    ASSERT_LT(record.name_offset, header.string_table_length);
+    EXPECT_STREQ(string_table + record.name_offset,
+                 kExportNames[record.export_ordinal]);
+    named_dispatch_count += record.dispatch_count;
+    named_workgroup_count += record.workgroup_count;
+    if (record.export_ordinal == 1 && record.worker_id == 1) {
+      EXPECT_EQ(record.workgroup_count, 2);
+    }
+  }
+  EXPECT_EQ(named_dispatch_count, 2);
+  EXPECT_EQ(named_workgroup_count, 11);
+
+  iree_file_contents_free(contents);
+  remove(path.c_str());
+}
+
+// Tests that sampled executables are kept alive until profiling ends so that
+// their address cannot be reused by another executable and merge its samples
+// into stale entries.
+TEST_F(LocalProfilerTest, RetainsSampledExecutables) {
+  std::string path = GetUniquePath("retain.bin");
+  iree_hal_device_profiling_options_t options = {};
+  options.mode = IREE_HAL_DEVICE_PROFILING_MODE_QUEUE_OPERATIONS;
+  options.file_path = path.c_str();
+  IREE_ASSERT_OK(iree_hal_local_profiler_begin(profiler, &options));
+
+  Sample(1, &named_executable, 0, 1, 1);
+  named_executable.Release();
+  EXPECT_FALSE(named_executable.destroyed);
+  IREE_ASSERT_OK(iree_hal_local_profiler_flush(profiler));
+  EXPECT_FALSE(named_executable.destroyed);
+  IREE_ASSERT_OK(iree_hal_local_profiler_end(profiler));
+  EXPECT_TRUE(named_executable.destroyed);
+
+  // Unsampled executables are not retained.
+  unnamed_executable.Release();
+  EXPECT_TRUE(unnamed_executable.destroyed);
+
+  remove(path.c_str());
+}
+
+// Tests that samples from a thread other than the one owning a worker slot are
+// merged with the owner's samples of the same export.
+TEST_F(LocalProfilerTest, SharedWorkerSlot) {
+  std::string path = GetUniquePath("shared.bin");
+  iree_hal_device_profiling_options_t options = {};
+  options.mode = IREE_HAL_DEVICE_PROFILING_MODE_DISPATCH_COUNTERS;
+  options.file_path = path.c_str();
+  IREE_ASSERT_OK(iree_hal_local_profiler_begin(profiler, &options));
+
+  Sample(0, &named_executable, 0, 1, 2);
+  std::thread thread([&]() {
+    Sample(0, &named_executable, 0, 1, 3);
+    Sample(0, &named_executable, 1, 1, 5);
+  });
+  thread.join();
+  IREE_ASSERT_OK(iree_hal_local_profiler_end(profiler));
+
+  iree_hal_local_profile_header_t header;
+  std::vector<iree_hal_local_profile_record_t> records;
+  ReadCapture(path, &header, &records);
+  EXPECT_EQ(header.dropped_sample_count, 0);
+  ASSERT_EQ(header.record_count, 2);
+  EXPECT_EQ(records[0].export_ordinal, 0);
+  EXPECT_EQ(records[0].dispatch_count, 2);
+  EXPECT_EQ(records[0].workgroup_count, 5);
+  EXPECT_EQ(records[0].binding_length, 2 * 1024);
+  EXPECT_EQ(records[1].export_ordinal, 1);
+  EXPECT_EQ(records[1].workgroup_count, 5);
+
+  remove(path.c_str());
+}
+
+}  // namespace
+}  // namespace hal
+}  // namespace iree
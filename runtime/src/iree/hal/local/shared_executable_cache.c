@@ -0,0 +1,476 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/hal/local/shared_executable_cache.h"
+
+#include <string.h>
+
+#include "iree/base/internal/hash.h"
+#include "iree/base/internal/synchronization.h"
+#include "iree/hal/local/local_pipeline_layout.h"
+
+//===----------------------------------------------------------------------===//
+// Cache keys
+//===----------------------------------------------------------------------===//
+
+// Number of bytes from the start and end of the executable data mixed into the
+// key hash. The hash only selects a bucket and entries are always confirmed by
+// comparing the full contents so we avoid walking (potentially many MB of)
+// executable data a byte at a time on every load.
+#define IREE_HAL_SHARED_EXECUTABLE_CACHE_HASH_SAMPLE_LENGTH 256
+
+// The portions of a pipeline layout that influence dispatch.
+// Each device creates its own layout objects and as such we can't compare
+// pointers; instead we compare the structure the local command buffers read.
+typedef struct iree_hal_shared_executable_cache_layout_t {
+  iree_host_size_t push_constants;
+  iree_hal_local_binding_mask_t used_bindings;
+  iree_hal_local_binding_mask_t read_only_bindings;
+  iree_host_size_t set_layout_count;
+} iree_hal_shared_executable_cache_layout_t;
+
+typedef struct iree_hal_shared_executable_cache_key_t {
+  // Loader used to load the executable. Retained by entries.
+  iree_hal_executable_loader_t* loader;
+  iree_hal_executable_caching_mode_t caching_mode;
+  iree_host_size_t worker_capacity;
+  iree_string_view_t executable_format;
+  iree_const_byte_span_t executable_data;
+  iree_host_size_t constant_count;
+  const uint32_t* constants;
+  iree_host_size_t layout_count;
+  const iree_hal_shared_executable_cache_layout_t* layouts;
+  // Hash of all of the above with a sample of the executable data.
+  uint64_t hash;
+} iree_hal_shared_executable_cache_key_t;
+
+static void iree_hal_shared_executable_cache_layout_from_pipeline_layout(
+    iree_hal_pipeline_layout_t* pipeline_layout,
+    iree_hal_shared_executable_cache_layout_t* out_layout) {
+  const iree_hal_local_pipeline_layout_t* layout =
+      iree_hal_local_pipeline_layout_cast(pipeline_layout);
+  memset(out_layout, 0, sizeof(*out_layout));
+  out_layout->push_constants = layout->push_constants;
+  out_layout->used_bindings = layout->used_bindings;
+  out_layout->read_only_bindings = layout->read_only_bindings;
+  out_layout->set_layout_count = layout->set_layout_count;
+}
+
+static uint64_t iree_hal_shared_executable_cache_key_hash(
+    const iree_hal_shared_executable_cache_key_t* key) {
+  uint64_t hash = IREE_HASH_FNV1A_64_SEED;
+  hash = iree_hash_fnv1a_64(hash, key->executable_format.data,
+                            key->executable_format.size);
+  hash = iree_hash_fnv1a_64_u64(hash, key->executable_data.data_length);
+  iree_host_size_t sample_length =
+      iree_min(key->executable_data.data_length,
+               IREE_HAL_SHARED_EXECUTABLE_CACHE_HASH_SAMPLE_LENGTH);
+  hash = iree_hash_fnv1a_64(hash, key->executable_data.data, sample_length);
+  hash = iree_hash_fnv1a_64(hash,
+                            key->executable_data.data +
+                                key->executable_data.data_length -
+                                sample_length,
+                            sample_length);
+  hash = iree_hash_fnv1a_64_u64(hash, key->constant_count);
+  hash = iree_hash_fnv1a_64(hash, key->constants,
+                            key->constant_count * sizeof(*key->constants));
+  hash = iree_hash_fnv1a_64_u64(hash, key->layout_count);
+  hash = iree_hash_fnv1a_64(hash, key->layouts,
+                            key->layout_count * sizeof(*key->layouts));
+  return hash;
+}
+
+static bool iree_hal_shared_executable_cache_key_equal(
+    const iree_hal_shared_executable_cache_key_t* lhs,
+    const iree_hal_shared_executable_cache_key_t* rhs) {
+  return lhs->hash == rhs->hash && lhs->loader == rhs->loader &&
+         lhs->caching_mode == rhs->caching_mode &&
+         lhs->worker_capacity == rhs->worker_capacity &&
+         iree_string_view_equal(lhs->executable_format,
+                                rhs->executable_format) &&
+         lhs->executable_data.data_length ==
+             rhs->executable_data.data_length &&
+         memcmp(lhs->executable_data.data, rhs->executable_data.data,
+                lhs->executable_data.data_length) == 0 &&
+         lhs->constant_count == rhs->constant_count &&
+         memcmp(lhs->constants, rhs->constants,
+                lhs->constant_count * sizeof(*lhs->constants)) == 0 &&
+         lhs->layout_count == rhs->layout_count &&
+         memcmp(lhs->layouts, rhs->layouts,
+                lhs->layout_count * sizeof(*lhs->layouts)) == 0;
+}
+
+//===----------------------------------------------------------------------===//
+// iree_hal_shared_executable_cache_t
+//===----------------------------------------------------------------------===//
+
+// Power-of-two number of hash buckets. Most programs have only a handful of
+// executables (dispatches are linked together by the compiler) so this is
+// mostly to keep pathological cases from degrading into long list walks.
+#define IREE_HAL_SHARED_EXECUTABLE_CACHE_BUCKET_COUNT 64
+
+typedef struct iree_hal_shared_executable_cache_entry_t {
+  struct iree_hal_shared_executable_cache_entry_t* next;
+  // Key with all views referencing copies stored in the entry allocation.
+  iree_hal_shared_executable_cache_key_t key;
+  // Retained by the cache.
+  iree_hal_executable_t* executable;
+  // + trailing storage for key layouts, constants, format, and data.
+} iree_hal_shared_executable_cache_entry_t;
+
+struct iree_hal_shared_executable_cache_t {
+  iree_atomic_ref_count_t ref_count;
+  iree_allocator_t host_allocator;
+
+  // Guards all fields below. Only held for lookup/insertion and never during
+  // executable loading.
+  iree_slim_mutex_t mutex;
+  iree_hal_shared_executable_cache_statistics_t statistics;
+  iree_hal_shared_executable_cache_entry_t*
+      buckets[IREE_HAL_SHARED_EXECUTABLE_CACHE_BUCKET_COUNT];
+};
+
+iree_status_t iree_hal_shared_executable_cache_create(
+    iree_allocator_t host_allocator,
+    iree_hal_shared_executable_cache_t** out_cache) {
+  IREE_ASSERT_ARGUMENT(out_cache);
+  *out_cache = NULL;
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  iree_hal_shared_executable_cache_t* cache = NULL;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0,
+      iree_allocator_malloc(host_allocator, sizeof(*cache), (void**)&cache));
+  memset(cache, 0, sizeof(*cache));
+  iree_atomic_ref_count_init(&cache->ref_count);
+  cache->host_allocator = host_allocator;
+  iree_slim_mutex_initialize(&cache->mutex);
+
+  *out_cache = cache;
+  IREE_TRACE_ZONE_END(z0);
+  return iree_ok_status();
+}
+
+static void iree_hal_shared_executable_cache_destroy(
+    iree_hal_shared_executable_cache_t* cache) {
+  iree_allocator_t host_allocator = cache->host_allocator;
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  for (iree_host_size_t i = 0; i < IREE_ARRAYSIZE(cache->buckets); ++i) {
+    iree_hal_shared_executable_cache_entry_t* entry = cache->buckets[i];
+    while (entry) {
+      iree_hal_shared_executable_cache_entry_t* next = entry->next;
+      iree_hal_executable_release(entry->executable);
+      iree_hal_executable_loader_release(entry->key.loader);
+      iree_allocator_free(host_allocator, entry);
+      entry = next;
+    }
+  }
+  iree_slim_mutex_deinitialize(&cache->mutex);
+  iree_allocator_free(host_allocator, cache);
+
+  IREE_TRACE_ZONE_END(z0);
+}
+
+void iree_hal_shared_executable_cache_retain(
+    iree_hal_shared_executable_cache_t* cache) {
+  if (IREE_LIKELY(cache)) {
+    iree_atomic_ref_count_inc(&cache->ref_count);
+  }
+}
+
+void iree_hal_shared_executable_cache_release(
+    iree_hal_shared_executable_cache_t* cache) {
+  if (IREE_LIKELY(cache) && iree_atomic_ref_count_dec(&cache->ref_count) == 1) {
+    iree_hal_shared_executable_cache_destroy(cache);
+  }
+}
+
+// Allocates a new entry holding a copy of |key| and all data it references.
+static iree_status_t iree_hal_shared_executable_cache_entry_allocate(
+    iree_allocator_t host_allocator,
+    const iree_hal_shared_executable_cache_key_t* key,
+    iree_hal_shared_executable_cache_entry_t** out_entry) {
+  iree_host_size_t layouts_size = key->layout_count * sizeof(*key->layouts);
+  iree_host_size_t constants_size =
+      key->constant_count * sizeof(*key->constants);
+  iree_hal_shared_executable_cache_entry_t* entry = NULL;
+  iree_host_size_t total_size =
+      iree_sizeof_struct(*entry) + layouts_size + constants_size +
+      key->executable_format.size + key->executable_data.data_length;
+  IREE_RETURN_IF_ERROR(
+      iree_allocator_malloc(host_allocator, total_size, (void**)&entry));
+  memset(entry, 0, sizeof(*entry));
+  entry->key = *key;
+
+  uint8_t* storage = (uint8_t*)entry + iree_sizeof_struct(*entry);
+  memcpy(storage, key->layouts, layouts_size);
+  entry->key.layouts =
+      (const iree_hal_shared_executable_cache_layout_t*)storage;
+  storage += layouts_size;
+  memcpy(storage, key->constants, constants_size);
+  entry->key.constants = (const uint32_t*)storage;
+  storage += constants_size;
+  memcpy(storage, key->executable_format.data, key->executable_format.size);
+  entry->key.executable_format =
+      iree_make_string_view((const char*)storage, key->executable_format.size);
+  storage += key->executable_format.size;
+  memcpy(storage, key->executable_data.data, key->executable_data.data_length);
+  entry->key.executable_data =
+      iree_make_const_byte_span(storage, key->executable_data.data_length);
+
+  *out_entry = entry;
+  return iree_ok_status();
+}
+
+static iree_hal_shared_executable_cache_entry_t**
+iree_hal_shared_executable_cache_bucket(
+    iree_hal_shared_executable_cache_t* cache,
+    const iree_hal_shared_executable_cache_key_t* key) {
+  return &cache->buckets[key->hash &
+                         (IREE_HAL_SHARED_EXECUTABLE_CACHE_BUCKET_COUNT - 1)];
+}
+
+// Returns a new reference to the executable matching |key| or NULL if not
+// found. Must be called with the cache mutex held.
+static iree_hal_executable_t* iree_hal_shared_executable_cache_lookup_locked(
+    iree_hal_shared_executable_cache_t* cache,
+    const iree_hal_shared_executable_cache_key_t* key) {
+  iree_hal_shared_executable_cache_entry_t* entry =
+      *iree_hal_shared_executable_cache_bucket(cache, key);
+  for (; entry; entry = entry->next) {
+    if (iree_hal_shared_executable_cache_key_equal(&entry->key, key)) {
+      iree_hal_executable_retain(entry->executable);
+      return entry->executable;
+    }
+  }
+  return NULL;
+}
+
+// Releases all entries that are only referenced by the cache.
+// Must be called with the cache mutex held. Since only the cache can hand out
+// new references while the mutex is held an entry with a single reference
+// cannot be resurrected concurrently.
+static void iree_hal_shared_executable_cache_trim_locked(
+    iree_hal_shared_executable_cache_t* cache) {
+  for (iree_host_size_t i = 0; i < IREE_ARRAYSIZE(cache->buckets); ++i) {
+    iree_hal_shared_executable_cache_entry_t** entry_ptr = &cache->buckets[i];
+    while (*entry_ptr) {
+      iree_hal_shared_executable_cache_entry_t* entry = *entry_ptr;
+      iree_hal_resource_t* resource = (iree_hal_resource_t*)entry->executable;
+      if (iree_atomic_ref_count_load(&resource->ref_count) == 1) {
+        *entry_ptr = entry->next;
+        iree_hal_executable_release(entry->executable);
+        iree_hal_executable_loader_release(entry->key.loader);
+        iree_allocator_free(cache->host_allocator, entry);
+        --cache->statistics.entry_count;
+      } else {
+        entry_ptr = &entry->next;
+      }
+    }
+  }
+}
+
+void iree_hal_shared_executable_cache_trim(
+    iree_hal_shared_executable_cache_t* cache) {
+  IREE_ASSERT_ARGUMENT(cache);
+  IREE_TRACE_ZONE_BEGIN(z0);
+  iree_slim_mutex_lock(&cache->mutex);
+  iree_hal_shared_executable_cache_trim_locked(cache);
+  iree_slim_mutex_unlock(&cache->mutex);
+  IREE_TRACE_ZONE_END(z0);
+}
+
+void iree_hal_shared_executable_cache_query_statistics(
+    iree_hal_shared_executable_cache_t* cache,
+    iree_hal_shared_executable_cache_statistics_t* out_statistics) {
+  IREE_ASSERT_ARGUMENT(cache);
+  IREE_ASSERT_ARGUMENT(out_statistics);
+  iree_slim_mutex_lock(&cache->mutex);
+  memcpy(out_statistics, &cache->statistics, sizeof(*out_statistics));
+  iree_slim_mutex_unlock(&cache->mutex);
+}
+
+// Loads an executable through |loader| or returns an existing one matching the
+// same key.
+static iree_status_t iree_hal_shared_executable_cache_load(
+    iree_hal_shared_executable_cache_t* cache,
+    iree_hal_executable_loader_t* loader,
+    const iree_hal_executable_params_t* executable_params,
+    iree_host_size_t worker_capacity, iree_hal_executable_t** out_executable) {
+  // Cached executables outlive the callers that originally requested them and
+  // may be handed to other callers with their own copies of the data. We can't
+  // allow loaders to alias any particular caller's data.
+  iree_hal_executable_params_t params = *executable_params;
+  params.caching_mode &= ~IREE_HAL_EXECUTABLE_CACHING_MODE_ALIAS_PROVIDED_DATA;
+
+  if (params.pipeline_layout_count > 0 && !params.pipeline_layouts) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "pipeline layouts must be provided");
+  }
+  iree_hal_shared_executable_cache_layout_t* layouts =
+      (iree_hal_shared_executable_cache_layout_t*)iree_alloca(
+          params.pipeline_layout_count * sizeof(*layouts));
+  for (iree_host_size_t i = 0; i < params.pipeline_layout_count; ++i) {
+    iree_hal_shared_executable_cache_layout_from_pipeline_layout(
+        params.pipeline_layouts[i], &layouts[i]);
+  }
+  iree_hal_shared_executable_cache_key_t key = {
+      .loader = loader,
+      .caching_mode = params.caching_mode,
+      .worker_capacity = worker_capacity,
+      .executable_format = params.executable_format,
+      .executable_data = params.executable_data,
+      .constant_count = params.constant_count,
+      .constants = params.constants,
+      .layout_count = params.pipeline_layout_count,
+      .layouts = layouts,
+  };
+  key.hash = iree_hal_shared_executable_cache_key_hash(&key);
+
+  iree_slim_mutex_lock(&cache->mutex);
+  iree_hal_executable_t* executable =
+      iree_hal_shared_executable_cache_lookup_locked(cache, &key);
+  if (executable) ++cache->statistics.hit_count;
+  iree_slim_mutex_unlock(&cache->mutex);
+  if (executable) {
+    *out_executable = executable;
+    return iree_ok_status();
+  }
+
+  // Load without holding the lock so that unrelated executables can load
+  // concurrently. If another thread races us to load the same executable we'll
+  // drop ours and use theirs below.
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_hal_executable_loader_try_load(loader, &params, worker_capacity,
+                                              &executable));
+
+  iree_hal_shared_executable_cache_entry_t* entry = NULL;
+  iree_status_t status = iree_hal_shared_executable_cache_entry_allocate(
+      cache->host_allocator, &key, &entry);
+  if (!iree_status_is_ok(status)) {
+    iree_hal_executable_release(executable);
+    IREE_TRACE_ZONE_END(z0);
+    return status;
+  }
+
+  iree_slim_mutex_lock(&cache->mutex);
+  iree_hal_executable_t* existing_executable =
+      iree_hal_shared_executable_cache_lookup_locked(cache, &key);
+  if (existing_executable) {
+    ++cache->statistics.hit_count;
+  } else {
+    iree_hal_shared_executable_cache_trim_locked(cache);
+    iree_hal_shared_executable_cache_entry_t** bucket =
+        iree_hal_shared_executable_cache_bucket(cache, &key);
+    entry->next = *bucket;
+    entry->executable = executable;
+    iree_hal_executable_retain(executable);
+    iree_hal_executable_loader_retain(loader);
+    *bucket = entry;
+    entry = NULL;
+    ++cache->statistics.miss_count;
+    ++cache->statistics.entry_count;
+  }
+  iree_slim_mutex_unlock(&cache->mutex);
+
+  if (existing_executable) {
+    iree_allocator_free(cache->host_allocator, entry);
+    iree_hal_executable_release(executable);
+    executable = existing_executable;
+  }
+  *out_executable = executable;
+  IREE_TRACE_ZONE_END(z0);
+  return iree_ok_status();
+}
+
+//===----------------------------------------------------------------------===//
+// iree_hal_shared_executable_loader_t
+//===----------------------------------------------------------------------===//
+
+typedef struct iree_hal_shared_executable_loader_t {
+  iree_hal_executable_loader_t base;
+  iree_allocator_t host_allocator;
+  iree_hal_shared_executable_cache_t* cache;
+  iree_hal_executable_loader_t* base_loader;
+} iree_hal_shared_executable_loader_t;
+
+static const iree_hal_executable_loader_vtable_t
+    iree_hal_shared_executable_loader_vtable;
+
+iree_status_t iree_hal_shared_executable_cache_wrap_loader(
+    iree_hal_shared_executable_cache_t* cache,
+    iree_hal_executable_loader_t* base_loader, iree_allocator_t host_allocator,
+    iree_hal_executable_loader_t** out_executable_loader) {
+  IREE_ASSERT_ARGUMENT(cache);
+  IREE_ASSERT_ARGUMENT(base_loader);
+  IREE_ASSERT_ARGUMENT(out_executable_loader);
+  *out_executable_loader = NULL;
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  iree_hal_shared_executable_loader_t* executable_loader = NULL;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_allocator_malloc(host_allocator, sizeof(*executable_loader),
+                                (void**)&executable_loader));
+  iree_hal_executable_loader_initialize(
+      &iree_hal_shared_executable_loader_vtable, base_loader->import_provider,
+      &executable_loader->base);
+  executable_loader->host_allocator = host_allocator;
+  executable_loader->cache = cache;
+  iree_hal_shared_executable_cache_retain(cache);
+  executable_loader->base_loader = base_loader;
+  iree_hal_executable_loader_retain(base_loader);
+
+  *out_executable_loader = (iree_hal_executable_loader_t*)executable_loader;
+  IREE_TRACE_ZONE_END(z0);
+  return iree_ok_status();
+}
+
+static void iree_hal_shared_executable_loader_destroy(
+    iree_hal_executable_loader_t* base_executable_loader) {
+  iree_hal_shared_executable_loader_t* executable_loader =
+      (iree_hal_shared_executable_loader_t*)base_executable_loader;
+  iree_allocator_t host_allocator = executable_loader->host_allocator;
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  // Drop any executables only the cache was keeping alive so that the base
+  // loader they retain can be released if this was the last wrapper using it.
+  iree_hal_shared_executable_cache_trim(executable_loader->cache);
+  iree_hal_executable_loader_release(executable_loader->base_loader);
+  iree_hal_shared_executable_cache_release(executable_loader->cache);
+  iree_allocator_free(host_allocator, executable_loader);
+
+  IREE_TRACE_ZONE_END(z0);
+}
+
+static bool iree_hal_shared_executable_loader_query_support(
+    iree_hal_executable_loader_t* base_executable_loader,
+    iree_hal_executable_caching_mode_t caching_mode,
+    iree_string_view_t executable_format) {
+  iree_hal_shared_executable_loader_t* executable_loader =
+      (iree_hal_shared_executable_loader_t*)base_executable_loader;
+  return iree_hal_executable_loader_query_support(
+      executable_loader->base_loader, caching_mode, executable_format);
+}
+
+static iree_status_t iree_hal_shared_executable_loader_try_load(
+    iree_hal_executable_loader_t* base_executable_loader,
+    const iree_hal_executable_params_t* executable_params,
+    iree_host_size_t worker_capacity, iree_hal_executable_t** out_executable) {
+  iree_hal_shared_executable_loader_t* executable_loader =
+      (iree_hal_shared_executable_loader_t*)base_executable_loader;
+  return iree_hal_shared_executable_cache_load(
+      executable_loader->cache, executable_loader->base_loader,
+      executable_params, worker_capacity, out_executable);
+}
+
+static const iree_hal_executable_loader_vtable_t
+    iree_hal_shared_executable_loader_vtable = {
+        .destroy = iree_hal_shared_executable_loader_destroy,
+        .query_support = iree_hal_shared_executable_loader_query_support,
+        .try_load = iree_hal_shared_executable_loader_try_load,
+};
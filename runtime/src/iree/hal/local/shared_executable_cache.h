@@ -0,0 +1,97 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_HAL_LOCAL_SHARED_EXECUTABLE_CACHE_H_
+#define IREE_HAL_LOCAL_SHARED_EXECUTABLE_CACHE_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "iree/base/api.h"
+#include "iree/hal/api.h"
+#include "iree/hal/local/executable_loader.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+//===----------------------------------------------------------------------===//
+// iree_hal_shared_executable_cache_t
+//===----------------------------------------------------------------------===//
+
+// Statistics tracked by the shared cache over its lifetime.
+typedef struct iree_hal_shared_executable_cache_statistics_t {
+  // Total number of loads that were serviced by an existing executable.
+  uint64_t hit_count;
+  // Total number of loads that had to go to the underlying loader.
+  uint64_t miss_count;
+  // Number of executables currently resident in the cache.
+  iree_host_size_t entry_count;
+} iree_hal_shared_executable_cache_statistics_t;
+
+// A content-addressed cache of loaded executables that can be shared by any
+// number of local devices, drivers, and contexts within a process.
+//
+// Executables are keyed by the loader that produced them, the executable format
+// and caching mode, the executable data and specialization constants, the
+// worker capacity they were loaded for, and the structural layout of their
+// pipeline layouts. Entries keep a copy of the executable data and matches are
+// confirmed by comparing it byte-for-byte. Requests for an executable that
+// matches an existing entry receive a new reference to the existing executable
+// instead of having the loader re-load (and for ELFs re-relocate) the same
+// data.
+//
+// The cache is not consulted directly but instead through loaders returned by
+// iree_hal_shared_executable_cache_wrap_loader. The wrapped loaders can be
+// passed to any number of devices (such as one local-task device per NUMA node)
+// and all executables loaded through them will be deduplicated.
+//
+// The cache retains each executable it hands out. Entries are evicted by
+// iree_hal_shared_executable_cache_trim once the cache holds the last
+// reference; trimming happens automatically as new executables are inserted.
+//
+// Thread-safe - multiple threads may load executables (including the *same*
+// executable) simultaneously.
+typedef struct iree_hal_shared_executable_cache_t
+    iree_hal_shared_executable_cache_t;
+
+// Creates a new empty shared executable cache.
+iree_status_t iree_hal_shared_executable_cache_create(
+    iree_allocator_t host_allocator,
+    iree_hal_shared_executable_cache_t** out_cache);
+
+// Retains the given |cache| for the caller.
+void iree_hal_shared_executable_cache_retain(
+    iree_hal_shared_executable_cache_t* cache);
+
+// Releases the given |cache| from the caller.
+void iree_hal_shared_executable_cache_release(
+    iree_hal_shared_executable_cache_t* cache);
+
+// Wraps |base_loader| such that all executables it loads are deduplicated
+// through |cache|. The returned loader retains both |cache| and |base_loader|.
+// Wrapping the same |base_loader| multiple times (or with multiple caches) is
+// allowed and executables will be shared across all wrappers of the same cache.
+iree_status_t iree_hal_shared_executable_cache_wrap_loader(
+    iree_hal_shared_executable_cache_t* cache,
+    iree_hal_executable_loader_t* base_loader, iree_allocator_t host_allocator,
+    iree_hal_executable_loader_t** out_executable_loader);
+
+// Drops all cached executables that are no longer referenced outside of the
+// cache. Executables still in use remain cached.
+void iree_hal_shared_executable_cache_trim(
+    iree_hal_shared_executable_cache_t* cache);
+
+// Queries the current statistics of the |cache|.
+void iree_hal_shared_executable_cache_query_statistics(
+    iree_hal_shared_executable_cache_t* cache,
+    iree_hal_shared_executable_cache_statistics_t* out_statistics);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif  // IREE_HAL_LOCAL_SHARED_EXECUTABLE_CACHE_H_
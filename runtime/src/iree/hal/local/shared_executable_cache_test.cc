@@ -0,0 +1,213 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/hal/local/shared_executable_cache.h"
+
+#include "iree/base/api.h"
+#include "iree/hal/api.h"
+#include "iree/hal/local/executable_library_demo.h"
+#include "iree/hal/local/loaders/static_library_loader.h"
+#include "iree/testing/gtest.h"
+#include "iree/testing/status_matchers.h"
+
+namespace iree {
+namespace hal {
+namespace {
+
+// Copies of the demo library registered under long names that differ only in
+// a single byte in the middle. The cache only hashes the start and end of the
+// executable data so these land on the same hash and must be told apart by
+// comparing their contents.
+struct LongNameLibrary {
+  char name[2048];
+  iree_hal_executable_library_header_t header;
+  iree_hal_executable_library_v0_t library;
+
+  void Initialize(char distinguisher) {
+    memset(name, 'x', sizeof(name) - 1);
+    name[sizeof(name) / 2] = distinguisher;
+    name[sizeof(name) - 1] = 0;
+    const iree_hal_executable_library_v0_t* demo_library =
+        (const iree_hal_executable_library_v0_t*)demo_executable_library_query(
+            IREE_HAL_EXECUTABLE_LIBRARY_VERSION_LATEST, NULL);
+    header = *demo_library->header;
+    header.name = name;
+    library = *demo_library;
+    library.header = &header;
+  }
+};
+static LongNameLibrary long_name_libraries[2];
+
+static const iree_hal_executable_library_header_t** long_name_library_a_query(
+    iree_hal_executable_library_version_t max_version,
+    const iree_hal_executable_environment_v0_t* environment) {
+  return (const iree_hal_executable_library_header_t**)&long_name_libraries[0]
+      .library;
+}
+
+static const iree_hal_executable_library_header_t** long_name_library_b_query(
+    iree_hal_executable_library_version_t max_version,
+    const iree_hal_executable_environment_v0_t* environment) {
+  return (const iree_hal_executable_library_header_t**)&long_name_libraries[1]
+      .library;
+}
+
+struct SharedExecutableCacheTest : public ::testing::Test {
+  iree_allocator_t host_allocator = iree_allocator_system();
+  iree_hal_executable_loader_t* base_loader = NULL;
+  iree_hal_shared_executable_cache_t* cache = NULL;
+
+  void SetUp() override {
+    long_name_libraries[0].Initialize('a');
+    long_name_libraries[1].Initialize('b');
+    const iree_hal_executable_library_query_fn_t library_query_fns[] = {
+        demo_executable_library_query,
+        long_name_library_a_query,
+        long_name_library_b_query,
+    };
+    IREE_ASSERT_OK(iree_hal_static_library_loader_create(
+        IREE_ARRAYSIZE(library_query_fns), library_query_fns,
+        iree_hal_executable_import_provider_null(), host_allocator,
+        &base_loader));
+    IREE_ASSERT_OK(
+        iree_hal_shared_executable_cache_create(host_allocator, &cache));
+  }
+
+  void TearDown() override {
+    iree_hal_shared_executable_cache_release(cache);
+    iree_hal_executable_loader_release(base_loader);
+  }
+
+  iree_hal_shared_executable_cache_statistics_t QueryStatistics() {
+    iree_hal_shared_executable_cache_statistics_t statistics;
+    iree_hal_shared_executable_cache_query_statistics(cache, &statistics);
+    return statistics;
+  }
+
+  static iree_status_t LoadDemo(iree_hal_executable_loader_t* loader,
+                                iree_host_size_t worker_capacity,
+                                iree_hal_executable_t** out_executable) {
+    return LoadLibrary(loader, "demo_library", worker_capacity,
+                       out_executable);
+  }
+
+  static iree_status_t LoadLibrary(iree_hal_executable_loader_t* loader,
+                                   const char* library_name,
+                                   iree_host_size_t worker_capacity,
+                                   iree_hal_executable_t** out_executable) {
+    iree_hal_executable_params_t executable_params;
+    iree_hal_executable_params_initialize(&executable_params);
+    executable_params.caching_mode =
+        IREE_HAL_EXECUTABLE_CACHING_MODE_ALIAS_PROVIDED_DATA;
+    executable_params.executable_format = IREE_SV("static");
+    executable_params.executable_data =
+        iree_make_const_byte_span(library_name, strlen(library_name));
+    return iree_hal_executable_loader_try_load(
+        loader, &executable_params, worker_capacity, out_executable);
+  }
+};
+
+// Tests that the same executable loaded through multiple wrappers is shared.
+TEST_F(SharedExecutableCacheTest, DeduplicatesAcrossWrappers) {
+  iree_hal_executable_loader_t* loader_a = NULL;
+  IREE_ASSERT_OK(iree_hal_shared_executable_cache_wrap_loader(
+      cache, base_loader, host_allocator, &loader_a));
+  iree_hal_executable_loader_t* loader_b = NULL;
+  IREE_ASSERT_OK(iree_hal_shared_executable_cache_wrap_loader(
+      cache, base_loader, host_allocator, &loader_b));
+
+  iree_hal_executable_t* executable_a = NULL;
+  IREE_ASSERT_OK(LoadDemo(loader_a, /*worker_capacity=*/1, &executable_a));
+  iree_hal_executable_t* executable_b = NULL;
+  IREE_ASSERT_OK(LoadDemo(loader_b, /*worker_capacity=*/1, &executable_b));
+  EXPECT_EQ(executable_a, executable_b);
+
+  auto statistics = QueryStatistics();
+  EXPECT_EQ(statistics.miss_count, 1);
+  EXPECT_EQ(statistics.hit_count, 1);
+  EXPECT_EQ(statistics.entry_count, 1);
+
+  iree_hal_executable_release(executable_a);
+  iree_hal_executable_release(executable_b);
+  iree_hal_executable_loader_release(loader_a);
+  iree_hal_executable_loader_release(loader_b);
+}
+
+// Tests that executables loaded with different parameters are not shared.
+TEST_F(SharedExecutableCacheTest, DistinctKeys) {
+  iree_hal_executable_loader_t* loader = NULL;
+  IREE_ASSERT_OK(iree_hal_shared_executable_cache_wrap_loader(
+      cache, base_loader, host_allocator, &loader));
+
+  iree_hal_executable_t* executable_a = NULL;
+  IREE_ASSERT_OK(LoadDemo(loader, /*worker_capacity=*/1, &executable_a));
+  iree_hal_executable_t* executable_b = NULL;
+  IREE_ASSERT_OK(LoadDemo(loader, /*worker_capacity=*/4, &executable_b));
+  EXPECT_NE(executable_a, executable_b);
+
+  auto statistics = QueryStatistics();
+  EXPECT_EQ(statistics.miss_count, 2);
+  EXPECT_EQ(statistics.hit_count, 0);
+  EXPECT_EQ(statistics.entry_count, 2);
+
+  iree_hal_executable_release(executable_a);
+  iree_hal_executable_release(executable_b);
+  iree_hal_executable_loader_release(loader);
+}
+
+// Tests that executables whose data hashes the same but differs are not shared.
+TEST_F(SharedExecutableCacheTest, HashCollisionComparesContents) {
+  iree_hal_executable_loader_t* loader = NULL;
+  IREE_ASSERT_OK(iree_hal_shared_executable_cache_wrap_loader(
+      cache, base_loader, host_allocator, &loader));
+
+  iree_hal_executable_t* executable_a = NULL;
+  IREE_ASSERT_OK(LoadLibrary(loader, long_name_libraries[0].name,
+                             /*worker_capacity=*/1, &executable_a));
+  iree_hal_executable_t* executable_b = NULL;
+  IREE_ASSERT_OK(LoadLibrary(loader, long_name_libraries[1].name,
+                             /*worker_capacity=*/1, &executable_b));
+  EXPECT_NE(executable_a, executable_b);
+  EXPECT_EQ(QueryStatistics().miss_count, 2);
+
+  // Reloading either one finds the matching entry.
+  iree_hal_executable_t* executable_c = NULL;
+  IREE_ASSERT_OK(LoadLibrary(loader, long_name_libraries[1].name,
+                             /*worker_capacity=*/1, &executable_c));
+  EXPECT_EQ(executable_b, executable_c);
+  EXPECT_EQ(QueryStatistics().hit_count, 1);
+
+  iree_hal_executable_release(executable_a);
+  iree_hal_executable_release(executable_b);
+  iree_hal_executable_release(executable_c);
+  iree_hal_executable_loader_release(loader);
+}
+
+// Tests that trimming only evicts executables no longer used outside the cache.
+TEST_F(SharedExecutableCacheTest, TrimEvictsUnused) {
+  iree_hal_executable_loader_t* loader = NULL;
+  IREE_ASSERT_OK(iree_hal_shared_executable_cache_wrap_loader(
+      cache, base_loader, host_allocator, &loader));
+
+  iree_hal_executable_t* executable = NULL;
+  IREE_ASSERT_OK(LoadDemo(loader, /*worker_capacity=*/1, &executable));
+  iree_hal_shared_executable_cache_trim(cache);
+  EXPECT_EQ(QueryStatistics().entry_count, 1);
+
+  iree_hal_executable_release(executable);
+  iree_hal_shared_executable_cache_trim(cache);
+  EXPECT_EQ(QueryStatistics().entry_count, 0);
+
+  // Reloading after eviction goes back to the base loader.
+  IREE_ASSERT_OK(LoadDemo(loader, /*worker_capacity=*/1, &executable));
+  EXPECT_EQ(QueryStatistics().miss_count, 2);
+  iree_hal_executable_release(executable);
+  iree_hal_executable_loader_release(loader);
+}
+
+}  // namespace
+}  // namespace hal
+}  // namespace iree
@@ -32,6 +32,31 @@ static void iree_hal_semaphore_timepoint_list_push_back(
   list->tail = timepoint;
 }
 
+// Inserts |timepoint| into |list| after all timepoints with a minimum_value
+// less than or equal to its own. Timepoints are usually acquired with
+// increasing values so we search backwards from the tail.
+static void iree_hal_semaphore_timepoint_list_insert_ordered(
+    iree_hal_semaphore_timepoint_list_t* list,
+    iree_hal_semaphore_timepoint_t* timepoint) {
+  iree_hal_semaphore_timepoint_t* prev = list->tail;
+  while (prev && prev->minimum_value > timepoint->minimum_value) {
+    prev = prev->prev;
+  }
+  iree_hal_semaphore_timepoint_t* next = prev ? prev->next : list->head;
+  timepoint->prev = prev;
+  timepoint->next = next;
+  if (prev) {
+    prev->next = timepoint;
+  } else {
+    list->head = timepoint;
+  }
+  if (next) {
+    next->prev = timepoint;
+  } else {
+    list->tail = timepoint;
+  }
+}
+
 // Erases |timepoint| from |list|.
 static void iree_hal_semaphore_timepoint_list_erase(
     iree_hal_semaphore_timepoint_list_t* list,
@@ -63,6 +88,49 @@ static void iree_hal_semaphore_timepoint_list_take_all(
   available_list->tail = NULL;
 }
 
+// Pushes |timepoint| on to the pending stack of |semaphore| without locking.
+static void iree_hal_semaphore_push_pending_timepoint(
+    iree_hal_semaphore_t* semaphore,
+    iree_hal_semaphore_timepoint_t* timepoint) {
+  intptr_t head = iree_atomic_load_intptr(&semaphore->pending_timepoints,
+                                          iree_memory_order_relaxed);
+  do {
+    timepoint->next = (iree_hal_semaphore_timepoint_t*)head;
+  } while (!iree_atomic_compare_exchange_weak_intptr(
+      &semaphore->pending_timepoints, &head, (intptr_t)timepoint,
+      iree_memory_order_release, iree_memory_order_relaxed));
+}
+
+// Merges all pending timepoints into the ordered timepoint list.
+// NOTE: semaphore timepoint lock must be held.
+static void iree_hal_semaphore_merge_pending_timepoints(
+    iree_hal_semaphore_t* semaphore) {
+  iree_hal_semaphore_timepoint_t* pending =
+      (iree_hal_semaphore_timepoint_t*)iree_atomic_exchange_intptr(
+          &semaphore->pending_timepoints, 0, iree_memory_order_acquire);
+  if (!pending) return;
+
+  // The stack is in LIFO order; reverse it so that timepoints with the same
+  // value are kept in the order they were acquired.
+  iree_hal_semaphore_timepoint_t* fifo = NULL;
+  while (pending) {
+    iree_hal_semaphore_timepoint_t* next = pending->next;
+    pending->next = fifo;
+    fifo = pending;
+    pending = next;
+  }
+
+  while (fifo) {
+    iree_hal_semaphore_timepoint_t* next = fifo->next;
+    if (fifo->deadline_ns < semaphore->earliest_deadline_ns) {
+      semaphore->earliest_deadline_ns = fifo->deadline_ns;
+    }
+    iree_hal_semaphore_timepoint_list_insert_ordered(&semaphore->timepoint_list,
+                                                     fifo);
+    fifo = next;
+  }
+}
+
 // Issues the callback for the given |timepoint| and resets it.
 static void iree_hal_semaphore_issue_timepoint_callback(
     iree_hal_semaphore_t* semaphore, uint64_t new_value,
@@ -112,45 +180,52 @@ static void iree_hal_semaphore_resolve_timepoints(
     iree_hal_semaphore_t* semaphore, uint64_t new_value) {
   IREE_TRACE_ZONE_BEGIN(z0);
 
-  iree_hal_semaphore_timepoint_list_t pending_list = {NULL, NULL};
   iree_hal_semaphore_timepoint_list_t ready_list = {NULL, NULL};
   iree_hal_semaphore_timepoint_list_t expired_list = {NULL, NULL};
 
   iree_slim_mutex_lock(&semaphore->timepoint_mutex);
+  iree_hal_semaphore_merge_pending_timepoints(semaphore);
 
-  if (iree_hal_semaphore_timepoint_list_is_empty(&semaphore->timepoint_list)) {
+  iree_hal_semaphore_timepoint_list_t* list = &semaphore->timepoint_list;
+  if (iree_hal_semaphore_timepoint_list_is_empty(list)) {
     iree_slim_mutex_unlock(&semaphore->timepoint_mutex);
     IREE_TRACE_ZONE_END(z0);
     return;
   }
 
-  // Scan through the list and divvy up timepoints into still-pending, ready to
-  // resolve, and expired buckets.
-  iree_time_t now_ns = iree_time_now();
-  for (iree_hal_semaphore_timepoint_t* timepoint =
-           semaphore->timepoint_list.head;
-       timepoint != NULL;) {
-    iree_hal_semaphore_timepoint_t* next_timepoint = timepoint->next;
-    timepoint->next = NULL;
+  // The list is ordered by value so all reached timepoints are at the head.
+  // Even if the deadline has been reached we'll still consider this a hit.
+  while (list->head && list->head->minimum_value <= new_value) {
+    iree_hal_semaphore_timepoint_t* timepoint = list->head;
+    iree_hal_semaphore_timepoint_list_erase(list, timepoint);
+    iree_hal_semaphore_timepoint_list_push_back(&ready_list, timepoint);
+  }
 
-    if (timepoint->minimum_value <= new_value) {
-      // Reached the timepoint; even if the deadline has been reached we'll
-      // still consider this a hit.
-      iree_hal_semaphore_timepoint_list_push_back(&ready_list, timepoint);
-    } else if (timepoint->deadline_ns <= now_ns) {
-      // Deadline expired before the timepoint was reached.
-      iree_hal_semaphore_timepoint_list_push_back(&expired_list, timepoint);
-    } else {
-      // Still pending.
-      iree_hal_semaphore_timepoint_list_push_back(&pending_list, timepoint);
+  // Deadlines are unordered and need a scan of the remaining timepoints but
+  // only once the earliest of them may have been reached.
+  iree_time_t now_ns =
+      semaphore->earliest_deadline_ns != IREE_TIME_INFINITE_FUTURE
+          ? iree_time_now()
+          : IREE_TIME_INFINITE_PAST;
+  if (semaphore->earliest_deadline_ns <= now_ns) {
+    iree_time_t earliest_deadline_ns = IREE_TIME_INFINITE_FUTURE;
+    for (iree_hal_semaphore_timepoint_t* timepoint = list->head;
+         timepoint != NULL;) {
+      iree_hal_semaphore_timepoint_t* next_timepoint = timepoint->next;
+      if (timepoint->deadline_ns <= now_ns) {
+        // Deadline expired before the timepoint was reached.
+        iree_hal_semaphore_timepoint_list_erase(list, timepoint);
+        iree_hal_semaphore_timepoint_list_push_back(&expired_list, timepoint);
+      } else if (timepoint->deadline_ns < earliest_deadline_ns) {
+        earliest_deadline_ns = timepoint->deadline_ns;
+      }
+      timepoint = next_timepoint;
     }
-
-    timepoint = next_timepoint;
+    semaphore->earliest_deadline_ns = earliest_deadline_ns;
+  } else if (iree_hal_semaphore_timepoint_list_is_empty(list)) {
+    semaphore->earliest_deadline_ns = IREE_TIME_INFINITE_FUTURE;
   }
 
-  // Preserve pending timepoints.
-  semaphore->timepoint_list = pending_list;
-
   // Issue callbacks for all successes and failures.
   iree_hal_semaphore_issue_timepoint_callbacks(semaphore, new_value,
                                                IREE_STATUS_OK, &ready_list);
@@ -168,11 +243,13 @@ static void iree_hal_semaphore_reject_timepoints(
   IREE_TRACE_ZONE_BEGIN(z0);
 
   iree_slim_mutex_lock(&semaphore->timepoint_mutex);
+  iree_hal_semaphore_merge_pending_timepoints(semaphore);
 
   // Take the entire timepoint list from the semaphore.
   iree_hal_semaphore_timepoint_list_t failed_list = {NULL, NULL};
   iree_hal_semaphore_timepoint_list_take_all(&semaphore->timepoint_list,
                                              &failed_list);
+  semaphore->earliest_deadline_ns = IREE_TIME_INFINITE_FUTURE;
 
   // Issue failure callbacks for all timepoints.
   iree_hal_semaphore_issue_timepoint_callbacks(semaphore, UINT64_MAX,
@@ -192,9 +269,12 @@ IREE_API_EXPORT void iree_hal_semaphore_initialize(
     iree_hal_semaphore_t* out_semaphore) {
   IREE_ASSERT_ARGUMENT(out_semaphore);
   iree_hal_resource_initialize(vtable, &out_semaphore->resource);
+  iree_atomic_store_intptr(&out_semaphore->pending_timepoints, 0,
+                           iree_memory_order_relaxed);
   iree_slim_mutex_initialize(&out_semaphore->timepoint_mutex);
   memset(&out_semaphore->timepoint_list, 0,
          sizeof(out_semaphore->timepoint_list));
+  out_semaphore->earliest_deadline_ns = IREE_TIME_INFINITE_FUTURE;
 }
 
 IREE_API_EXPORT void iree_hal_semaphore_deinitialize(
@@ -222,13 +302,10 @@ IREE_API_EXPORT void iree_hal_semaphore_acquire_timepoint(
   out_timepoint->deadline_ns = iree_timeout_as_deadline_ns(timeout);
   out_timepoint->callback = callback;
 
-  // Insert into timepoint list.
-  // After we release the lock the callback may be issued immediately as another
-  // thread may be waiting to signal the timepoint.
-  iree_slim_mutex_lock(&semaphore->timepoint_mutex);
-  iree_hal_semaphore_timepoint_list_push_back(&semaphore->timepoint_list,
-                                              out_timepoint);
-  iree_slim_mutex_unlock(&semaphore->timepoint_mutex);
+  // Publish to the pending stack; the next thread to notify, poll, or cancel
+  // merges it into the ordered timepoint list. Once pushed the callback may be
+  // issued immediately as another thread may be signaling the semaphore.
+  iree_hal_semaphore_push_pending_timepoint(semaphore, out_timepoint);
 
   IREE_TRACE_ZONE_END(z0);
 }
@@ -241,6 +318,10 @@ IREE_API_EXPORT void iree_hal_semaphore_cancel_timepoint(
 
   iree_slim_mutex_lock(&semaphore->timepoint_mutex);
 
+  // The timepoint may still be on the pending stack; merge it into the list so
+  // that it can be erased.
+  iree_hal_semaphore_merge_pending_timepoints(semaphore);
+
   // NOTE: if the semaphore is NULL then the timepoint has already been issued.
   // The caller is expected to know it's safe to still use the timepoint struct
   // even if such a race is possible.
@@ -11,6 +11,7 @@
 #include <stdint.h>
 
 #include "iree/base/api.h"
+#include "iree/base/internal/atomics.h"
 #include "iree/base/internal/synchronization.h"
 #include "iree/hal/api.h"
 
@@ -43,7 +44,8 @@ typedef struct iree_hal_semaphore_callback_t {
 // callback when the semaphore is signaled to or beyond a given value.
 typedef struct iree_hal_semaphore_timepoint_t {
   // Intrusive doubly-linked list next entry pointer.
-  // Guarded by the semaphore mutex.
+  // Guarded by the semaphore mutex once in the timepoint list; before that it
+  // links the lock-free pending stack.
   struct iree_hal_semaphore_timepoint_t* next;
   // Intrusive doubly-linked list previous entry pointer.
   // Guarded by the semaphore mutex.
@@ -66,9 +68,8 @@ typedef struct iree_hal_semaphore_timepoint_t {
   iree_hal_semaphore_callback_t callback;
 } iree_hal_semaphore_timepoint_t;
 
-// A doubly-linked FIFO list of timepoints.
-// The order of the timepoints does *not* match increasing payload values but
-// instead the order they were added to the list.
+// A doubly-linked list of timepoints ordered by increasing minimum_value.
+// Timepoints with the same minimum_value are kept in the order they were added.
 //
 // Note that the timepoints are not owned by the list - this just nicely
 // stitches together timepoints for easier management.
@@ -92,17 +93,26 @@ typedef struct iree_hal_semaphore_timepoint_list_t {
 struct iree_hal_semaphore_t {
   iree_hal_resource_t resource;  // must be at 0
 
+  // Lock-free LIFO stack of timepoints acquired since the timepoint list was
+  // last updated, linked through iree_hal_semaphore_timepoint_t::next.
+  // Acquiring a timepoint only pushes here; whichever thread next takes the
+  // timepoint mutex merges the stack into |timepoint_list|.
+  iree_atomic_intptr_t pending_timepoints;
+
   // Non-recursive mutex guarding access to the timepoint list.
   iree_slim_mutex_t timepoint_mutex;
 
-  // Timepoint list in insertion order.
-  // There are probably better orderings we could use here that allow us to
-  // walk the entire list less frequently, though target payload value is not
-  // enough as deadlines still require the scan. We could sort by non-infinite
-  // deadlines first and then infinite ones last but given the common timepoint
-  // counts (0..1) it's not worth the complexity today.
+  // Timepoint list ordered by increasing minimum_value so that notifications
+  // only visit the satisfied prefix of the list. Pipelined submissions acquire
+  // timepoints in increasing order and are inserted at the tail in O(1).
   iree_hal_semaphore_timepoint_list_t timepoint_list
       IREE_GUARDED_BY(timepoint_mutex);
+
+  // Lower bound on the deadlines of all timepoints in |timepoint_list|.
+  // Deadlines are unordered in the list and it is only scanned for expired
+  // timepoints once this has been reached. IREE_TIME_INFINITE_FUTURE if no
+  // timepoint has a deadline.
+  iree_time_t earliest_deadline_ns IREE_GUARDED_BY(timepoint_mutex);
 };
 
 // Initializes the base |out_semaphore| resource.
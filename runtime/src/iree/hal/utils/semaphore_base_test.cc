@@ -11,6 +11,7 @@
 #include <memory>
 #include <string>
 #include <thread>
+#include <vector>
 
 #include "iree/base/api.h"
 #include "iree/base/internal/wait_handle.h"
@@ -374,6 +375,104 @@ TEST_F(TrackingSemaphoreTest, CancelResolvedTimepoint) {
   iree_hal_semaphore_release(*semaphore);
 }
 
+// Tests that timepoints acquired out of order only resolve once reached.
+TEST_F(TrackingSemaphoreTest, ResolveOutOfOrderTimepoints) {
+  auto* semaphore = TestSemaphore::Create(0ull, host_allocator);
+
+  const uint64_t kValues[] = {3ull, 1ull, 4ull, 2ull, 2ull};
+  constexpr size_t kCount = IREE_ARRAYSIZE(kValues);
+  CallbackState states[kCount];
+  iree_hal_semaphore_timepoint_t timepoints[kCount];
+  for (size_t i = 0; i < kCount; ++i) {
+    iree_hal_semaphore_acquire_timepoint(*semaphore, kValues[i],
+                                         iree_infinite_timeout(),
+                                         MakeCallback(&states[i]),
+                                         &timepoints[i]);
+  }
+
+  // Only timepoints <= 2 are reached.
+  IREE_ASSERT_OK(iree_hal_semaphore_signal(*semaphore, 2ull));
+  for (size_t i = 0; i < kCount; ++i) {
+    EXPECT_EQ(states[i].callback_count, kValues[i] <= 2ull ? 1 : 0);
+  }
+
+  // Cancel one of the remaining timepoints and reach the rest.
+  iree_hal_semaphore_cancel_timepoint(*semaphore, &timepoints[0]);
+  IREE_ASSERT_OK(iree_hal_semaphore_signal(*semaphore, 4ull));
+  EXPECT_EQ(states[0].callback_count, 0);
+  EXPECT_EQ(states[2].callback_count, 1);
+  EXPECT_EQ(states[2].status_code, IREE_STATUS_OK);
+  EXPECT_EQ(states[2].value, 4ull);
+
+  iree_hal_semaphore_release(*semaphore);
+}
+
+// Tests that timepoints expire once their deadline is reached even if other
+// timepoints in the list are still pending.
+TEST_F(TrackingSemaphoreTest, ExpireTimepoint) {
+  auto* semaphore = TestSemaphore::Create(0ull, host_allocator);
+
+  CallbackState infinite_state;
+  iree_hal_semaphore_timepoint_t infinite_timepoint;
+  iree_hal_semaphore_acquire_timepoint(
+      *semaphore, 2ull, iree_infinite_timeout(),
+      MakeCallback(&infinite_state), &infinite_timepoint);
+  CallbackState immediate_state;
+  iree_hal_semaphore_timepoint_t immediate_timepoint;
+  iree_hal_semaphore_acquire_timepoint(
+      *semaphore, 2ull, iree_immediate_timeout(),
+      MakeCallback(&immediate_state), &immediate_timepoint);
+
+  IREE_ASSERT_OK(iree_hal_semaphore_signal(*semaphore, 1ull));
+  EXPECT_EQ(infinite_state.callback_count, 0);
+  EXPECT_EQ(immediate_state.callback_count, 1);
+  EXPECT_EQ(immediate_state.status_code, IREE_STATUS_DEADLINE_EXCEEDED);
+
+  IREE_ASSERT_OK(iree_hal_semaphore_signal(*semaphore, 2ull));
+  EXPECT_EQ(infinite_state.callback_count, 1);
+  EXPECT_EQ(infinite_state.status_code, IREE_STATUS_OK);
+  EXPECT_EQ(immediate_state.callback_count, 1);
+
+  iree_hal_semaphore_release(*semaphore);
+}
+
+// Tests acquiring timepoints from multiple threads while the semaphore is
+// being signaled.
+TEST_F(TrackingSemaphoreTest, AcquireConcurrentTimepoints) {
+  auto* semaphore = TestSemaphore::Create(0ull, host_allocator);
+
+  constexpr int kThreadCount = 4;
+  constexpr int kTimepointsPerThread = 256;
+  constexpr uint64_t kFinalValue = 1024ull;
+  std::vector<CallbackState> states(kThreadCount * kTimepointsPerThread);
+  std::vector<iree_hal_semaphore_timepoint_t> timepoints(states.size());
+
+  std::vector<std::thread> threads;
+  for (int i = 0; i < kThreadCount; ++i) {
+    threads.emplace_back([&, i]() {
+      for (int j = 0; j < kTimepointsPerThread; ++j) {
+        size_t index = i * kTimepointsPerThread + j;
+        iree_hal_semaphore_acquire_timepoint(
+            *semaphore, 1ull + (index * 7) % kFinalValue,
+            iree_infinite_timeout(), MakeCallback(&states[index]),
+            &timepoints[index]);
+      }
+    });
+  }
+  for (uint64_t value = 1ull; value < kFinalValue / 2; ++value) {
+    IREE_ASSERT_OK(iree_hal_semaphore_signal(*semaphore, value));
+  }
+  for (auto& thread : threads) thread.join();
+  IREE_ASSERT_OK(iree_hal_semaphore_signal(*semaphore, kFinalValue));
+
+  for (auto& state : states) {
+    EXPECT_EQ(state.callback_count, 1);
+    EXPECT_EQ(state.status_code, IREE_STATUS_OK);
+  }
+
+  iree_hal_semaphore_release(*semaphore);
+}
+
 }  // namespace
 }  // namespace hal
 }  // namespace iree
@@ -0,0 +1,374 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/hal/utils/statistics_allocator.h"
+
+#include <inttypes.h>
+
+#include "iree/base/internal/synchronization.h"
+
+//===----------------------------------------------------------------------===//
+// iree_hal_statistics_buffer_t
+//===----------------------------------------------------------------------===//
+
+// Subspan of an underlying allocator buffer tagged with the scope it was
+// allocated in. Destroyed by the subspan vtable which releases the underlying
+// buffer back to its own allocator.
+typedef struct iree_hal_statistics_buffer_t {
+  iree_hal_buffer_t base;  // must be at 0
+  // Scope the buffer was allocated within or 0 if no scope was active.
+  uint32_t scope_id;
+} iree_hal_statistics_buffer_t;
+
+//===----------------------------------------------------------------------===//
+// iree_hal_statistics_allocator_t
+//===----------------------------------------------------------------------===//
+
+struct iree_hal_statistics_allocator_t {
+  iree_hal_resource_t resource;
+  iree_allocator_t host_allocator;
+  iree_hal_allocator_t* device_allocator;
+
+  // Guards the fields below. Allocations are expected to be infrequent enough
+  // relative to their cost that a lock is fine.
+  iree_slim_mutex_t mutex;
+
+  // Bytes currently live in host-local and device-local memory.
+  iree_device_size_t host_bytes_live;
+  iree_device_size_t device_bytes_live;
+
+  // Identifier of the active scope or 0 if no scope is active.
+  uint32_t scope_id;
+  // Identifier assigned to the next scope.
+  uint32_t next_scope_id;
+  // Counters of the active scope.
+  iree_hal_statistics_allocator_scope_t scope;
+};
+
+static const iree_hal_allocator_vtable_t iree_hal_statistics_allocator_vtable;
+
+iree_hal_statistics_allocator_t* iree_hal_statistics_allocator_cast(
+    iree_hal_allocator_t* base_value) {
+  IREE_HAL_ASSERT_TYPE(base_value, &iree_hal_statistics_allocator_vtable);
+  return (iree_hal_statistics_allocator_t*)base_value;
+}
+
+iree_status_t iree_hal_statistics_allocator_create(
+    iree_hal_allocator_t* device_allocator, iree_allocator_t host_allocator,
+    iree_hal_allocator_t** out_allocator) {
+  IREE_ASSERT_ARGUMENT(device_allocator);
+  IREE_ASSERT_ARGUMENT(out_allocator);
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  iree_hal_statistics_allocator_t* allocator = NULL;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_allocator_malloc(host_allocator, sizeof(*allocator),
+                                (void**)&allocator));
+
+  iree_hal_resource_initialize(&iree_hal_statistics_allocator_vtable,
+                               &allocator->resource);
+  allocator->host_allocator = host_allocator;
+  allocator->device_allocator = device_allocator;
+  iree_hal_allocator_retain(allocator->device_allocator);
+  iree_slim_mutex_initialize(&allocator->mutex);
+  allocator->next_scope_id = 1;
+
+  *out_allocator = (iree_hal_allocator_t*)allocator;
+  IREE_TRACE_ZONE_END(z0);
+  return iree_ok_status();
+}
+
+static void iree_hal_statistics_allocator_destroy(
+    iree_hal_allocator_t* IREE_RESTRICT base_allocator) {
+  iree_hal_statistics_allocator_t* allocator =
+      iree_hal_statistics_allocator_cast(base_allocator);
+  iree_allocator_t host_allocator = allocator->host_allocator;
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  iree_slim_mutex_deinitialize(&allocator->mutex);
+  iree_hal_allocator_release(allocator->device_allocator);
+  iree_allocator_free(host_allocator, allocator);
+
+  IREE_TRACE_ZONE_END(z0);
+}
+
+bool iree_hal_statistics_allocator_isa(iree_hal_allocator_t* allocator) {
+  return iree_hal_resource_is(allocator, &iree_hal_statistics_allocator_vtable);
+}
+
+void iree_hal_statistics_allocator_begin_scope(
+    iree_hal_allocator_t* base_allocator) {
+  iree_hal_statistics_allocator_t* allocator =
+      iree_hal_statistics_allocator_cast(base_allocator);
+  iree_slim_mutex_lock(&allocator->mutex);
+  allocator->scope_id = allocator->next_scope_id++;
+  if (!allocator->next_scope_id) allocator->next_scope_id = 1;
+  memset(&allocator->scope, 0, sizeof(allocator->scope));
+  allocator->scope.host.bytes_live_begin = allocator->host_bytes_live;
+  allocator->scope.host.bytes_peak = allocator->host_bytes_live;
+  allocator->scope.device.bytes_live_begin = allocator->device_bytes_live;
+  allocator->scope.device.bytes_peak = allocator->device_bytes_live;
+  iree_slim_mutex_unlock(&allocator->mutex);
+}
+
+void iree_hal_statistics_allocator_end_scope(
+    iree_hal_allocator_t* base_allocator,
+    iree_hal_statistics_allocator_scope_t* out_scope) {
+  iree_hal_statistics_allocator_t* allocator =
+      iree_hal_statistics_allocator_cast(base_allocator);
+  iree_slim_mutex_lock(&allocator->mutex);
+  *out_scope = allocator->scope;
+  allocator->scope_id = 0;
+  iree_slim_mutex_unlock(&allocator->mutex);
+  out_scope->host.bytes_persistent =
+      out_scope->host.bytes_allocated - out_scope->host.bytes_transient;
+  out_scope->device.bytes_persistent =
+      out_scope->device.bytes_allocated - out_scope->device.bytes_transient;
+}
+
+iree_status_t iree_hal_statistics_allocator_scope_format(
+    const iree_hal_statistics_allocator_scope_t* scope,
+    iree_string_builder_t* builder) {
+  IREE_ASSERT_ARGUMENT(scope);
+  IREE_ASSERT_ARGUMENT(builder);
+  const struct {
+    const char* name;
+    const iree_hal_statistics_allocator_counters_t* counters;
+  } classes[2] = {
+      {"  HOST_LOCAL", &scope->host},
+      {"DEVICE_LOCAL", &scope->device},
+  };
+  for (iree_host_size_t i = 0; i < IREE_ARRAYSIZE(classes); ++i) {
+    const iree_hal_statistics_allocator_counters_t* counters =
+        classes[i].counters;
+    IREE_RETURN_IF_ERROR(iree_string_builder_append_format(
+        builder,
+        "%s: %12" PRIu64 "B peak / %12" PRIu64 "B transient / %12" PRIu64
+        "B persistent / %6" PRIu64 " allocs / %6" PRIu64 " frees\n",
+        classes[i].name, (uint64_t)counters->bytes_peak,
+        (uint64_t)counters->bytes_transient,
+        (uint64_t)counters->bytes_persistent, counters->allocation_count,
+        counters->free_count));
+  }
+  return iree_ok_status();
+}
+
+static void iree_hal_statistics_allocator_format_counters_json(
+    const char* name, const iree_hal_statistics_allocator_counters_t* counters,
+    iree_string_builder_t* builder, iree_status_t* status) {
+  if (!iree_status_is_ok(*status)) return;
+  *status = iree_string_builder_append_format(
+      builder,
+      "\"%s\": {\"allocation_count\": %" PRIu64 ", \"free_count\": %" PRIu64
+      ", \"bytes_allocated\": %" PRIu64 ", \"bytes_freed\": %" PRIu64
+      ", \"bytes_live_begin\": %" PRIu64 ", \"bytes_peak\": %" PRIu64
+      ", \"bytes_transient\": %" PRIu64 ", \"bytes_persistent\": %" PRIu64 "}",
+      name, counters->allocation_count, counters->free_count,
+      (uint64_t)counters->bytes_allocated, (uint64_t)counters->bytes_freed,
+      (uint64_t)counters->bytes_live_begin, (uint64_t)counters->bytes_peak,
+      (uint64_t)counters->bytes_transient,
+      (uint64_t)counters->bytes_persistent);
+}
+
+iree_status_t iree_hal_statistics_allocator_scope_format_json(
+    const iree_hal_statistics_allocator_scope_t* scope,
+    iree_string_builder_t* builder) {
+  IREE_ASSERT_ARGUMENT(scope);
+  IREE_ASSERT_ARGUMENT(builder);
+  iree_status_t status = iree_string_builder_append_cstring(builder, "{");
+  iree_hal_statistics_allocator_format_counters_json("host", &scope->host,
+                                                     builder, &status);
+  if (iree_status_is_ok(status)) {
+    status = iree_string_builder_append_cstring(builder, ", ");
+  }
+  iree_hal_statistics_allocator_format_counters_json("device", &scope->device,
+                                                     builder, &status);
+  if (iree_status_is_ok(status)) {
+    status = iree_string_builder_append_cstring(builder, "}");
+  }
+  return status;
+}
+
+static iree_allocator_t iree_hal_statistics_allocator_host_allocator(
+    const iree_hal_allocator_t* IREE_RESTRICT base_allocator) {
+  iree_hal_statistics_allocator_t* allocator =
+      (iree_hal_statistics_allocator_t*)base_allocator;
+  return allocator->host_allocator;
+}
+
+static iree_status_t iree_hal_statistics_allocator_trim(
+    iree_hal_allocator_t* IREE_RESTRICT base_allocator) {
+  iree_hal_statistics_allocator_t* allocator =
+      iree_hal_statistics_allocator_cast(base_allocator);
+  return iree_hal_allocator_trim(allocator->device_allocator);
+}
+
+static void iree_hal_statistics_allocator_query_statistics(
+    iree_hal_allocator_t* IREE_RESTRICT base_allocator,
+    iree_hal_allocator_statistics_t* IREE_RESTRICT out_statistics) {
+  iree_hal_statistics_allocator_t* allocator =
+      iree_hal_statistics_allocator_cast(base_allocator);
+  iree_hal_allocator_query_statistics(allocator->device_allocator,
+                                      out_statistics);
+}
+
+static iree_status_t iree_hal_statistics_allocator_query_memory_heaps(
+    iree_hal_allocator_t* IREE_RESTRICT base_allocator,
+    iree_host_size_t capacity,
+    iree_hal_allocator_memory_heap_t* IREE_RESTRICT heaps,
+    iree_host_size_t* IREE_RESTRICT out_count) {
+  iree_hal_statistics_allocator_t* allocator =
+      iree_hal_statistics_allocator_cast(base_allocator);
+  return iree_hal_allocator_query_memory_heaps(allocator->device_allocator,
+                                               capacity, heaps, out_count);
+}
+
+static iree_hal_buffer_compatibility_t
+iree_hal_statistics_allocator_query_buffer_compatibility(
+    iree_hal_allocator_t* IREE_RESTRICT base_allocator,
+    iree_hal_buffer_params_t* IREE_RESTRICT params,
+    iree_device_size_t* IREE_RESTRICT allocation_size) {
+  iree_hal_statistics_allocator_t* allocator =
+      iree_hal_statistics_allocator_cast(base_allocator);
+  return iree_hal_allocator_query_buffer_compatibility(
+      allocator->device_allocator, *params, *allocation_size, params,
+      allocation_size);
+}
+
+static iree_status_t iree_hal_statistics_allocator_allocate_buffer(
+    iree_hal_allocator_t* IREE_RESTRICT base_allocator,
+    const iree_hal_buffer_params_t* IREE_RESTRICT params,
+    iree_device_size_t allocation_size,
+    iree_hal_buffer_t** IREE_RESTRICT out_buffer) {
+  iree_hal_statistics_allocator_t* allocator =
+      iree_hal_statistics_allocator_cast(base_allocator);
+  *out_buffer = NULL;
+
+  iree_hal_buffer_t* allocated_buffer = NULL;
+  IREE_RETURN_IF_ERROR(iree_hal_allocator_allocate_buffer(
+      allocator->device_allocator, *params, allocation_size,
+      &allocated_buffer));
+
+  // Wrap the buffer in a subspan pointing back to us for deallocation. The
+  // subspan retains the allocated buffer.
+  iree_hal_statistics_buffer_t* buffer = NULL;
+  iree_status_t status = iree_allocator_malloc(
+      allocator->host_allocator, sizeof(*buffer), (void**)&buffer);
+  if (iree_status_is_ok(status)) {
+    iree_hal_subspan_buffer_initialize(
+        allocated_buffer, 0, iree_hal_buffer_byte_length(allocated_buffer),
+        base_allocator, allocator->host_allocator, &buffer->base);
+  }
+  iree_hal_buffer_release(allocated_buffer);
+  IREE_RETURN_IF_ERROR(status);
+
+  const iree_hal_memory_type_t memory_type =
+      iree_hal_buffer_memory_type(&buffer->base);
+  const iree_device_size_t size =
+      iree_hal_buffer_allocation_size(&buffer->base);
+  iree_slim_mutex_lock(&allocator->mutex);
+  buffer->scope_id = allocator->scope_id;
+  iree_device_size_t* bytes_live = NULL;
+  iree_hal_statistics_allocator_counters_t* counters = NULL;
+  if (iree_all_bits_set(memory_type, IREE_HAL_MEMORY_TYPE_HOST_LOCAL)) {
+    bytes_live = &allocator->host_bytes_live;
+    counters = &allocator->scope.host;
+  } else {
+    bytes_live = &allocator->device_bytes_live;
+    counters = &allocator->scope.device;
+  }
+  *bytes_live += size;
+  if (allocator->scope_id) {
+    ++counters->allocation_count;
+    counters->bytes_allocated += size;
+    counters->bytes_peak = iree_max(counters->bytes_peak, *bytes_live);
+  }
+  iree_slim_mutex_unlock(&allocator->mutex);
+
+  *out_buffer = &buffer->base;
+  return iree_ok_status();
+}
+
+static void iree_hal_statistics_allocator_deallocate_buffer(
+    iree_hal_allocator_t* IREE_RESTRICT base_allocator,
+    iree_hal_buffer_t* IREE_RESTRICT base_buffer) {
+  iree_hal_statistics_allocator_t* allocator =
+      iree_hal_statistics_allocator_cast(base_allocator);
+  iree_hal_statistics_buffer_t* buffer =
+      (iree_hal_statistics_buffer_t*)base_buffer;
+
+  const iree_hal_memory_type_t memory_type =
+      iree_hal_buffer_memory_type(base_buffer);
+  const iree_device_size_t size = iree_hal_buffer_allocation_size(base_buffer);
+  iree_slim_mutex_lock(&allocator->mutex);
+  iree_device_size_t* bytes_live = NULL;
+  iree_hal_statistics_allocator_counters_t* counters = NULL;
+  if (iree_all_bits_set(memory_type, IREE_HAL_MEMORY_TYPE_HOST_LOCAL)) {
+    bytes_live = &allocator->host_bytes_live;
+    counters = &allocator->scope.host;
+  } else {
+    bytes_live = &allocator->device_bytes_live;
+    counters = &allocator->scope.device;
+  }
+  *bytes_live -= size;
+  if (allocator->scope_id) {
+    ++counters->free_count;
+    counters->bytes_freed += size;
+    if (buffer->scope_id == allocator->scope_id) {
+      counters->bytes_transient += size;
+    }
+  }
+  iree_slim_mutex_unlock(&allocator->mutex);
+
+  // Releases the allocated buffer back to the allocator that owns it.
+  iree_hal_buffer_destroy(base_buffer);
+}
+
+static iree_status_t iree_hal_statistics_allocator_import_buffer(
+    iree_hal_allocator_t* IREE_RESTRICT base_allocator,
+    const iree_hal_buffer_params_t* IREE_RESTRICT params,
+    iree_hal_external_buffer_t* IREE_RESTRICT external_buffer,
+    iree_hal_buffer_release_callback_t release_callback,
+    iree_hal_buffer_t** IREE_RESTRICT out_buffer) {
+  // Imported buffers are owned externally and not counted.
+  iree_hal_statistics_allocator_t* allocator =
+      iree_hal_statistics_allocator_cast(base_allocator);
+  return iree_hal_allocator_import_buffer(allocator->device_allocator, *params,
+                                          external_buffer, release_callback,
+                                          out_buffer);
+}
+
+static iree_status_t iree_hal_statistics_allocator_export_buffer(
+    iree_hal_allocator_t* IREE_RESTRICT base_allocator,
+    iree_hal_buffer_t* IREE_RESTRICT buffer,
+    iree_hal_external_buffer_type_t requested_type,
+    iree_hal_external_buffer_flags_t requested_flags,
+    iree_hal_external_buffer_t* IREE_RESTRICT out_external_buffer) {
+  iree_hal_statistics_allocator_t* allocator =
+      iree_hal_statistics_allocator_cast(base_allocator);
+  // Export the underlying buffer when it is one of our subspans.
+  if (buffer->device_allocator == base_allocator) {
+    buffer = iree_hal_buffer_allocated_buffer(buffer);
+  }
+  return iree_hal_allocator_export_buffer(allocator->device_allocator, buffer,
+                                          requested_type, requested_flags,
+                                          out_external_buffer);
+}
+
+static const iree_hal_allocator_vtable_t iree_hal_statistics_allocator_vtable =
+    {
+        .destroy = iree_hal_statistics_allocator_destroy,
+        .host_allocator = iree_hal_statistics_allocator_host_allocator,
+        .trim = iree_hal_statistics_allocator_trim,
+        .query_statistics = iree_hal_statistics_allocator_query_statistics,
+        .query_memory_heaps = iree_hal_statistics_allocator_query_memory_heaps,
+        .query_buffer_compatibility =
+            iree_hal_statistics_allocator_query_buffer_compatibility,
+        .allocate_buffer = iree_hal_statistics_allocator_allocate_buffer,
+        .deallocate_buffer = iree_hal_statistics_allocator_deallocate_buffer,
+        .import_buffer = iree_hal_statistics_allocator_import_buffer,
+        .export_buffer = iree_hal_statistics_allocator_export_buffer,
+};
@@ -0,0 +1,100 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_HAL_UTILS_STATISTICS_ALLOCATOR_H_
+#define IREE_HAL_UTILS_STATISTICS_ALLOCATOR_H_
+
+#include "iree/base/api.h"
+#include "iree/hal/api.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+// Allocation counters for one class of memory (host-local or device-local)
+// captured over a scope.
+typedef struct iree_hal_statistics_allocator_counters_t {
+  // Number of buffers allocated within the scope.
+  uint64_t allocation_count;
+  // Number of buffers freed within the scope, including those allocated prior
+  // to the scope beginning.
+  uint64_t free_count;
+  // Total bytes allocated within the scope.
+  iree_device_size_t bytes_allocated;
+  // Total bytes freed within the scope, including those allocated prior to the
+  // scope beginning.
+  iree_device_size_t bytes_freed;
+  // Bytes live when the scope began.
+  iree_device_size_t bytes_live_begin;
+  // Maximum bytes live at any point within the scope. Includes
+  // |bytes_live_begin|.
+  iree_device_size_t bytes_peak;
+  // Bytes allocated within the scope that were also freed within the scope
+  // (scratch and intermediate buffers).
+  iree_device_size_t bytes_transient;
+  // Bytes allocated within the scope that were still live when it ended
+  // (results, variables, and caches).
+  iree_device_size_t bytes_persistent;
+} iree_hal_statistics_allocator_counters_t;
+
+// Allocation statistics captured between
+// iree_hal_statistics_allocator_begin_scope and
+// iree_hal_statistics_allocator_end_scope.
+typedef struct iree_hal_statistics_allocator_scope_t {
+  // Buffers allocated in IREE_HAL_MEMORY_TYPE_HOST_LOCAL memory.
+  iree_hal_statistics_allocator_counters_t host;
+  // Buffers allocated in all other memory.
+  iree_hal_statistics_allocator_counters_t device;
+} iree_hal_statistics_allocator_scope_t;
+
+// A HAL buffer allocator that counts every allocation and deallocation made
+// through it in order to attribute memory usage to a region of execution such
+// as a single function invocation. Unlike iree_hal_allocator_statistics_t the
+// counters are always available and can be captured in scoped snapshots.
+//
+// Buffers are returned as subspans of the underlying allocator buffers so that
+// their deallocation routes back through this allocator regardless of which
+// allocator in the chain owns the storage. This adds a small host allocation
+// per buffer and should only be used when diagnosing memory usage.
+//
+// Thread-safe: allocations and scopes may be used from multiple threads but
+// only one scope may be active at a time.
+typedef struct iree_hal_statistics_allocator_t iree_hal_statistics_allocator_t;
+
+// Creates a statistics allocator intercepting all |device_allocator|
+// allocations.
+iree_status_t iree_hal_statistics_allocator_create(
+    iree_hal_allocator_t* device_allocator, iree_allocator_t host_allocator,
+    iree_hal_allocator_t** out_allocator);
+
+// Returns true if |allocator| is an iree_hal_statistics_allocator_t.
+bool iree_hal_statistics_allocator_isa(iree_hal_allocator_t* allocator);
+
+// Begins a new scope on |allocator| resetting the scope counters.
+// Any previously active scope is discarded.
+void iree_hal_statistics_allocator_begin_scope(iree_hal_allocator_t* allocator);
+
+// Ends the active scope on |allocator| and stores its counters in |out_scope|.
+void iree_hal_statistics_allocator_end_scope(
+    iree_hal_allocator_t* allocator,
+    iree_hal_statistics_allocator_scope_t* out_scope);
+
+// Formats |scope| as a pretty-printed multi-line string and appends it to
+// |builder|.
+iree_status_t iree_hal_statistics_allocator_scope_format(
+    const iree_hal_statistics_allocator_scope_t* scope,
+    iree_string_builder_t* builder);
+
+// Formats |scope| as a JSON object and appends it to |builder|.
+iree_status_t iree_hal_statistics_allocator_scope_format_json(
+    const iree_hal_statistics_allocator_scope_t* scope,
+    iree_string_builder_t* builder);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif  // IREE_HAL_UTILS_STATISTICS_ALLOCATOR_H_
@@ -0,0 +1,128 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/hal/utils/statistics_allocator.h"
+
+#include <string>
+
+#include "iree/base/api.h"
+#include "iree/hal/api.h"
+#include "iree/testing/gtest.h"
+#include "iree/testing/status_matchers.h"
+
+namespace iree {
+namespace hal {
+namespace {
+
+class StatisticsAllocatorTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    iree_allocator_t host_allocator = iree_allocator_system();
+    iree_hal_allocator_t* heap_allocator = NULL;
+    IREE_ASSERT_OK(iree_hal_allocator_create_heap(
+        IREE_SV("heap"), host_allocator, host_allocator, &heap_allocator));
+    IREE_ASSERT_OK(iree_hal_statistics_allocator_create(
+        heap_allocator, host_allocator, &allocator_));
+    iree_hal_allocator_release(heap_allocator);
+  }
+
+  void TearDown() override { iree_hal_allocator_release(allocator_); }
+
+  iree_hal_buffer_t* Allocate(iree_device_size_t size) {
+    iree_hal_buffer_params_t params = {0};
+    params.type = IREE_HAL_MEMORY_TYPE_HOST_LOCAL;
+    params.usage = IREE_HAL_BUFFER_USAGE_DEFAULT;
+    iree_hal_buffer_t* buffer = NULL;
+    IREE_CHECK_OK(
+        iree_hal_allocator_allocate_buffer(allocator_, params, size, &buffer));
+    return buffer;
+  }
+
+  iree_hal_allocator_t* allocator_ = NULL;
+};
+
+TEST_F(StatisticsAllocatorTest, Isa) {
+  EXPECT_TRUE(iree_hal_statistics_allocator_isa(allocator_));
+}
+
+TEST_F(StatisticsAllocatorTest, BuffersAreUsable) {
+  iree_hal_buffer_t* buffer = Allocate(64);
+  EXPECT_EQ(iree_hal_buffer_byte_length(buffer), 64);
+  uint32_t pattern = 0xCAFEF00Du;
+  IREE_ASSERT_OK(iree_hal_buffer_map_fill(buffer, 0, IREE_WHOLE_BUFFER,
+                                          &pattern, sizeof(pattern)));
+  uint32_t value = 0;
+  IREE_ASSERT_OK(iree_hal_buffer_map_read(buffer, 60, &value, sizeof(value)));
+  EXPECT_EQ(value, pattern);
+  iree_hal_buffer_release(buffer);
+}
+
+TEST_F(StatisticsAllocatorTest, EmptyScope) {
+  iree_hal_statistics_allocator_begin_scope(allocator_);
+  iree_hal_statistics_allocator_scope_t scope;
+  iree_hal_statistics_allocator_end_scope(allocator_, &scope);
+  EXPECT_EQ(scope.host.allocation_count, 0);
+  EXPECT_EQ(scope.host.free_count, 0);
+  EXPECT_EQ(scope.host.bytes_peak, 0);
+  EXPECT_EQ(scope.device.allocation_count, 0);
+}
+
+TEST_F(StatisticsAllocatorTest, TransientAndPersistent) {
+  // Live before the scope begins and freed within it.
+  iree_hal_buffer_t* prior_buffer = Allocate(1000);
+
+  iree_hal_statistics_allocator_begin_scope(allocator_);
+  iree_hal_buffer_t* transient_buffer = Allocate(200);
+  iree_hal_buffer_t* persistent_buffer = Allocate(30);
+  iree_hal_buffer_release(transient_buffer);
+  iree_hal_buffer_release(prior_buffer);
+  iree_hal_statistics_allocator_scope_t scope;
+  iree_hal_statistics_allocator_end_scope(allocator_, &scope);
+
+  EXPECT_EQ(scope.host.allocation_count, 2);
+  EXPECT_EQ(scope.host.free_count, 2);
+  EXPECT_EQ(scope.host.bytes_allocated, 230);
+  EXPECT_EQ(scope.host.bytes_freed, 1200);
+  EXPECT_EQ(scope.host.bytes_live_begin, 1000);
+  EXPECT_EQ(scope.host.bytes_peak, 1230);
+  EXPECT_EQ(scope.host.bytes_transient, 200);
+  EXPECT_EQ(scope.host.bytes_persistent, 30);
+
+  // Frees outside of a scope are not counted against the next one.
+  iree_hal_buffer_release(persistent_buffer);
+  iree_hal_statistics_allocator_begin_scope(allocator_);
+  iree_hal_statistics_allocator_end_scope(allocator_, &scope);
+  EXPECT_EQ(scope.host.bytes_live_begin, 0);
+  EXPECT_EQ(scope.host.free_count, 0);
+}
+
+TEST_F(StatisticsAllocatorTest, FormatJson) {
+  iree_hal_statistics_allocator_begin_scope(allocator_);
+  iree_hal_buffer_release(Allocate(16));
+  iree_hal_statistics_allocator_scope_t scope;
+  iree_hal_statistics_allocator_end_scope(allocator_, &scope);
+
+  iree_string_builder_t builder;
+  iree_string_builder_initialize(iree_allocator_system(), &builder);
+  IREE_ASSERT_OK(
+      iree_hal_statistics_allocator_scope_format_json(&scope, &builder));
+  std::string json(iree_string_builder_buffer(&builder),
+                   iree_string_builder_size(&builder));
+  iree_string_builder_deinitialize(&builder);
+  EXPECT_EQ(json,
+            "{\"host\": {\"allocation_count\": 1, \"free_count\": 1, "
+            "\"bytes_allocated\": 16, \"bytes_freed\": 16, "
+            "\"bytes_live_begin\": 0, \"bytes_peak\": 16, "
+            "\"bytes_transient\": 16, \"bytes_persistent\": 0}, "
+            "\"device\": {\"allocation_count\": 0, \"free_count\": 0, "
+            "\"bytes_allocated\": 0, \"bytes_freed\": 0, "
+            "\"bytes_live_begin\": 0, \"bytes_peak\": 0, "
+            "\"bytes_transient\": 0, \"bytes_persistent\": 0}}");
+}
+
+}  // namespace
+}  // namespace hal
+}  // namespace iree
@@ -1165,6 +1165,8 @@ IREE_VM_ABI_EXPORT(iree_hal_module_executable_create,  //
     executable_params.pipeline_layouts = pipeline_layouts;
     executable_params.constant_count = constant_count;
     executable_params.constants = constants;
+    // Prepared synchronously: the cache loop is inline (see loop_status) so
+    // asynchronous preparation would only add a copy of the executable data.
     status = iree_hal_executable_cache_prepare_executable(
         state->executable_cache, &executable_params, &executable);
   }
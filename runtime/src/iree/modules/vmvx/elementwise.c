@@ -274,3 +274,314 @@ DISPATCH_UKERNEL_UNARY_2D(floorf, IREE_UK_X32U_FLOORF, iree_uk_uint32_t, x32u);
 DISPATCH_UKERNEL_UNARY_2D(logf, IREE_UK_X32U_LOGF, iree_uk_uint32_t, x32u);
 DISPATCH_UKERNEL_UNARY_2D(negf, IREE_UK_X32U_NEGF, iree_uk_uint32_t, x32u);
 DISPATCH_UKERNEL_UNARY_2D(rsqrtf, IREE_UK_X32U_RSQRTF, iree_uk_uint32_t, x32u);
+
+//===----------------------------------------------------------------------===//
+// 16-bit float kernels.
+//===----------------------------------------------------------------------===//
+
+// Opcodes for the f16/bf16 kernels. These only have float semantics, the
+// 16-bit format is carried separately by iree_uk_x16_format_t. As above, each
+// opcode must be numerically stable.
+typedef enum {
+  IREE_UK_X16B_ADDF = 0,
+  IREE_UK_X16B_DIVF = 1,
+  IREE_UK_X16B_MULF = 2,
+  IREE_UK_X16B_SUBF = 3,
+} iree_uk_x16b_opcode_t;
+
+typedef enum {
+  IREE_UK_X16U_ABSF = 0,
+  IREE_UK_X16U_CEILF = 1,
+  IREE_UK_X16U_EXPF = 2,
+  IREE_UK_X16U_FLOORF = 3,
+  IREE_UK_X16U_LOGF = 4,
+  IREE_UK_X16U_NEGF = 5,
+  IREE_UK_X16U_RSQRTF = 6,
+} iree_uk_x16u_opcode_t;
+
+typedef enum {
+  IREE_UK_X16_FORMAT_F16 = 0,
+  IREE_UK_X16_FORMAT_BF16 = 1,
+} iree_uk_x16_format_t;
+
+// Rows are processed in chunks of this many elements: a chunk is widened to
+// f32, the opcode is applied to the whole chunk, and the result is narrowed
+// back. Unlike the x32 kernels above, this keeps the opcode switch out of the
+// element loops, which are then simple enough for the compiler to vectorize.
+#define IREE_UK_X16_CHUNK_SIZE 64
+
+// Widens |count| 16-bit floats from |in| to f32 in |out|.
+static void iree_uk_x16_widen(iree_uk_x16_format_t format,
+                              const iree_uk_uint16_t* in,
+                              iree_uk_index_t in_stride, float* out,
+                              iree_uk_index_t out_stride,
+                              iree_uk_index_t count) {
+  if (format == IREE_UK_X16_FORMAT_BF16) {
+    for (iree_uk_index_t j = 0; j < count; ++j) {
+      out[j * out_stride] = iree_uk_bf16_to_f32(in[j * in_stride]);
+    }
+  } else {
+    for (iree_uk_index_t j = 0; j < count; ++j) {
+      out[j * out_stride] = iree_uk_f16_to_f32(in[j * in_stride]);
+    }
+  }
+}
+
+// Narrows |count| f32 values from |in| to 16-bit floats in |out|, rounding to
+// nearest even.
+static void iree_uk_x16_narrow(iree_uk_x16_format_t format, const float* in,
+                               iree_uk_index_t in_stride,
+                               iree_uk_uint16_t* out,
+                               iree_uk_index_t out_stride,
+                               iree_uk_index_t count) {
+  if (format == IREE_UK_X16_FORMAT_BF16) {
+    for (iree_uk_index_t j = 0; j < count; ++j) {
+      out[j * out_stride] = iree_uk_f32_to_bf16(in[j * in_stride]);
+    }
+  } else {
+    for (iree_uk_index_t j = 0; j < count; ++j) {
+      out[j * out_stride] = iree_uk_f32_to_f16(in[j * in_stride]);
+    }
+  }
+}
+
+// Applies an x16b opcode to |count| widened elements. Returns non-zero on
+// error.
+static int iree_uk_x16b_chunk(iree_uk_x16b_opcode_t opcode, const float* lhs,
+                              const float* rhs, float* IREE_UK_RESTRICT out,
+                              iree_uk_index_t count) {
+  switch (opcode) {
+    case IREE_UK_X16B_ADDF:
+      for (iree_uk_index_t j = 0; j < count; ++j) out[j] = lhs[j] + rhs[j];
+      return 0;
+    case IREE_UK_X16B_DIVF:
+      for (iree_uk_index_t j = 0; j < count; ++j) out[j] = lhs[j] / rhs[j];
+      return 0;
+    case IREE_UK_X16B_MULF:
+      for (iree_uk_index_t j = 0; j < count; ++j) out[j] = lhs[j] * rhs[j];
+      return 0;
+    case IREE_UK_X16B_SUBF:
+      for (iree_uk_index_t j = 0; j < count; ++j) out[j] = lhs[j] - rhs[j];
+      return 0;
+    default:
+      return 1;
+  }
+}
+
+// Applies an x16u opcode to |count| widened elements. Returns non-zero on
+// error.
+static int iree_uk_x16u_chunk(iree_uk_x16u_opcode_t opcode, const float* in,
+                              float* IREE_UK_RESTRICT out,
+                              iree_uk_index_t count) {
+  switch (opcode) {
+    case IREE_UK_X16U_ABSF:
+      for (iree_uk_index_t j = 0; j < count; ++j) out[j] = fabsf(in[j]);
+      return 0;
+    case IREE_UK_X16U_CEILF:
+      for (iree_uk_index_t j = 0; j < count; ++j) out[j] = ceilf(in[j]);
+      return 0;
+    case IREE_UK_X16U_EXPF:
+      for (iree_uk_index_t j = 0; j < count; ++j) out[j] = expf(in[j]);
+      return 0;
+    case IREE_UK_X16U_FLOORF:
+      for (iree_uk_index_t j = 0; j < count; ++j) out[j] = floorf(in[j]);
+      return 0;
+    case IREE_UK_X16U_LOGF:
+      for (iree_uk_index_t j = 0; j < count; ++j) out[j] = logf(in[j]);
+      return 0;
+    case IREE_UK_X16U_NEGF:
+      for (iree_uk_index_t j = 0; j < count; ++j) out[j] = -in[j];
+      return 0;
+    case IREE_UK_X16U_RSQRTF:
+      for (iree_uk_index_t j = 0; j < count; ++j) {
+        out[j] = 1.0f / sqrtf(in[j]);
+      }
+      return 0;
+    default:
+      return 1;
+  }
+}
+
+// Generic 16bit float binary kernels.
+IREE_UK_ATTRIBUTE_NOINLINE static int iree_uk_generic_x16b_2d(
+    iree_uk_x16b_opcode_t opcode, iree_uk_x16_format_t format,
+    // LHS.
+    const iree_uk_uint16_t* lhs, iree_uk_index_t lhs_offset,
+    iree_uk_index_t lhs_stride0, iree_uk_index_t lhs_stride1,
+    // RHS
+    const iree_uk_uint16_t* rhs, iree_uk_index_t rhs_offset,
+    iree_uk_index_t rhs_stride0, iree_uk_index_t rhs_stride1,
+    // OUT.
+    iree_uk_uint16_t* IREE_UK_RESTRICT out, iree_uk_index_t out_offset,
+    iree_uk_index_t out_stride0, iree_uk_index_t out_stride1,
+    // Sizes.
+    iree_uk_index_t size0, iree_uk_index_t size1) {
+  float lhs_f32[IREE_UK_X16_CHUNK_SIZE];
+  float rhs_f32[IREE_UK_X16_CHUNK_SIZE];
+  float out_f32[IREE_UK_X16_CHUNK_SIZE];
+  for (iree_uk_index_t i = 0; i < size0; ++i) {
+    for (iree_uk_index_t j = 0; j < size1; j += IREE_UK_X16_CHUNK_SIZE) {
+      iree_uk_index_t count =
+          iree_uk_index_min(IREE_UK_X16_CHUNK_SIZE, size1 - j);
+      iree_uk_x16_widen(format, &lhs[i * lhs_stride0 + j * lhs_stride1],
+                        lhs_stride1, lhs_f32, 1, count);
+      iree_uk_x16_widen(format, &rhs[i * rhs_stride0 + j * rhs_stride1],
+                        rhs_stride1, rhs_f32, 1, count);
+      if (iree_uk_x16b_chunk(opcode, lhs_f32, rhs_f32, out_f32, count)) {
+        return 1;
+      }
+      iree_uk_x16_narrow(format, out_f32, 1,
+                         &out[i * out_stride0 + j * out_stride1], out_stride1,
+                         count);
+    }
+  }
+  return 0;
+}
+
+// Generic 16bit float unary kernels.
+IREE_UK_ATTRIBUTE_NOINLINE static int iree_uk_generic_x16u_2d(
+    iree_uk_x16u_opcode_t opcode, iree_uk_x16_format_t format,
+    // IN.
+    const iree_uk_uint16_t* in, iree_uk_index_t in_offset,
+    iree_uk_index_t in_stride0, iree_uk_index_t in_stride1,
+    // OUT.
+    iree_uk_uint16_t* IREE_UK_RESTRICT out, iree_uk_index_t out_offset,
+    iree_uk_index_t out_stride0, iree_uk_index_t out_stride1,
+    // Sizes.
+    iree_uk_index_t size0, iree_uk_index_t size1) {
+  float in_f32[IREE_UK_X16_CHUNK_SIZE];
+  float out_f32[IREE_UK_X16_CHUNK_SIZE];
+  for (iree_uk_index_t i = 0; i < size0; ++i) {
+    for (iree_uk_index_t j = 0; j < size1; j += IREE_UK_X16_CHUNK_SIZE) {
+      iree_uk_index_t count =
+          iree_uk_index_min(IREE_UK_X16_CHUNK_SIZE, size1 - j);
+      iree_uk_x16_widen(format, &in[i * in_stride0 + j * in_stride1],
+                        in_stride1, in_f32, 1, count);
+      if (iree_uk_x16u_chunk(opcode, in_f32, out_f32, count)) return 1;
+      iree_uk_x16_narrow(format, out_f32, 1,
+                         &out[i * out_stride0 + j * out_stride1], out_stride1,
+                         count);
+    }
+  }
+  return 0;
+}
+
+// Generic 16bit float to f32 conversion kernels.
+IREE_UK_ATTRIBUTE_NOINLINE static int iree_uk_generic_x16x32_2d(
+    iree_uk_x16_format_t format,
+    // IN.
+    const iree_uk_uint16_t* in, iree_uk_index_t in_offset,
+    iree_uk_index_t in_stride0, iree_uk_index_t in_stride1,
+    // OUT.
+    iree_uk_uint32_t* IREE_UK_RESTRICT out, iree_uk_index_t out_offset,
+    iree_uk_index_t out_stride0, iree_uk_index_t out_stride1,
+    // Sizes.
+    iree_uk_index_t size0, iree_uk_index_t size1) {
+  for (iree_uk_index_t i = 0; i < size0; ++i) {
+    iree_uk_x16_widen(format, &in[i * in_stride0], in_stride1,
+                      (float*)&out[i * out_stride0], out_stride1, size1);
+  }
+  return 0;
+}
+
+// Generic f32 to 16bit float conversion kernels.
+IREE_UK_ATTRIBUTE_NOINLINE static int iree_uk_generic_x32x16_2d(
+    iree_uk_x16_format_t format,
+    // IN.
+    const iree_uk_uint32_t* in, iree_uk_index_t in_offset,
+    iree_uk_index_t in_stride0, iree_uk_index_t in_stride1,
+    // OUT.
+    iree_uk_uint16_t* IREE_UK_RESTRICT out, iree_uk_index_t out_offset,
+    iree_uk_index_t out_stride0, iree_uk_index_t out_stride1,
+    // Sizes.
+    iree_uk_index_t size0, iree_uk_index_t size1) {
+  for (iree_uk_index_t i = 0; i < size0; ++i) {
+    iree_uk_x16_narrow(format, (const float*)&in[i * in_stride0], in_stride1,
+                       &out[i * out_stride0], out_stride1, size1);
+  }
+  return 0;
+}
+
+// Defines a 16-bit float binary kernel for the given 16-bit format by
+// invoking iree_uk_generic_x16b_2d.
+#define DISPATCH_UKERNEL_X16B_2D(opcode, opcode_t, format)                    \
+  IREE_UK_EXPORT int iree_uk_x16b_##opcode##_2d(                              \
+      const iree_uk_uint16_t* lhs, iree_uk_index_t lhs_offset,                \
+      iree_uk_index_t lhs_stride0, iree_uk_index_t lhs_stride1,               \
+      const iree_uk_uint16_t* rhs, iree_uk_index_t rhs_offset,                \
+      iree_uk_index_t rhs_stride0, iree_uk_index_t rhs_stride1,               \
+      iree_uk_uint16_t* IREE_UK_RESTRICT out, iree_uk_index_t out_offset,     \
+      iree_uk_index_t out_stride0, iree_uk_index_t out_stride1,               \
+      iree_uk_index_t size0, iree_uk_index_t size1) {                         \
+    return iree_uk_generic_x16b_2d(                                           \
+        opcode_t, format, lhs, lhs_offset, lhs_stride0, lhs_stride1, rhs,     \
+        rhs_offset, rhs_stride0, rhs_stride1, out, out_offset, out_stride0,   \
+        out_stride1, size0, size1);                                           \
+  }
+
+// Defines a 16-bit float unary kernel for the given 16-bit format by invoking
+// iree_uk_generic_x16u_2d.
+#define DISPATCH_UKERNEL_X16U_2D(opcode, opcode_t, format)                    \
+  IREE_UK_EXPORT int iree_uk_x16u_##opcode##_2d(                              \
+      const iree_uk_uint16_t* in, iree_uk_index_t in_offset,                  \
+      iree_uk_index_t in_stride0, iree_uk_index_t in_stride1,                 \
+      iree_uk_uint16_t* IREE_UK_RESTRICT out, iree_uk_index_t out_offset,     \
+      iree_uk_index_t out_stride0, iree_uk_index_t out_stride1,               \
+      iree_uk_index_t size0, iree_uk_index_t size1) {                         \
+    return iree_uk_generic_x16u_2d(opcode_t, format, in, in_offset,           \
+                                   in_stride0, in_stride1, out, out_offset,   \
+                                   out_stride0, out_stride1, size0, size1);   \
+  }
+
+// Defines a conversion kernel for the given 16-bit format by invoking
+// iree_uk_generic_{category}_2d.
+#define DISPATCH_UKERNEL_CONVERT_2D(opcode, format, in_dtype, out_dtype,      \
+                                    category)                                 \
+  IREE_UK_EXPORT int iree_uk_##category##_##opcode##_2d(                      \
+      const in_dtype* in, iree_uk_index_t in_offset,                          \
+      iree_uk_index_t in_stride0, iree_uk_index_t in_stride1,                 \
+      out_dtype* IREE_UK_RESTRICT out, iree_uk_index_t out_offset,            \
+      iree_uk_index_t out_stride0, iree_uk_index_t out_stride1,               \
+      iree_uk_index_t size0, iree_uk_index_t size1) {                         \
+    return iree_uk_generic_##category##_2d(                                   \
+        format, in, in_offset, in_stride0, in_stride1, out, out_offset,       \
+        out_stride0, out_stride1, size0, size1);                              \
+  }
+
+DISPATCH_UKERNEL_X16B_2D(addf_bf16, IREE_UK_X16B_ADDF, IREE_UK_X16_FORMAT_BF16);
+DISPATCH_UKERNEL_X16B_2D(addf_f16, IREE_UK_X16B_ADDF, IREE_UK_X16_FORMAT_F16);
+DISPATCH_UKERNEL_X16B_2D(divf_bf16, IREE_UK_X16B_DIVF, IREE_UK_X16_FORMAT_BF16);
+DISPATCH_UKERNEL_X16B_2D(divf_f16, IREE_UK_X16B_DIVF, IREE_UK_X16_FORMAT_F16);
+DISPATCH_UKERNEL_X16B_2D(mulf_bf16, IREE_UK_X16B_MULF, IREE_UK_X16_FORMAT_BF16);
+DISPATCH_UKERNEL_X16B_2D(mulf_f16, IREE_UK_X16B_MULF, IREE_UK_X16_FORMAT_F16);
+DISPATCH_UKERNEL_X16B_2D(subf_bf16, IREE_UK_X16B_SUBF, IREE_UK_X16_FORMAT_BF16);
+DISPATCH_UKERNEL_X16B_2D(subf_f16, IREE_UK_X16B_SUBF, IREE_UK_X16_FORMAT_F16);
+
+DISPATCH_UKERNEL_X16U_2D(absf_bf16, IREE_UK_X16U_ABSF, IREE_UK_X16_FORMAT_BF16);
+DISPATCH_UKERNEL_X16U_2D(absf_f16, IREE_UK_X16U_ABSF, IREE_UK_X16_FORMAT_F16);
+DISPATCH_UKERNEL_X16U_2D(ceilf_bf16, IREE_UK_X16U_CEILF,
+                         IREE_UK_X16_FORMAT_BF16);
+DISPATCH_UKERNEL_X16U_2D(ceilf_f16, IREE_UK_X16U_CEILF, IREE_UK_X16_FORMAT_F16);
+DISPATCH_UKERNEL_X16U_2D(expf_bf16, IREE_UK_X16U_EXPF, IREE_UK_X16_FORMAT_BF16);
+DISPATCH_UKERNEL_X16U_2D(expf_f16, IREE_UK_X16U_EXPF, IREE_UK_X16_FORMAT_F16);
+DISPATCH_UKERNEL_X16U_2D(floorf_bf16, IREE_UK_X16U_FLOORF,
+                         IREE_UK_X16_FORMAT_BF16);
+DISPATCH_UKERNEL_X16U_2D(floorf_f16, IREE_UK_X16U_FLOORF,
+                         IREE_UK_X16_FORMAT_F16);
+DISPATCH_UKERNEL_X16U_2D(logf_bf16, IREE_UK_X16U_LOGF, IREE_UK_X16_FORMAT_BF16);
+DISPATCH_UKERNEL_X16U_2D(logf_f16, IREE_UK_X16U_LOGF, IREE_UK_X16_FORMAT_F16);
+DISPATCH_UKERNEL_X16U_2D(negf_bf16, IREE_UK_X16U_NEGF, IREE_UK_X16_FORMAT_BF16);
+DISPATCH_UKERNEL_X16U_2D(negf_f16, IREE_UK_X16U_NEGF, IREE_UK_X16_FORMAT_F16);
+DISPATCH_UKERNEL_X16U_2D(rsqrtf_bf16, IREE_UK_X16U_RSQRTF,
+                         IREE_UK_X16_FORMAT_BF16);
+DISPATCH_UKERNEL_X16U_2D(rsqrtf_f16, IREE_UK_X16U_RSQRTF,
+                         IREE_UK_X16_FORMAT_F16);
+
+DISPATCH_UKERNEL_CONVERT_2D(extf_bf16, IREE_UK_X16_FORMAT_BF16,
+                            iree_uk_uint16_t, iree_uk_uint32_t, x16x32);
+DISPATCH_UKERNEL_CONVERT_2D(extf_f16, IREE_UK_X16_FORMAT_F16, iree_uk_uint16_t,
+                            iree_uk_uint32_t, x16x32);
+DISPATCH_UKERNEL_CONVERT_2D(truncf_bf16, IREE_UK_X16_FORMAT_BF16,
+                            iree_uk_uint32_t, iree_uk_uint16_t, x32x16);
+DISPATCH_UKERNEL_CONVERT_2D(truncf_f16, IREE_UK_X16_FORMAT_F16,
+                            iree_uk_uint32_t, iree_uk_uint16_t, x32x16);
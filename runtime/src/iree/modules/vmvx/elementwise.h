@@ -93,6 +93,98 @@ DECLARE_UKERNEL_UNARY_2D(logf, iree_uk_uint32_t, x32u);
 DECLARE_UKERNEL_UNARY_2D(negf, iree_uk_uint32_t, x32u);
 DECLARE_UKERNEL_UNARY_2D(rsqrtf, iree_uk_uint32_t, x32u);
 
+//===----------------------------------------------------------------------===//
+// Public API - 16-bit float kernels.
+//===----------------------------------------------------------------------===//
+
+// The f16 and bf16 kernels compute in f32 and round the result back to the
+// 16-bit format. Each 16-bit format has its own entry point so that the
+// opcode and format are both static at the call site; the opcode suffix is
+// the 16-bit format (e.g. addf_f16, addf_bf16).
+
+// Binary ukernel func 2d, x16.
+typedef int (*iree_uk_x16b_2d_func_t)(
+    const iree_uk_uint16_t* lhs, iree_uk_index_t lhs_offset,
+    iree_uk_index_t lhs_stride0, iree_uk_index_t lhs_stride1,
+    const iree_uk_uint16_t* rhs, iree_uk_index_t rhs_offset,
+    iree_uk_index_t rhs_stride0, iree_uk_index_t rhs_stride1,
+    iree_uk_uint16_t* out, iree_uk_index_t out_offset,
+    iree_uk_index_t out_stride0, iree_uk_index_t out_stride1,
+    iree_uk_index_t size0, iree_uk_index_t size1);
+
+DECLARE_UKERNEL_BINARY_2D(addf_bf16, iree_uk_uint16_t, x16b);
+DECLARE_UKERNEL_BINARY_2D(addf_f16, iree_uk_uint16_t, x16b);
+DECLARE_UKERNEL_BINARY_2D(divf_bf16, iree_uk_uint16_t, x16b);
+DECLARE_UKERNEL_BINARY_2D(divf_f16, iree_uk_uint16_t, x16b);
+DECLARE_UKERNEL_BINARY_2D(mulf_bf16, iree_uk_uint16_t, x16b);
+DECLARE_UKERNEL_BINARY_2D(mulf_f16, iree_uk_uint16_t, x16b);
+DECLARE_UKERNEL_BINARY_2D(subf_bf16, iree_uk_uint16_t, x16b);
+DECLARE_UKERNEL_BINARY_2D(subf_f16, iree_uk_uint16_t, x16b);
+
+// Unary ukernel func 2d, x16.
+typedef int (*iree_uk_x16u_2d_func_t)(
+    const iree_uk_uint16_t* in, iree_uk_index_t in_offset,
+    iree_uk_index_t in_stride0, iree_uk_index_t in_stride1,
+    iree_uk_uint16_t* out, iree_uk_index_t out_offset,
+    iree_uk_index_t out_stride0, iree_uk_index_t out_stride1,
+    iree_uk_index_t size0, iree_uk_index_t size1);
+
+DECLARE_UKERNEL_UNARY_2D(absf_bf16, iree_uk_uint16_t, x16u);
+DECLARE_UKERNEL_UNARY_2D(absf_f16, iree_uk_uint16_t, x16u);
+DECLARE_UKERNEL_UNARY_2D(ceilf_bf16, iree_uk_uint16_t, x16u);
+DECLARE_UKERNEL_UNARY_2D(ceilf_f16, iree_uk_uint16_t, x16u);
+DECLARE_UKERNEL_UNARY_2D(expf_bf16, iree_uk_uint16_t, x16u);
+DECLARE_UKERNEL_UNARY_2D(expf_f16, iree_uk_uint16_t, x16u);
+DECLARE_UKERNEL_UNARY_2D(floorf_bf16, iree_uk_uint16_t, x16u);
+DECLARE_UKERNEL_UNARY_2D(floorf_f16, iree_uk_uint16_t, x16u);
+DECLARE_UKERNEL_UNARY_2D(logf_bf16, iree_uk_uint16_t, x16u);
+DECLARE_UKERNEL_UNARY_2D(logf_f16, iree_uk_uint16_t, x16u);
+DECLARE_UKERNEL_UNARY_2D(negf_bf16, iree_uk_uint16_t, x16u);
+DECLARE_UKERNEL_UNARY_2D(negf_f16, iree_uk_uint16_t, x16u);
+DECLARE_UKERNEL_UNARY_2D(rsqrtf_bf16, iree_uk_uint16_t, x16u);
+DECLARE_UKERNEL_UNARY_2D(rsqrtf_f16, iree_uk_uint16_t, x16u);
+
+//===----------------------------------------------------------------------===//
+// Public API - Conversion kernels.
+//===----------------------------------------------------------------------===//
+
+// Conversion ukernel func 2d, x16 -> x32 (extf from f16/bf16 to f32).
+typedef int (*iree_uk_x16x32_2d_func_t)(
+    const iree_uk_uint16_t* in, iree_uk_index_t in_offset,
+    iree_uk_index_t in_stride0, iree_uk_index_t in_stride1,
+    iree_uk_uint32_t* out, iree_uk_index_t out_offset,
+    iree_uk_index_t out_stride0, iree_uk_index_t out_stride1,
+    iree_uk_index_t size0, iree_uk_index_t size1);
+
+// Conversion ukernel func 2d, x32 -> x16 (truncf from f32 to f16/bf16,
+// rounding to nearest even).
+typedef int (*iree_uk_x32x16_2d_func_t)(
+    const iree_uk_uint32_t* in, iree_uk_index_t in_offset,
+    iree_uk_index_t in_stride0, iree_uk_index_t in_stride1,
+    iree_uk_uint16_t* out, iree_uk_index_t out_offset,
+    iree_uk_index_t out_stride0, iree_uk_index_t out_stride1,
+    iree_uk_index_t size0, iree_uk_index_t size1);
+
+// Declares a conversion 2d microkernel with the following signature:
+//   int iree_uk_{category}_{opcode}_2d(...)
+// of function type iree_uk_{category}_2d_func_t.
+#define DECLARE_UKERNEL_CONVERT_2D(opcode, in_dtype, out_dtype, category) \
+  IREE_UK_EXPORT int iree_uk_##category##_##opcode##_2d(                  \
+      const in_dtype* in, iree_uk_index_t in_offset,                      \
+      iree_uk_index_t in_stride0, iree_uk_index_t in_stride1,             \
+      out_dtype* IREE_UK_RESTRICT out, iree_uk_index_t out_offset,        \
+      iree_uk_index_t out_stride0, iree_uk_index_t out_stride1,           \
+      iree_uk_index_t size0, iree_uk_index_t size1)
+
+DECLARE_UKERNEL_CONVERT_2D(extf_bf16, iree_uk_uint16_t, iree_uk_uint32_t,
+                           x16x32);
+DECLARE_UKERNEL_CONVERT_2D(extf_f16, iree_uk_uint16_t, iree_uk_uint32_t,
+                           x16x32);
+DECLARE_UKERNEL_CONVERT_2D(truncf_bf16, iree_uk_uint32_t, iree_uk_uint16_t,
+                           x32x16);
+DECLARE_UKERNEL_CONVERT_2D(truncf_f16, iree_uk_uint32_t, iree_uk_uint16_t,
+                           x32x16);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif  // __cplusplus
@@ -13,6 +13,7 @@
 #include <string.h>
 
 #include "iree/base/api.h"
+#include "iree/base/internal/atomics.h"
 #include "iree/base/internal/cpu.h"
 #include "iree/vm/api.h"
 
@@ -45,8 +46,24 @@ void iree_uk_assert_fail(const char* file, int line, const char* function,
 // Module type definitions
 //===----------------------------------------------------------------------===//
 
+// Capacity of the mmt4d tile function cache. Models only use a handful of
+// mmt4d types and tile sizes; past that, tile functions are resolved per call.
+#define IREE_VMVX_MMT4D_TILE_FUNC_CACHE_CAPACITY 16
+
+// An entry of the mmt4d tile function cache. |key| is 0 while the entry is
+// empty and is published with release semantics after |tile_func| is stored.
+typedef struct iree_vmvx_mmt4d_tile_func_cache_entry_t {
+  iree_atomic_int64_t key;
+  iree_atomic_intptr_t tile_func;
+} iree_vmvx_mmt4d_tile_func_cache_entry_t;
+
 typedef struct iree_vmvx_module_t {
   iree_allocator_t host_allocator;
+  // Tile functions resolved by iree_uk_mmt4d_resolve_tile_func, keyed by the
+  // mmt4d flags and tile sizes. The cpu_data is process-wide so it is not part
+  // of the key. Shared by all contexts and accessed lock-free.
+  iree_vmvx_mmt4d_tile_func_cache_entry_t
+      mmt4d_tile_funcs[IREE_VMVX_MMT4D_TILE_FUNC_CACHE_CAPACITY];
   // TODO(benvanik): types when we are not registering them globally.
 } iree_vmvx_module_t;
 
@@ -352,6 +369,262 @@ static iree_status_t iree_vm_shim_ukernel_x32u_2d_v(
                                 "illegal x32u ukernel return code (%d)", ret);
 }
 
+// 16-bit float kernels (f16 and bf16 share the same shims). The conversion
+// shims differ from the unary ones only in the element size of in and out.
+
+IREE_VMVX_ABI_FIXED_STRUCT(ukernel_x16b_2d, rIIIrIIIrIIIII, {
+  iree_vm_ref_t lhs_ref;
+  int64_t lhs_offset;
+  int64_t lhs_stride0;
+  int64_t lhs_stride1;
+  iree_vm_ref_t rhs_ref;
+  int64_t rhs_offset;
+  int64_t rhs_stride0;
+  int64_t rhs_stride1;
+  iree_vm_ref_t out_ref;
+  int64_t out_offset;
+  int64_t out_stride0;
+  int64_t out_stride1;
+  int64_t size0;
+  int64_t size1;
+});
+
+static iree_status_t iree_vm_shim_ukernel_x16b_2d_v(
+    iree_vm_stack_t* IREE_RESTRICT stack, iree_vm_native_function_flags_t flags,
+    iree_byte_span_t args_storage, iree_byte_span_t rets_storage,
+    iree_vm_native_function_target2_t target_fn, void* IREE_RESTRICT module,
+    void* IREE_RESTRICT module_state) {
+  // TODO: Figure out how to identify this with the actual target fn.
+  IREE_TRACE_ZONE_BEGIN(z0);
+  const iree_vm_abi_ukernel_x16b_2d_t* args =
+      iree_vm_abi_ukernel_x16b_2d_checked_deref(args_storage);
+  if (IREE_UNLIKELY(!((flags & IREE_VM_NATIVE_FUNCTION_CALL_RESUME) || args))) {
+    IREE_TRACE_ZONE_END(z0);
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "argument/result signature mismatch");
+  }
+
+  MAP_BUFFER_2D_RO(lhs, iree_uk_uint16_t,
+                   /*buffer_ref=*/args->lhs_ref,
+                   /*offset=*/args->lhs_offset,
+                   /*stride0=*/args->lhs_stride0,
+                   /*stride1=*/args->lhs_stride1,
+                   /*size0=*/args->size0,
+                   /*size1=*/args->size1);
+  MAP_BUFFER_2D_RO(rhs, iree_uk_uint16_t,
+                   /*buffer_ref=*/args->rhs_ref,
+                   /*offset=*/args->rhs_offset,
+                   /*stride0=*/args->rhs_stride0,
+                   /*stride1=*/args->rhs_stride1,
+                   /*size0=*/args->size0,
+                   /*size1=*/args->size1);
+  MAP_BUFFER_2D_RW(out, iree_uk_uint16_t,
+                   /*buffer_ref=*/args->out_ref,
+                   /*offset=*/args->out_offset,
+                   /*stride0=*/args->out_stride0,
+                   /*stride1=*/args->out_stride1,
+                   /*size0=*/args->size0,
+                   /*size1=*/args->size1);
+
+  iree_uk_x16b_2d_func_t ukernel_func = (iree_uk_x16b_2d_func_t)target_fn;
+
+  int ret = ukernel_func(
+      // LHS
+      lhs, lhs_offset, lhs_stride0, lhs_stride1,
+      // RHS
+      rhs, rhs_offset, rhs_stride0, rhs_stride1,
+      // OUT
+      out, out_offset, out_stride0, out_stride1,
+      // SIZE
+      out_size0, out_size1);
+
+  IREE_TRACE_ZONE_END(z0);
+  return ret == 0
+             ? iree_ok_status()
+             : iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                                "illegal x16b ukernel return code (%d)", ret);
+}
+
+IREE_VMVX_ABI_FIXED_STRUCT(ukernel_x16u_2d, rIIIrIIIII, {
+  iree_vm_ref_t in_ref;
+  int64_t in_offset;
+  int64_t in_stride0;
+  int64_t in_stride1;
+  iree_vm_ref_t out_ref;
+  int64_t out_offset;
+  int64_t out_stride0;
+  int64_t out_stride1;
+  int64_t size0;
+  int64_t size1;
+});
+
+static iree_status_t iree_vm_shim_ukernel_x16u_2d_v(
+    iree_vm_stack_t* IREE_RESTRICT stack, iree_vm_native_function_flags_t flags,
+    iree_byte_span_t args_storage, iree_byte_span_t rets_storage,
+    iree_vm_native_function_target2_t target_fn, void* IREE_RESTRICT module,
+    void* IREE_RESTRICT module_state) {
+  // TODO: Figure out how to identify this with the actual target fn.
+  IREE_TRACE_ZONE_BEGIN(z0);
+  const iree_vm_abi_ukernel_x16u_2d_t* args =
+      iree_vm_abi_ukernel_x16u_2d_checked_deref(args_storage);
+  if (IREE_UNLIKELY(!((flags & IREE_VM_NATIVE_FUNCTION_CALL_RESUME) || args))) {
+    IREE_TRACE_ZONE_END(z0);
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "argument/result signature mismatch");
+  }
+
+  MAP_BUFFER_2D_RO(in, iree_uk_uint16_t,
+                   /*buffer_ref=*/args->in_ref,
+                   /*offset=*/args->in_offset,
+                   /*stride0=*/args->in_stride0,
+                   /*stride1=*/args->in_stride1,
+                   /*size0=*/args->size0,
+                   /*size1=*/args->size1);
+  MAP_BUFFER_2D_RW(out, iree_uk_uint16_t,
+                   /*buffer_ref=*/args->out_ref,
+                   /*offset=*/args->out_offset,
+                   /*stride0=*/args->out_stride0,
+                   /*stride1=*/args->out_stride1,
+                   /*size0=*/args->size0,
+                   /*size1=*/args->size1);
+
+  iree_uk_x16u_2d_func_t ukernel_func = (iree_uk_x16u_2d_func_t)target_fn;
+
+  int ret = ukernel_func(
+      // IN
+      in, in_offset, in_stride0, in_stride1,
+      // OUT
+      out, out_offset, out_stride0, out_stride1,
+      // SIZE
+      out_size0, out_size1);
+
+  IREE_TRACE_ZONE_END(z0);
+  return ret == 0
+             ? iree_ok_status()
+             : iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                                "illegal x16u ukernel return code (%d)", ret);
+}
+
+IREE_VMVX_ABI_FIXED_STRUCT(ukernel_x16x32_2d, rIIIrIIIII, {
+  iree_vm_ref_t in_ref;
+  int64_t in_offset;
+  int64_t in_stride0;
+  int64_t in_stride1;
+  iree_vm_ref_t out_ref;
+  int64_t out_offset;
+  int64_t out_stride0;
+  int64_t out_stride1;
+  int64_t size0;
+  int64_t size1;
+});
+
+static iree_status_t iree_vm_shim_ukernel_x16x32_2d_v(
+    iree_vm_stack_t* IREE_RESTRICT stack, iree_vm_native_function_flags_t flags,
+    iree_byte_span_t args_storage, iree_byte_span_t rets_storage,
+    iree_vm_native_function_target2_t target_fn, void* IREE_RESTRICT module,
+    void* IREE_RESTRICT module_state) {
+  // TODO: Figure out how to identify this with the actual target fn.
+  IREE_TRACE_ZONE_BEGIN(z0);
+  const iree_vm_abi_ukernel_x16x32_2d_t* args =
+      iree_vm_abi_ukernel_x16x32_2d_checked_deref(args_storage);
+  if (IREE_UNLIKELY(!((flags & IREE_VM_NATIVE_FUNCTION_CALL_RESUME) || args))) {
+    IREE_TRACE_ZONE_END(z0);
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "argument/result signature mismatch");
+  }
+
+  MAP_BUFFER_2D_RO(in, iree_uk_uint16_t,
+                   /*buffer_ref=*/args->in_ref,
+                   /*offset=*/args->in_offset,
+                   /*stride0=*/args->in_stride0,
+                   /*stride1=*/args->in_stride1,
+                   /*size0=*/args->size0,
+                   /*size1=*/args->size1);
+  MAP_BUFFER_2D_RW(out, iree_uk_uint32_t,
+                   /*buffer_ref=*/args->out_ref,
+                   /*offset=*/args->out_offset,
+                   /*stride0=*/args->out_stride0,
+                   /*stride1=*/args->out_stride1,
+                   /*size0=*/args->size0,
+                   /*size1=*/args->size1);
+
+  iree_uk_x16x32_2d_func_t ukernel_func = (iree_uk_x16x32_2d_func_t)target_fn;
+
+  int ret = ukernel_func(
+      // IN
+      in, in_offset, in_stride0, in_stride1,
+      // OUT
+      out, out_offset, out_stride0, out_stride1,
+      // SIZE
+      out_size0, out_size1);
+
+  IREE_TRACE_ZONE_END(z0);
+  return ret == 0
+             ? iree_ok_status()
+             : iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                                "illegal x16x32 ukernel return code (%d)", ret);
+}
+
+IREE_VMVX_ABI_FIXED_STRUCT(ukernel_x32x16_2d, rIIIrIIIII, {
+  iree_vm_ref_t in_ref;
+  int64_t in_offset;
+  int64_t in_stride0;
+  int64_t in_stride1;
+  iree_vm_ref_t out_ref;
+  int64_t out_offset;
+  int64_t out_stride0;
+  int64_t out_stride1;
+  int64_t size0;
+  int64_t size1;
+});
+
+static iree_status_t iree_vm_shim_ukernel_x32x16_2d_v(
+    iree_vm_stack_t* IREE_RESTRICT stack, iree_vm_native_function_flags_t flags,
+    iree_byte_span_t args_storage, iree_byte_span_t rets_storage,
+    iree_vm_native_function_target2_t target_fn, void* IREE_RESTRICT module,
+    void* IREE_RESTRICT module_state) {
+  // TODO: Figure out how to identify this with the actual target fn.
+  IREE_TRACE_ZONE_BEGIN(z0);
+  const iree_vm_abi_ukernel_x32x16_2d_t* args =
+      iree_vm_abi_ukernel_x32x16_2d_checked_deref(args_storage);
+  if (IREE_UNLIKELY(!((flags & IREE_VM_NATIVE_FUNCTION_CALL_RESUME) || args))) {
+    IREE_TRACE_ZONE_END(z0);
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "argument/result signature mismatch");
+  }
+
+  MAP_BUFFER_2D_RO(in, iree_uk_uint32_t,
+                   /*buffer_ref=*/args->in_ref,
+                   /*offset=*/args->in_offset,
+                   /*stride0=*/args->in_stride0,
+                   /*stride1=*/args->in_stride1,
+                   /*size0=*/args->size0,
+                   /*size1=*/args->size1);
+  MAP_BUFFER_2D_RW(out, iree_uk_uint16_t,
+                   /*buffer_ref=*/args->out_ref,
+                   /*offset=*/args->out_offset,
+                   /*stride0=*/args->out_stride0,
+                   /*stride1=*/args->out_stride1,
+                   /*size0=*/args->size0,
+                   /*size1=*/args->size1);
+
+  iree_uk_x32x16_2d_func_t ukernel_func = (iree_uk_x32x16_2d_func_t)target_fn;
+
+  int ret = ukernel_func(
+      // IN
+      in, in_offset, in_stride0, in_stride1,
+      // OUT
+      out, out_offset, out_stride0, out_stride1,
+      // SIZE
+      out_size0, out_size1);
+
+  IREE_TRACE_ZONE_END(z0);
+  return ret == 0
+             ? iree_ok_status()
+             : iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                                "illegal x32x16 ukernel return code (%d)", ret);
+}
+
 //===----------------------------------------------------------------------===//
 // Exported copy function definitions
 //===----------------------------------------------------------------------===//
@@ -505,6 +778,59 @@ IREE_VMVX_ABI_EXPORT(iree_vmvx_fill2d_x32, fill2d_x32, v) {
 // Exported mmt4d function definitions
 //===----------------------------------------------------------------------===//
 
+// Bits of an mmt4d tile function cache key above the flags and tile sizes.
+// VALID makes keys non-zero, BUSY is set while an entry is being published.
+#define IREE_VMVX_MMT4D_TILE_FUNC_KEY_VALID (1ull << 56)
+#define IREE_VMVX_MMT4D_TILE_FUNC_KEY_BUSY (1ull << 57)
+
+// Returns the tile function for |params|, resolving it only on the first call
+// for its flags and tile sizes. Entries are claimed in order and never
+// evicted, so a lookup can stop at the first empty entry.
+static iree_uk_mmt4d_resolved_tile_func_t iree_vmvx_mmt4d_resolve_tile_func(
+    iree_vmvx_module_t* module, const iree_uk_mmt4d_params_t* params) {
+  if ((uint32_t)params->M0 > 0xFF || (uint32_t)params->N0 > 0xFF ||
+      (uint32_t)params->K0 > 0xFF) {
+    return iree_uk_mmt4d_resolve_tile_func(params);
+  }
+  const int64_t key =
+      (int64_t)(IREE_VMVX_MMT4D_TILE_FUNC_KEY_VALID | (uint64_t)params->flags |
+                ((uint64_t)params->M0 << 32) | ((uint64_t)params->N0 << 40) |
+                ((uint64_t)params->K0 << 48));
+  iree_host_size_t i = 0;
+  for (; i < IREE_VMVX_MMT4D_TILE_FUNC_CACHE_CAPACITY; ++i) {
+    iree_vmvx_mmt4d_tile_func_cache_entry_t* entry =
+        &module->mmt4d_tile_funcs[i];
+    int64_t entry_key =
+        iree_atomic_load_int64(&entry->key, iree_memory_order_acquire);
+    if (entry_key == key) {
+      return (iree_uk_mmt4d_resolved_tile_func_t)iree_atomic_load_intptr(
+          &entry->tile_func, iree_memory_order_relaxed);
+    }
+    if (entry_key == 0) break;
+  }
+
+  // Miss: resolve and try to publish into the first empty entry. Racing with
+  // another thread on the same key is benign as both resolve the same value.
+  iree_uk_mmt4d_resolved_tile_func_t tile_func =
+      iree_uk_mmt4d_resolve_tile_func(params);
+  for (; i < IREE_VMVX_MMT4D_TILE_FUNC_CACHE_CAPACITY; ++i) {
+    iree_vmvx_mmt4d_tile_func_cache_entry_t* entry =
+        &module->mmt4d_tile_funcs[i];
+    int64_t expected = 0;
+    if (iree_atomic_compare_exchange_strong_int64(
+            &entry->key, &expected,
+            key | (int64_t)IREE_VMVX_MMT4D_TILE_FUNC_KEY_BUSY,
+            iree_memory_order_acquire, iree_memory_order_acquire)) {
+      iree_atomic_store_intptr(&entry->tile_func, (intptr_t)tile_func,
+                               iree_memory_order_relaxed);
+      iree_atomic_store_int64(&entry->key, key, iree_memory_order_release);
+      break;
+    }
+    if ((expected & ~(int64_t)IREE_VMVX_MMT4D_TILE_FUNC_KEY_BUSY) == key) break;
+  }
+  return tile_func;
+}
+
 IREE_VMVX_ABI_FIXED_STRUCT(mmt4d, rIIrIIrIIIIIiiii, {
   iree_vm_ref_t lhs_ref;
   int64_t lhs_offset;
@@ -593,7 +919,10 @@ IREE_VMVX_ABI_EXPORT(iree_vmvx_mmt4d, mmt4d, v) {
       .K0 = K0,
       .cpu_data = (const iree_uk_uint64_t*)iree_cpu_data_fields(),
   };
-  iree_uk_mmt4d(&ukernel_params);
+  iree_vmvx_module_t* vmvx_module = IREE_VMVX_MODULE_CAST(module);
+  iree_uk_mmt4d_with_resolved_tile_func(
+      &ukernel_params,
+      iree_vmvx_mmt4d_resolve_tile_func(vmvx_module, &ukernel_params));
   IREE_TRACE_ZONE_END(z0);
   return iree_ok_status();
 }
@@ -0,0 +1,450 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+// Tests the 16-bit float elementwise and conversion exports of the VMVX module
+// by invoking them through a VM context the same way compiled programs do.
+
+#include "iree/modules/vmvx/module.h"
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "iree/base/api.h"
+#include "iree/base/internal/math.h"
+#include "iree/testing/gtest.h"
+#include "iree/testing/status_matchers.h"
+#include "iree/vm/api.h"
+
+namespace iree {
+namespace {
+
+// Fills bytes of buffers that no kernel may touch.
+constexpr uint16_t kSentinel16 = 0xA5A5;
+constexpr uint32_t kSentinel32 = 0xA5A5A5A5u;
+
+// A 16-bit float format under test.
+struct Format {
+  const char* name;
+  uint16_t (*from_f32)(float value);
+  float (*to_f32)(uint16_t value);
+  // Relative tolerance for ops that are not correctly rounded.
+  float tolerance;
+};
+
+const Format kFormats[] = {
+    {"f16", iree_math_f32_to_f16, iree_math_f16_to_f32, 1e-3f},
+    {"bf16", iree_math_f32_to_bf16, iree_math_bf16_to_f32, 1e-2f},
+};
+
+// Describes where a size0 x size1 operand lives within its buffer. Offsets and
+// strides are in elements, as passed to the exports.
+struct Layout {
+  int64_t offset;
+  int64_t stride0;
+  int64_t stride1;
+
+  int64_t Index(int64_t i, int64_t j) const {
+    return offset + i * stride0 + j * stride1;
+  }
+  // Number of elements needed to hold the operand plus trailing padding.
+  int64_t Extent(int64_t size0, int64_t size1) const {
+    return Index(size0 - 1, size1 - 1) + 1 + 3;
+  }
+};
+
+float BitsToFloat(uint32_t bits) {
+  float value;
+  memcpy(&value, &bits, sizeof(value));
+  return value;
+}
+
+uint32_t FloatToBits(float value) {
+  uint32_t bits;
+  memcpy(&bits, &value, sizeof(bits));
+  return bits;
+}
+
+class VMVXModuleTest : public ::testing::Test {
+ protected:
+  static void SetUpTestSuite() {
+    IREE_ASSERT_OK(iree_vm_instance_create(
+        IREE_VM_TYPE_CAPACITY_DEFAULT, iree_allocator_system(), &instance_));
+    IREE_ASSERT_OK(iree_vmvx_module_create(instance_, iree_allocator_system(),
+                                           &vmvx_module_));
+  }
+
+  static void TearDownTestSuite() {
+    iree_vm_module_release(vmvx_module_);
+    iree_vm_instance_release(instance_);
+  }
+
+  void SetUp() override {
+    IREE_ASSERT_OK(iree_vm_context_create_with_modules(
+        instance_, IREE_VM_CONTEXT_FLAG_NONE, 1, &vmvx_module_,
+        iree_allocator_system(), &context_));
+  }
+
+  void TearDown() override {
+    for (iree_vm_buffer_t* buffer : buffers_) iree_vm_buffer_release(buffer);
+    buffers_.clear();
+    iree_vm_context_release(context_);
+  }
+
+  // Creates a mutable buffer with |contents| that is released on teardown.
+  template <typename T>
+  iree_vm_buffer_t* CreateBuffer(const std::vector<T>& contents) {
+    iree_vm_buffer_t* buffer = nullptr;
+    IREE_CHECK_OK(iree_vm_buffer_create(
+        IREE_VM_BUFFER_ACCESS_MUTABLE | IREE_VM_BUFFER_ACCESS_ORIGIN_HOST,
+        contents.size() * sizeof(T), sizeof(T), iree_allocator_system(),
+        &buffer));
+    memcpy(iree_vm_buffer_data(buffer), contents.data(),
+           contents.size() * sizeof(T));
+    buffers_.push_back(buffer);
+    return buffer;
+  }
+
+  template <typename T>
+  static std::vector<T> ReadBuffer(iree_vm_buffer_t* buffer) {
+    std::vector<T> contents(iree_vm_buffer_length(buffer) / sizeof(T));
+    memcpy(contents.data(), iree_vm_buffer_data(buffer),
+           contents.size() * sizeof(T));
+    return contents;
+  }
+
+  // Invokes `vmvx.|name|` with the |buffers| laid out as |layouts| followed by
+  // the 2D sizes.
+  iree_status_t Invoke(const std::string& name,
+                       const std::vector<iree_vm_buffer_t*>& buffers,
+                       const std::vector<Layout>& layouts, int64_t size0,
+                       int64_t size1) {
+    iree_vm_function_t function;
+    IREE_RETURN_IF_ERROR(iree_vm_context_resolve_function(
+        context_, iree_make_cstring_view(("vmvx." + name).c_str()),
+        &function));
+    iree_vm_list_t* inputs = nullptr;
+    IREE_RETURN_IF_ERROR(iree_vm_list_create(iree_vm_make_undefined_type_def(),
+                                             buffers.size() * 4 + 2,
+                                             iree_allocator_system(), &inputs));
+    iree_status_t status = iree_ok_status();
+    for (size_t i = 0; i < buffers.size() && iree_status_is_ok(status); ++i) {
+      iree_vm_ref_t buffer_ref = iree_vm_buffer_retain_ref(buffers[i]);
+      status = iree_vm_list_push_ref_move(inputs, &buffer_ref);
+      for (int64_t value :
+           {layouts[i].offset, layouts[i].stride0, layouts[i].stride1}) {
+        if (!iree_status_is_ok(status)) break;
+        iree_vm_value_t arg = iree_vm_value_make_i64(value);
+        status = iree_vm_list_push_value(inputs, &arg);
+      }
+    }
+    for (int64_t value : {size0, size1}) {
+      if (!iree_status_is_ok(status)) break;
+      iree_vm_value_t arg = iree_vm_value_make_i64(value);
+      status = iree_vm_list_push_value(inputs, &arg);
+    }
+    if (iree_status_is_ok(status)) {
+      status = iree_vm_invoke(context_, function, IREE_VM_INVOCATION_FLAG_NONE,
+                              /*policy=*/nullptr, inputs,
+                              /*outputs=*/nullptr, iree_allocator_system());
+    }
+    iree_vm_list_release(inputs);
+    return status;
+  }
+
+  // Returns a buffer holding |size0| x |size1| elements produced by
+  // |element(i, j)| at |layout| and |sentinel| everywhere else.
+  template <typename T, typename F>
+  iree_vm_buffer_t* CreateOperand(const Layout& layout, int64_t size0,
+                                  int64_t size1, T sentinel, F element) {
+    std::vector<T> contents(layout.Extent(size0, size1), sentinel);
+    for (int64_t i = 0; i < size0; ++i) {
+      for (int64_t j = 0; j < size1; ++j) {
+        contents[layout.Index(i, j)] = element(i, j);
+      }
+    }
+    return CreateBuffer(contents);
+  }
+
+  // Expects that |contents| holds the sentinel at every element outside of the
+  // size0 x size1 operand at |layout|.
+  template <typename T>
+  static void ExpectGapsUntouched(const std::vector<T>& contents,
+                                  const Layout& layout, int64_t size0,
+                                  int64_t size1, T sentinel) {
+    std::vector<bool> covered(contents.size(), false);
+    for (int64_t i = 0; i < size0; ++i) {
+      for (int64_t j = 0; j < size1; ++j) covered[layout.Index(i, j)] = true;
+    }
+    for (size_t k = 0; k < contents.size(); ++k) {
+      if (!covered[k]) EXPECT_EQ(contents[k], sentinel) << "element " << k;
+    }
+  }
+
+  static iree_vm_instance_t* instance_;
+  static iree_vm_module_t* vmvx_module_;
+
+  iree_vm_context_t* context_ = nullptr;
+  std::vector<iree_vm_buffer_t*> buffers_;
+};
+
+iree_vm_instance_t* VMVXModuleTest::instance_ = nullptr;
+iree_vm_module_t* VMVXModuleTest::vmvx_module_ = nullptr;
+
+TEST_F(VMVXModuleTest, BinaryStrided) {
+  constexpr int64_t kSize0 = 3;
+  constexpr int64_t kSize1 = 5;
+  // Contiguous with an offset, every other column with padded rows, and
+  // column-major.
+  const Layout lhs_layout = {/*offset=*/2, /*stride0=*/kSize1, /*stride1=*/1};
+  const Layout rhs_layout = {/*offset=*/1, /*stride0=*/13, /*stride1=*/2};
+  const Layout out_layout = {/*offset=*/3, /*stride0=*/1, /*stride1=*/kSize0};
+  struct {
+    const char* name;
+    float (*op)(float lhs, float rhs);
+  } const ops[] = {
+      {"add", [](float lhs, float rhs) { return lhs + rhs; }},
+      {"sub", [](float lhs, float rhs) { return lhs - rhs; }},
+      {"mul", [](float lhs, float rhs) { return lhs * rhs; }},
+      {"div", [](float lhs, float rhs) { return lhs / rhs; }},
+  };
+  for (const Format& format : kFormats) {
+    auto lhs_value = [](int64_t i, int64_t j) {
+      return static_cast<float>(i * kSize1 + j) * 0.375f - 2.5f;
+    };
+    auto rhs_value = [](int64_t i, int64_t j) {
+      return static_cast<float>(i + j) * 0.75f + 0.5f;
+    };
+    for (const auto& op : ops) {
+      std::string name = std::string(op.name) + ".2d." + format.name;
+      SCOPED_TRACE(name);
+      iree_vm_buffer_t* lhs = CreateOperand<uint16_t>(
+          lhs_layout, kSize0, kSize1, kSentinel16, [&](int64_t i, int64_t j) {
+            return format.from_f32(lhs_value(i, j));
+          });
+      iree_vm_buffer_t* rhs = CreateOperand<uint16_t>(
+          rhs_layout, kSize0, kSize1, kSentinel16, [&](int64_t i, int64_t j) {
+            return format.from_f32(rhs_value(i, j));
+          });
+      iree_vm_buffer_t* out = CreateOperand<uint16_t>(
+          out_layout, kSize0, kSize1, kSentinel16,
+          [](int64_t i, int64_t j) { return kSentinel16; });
+      IREE_ASSERT_OK(Invoke(name, {lhs, rhs, out},
+                            {lhs_layout, rhs_layout, out_layout}, kSize0,
+                            kSize1));
+      std::vector<uint16_t> results = ReadBuffer<uint16_t>(out);
+      for (int64_t i = 0; i < kSize0; ++i) {
+        for (int64_t j = 0; j < kSize1; ++j) {
+          // Inputs are exact in both formats so the result is the correctly
+          // rounded f32 result.
+          uint16_t expected = format.from_f32(
+              op.op(format.to_f32(format.from_f32(lhs_value(i, j))),
+                    format.to_f32(format.from_f32(rhs_value(i, j)))));
+          EXPECT_EQ(results[out_layout.Index(i, j)], expected)
+              << "at (" << i << ", " << j << ")";
+        }
+      }
+      ExpectGapsUntouched(results, out_layout, kSize0, kSize1, kSentinel16);
+    }
+  }
+}
+
+TEST_F(VMVXModuleTest, UnaryStrided) {
+  // Rows longer than the kernels' internal chunk of 64 elements.
+  constexpr int64_t kSize0 = 2;
+  constexpr int64_t kSize1 = 70;
+  const Layout in_layout = {/*offset=*/5, /*stride0=*/2 * kSize1 + 7,
+                            /*stride1=*/2};
+  const Layout out_layout = {/*offset=*/1, /*stride0=*/1, /*stride1=*/kSize0};
+  struct {
+    const char* name;
+    float (*op)(float value);
+    // Whether the op is correctly rounded and must match exactly.
+    bool exact;
+    // Whether the op is only tested on positive inputs.
+    bool positive;
+  } const ops[] = {
+      {"abs", [](float value) { return fabsf(value); }, true, false},
+      {"ceil", [](float value) { return ceilf(value); }, true, false},
+      {"floor", [](float value) { return floorf(value); }, true, false},
+      {"neg", [](float value) { return -value; }, true, false},
+      {"exp", [](float value) { return expf(value); }, false, false},
+      {"log", [](float value) { return logf(value); }, false, true},
+      {"rsqrt", [](float value) { return 1.0f / sqrtf(value); }, false, true},
+  };
+  for (const Format& format : kFormats) {
+    for (const auto& op : ops) {
+      std::string name = std::string(op.name) + ".2d." + format.name;
+      SCOPED_TRACE(name);
+      auto in_value = [&](int64_t i, int64_t j) {
+        float value = static_cast<float>(i * kSize1 + j) * 0.0625f;
+        return op.positive ? value + 0.25f : value - 4.375f;
+      };
+      iree_vm_buffer_t* in = CreateOperand<uint16_t>(
+          in_layout, kSize0, kSize1, kSentinel16, [&](int64_t i, int64_t j) {
+            return format.from_f32(in_value(i, j));
+          });
+      iree_vm_buffer_t* out = CreateOperand<uint16_t>(
+          out_layout, kSize0, kSize1, kSentinel16,
+          [](int64_t i, int64_t j) { return kSentinel16; });
+      IREE_ASSERT_OK(
+          Invoke(name, {in, out}, {in_layout, out_layout}, kSize0, kSize1));
+      std::vector<uint16_t> results = ReadBuffer<uint16_t>(out);
+      for (int64_t i = 0; i < kSize0; ++i) {
+        for (int64_t j = 0; j < kSize1; ++j) {
+          float expected =
+              op.op(format.to_f32(format.from_f32(in_value(i, j))));
+          uint16_t result = results[out_layout.Index(i, j)];
+          if (op.exact) {
+            EXPECT_EQ(result, format.from_f32(expected))
+                << "at (" << i << ", " << j << ")";
+          } else {
+            EXPECT_NEAR(format.to_f32(result), expected,
+                        fabsf(expected) * format.tolerance)
+                << "at (" << i << ", " << j << ")";
+          }
+        }
+      }
+      ExpectGapsUntouched(results, out_layout, kSize0, kSize1, kSentinel16);
+    }
+  }
+}
+
+TEST_F(VMVXModuleTest, ExtfStrided) {
+  constexpr int64_t kSize0 = 2;
+  constexpr int64_t kSize1 = 4;
+  const Layout in_layout = {/*offset=*/3, /*stride0=*/13, /*stride1=*/3};
+  const Layout out_layout = {/*offset=*/2, /*stride0=*/1, /*stride1=*/kSize0};
+  // Subnormal inputs are left out as whether they are flushed to zero depends
+  // on the compiler support for _Float16 in the ukernels.
+  struct {
+    const char* name;
+    uint16_t in[kSize0][kSize1];
+    uint32_t out[kSize0][kSize1];
+  } const cases[] = {
+      {"extf.2d.f16",
+       // 1.0, -2.0, 65504 (max), 2^-14 (smallest normal),
+       // -0.0, +inf, -inf, 0.333251953125.
+       {{0x3C00, 0xC000, 0x7BFF, 0x0400}, {0x8000, 0x7C00, 0xFC00, 0x3555}},
+       {{0x3F800000, 0xC0000000, 0x477FE000, 0x38800000},
+        {0x80000000, 0x7F800000, 0xFF800000, 0x3EAAA000}}},
+      {"extf.2d.bf16",
+       // 1.0, -2.0, max, 2^-126 (smallest normal),
+       // -0.0, +inf, -inf, 0.333984375.
+       {{0x3F80, 0xC000, 0x7F7F, 0x0080}, {0x8000, 0x7F80, 0xFF80, 0x3EAB}},
+       {{0x3F800000, 0xC0000000, 0x7F7F0000, 0x00800000},
+        {0x80000000, 0x7F800000, 0xFF800000, 0x3EAB0000}}},
+  };
+  for (const auto& test_case : cases) {
+    SCOPED_TRACE(test_case.name);
+    iree_vm_buffer_t* in = CreateOperand<uint16_t>(
+        in_layout, kSize0, kSize1, kSentinel16,
+        [&](int64_t i, int64_t j) { return test_case.in[i][j]; });
+    iree_vm_buffer_t* out = CreateOperand<uint32_t>(
+        out_layout, kSize0, kSize1, kSentinel32,
+        [](int64_t i, int64_t j) { return kSentinel32; });
+    IREE_ASSERT_OK(Invoke(test_case.name, {in, out}, {in_layout, out_layout},
+                          kSize0, kSize1));
+    std::vector<uint32_t> results = ReadBuffer<uint32_t>(out);
+    for (int64_t i = 0; i < kSize0; ++i) {
+      for (int64_t j = 0; j < kSize1; ++j) {
+        EXPECT_EQ(results[out_layout.Index(i, j)], test_case.out[i][j])
+            << "at (" << i << ", " << j << ")";
+      }
+    }
+    ExpectGapsUntouched(results, out_layout, kSize0, kSize1, kSentinel32);
+  }
+}
+
+TEST_F(VMVXModuleTest, ExtfNaN) {
+  const Layout layout = {/*offset=*/0, /*stride0=*/1, /*stride1=*/1};
+  for (const Format& format : kFormats) {
+    std::string name = std::string("extf.2d.") + format.name;
+    SCOPED_TRACE(name);
+    uint16_t nan = format.from_f32(NAN);
+    iree_vm_buffer_t* in = CreateBuffer(std::vector<uint16_t>{nan});
+    iree_vm_buffer_t* out = CreateBuffer(std::vector<uint32_t>{0});
+    IREE_ASSERT_OK(Invoke(name, {in, out}, {layout, layout}, 1, 1));
+    EXPECT_TRUE(std::isnan(BitsToFloat(ReadBuffer<uint32_t>(out)[0])));
+  }
+}
+
+TEST_F(VMVXModuleTest, TruncfRoundsToNearestEven) {
+  constexpr int64_t kSize0 = 2;
+  constexpr int64_t kSize1 = 4;
+  const Layout in_layout = {/*offset=*/1, /*stride0=*/1, /*stride1=*/kSize0};
+  const Layout out_layout = {/*offset=*/4, /*stride0=*/11, /*stride1=*/2};
+  struct {
+    const char* name;
+    float in[kSize0][kSize1];
+    uint16_t out[kSize0][kSize1];
+  } const cases[] = {
+      {"truncf.2d.f16",
+       // Ties round to the even neighbor, values above a tie round up, values
+       // past the largest finite value overflow, and values below half of the
+       // smallest subnormal underflow to zero.
+       {{1.0f + 0x1p-11f, 1.0f + 0x3p-11f, 1.0f + 0x1p-11f + 0x1p-20f, -2.0f},
+        {65520.0f, -65520.0f, 1e-8f, 0.1f}},
+       {{0x3C00, 0x3C02, 0x3C01, 0xC000}, {0x7C00, 0xFC00, 0x0000, 0x2E66}}},
+      {"truncf.2d.bf16",
+       {{1.0f + 0x1p-8f, 1.0f + 0x3p-8f, 1.0f + 0x1p-8f + 0x1p-16f, -2.0f},
+        {INFINITY, -INFINITY, 0x1p-140f, 0.1f}},
+       {{0x3F80, 0x3F82, 0x3F81, 0xC000}, {0x7F80, 0xFF80, 0x0000, 0x3DCD}}},
+  };
+  for (const auto& test_case : cases) {
+    SCOPED_TRACE(test_case.name);
+    iree_vm_buffer_t* in = CreateOperand<uint32_t>(
+        in_layout, kSize0, kSize1, kSentinel32,
+        [&](int64_t i, int64_t j) { return FloatToBits(test_case.in[i][j]); });
+    iree_vm_buffer_t* out = CreateOperand<uint16_t>(
+        out_layout, kSize0, kSize1, kSentinel16,
+        [](int64_t i, int64_t j) { return kSentinel16; });
+    IREE_ASSERT_OK(Invoke(test_case.name, {in, out}, {in_layout, out_layout},
+                          kSize0, kSize1));
+    std::vector<uint16_t> results = ReadBuffer<uint16_t>(out);
+    for (int64_t i = 0; i < kSize0; ++i) {
+      for (int64_t j = 0; j < kSize1; ++j) {
+        EXPECT_EQ(results[out_layout.Index(i, j)], test_case.out[i][j])
+            << "at (" << i << ", " << j << ")";
+      }
+    }
+    ExpectGapsUntouched(results, out_layout, kSize0, kSize1, kSentinel16);
+  }
+}
+
+TEST_F(VMVXModuleTest, TruncfNaN) {
+  const Layout layout = {/*offset=*/0, /*stride0=*/1, /*stride1=*/1};
+  for (const Format& format : kFormats) {
+    std::string name = std::string("truncf.2d.") + format.name;
+    SCOPED_TRACE(name);
+    iree_vm_buffer_t* in =
+        CreateBuffer(std::vector<uint32_t>{FloatToBits(NAN)});
+    iree_vm_buffer_t* out = CreateBuffer(std::vector<uint16_t>{0});
+    IREE_ASSERT_OK(Invoke(name, {in, out}, {layout, layout}, 1, 1));
+    EXPECT_TRUE(std::isnan(format.to_f32(ReadBuffer<uint16_t>(out)[0])));
+  }
+}
+
+TEST_F(VMVXModuleTest, OutOfBoundsOperandFails) {
+  constexpr int64_t kSize0 = 2;
+  constexpr int64_t kSize1 = 3;
+  const Layout layout = {/*offset=*/0, /*stride0=*/kSize1, /*stride1=*/1};
+  // The output stride runs past the end of the buffer on the last row.
+  const Layout out_layout = {/*offset=*/1, /*stride0=*/kSize1, /*stride1=*/1};
+  std::vector<uint16_t> contents(kSize0 * kSize1, kSentinel16);
+  iree_vm_buffer_t* in = CreateBuffer(contents);
+  iree_vm_buffer_t* out = CreateBuffer(contents);
+  iree_status_t status =
+      Invoke("neg.2d.f16", {in, out}, {layout, out_layout}, kSize0, kSize1);
+  IREE_EXPECT_STATUS_IS(IREE_STATUS_OUT_OF_RANGE, status);
+  iree_status_free(status);
+  EXPECT_EQ(ReadBuffer<uint16_t>(out), contents);
+}
+
+}  // namespace
+}  // namespace iree
@@ -74,4 +74,51 @@ enum iree_cpu_data_field_0_e {
 
 #undef IREE_CPU_FEATURE_BIT_NAME
 
+//===----------------------------------------------------------------------===//
+// Processor data field 6: processor model
+//===----------------------------------------------------------------------===//
+// Identifies the microarchitecture of the processor beyond its ISA features,
+// for instance so that tuning tools such as ukernel/tools/mmt4d_autotune can
+// report which processor their measurements were taken on. Two processors with
+// the same feature bits in field 0 may still prefer different code paths.
+//
+// The field packs a vendor, family and model id whose meaning is
+// architecture-specific:
+//   x86_64: vendor is one of IREE_CPU_DATA6_X86_64_VENDOR_* and family and
+//           model are the CPUID leaf 1 display family and display model.
+//   arm_64: vendor is the MIDR_EL1 implementer, family is zero and model is
+//           the MIDR_EL1 primary part number.
+// A zero value means the model is unknown.
+
+#define IREE_CPU_DATA_MODEL_FIELD_INDEX 6
+#define IREE_CPU_DATA6_MODEL_SHIFT 0
+#define IREE_CPU_DATA6_MODEL_MASK 0xFFFFull
+#define IREE_CPU_DATA6_FAMILY_SHIFT 16
+#define IREE_CPU_DATA6_FAMILY_MASK 0xFFFFull
+#define IREE_CPU_DATA6_VENDOR_SHIFT 32
+#define IREE_CPU_DATA6_VENDOR_MASK 0xFFFFull
+
+#define IREE_CPU_DATA6_X86_64_VENDOR_INTEL 1
+#define IREE_CPU_DATA6_X86_64_VENDOR_AMD 2
+
+// Packs the given ids into a processor data field 6 value.
+#define IREE_CPU_DATA6_MAKE_MODEL(vendor, family, model)                      \
+  ((((vendor)&IREE_CPU_DATA6_VENDOR_MASK) << IREE_CPU_DATA6_VENDOR_SHIFT) |   \
+   (((family)&IREE_CPU_DATA6_FAMILY_MASK) << IREE_CPU_DATA6_FAMILY_SHIFT) |   \
+   (((model)&IREE_CPU_DATA6_MODEL_MASK) << IREE_CPU_DATA6_MODEL_SHIFT))
+
+//===----------------------------------------------------------------------===//
+// Processor data field 7: cache hierarchy
+//===----------------------------------------------------------------------===//
+// Unlike the feature bits above this field is architecture-independent. It
+// holds the sizes of the data caches visible to a single core in KiB, packed as
+// 20-bit values. A zero size means the cache level is unknown or absent and
+// consumers must fall back to their cache-oblivious behavior.
+
+#define IREE_CPU_DATA_CACHE_FIELD_INDEX 7
+#define IREE_CPU_DATA_CACHE_SIZE_KB_MASK 0xFFFFFull
+#define IREE_CPU_DATA7_L1D_SIZE_KB_SHIFT 0
+#define IREE_CPU_DATA7_L2_SIZE_KB_SHIFT 20
+#define IREE_CPU_DATA7_L3_SIZE_KB_SHIFT 40
+
 #endif  // IREE_SCHEMAS_CPU_DATA_H_
@@ -11,6 +11,7 @@
 
 #include "iree/base/internal/flags.h"
 #include "iree/task/topology.h"
+#include "iree/task/tuning.h"
 
 //===----------------------------------------------------------------------===//
 // Executor configuration
@@ -34,15 +35,19 @@ IREE_FLAG(
     "the stack for storage over ~16-32KB and instead use local workgroup\n"
     "memory.");
 
-// TODO(benvanik): enable this when we use it - though hopefully we don't!
 IREE_FLAG(
-    int32_t, task_worker_local_memory, 0,  // 64 * 1024,
-    "Specifies the bytes of per-worker local memory allocated for use by\n"
-    "dispatched tiles. Tiles may use less than this but will fail to dispatch\n"
-    "if they require more. Conceptually it is like a stack reservation and\n"
-    "should be treated the same way: the source programs must be built to\n"
-    "only use a specific maximum amount of local memory and the runtime must\n"
-    "be configured to make at least that amount of local memory available.");
+    int32_t, task_worker_local_memory, 0,
+    "Specifies the bytes of per-worker local memory initially allocated for\n"
+    "use by dispatched tiles. Workers grow their local memory on demand to\n"
+    "the largest amount any dispatch they execute requires; setting this to\n"
+    "the high water mark observed in production avoids growth during\n"
+    "execution. 0 allocates lazily on first use.");
+
+IREE_FLAG(
+    int64_t, task_worker_local_memory_limit,
+    IREE_TASK_WORKER_LOCAL_MEMORY_DEFAULT_LIMIT,
+    "Specifies the maximum bytes of local memory each worker may grow to.\n"
+    "Dispatches requiring more local memory than this fail.");
 
 iree_status_t iree_task_executor_options_initialize_from_flags(
     iree_task_executor_options_t* out_options) {
@@ -54,6 +59,8 @@ iree_status_t iree_task_executor_options_initialize_from_flags(
       (iree_host_size_t)FLAG_task_worker_stack_size;
   out_options->worker_local_memory_size =
       (iree_host_size_t)FLAG_task_worker_local_memory;
+  out_options->worker_local_memory_limit =
+      (iree_host_size_t)FLAG_task_worker_local_memory_limit;
   return iree_ok_status();
 }
 
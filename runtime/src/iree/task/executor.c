@@ -27,6 +27,8 @@ static void iree_task_executor_destroy(iree_task_executor_t* executor);
 void iree_task_executor_options_initialize(
     iree_task_executor_options_t* out_options) {
   memset(out_options, 0, sizeof(*out_options));
+  out_options->worker_local_memory_limit =
+      IREE_TASK_WORKER_LOCAL_MEMORY_DEFAULT_LIMIT;
 }
 
 iree_status_t iree_task_executor_create(iree_task_executor_options_t options,
@@ -53,23 +55,21 @@ iree_status_t iree_task_executor_create(iree_task_executor_options_t options,
   IREE_ASSERT_ARGUMENT(out_executor);
   *out_executor = NULL;
 
-  // The executor is followed in memory by worker[] + worker_local_memory[].
-  // The whole point is that we don't want destructive sharing between workers
-  // so ensure we are aligned to at least the destructive interference size.
-  options.worker_local_memory_size =
-      iree_host_align(options.worker_local_memory_size,
-                      iree_hardware_destructive_interference_size);
+  // The executor is followed in memory by worker[]. The whole point is that
+  // we don't want destructive sharing between workers so ensure we are aligned
+  // to at least the destructive interference size. Worker local memory is
+  // allocated by each worker on its own thread.
   IREE_TRACE_ZONE_APPEND_VALUE_I64(z0,
                                    (int64_t)options.worker_local_memory_size);
+  options.worker_local_memory_limit = iree_max(
+      options.worker_local_memory_limit, options.worker_local_memory_size);
   iree_host_size_t executor_base_size =
       iree_host_align(sizeof(iree_task_executor_t),
                       iree_hardware_destructive_interference_size);
   iree_host_size_t worker_list_size =
       iree_host_align(worker_count * sizeof(iree_task_worker_t),
                       iree_hardware_destructive_interference_size);
-  iree_host_size_t executor_size =
-      executor_base_size + worker_list_size +
-      worker_count * options.worker_local_memory_size;
+  iree_host_size_t executor_size = executor_base_size + worker_list_size;
 
   iree_task_executor_t* executor = NULL;
   IREE_RETURN_AND_END_ZONE_IF_ERROR(
@@ -150,8 +150,6 @@ iree_status_t iree_task_executor_create(iree_task_executor_options_t options,
     executor->worker_count = worker_count;
     executor->workers =
         (iree_task_worker_t*)((uint8_t*)executor + executor_base_size);
-    uint8_t* worker_local_memory =
-        (uint8_t*)executor->workers + worker_list_size;
 
     iree_task_affinity_set_t worker_mask =
         iree_task_affinity_set_ones(worker_count);
@@ -160,11 +158,8 @@ iree_status_t iree_task_executor_create(iree_task_executor_options_t options,
       iree_task_worker_t* worker = &executor->workers[i];
       status = iree_task_worker_initialize(
           executor, i, iree_task_topology_get_group(topology, i),
-          options.worker_stack_size,
-          iree_make_byte_span(worker_local_memory,
-                              options.worker_local_memory_size),
-          &seed_prng, worker);
-      worker_local_memory += options.worker_local_memory_size;
+          options.worker_stack_size, options.worker_local_memory_size,
+          options.worker_local_memory_limit, &seed_prng, worker);
       if (!iree_status_is_ok(status)) break;
     }
 
@@ -250,6 +245,26 @@ void iree_task_executor_trim(iree_task_executor_t* executor) {
   // iree_task_pool_trim(&executor->transient_task_pool);
 }
 
+void iree_task_executor_query_local_memory_statistics(
+    iree_task_executor_t* executor,
+    iree_task_executor_local_memory_statistics_t* out_statistics) {
+  IREE_ASSERT_ARGUMENT(executor);
+  IREE_ASSERT_ARGUMENT(out_statistics);
+  memset(out_statistics, 0, sizeof(*out_statistics));
+  for (iree_host_size_t i = 0; i < executor->worker_count; ++i) {
+    iree_task_worker_local_memory_statistics_t worker_statistics;
+    iree_task_worker_query_local_memory_statistics(&executor->workers[i],
+                                                   &worker_statistics);
+    out_statistics->high_water_mark = iree_max(
+        out_statistics->high_water_mark, worker_statistics.high_water_mark);
+    out_statistics->max_worker_capacity =
+        iree_max(out_statistics->max_worker_capacity,
+                 worker_statistics.capacity);
+    out_statistics->total_capacity += worker_statistics.capacity;
+    out_statistics->grow_count += worker_statistics.grow_count;
+  }
+}
+
 iree_host_size_t iree_task_executor_worker_count(
     iree_task_executor_t* executor) {
   return executor->worker_count;
@@ -296,12 +296,16 @@ typedef struct iree_task_executor_options_t {
   // for storage over ~16-32KB and instead use local workgroup memory.
   iree_host_size_t worker_stack_size;
 
-  // Defines the bytes to be allocated and reserved by each worker to use for
-  // local memory operations. Will be rounded up to the next power of two.
-  // Dispatches performed will be able to request up to this amount of memory
-  // for their invocations and no more. May be 0 if no worker local memory is
-  // required.
+  // Defines the bytes to be initially allocated by each worker to use for
+  // local memory operations. Workers grow their local memory on demand to the
+  // largest amount requested by any dispatch they execute so this only avoids
+  // growth during execution. May be 0 to allocate lazily.
   iree_host_size_t worker_local_memory_size;
+
+  // Maximum bytes of local memory each worker may grow to. Dispatches that
+  // request more fail with IREE_STATUS_RESOURCE_EXHAUSTED. Values smaller than
+  // worker_local_memory_size are raised to it.
+  iree_host_size_t worker_local_memory_limit;
 } iree_task_executor_options_t;
 
 // Initializes |out_options| to default values.
@@ -330,6 +334,26 @@ void iree_task_executor_release(iree_task_executor_t* executor);
 // Trims pools and caches used by the executor and its workers.
 void iree_task_executor_trim(iree_task_executor_t* executor);
 
+// Statistics about the local memory used by workers to execute dispatches.
+typedef struct iree_task_executor_local_memory_statistics_t {
+  // Largest amount of local memory requested by any dispatch on any worker.
+  iree_host_size_t high_water_mark;
+  // Largest local memory block currently allocated by any single worker.
+  iree_host_size_t max_worker_capacity;
+  // Total bytes of local memory currently allocated across all workers.
+  iree_host_size_t total_capacity;
+  // Total number of times any worker had to grow its local memory.
+  uint64_t grow_count;
+} iree_task_executor_local_memory_statistics_t;
+
+// Queries statistics about the local memory used by workers of |executor|.
+// The high water mark can be used to size worker_local_memory_size (and
+// --task_worker_local_memory) such that no growth happens in production.
+// Values are sampled without synchronizing with workers and may be stale.
+void iree_task_executor_query_local_memory_statistics(
+    iree_task_executor_t* executor,
+    iree_task_executor_local_memory_statistics_t* out_statistics);
+
 // Returns the number of live workers usable by the executor.
 // The actual number used for any particular operation is dynamic.
 iree_host_size_t iree_task_executor_worker_count(
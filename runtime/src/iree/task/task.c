@@ -530,6 +530,7 @@ static void iree_task_dispatch_initialize_base(
   memcpy(out_task->workgroup_size, workgroup_size,
          sizeof(out_task->workgroup_size));
   out_task->local_memory_size = 0;
+  out_task->shard_fn = NULL;
   iree_atomic_store_intptr(&out_task->status, 0, iree_memory_order_release);
   memset(&out_task->statistics, 0, sizeof(out_task->statistics));
 
@@ -709,6 +710,19 @@ iree_task_dispatch_shard_t* iree_task_dispatch_shard_allocate(
   return shard_task;
 }
 
+iree_host_size_t iree_task_dispatch_shard_local_memory_size(
+    iree_task_dispatch_shard_t* task) {
+  return iree_task_dispatch_shard_parent(task)->local_memory_size;
+}
+
+void iree_task_dispatch_shard_fail(iree_task_dispatch_shard_t* task,
+                                   iree_status_t status,
+                                   iree_task_submission_t* pending_submission) {
+  iree_task_dispatch_t* dispatch_task = iree_task_dispatch_shard_parent(task);
+  iree_task_try_set_status(&dispatch_task->status, status);
+  iree_task_retire(&task->header, pending_submission, iree_ok_status());
+}
+
 void iree_task_dispatch_shard_execute(
     iree_task_dispatch_shard_t* task, iree_cpu_processor_id_t processor_id,
     uint32_t worker_id, iree_byte_span_t worker_local_memory,
@@ -722,17 +736,18 @@ void iree_task_dispatch_shard_execute(
 
   // Map only the requested amount of worker local memory into the tile context.
   // This ensures that how much memory is used by some executions does not
-  // inadvertently leak over into other executions.
+  // inadvertently leak over into other executions. Workers grow their local
+  // memory prior to execution so this only guards against callers that don't.
   if (IREE_UNLIKELY(dispatch_task->local_memory_size >
                     worker_local_memory.data_length)) {
-    iree_task_try_set_status(
-        &dispatch_task->status,
+    iree_task_dispatch_shard_fail(
+        task,
         iree_make_status(IREE_STATUS_RESOURCE_EXHAUSTED,
                          "dispatch requires %ub of local memory but only "
                          "%" PRIhsz "b is available per-worker",
                          dispatch_task->local_memory_size,
-                         worker_local_memory.data_length));
-    iree_task_retire(&task->header, pending_submission, iree_ok_status());
+                         worker_local_memory.data_length),
+        pending_submission);
     IREE_TRACE_ZONE_END(z0);
     return;
   }
@@ -741,6 +756,7 @@ void iree_task_dispatch_shard_execute(
 
   // Prepare context shared for all tiles in the shard.
   iree_task_tile_context_t tile_context;
+  memset(&tile_context.workgroup_xyz, 0, sizeof(tile_context.workgroup_xyz));
   memcpy(&tile_context.workgroup_size, dispatch_task->workgroup_size,
          sizeof(tile_context.workgroup_size));
   memcpy(&tile_context.workgroup_count, dispatch_task->workgroup_count.value,
@@ -768,6 +784,11 @@ void iree_task_dispatch_shard_execute(
   uint32_t tile_base = iree_atomic_fetch_add_int32(&dispatch_task->tile_index,
                                                    tiles_per_reservation,
                                                    iree_memory_order_relaxed);
+  const bool has_shard_fn = dispatch_task->shard_fn && tile_base < tile_count;
+  if (has_shard_fn) {
+    dispatch_task->shard_fn(dispatch_task->closure.user_context, &tile_context,
+                            IREE_TASK_DISPATCH_SHARD_EVENT_BEGIN);
+  }
   while (tile_base < tile_count) {
     const uint32_t tile_range =
         iree_min(tile_base + tiles_per_reservation, tile_count);
@@ -820,6 +841,10 @@ void iree_task_dispatch_shard_execute(
                                             iree_memory_order_relaxed);
   }
 abort_shard:
+  if (has_shard_fn) {
+    dispatch_task->shard_fn(dispatch_task->closure.user_context, &tile_context,
+                            IREE_TASK_DISPATCH_SHARD_EVENT_END);
+  }
 
   // Push aggregate statistics up to the dispatch.
   // Note that we may have partial information here if we errored out of the
@@ -571,6 +571,21 @@ typedef struct iree_task_dispatch_closure_t {
   void* user_context;
 } iree_task_dispatch_closure_t;
 
+// Identifies the point within a dispatch shard a shard function is called at.
+typedef enum iree_task_dispatch_shard_event_e {
+  // The worker is about to process the first tile of the shard.
+  IREE_TASK_DISPATCH_SHARD_EVENT_BEGIN = 0,
+  // The worker has processed (or aborted) the last tile of the shard.
+  IREE_TASK_DISPATCH_SHARD_EVENT_END = 1,
+} iree_task_dispatch_shard_event_t;
+
+// Function called on the worker executing a dispatch shard around all of the
+// tiles it processes. |tile_context| is the context shared by those tiles with
+// a workgroup_xyz that is not meaningful.
+typedef void(IREE_API_PTR* iree_task_dispatch_shard_fn_t)(
+    void* user_context, const iree_task_tile_context_t* tile_context,
+    iree_task_dispatch_shard_event_t event);
+
 // Binds a function pointer and the arguments it should be called with.
 // If the arguments represent pointers they must remain live until the task
 // has completed execution.
@@ -628,6 +643,12 @@ typedef iree_alignas(iree_max_align_t) struct iree_task_dispatch_t {
   // dispatch closure.
   uint32_t local_memory_size;
 
+  // Optional function called with the closure user_context before the first
+  // and after the last tile each shard processes. Shards that process no tiles
+  // do not call it. Allows per-tile work such as reading hardware counters to
+  // be amortized across all tiles a worker processes.
+  iree_task_dispatch_shard_fn_t shard_fn;
+
   // Resulting status from the dispatch available once all workgroups have
   // completed (or would have completed). If multiple shards processing the
   // workgroups hit an error the first will be taken and the result ignored. A
@@ -107,6 +107,18 @@ void iree_task_dispatch_retire(iree_task_dispatch_t* dispatch_task,
 iree_task_dispatch_shard_t* iree_task_dispatch_shard_allocate(
     iree_task_dispatch_t* dispatch_task, iree_task_pool_t* shard_task_pool);
 
+// Returns the bytes of worker local memory required to execute |task|.
+// Workers use this to ensure their local memory is large enough prior to
+// calling iree_task_dispatch_shard_execute.
+iree_host_size_t iree_task_dispatch_shard_local_memory_size(
+    iree_task_dispatch_shard_t* task);
+
+// Fails the parent dispatch of |task| with |status| and retires the shard
+// without executing any tiles. Takes ownership of |status|.
+void iree_task_dispatch_shard_fail(iree_task_dispatch_shard_t* task,
+                                   iree_status_t status,
+                                   iree_task_submission_t* pending_submission);
+
 // Executes and retires a dispatch shard task.
 // May block the caller for an indeterminate amount of time and should only be
 // called from threads owned by or donated to the executor.
@@ -6,12 +6,14 @@
 
 #include <cstdint>
 #include <cstdio>
+#include <cstring>
 #include <memory>
 
 #include "iree/base/api.h"
 #include "iree/task/submission.h"
 #include "iree/task/task.h"
 #include "iree/task/testing/task_test.h"
+#include "iree/task/tuning.h"
 #include "iree/testing/gtest.h"
 #include "iree/testing/status_matchers.h"
 
@@ -214,4 +216,139 @@ TEST_F(TaskDispatchTest, IssueFailureChained) {
               StatusIs(StatusCode::kDataLoss));
 }
 
+// Tests that workers grow their local memory to fit dispatches that request
+// more than was initially allocated.
+TEST_F(TaskDispatchTest, IssueLocalMemoryGrowth) {
+  IREE_TRACE_SCOPE();
+
+  const uint32_t kWorkgroupSize[3] = {1, 1, 1};
+  const uint32_t kWorkgroupCount[3] = {64, 1, 1};
+  static const uint32_t kLocalMemorySize = 256 * 1024;
+
+  auto tile = [](void* user_context,
+                 const iree_task_tile_context_t* tile_context,
+                 iree_task_submission_t* pending_submission) -> iree_status_t {
+    IREE_TRACE_SCOPE();
+    if (tile_context->local_memory.data_length != kLocalMemorySize) {
+      return iree_make_status(IREE_STATUS_INTERNAL,
+                              "local memory size mismatch");
+    }
+    memset(tile_context->local_memory.data, 0xCD,
+           tile_context->local_memory.data_length);
+    return iree_ok_status();
+  };
+
+  iree_task_dispatch_t task;
+  iree_task_dispatch_initialize(&scope_,
+                                iree_task_make_dispatch_closure(tile, NULL),
+                                kWorkgroupSize, kWorkgroupCount, &task);
+  task.local_memory_size = kLocalMemorySize;
+  IREE_ASSERT_OK(SubmitTasksAndWaitIdle(&task.header, &task.header));
+  IREE_EXPECT_OK(iree_task_scope_consume_status(&scope_));
+
+  iree_task_executor_local_memory_statistics_t statistics;
+  iree_task_executor_query_local_memory_statistics(executor_, &statistics);
+  EXPECT_EQ(statistics.high_water_mark, kLocalMemorySize);
+  EXPECT_GE(statistics.max_worker_capacity, kLocalMemorySize);
+  EXPECT_GE(statistics.total_capacity, statistics.max_worker_capacity);
+  EXPECT_GE(statistics.grow_count, 1);
+}
+
+// Tests that dispatches requesting more local memory than workers are allowed
+// to grow to fail instead of executing.
+TEST_F(TaskDispatchTest, IssueLocalMemoryOverLimit) {
+  IREE_TRACE_SCOPE();
+
+  const uint32_t kWorkgroupSize[3] = {1, 1, 1};
+  const uint32_t kWorkgroupCount[3] = {4, 1, 1};
+
+  auto tile = [](void* user_context,
+                 const iree_task_tile_context_t* tile_context,
+                 iree_task_submission_t* pending_submission) -> iree_status_t {
+    IREE_TRACE_SCOPE();
+    return iree_make_status(IREE_STATUS_INTERNAL, "tile should not execute");
+  };
+
+  iree_task_dispatch_t task;
+  iree_task_dispatch_initialize(&scope_,
+                                iree_task_make_dispatch_closure(tile, NULL),
+                                kWorkgroupSize, kWorkgroupCount, &task);
+  task.local_memory_size = IREE_TASK_WORKER_LOCAL_MEMORY_DEFAULT_LIMIT + 1;
+  IREE_ASSERT_OK(SubmitTasksAndWaitIdle(&task.header, &task.header));
+  EXPECT_THAT(Status(iree_task_scope_consume_status(&scope_)),
+              StatusIs(StatusCode::kResourceExhausted));
+
+  iree_task_executor_local_memory_statistics_t statistics;
+  iree_task_executor_query_local_memory_statistics(executor_, &statistics);
+  EXPECT_LE(statistics.max_worker_capacity,
+            IREE_TASK_WORKER_LOCAL_MEMORY_DEFAULT_LIMIT);
+}
+
+// Tests that the shard function brackets all tiles each worker processes.
+TEST_F(TaskDispatchTest, IssueShardFn) {
+  IREE_TRACE_SCOPE();
+
+  const uint32_t kWorkgroupSize[3] = {1, 1, 1};
+  const uint32_t kWorkgroupCount[3] = {64, 4, 1};
+
+  struct ShardState {
+    // Shards currently open per worker; only touched by that worker.
+    int open_count[256];
+    iree_atomic_int32_t begin_count;
+    iree_atomic_int32_t end_count;
+    iree_atomic_int32_t tile_count;
+    iree_atomic_int32_t unbracketed_tile_count;
+  } state;
+  memset(&state, 0, sizeof(state));
+
+  auto shard = [](void* user_context,
+                  const iree_task_tile_context_t* tile_context,
+                  iree_task_dispatch_shard_event_t event) {
+    ShardState* state = (ShardState*)user_context;
+    if (event == IREE_TASK_DISPATCH_SHARD_EVENT_BEGIN) {
+      ++state->open_count[tile_context->worker_id];
+      iree_atomic_fetch_add_int32(&state->begin_count, 1,
+                                  iree_memory_order_relaxed);
+    } else {
+      --state->open_count[tile_context->worker_id];
+      iree_atomic_fetch_add_int32(&state->end_count, 1,
+                                  iree_memory_order_relaxed);
+    }
+  };
+  auto tile = [](void* user_context,
+                 const iree_task_tile_context_t* tile_context,
+                 iree_task_submission_t* pending_submission) -> iree_status_t {
+    ShardState* state = (ShardState*)user_context;
+    iree_atomic_fetch_add_int32(&state->tile_count, 1,
+                                iree_memory_order_relaxed);
+    if (state->open_count[tile_context->worker_id] != 1) {
+      iree_atomic_fetch_add_int32(&state->unbracketed_tile_count, 1,
+                                  iree_memory_order_relaxed);
+    }
+    return iree_ok_status();
+  };
+
+  iree_task_dispatch_t task;
+  iree_task_dispatch_initialize(&scope_,
+                                iree_task_make_dispatch_closure(tile, &state),
+                                kWorkgroupSize, kWorkgroupCount, &task);
+  task.shard_fn = shard;
+  IREE_ASSERT_OK(SubmitTasksAndWaitIdle(&task.header, &task.header));
+  IREE_EXPECT_OK(iree_task_scope_consume_status(&scope_));
+
+  EXPECT_EQ(iree_atomic_load_int32(&state.tile_count,
+                                   iree_memory_order_relaxed),
+            64 * 4);
+  EXPECT_EQ(iree_atomic_load_int32(&state.unbracketed_tile_count,
+                                   iree_memory_order_relaxed),
+            0);
+  int32_t begin_count =
+      iree_atomic_load_int32(&state.begin_count, iree_memory_order_relaxed);
+  EXPECT_GE(begin_count, 1);
+  int32_t end_count =
+      iree_atomic_load_int32(&state.end_count, iree_memory_order_relaxed);
+  EXPECT_EQ(begin_count, end_count);
+  for (int open_count : state.open_count) EXPECT_EQ(open_count, 0);
+}
+
 }  // namespace
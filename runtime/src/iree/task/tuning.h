@@ -94,6 +94,18 @@ extern "C" {
 // memory).
 #define IREE_TASK_DISPATCH_MAX_TILES_PER_SHARD_RESERVATION (8)
 
+// Alignment of the worker-local memory blocks used by dispatches and the
+// granularity at which they grow. Page alignment keeps each worker's block on
+// its own pages so that first-touch placement by the worker thread makes the
+// pages local to the NUMA node the worker runs on and no cache lines are
+// shared with other workers.
+#define IREE_TASK_WORKER_LOCAL_MEMORY_ALIGNMENT (4096)
+
+// Default maximum bytes of local memory any single worker may grow to.
+// Dispatches requiring more fail with RESOURCE_EXHAUSTED instead of allowing a
+// bad dispatch to reserve an unbounded amount of memory on every worker.
+#define IREE_TASK_WORKER_LOCAL_MEMORY_DEFAULT_LIMIT (64 * 1024 * 1024)
+
 // Whether to enable per-tile colors for each tile tracing zone based on the
 // tile grid xyz. Not cheap and can be disabled to reduce tracing overhead.
 // TODO(#4017): make per-tile color tracing fast enough to always have on.
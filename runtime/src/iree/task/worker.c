@@ -24,7 +24,8 @@ static int iree_task_worker_main(iree_task_worker_t* worker);
 iree_status_t iree_task_worker_initialize(
     iree_task_executor_t* executor, iree_host_size_t worker_index,
     const iree_task_topology_group_t* topology_group,
-    iree_host_size_t stack_size, iree_byte_span_t local_memory,
+    iree_host_size_t stack_size, iree_host_size_t local_memory_size,
+    iree_host_size_t local_memory_limit,
     iree_prng_splitmix64_state_t* seed_prng, iree_task_worker_t* out_worker) {
   IREE_TRACE_ZONE_BEGIN(z0);
 
@@ -38,7 +39,15 @@ iree_status_t iree_task_worker_initialize(
       executor->worker_count / IREE_TASK_EXECUTOR_MAX_THEFT_ATTEMPTS_DIVISOR;
   iree_prng_minilcg128_initialize(iree_prng_splitmix64_next(seed_prng),
                                   &out_worker->theft_prng);
-  out_worker->local_memory = local_memory;
+  out_worker->local_memory = iree_make_byte_span(NULL, 0);
+  out_worker->local_memory_initial_size = local_memory_size;
+  out_worker->local_memory_limit = local_memory_limit;
+  iree_atomic_store_int64(&out_worker->local_memory_capacity, 0,
+                          iree_memory_order_relaxed);
+  iree_atomic_store_int64(&out_worker->local_memory_high_water_mark, 0,
+                          iree_memory_order_relaxed);
+  iree_atomic_store_int64(&out_worker->local_memory_grow_count, 0,
+                          iree_memory_order_relaxed);
   out_worker->processor_id = 0;
   out_worker->processor_tag = 0;
 
@@ -137,6 +146,12 @@ void iree_task_worker_deinitialize(iree_task_worker_t* worker) {
   iree_atomic_task_slist_deinitialize(&worker->mailbox_slist);
   iree_task_queue_deinitialize(&worker->local_task_queue);
 
+  if (worker->local_memory.data) {
+    iree_allocator_free_aligned(worker->executor->allocator,
+                                worker->local_memory.data);
+    worker->local_memory = iree_make_byte_span(NULL, 0);
+  }
+
   IREE_TRACE_ZONE_END(z0);
 }
 
@@ -164,6 +179,74 @@ iree_task_t* iree_task_worker_try_steal_task(iree_task_worker_t* worker,
   return NULL;
 }
 
+void iree_task_worker_query_local_memory_statistics(
+    iree_task_worker_t* worker,
+    iree_task_worker_local_memory_statistics_t* out_statistics) {
+  out_statistics->capacity = (iree_host_size_t)iree_atomic_load_int64(
+      &worker->local_memory_capacity, iree_memory_order_relaxed);
+  out_statistics->high_water_mark = (iree_host_size_t)iree_atomic_load_int64(
+      &worker->local_memory_high_water_mark, iree_memory_order_relaxed);
+  out_statistics->grow_count = (uint64_t)iree_atomic_load_int64(
+      &worker->local_memory_grow_count, iree_memory_order_relaxed);
+}
+
+// Ensures the worker local memory is at least |minimum_size| bytes.
+// The contents of the local memory are not preserved across growth as they are
+// only valid for the duration of a single dispatch shard. Fails with
+// IREE_STATUS_RESOURCE_EXHAUSTED if |minimum_size| exceeds the worker limit or
+// the allocation fails; the worker is left with no local memory in the latter
+// case and will try again on the next request.
+//
+// Must only be called from the worker thread: the allocator zeroes the memory
+// and that first touch places the pages on the NUMA node of the worker.
+static iree_status_t iree_task_worker_reserve_local_memory(
+    iree_task_worker_t* worker, iree_host_size_t minimum_size) {
+  if (minimum_size > (iree_host_size_t)iree_atomic_load_int64(
+                         &worker->local_memory_high_water_mark,
+                         iree_memory_order_relaxed)) {
+    iree_atomic_store_int64(&worker->local_memory_high_water_mark,
+                            (int64_t)minimum_size, iree_memory_order_relaxed);
+  }
+  if (IREE_LIKELY(minimum_size <= worker->local_memory.data_length)) {
+    return iree_ok_status();
+  }
+  if (IREE_UNLIKELY(minimum_size > worker->local_memory_limit)) {
+    return iree_make_status(IREE_STATUS_RESOURCE_EXHAUSTED,
+                            "dispatch requires %" PRIhsz
+                            "b of local memory but workers are limited to "
+                            "%" PRIhsz "b; raise the limit with "
+                            "--task_worker_local_memory_limit",
+                            minimum_size, worker->local_memory_limit);
+  }
+  IREE_TRACE_ZONE_BEGIN(z0);
+  iree_host_size_t new_size =
+      iree_host_align(minimum_size, IREE_TASK_WORKER_LOCAL_MEMORY_ALIGNMENT);
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, (int64_t)new_size);
+
+  // Drop the old block first as its contents need not be preserved; this keeps
+  // the peak usage during growth down.
+  iree_allocator_t allocator = worker->executor->allocator;
+  iree_allocator_free_aligned(allocator, worker->local_memory.data);
+  worker->local_memory = iree_make_byte_span(NULL, 0);
+  iree_atomic_store_int64(&worker->local_memory_capacity, 0,
+                          iree_memory_order_relaxed);
+
+  uint8_t* data = NULL;
+  iree_status_t status = iree_allocator_malloc_aligned(
+      allocator, new_size, IREE_TASK_WORKER_LOCAL_MEMORY_ALIGNMENT,
+      /*offset=*/0, (void**)&data);
+  if (iree_status_is_ok(status)) {
+    worker->local_memory = iree_make_byte_span(data, new_size);
+    iree_atomic_store_int64(&worker->local_memory_capacity, (int64_t)new_size,
+                            iree_memory_order_relaxed);
+    iree_atomic_fetch_add_int64(&worker->local_memory_grow_count, 1,
+                                iree_memory_order_relaxed);
+  }
+
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
 // Executes a task on a worker.
 // Only task types that are scheduled to workers are handled; all others must be
 // handled by the coordinator during scheduling.
@@ -184,9 +267,18 @@ static void iree_task_worker_execute(
       break;
     }
     case IREE_TASK_TYPE_DISPATCH_SHARD: {
-      iree_task_dispatch_shard_execute(
-          (iree_task_dispatch_shard_t*)task, worker->processor_id,
-          worker->worker_index, worker->local_memory, pending_submission);
+      iree_task_dispatch_shard_t* shard_task =
+          (iree_task_dispatch_shard_t*)task;
+      iree_status_t status = iree_task_worker_reserve_local_memory(
+          worker, iree_task_dispatch_shard_local_memory_size(shard_task));
+      if (IREE_LIKELY(iree_status_is_ok(status))) {
+        iree_task_dispatch_shard_execute(shard_task, worker->processor_id,
+                                         worker->worker_index,
+                                         worker->local_memory,
+                                         pending_submission);
+      } else {
+        iree_task_dispatch_shard_fail(shard_task, status, pending_submission);
+      }
       break;
     }
     default:
@@ -376,6 +468,12 @@ static int iree_task_worker_main(iree_task_worker_t* worker) {
   // TODO(benvanik): call this after waking in case CPU hotplugging happens.
   iree_thread_request_affinity(worker->thread, worker->ideal_thread_affinity);
 
+  // Allocate the initial local memory from the worker thread now that it is
+  // (hopefully) running where it will stay. Failure is not fatal here as any
+  // dispatch needing the memory will try again and fail with the error.
+  iree_status_ignore(iree_task_worker_reserve_local_memory(
+      worker, worker->local_memory_initial_size));
+
   // Enter the running state immediately. Note that we could have been requested
   // to exit while suspended/still starting up, so check that here before we
   // mess with any data structures.
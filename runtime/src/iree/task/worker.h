@@ -132,10 +132,22 @@ typedef struct iree_task_worker_t {
   // interference) this is the only place padding should be added.
   // uint8_t _padding[8];
 
-  // Pointer to local memory available for use exclusively by the worker.
-  // The base address should be aligned to avoid false sharing with other
-  // workers.
+  // Local memory available for use exclusively by the worker.
+  // Allocated (and first touched) by the worker thread such that the pages are
+  // local to the NUMA node the worker runs on and grown on demand to the
+  // largest size requested by any dispatch the worker executes. The base
+  // address is aligned to IREE_TASK_WORKER_LOCAL_MEMORY_ALIGNMENT to avoid
+  // false sharing with other workers.
   iree_byte_span_t local_memory;
+  // Bytes of local memory to allocate when the worker starts.
+  iree_host_size_t local_memory_initial_size;
+  // Maximum bytes of local memory the worker may grow to.
+  iree_host_size_t local_memory_limit;
+  // Statistics about local memory usage. Only written by the worker thread
+  // but may be read from any thread.
+  iree_atomic_int64_t local_memory_capacity;
+  iree_atomic_int64_t local_memory_high_water_mark;
+  iree_atomic_int64_t local_memory_grow_count;
 
   // Worker-local FIFO queue containing the tasks that will be processed by the
   // worker. This queue supports work-stealing by other workers if they run out
@@ -159,7 +171,8 @@ static_assert(offsetof(iree_task_worker_t, local_task_queue) >=
 iree_status_t iree_task_worker_initialize(
     iree_task_executor_t* executor, iree_host_size_t worker_index,
     const iree_task_topology_group_t* topology_group,
-    iree_host_size_t stack_size, iree_byte_span_t local_memory,
+    iree_host_size_t stack_size, iree_host_size_t local_memory_size,
+    iree_host_size_t local_memory_limit,
     iree_prng_splitmix64_state_t* seed_prng, iree_task_worker_t* out_worker);
 
 // Requests that the worker begin exiting (if it hasn't already).
@@ -183,6 +196,23 @@ void iree_task_worker_await_exit(iree_task_worker_t* worker);
 //  - deinitialize all workers
 void iree_task_worker_deinitialize(iree_task_worker_t* worker);
 
+// Statistics about the local memory of a single worker.
+typedef struct iree_task_worker_local_memory_statistics_t {
+  // Bytes of local memory currently allocated by the worker.
+  iree_host_size_t capacity;
+  // Largest amount of local memory requested of the worker.
+  iree_host_size_t high_water_mark;
+  // Number of times the worker had to grow its local memory.
+  uint64_t grow_count;
+} iree_task_worker_local_memory_statistics_t;
+
+// Queries the local memory statistics of |worker|.
+//
+// May be called from any thread.
+void iree_task_worker_query_local_memory_statistics(
+    iree_task_worker_t* worker,
+    iree_task_worker_local_memory_statistics_t* out_statistics);
+
 // Posts a FIFO list of tasks to the worker mailbox. The target worker takes
 // ownership of the tasks and will be woken if it is currently idle.
 //
@@ -406,7 +406,9 @@ IREE_FLAG(
     string, device_profiling_file, "",
     "Optional file path/prefix for profiling file output. Some\n"
     "implementations may require a file name in order to capture profiling\n"
-    "information.");
+    "information. The local-sync and local-task devices write per-dispatch\n"
+    "timing and hardware counters to the file for use with\n"
+    "iree-dump-profile.");
 
 iree_status_t iree_hal_begin_profiling_from_flags(iree_hal_device_t* device) {
   if (!device) return iree_ok_status();
@@ -6,6 +6,9 @@
 
 #include "iree/tooling/numpy_io.h"
 
+#include "iree/base/internal/atomics.h"
+#include "iree/base/internal/file_io.h"
+
 //===----------------------------------------------------------------------===//
 // .npy (multiple values concatenated)
 //===----------------------------------------------------------------------===//
@@ -24,6 +27,34 @@
 //   padded with spaces (\x20) such that
 //   `len(magic string) + 2 + len(length) + HEADER_LEN` % 64 = 0
 
+// Fixed-size prefix of all npy headers.
+typedef struct iree_numpy_npy_header_prefix_t {
+  uint8_t magic[6];
+  uint8_t version_major;
+  uint8_t version_minor;
+} iree_numpy_npy_header_prefix_t;
+static_assert(sizeof(iree_numpy_npy_header_prefix_t) == 8, "packing");
+
+// Verifies that |header| is from an npy file of a version we support.
+static iree_status_t iree_numpy_npy_verify_header_prefix(
+    const iree_numpy_npy_header_prefix_t* header) {
+  // Verify magic bytes to confirm this is an npy file.
+  static const uint8_t kMagicBytes[6] = {0x93, 'N', 'U', 'M', 'P', 'Y'};
+  if (memcmp(header->magic, kMagicBytes, sizeof(kMagicBytes)) != 0) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "npy header magic mismatch");
+  }
+
+  // Ensure we support the version; newer versions aren't expected to parse.
+  // There's been no minor versions yet so we only need to check major.
+  if (header->version_major <= 0 || header->version_major > 3) {
+    return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
+                            "npy version %d.%d not supported",
+                            header->version_major, header->version_minor);
+  }
+  return iree_ok_status();
+}
+
 // Reads the numpy file header string into an allocated |out_header_buffer|.
 // Upon successful return the |stream| will be positioned immediately at the
 // start of the file payload.
@@ -39,31 +70,12 @@ static iree_status_t iree_numpy_npy_read_header(
 
   // Since the header contents vary based on version we read the fixed prefix
   // first and then continue with the rest.
-  struct {
-    uint8_t magic[6];
-    uint8_t version_major;
-    uint8_t version_minor;
-  } header;
-  static_assert(sizeof(header) == 8, "packing");
+  iree_numpy_npy_header_prefix_t header;
   if (fread(&header, 1, sizeof(header), stream) != sizeof(header)) {
     return iree_make_status(IREE_STATUS_RESOURCE_EXHAUSTED,
                             "unable to read entire header prefix");
   }
-
-  // Verify magic bytes to confirm this is an npy file.
-  static const uint8_t kMagicBytes[6] = {0x93, 'N', 'U', 'M', 'P', 'Y'};
-  if (memcmp(header.magic, kMagicBytes, sizeof(kMagicBytes)) != 0) {
-    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
-                            "npy header magic mismatch");
-  }
-
-  // Ensure we support the version; newer versions aren't expected to parse.
-  // There's been no minor versions yet so we only need to check major.
-  if (header.version_major <= 0 || header.version_major > 3) {
-    return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
-                            "npy version %d.%d not supported",
-                            header.version_major, header.version_minor);
-  }
+  IREE_RETURN_IF_ERROR(iree_numpy_npy_verify_header_prefix(&header));
 
   // Read 2- or 4-byte header length.
   // Have never seen a header actually needing 4-bytes (any reason to have one
@@ -292,37 +304,23 @@ static iree_status_t iree_numpy_parse_shape_dims(iree_string_view_t shape,
   return iree_ok_status();
 }
 
-IREE_API_EXPORT iree_status_t iree_numpy_npy_load_ndarray(
-    FILE* stream, iree_numpy_npy_load_options_t options,
-    iree_hal_buffer_params_t buffer_params, iree_hal_device_t* device,
-    iree_hal_allocator_t* device_allocator,
-    iree_hal_buffer_view_t** out_buffer_view) {
-  IREE_ASSERT_ARGUMENT(stream);
-  IREE_ASSERT_ARGUMENT(device_allocator);
-  IREE_ASSERT_ARGUMENT(out_buffer_view);
-  *out_buffer_view = NULL;
-  IREE_TRACE_ZONE_BEGIN(z0);
-  iree_allocator_t host_allocator =
-      iree_hal_allocator_host_allocator(device_allocator);
+// Maximum shape rank accepted in npy headers.
+#define IREE_NUMPY_NPY_MAX_SHAPE_RANK 128
 
-  // Quick check for EOF; if already there we can give a better error than
-  // if we failed trying to parse the header. Since npy files are often
-  // concatenated callers are likely to be using this in a loop and checking for
-  // this condition, even if it'd be better if they did it themselves.
-  if (feof(stream)) {
-    IREE_TRACE_ZONE_END(z0);
-    return iree_make_status(IREE_STATUS_OUT_OF_RANGE, "end-of-file");
-  }
+// Array type and shape parsed from an npy header dict.
+typedef struct iree_numpy_npy_array_info_t {
+  iree_hal_element_type_t element_type;
+  iree_hal_encoding_type_t encoding_type;
+  iree_host_size_t shape_rank;
+  iree_hal_dim_t shape[IREE_NUMPY_NPY_MAX_SHAPE_RANK];
+} iree_numpy_npy_array_info_t;
 
-  // Read header string.
-  // The resulting header must be freed with host_allocator.
-  char* header_buffer = NULL;
-  iree_host_size_t header_length = 0;
-  IREE_RETURN_AND_END_ZONE_IF_ERROR(
-      z0, iree_numpy_npy_read_header(stream, host_allocator, &header_length,
-                                     &header_buffer));
-  iree_string_view_t header = iree_string_view_trim(
-      iree_make_string_view(header_buffer, header_length));
+// Parses an npy |header| dict string into |out_info|.
+static iree_status_t iree_numpy_npy_parse_header_dict(
+    iree_string_view_t header, iree_numpy_npy_array_info_t* out_info) {
+  out_info->element_type = IREE_HAL_ELEMENT_TYPE_NONE;
+  out_info->encoding_type = IREE_HAL_ENCODING_TYPE_OPAQUE;
+  out_info->shape_rank = 0;
 
   // Parse the header.
   // It look something like this:
@@ -332,10 +330,6 @@ IREE_API_EXPORT iree_status_t iree_numpy_npy_load_ndarray(
   // also be keys we don't understand such as when what's saved is a pickled
   // object. We implement a basic scanning parser here and try to deal with it.
   iree_status_t status = iree_ok_status();
-  iree_host_size_t shape_rank = 0;
-  iree_hal_dim_t* shape = NULL;
-  iree_hal_element_type_t element_type = IREE_HAL_ELEMENT_TYPE_NONE;
-  iree_hal_encoding_type_t encoding_type = IREE_HAL_ENCODING_TYPE_OPAQUE;
   iree_string_view_consume_prefix(&header, IREE_SV("{"));
   iree_string_view_consume_suffix(&header, IREE_SV("}"));
   while (!iree_string_view_is_empty(header)) {
@@ -345,27 +339,67 @@ IREE_API_EXPORT iree_status_t iree_numpy_npy_load_ndarray(
     if (!iree_status_is_ok(status)) break;
 
     if (iree_string_view_equal(key, IREE_SV("descr"))) {
-      status = iree_numpy_descr_to_element_type(value, &element_type);
+      status = iree_numpy_descr_to_element_type(value, &out_info->element_type);
     } else if (iree_string_view_equal(key, IREE_SV("fortran_order"))) {
       if (iree_string_view_equal(value, IREE_SV("False"))) {
-        encoding_type = IREE_HAL_ENCODING_TYPE_DENSE_ROW_MAJOR;
+        out_info->encoding_type = IREE_HAL_ENCODING_TYPE_DENSE_ROW_MAJOR;
       } else {
         status = iree_make_status(IREE_STATUS_UNIMPLEMENTED,
                                   "fortran order arrays not supported");
       }
     } else if (iree_string_view_equal(key, IREE_SV("shape"))) {
-      shape_rank = iree_numpy_parse_shape_rank(value);
-      if (shape_rank > 128) {
+      iree_host_size_t shape_rank = iree_numpy_parse_shape_rank(value);
+      if (shape_rank > IREE_NUMPY_NPY_MAX_SHAPE_RANK) {
         status = iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
                                   "shape rank %" PRIhsz
-                                  " too large; be reasonable please");
+                                  " too large; be reasonable please",
+                                  shape_rank);
       } else {
-        shape = iree_alloca(shape_rank * sizeof(*shape));
-        status = iree_numpy_parse_shape_dims(value, shape_rank, shape);
+        out_info->shape_rank = shape_rank;
+        status =
+            iree_numpy_parse_shape_dims(value, shape_rank, out_info->shape);
       }
     }
     if (!iree_status_is_ok(status)) break;
   }
+  return status;
+}
+
+IREE_API_EXPORT iree_status_t iree_numpy_npy_load_ndarray(
+    FILE* stream, iree_numpy_npy_load_options_t options,
+    iree_hal_buffer_params_t buffer_params, iree_hal_device_t* device,
+    iree_hal_allocator_t* device_allocator,
+    iree_hal_buffer_view_t** out_buffer_view) {
+  IREE_ASSERT_ARGUMENT(stream);
+  IREE_ASSERT_ARGUMENT(device_allocator);
+  IREE_ASSERT_ARGUMENT(out_buffer_view);
+  *out_buffer_view = NULL;
+  IREE_TRACE_ZONE_BEGIN(z0);
+  iree_allocator_t host_allocator =
+      iree_hal_allocator_host_allocator(device_allocator);
+
+  // Quick check for EOF; if already there we can give a better error than
+  // if we failed trying to parse the header. Since npy files are often
+  // concatenated callers are likely to be using this in a loop and checking for
+  // this condition, even if it'd be better if they did it themselves.
+  if (feof(stream)) {
+    IREE_TRACE_ZONE_END(z0);
+    return iree_make_status(IREE_STATUS_OUT_OF_RANGE, "end-of-file");
+  }
+
+  // Read header string.
+  // The resulting header must be freed with host_allocator.
+  char* header_buffer = NULL;
+  iree_host_size_t header_length = 0;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_numpy_npy_read_header(stream, host_allocator, &header_length,
+                                     &header_buffer));
+  iree_string_view_t header = iree_string_view_trim(
+      iree_make_string_view(header_buffer, header_length));
+
+  // Parse the header dict to get the array type and shape.
+  iree_numpy_npy_array_info_t info;
+  iree_status_t status = iree_numpy_npy_parse_header_dict(header, &info);
 
   // Allocate the buffer view and directly read into the allocated memory.
   // On targets where we can perform host mapping this will be zero-copy; on
@@ -376,9 +410,9 @@ IREE_API_EXPORT iree_status_t iree_numpy_npy_load_ndarray(
     };
     buffer_params.access |= IREE_HAL_MEMORY_ACCESS_DISCARD_WRITE;
     status = iree_hal_buffer_view_generate_buffer(
-        device, device_allocator, shape_rank, shape, element_type,
-        encoding_type, buffer_params, iree_numpy_npy_read_into_mapping,
-        &read_params, out_buffer_view);
+        device, device_allocator, info.shape_rank, info.shape,
+        info.element_type, info.encoding_type, buffer_params,
+        iree_numpy_npy_read_into_mapping, &read_params, out_buffer_view);
   }
 
   iree_allocator_free(host_allocator, header_buffer);
@@ -622,3 +656,444 @@ IREE_API_EXPORT iree_status_t iree_numpy_npy_save_ndarray(
   IREE_TRACE_ZONE_END(z0);
   return status;
 }
+
+//===----------------------------------------------------------------------===//
+// .npy/.npz files
+//===----------------------------------------------------------------------===//
+
+// Loaded file contents shared by all buffers imported from them.
+// The contents (and the file mapping, if any) are kept alive until the loader
+// and all imported buffers have released their references.
+typedef struct iree_numpy_file_t {
+  iree_atomic_ref_count_t ref_count;
+  iree_allocator_t host_allocator;
+  iree_file_contents_t* contents;
+} iree_numpy_file_t;
+
+static iree_status_t iree_numpy_file_open(const char* path,
+                                          iree_numpy_npy_load_options_t options,
+                                          iree_allocator_t host_allocator,
+                                          iree_numpy_file_t** out_file) {
+  *out_file = NULL;
+  iree_numpy_file_t* file = NULL;
+  IREE_RETURN_IF_ERROR(
+      iree_allocator_malloc(host_allocator, sizeof(*file), (void**)&file));
+  iree_atomic_ref_count_init(&file->ref_count);
+  file->host_allocator = host_allocator;
+  file->contents = NULL;
+
+  // Mapping is best-effort: the platform may not support it or the file may
+  // not be mappable (such as when empty). Preloading will report any real
+  // issues with the file.
+  iree_status_t status = iree_ok_status();
+  if (iree_all_bits_set(options, IREE_NUMPY_NPY_LOAD_OPTION_MAP_FILE)) {
+    status = iree_file_read_contents(path, IREE_FILE_READ_FLAG_MMAP,
+                                     host_allocator, &file->contents);
+    if (!iree_status_is_ok(status) && !iree_status_is_not_found(status)) {
+      status = iree_status_ignore(status);
+    }
+  }
+  if (iree_status_is_ok(status) && !file->contents) {
+    status = iree_file_read_contents(path, IREE_FILE_READ_FLAG_PRELOAD,
+                                     host_allocator, &file->contents);
+  }
+
+  if (iree_status_is_ok(status)) {
+    *out_file = file;
+  } else {
+    iree_allocator_free(host_allocator, file);
+  }
+  return status;
+}
+
+static void iree_numpy_file_retain(iree_numpy_file_t* file) {
+  iree_atomic_ref_count_inc(&file->ref_count);
+}
+
+static void iree_numpy_file_release(iree_numpy_file_t* file) {
+  if (iree_atomic_ref_count_dec(&file->ref_count) == 1) {
+    iree_file_contents_free(file->contents);
+    iree_allocator_free(file->host_allocator, file);
+  }
+}
+
+static void iree_numpy_file_buffer_release(void* user_data,
+                                           iree_hal_buffer_t* buffer) {
+  iree_numpy_file_release((iree_numpy_file_t*)user_data);
+}
+
+// Tries to import |data| from |file| as a buffer without copying.
+// |out_buffer| will be NULL if the allocator cannot import the data with the
+// given |buffer_params|.
+static iree_status_t iree_numpy_file_try_import_buffer(
+    iree_numpy_file_t* file, iree_const_byte_span_t data,
+    iree_hal_buffer_params_t buffer_params,
+    iree_hal_allocator_t* device_allocator, iree_hal_buffer_t** out_buffer) {
+  *out_buffer = NULL;
+
+  // File contents are read-only (and may be mapped as such) so we can only
+  // import when the caller does not need to write to the buffer.
+  if (data.data_length == 0 ||
+      iree_any_bit_set(buffer_params.access, IREE_HAL_MEMORY_ACCESS_WRITE)) {
+    return iree_ok_status();
+  }
+  iree_device_size_t allocation_size = data.data_length;
+  if (!iree_all_bits_set(iree_hal_allocator_query_buffer_compatibility(
+                             device_allocator, buffer_params, allocation_size,
+                             &buffer_params, &allocation_size),
+                         IREE_HAL_BUFFER_COMPATIBILITY_IMPORTABLE)) {
+    return iree_ok_status();
+  }
+
+  iree_hal_external_buffer_t external_buffer = {
+      .type = IREE_HAL_EXTERNAL_BUFFER_TYPE_HOST_ALLOCATION,
+      .flags = IREE_HAL_EXTERNAL_BUFFER_FLAG_NONE,
+      .size = data.data_length,
+      .handle.host_allocation.ptr = (void*)data.data,
+  };
+  iree_hal_buffer_release_callback_t release_callback = {
+      .fn = iree_numpy_file_buffer_release,
+      .user_data = file,
+  };
+  iree_numpy_file_retain(file);  // released by release_callback
+  iree_status_t status =
+      iree_hal_allocator_import_buffer(device_allocator, buffer_params,
+                                       &external_buffer, release_callback,
+                                       out_buffer);
+  if (!iree_status_is_ok(status)) {
+    iree_numpy_file_release(file);
+    // The allocator fails imports of pointers it cannot use (such as when the
+    // data is not sufficiently aligned); we fall back to copying in that case.
+    if (iree_status_is_out_of_range(status) ||
+        iree_status_is_unavailable(status)) {
+      status = iree_status_ignore(status);
+    }
+  }
+  return status;
+}
+
+static iree_status_t iree_numpy_npy_copy_into_mapping(
+    iree_hal_buffer_mapping_t* mapping, void* user_data) {
+  const iree_const_byte_span_t* data = (const iree_const_byte_span_t*)user_data;
+  memcpy(mapping->contents.data, data->data, mapping->contents.data_length);
+  return iree_ok_status();
+}
+
+// Loads the ndarray at the start of |contents|, which must be a subrange of
+// |file|. |out_length| will contain the total length of the ndarray including
+// its header.
+static iree_status_t iree_numpy_npy_load_ndarray_from_file(
+    iree_numpy_file_t* file, iree_const_byte_span_t contents,
+    iree_numpy_npy_load_options_t options,
+    iree_hal_buffer_params_t buffer_params, iree_hal_device_t* device,
+    iree_hal_allocator_t* device_allocator, iree_host_size_t* out_length,
+    iree_hal_buffer_view_t** out_buffer_view) {
+  *out_length = 0;
+  *out_buffer_view = NULL;
+
+  // Parse the header prefix and the 2- or 4-byte header length; see
+  // iree_numpy_npy_read_header.
+  iree_numpy_npy_header_prefix_t prefix;
+  if (contents.data_length < sizeof(prefix)) {
+    return iree_make_status(IREE_STATUS_OUT_OF_RANGE,
+                            "unable to read entire header prefix");
+  }
+  memcpy(&prefix, contents.data, sizeof(prefix));
+  IREE_RETURN_IF_ERROR(iree_numpy_npy_verify_header_prefix(&prefix));
+  iree_host_size_t header_offset = sizeof(prefix);
+  iree_host_size_t header_length = 0;
+  if (prefix.version_major == 1) {
+    if (contents.data_length < header_offset + sizeof(uint16_t)) {
+      return iree_make_status(IREE_STATUS_OUT_OF_RANGE,
+                              "unable to read 2-byte header length");
+    }
+    header_length = iree_unaligned_load_le_u16(
+        (const uint16_t*)(contents.data + header_offset));
+    header_offset += sizeof(uint16_t);
+  } else {
+    if (contents.data_length < header_offset + sizeof(uint32_t)) {
+      return iree_make_status(IREE_STATUS_OUT_OF_RANGE,
+                              "unable to read 4-byte header length");
+    }
+    header_length = iree_unaligned_load_le_u32(
+        (const uint32_t*)(contents.data + header_offset));
+    header_offset += sizeof(uint32_t);
+  }
+  if (contents.data_length - header_offset < header_length) {
+    return iree_make_status(IREE_STATUS_OUT_OF_RANGE,
+                            "header string of %" PRIhsz " bytes truncated",
+                            header_length);
+  }
+  iree_string_view_t header = iree_string_view_trim(iree_make_string_view(
+      (const char*)contents.data + header_offset, header_length));
+
+  iree_numpy_npy_array_info_t info;
+  IREE_RETURN_IF_ERROR(iree_numpy_npy_parse_header_dict(header, &info));
+  iree_device_size_t byte_length = 0;
+  IREE_RETURN_IF_ERROR(iree_hal_buffer_compute_view_size(
+      info.shape_rank, info.shape, info.element_type, info.encoding_type,
+      &byte_length));
+  iree_host_size_t data_offset = header_offset + header_length;
+  if (contents.data_length - data_offset < byte_length) {
+    return iree_make_status(IREE_STATUS_OUT_OF_RANGE,
+                            "npy contents of %" PRIdsz " bytes truncated",
+                            byte_length);
+  }
+  iree_const_byte_span_t data = iree_make_const_byte_span(
+      contents.data + data_offset, (iree_host_size_t)byte_length);
+
+  // Try to use the file contents directly and otherwise copy them into a new
+  // buffer. Copies come straight from the (possibly mapped) file contents.
+  iree_hal_buffer_t* buffer = NULL;
+  if (iree_all_bits_set(options, IREE_NUMPY_NPY_LOAD_OPTION_MAP_FILE)) {
+    IREE_RETURN_IF_ERROR(iree_numpy_file_try_import_buffer(
+        file, data, buffer_params, device_allocator, &buffer));
+  }
+  iree_status_t status = iree_ok_status();
+  if (buffer) {
+    status = iree_hal_buffer_view_create(
+        buffer, info.shape_rank, info.shape, info.element_type,
+        info.encoding_type, file->host_allocator, out_buffer_view);
+    iree_hal_buffer_release(buffer);
+  } else {
+    buffer_params.access |= IREE_HAL_MEMORY_ACCESS_DISCARD_WRITE;
+    status = iree_hal_buffer_view_generate_buffer(
+        device, device_allocator, info.shape_rank, info.shape,
+        info.element_type, info.encoding_type, buffer_params,
+        iree_numpy_npy_copy_into_mapping, &data, out_buffer_view);
+  }
+
+  if (iree_status_is_ok(status)) {
+    *out_length = data_offset + data.data_length;
+  }
+  return status;
+}
+
+// Loads all concatenated ndarrays in a .npy |file|.
+static iree_status_t iree_numpy_npy_load_ndarrays_from_file(
+    iree_numpy_file_t* file, iree_numpy_npy_load_options_t options,
+    iree_hal_buffer_params_t buffer_params, iree_hal_device_t* device,
+    iree_hal_allocator_t* device_allocator,
+    iree_numpy_ndarray_callback_t callback) {
+  iree_const_byte_span_t contents = file->contents->const_buffer;
+  iree_status_t status = iree_ok_status();
+  while (iree_status_is_ok(status) && contents.data_length > 0) {
+    iree_host_size_t length = 0;
+    iree_hal_buffer_view_t* buffer_view = NULL;
+    status = iree_numpy_npy_load_ndarray_from_file(
+        file, contents, options, buffer_params, device, device_allocator,
+        &length, &buffer_view);
+    if (iree_status_is_ok(status)) {
+      status = callback.fn(callback.user_data, iree_string_view_empty(),
+                           buffer_view);
+      iree_hal_buffer_view_release(buffer_view);
+    }
+    contents.data += length;
+    contents.data_length -= length;
+  }
+  return status;
+}
+
+// ZIP format spec:
+// https://pkware.cachefly.net/webdocs/casestudies/APPNOTE.TXT
+//
+// .npz files are ZIP archives with one .npy file per array. When saved with
+// `numpy.savez` the entries are stored without compression and we can use the
+// .npy contents in-place. We only walk the local file headers as they precede
+// each entry's data; the central directory at the end of the archive is only
+// used as a terminator.
+//
+// Local file header (all fields little-endian):
+//   4b: signature `PK\3\4`
+//   2b: version needed to extract
+//   2b: general purpose bit flags
+//   2b: compression method
+//   2b: last modified time
+//   2b: last modified date
+//   4b: crc-32
+//   4b: compressed size
+//   4b: uncompressed size
+//   2b: file name length
+//   2b: extra field length
+//   [file name length]b: file name
+//   [extra field length]b: extra fields
+//   [compressed size]b: file data
+#define IREE_NUMPY_ZIP_LOCAL_FILE_HEADER_SIGNATURE 0x04034B50u
+#define IREE_NUMPY_ZIP_LOCAL_FILE_HEADER_SIZE 30
+#define IREE_NUMPY_ZIP_FLAG_ENCRYPTED (1u << 0)
+#define IREE_NUMPY_ZIP_FLAG_DATA_DESCRIPTOR (1u << 3)
+#define IREE_NUMPY_ZIP_METHOD_STORED 0
+#define IREE_NUMPY_ZIP_EXTRA_ZIP64 0x0001u
+
+// Returns true if |contents| begins with a ZIP signature.
+static bool iree_numpy_is_zip(iree_const_byte_span_t contents) {
+  return contents.data_length >= 2 && contents.data[0] == 'P' &&
+         contents.data[1] == 'K';
+}
+
+// Parses the zip64 extended information in the |extra| fields of a local file
+// header. numpy always writes zip64 entries and as such the 32-bit sizes in the
+// header are 0xFFFFFFFF and the real sizes are stored here.
+static iree_status_t iree_numpy_zip_parse_zip64_extra(
+    iree_const_byte_span_t extra, uint64_t* uncompressed_size,
+    uint64_t* compressed_size) {
+  while (extra.data_length >= 4) {
+    uint16_t id = iree_unaligned_load_le_u16((const uint16_t*)extra.data);
+    uint16_t size = iree_unaligned_load_le_u16((const uint16_t*)extra.data + 1);
+    if (extra.data_length - 4 < size) break;
+    if (id == IREE_NUMPY_ZIP_EXTRA_ZIP64) {
+      // Fields are only present if the corresponding header field is maxed.
+      const uint64_t* fields = (const uint64_t*)(extra.data + 4);
+      iree_host_size_t field_count = size / sizeof(uint64_t);
+      iree_host_size_t i = 0;
+      if (*uncompressed_size == UINT32_MAX && i < field_count) {
+        *uncompressed_size = iree_unaligned_load_le_u64(&fields[i++]);
+      }
+      if (*compressed_size == UINT32_MAX && i < field_count) {
+        *compressed_size = iree_unaligned_load_le_u64(&fields[i++]);
+      }
+      break;
+    }
+    extra.data += 4 + size;
+    extra.data_length -= 4 + size;
+  }
+  if (*uncompressed_size == UINT32_MAX || *compressed_size == UINT32_MAX) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "zip64 entry missing extended size information");
+  }
+  return iree_ok_status();
+}
+
+// Loads all ndarrays in an .npz |file|.
+static iree_status_t iree_numpy_npz_load_ndarrays_from_file(
+    iree_numpy_file_t* file, iree_numpy_npy_load_options_t options,
+    iree_hal_buffer_params_t buffer_params, iree_hal_device_t* device,
+    iree_hal_allocator_t* device_allocator,
+    iree_numpy_ndarray_callback_t callback) {
+  iree_const_byte_span_t contents = file->contents->const_buffer;
+  iree_host_size_t offset = 0;
+  iree_status_t status = iree_ok_status();
+  while (iree_status_is_ok(status) &&
+         contents.data_length - offset >= sizeof(uint32_t)) {
+    const uint8_t* header = contents.data + offset;
+    // Anything other than a local file header (central directory, etc)
+    // indicates there are no more entries.
+    if (iree_unaligned_load_le_u32((const uint32_t*)header) !=
+        IREE_NUMPY_ZIP_LOCAL_FILE_HEADER_SIGNATURE) {
+      break;
+    }
+    if (contents.data_length - offset < IREE_NUMPY_ZIP_LOCAL_FILE_HEADER_SIZE) {
+      status = iree_make_status(IREE_STATUS_OUT_OF_RANGE,
+                                "zip local file header truncated");
+      break;
+    }
+    uint16_t flags = iree_unaligned_load_le_u16((const uint16_t*)(header + 6));
+    uint16_t method = iree_unaligned_load_le_u16((const uint16_t*)(header + 8));
+    uint64_t compressed_size =
+        iree_unaligned_load_le_u32((const uint32_t*)(header + 18));
+    uint64_t uncompressed_size =
+        iree_unaligned_load_le_u32((const uint32_t*)(header + 22));
+    uint16_t name_length =
+        iree_unaligned_load_le_u16((const uint16_t*)(header + 26));
+    uint16_t extra_length =
+        iree_unaligned_load_le_u16((const uint16_t*)(header + 28));
+    iree_host_size_t data_offset = offset +
+                                   IREE_NUMPY_ZIP_LOCAL_FILE_HEADER_SIZE +
+                                   name_length + extra_length;
+    if (data_offset > contents.data_length) {
+      status = iree_make_status(IREE_STATUS_OUT_OF_RANGE,
+                                "zip local file header truncated");
+      break;
+    }
+    iree_string_view_t name = iree_make_string_view(
+        (const char*)header + IREE_NUMPY_ZIP_LOCAL_FILE_HEADER_SIZE,
+        name_length);
+    iree_const_byte_span_t extra = iree_make_const_byte_span(
+        header + IREE_NUMPY_ZIP_LOCAL_FILE_HEADER_SIZE + name_length,
+        extra_length);
+
+    if (iree_any_bit_set(flags, IREE_NUMPY_ZIP_FLAG_ENCRYPTED)) {
+      status = iree_make_status(IREE_STATUS_UNIMPLEMENTED,
+                                "npz entry '%.*s' is encrypted",
+                                (int)name.size, name.data);
+    } else if (iree_any_bit_set(flags, IREE_NUMPY_ZIP_FLAG_DATA_DESCRIPTOR)) {
+      // Sizes are only known after the data; only happens when the archive was
+      // written to a non-seekable stream.
+      status = iree_make_status(IREE_STATUS_UNIMPLEMENTED,
+                                "npz entry '%.*s' was streamed and has no "
+                                "sizes in its local file header",
+                                (int)name.size, name.data);
+    } else if (method != IREE_NUMPY_ZIP_METHOD_STORED) {
+      status = iree_make_status(
+          IREE_STATUS_UNIMPLEMENTED,
+          "npz entry '%.*s' uses compression method %u; only uncompressed "
+          "archives from `numpy.savez` are supported",
+          (int)name.size, name.data, method);
+    } else if (compressed_size == UINT32_MAX ||
+               uncompressed_size == UINT32_MAX) {
+      status = iree_numpy_zip_parse_zip64_extra(extra, &uncompressed_size,
+                                                &compressed_size);
+    }
+    if (!iree_status_is_ok(status)) break;
+    if (compressed_size != uncompressed_size ||
+        compressed_size > contents.data_length - data_offset) {
+      status = iree_make_status(IREE_STATUS_OUT_OF_RANGE,
+                                "npz entry '%.*s' data truncated",
+                                (int)name.size, name.data);
+      break;
+    }
+
+    // Load the entry in-place. Only one array is stored per entry.
+    iree_host_size_t length = 0;
+    iree_hal_buffer_view_t* buffer_view = NULL;
+    status = iree_numpy_npy_load_ndarray_from_file(
+        file,
+        iree_make_const_byte_span(contents.data + data_offset,
+                                  (iree_host_size_t)compressed_size),
+        options, buffer_params, device, device_allocator, &length,
+        &buffer_view);
+    if (iree_status_is_ok(status)) {
+      iree_string_view_consume_suffix(&name, IREE_SV(".npy"));
+      status = callback.fn(callback.user_data, name, buffer_view);
+      iree_hal_buffer_view_release(buffer_view);
+    }
+    if (!iree_status_is_ok(status)) {
+      status = iree_status_annotate_f(status, "loading npz entry '%.*s'",
+                                      (int)name.size, name.data);
+    }
+    offset = data_offset + (iree_host_size_t)compressed_size;
+  }
+  return status;
+}
+
+IREE_API_EXPORT iree_status_t iree_numpy_load_ndarrays_from_file(
+    const char* path, iree_numpy_npy_load_options_t options,
+    iree_hal_buffer_params_t buffer_params, iree_hal_device_t* device,
+    iree_hal_allocator_t* device_allocator,
+    iree_numpy_ndarray_callback_t callback) {
+  IREE_ASSERT_ARGUMENT(path);
+  IREE_ASSERT_ARGUMENT(device_allocator);
+  IREE_ASSERT_ARGUMENT(callback.fn);
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_TEXT(z0, path);
+
+  iree_allocator_t host_allocator =
+      iree_hal_allocator_host_allocator(device_allocator);
+  iree_numpy_file_t* file = NULL;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_numpy_file_open(path, options, host_allocator, &file));
+
+  iree_status_t status = iree_ok_status();
+  if (iree_numpy_is_zip(file->contents->const_buffer)) {
+    status = iree_numpy_npz_load_ndarrays_from_file(
+        file, options, buffer_params, device, device_allocator, callback);
+  } else {
+    status = iree_numpy_npy_load_ndarrays_from_file(
+        file, options, buffer_params, device, device_allocator, callback);
+  }
+
+  // Imported buffers may retain the file contents beyond this call.
+  iree_numpy_file_release(file);
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
@@ -17,9 +17,9 @@
 // not all dtypes are supported.
 //
 // .npy and uncompressed .npz files can be mapped into host memory with
-// IREE_NUMPY_NPY_LOAD_OPTION_MAP_FILE if the HAL device allocator
-// supports using such memory. On devices with discrete memory the contents will
-// be loaded into host memory and copied to the device.
+// IREE_NUMPY_NPY_LOAD_OPTION_MAP_FILE and iree_numpy_load_ndarrays_from_file if
+// the HAL device allocator supports using such memory. On devices with discrete
+// memory the contents will be copied from the mapped file to the device.
 //
 // This current implementation is very basic; in the future it'd be nice to
 // support an iree_io_stream_t to allow for externalizing the file access.
@@ -98,6 +98,45 @@ IREE_API_EXPORT iree_status_t iree_numpy_npy_save_ndarray(
     FILE* stream, iree_numpy_npy_save_options_t options,
     iree_hal_buffer_view_t* buffer_view, iree_allocator_t host_allocator);
 
+//===----------------------------------------------------------------------===//
+// .npy/.npz files
+//===----------------------------------------------------------------------===//
+
+// Callback issued for each ndarray loaded from a file.
+// |name| is the name of the array within an .npz archive (without the `.npy`
+// extension) or empty for arrays loaded from .npy files. The callee must
+// retain |buffer_view| if it is needed beyond the call.
+typedef iree_status_t(IREE_API_PTR* iree_numpy_ndarray_callback_fn_t)(
+    void* user_data, iree_string_view_t name,
+    iree_hal_buffer_view_t* buffer_view);
+
+// A callback issued for each ndarray loaded from a file.
+typedef struct iree_numpy_ndarray_callback_t {
+  // Callback function pointer.
+  iree_numpy_ndarray_callback_fn_t fn;
+  // User data passed to the callback function. Unowned.
+  void* user_data;
+} iree_numpy_ndarray_callback_t;
+
+// Loads all ndarrays from the file at |path| and issues |callback| for each
+// in file order. The file may be either a .npy file containing zero or more
+// concatenated arrays or an .npz archive produced by `numpy.savez`; the format
+// is detected from the file contents. Compressed archives (as produced by
+// `numpy.savez_compressed`) are not supported.
+//
+// If IREE_NUMPY_NPY_LOAD_OPTION_MAP_FILE is set the file is mapped into the
+// host process and read-only arrays are imported directly from the mapped
+// pages when |device_allocator| supports importing host allocations and the
+// array data meets its alignment requirements; the mapping is kept alive until
+// all imported buffers have been released. Arrays that cannot be imported are
+// copied into new allocations from the mapped pages without an intermediate
+// read.
+IREE_API_EXPORT iree_status_t iree_numpy_load_ndarrays_from_file(
+    const char* path, iree_numpy_npy_load_options_t options,
+    iree_hal_buffer_params_t buffer_params, iree_hal_device_t* device,
+    iree_hal_allocator_t* device_allocator,
+    iree_numpy_ndarray_callback_t callback);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif  // __cplusplus
@@ -58,7 +58,7 @@ class NumpyIOTest : public ::testing::Test {
            std::to_string(unique_id++) + '_' + suffix;
   }
 
-  FILE* OpenInputFile(const char* name) {
+  static std::string WriteInputFile(const char* name) {
     const struct iree_file_toc_t* file_toc = iree_numpy_npy_files_create();
     for (size_t i = 0; i < iree_numpy_npy_files_size(); ++i) {
       if (strcmp(file_toc[i].name, name) != 0) continue;
@@ -66,9 +66,14 @@ class NumpyIOTest : public ::testing::Test {
       IREE_CHECK_OK(iree_file_write_contents(
           file_path.c_str(),
           iree_make_const_byte_span(file_toc[i].data, file_toc[i].size)));
-      return fopen(file_path.c_str(), "rb");
+      return file_path;
     }
-    return NULL;
+    return "";
+  }
+
+  FILE* OpenInputFile(const char* name) {
+    auto file_path = WriteInputFile(name);
+    return file_path.empty() ? NULL : fopen(file_path.c_str(), "rb");
   }
 
   FILE* OpenOutputFile(const char* name) {
@@ -404,5 +409,105 @@ TEST_F(NumpyIOTest, RoundTripArrayTypes) {
   fclose(target_stream);
 }
 
+// Named ndarrays loaded with iree_numpy_load_ndarrays_from_file.
+struct LoadedArray {
+  std::string name;
+  iree_hal_buffer_view_t* buffer_view;
+};
+
+static iree_status_t AppendLoadedArray(void* user_data, iree_string_view_t name,
+                                       iree_hal_buffer_view_t* buffer_view) {
+  auto* arrays = reinterpret_cast<std::vector<LoadedArray>*>(user_data);
+  iree_hal_buffer_view_retain(buffer_view);
+  arrays->push_back({std::string(name.data, name.size), buffer_view});
+  return iree_ok_status();
+}
+
+static void ReleaseLoadedArrays(std::vector<LoadedArray>& arrays) {
+  for (auto& array : arrays) iree_hal_buffer_view_release(array.buffer_view);
+  arrays.clear();
+}
+
+// Loads all arrays from the file at |file_path| into |arrays|.
+static iree_status_t LoadArraysFromFile(const std::string& file_path,
+                                        iree_numpy_npy_load_options_t options,
+                                        iree_hal_device_t* device,
+                                        iree_hal_allocator_t* device_allocator,
+                                        std::vector<LoadedArray>* arrays) {
+  iree_hal_buffer_params_t buffer_params = {};
+  buffer_params.usage = IREE_HAL_BUFFER_USAGE_DEFAULT;
+  buffer_params.access = IREE_HAL_MEMORY_ACCESS_READ;
+  buffer_params.type = IREE_HAL_MEMORY_TYPE_DEVICE_LOCAL;
+  iree_numpy_ndarray_callback_t callback = {AppendLoadedArray, arrays};
+  return iree_numpy_load_ndarrays_from_file(file_path.c_str(), options,
+                                            buffer_params, device,
+                                            device_allocator, callback);
+}
+
+// Tests that an empty file has no arrays.
+TEST_F(NumpyIOTest, LoadFileEmpty) {
+  std::vector<LoadedArray> arrays;
+  IREE_ASSERT_OK(LoadArraysFromFile(
+      WriteInputFile("empty.npy"), IREE_NUMPY_NPY_LOAD_OPTION_MAP_FILE, device_,
+      device_allocator_, &arrays));
+  EXPECT_TRUE(arrays.empty());
+}
+
+// Tests loading multiple arrays from a concatenated file with and without
+// mapping. Arrays must remain valid after the file has been closed.
+TEST_F(NumpyIOTest, LoadFileMultipleArrays) {
+  auto file_path = WriteInputFile("multiple.npy");
+  for (auto options : {IREE_NUMPY_NPY_LOAD_OPTION_DEFAULT,
+                       IREE_NUMPY_NPY_LOAD_OPTION_MAP_FILE}) {
+    std::vector<LoadedArray> arrays;
+    IREE_ASSERT_OK(LoadArraysFromFile(file_path, options, device_,
+                                      device_allocator_, &arrays));
+    ASSERT_EQ(arrays.size(), 3);
+    EXPECT_EQ(arrays[0].name, "");
+    AssertBufferViewContents<float>(
+        arrays[0].buffer_view, {3}, IREE_HAL_ELEMENT_TYPE_FLOAT_32,
+        IREE_HAL_ENCODING_TYPE_DENSE_ROW_MAJOR, {1.1f, 2.2f, 3.3f});
+    AssertBufferViewContents<int32_t>(
+        arrays[1].buffer_view, {2, 2}, IREE_HAL_ELEMENT_TYPE_SINT_32,
+        IREE_HAL_ENCODING_TYPE_DENSE_ROW_MAJOR, {0, 1, 2, 3});
+    AssertBufferViewContents<int32_t>(
+        arrays[2].buffer_view, {}, IREE_HAL_ELEMENT_TYPE_SINT_32,
+        IREE_HAL_ENCODING_TYPE_DENSE_ROW_MAJOR, {42});
+    ReleaseLoadedArrays(arrays);
+  }
+}
+
+// Tests loading named arrays from an uncompressed npz archive.
+TEST_F(NumpyIOTest, LoadFileNpz) {
+  std::vector<LoadedArray> arrays;
+  IREE_ASSERT_OK(LoadArraysFromFile(
+      WriteInputFile("multiple.npz"), IREE_NUMPY_NPY_LOAD_OPTION_MAP_FILE,
+      device_, device_allocator_, &arrays));
+  ASSERT_EQ(arrays.size(), 3);
+  EXPECT_EQ(arrays[0].name, "a");
+  AssertBufferViewContents<float>(
+      arrays[0].buffer_view, {3}, IREE_HAL_ELEMENT_TYPE_FLOAT_32,
+      IREE_HAL_ENCODING_TYPE_DENSE_ROW_MAJOR, {1.1f, 2.2f, 3.3f});
+  EXPECT_EQ(arrays[1].name, "b");
+  AssertBufferViewContents<int32_t>(
+      arrays[1].buffer_view, {2, 2}, IREE_HAL_ELEMENT_TYPE_SINT_32,
+      IREE_HAL_ENCODING_TYPE_DENSE_ROW_MAJOR, {0, 1, 2, 3});
+  EXPECT_EQ(arrays[2].name, "c");
+  AssertBufferViewContents<int32_t>(
+      arrays[2].buffer_view, {}, IREE_HAL_ELEMENT_TYPE_SINT_32,
+      IREE_HAL_ENCODING_TYPE_DENSE_ROW_MAJOR, {42});
+  ReleaseLoadedArrays(arrays);
+}
+
+// Tests that compressed npz archives are rejected.
+TEST_F(NumpyIOTest, LoadFileNpzCompressed) {
+  std::vector<LoadedArray> arrays;
+  EXPECT_THAT(Status(LoadArraysFromFile(WriteInputFile("compressed.npz"),
+                                        IREE_NUMPY_NPY_LOAD_OPTION_MAP_FILE,
+                                        device_, device_allocator_, &arrays)),
+              StatusIs(StatusCode::kUnimplemented));
+  ReleaseLoadedArrays(arrays);
+}
+
 }  // namespace
 }  // namespace iree
@@ -0,0 +1,306 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/tooling/profile_util.h"
+
+#include <inttypes.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "iree/hal/local/local_profiler.h"
+
+//===----------------------------------------------------------------------===//
+// Op count estimation
+//===----------------------------------------------------------------------===//
+
+// Ops that perform one multiply-add per point in their iteration space.
+// Matches the op name or the op name followed by a '_' suffix such that
+// `matmul` matches `matmul_transpose_b` and `conv` matches
+// `conv_2d_nhwc_hwcf`.
+static const char* const kMultiplyAddOpNames[] = {
+    "batch_matmul",
+    "batch_matvec",
+    "batch_mmt4d",
+    "batch_reduce_matmul",
+    "batch_vecmat",
+    "conv",
+    "depthwise_conv",
+    "dot",
+    "matmul",
+    "matvec",
+    "mmt4d",
+    "quantized_batch_matmul",
+    "quantized_matmul",
+    "vecmat",
+};
+
+static bool iree_tooling_is_multiply_add_op_name(iree_string_view_t op_name) {
+  for (iree_host_size_t i = 0; i < IREE_ARRAYSIZE(kMultiplyAddOpNames); ++i) {
+    iree_string_view_t name = iree_make_cstring_view(kMultiplyAddOpNames[i]);
+    if (iree_string_view_equal(op_name, name)) return true;
+    if (iree_string_view_starts_with(op_name, name) &&
+        op_name.data[name.size] == '_') {
+      return true;
+    }
+  }
+  return false;
+}
+
+// Returns true if |token| is a loop range list like `128x256` or `128xDx64`.
+static bool iree_tooling_is_loop_range_token(iree_string_view_t token) {
+  if (iree_string_view_is_empty(token)) return false;
+  if (token.data[0] != 'D' && (token.data[0] < '0' || token.data[0] > '9')) {
+    return false;
+  }
+  for (iree_host_size_t i = 0; i < token.size; ++i) {
+    char c = token.data[i];
+    if (c != 'x' && c != 'D' && (c < '0' || c > '9')) return false;
+  }
+  return true;
+}
+
+bool iree_tooling_estimate_dispatch_op_count(iree_string_view_t export_name,
+                                             uint64_t* out_op_count) {
+  *out_op_count = 0;
+
+  // Strip the `<function>_dispatch_<ordinal>_` prefix, if present.
+  iree_string_view_t summary = export_name;
+  iree_host_size_t dispatch_pos =
+      iree_string_view_find_char(export_name, '_', 0);
+  while (dispatch_pos != IREE_STRING_VIEW_NPOS) {
+    iree_string_view_t tail =
+        iree_string_view_remove_prefix(export_name, dispatch_pos);
+    if (iree_string_view_consume_prefix(&tail, IREE_SV("_dispatch_"))) {
+      iree_host_size_t digit_count = 0;
+      while (digit_count < tail.size && tail.data[digit_count] >= '0' &&
+             tail.data[digit_count] <= '9') {
+        ++digit_count;
+      }
+      tail = iree_string_view_remove_prefix(tail, digit_count);
+      if (digit_count > 0 &&
+          iree_string_view_consume_prefix(&tail, IREE_SV("_"))) {
+        summary = tail;
+        break;
+      }
+    }
+    dispatch_pos =
+        iree_string_view_find_char(export_name, '_', dispatch_pos + 1);
+  }
+
+  // Split `<op_name>_<loop ranges>[_<types>]` on the first loop range token.
+  iree_string_view_t remaining = summary;
+  iree_host_size_t op_name_length = 0;
+  iree_string_view_t loop_ranges = iree_string_view_empty();
+  while (!iree_string_view_is_empty(remaining)) {
+    iree_string_view_t token = iree_string_view_empty();
+    iree_string_view_split(remaining, '_', &token, &remaining);
+    if (iree_tooling_is_loop_range_token(token)) {
+      loop_ranges = token;
+      break;
+    }
+    op_name_length = (iree_host_size_t)(token.data + token.size - summary.data);
+  }
+  if (iree_string_view_is_empty(loop_ranges)) return false;
+  if (!iree_tooling_is_multiply_add_op_name(
+          iree_make_string_view(summary.data, op_name_length))) {
+    return false;
+  }
+
+  // Multiply out the static loop ranges.
+  uint64_t point_count = 1;
+  while (!iree_string_view_is_empty(loop_ranges)) {
+    iree_string_view_t range = iree_string_view_empty();
+    iree_string_view_split(loop_ranges, 'x', &range, &loop_ranges);
+    uint64_t value = 0;
+    if (!iree_string_view_atoi_uint64(range, &value)) {
+      return false;  // dynamic (`D`)
+    }
+    if (value && point_count > UINT64_MAX / 2 / value) return false;
+    point_count *= value;
+  }
+  *out_op_count = 2 * point_count;
+  return true;
+}
+
+//===----------------------------------------------------------------------===//
+// Profile breakdown
+//===----------------------------------------------------------------------===//
+
+// Samples of one export aggregated across all workers.
+typedef struct {
+  const char* name;
+  uint32_t executable_index;
+  uint32_t export_ordinal;
+  uint32_t worker_count;
+  uint64_t dispatch_count;
+  uint64_t workgroup_count;
+  uint64_t total_ns;
+  uint64_t binding_length;
+  uint64_t counters[IREE_HAL_LOCAL_PROFILE_COUNTER_COUNT];
+} iree_tooling_profile_export_t;
+
+static int iree_tooling_profile_export_compare(const void* lhs_ptr,
+                                               const void* rhs_ptr) {
+  const iree_tooling_profile_export_t* lhs =
+      (const iree_tooling_profile_export_t*)lhs_ptr;
+  const iree_tooling_profile_export_t* rhs =
+      (const iree_tooling_profile_export_t*)rhs_ptr;
+  // Hottest first.
+  return (lhs->total_ns < rhs->total_ns) - (lhs->total_ns > rhs->total_ns);
+}
+
+iree_status_t iree_tooling_print_profile_breakdown(
+    iree_const_byte_span_t capture, FILE* stream) {
+  const iree_hal_local_profile_header_t* header =
+      (const iree_hal_local_profile_header_t*)capture.data;
+  if (capture.data_length < sizeof(*header) ||
+      header->magic != IREE_HAL_LOCAL_PROFILE_MAGIC) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "file is not a local HAL profile capture");
+  }
+  if (header->version != IREE_HAL_LOCAL_PROFILE_VERSION ||
+      header->counter_count != IREE_HAL_LOCAL_PROFILE_COUNTER_COUNT) {
+    return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
+                            "unsupported capture version %u",
+                            header->version);
+  }
+  const iree_hal_local_profile_record_t* records =
+      (const iree_hal_local_profile_record_t*)(capture.data + sizeof(*header));
+  const char* string_table = (const char*)(records + header->record_count);
+  if (capture.data_length < sizeof(*header) +
+                                header->record_count * sizeof(*records) +
+                                header->string_table_length) {
+    return iree_make_status(IREE_STATUS_OUT_OF_RANGE, "capture truncated");
+  }
+
+  iree_tooling_profile_export_t* exports = NULL;
+  IREE_RETURN_IF_ERROR(iree_allocator_malloc(
+      iree_allocator_system(),
+      iree_max(1, header->record_count) * sizeof(*exports), (void**)&exports));
+  iree_host_size_t export_count = 0;
+  uint64_t total_ns = 0;
+  for (uint32_t i = 0; i < header->record_count; ++i) {
+    const iree_hal_local_profile_record_t* record = &records[i];
+    iree_tooling_profile_export_t* export_info =
+        export_count ? &exports[export_count - 1] : NULL;
+    if (!export_info ||
+        export_info->executable_index != record->executable_index ||
+        export_info->export_ordinal != record->export_ordinal) {
+      export_info = &exports[export_count++];
+      memset(export_info, 0, sizeof(*export_info));
+      export_info->executable_index = record->executable_index;
+      export_info->export_ordinal = record->export_ordinal;
+      if (record->name_offset < header->string_table_length) {
+        export_info->name = string_table + record->name_offset;
+      }
+    }
+    ++export_info->worker_count;
+    export_info->dispatch_count += record->dispatch_count;
+    export_info->workgroup_count += record->workgroup_count;
+    export_info->total_ns += record->total_ns;
+    export_info->binding_length += record->binding_length;
+    for (iree_host_size_t j = 0; j < IREE_HAL_LOCAL_PROFILE_COUNTER_COUNT;
+         ++j) {
+      export_info->counters[j] += record->counters[j];
+    }
+    total_ns += record->total_ns;
+  }
+  qsort(exports, export_count, sizeof(*exports),
+        iree_tooling_profile_export_compare);
+
+  fprintf(stream, "duration: %.3f ms\n", header->duration_ns / 1e6);
+  fprintf(stream, "workers: %u\n", header->worker_count);
+  fprintf(stream,
+          "queue submissions: %" PRIu64 " (%" PRIu64 " command buffers)\n",
+          header->queue_submit_count, header->queue_command_buffer_count);
+  if (header->dropped_sample_count) {
+    fprintf(stream, "dropped samples: %" PRIu64 "\n",
+            header->dropped_sample_count);
+  }
+  // Records only hold the time each worker spent in an export, so the time
+  // columns are summed across workers and not dispatch latency. Rates are
+  // derived from that summed time and are per busy worker.
+  fprintf(stream,
+          "worker_ms: time summed across workers (not wall-clock latency)\n");
+  fprintf(stream, "GFLOP/s, GB/s: per busy worker\n");
+  const bool has_cycles =
+      header->counter_mask & (1u << IREE_HAL_LOCAL_PROFILE_COUNTER_CPU_CYCLES);
+  const bool has_instructions =
+      header->counter_mask &
+      (1u << IREE_HAL_LOCAL_PROFILE_COUNTER_INSTRUCTIONS);
+  const bool has_cache_misses =
+      header->counter_mask &
+      (1u << IREE_HAL_LOCAL_PROFILE_COUNTER_CACHE_MISSES);
+  if (!header->counter_mask) {
+    fprintf(stream, "hardware counters: unavailable\n");
+  }
+  fprintf(stream, "\n%7s %12s %10s %10s %19s %16s %13s", "time%",
+          "worker_ms", "dispatches", "workgroups", "worker_us/dispatch",
+          "GFLOP/s/worker", "GB/s/worker");
+  if (has_cycles) fprintf(stream, " %14s", "cycles");
+  if (has_instructions) fprintf(stream, " %14s", "instructions");
+  if (has_cycles && has_instructions) fprintf(stream, " %6s", "ipc");
+  if (has_cache_misses) fprintf(stream, " %12s", "cache_misses");
+  fprintf(stream, "  export\n");
+  for (iree_host_size_t i = 0; i < export_count; ++i) {
+    const iree_tooling_profile_export_t* export_info = &exports[i];
+    fprintf(stream, "%6.2f%% %12.3f %10" PRIu64 " %10" PRIu64 " %19.3f",
+            total_ns ? 100.0 * export_info->total_ns / total_ns : 0.0,
+            export_info->total_ns / 1e6, export_info->dispatch_count,
+            export_info->workgroup_count,
+            export_info->dispatch_count
+                ? export_info->total_ns / 1e3 / export_info->dispatch_count
+                : 0.0);
+    // Ops (or bytes) per nanosecond are G/s.
+    uint64_t op_count = 0;
+    if (export_info->name && export_info->total_ns &&
+        iree_tooling_estimate_dispatch_op_count(
+            iree_make_cstring_view(export_info->name), &op_count)) {
+      fprintf(stream, " %16.2f",
+              (double)op_count * export_info->dispatch_count /
+                  export_info->total_ns);
+    } else {
+      fprintf(stream, " %16s", "-");
+    }
+    if (export_info->binding_length && export_info->total_ns) {
+      fprintf(stream, " %13.2f",
+              (double)export_info->binding_length / export_info->total_ns);
+    } else {
+      fprintf(stream, " %13s", "-");
+    }
+    const uint64_t* counters = export_info->counters;
+    if (has_cycles) {
+      fprintf(stream, " %14" PRIu64,
+              counters[IREE_HAL_LOCAL_PROFILE_COUNTER_CPU_CYCLES]);
+    }
+    if (has_instructions) {
+      fprintf(stream, " %14" PRIu64,
+              counters[IREE_HAL_LOCAL_PROFILE_COUNTER_INSTRUCTIONS]);
+    }
+    if (has_cycles && has_instructions) {
+      uint64_t cycles = counters[IREE_HAL_LOCAL_PROFILE_COUNTER_CPU_CYCLES];
+      fprintf(stream, " %6.2f",
+              cycles ? (double)counters
+                               [IREE_HAL_LOCAL_PROFILE_COUNTER_INSTRUCTIONS] /
+                           cycles
+                     : 0.0);
+    }
+    if (has_cache_misses) {
+      fprintf(stream, " %12" PRIu64,
+              counters[IREE_HAL_LOCAL_PROFILE_COUNTER_CACHE_MISSES]);
+    }
+    if (export_info->name) {
+      fprintf(stream, "  %s", export_info->name);
+    } else {
+      fprintf(stream, "  executable[%u] export[%u]",
+              export_info->executable_index, export_info->export_ordinal);
+    }
+    fprintf(stream, "\n");
+  }
+
+  iree_allocator_free(iree_allocator_system(), exports);
+  return iree_ok_status();
+}
@@ -0,0 +1,47 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_TOOLING_PROFILE_UTIL_H_
+#define IREE_TOOLING_PROFILE_UTIL_H_
+
+#include <stdio.h>
+
+#include "iree/base/api.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+// Estimates the number of arithmetic operations performed by one dispatch of
+// the export named |export_name| and stores it in |out_op_count|.
+//
+// The compiler names dispatches after the most expensive op they contain along
+// with its static loop ranges and element types, as in
+// `main_dispatch_3_matmul_128x256x512_f32`. Contractions and convolutions
+// perform one multiply-add (2 ops) per point of their iteration space and have
+// their op count derived from the loop ranges. Returns false if the export
+// name does not describe such an op or has dynamic loop ranges.
+bool iree_tooling_estimate_dispatch_op_count(iree_string_view_t export_name,
+                                             uint64_t* out_op_count);
+
+// Prints a per-export breakdown table of a local HAL profile |capture| (see
+// iree/hal/local/local_profiler.h) to |stream| sorted by total time.
+//
+// The table includes the worker time, dispatch count, and average worker time
+// per dispatch of each export along with the achieved GFLOP/s when the op count
+// can be estimated from the export name and the achieved GB/s based on the
+// length of the buffers bound to each dispatch. Worker time is summed across
+// all workers that ran the export and is not dispatch latency; the rates are
+// derived from it and are per busy worker. Hardware counters are included when
+// present in the capture.
+iree_status_t iree_tooling_print_profile_breakdown(
+    iree_const_byte_span_t capture, FILE* stream);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif  // IREE_TOOLING_PROFILE_UTIL_H_
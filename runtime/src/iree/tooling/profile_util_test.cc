@@ -0,0 +1,88 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/tooling/profile_util.h"
+
+#include "iree/testing/gtest.h"
+#include "iree/testing/status_matchers.h"
+
+namespace {
+
+using iree::testing::status::StatusIs;
+
+static bool EstimateOpCount(const char* export_name, uint64_t* out_op_count) {
+  return iree_tooling_estimate_dispatch_op_count(
+      iree_make_cstring_view(export_name), out_op_count);
+}
+
+TEST(ProfileUtilTest, EstimateMatmul) {
+  uint64_t op_count = 0;
+  EXPECT_TRUE(
+      EstimateOpCount("main_dispatch_3_matmul_128x256x512_f32", &op_count));
+  EXPECT_EQ(op_count, 2ull * 128 * 256 * 512);
+}
+
+TEST(ProfileUtilTest, EstimateMatmulVariant) {
+  uint64_t op_count = 0;
+  EXPECT_TRUE(EstimateOpCount(
+      "forward_dispatch_12_matmul_transpose_b_64x32x16_f16xf16xf32",
+      &op_count));
+  EXPECT_EQ(op_count, 2ull * 64 * 32 * 16);
+}
+
+TEST(ProfileUtilTest, EstimateBatchMatmul) {
+  uint64_t op_count = 0;
+  EXPECT_TRUE(EstimateOpCount("main_dispatch_0_batch_matmul_4x32x64x128_f32",
+                              &op_count));
+  EXPECT_EQ(op_count, 2ull * 4 * 32 * 64 * 128);
+}
+
+TEST(ProfileUtilTest, EstimateConv) {
+  uint64_t op_count = 0;
+  EXPECT_TRUE(EstimateOpCount(
+      "predict_dispatch_7_conv_2d_nhwc_hwcf_1x112x112x32x3x3x3_f32",
+      &op_count));
+  EXPECT_EQ(op_count, 2ull * 1 * 112 * 112 * 32 * 3 * 3 * 3);
+}
+
+TEST(ProfileUtilTest, EstimateFunctionNameWithUnderscores) {
+  uint64_t op_count = 0;
+  EXPECT_TRUE(EstimateOpCount("my_model_main_dispatch_1_matmul_8x8x8_i8xi8xi32",
+                              &op_count));
+  EXPECT_EQ(op_count, 2ull * 8 * 8 * 8);
+}
+
+TEST(ProfileUtilTest, DynamicLoopRangesUnknown) {
+  uint64_t op_count = 0;
+  EXPECT_FALSE(
+      EstimateOpCount("main_dispatch_3_matmul_Dx256x512_f32", &op_count));
+  EXPECT_EQ(op_count, 0u);
+}
+
+TEST(ProfileUtilTest, ElementwiseUnknown) {
+  uint64_t op_count = 0;
+  EXPECT_FALSE(
+      EstimateOpCount("main_dispatch_2_generic_128x256_f32", &op_count));
+  EXPECT_FALSE(EstimateOpCount("main_dispatch_5_elementwise_1024_f32xf16",
+                               &op_count));
+}
+
+TEST(ProfileUtilTest, UnstructuredNameUnknown) {
+  uint64_t op_count = 0;
+  EXPECT_FALSE(EstimateOpCount("main_dispatch_4", &op_count));
+  EXPECT_FALSE(EstimateOpCount("my_handwritten_kernel", &op_count));
+  EXPECT_FALSE(EstimateOpCount("", &op_count));
+}
+
+TEST(ProfileUtilTest, RejectInvalidCapture) {
+  const uint8_t data[16] = {0};
+  iree_status_t status = iree_tooling_print_profile_breakdown(
+      iree_make_const_byte_span(data, sizeof(data)), stdout);
+  IREE_EXPECT_STATUS_IS(IREE_STATUS_INVALID_ARGUMENT, status);
+  iree_status_free(status);
+}
+
+}  // namespace
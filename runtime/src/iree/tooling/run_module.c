@@ -9,6 +9,7 @@
 #include "iree/base/api.h"
 #include "iree/base/internal/flags.h"
 #include "iree/hal/api.h"
+#include "iree/hal/utils/statistics_allocator.h"
 #include "iree/modules/hal/types.h"
 #include "iree/tooling/comparison.h"
 #include "iree/tooling/context_util.h"
@@ -38,6 +39,8 @@ IREE_FLAG_LIST(
     "\n"
     "Numpy npy files from numpy.save can be read to provide 1+ values:\n"
     "  @some.npy\n"
+    "Uncompressed npz files from numpy.savez provide each array in order:\n"
+    "  @some.npz\n"
     "\n"
     "Each occurrence of the flag indicates an input in the order they were\n"
     "specified on the command line.");
@@ -80,6 +83,66 @@ IREE_FLAG(
 IREE_FLAG(bool, print_statistics, false,
           "Prints runtime statistics to stderr on exit.");
 
+IREE_FLAG(string, allocation_statistics_file, "",
+          "Writes the allocations made during the function invocation as JSON\n"
+          "to the given file ('-' for stdout) for comparison across runs.\n"
+          "Requires --device_allocator=statistics as the last allocator.");
+
+// Reports the allocation |scope| of the invocation of |function_name| based on
+// the --print_statistics and --allocation_statistics_file flags.
+static iree_status_t iree_tooling_report_allocation_scope(
+    iree_string_view_t function_name,
+    const iree_hal_statistics_allocator_scope_t* scope,
+    iree_allocator_t host_allocator) {
+  iree_string_builder_t builder;
+  iree_string_builder_initialize(host_allocator, &builder);
+  iree_status_t status = iree_ok_status();
+
+  if (FLAG_print_statistics) {
+    status = iree_string_builder_append_format(
+        &builder, "[[ allocations @%.*s ]]\n", (int)function_name.size,
+        function_name.data);
+    if (iree_status_is_ok(status)) {
+      status = iree_hal_statistics_allocator_scope_format(scope, &builder);
+    }
+    if (iree_status_is_ok(status)) {
+      fprintf(stderr, "%.*s", (int)iree_string_builder_size(&builder),
+              iree_string_builder_buffer(&builder));
+    }
+    iree_string_builder_deinitialize(&builder);
+    iree_string_builder_initialize(host_allocator, &builder);
+  }
+
+  if (iree_status_is_ok(status) && strlen(FLAG_allocation_statistics_file)) {
+    status = iree_string_builder_append_format(
+        &builder, "{\"function\": \"%.*s\", \"allocations\": ",
+        (int)function_name.size, function_name.data);
+    if (iree_status_is_ok(status)) {
+      status = iree_hal_statistics_allocator_scope_format_json(scope, &builder);
+    }
+    if (iree_status_is_ok(status)) {
+      status = iree_string_builder_append_cstring(&builder, "}\n");
+    }
+    if (iree_status_is_ok(status)) {
+      bool is_stdout = strcmp(FLAG_allocation_statistics_file, "-") == 0;
+      FILE* file =
+          is_stdout ? stdout : fopen(FLAG_allocation_statistics_file, "wb");
+      if (file) {
+        fwrite(iree_string_builder_buffer(&builder), 1,
+               iree_string_builder_size(&builder), file);
+        if (!is_stdout) fclose(file);
+      } else {
+        status = iree_make_status(IREE_STATUS_PERMISSION_DENIED,
+                                  "unable to open '%s' for writing",
+                                  FLAG_allocation_statistics_file);
+      }
+    }
+  }
+
+  iree_string_builder_deinitialize(&builder);
+  return status;
+}
+
 static iree_status_t iree_tooling_process_outputs(
     iree_hal_device_t* device, iree_vm_list_t* outputs,
     iree_allocator_t host_allocator, int* out_exit_code);
@@ -216,6 +279,21 @@ static iree_status_t iree_tooling_run_function(
                                     "beginning device profiling");
   }
 
+  // Attribute all allocations made by the invocation to it. Inputs have already
+  // been allocated and count as live when the scope begins.
+  const bool has_allocation_scope =
+      device_allocator && iree_hal_statistics_allocator_isa(device_allocator);
+  if (iree_status_is_ok(status) && !has_allocation_scope &&
+      strlen(FLAG_allocation_statistics_file)) {
+    status = iree_make_status(
+        IREE_STATUS_FAILED_PRECONDITION,
+        "--allocation_statistics_file requires "
+        "--device_allocator=statistics as the last allocator");
+  }
+  if (iree_status_is_ok(status) && has_allocation_scope) {
+    iree_hal_statistics_allocator_begin_scope(device_allocator);
+  }
+
   // Invoke the function with the provided inputs.
   if (iree_status_is_ok(status)) {
     status = iree_status_annotate_f(
@@ -233,6 +311,18 @@ static iree_status_t iree_tooling_run_function(
         "waiting on finish fence");
   }
 
+  // End the allocation scope after waiting for the invocation to finish. The
+  // outputs are still live and count as persistent.
+  if (iree_status_is_ok(status) && has_allocation_scope) {
+    iree_hal_statistics_allocator_scope_t allocation_scope;
+    iree_hal_statistics_allocator_end_scope(device_allocator,
+                                            &allocation_scope);
+    status = iree_status_annotate_f(
+        iree_tooling_report_allocation_scope(function_name, &allocation_scope,
+                                             host_allocator),
+        "reporting allocation statistics");
+  }
+
   // End profiling after waiting for the invocation to finish.
   if (iree_status_is_ok(status)) {
     status = iree_status_annotate_f(iree_hal_end_profiling_from_flags(device),
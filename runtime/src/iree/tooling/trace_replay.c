@@ -1401,7 +1401,33 @@ static iree_status_t iree_trace_replay_event_blackboard_assign(
 // Numpy ndarray management
 //===----------------------------------------------------------------------===//
 
-// Loads one or more ndarrays from a .npy file.
+typedef struct iree_trace_replay_numpy_load_state_t {
+  iree_trace_replay_t* replay;
+  yaml_document_t* document;
+  // Remaining array items in the event; arrays beyond these are ignored.
+  yaml_node_item_t* item;
+  yaml_node_item_t* item_end;
+} iree_trace_replay_numpy_load_state_t;
+
+static iree_status_t iree_trace_replay_numpy_load_array(
+    void* user_data, iree_string_view_t name,
+    iree_hal_buffer_view_t* buffer_view) {
+  iree_trace_replay_numpy_load_state_t* state =
+      (iree_trace_replay_numpy_load_state_t*)user_data;
+  if (state->item == state->item_end) return iree_ok_status();
+
+  // Route the loaded value to its destination.
+  yaml_node_t* item_node =
+      yaml_document_get_node(state->document, *state->item++);
+  iree_vm_variant_t variant = iree_vm_make_variant_ref_assign(
+      iree_hal_buffer_view_retain_ref(buffer_view));
+  iree_status_t status = iree_trace_replay_parse_result_item(
+      state->replay, state->document, item_node, variant);
+  iree_vm_variant_reset(&variant);
+  return status;
+}
+
+// Loads one or more ndarrays from a .npy or uncompressed .npz file.
 //
 // Example:
 // ```yaml
@@ -1413,8 +1439,7 @@ static iree_status_t iree_trace_replay_event_blackboard_assign(
 // - !output.set 4
 // ```
 //
-// NOTE: this currently reads things into new buffers; we could try mapping from
-// disk and other fancy things where possible.
+// The file is mapped and arrays are used in-place when the device allows it.
 static iree_status_t iree_trace_replay_event_numpy_load(
     iree_trace_replay_t* replay, yaml_document_t* document,
     yaml_node_t* event_node) {
@@ -1440,51 +1465,34 @@ static iree_status_t iree_trace_replay_event_numpy_load(
   IREE_RETURN_AND_END_ZONE_IF_ERROR(
       z0, iree_file_path_join(replay->root_path, path_str,
                               replay->host_allocator, &full_path));
-  FILE* file = fopen(full_path, "rb");
-  iree_allocator_free(replay->host_allocator, full_path);
-  if (!file) {
-    IREE_TRACE_ZONE_END(z0);
-    return iree_make_status(iree_status_code_from_errno(errno),
-                            "failed to open file `%.*s` for read",
-                            (int)path_str.size, path_str.data);
-  }
-
-  uint64_t file_length = 0;
-  iree_status_t status = iree_file_query_length(file, &file_length);
 
   iree_hal_buffer_params_t buffer_params = {0};
   buffer_params.usage = IREE_HAL_BUFFER_USAGE_DEFAULT;
   buffer_params.access = IREE_HAL_MEMORY_ACCESS_READ;
   buffer_params.type = IREE_HAL_MEMORY_TYPE_DEVICE_LOCAL;
 
-  if (iree_status_is_ok(status)) {
-    for (yaml_node_item_t* item = arrays_node->data.sequence.items.start;
-         item != arrays_node->data.sequence.items.top; ++item) {
-      // Parse the next array in the file. Note that we may be at the end!
-      if (iree_file_is_at(file, file_length)) {
-        status = iree_make_status(IREE_STATUS_OUT_OF_RANGE,
-                                  "file ended before all arrays were decoded");
-        break;
-      }
-      iree_hal_buffer_view_t* buffer_view = NULL;
-      status = iree_numpy_npy_load_ndarray(
-          file, IREE_NUMPY_NPY_LOAD_OPTION_DEFAULT, buffer_params,
-          replay->device, iree_hal_device_allocator(replay->device),
-          &buffer_view);
-      if (!iree_status_is_ok(status)) break;
-
-      // Route the loaded value to its destination.
-      iree_vm_variant_t variant = iree_vm_make_variant_ref_assign(
-          iree_hal_buffer_view_move_ref(buffer_view));
-      yaml_node_t* item_node = yaml_document_get_node(document, *item);
-      status = iree_trace_replay_parse_result_item(replay, document, item_node,
-                                                   variant);
-      iree_vm_variant_reset(&variant);
-      if (!iree_status_is_ok(status)) break;
-    }
+  iree_trace_replay_numpy_load_state_t state = {
+      .replay = replay,
+      .document = document,
+      .item = arrays_node->data.sequence.items.start,
+      .item_end = arrays_node->data.sequence.items.top,
+  };
+  iree_numpy_ndarray_callback_t callback = {
+      .fn = iree_trace_replay_numpy_load_array,
+      .user_data = &state,
+  };
+  iree_status_t status = iree_numpy_load_ndarrays_from_file(
+      full_path, IREE_NUMPY_NPY_LOAD_OPTION_MAP_FILE, buffer_params,
+      replay->device, iree_hal_device_allocator(replay->device), callback);
+  iree_allocator_free(replay->host_allocator, full_path);
+  if (iree_status_is_ok(status) && state.item != state.item_end) {
+    status = iree_make_status(IREE_STATUS_OUT_OF_RANGE,
+                              "file ended before all arrays were decoded");
+  }
+  if (!iree_status_is_ok(status)) {
+    status = iree_status_annotate_f(status, "loading `%.*s`",
+                                    (int)path_str.size, path_str.data);
   }
-
-  fclose(file);
 
   IREE_TRACE_ZONE_END(z0);
   return status;
@@ -11,7 +11,6 @@
 #include <stdio.h>
 
 #include "iree/base/api.h"
-#include "iree/base/internal/file_io.h"
 #include "iree/hal/api.h"
 #include "iree/modules/hal/module.h"
 #include "iree/tooling/numpy_io.h"
@@ -25,42 +24,38 @@ static iree_status_t iree_allocate_and_copy_cstring_from_view(
   return iree_ok_status();
 }
 
+static iree_status_t iree_tooling_append_ndarray_to_list(
+    void* user_data, iree_string_view_t name,
+    iree_hal_buffer_view_t* buffer_view) {
+  iree_vm_list_t* list = (iree_vm_list_t*)user_data;
+  iree_vm_ref_t buffer_view_ref = iree_hal_buffer_view_retain_ref(buffer_view);
+  return iree_vm_list_push_ref_move(list, &buffer_view_ref);
+}
+
+// Loads all ndarrays from the .npy or .npz file at |file_path| and appends
+// them to |list| in file order. The file is mapped and arrays are used
+// in-place when the device allows it.
 static iree_status_t iree_tooling_load_ndarrays_from_file(
     iree_string_view_t file_path, iree_hal_device_t* device,
     iree_hal_allocator_t* device_allocator, iree_vm_list_t* list) {
   char* file_path_cstring = NULL;
   IREE_RETURN_IF_ERROR(iree_allocate_and_copy_cstring_from_view(
       iree_allocator_system(), file_path, &file_path_cstring));
-  FILE* file = fopen(file_path_cstring, "rb");
-  iree_allocator_free(iree_allocator_system(), file_path_cstring);
-  if (!file) {
-    return iree_make_status(iree_status_code_from_errno(errno),
-                            "failed to open file '%.*s'", (int)file_path.size,
-                            file_path.data);
-  }
-
-  uint64_t file_length = 0;
-  iree_status_t status = iree_file_query_length(file, &file_length);
 
   iree_hal_buffer_params_t buffer_params = {0};
   buffer_params.usage = IREE_HAL_BUFFER_USAGE_DEFAULT;
   buffer_params.access = IREE_HAL_MEMORY_ACCESS_READ;
   buffer_params.type = IREE_HAL_MEMORY_TYPE_DEVICE_LOCAL;
 
-  while (iree_status_is_ok(status) && !iree_file_is_at(file, file_length)) {
-    iree_hal_buffer_view_t* buffer_view = NULL;
-    status = iree_numpy_npy_load_ndarray(
-        file, IREE_NUMPY_NPY_LOAD_OPTION_DEFAULT, buffer_params, device,
-        device_allocator, &buffer_view);
-    if (iree_status_is_ok(status)) {
-      iree_vm_ref_t buffer_view_ref =
-          iree_hal_buffer_view_retain_ref(buffer_view);
-      status = iree_vm_list_push_ref_move(list, &buffer_view_ref);
-    }
-    iree_hal_buffer_view_release(buffer_view);
-  }
+  iree_numpy_ndarray_callback_t callback = {
+      .fn = iree_tooling_append_ndarray_to_list,
+      .user_data = list,
+  };
+  iree_status_t status = iree_numpy_load_ndarrays_from_file(
+      file_path_cstring, IREE_NUMPY_NPY_LOAD_OPTION_MAP_FILE, buffer_params,
+      device, device_allocator, callback);
 
-  fclose(file);
+  iree_allocator_free(iree_allocator_system(), file_path_cstring);
   return status;
 }
 
@@ -24,9 +24,8 @@
 static void iree_vm_invoke_release_io_refs(iree_string_view_t cconv_fragment,
                                            iree_byte_span_t storage) {
   if (!storage.data_length) return;
-  if (cconv_fragment.size == 0 || cconv_fragment.data[0] != '0') return;
   uint8_t* p = storage.data;
-  for (iree_host_size_t i = 1; i < cconv_fragment.size; ++i) {
+  for (iree_host_size_t i = 0; i < cconv_fragment.size; ++i) {
     char c = cconv_fragment.data[i];
     switch (c) {
       default:
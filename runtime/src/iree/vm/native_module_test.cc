@@ -6,11 +6,13 @@
 
 #include "iree/vm/native_module_test.h"
 
+#include <string>
 #include <vector>
 
 #include "iree/base/api.h"
 #include "iree/testing/gtest.h"
 #include "iree/testing/status_matchers.h"
+#include "iree/vm/buffer.h"
 #include "iree/vm/context.h"
 #include "iree/vm/instance.h"
 #include "iree/vm/invocation.h"
@@ -111,5 +113,138 @@ TEST_F(VMNativeModuleTest, Example) {
   ASSERT_EQ(v2, 8);
 }
 
+// A module whose exports take a ref argument: `borrow` only reads it (as all
+// native shims do) and `echo` returns a new reference to it. Both share a shim
+// that passes the argument and optional result through; `borrow` has no result
+// storage and ignores |out_ret0|.
+typedef iree_status_t (*call_r_r_t)(iree_vm_stack_t* stack, void* module,
+                                    void* module_state,
+                                    const iree_vm_ref_t* arg0,
+                                    iree_vm_ref_t* out_ret0);
+static iree_status_t call_shim_r_r(iree_vm_stack_t* stack,
+                                   iree_vm_native_function_flags_t flags,
+                                   iree_byte_span_t args_storage,
+                                   iree_byte_span_t rets_storage,
+                                   call_r_r_t target_fn, void* module,
+                                   void* module_state) {
+  return target_fn(stack, module, module_state,
+                   (const iree_vm_ref_t*)args_storage.data,
+                   (iree_vm_ref_t*)rets_storage.data);
+}
+static iree_status_t module_r_borrow(iree_vm_stack_t* stack, void* module,
+                                     void* module_state,
+                                     const iree_vm_ref_t* arg0,
+                                     iree_vm_ref_t* out_ret0) {
+  iree_vm_buffer_t* buffer = nullptr;
+  return iree_vm_buffer_check_deref(*arg0, &buffer);
+}
+static iree_status_t module_r_echo(iree_vm_stack_t* stack, void* module,
+                                   void* module_state,
+                                   const iree_vm_ref_t* arg0,
+                                   iree_vm_ref_t* out_ret0) {
+  iree_vm_buffer_t* buffer = nullptr;
+  IREE_RETURN_IF_ERROR(iree_vm_buffer_check_deref(*arg0, &buffer));
+  *out_ret0 = iree_vm_buffer_retain_ref(buffer);
+  return iree_ok_status();
+}
+static const iree_vm_native_export_descriptor_t module_r_exports_[] = {
+    {iree_make_cstring_view("borrow"), iree_make_cstring_view("0r_v"), 0,
+     nullptr},
+    {iree_make_cstring_view("echo"), iree_make_cstring_view("0r_r"), 0,
+     nullptr},
+};
+static const iree_vm_native_function_ptr_t module_r_funcs_[] = {
+    {(iree_vm_native_function_shim_t)call_shim_r_r,
+     (iree_vm_native_function_target_t)module_r_borrow},
+    {(iree_vm_native_function_shim_t)call_shim_r_r,
+     (iree_vm_native_function_target_t)module_r_echo},
+};
+static const iree_vm_native_module_descriptor_t module_r_descriptor_ = {
+    /*name=*/iree_make_cstring_view("module_r"),
+    /*version=*/0,
+    /*attr_count=*/0,
+    /*attrs=*/nullptr,
+    /*dependency_count=*/0,
+    /*dependencies=*/nullptr,
+    /*import_count=*/0,
+    /*imports=*/nullptr,
+    /*export_count=*/IREE_ARRAYSIZE(module_r_exports_),
+    /*exports=*/module_r_exports_,
+    /*function_count=*/IREE_ARRAYSIZE(module_r_funcs_),
+    /*functions=*/module_r_funcs_,
+};
+
+// Tests that iree_vm_invoke releases the argument references it marshals from
+// the input list once the native callee returns.
+class VMNativeModuleRefTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    IREE_ASSERT_OK(iree_vm_instance_create(
+        IREE_VM_TYPE_CAPACITY_DEFAULT, iree_allocator_system(), &instance_));
+    iree_vm_module_t interface;
+    IREE_ASSERT_OK(iree_vm_module_initialize(&interface, nullptr));
+    iree_vm_module_t* module = nullptr;
+    IREE_ASSERT_OK(iree_vm_native_module_create(
+        &interface, &module_r_descriptor_, instance_, iree_allocator_system(),
+        &module));
+    IREE_ASSERT_OK(iree_vm_context_create_with_modules(
+        instance_, IREE_VM_CONTEXT_FLAG_NONE, 1, &module,
+        iree_allocator_system(), &context_));
+    iree_vm_module_release(module);
+    IREE_ASSERT_OK(iree_vm_buffer_create(IREE_VM_BUFFER_ACCESS_ORIGIN_HOST, 16,
+                                         16, iree_allocator_system(),
+                                         &buffer_));
+  }
+
+  void TearDown() override {
+    iree_vm_buffer_release(buffer_);
+    iree_vm_context_release(context_);
+    iree_vm_instance_release(instance_);
+  }
+
+  int32_t BufferRefCount() {
+    return iree_atomic_ref_count_load(&buffer_->ref_object.counter);
+  }
+
+  // Invokes `module_r.|name|` with the buffer as its argument.
+  Status Invoke(const char* name, iree_vm_list_t* outputs) {
+    iree_vm_function_t function;
+    IREE_RETURN_IF_ERROR(iree_vm_context_resolve_function(
+        context_,
+        iree_make_cstring_view((std::string("module_r.") + name).c_str()),
+        &function));
+    vm::ref<iree_vm_list_t> inputs;
+    IREE_RETURN_IF_ERROR(iree_vm_list_create(iree_vm_make_undefined_type_def(),
+                                             1, iree_allocator_system(),
+                                             &inputs));
+    iree_vm_ref_t buffer_ref = iree_vm_buffer_retain_ref(buffer_);
+    IREE_RETURN_IF_ERROR(iree_vm_list_push_ref_move(inputs.get(), &buffer_ref));
+    return iree_vm_invoke(context_, function, IREE_VM_INVOCATION_FLAG_NONE,
+                          /*policy=*/nullptr, inputs.get(), outputs,
+                          iree_allocator_system());
+  }
+
+  iree_vm_instance_t* instance_ = nullptr;
+  iree_vm_context_t* context_ = nullptr;
+  iree_vm_buffer_t* buffer_ = nullptr;
+};
+
+TEST_F(VMNativeModuleRefTest, BorrowedArgumentIsReleased) {
+  for (int i = 0; i < 3; ++i) {
+    IREE_ASSERT_OK(Invoke("borrow", /*outputs=*/nullptr));
+    EXPECT_EQ(BufferRefCount(), 1);
+  }
+}
+
+TEST_F(VMNativeModuleRefTest, ReturnedRefIsOwnedByOutputs) {
+  vm::ref<iree_vm_list_t> outputs;
+  IREE_ASSERT_OK(iree_vm_list_create(iree_vm_make_undefined_type_def(), 1,
+                                     iree_allocator_system(), &outputs));
+  IREE_ASSERT_OK(Invoke("echo", outputs.get()));
+  EXPECT_EQ(BufferRefCount(), 2);
+  outputs.reset();
+  EXPECT_EQ(BufferRefCount(), 1);
+}
+
 }  // namespace
 }  // namespace iree
@@ -18,7 +18,17 @@
 // If interested in the precise time of a particular dispatch then tracy,
 // executable_library_benchmark, and platform/vendor tooling (nsight, perf, etc)
 // are to be used instead and attaching them to this tool is often useful in
-// order to get a large sample set.
+// order to get a large sample set. On local CPU devices --dispatch_breakdown
+// samples every dispatch while benchmarking and prints which dispatches
+// dominate along with their estimated GFLOP/s and GB/s. The breakdown reports
+// worker time summed across all workers and rates per busy worker, not
+// per-dispatch wall-clock latency.
+//
+// For capacity planning --load_requests=N runs --function as a serial-issue
+// load test instead: N requests arrive at --load_qps following a Poisson
+// process and are issued one at a time from a single thread with up to
+// --load_max_in_flight outstanding on the device. The achieved throughput and
+// p50/p90/p99/p999 latencies are reported as benchmark counters.
 //
 // By default all functions taking no inputs will be benchmarked. If a function
 // takes inputs then the user will need to specify them using --input=
@@ -52,9 +62,13 @@
 // an appropriate device-specific tool before trusting the more generic and
 // higher-level numbers from this tool.
 
+#include <algorithm>
 #include <array>
+#include <cmath>
 #include <cstdio>
+#include <cstdlib>
 #include <iterator>
+#include <random>
 #include <string>
 #include <type_traits>
 #include <utility>
@@ -62,11 +76,13 @@
 
 #include "benchmark/benchmark.h"
 #include "iree/base/api.h"
+#include "iree/base/internal/file_io.h"
 #include "iree/base/internal/flags.h"
 #include "iree/hal/api.h"
 #include "iree/modules/hal/types.h"
 #include "iree/tooling/context_util.h"
 #include "iree/tooling/device_util.h"
+#include "iree/tooling/profile_util.h"
 #include "iree/tooling/vm_util.h"
 #include "iree/vm/api.h"
 
@@ -91,6 +107,29 @@ IREE_FLAG(string, function, "",
 IREE_FLAG(bool, print_statistics, false,
           "Prints runtime statistics to stderr on exit.");
 
+IREE_FLAG(bool, dispatch_breakdown, false,
+          "Samples every dispatch on local CPU devices while benchmarking and "
+          "prints a per-dispatch breakdown of worker time (summed across "
+          "workers, not wall-clock latency) and estimated GFLOP/s and GB/s "
+          "per busy worker on exit. Overrides --device_profiling_mode.");
+
+IREE_FLAG(int32_t, load_requests, 0,
+          "Runs --function as a serial-issue load test issuing this many "
+          "requests instead of the default benchmark loop. Reports latency "
+          "percentiles measured from each request's arrival time along with "
+          "the achieved throughput.");
+IREE_FLAG(double, load_qps, 0.0,
+          "Target request rate of the load test with Poisson-distributed "
+          "arrivals (open loop). 0 issues each request as soon as an "
+          "in-flight slot frees up (closed loop).");
+IREE_FLAG(int32_t, load_max_in_flight, 1,
+          "Maximum number of requests outstanding on the device during the "
+          "load test. Values above 1 require an asynchronous (coarse-fences) "
+          "function. Requests are issued one at a time from a single thread "
+          "so functions that wait internally serialize issue.");
+IREE_FLAG(int64_t, load_seed, 1,
+          "Seed of the load test arrival process for reproducible runs.");
+
 IREE_FLAG_LIST(
     string, input,
     "An input value or buffer of the format:\n"
@@ -370,6 +409,246 @@ void RegisterAsyncBenchmark(const std::string& function_name,
                                   : benchmark::kMillisecond);
 }
 
+// One in-flight request of a load test.
+struct LoadSlot {
+  // Timeline signaled by the invocation when the request completes.
+  vm::ref<iree_hal_semaphore_t> semaphore;
+  // Payload value |semaphore| reaches when the in-flight request completes.
+  uint64_t pending_value = 0;
+  // Time the in-flight request arrived, which may be before it was issued if
+  // it had to wait for a free slot.
+  iree_time_t arrival_ns = 0;
+  bool busy = false;
+  vm::ref<iree_vm_list_t> outputs;
+};
+
+// Issues |request_count| invocations arriving at |target_qps| with up to
+// |max_in_flight| outstanding and stores the latency of each in
+// |latencies_ns|.
+//
+// Arrivals follow a Poisson process: inter-arrival times are exponentially
+// distributed. Latencies are measured from arrival instead of issue so that
+// time spent waiting for a free slot when the device can't keep up is
+// included (avoiding coordinated omission). With |target_qps| of 0 requests
+// arrive as soon as a slot frees up and the test is closed loop.
+//
+// |is_async| functions take a (wait, signal) fence pair following the inputs
+// and may have multiple requests in flight; synchronous functions block the
+// caller and are limited to one in flight.
+//
+// Requests are issued serially with the synchronous iree_vm_invoke from this
+// thread. Coarse-fences functions normally return once their work is enqueued,
+// so requests overlap on the device. A function that waits internally (such as
+// on a host readback) blocks the generator until the wait resolves instead.
+// That serializes issue and limits the achieved number in flight. Latencies
+// are still measured from arrival and include the time spent blocked.
+static void RunSerialIssueLoad(bool is_async, int32_t request_count,
+                               double target_qps, int32_t max_in_flight,
+                               uint64_t seed, iree_hal_device_t* device,
+                               iree_vm_context_t* context,
+                               iree_vm_function_t function,
+                               iree_vm_list_t* common_inputs,
+                               std::vector<iree_time_t>& latencies_ns) {
+  iree_allocator_t host_allocator = iree_allocator_system();
+  std::mt19937_64 rng(seed);
+  std::exponential_distribution<double> inter_arrival_s(
+      target_qps > 0.0 ? target_qps : 1.0);
+  auto next_inter_arrival_ns = [&]() -> iree_duration_t {
+    if (target_qps <= 0.0) return 0;
+    return (iree_duration_t)(inter_arrival_s(rng) * 1e9);
+  };
+
+  std::vector<LoadSlot> slots(max_in_flight);
+  for (auto& slot : slots) {
+    if (is_async) {
+      IREE_CHECK_OK(iree_hal_semaphore_create(device, 0ull, &slot.semaphore));
+    }
+    IREE_CHECK_OK(iree_vm_list_create(iree_vm_make_undefined_type_def(), 16,
+                                      host_allocator, &slot.outputs));
+  }
+  std::vector<iree_hal_semaphore_t*> wait_semaphores(max_in_flight);
+  std::vector<uint64_t> wait_values(max_in_flight);
+
+  int32_t issued_count = 0;
+  int32_t busy_count = 0;
+  iree_time_t next_arrival_ns = iree_time_now() + next_inter_arrival_ns();
+  while (issued_count < request_count || busy_count > 0) {
+    // Retire completed requests.
+    iree_time_t now_ns = iree_time_now();
+    for (auto& slot : slots) {
+      if (!slot.busy) continue;
+      uint64_t current_value = 0;
+      IREE_CHECK_OK(
+          iree_hal_semaphore_query(slot.semaphore.get(), &current_value));
+      if (current_value < slot.pending_value) continue;
+      latencies_ns.push_back(now_ns - slot.arrival_ns);
+      iree_vm_list_clear(slot.outputs.get());
+      slot.busy = false;
+      --busy_count;
+    }
+
+    // Issue the next request if it has arrived and a slot is free.
+    if (issued_count < request_count && busy_count < max_in_flight &&
+        (target_qps <= 0.0 || now_ns >= next_arrival_ns)) {
+      auto slot = std::find_if(slots.begin(), slots.end(),
+                               [](const LoadSlot& s) { return !s.busy; });
+      slot->arrival_ns = target_qps > 0.0 ? next_arrival_ns : now_ns;
+      next_arrival_ns += next_inter_arrival_ns();
+      ++issued_count;
+      if (is_async) {
+        // Clone common inputs and add the request-specific fences. Requests
+        // wait on nothing and begin executing immediately.
+        vm::ref<iree_vm_list_t> inputs;
+        IREE_CHECK_OK(
+            iree_vm_list_clone(common_inputs, host_allocator, &inputs));
+        vm::ref<iree_hal_fence_t> wait_fence;
+        IREE_CHECK_OK(iree_vm_list_push_ref_move(inputs.get(), wait_fence));
+        ++slot->pending_value;
+        vm::ref<iree_hal_fence_t> signal_fence;
+        IREE_CHECK_OK(iree_hal_fence_create_at(slot->semaphore.get(),
+                                               slot->pending_value,
+                                               host_allocator, &signal_fence));
+        IREE_CHECK_OK(iree_vm_list_push_ref_move(inputs.get(), signal_fence));
+        IREE_CHECK_OK(iree_vm_invoke(
+            context, function, IREE_VM_INVOCATION_FLAG_NONE,
+            /*policy=*/nullptr, inputs.get(), slot->outputs.get(),
+            host_allocator));
+        slot->busy = true;
+        ++busy_count;
+      } else {
+        IREE_CHECK_OK(iree_vm_invoke(
+            context, function, IREE_VM_INVOCATION_FLAG_NONE,
+            /*policy=*/nullptr, common_inputs, slot->outputs.get(),
+            host_allocator));
+        latencies_ns.push_back(iree_time_now() - slot->arrival_ns);
+        iree_vm_list_clear(slot->outputs.get());
+      }
+      continue;
+    }
+
+    // Sleep until the next arrival or until any in-flight request completes.
+    if (busy_count == 0) {
+      iree_wait_until(next_arrival_ns);
+      continue;
+    }
+    iree_timeout_t timeout = iree_infinite_timeout();
+    if (issued_count < request_count && busy_count < max_in_flight) {
+      timeout = iree_make_deadline(next_arrival_ns);
+    }
+    iree_host_size_t wait_count = 0;
+    for (auto& slot : slots) {
+      if (!slot.busy) continue;
+      wait_semaphores[wait_count] = slot.semaphore.get();
+      wait_values[wait_count] = slot.pending_value;
+      ++wait_count;
+    }
+    iree_hal_semaphore_list_t wait_list = {
+        wait_count,
+        wait_semaphores.data(),
+        wait_values.data(),
+    };
+    iree_status_t status = iree_hal_device_wait_semaphores(
+        device, IREE_HAL_WAIT_MODE_ANY, wait_list, timeout);
+    if (iree_status_is_deadline_exceeded(status)) {
+      iree_status_ignore(status);
+    } else {
+      IREE_CHECK_OK(status);
+    }
+  }
+}
+
+// Returns the latency at percentile |p| (0-1) of the sorted |latencies_ns|.
+static double LatencyPercentileMs(const std::vector<iree_time_t>& latencies_ns,
+                                  double p) {
+  if (latencies_ns.empty()) return 0.0;
+  size_t rank = (size_t)std::ceil(p * latencies_ns.size());
+  size_t index = std::min(latencies_ns.size() - 1, rank ? rank - 1 : 0);
+  return latencies_ns[index] / 1e6;
+}
+
+static void BenchmarkLoadFunction(const std::string& benchmark_name,
+                                  bool is_async, int32_t request_count,
+                                  double target_qps, int32_t max_in_flight,
+                                  uint64_t seed, iree_hal_device_t* device,
+                                  iree_vm_context_t* context,
+                                  iree_vm_function_t function,
+                                  iree_vm_list_t* inputs,
+                                  benchmark::State& state) {
+  IREE_TRACE_ZONE_BEGIN_NAMED_DYNAMIC(z0, benchmark_name.data(),
+                                      benchmark_name.size());
+  IREE_TRACE_FRAME_MARK();
+
+  std::vector<iree_time_t> latencies_ns;
+  latencies_ns.reserve(request_count);
+  iree_time_t duration_ns = 0;
+  while (state.KeepRunningBatch(request_count)) {
+    latencies_ns.clear();
+    iree_time_t start_ns = iree_time_now();
+    RunSerialIssueLoad(is_async, request_count, target_qps, max_in_flight,
+                       seed, device, context, function, inputs, latencies_ns);
+    duration_ns = iree_time_now() - start_ns;
+    state.SetIterationTime(duration_ns / 1e9);
+    if (device) {
+      IREE_CHECK_OK(iree_hal_device_profiling_flush(device));
+    }
+  }
+  state.SetItemsProcessed(state.iterations());
+
+  std::sort(latencies_ns.begin(), latencies_ns.end());
+  double latency_sum_ns = 0.0;
+  for (iree_time_t latency_ns : latencies_ns) latency_sum_ns += latency_ns;
+  state.counters["target_qps"] = target_qps;
+  state.counters["qps"] =
+      duration_ns ? latencies_ns.size() / (duration_ns / 1e9) : 0.0;
+  state.counters["mean_ms"] =
+      latencies_ns.empty() ? 0.0 : latency_sum_ns / latencies_ns.size() / 1e6;
+  state.counters["p50_ms"] = LatencyPercentileMs(latencies_ns, 0.50);
+  state.counters["p90_ms"] = LatencyPercentileMs(latencies_ns, 0.90);
+  state.counters["p99_ms"] = LatencyPercentileMs(latencies_ns, 0.99);
+  state.counters["p999_ms"] = LatencyPercentileMs(latencies_ns, 0.999);
+  state.counters["max_ms"] = LatencyPercentileMs(latencies_ns, 1.0);
+
+  IREE_TRACE_ZONE_END(z0);
+}
+
+iree_status_t RegisterLoadBenchmark(const std::string& function_name,
+                                    bool is_async, iree_hal_device_t* device,
+                                    iree_vm_context_t* context,
+                                    iree_vm_function_t function,
+                                    iree_vm_list_t* inputs) {
+  int32_t request_count = FLAG_load_requests;
+  double target_qps = FLAG_load_qps;
+  int32_t max_in_flight = FLAG_load_max_in_flight;
+  uint64_t seed = (uint64_t)FLAG_load_seed;
+  if (target_qps < 0.0 || max_in_flight < 1) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "--load_qps must be >= 0 and --load_max_in_flight "
+                            "must be >= 1");
+  }
+  if (!is_async && max_in_flight > 1) {
+    return iree_make_status(
+        IREE_STATUS_INVALID_ARGUMENT,
+        "--load_max_in_flight > 1 requires an asynchronous (coarse-fences) "
+        "function; '%s' is synchronous",
+        function_name.c_str());
+  }
+  auto benchmark_name = "BM_" + function_name + "/serial_issue_load";
+  benchmark::RegisterBenchmark(
+      benchmark_name.c_str(),
+      [=](benchmark::State& state) -> void {
+        BenchmarkLoadFunction(benchmark_name, is_async, request_count,
+                              target_qps, max_in_flight, seed, device, context,
+                              function, inputs, state);
+      })
+      // Each iteration is one request of a single load test run.
+      ->Iterations(request_count)
+      ->UseManualTime()
+      ->MeasureProcessCPUTime()
+      ->Unit(FLAG_time_unit.first ? FLAG_time_unit.second
+                                  : benchmark::kMillisecond);
+  return iree_ok_status();
+}
+
 static void BenchmarkDispatchFunction(const std::string& benchmark_name,
                                       iree_vm_context_t* context,
                                       iree_vm_function_t function,
@@ -458,6 +737,10 @@ class IREEBenchmark {
     }
 
     auto function_name = std::string(FLAG_function);
+    if (FLAG_load_requests > 0 && function_name.empty()) {
+      return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                              "--load_requests requires --function");
+    }
     if (!function_name.empty()) {
       IREE_RETURN_IF_ERROR(RegisterSpecificFunction(function_name));
     } else {
@@ -506,7 +789,14 @@ class IREEBenchmark {
 
     iree_string_view_t invocation_model = iree_vm_function_lookup_attr_by_name(
         &function, IREE_SV("iree.abi.model"));
-    if (iree_string_view_equal(invocation_model, IREE_SV("coarse-fences"))) {
+    if (FLAG_load_requests > 0) {
+      // Serial-issue load test.
+      return iree::RegisterLoadBenchmark(
+          function_name,
+          iree_string_view_equal(invocation_model, IREE_SV("coarse-fences")),
+          device_.get(), context_.get(), function, inputs_.get());
+    } else if (iree_string_view_equal(invocation_model,
+                                      IREE_SV("coarse-fences"))) {
       // Asynchronous invocation.
       iree::RegisterAsyncBenchmark(function_name, device_.get(), context_.get(),
                                    function, inputs_.get());
@@ -596,6 +886,48 @@ class IREEBenchmark {
   iree_tooling_module_list_t module_list_;
   iree::vm::ref<iree_vm_list_t> inputs_;
 };
+
+// Runs all benchmarks with dispatch profiling enabled on |device| and prints
+// the per-dispatch breakdown of the capture to stdout.
+//
+// Only local CPU devices produce a capture the breakdown understands; other
+// devices run the benchmarks as usual and a note is printed instead.
+iree_status_t RunWithDispatchBreakdown(iree_hal_device_t* device) {
+  const char* temp_path = getenv("TMPDIR");
+  if (!temp_path) temp_path = getenv("TEMP");
+  if (!temp_path) temp_path = ".";
+  std::string capture_path = std::string(temp_path) +
+                             "/iree-dispatch-breakdown-" +
+                             std::to_string(iree_time_now()) + ".bin";
+
+  iree_hal_device_profiling_options_t options = {0};
+  options.mode = IREE_HAL_DEVICE_PROFILING_MODE_DISPATCH_COUNTERS;
+  options.file_path = capture_path.c_str();
+  IREE_RETURN_IF_ERROR(iree_hal_device_profiling_begin(device, &options));
+  ::benchmark::RunSpecifiedBenchmarks();
+  IREE_RETURN_IF_ERROR(iree_hal_device_profiling_end(device));
+
+  iree_file_contents_t* capture = nullptr;
+  iree_status_t status =
+      iree_file_read_contents(capture_path.c_str(), IREE_FILE_READ_FLAG_DEFAULT,
+                              iree_allocator_system(), &capture);
+  if (iree_status_is_not_found(status)) {
+    iree_status_ignore(status);
+    fprintf(stdout,
+            "dispatch breakdown unavailable: device does not support "
+            "dispatch profiling\n");
+    return iree_ok_status();
+  }
+  if (iree_status_is_ok(status)) {
+    fprintf(stdout, "\nDispatch breakdown:\n");
+    status =
+        iree_tooling_print_profile_breakdown(capture->const_buffer, stdout);
+  }
+  iree_file_contents_free(capture);
+  remove(capture_path.c_str());
+  return status;
+}
+
 }  // namespace
 }  // namespace iree
 
@@ -618,9 +950,14 @@ int main(int argc, char** argv) {
     IREE_TRACE_APP_EXIT(exit_code);
     return exit_code;
   }
-  IREE_CHECK_OK(iree_hal_begin_profiling_from_flags(iree_benchmark.device()));
-  ::benchmark::RunSpecifiedBenchmarks();
-  IREE_CHECK_OK(iree_hal_end_profiling_from_flags(iree_benchmark.device()));
+  if (FLAG_dispatch_breakdown) {
+    IREE_CHECK_OK(iree::RunWithDispatchBreakdown(iree_benchmark.device()));
+  } else {
+    IREE_CHECK_OK(
+        iree_hal_begin_profiling_from_flags(iree_benchmark.device()));
+    ::benchmark::RunSpecifiedBenchmarks();
+    IREE_CHECK_OK(iree_hal_end_profiling_from_flags(iree_benchmark.device()));
+  }
 
   IREE_TRACE_ZONE_END(z0);
   IREE_TRACE_APP_EXIT(EXIT_SUCCESS);
@@ -0,0 +1,46 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "iree/base/api.h"
+#include "iree/base/internal/file_io.h"
+#include "iree/tooling/profile_util.h"
+
+int main(int argc, char** argv) {
+  if (argc < 2) {
+    fprintf(stderr,
+            "Syntax: iree-dump-profile profile.bin\n"
+            "Example usage:\n"
+            "  $ iree-benchmark-module \\\n"
+            "        --device=local-task \\\n"
+            "        --module=model.vmfb \\\n"
+            "        --function=main \\\n"
+            "        --device_profiling_mode=dispatch \\\n"
+            "        --device_profiling_file=profile.bin\n"
+            "  $ iree-dump-profile profile.bin\n"
+            "\n");
+    return 1;
+  }
+
+  iree_file_contents_t* file_contents = NULL;
+  iree_status_t status =
+      iree_file_read_contents(argv[1], IREE_FILE_READ_FLAG_DEFAULT,
+                              iree_allocator_system(), &file_contents);
+  if (iree_status_is_ok(status)) {
+    status = iree_tooling_print_profile_breakdown(file_contents->const_buffer,
+                                                  stdout);
+  }
+  iree_file_contents_free(file_contents);
+
+  if (!iree_status_is_ok(status)) {
+    iree_status_fprint(stderr, status);
+    iree_status_free(status);
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}